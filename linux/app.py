@@ -37,7 +37,7 @@ import typer
 import flask
 import semver
 from os import path, getcwd
-from camera.camera_ids_cli import close_cam, initialise_camera, capture_optimised
+from camera.camera_ids_cli import close_cam, initialise_camera, capture_optimised, capture_native, dump_black_box
 from api_client import validate_image
 from mdns import init_service
 
@@ -61,6 +61,9 @@ g_led_rgb = (255, 255, 255)
 
 g_path = "/tmp"
 
+# Unix socket of the capture_service daemon, empty to capture in-process
+g_capture_socket = ""
+
 
 
 
@@ -88,7 +91,10 @@ def trigger():
     # The AIRA API expects a path wrt to the Docker container so we need to remap.
     # fpath_for_api = "/mnt/original_image/"
     print("Triggered")
-    ret = capture_optimised(cam, stream)
+    if g_capture_socket:
+        ret = capture_native(g_capture_socket)
+    else:
+        ret = capture_optimised(cam, stream)
     if ret.get("error"):
         return flask.Response(json.dumps(ret), status=503, mimetype="application/json")
     else:
@@ -96,10 +102,30 @@ def trigger():
         # fname = path.basename(ret.get("path"))
         # fpath = path.join(fpath_for_api, fname)
         fpath = ret.get("path")
-        validate_image(fpath)
+        try:
+            res = validate_image(fpath)
+        except Exception:
+            res = None
+            raise
+        finally:
+            # Keep the frames around a rejected sample for diagnosis
+            if g_capture_socket and (not isinstance(res, dict) or res.get("error")):
+                dump_black_box(g_capture_socket, "validation")
         return flask.Response(json.dumps(ret), status=200, mimetype="application/json")
 
 
+@app.post("/blackbox")
+def black_box():
+    # Dump the capture_service black box, e.g. when an operator saw something odd
+    if not g_capture_socket:
+        return flask.Response(json.dumps({"error": "black box needs the capture service"}), status=503,
+                              mimetype="application/json")
+    item = flask.request.get_json(silent=True) or {}
+    ret = dump_black_box(g_capture_socket, item.get("reason") or "http")
+    status = 503 if ret.get("error") else 200
+    return flask.Response(json.dumps(ret), status=status, mimetype="application/json")
+
+
 @app.get("/ota")
 def check_ota():
     version = flask.request.args.get("version")
@@ -144,13 +170,16 @@ def main(
     skip: int = 2,
     red: int = 255,
     green: int = 255,
-    blue: int = 255
+    blue: int = 255,
+    capture_socket: str = ""
 ):
     global cam
     global stream
     global exiting
     global g_led_rgb 
+    global g_capture_socket
     g_led_rgb = (red, green, blue)
+    g_capture_socket = capture_socket
     logging.basicConfig(
         level=logging.DEBUG,
         filename=logfile,
@@ -161,7 +190,8 @@ def main(
     #    path=path,
     #    skip=skip,
     #)
-    cam, stream = initialise_camera(device) ## add device sel. control
+    if not g_capture_socket:
+        cam, stream = initialise_camera(device) ## add device sel. control
     try:
         init_service(host, port)
     except Exception as e:
@@ -170,7 +200,8 @@ def main(
     #stream.close()
     #cam.close()
     #close camera and library cleanly
-    close_cam()
+    if not g_capture_socket:
+        close_cam()
 
 
 if __name__ == "__main__":
@@ -22,7 +22,9 @@ print("GENICAM_GENTL32_PATH:", os.environ.get("GENICAM_GENTL32_PATH"))
 print("GENICAM_GENTL64_PATH:", os.environ.get("GENICAM_GENTL64_PATH"))
 
 
+import json
 import logging
+import socket
 import ids_peak.ids_peak as ids_peak
 from io import BytesIO
 from datetime import datetime
@@ -40,6 +42,7 @@ g_height = 2448
 g_xoffset = 408
 g_yoffset = 0
 g_path = "/tmp"
+g_capture_socket = "/tmp/capture_service.sock"
 
 
 datastream = None
@@ -211,6 +214,33 @@ def capture_optimised(device,remote_device_nodemap):
         print(str(e))
         return {"error": str(e)}
 
+def capture_native(socket_path=g_capture_socket, timeout=5.0):
+    # Trigger the capture_service daemon, which keeps the datastream armed between
+    # triggers. Returns the same dict as capture_optimised.
+    return send_command(socket_path, "TRIGGER", timeout)
+
+def dump_black_box(socket_path=g_capture_socket, reason="http", timeout=5.0):
+    # Ask the capture_service daemon to write the frames around now from its black box
+    # ring to disk. Returns at once, the dump is written in the background.
+    return send_command(socket_path, f"DUMP {reason}", timeout)
+
+def send_command(socket_path, command, timeout=5.0):
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.settimeout(timeout)
+            sock.connect(socket_path)
+            sock.sendall(command.encode() + b"\n")
+            response = b""
+            while not response.endswith(b"\n"):
+                chunk = sock.recv(4096)
+                if not chunk:
+                    break
+                response += chunk
+        return json.loads(response)
+    except Exception as e:
+        print(str(e))
+        return {"error": str(e)}
+
 def save_image(image_byte, filename):
 
     ## try this out 
@@ -0,0 +1,106 @@
+/*!
+ * \file    frame_queue.c
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Bounded FIFO of frame handles between the acquisition loop and
+ *          the encoding thread. Pushing never blocks, so a slow encoder
+ *          costs queued frames instead of stalling the acquisition.
+ *
+ * \version 1.0.0
+ */
+
+#include "frame_queue.h"
+#include <stdlib.h>
+
+peak_bool frame_queue_init(frame_queue* queue, size_t capacity)
+{
+    queue->capacity = (capacity > 0) ? capacity : 1;
+    queue->frames = (peak_frame_handle*)calloc(queue->capacity, sizeof(peak_frame_handle));
+    if (queue->frames == NULL)
+    {
+        return PEAK_FALSE;
+    }
+
+    queue->head = 0;
+    queue->count = 0;
+    queue->highWatermark = 0;
+    queue->closed = PEAK_FALSE;
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    return PEAK_TRUE;
+}
+
+void frame_queue_destroy(frame_queue* queue)
+{
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->frames);
+    queue->frames = NULL;
+}
+
+peak_bool frame_queue_push(frame_queue* queue, peak_frame_handle frame)
+{
+    pthread_mutex_lock(&queue->mutex);
+
+    if (queue->closed || queue->count == queue->capacity)
+    {
+        pthread_mutex_unlock(&queue->mutex);
+        return PEAK_FALSE;
+    }
+
+    queue->frames[(queue->head + queue->count) % queue->capacity] = frame;
+    queue->count++;
+    if (queue->count > queue->highWatermark)
+    {
+        queue->highWatermark = queue->count;
+    }
+
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->mutex);
+    return PEAK_TRUE;
+}
+
+peak_bool frame_queue_pop(frame_queue* queue, peak_frame_handle* frame)
+{
+    pthread_mutex_lock(&queue->mutex);
+
+    while (queue->count == 0 && !queue->closed)
+    {
+        pthread_cond_wait(&queue->notEmpty, &queue->mutex);
+    }
+
+    if (queue->count == 0)
+    {
+        pthread_mutex_unlock(&queue->mutex);
+        return PEAK_FALSE;
+    }
+
+    *frame = queue->frames[queue->head];
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+
+    pthread_mutex_unlock(&queue->mutex);
+    return PEAK_TRUE;
+}
+
+void frame_queue_close(frame_queue* queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    queue->closed = PEAK_TRUE;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+size_t frame_queue_depth(frame_queue* queue, size_t* highWatermark)
+{
+    pthread_mutex_lock(&queue->mutex);
+    const size_t depth = queue->count;
+    if (highWatermark != NULL)
+    {
+        *highWatermark = queue->highWatermark;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return depth;
+}
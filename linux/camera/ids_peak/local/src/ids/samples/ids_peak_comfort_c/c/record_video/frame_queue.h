@@ -0,0 +1,47 @@
+/*!
+ * \file    frame_queue.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Bounded FIFO of frame handles between the acquisition loop and
+ *          the encoding thread. Pushing never blocks, so a slow encoder
+ *          costs queued frames instead of stalling the acquisition.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <ids_peak_comfort_c/ids_peak_comfort_c.h>
+#include <pthread.h>
+#include <stddef.h>
+
+typedef struct
+{
+    peak_frame_handle* frames;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t highWatermark;
+    peak_bool closed;
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+} frame_queue;
+
+peak_bool frame_queue_init(frame_queue* queue, size_t capacity);
+void frame_queue_destroy(frame_queue* queue);
+
+// Returns PEAK_FALSE if the queue is full or closed, the caller still owns the frame then
+peak_bool frame_queue_push(frame_queue* queue, peak_frame_handle frame);
+
+// Waits for the oldest frame. Returns PEAK_FALSE once the queue is closed and empty.
+peak_bool frame_queue_pop(frame_queue* queue, peak_frame_handle* frame);
+
+// Rejects further pushes and wakes the consumer, which still gets the frames already queued
+void frame_queue_close(frame_queue* queue);
+
+size_t frame_queue_depth(frame_queue* queue, size_t* highWatermark);
+
+#endif // FRAME_QUEUE_H
@@ -33,6 +33,8 @@
 
 #if defined(WIN32)
 #include <Windows.h>
+#elif defined(__linux__)
+#include <unistd.h>
 #endif
 
 const char* containerTypeToString(peak_video_container container)
@@ -51,7 +53,7 @@ const char* encoderTypeToString(peak_video_encoder encoder)
         return "Invalid";
 }
 
-peak_status openCamera()
+peak_status openCamera(size_t cameraIndex)
 {
     // Initialize library
     peak_status status = peak_Library_Init();
@@ -95,19 +97,14 @@ peak_status openCamera()
         printf("%zu: %s (Serial: %s, ID: %"PRIu64")\n", i, camera.modelName, camera.serialNumber, camera.cameraID);
     }
 
-    // Select a camera via user input and open it
-    size_t selectedCamera = cameraListLength;
-    peak_bool scanSucceeded = PEAK_FALSE;
-    while (selectedCamera >= cameraListLength || !scanSucceeded)
+    // Open the camera selected on the command line, the recorder runs unattended
+    if (cameraIndex >= cameraListLength)
     {
-        printf("\nSelect camera to open: ");
-        scanSucceeded = scanInteger(&selectedCamera);
-
-        if (selectedCamera >= cameraListLength || !scanSucceeded)
-        {
-            printf("Please select a valid camera. \n");
-        }
+        printf("Camera %zu not found. \n", cameraIndex);
+        free(cameraList);
+        return PEAK_STATUS_CAMERA_NOT_FOUND;
     }
+    const size_t selectedCamera = cameraIndex;
 
     status = peak_Camera_Open(cameraList[selectedCamera].cameraID, &hCam);
     if (!checkForSuccess(status))
@@ -363,7 +360,15 @@ void signalHandler(int signal)
 int cleanExit()
 {
     printf("\nExiting program.\n");
+#if defined(__linux__)
+    // Only wait for a user at a terminal, not when running as a service
+    if (isatty(fileno(stdin)))
+    {
+        waitForEnter();
+    }
+#else
     waitForEnter();
+#endif
 
     // Clean up before exit
     peak_status status;
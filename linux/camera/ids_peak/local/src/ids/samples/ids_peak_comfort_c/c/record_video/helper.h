@@ -31,7 +31,7 @@ extern peak_camera_handle hCam;
 const char* containerTypeToString(peak_video_container container);
 const char* encoderTypeToString(peak_video_encoder encoder);
 
-peak_status openCamera();
+peak_status openCamera(size_t cameraIndex);
 peak_status adjustFrameRateToCameraRange(double* frameRate);
 peak_status configureColorConversion(peak_bool* hasColorConversion);
 peak_status acquireFrame(peak_frame_handle* frame, peak_bool hasColorConversion);
@@ -23,12 +23,14 @@
 
 #define VERSION "1.0.0"
 
-#define IMAGECOUNT 100
-
 #include "helper.h"
+#include "recorder.h"
 #include <inttypes.h>
 #include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #if defined(WIN32)
 #include <Windows.h>
@@ -38,17 +40,168 @@
 
 peak_camera_handle hCam = PEAK_INVALID_HANDLE;
 
-int main()
+typedef struct
+{
+    size_t camera;
+    recorder_options recorder;
+    // Seconds between counter reports, 0 disables them
+    double statsInterval;
+    // JSON file with the latest counters, rewritten atomically on every report
+    const char* statusFile;
+} options;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int signal)
+{
+    (void)signal;
+    stopRequested = 1;
+}
+
+static double monotonicSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line. Unknown arguments are reported and
+ * ignored.
+ */
+static void parseOptions(int argc, char* argv[], options* opts)
+{
+    opts->camera = 0;
+    opts->recorder.directory = "/tmp";
+    opts->recorder.prefix = "video";
+    opts->recorder.maxSegmentBytes = 1024ull * 1024 * 1024;
+    opts->recorder.maxSegmentSeconds = 3600;
+    opts->recorder.frameRate = 30.0;
+    opts->recorder.quality = 0;
+    opts->recorder.queueCapacity = 64;
+    opts->statsInterval = 10.0;
+    opts->statusFile = NULL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const int hasValue = (i + 1) < argc;
+
+        if (strcmp(argument, "--camera") == 0 && hasValue)
+        {
+            opts->camera = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argument, "--output") == 0 && hasValue)
+        {
+            opts->recorder.directory = argv[++i];
+        }
+        else if (strcmp(argument, "--prefix") == 0 && hasValue)
+        {
+            opts->recorder.prefix = argv[++i];
+        }
+        else if (strcmp(argument, "--segment-mb") == 0 && hasValue)
+        {
+            opts->recorder.maxSegmentBytes = strtoull(argv[++i], NULL, 0) * 1024 * 1024;
+        }
+        else if (strcmp(argument, "--segment-seconds") == 0 && hasValue)
+        {
+            opts->recorder.maxSegmentSeconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argument, "--frame-rate") == 0 && hasValue)
+        {
+            opts->recorder.frameRate = strtod(argv[++i], NULL);
+        }
+        else if (strcmp(argument, "--quality") == 0 && hasValue)
+        {
+            opts->recorder.quality = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argument, "--queue") == 0 && hasValue)
+        {
+            opts->recorder.queueCapacity = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argument, "--stats-interval") == 0 && hasValue)
+        {
+            opts->statsInterval = strtod(argv[++i], NULL);
+        }
+        else if (strcmp(argument, "--status-file") == 0 && hasValue)
+        {
+            opts->statusFile = argv[++i];
+        }
+        else
+        {
+            printf("Ignoring unknown argument: %s\n", argument);
+        }
+    }
+}
+
+/*! \brief Report Counters function
+ *
+ * The function prints the recorder and camera counters in one line and, if
+ * requested, writes them as JSON to the status file via a temporary file, so
+ * readers never see a partial update.
+ */
+static void reportCounters(recorder* rec, const options* opts, double elapsed, uint64_t acquisitionErrors)
+{
+    recorder_counters counters;
+    recorder_counters_get(rec, &counters);
+
+    peak_acquisition_info acquisition;
+    memset(&acquisition, 0, sizeof(acquisition));
+    peak_Acquisition_GetInfo(hCam, &acquisition);
+
+    printf("[%8.0f s] frames %" PRIu64 ", encoded %" PRIu64 ", queue %zu (max %zu), dropped: queue %" PRIu64
+           ", writer %" PRIu64 ", camera %u, segment %u, %.1f MB\n",
+        elapsed, counters.frames, counters.encoded, counters.queueDepth, counters.queueHighWatermark,
+        counters.queueDropped, counters.writerDropped, acquisition.numDropped, counters.segments,
+        (double)counters.bytes / (1024.0 * 1024.0));
+    fflush(stdout);
+
+    if (opts->statusFile == NULL)
+    {
+        return;
+    }
+
+    char temporaryPath[512];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", opts->statusFile);
+    FILE* file = fopen(temporaryPath, "w");
+    if (file == NULL)
+    {
+        return;
+    }
+
+    fprintf(file,
+        "{\"uptime_s\": %.0f, \"frames\": %" PRIu64 ", \"encoded\": %" PRIu64 ", \"queue_depth\": %zu, "
+        "\"queue_high_watermark\": %zu, \"queue_dropped\": %" PRIu64 ", \"writer_dropped\": %" PRIu64 ", "
+        "\"write_errors\": %" PRIu64 ", \"rotation_errors\": %" PRIu64 ", \"acquisition_errors\": %" PRIu64 ", "
+        "\"camera_dropped\": %u, \"camera_underrun\": %u, \"camera_incomplete\": %u, \"segments\": %u, "
+        "\"bytes\": %" PRIu64 ", \"file\": \"%s\"}\n",
+        elapsed, counters.frames, counters.encoded, counters.queueDepth, counters.queueHighWatermark,
+        counters.queueDropped, counters.writerDropped, counters.writeErrors, counters.rotationErrors,
+        acquisitionErrors, acquisition.numDropped, acquisition.numUnderrun, acquisition.numIncomplete,
+        counters.segments, counters.bytes, counters.currentFile);
+
+    if (fclose(file) == 0)
+    {
+        rename(temporaryPath, opts->statusFile);
+    }
+}
+
+int main(int argc, char* argv[])
 {
-    // Handle console closing signals
+    // Stop gracefully on console closing signals, so the last segment is finished
 #if defined(WIN32)
-    signal(SIGBREAK, signalHandler);
+    signal(SIGBREAK, requestStop);
 #elif defined(__linux__)
-    signal(SIGINT, signalHandler);
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
 #endif
 
+    options opts;
+    parseOptions(argc, argv, &opts);
+
     // Open a camera
-    peak_status status = openCamera();
+    peak_status status = openCamera(opts.camera);
     if(!PEAK_SUCCESS(status))
     {
         cleanExit();
@@ -60,62 +213,16 @@ int main()
     checkForSuccess(status);
 
     /////////////////////////////////////////////////////
-    //    Video file configuration
+    //    Camera and IPL Configurations
     /////////////////////////////////////////////////////
 
-    peak_video_container container = PEAK_VIDEO_CONTAINER_AVI;
-    peak_video_encoder encoder = PEAK_VIDEO_ENCODER_MJPEG;
-    peak_video_handle hVideo = PEAK_INVALID_HANDLE;
-
-    // Get path and filename from user input and open the file
-    char filenameUtf8[256];
-    status = PEAK_STATUS_ERROR;
-
-    while (!PEAK_SUCCESS(status))
-    {
-        printf("\nSelect path and filename, e.g. \"C:/temp/video.avi\" or \"/tmp/video.avi\": ");
-
-        peak_bool scanSucceeded = scanFileName(filenameUtf8, sizeof(filenameUtf8));
-        if (scanSucceeded)
-        {
-            status = peak_VideoWriter_Open(&hVideo, filenameUtf8, container, encoder);
-        }
-
-        if (!PEAK_SUCCESS(status))
-        {
-            printf(
-                "Please select a valid filename (that does not already exist) in a folder that has write access. \n");
-        }
-    }
-
     // Configure camera and video frame rate to be equal
-    double frameRate = 30.0;
-    status = adjustFrameRateToCameraRange(&frameRate);
-    checkForSuccess(status);
-
-    status = peak_FrameRate_Set(hCam, frameRate);
+    status = adjustFrameRateToCameraRange(&opts.recorder.frameRate);
     checkForSuccess(status);
 
-    status = peak_VideoWriter_Container_Option_Set(hVideo, PEAK_VIDEO_CONTAINER_OPTION_FRAMERATE, &frameRate, sizeof(frameRate));
+    status = peak_FrameRate_Set(hCam, opts.recorder.frameRate);
     checkForSuccess(status);
 
-    // Get the quality parameter value of the video encoder (only for MJPEG)
-    uint32_t quality = 0;
-    status = peak_VideoWriter_Encoder_Option_Get(hVideo, PEAK_VIDEO_ENCODER_OPTION_QUALITY, &quality, sizeof(quality), NULL);
-    checkForSuccess(status);
-
-    // Print the current configuration
-    printf("Configuration:\n");
-    printf("\tVideo file: \"%s\"\n", filenameUtf8);
-    printf("\tContainer type: %s\n", containerTypeToString(container));
-    printf("\tFrame rate: %.3f fps\n", frameRate);
-    printf("\tEncoder type: %s\n", encoderTypeToString(encoder));
-    printf("\tQuality: %u\n", quality);
-
-    /////////////////////////////////////////////////////
-    //    Camera and IPL Configurations
-    /////////////////////////////////////////////////////
-
     // Configure color conversion to result in a PixelFormat that is supported by the video writer
     peak_bool colorConversionEnabled = PEAK_FALSE;
     status = configureColorConversion(&colorConversionEnabled);
@@ -125,47 +232,63 @@ int main()
         return PEAK_STATUS_ERROR;
     }
 
+    // Print the current configuration
+    printf("Configuration:\n");
+    printf("\tOutput: \"%s/%s_*.avi\"\n", opts.recorder.directory, opts.recorder.prefix);
+    printf("\tContainer type: %s\n", containerTypeToString(PEAK_VIDEO_CONTAINER_AVI));
+    printf("\tEncoder type: %s\n", encoderTypeToString(PEAK_VIDEO_ENCODER_MJPEG));
+    printf("\tFrame rate: %.3f fps\n", opts.recorder.frameRate);
+    printf("\tSegments: %" PRIu64 " MB or %u s\n", opts.recorder.maxSegmentBytes / (1024 * 1024),
+        opts.recorder.maxSegmentSeconds);
+    printf("\tQueue: %zu frames\n", opts.recorder.queueCapacity);
+
     /////////////////////////////////////////////////////
-    //    Acquisition
+    //    Recording
     /////////////////////////////////////////////////////
 
-    // Start acquisition with 100 frames
-    const uint32_t frameCount = (uint32_t)IMAGECOUNT;
-    status = peak_Acquisition_Start(hCam, frameCount);
+    recorder* rec = recorder_create(hCam, &opts.recorder);
+    if (rec == NULL || !PEAK_SUCCESS(recorder_start(rec)))
+    {
+        recorder_destroy(rec);
+        cleanExit();
+        return PEAK_STATUS_ERROR;
+    }
+
+    // Acquire until stopped, frames are encoded behind the acquisition by the recorder
+    status = peak_Acquisition_Start(hCam, PEAK_INFINITE);
     if (!checkForSuccess(status))
     {
+        recorder_destroy(rec);
         cleanExit();
         return PEAK_STATUS_ERROR;
     }
 
-    for(int i = 0; i < frameCount; ++i)
+    printf("Recording, press Ctrl+C to stop.\n");
+
+    const double started = monotonicSeconds();
+    double nextReport = started + opts.statsInterval;
+    uint64_t acquisitionErrors = 0;
+
+    while (!stopRequested)
     {
         peak_frame_handle frame = PEAK_INVALID_HANDLE;
 
         status = acquireFrame(&frame, colorConversionEnabled);
-        if(PEAK_SUCCESS(status))
+        if (PEAK_SUCCESS(status))
         {
-            status = peak_VideoWriter_AddFrame(hVideo, frame);
-            if(PEAK_SUCCESS(status))
-            {
-                // Frame processing was successful
-                printf(".");
-                fflush(stdout);
-            }
-            else
-            {
-                // Video writer error
-                printf("v");
-                fflush(stdout);
-            }
-
-            peak_Frame_Release(hCam, frame);
+            recorder_add_frame(rec, frame);
         }
-        else
+        else if (status != PEAK_STATUS_TIMEOUT && status != PEAK_STATUS_ABORTED)
         {
             // General acquisition or frame processing error
-            printf("e");
-            fflush(stdout);
+            acquisitionErrors++;
+        }
+
+        const double now = monotonicSeconds();
+        if (opts.statsInterval > 0.0 && now >= nextReport)
+        {
+            reportCounters(rec, &opts, now - started, acquisitionErrors);
+            nextReport = now + opts.statsInterval;
         }
     }
 
@@ -173,31 +296,11 @@ int main()
     //    Finish
     /////////////////////////////////////////////////////
 
-    // Wait for the video writer to finish the last frame
-    status = peak_VideoWriter_WaitUntilQueueEmpty(hVideo, 1000);
-    checkForSuccess(status);
-
-    // Print the video statistics
-    printf("\nVideo statistics:\n");
-    peak_video_info info;
-    status = peak_VideoWriter_GetInfo(hVideo, &info);
-    if(checkForSuccess(status))
-    {
-        printf("\tFile size: %"PRIi64" Bytes\n", info.fileSize);
-        printf("\tEncoded frames: %"PRIi64"\n", info.encodedFrames);
-        printf("\tDropped frames: %"PRIi64"\n", info.droppedFrames);
-    }
-    else
-    {
-        printf("Could not read video info\n");
-    }
-
-    // Closing everything
-    status = peak_VideoWriter_Close(hVideo);
-    if(checkForSuccess(status))
-    {
-        printf("\nVideo file \"%s\" successfully written:\n", filenameUtf8);
-    }
+    // Encode the queued frames and finish the last segment before the acquisition stops
+    printf("\nStopping, finishing the last segment.\n");
+    recorder_stop(rec);
+    reportCounters(rec, &opts, monotonicSeconds() - started, acquisitionErrors);
+    recorder_destroy(rec);
 
     return cleanExit();
 }
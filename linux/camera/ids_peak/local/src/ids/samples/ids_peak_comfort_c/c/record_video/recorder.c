@@ -0,0 +1,385 @@
+/*!
+ * \file    recorder.c
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Continuous video recorder. Acquired frames pass through a
+ *          frame_queue to an encoding thread, which feeds the video writer
+ *          and rotates to a new file by size or age. The next file is opened
+ *          before the previous one is closed, and the close runs on a thread
+ *          of its own, so no frame is lost at a segment boundary.
+ *
+ * \version 1.0.0
+ */
+
+#include "recorder.h"
+#include "frame_queue.h"
+#include "helper.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// A segment that failed to open is retried after this delay, not on every frame
+#define ROTATION_RETRY_SECONDS 1.0
+
+// Longest wait for the video writer to encode the frames queued before a segment is closed
+#define CLOSE_TIMEOUT_MS 10000
+
+struct recorder
+{
+    peak_camera_handle hCam;
+    recorder_options options;
+    char directory[256];
+    char prefix[64];
+
+    frame_queue queue;
+    pthread_t encoderThread;
+    peak_bool encoderRunning;
+    pthread_t closerThread;
+    peak_bool closerRunning;
+
+    // Owned by the encoding thread
+    double segmentOpened;
+    double rotationRetry;
+
+    // Guarded by mutex. A handle is taken out of hVideo/hClosing under the mutex before it is closed, so
+    // recorder_counters_get never queries a closed handle.
+    pthread_mutex_t mutex;
+    peak_video_handle hVideo;
+    peak_video_handle hClosing;
+    uint64_t frames;
+    uint64_t queueDropped;
+    uint64_t writeErrors;
+    uint64_t rotationErrors;
+    uint64_t closedEncoded;
+    uint64_t closedDropped;
+    uint64_t closedBytes;
+    uint32_t segments;
+    char currentFile[512];
+};
+
+static double monotonicSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static peak_status openSegment(recorder* rec, peak_video_handle* hVideo, char* path, size_t pathSize)
+{
+    char started[32];
+    const time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    strftime(started, sizeof(started), "%Y%m%d_%H%M%S", &local);
+
+    snprintf(path, pathSize, "%s/%s_%s_%04u.avi", rec->directory, rec->prefix, started, rec->segments);
+
+    peak_status status = peak_VideoWriter_Open(hVideo, path, PEAK_VIDEO_CONTAINER_AVI, PEAK_VIDEO_ENCODER_MJPEG);
+    if (!checkForSuccess(status))
+    {
+        printf("Could not open video file \"%s\"\n", path);
+        return status;
+    }
+
+    double frameRate = rec->options.frameRate;
+    status = peak_VideoWriter_Container_Option_Set(
+        *hVideo, PEAK_VIDEO_CONTAINER_OPTION_FRAMERATE, &frameRate, sizeof(frameRate));
+    if (PEAK_SUCCESS(status) && rec->options.quality > 0)
+    {
+        uint32_t quality = rec->options.quality;
+        status = peak_VideoWriter_Encoder_Option_Set(
+            *hVideo, PEAK_VIDEO_ENCODER_OPTION_QUALITY, &quality, sizeof(quality));
+    }
+
+    if (!checkForSuccess(status))
+    {
+        peak_VideoWriter_Close(*hVideo);
+        *hVideo = PEAK_INVALID_HANDLE;
+    }
+    return status;
+}
+
+// Waits for the queued frames of a segment, books its statistics and closes it
+static void closeSegment(recorder* rec, peak_video_handle hVideo)
+{
+    peak_status status = peak_VideoWriter_WaitUntilQueueEmpty(hVideo, CLOSE_TIMEOUT_MS);
+    checkForSuccess(status);
+
+    pthread_mutex_lock(&rec->mutex);
+    peak_video_info info;
+    if (PEAK_SUCCESS(peak_VideoWriter_GetInfo(hVideo, &info)))
+    {
+        rec->closedEncoded += info.encodedFrames;
+        rec->closedDropped += info.droppedFrames;
+        rec->closedBytes += info.fileSize;
+    }
+    if (rec->hClosing == hVideo)
+    {
+        rec->hClosing = PEAK_INVALID_HANDLE;
+    }
+    pthread_mutex_unlock(&rec->mutex);
+
+    status = peak_VideoWriter_Close(hVideo);
+    checkForSuccess(status);
+}
+
+static void* closerThread(void* context)
+{
+    recorder* rec = (recorder*)context;
+
+    pthread_mutex_lock(&rec->mutex);
+    peak_video_handle hVideo = rec->hClosing;
+    pthread_mutex_unlock(&rec->mutex);
+
+    closeSegment(rec, hVideo);
+    return NULL;
+}
+
+static void joinCloser(recorder* rec)
+{
+    if (rec->closerRunning)
+    {
+        pthread_join(rec->closerThread, NULL);
+        rec->closerRunning = PEAK_FALSE;
+    }
+}
+
+static peak_bool rotationDue(recorder* rec, double now)
+{
+    if (rec->options.maxSegmentSeconds > 0 && now - rec->segmentOpened >= rec->options.maxSegmentSeconds)
+    {
+        return PEAK_TRUE;
+    }
+
+    if (rec->options.maxSegmentBytes > 0)
+    {
+        peak_video_info info;
+        if (PEAK_SUCCESS(peak_VideoWriter_GetInfo(rec->hVideo, &info))
+            && info.fileSize >= rec->options.maxSegmentBytes)
+        {
+            return PEAK_TRUE;
+        }
+    }
+
+    return PEAK_FALSE;
+}
+
+static void rotate(recorder* rec, double now)
+{
+    peak_video_handle hNext = PEAK_INVALID_HANDLE;
+    char path[512];
+    if (!PEAK_SUCCESS(openSegment(rec, &hNext, path, sizeof(path))))
+    {
+        // Keep recording into the current segment, e.g. while the disk is full
+        pthread_mutex_lock(&rec->mutex);
+        rec->rotationErrors++;
+        pthread_mutex_unlock(&rec->mutex);
+        rec->rotationRetry = now + ROTATION_RETRY_SECONDS;
+        return;
+    }
+
+    // The previous close finished long ago unless segments are shorter than the writer's backlog
+    joinCloser(rec);
+
+    pthread_mutex_lock(&rec->mutex);
+    rec->hClosing = rec->hVideo;
+    rec->hVideo = hNext;
+    rec->segments++;
+    snprintf(rec->currentFile, sizeof(rec->currentFile), "%s", path);
+    pthread_mutex_unlock(&rec->mutex);
+
+    rec->segmentOpened = now;
+    rec->rotationRetry = 0.0;
+
+    if (pthread_create(&rec->closerThread, NULL, closerThread, rec) == 0)
+    {
+        rec->closerRunning = PEAK_TRUE;
+    }
+    else
+    {
+        closerThread(rec);
+    }
+}
+
+static void* encoderThread(void* context)
+{
+    recorder* rec = (recorder*)context;
+    const struct timespec busyDelay = { 0, 1000000 };
+
+    peak_frame_handle frame = PEAK_INVALID_HANDLE;
+    while (frame_queue_pop(&rec->queue, &frame))
+    {
+        // The frame that crosses the limit is the first one of the next segment
+        const double now = monotonicSeconds();
+        if (now >= rec->rotationRetry && rotationDue(rec, now))
+        {
+            rotate(rec, now);
+        }
+
+        // Busy means the video writer's own queue is full, the frame waits for it while ours absorbs the backlog
+        peak_status status = peak_VideoWriter_AddFrame(rec->hVideo, frame);
+        while (status == PEAK_STATUS_BUSY)
+        {
+            nanosleep(&busyDelay, NULL);
+            status = peak_VideoWriter_AddFrame(rec->hVideo, frame);
+        }
+
+        if (!PEAK_SUCCESS(status))
+        {
+            pthread_mutex_lock(&rec->mutex);
+            rec->writeErrors++;
+            pthread_mutex_unlock(&rec->mutex);
+        }
+
+        peak_Frame_Release(rec->hCam, frame);
+    }
+
+    return NULL;
+}
+
+recorder* recorder_create(peak_camera_handle hCam, const recorder_options* options)
+{
+    recorder* rec = (recorder*)calloc(1, sizeof(recorder));
+    if (rec == NULL)
+    {
+        return NULL;
+    }
+
+    rec->hCam = hCam;
+    rec->options = *options;
+    snprintf(rec->directory, sizeof(rec->directory), "%s", options->directory);
+    snprintf(rec->prefix, sizeof(rec->prefix), "%s", options->prefix);
+    rec->options.directory = rec->directory;
+    rec->options.prefix = rec->prefix;
+    rec->hVideo = PEAK_INVALID_HANDLE;
+    rec->hClosing = PEAK_INVALID_HANDLE;
+
+    if (!frame_queue_init(&rec->queue, options->queueCapacity))
+    {
+        free(rec);
+        return NULL;
+    }
+    pthread_mutex_init(&rec->mutex, NULL);
+
+    return rec;
+}
+
+void recorder_destroy(recorder* rec)
+{
+    if (rec == NULL)
+    {
+        return;
+    }
+
+    recorder_stop(rec);
+    pthread_mutex_destroy(&rec->mutex);
+    frame_queue_destroy(&rec->queue);
+    free(rec);
+}
+
+peak_status recorder_start(recorder* rec)
+{
+    char path[512];
+    peak_video_handle hVideo = PEAK_INVALID_HANDLE;
+    peak_status status = openSegment(rec, &hVideo, path, sizeof(path));
+    if (!PEAK_SUCCESS(status))
+    {
+        return status;
+    }
+
+    pthread_mutex_lock(&rec->mutex);
+    rec->hVideo = hVideo;
+    rec->segments = 1;
+    snprintf(rec->currentFile, sizeof(rec->currentFile), "%s", path);
+    pthread_mutex_unlock(&rec->mutex);
+
+    rec->segmentOpened = monotonicSeconds();
+    rec->rotationRetry = 0.0;
+
+    if (pthread_create(&rec->encoderThread, NULL, encoderThread, rec) != 0)
+    {
+        printf("Could not start the encoding thread\n");
+        pthread_mutex_lock(&rec->mutex);
+        rec->hVideo = PEAK_INVALID_HANDLE;
+        pthread_mutex_unlock(&rec->mutex);
+        peak_VideoWriter_Close(hVideo);
+        return PEAK_STATUS_ERROR;
+    }
+    rec->encoderRunning = PEAK_TRUE;
+
+    return PEAK_STATUS_SUCCESS;
+}
+
+void recorder_stop(recorder* rec)
+{
+    if (!rec->encoderRunning)
+    {
+        return;
+    }
+
+    frame_queue_close(&rec->queue);
+    pthread_join(rec->encoderThread, NULL);
+    rec->encoderRunning = PEAK_FALSE;
+    joinCloser(rec);
+
+    pthread_mutex_lock(&rec->mutex);
+    rec->hClosing = rec->hVideo;
+    rec->hVideo = PEAK_INVALID_HANDLE;
+    pthread_mutex_unlock(&rec->mutex);
+
+    closerThread(rec);
+}
+
+peak_bool recorder_add_frame(recorder* rec, peak_frame_handle frame)
+{
+    const peak_bool queued = frame_queue_push(&rec->queue, frame);
+
+    pthread_mutex_lock(&rec->mutex);
+    rec->frames++;
+    if (!queued)
+    {
+        rec->queueDropped++;
+    }
+    pthread_mutex_unlock(&rec->mutex);
+
+    if (!queued)
+    {
+        peak_Frame_Release(rec->hCam, frame);
+    }
+    return queued;
+}
+
+void recorder_counters_get(recorder* rec, recorder_counters* counters)
+{
+    memset(counters, 0, sizeof(*counters));
+
+    pthread_mutex_lock(&rec->mutex);
+    counters->frames = rec->frames;
+    counters->queueDropped = rec->queueDropped;
+    counters->writeErrors = rec->writeErrors;
+    counters->rotationErrors = rec->rotationErrors;
+    counters->encoded = rec->closedEncoded;
+    counters->writerDropped = rec->closedDropped;
+    counters->bytes = rec->closedBytes;
+    counters->segments = rec->segments;
+    snprintf(counters->currentFile, sizeof(counters->currentFile), "%s", rec->currentFile);
+
+    const peak_video_handle open[2] = { rec->hVideo, rec->hClosing };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        peak_video_info info;
+        if (open[i] != PEAK_INVALID_HANDLE && PEAK_SUCCESS(peak_VideoWriter_GetInfo(open[i], &info)))
+        {
+            counters->encoded += info.encodedFrames;
+            counters->writerDropped += info.droppedFrames;
+            counters->bytes += info.fileSize;
+        }
+    }
+    pthread_mutex_unlock(&rec->mutex);
+
+    counters->queueDepth = frame_queue_depth(&rec->queue, &counters->queueHighWatermark);
+}
@@ -0,0 +1,77 @@
+/*!
+ * \file    recorder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Continuous video recorder. Acquired frames pass through a
+ *          frame_queue to an encoding thread, which feeds the video writer
+ *          and rotates to a new file by size or age. The next file is opened
+ *          before the previous one is closed, and the close runs on a thread
+ *          of its own, so no frame is lost at a segment boundary.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <ids_peak_comfort_c/ids_peak_comfort_c.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+    // Directory of the segment files, which are named <prefix>_<YYYYmmdd_HHMMSS>_<segment>.avi
+    const char* directory;
+    const char* prefix;
+    // A new segment is started once the current one reaches this size or age, 0 disables the limit
+    uint64_t maxSegmentBytes;
+    uint32_t maxSegmentSeconds;
+    double frameRate;
+    // MJPEG quality of every segment, 0 keeps the encoder default
+    uint32_t quality;
+    // Frames that may wait for the encoding thread before new frames are dropped
+    size_t queueCapacity;
+} recorder_options;
+
+/*!
+ * \brief Counters of a recorder. All values are totals since recorder_start, except the queue depth.
+ */
+typedef struct
+{
+    // Frames handed to recorder_add_frame
+    uint64_t frames;
+    // Frames not queued because the queue was full
+    uint64_t queueDropped;
+    // Frames encoded and dropped by the video writer, over all segments
+    uint64_t encoded;
+    uint64_t writerDropped;
+    // Frames the video writer rejected with an error
+    uint64_t writeErrors;
+    // Segments that could not be opened, the current one is continued then
+    uint64_t rotationErrors;
+    uint64_t bytes;
+    uint32_t segments;
+    size_t queueDepth;
+    size_t queueHighWatermark;
+    char currentFile[512];
+} recorder_counters;
+
+typedef struct recorder recorder;
+
+recorder* recorder_create(peak_camera_handle hCam, const recorder_options* options);
+void recorder_destroy(recorder* rec);
+
+// Opens the first segment and starts the encoding thread
+peak_status recorder_start(recorder* rec);
+
+// Encodes the frames still queued, then closes the last segment
+void recorder_stop(recorder* rec);
+
+// Takes ownership of \p frame, it is released once encoded or dropped. Never blocks.
+peak_bool recorder_add_frame(recorder* rec, peak_frame_handle frame);
+
+void recorder_counters_get(recorder* rec, recorder_counters* counters);
+
+#endif // RECORDER_H
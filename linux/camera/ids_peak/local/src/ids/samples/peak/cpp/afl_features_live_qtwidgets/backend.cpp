@@ -196,8 +196,8 @@ bool BackEnd::OpenDevice()
             auto payloadSize = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")
                                    ->Value();
 
-            // Get the minimum number of buffers that must be announced
-            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired();
+            // Get the minimum number of buffers that must be announced, plus the buffers that may wait for conversion
+            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired() + AcquisitionWorker::FrameRingCapacity;
 
             // Allocate and announce image buffers and queue them
             for (size_t bufferCount = 0; bufferCount < bufferCountMax; ++bufferCount)
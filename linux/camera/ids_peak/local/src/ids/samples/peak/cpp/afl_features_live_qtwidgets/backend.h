@@ -117,7 +117,7 @@ private:
 
 signals:
     void ImageReceived(QImage image);
-    void CounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void CounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void MessageBoxTrigger(QString messageTitle, QString messageText);
 };
 
@@ -976,14 +976,15 @@ void MainWindow::OnNewROI(QRectF roi)
     OnROIChanged();
 }
 
-void MainWindow::OnCounterChanged(unsigned int frameCounter, unsigned int errorCounter)
+void MainWindow::OnCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter)
 {
     // NOTE: if message box pops up during creation of the widgets, we might not have
     // created the labelInfo widget yet
     if (m_labelInfo != nullptr)
     {
-        m_labelInfo->setText(QString("Frames acquired: %1, errors: %2")
-                                 .arg(QString::number(frameCounter), QString::number(errorCounter)));
+        m_labelInfo->setText(QString("Frames acquired: %1, errors: %2, dropped: %3")
+                                 .arg(QString::number(frameCounter), QString::number(errorCounter),
+                                     QString::number(droppedCounter)));
     }
 }
 
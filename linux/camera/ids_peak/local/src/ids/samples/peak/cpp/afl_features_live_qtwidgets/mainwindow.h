@@ -114,7 +114,7 @@ public slots:
     static void ShowMessageBox(const QString& messageTitle, const QString& messageText);
     void OnFocusModeChange(const QString& text);
     void OnAutoFocusFinished();
-    void OnCounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void OnCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void On_aboutQt_linkActivated(const QString& link);
     void OnExposureChanged(int exposureTimeInUs);
     void OnGainChanged(int value);
@@ -0,0 +1,790 @@
+/*!
+ * \file    barcode_benchmark.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application checks the BarcodeDecoder against the labels in
+ *          linux/barcode/test and times it. Every label listed in the
+ *          corpus file is decoded upright, rotated and embedded in a Bayer
+ *          frame at the resolution of our cameras, which goes through the
+ *          same half resolution luma as in the capture service. It reports
+ *          the decode time of every kernel and exits with an error if any
+ *          label does not read as expected, or if a region only 1 to 3
+ *          pixels wide or high reads anything.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "barcodedecoder.h"
+#include "debayer.h"
+
+#ifndef BARCODE_CORPUS
+#    define BARCODE_CORPUS "."
+#endif
+
+
+struct Options
+{
+    // Directory with the labels and corpus.txt
+    std::string corpus = BARCODE_CORPUS;
+    size_t iterations = 50;
+    size_t frameWidth = 4000;
+    size_t frameHeight = 3000;
+    peak::ipl::PixelFormatName inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+};
+
+// A Mono8 image, rows tightly packed
+struct GrayImage
+{
+    size_t width = 0;
+    size_t height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// A label of the corpus and what it must read as
+struct Sample
+{
+    std::string file;
+    BarcodeSymbology symbology = BarcodeSymbology::Code128;
+    std::string text;
+    GrayImage image;
+};
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line: --corpus <dir>, --iterations <n>, --frame <width>x<height> and
+ * --pattern RG|GR|BG|GB.
+ */
+Options parse_options(int argc, char* argv[]);
+
+/*! \brief Load Corpus function
+ *
+ * The function reads corpus.txt in \p directory, one label per line as "<file>\t<symbology>\t<text>" with C escapes
+ * in the text, and loads each label. Throws std::runtime_error if a file can't be read.
+ */
+std::vector<Sample> load_corpus(const std::string& directory);
+
+/*! \brief Load Image function
+ *
+ * The function loads the first frame of a GIF or a binary PGM as Mono8. Throws std::runtime_error on failure.
+ */
+GrayImage load_image(const std::string& path);
+
+/*! \brief Pad function
+ *
+ * The function surrounds an image with \p margin white pixels on every side.
+ */
+GrayImage pad(const GrayImage& image, size_t margin);
+
+/*! \brief Rotate function
+ *
+ * The function rotates an image clockwise by \p quarters quarter turns.
+ */
+GrayImage rotate(const GrayImage& image, size_t quarters);
+
+/*! \brief Create Bayer Frame function
+ *
+ * The function renders a lit background with sensor noise, places \p label at twice its size off centre and samples
+ * it with the given Bayer pattern, with a different gain per colour.
+ */
+std::vector<uint8_t> create_bayer_frame(
+    peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height, const GrayImage& label);
+
+/*! \brief Check Thin Regions function
+ *
+ * The function decodes strips 1 to 3 pixels wide and high along every edge of \p image, where the interpolation of
+ * the scan lines could reach past the region, and returns how many of them read anything. Run under AddressSanitizer
+ * it also catches reads outside the image.
+ */
+size_t check_thin_regions(const BarcodeDecoder& decoder, const GrayImage& image);
+
+/*! \brief Measure function
+ *
+ * The function runs the operation for the given number of iterations and
+ * returns the mean time per run in milliseconds.
+ */
+template <typename Operation>
+double measure(size_t iterations, Operation operation);
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"barcode_benchmark\" v" << VERSION << std::endl;
+
+    const auto options = parse_options(argc, argv);
+    const auto lumaWidth = options.frameWidth / 2;
+    const auto lumaHeight = options.frameHeight / 2;
+
+    size_t failures = 0;
+    try
+    {
+        const auto samples = load_corpus(options.corpus);
+        std::cout << "Corpus: " << options.corpus << ", " << samples.size() << " label(s), " << options.iterations
+                  << " iterations, frame " << options.frameWidth << "x" << options.frameHeight << " "
+                  << peak::ipl::PixelFormat(options.inputPixelFormat).Name() << std::endl
+                  << std::endl;
+
+        std::cout << std::left << std::setw(24) << "label" << std::setw(10) << "variant" << std::setw(8) << "isa"
+                  << std::right << std::setw(12) << "ms/decode" << "  " << std::left << "result" << std::endl;
+
+        const Debayer debayer;
+        std::vector<uint8_t> luma(lumaWidth * lumaHeight);
+
+        for (const auto& sample : samples)
+        {
+            auto check = [&](const std::vector<DecodedBarcode>& barcodes) {
+                const auto found = std::find_if(barcodes.begin(), barcodes.end(), [&](const DecodedBarcode& barcode) {
+                    return barcode.symbology == sample.symbology && barcode.text == sample.text;
+                });
+                if (found == barcodes.end())
+                {
+                    failures++;
+                    return std::string(barcodes.empty() ? "FAIL nothing read" : "FAIL read " + barcodes.front().text);
+                }
+                // Anything else read alongside is a misread
+                if (barcodes.size() > 1)
+                {
+                    failures++;
+                    return "FAIL also read " + (found == barcodes.begin() ? barcodes[1] : barcodes.front()).text;
+                }
+                return "ok, " + std::to_string(found->votes) + " votes";
+            };
+
+            auto printRow = [&](const std::string& variant, BarcodeDecoder::Isa isa, double ms,
+                                const std::string& result) {
+                std::cout << std::left << std::setw(24) << sample.file.substr(0, 23) << std::setw(10) << variant
+                          << std::setw(8) << BarcodeDecoder::IsaName(isa) << std::right << std::fixed
+                          << std::setprecision(3) << std::setw(12) << ms << "  " << std::left << result << std::endl;
+            };
+
+            const auto frame = create_bayer_frame(
+                options.inputPixelFormat, options.frameWidth, options.frameHeight, sample.image);
+            const auto lumaMs = measure(options.iterations, [&] {
+                debayer.ConvertScaled(frame.data(), options.frameWidth, options.frameHeight, options.inputPixelFormat,
+                    luma.data(), lumaWidth, lumaHeight, lumaWidth, peak::ipl::PixelFormatName::Mono8);
+            });
+            std::cout << std::left << std::setw(24) << sample.file.substr(0, 23) << std::setw(10) << "luma"
+                      << std::setw(8) << Debayer::IsaName(debayer.SelectedIsa()) << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(12) << lumaMs << "  " << std::left << lumaWidth << "x"
+                      << lumaHeight << std::endl;
+
+            for (const auto isa : BarcodeDecoder::AvailableIsas())
+            {
+                const BarcodeDecoder decoder(BarcodeDecoderOptions(), isa);
+
+                for (size_t quarters = 0; quarters < 4; ++quarters)
+                {
+                    const auto image = rotate(sample.image, quarters);
+                    std::vector<DecodedBarcode> barcodes;
+                    const auto ms = measure(options.iterations, [&] {
+                        barcodes = decoder.Decode(image.pixels.data(), image.width, image.height, image.width);
+                    });
+                    printRow("label " + std::to_string(90 * quarters), isa, ms, check(barcodes));
+                }
+
+                std::vector<DecodedBarcode> barcodes;
+                const auto ms = measure(options.iterations,
+                    [&] { barcodes = decoder.Decode(luma.data(), lumaWidth, lumaHeight, lumaWidth); });
+                printRow("frame", isa, ms, check(barcodes));
+            }
+        }
+
+        // Any label will do, the strips hold no readable barcode
+        if (!samples.empty())
+        {
+            for (const auto isa : BarcodeDecoder::AvailableIsas())
+            {
+                const BarcodeDecoder decoder(BarcodeDecoderOptions(), isa);
+                const auto thinFailures = check_thin_regions(decoder, samples[0].image);
+                failures += thinFailures;
+                std::cout << std::left << std::setw(24) << "thin regions" << std::setw(10) << "1..3 px" << std::setw(8)
+                          << BarcodeDecoder::IsaName(isa) << std::right << std::setw(12) << "" << "  " << std::left
+                          << (thinFailures ? "FAIL " + std::to_string(thinFailures) + " read something" : "ok")
+                          << std::endl;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::endl << (failures ? std::to_string(failures) + " failure(s)" : "All labels read") << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = (i + 1) < argc;
+
+        if (argument == "--corpus" && hasValue)
+        {
+            options.corpus = argv[++i];
+        }
+        else if (argument == "--iterations" && hasValue)
+        {
+            options.iterations = std::max<size_t>(std::stoul(argv[++i]), 1);
+        }
+        else if (argument == "--frame" && hasValue)
+        {
+            const std::string size = argv[++i];
+            const auto separator = size.find('x');
+            if (separator == std::string::npos || std::stoul(size) < 64 || std::stoul(size.substr(separator + 1)) < 64)
+            {
+                std::cout << "Ignoring invalid frame size: " << size << std::endl;
+                continue;
+            }
+            // Whole Bayer cells
+            options.frameWidth = std::stoul(size) & ~size_t{ 1 };
+            options.frameHeight = std::stoul(size.substr(separator + 1)) & ~size_t{ 1 };
+        }
+        else if (argument == "--pattern" && hasValue)
+        {
+            const std::string pattern = argv[++i];
+            if (pattern == "RG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+            }
+            else if (pattern == "GR")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGR8;
+            }
+            else if (pattern == "BG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerBG8;
+            }
+            else if (pattern == "GB")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGB8;
+            }
+            else
+            {
+                std::cout << "Ignoring unknown pattern: " << pattern << std::endl;
+            }
+        }
+        else
+        {
+            std::cout << "Ignoring unknown argument: " << argument << std::endl;
+        }
+    }
+
+    return options;
+}
+
+namespace
+{
+
+// \t, \\ and \xNN, so labels can hold characters a file name or a tab separated line can't
+std::string unescape(const std::string& text)
+{
+    std::string result;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] != '\\' || i + 1 == text.size())
+        {
+            result += text[i];
+            continue;
+        }
+
+        const auto escaped = text[++i];
+        if (escaped == 't')
+        {
+            result += '\t';
+        }
+        else if (escaped == 'x' && i + 2 < text.size())
+        {
+            result += static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else
+        {
+            result += escaped;
+        }
+    }
+    return result;
+}
+
+BarcodeSymbology symbology(const std::string& name)
+{
+    for (const auto candidate : { BarcodeSymbology::Code128, BarcodeSymbology::Ean13, BarcodeSymbology::Ean8,
+             BarcodeSymbology::QrCode, BarcodeSymbology::DataMatrix })
+    {
+        if (name == BarcodeSymbologyName(candidate))
+        {
+            return candidate;
+        }
+    }
+    throw std::runtime_error("Unknown symbology in the corpus: " + name);
+}
+
+// Reads the LSB first variable length codes of GIF image data
+class CodeReader
+{
+
+public:
+    explicit CodeReader(const std::vector<uint8_t>& data)
+        : m_data(data)
+    {}
+
+    // -1 at the end of the data
+    int Read(unsigned size)
+    {
+        while (m_bitCount < size)
+        {
+            if (m_position == m_data.size())
+            {
+                return -1;
+            }
+            m_bits |= static_cast<uint32_t>(m_data[m_position++]) << m_bitCount;
+            m_bitCount += 8;
+        }
+        const auto code = static_cast<int>(m_bits & ((1u << size) - 1));
+        m_bits >>= size;
+        m_bitCount -= size;
+        return code;
+    }
+
+private:
+    const std::vector<uint8_t>& m_data;
+    size_t m_position = 0;
+    uint32_t m_bits = 0;
+    unsigned m_bitCount = 0;
+};
+
+// Colour indices of one GIF image from its LZW data
+std::vector<uint8_t> decompressLzw(const std::vector<uint8_t>& data, unsigned minimumCodeSize, size_t pixelCount)
+{
+    if (minimumCodeSize < 2 || minimumCodeSize > 8)
+    {
+        throw std::runtime_error("Invalid GIF code size");
+    }
+
+    const int clear = 1 << minimumCodeSize;
+    const int end = clear + 1;
+    std::vector<int> prefixes(4096, -1);
+    std::vector<uint8_t> suffixes(4096, 0);
+    for (int code = 0; code < clear; ++code)
+    {
+        suffixes[static_cast<size_t>(code)] = static_cast<uint8_t>(code);
+    }
+
+    std::vector<uint8_t> indices;
+    indices.reserve(pixelCount);
+    std::vector<uint8_t> stack;
+    CodeReader reader(data);
+    unsigned codeSize = minimumCodeSize + 1;
+    int next = clear + 2;
+    int previous = -1;
+    uint8_t first = 0;
+
+    while (indices.size() < pixelCount)
+    {
+        const auto code = reader.Read(codeSize);
+        if (code < 0 || code == end)
+        {
+            break;
+        }
+        if (code == clear)
+        {
+            codeSize = minimumCodeSize + 1;
+            next = clear + 2;
+            previous = -1;
+            continue;
+        }
+        if (previous < 0)
+        {
+            first = suffixes[static_cast<size_t>(code)];
+            indices.push_back(first);
+            previous = code;
+            continue;
+        }
+
+        // A code not in the table yet is the previous string plus its own first character
+        auto current = code;
+        stack.clear();
+        if (code >= next)
+        {
+            stack.push_back(first);
+            current = previous;
+        }
+        while (current >= clear)
+        {
+            stack.push_back(suffixes[static_cast<size_t>(current)]);
+            current = prefixes[static_cast<size_t>(current)];
+        }
+        first = static_cast<uint8_t>(current);
+        stack.push_back(first);
+        indices.insert(indices.end(), stack.rbegin(), stack.rend());
+
+        if (next < 4096)
+        {
+            prefixes[static_cast<size_t>(next)] = previous;
+            suffixes[static_cast<size_t>(next)] = first;
+            next++;
+            if (next == (1 << codeSize) && codeSize < 12)
+            {
+                codeSize++;
+            }
+        }
+        previous = code;
+    }
+
+    indices.resize(pixelCount, 0);
+    return indices;
+}
+
+GrayImage loadGif(const std::vector<uint8_t>& file)
+{
+    size_t position = 0;
+    auto byte = [&]() -> uint8_t {
+        if (position >= file.size())
+        {
+            throw std::runtime_error("Truncated GIF");
+        }
+        return file[position++];
+    };
+    // Little endian, the operands of | may be evaluated in any order
+    auto word = [&]() {
+        const size_t low = byte();
+        return low | (static_cast<size_t>(byte()) << 8);
+    };
+    auto palette = [&](uint8_t flags) {
+        // BT.601 luma of each colour, like the Mono8 output of the Debayer
+        std::vector<uint8_t> grays(size_t{ 2 } << (flags & 7));
+        for (auto& gray : grays)
+        {
+            const unsigned red = byte();
+            const unsigned green = byte();
+            const unsigned blue = byte();
+            gray = static_cast<uint8_t>((77 * red + 150 * green + 29 * blue + 128) >> 8);
+        }
+        return grays;
+    };
+
+    if (file.size() < 13 || std::string(file.begin(), file.begin() + 3) != "GIF")
+    {
+        throw std::runtime_error("Not a GIF");
+    }
+    position = 6;
+
+    GrayImage image;
+    image.width = word();
+    image.height = word();
+    const auto screenFlags = byte();
+    position += 2;
+    std::vector<uint8_t> globalPalette;
+    if (screenFlags & 0x80)
+    {
+        globalPalette = palette(screenFlags);
+    }
+    // Anything the first image does not cover stays white, like the paper around a label
+    image.pixels.assign(image.width * image.height, 255);
+
+    while (true)
+    {
+        const auto block = byte();
+        if (block == 0x21)
+        {
+            // Extensions are skipped, including the transparency of the graphic control extension
+            byte();
+            for (auto length = byte(); length; length = byte())
+            {
+                position += length;
+            }
+            continue;
+        }
+        if (block != 0x2C)
+        {
+            throw std::runtime_error("GIF without an image");
+        }
+
+        const auto left = word();
+        const auto top = word();
+        const auto width = word();
+        const auto height = word();
+        const auto flags = byte();
+        const auto grays = (flags & 0x80) ? palette(flags) : globalPalette;
+        if (grays.empty() || left + width > image.width || top + height > image.height)
+        {
+            throw std::runtime_error("Unsupported GIF image");
+        }
+
+        const auto minimumCodeSize = byte();
+        std::vector<uint8_t> data;
+        for (auto length = byte(); length; length = byte())
+        {
+            if (position + length > file.size())
+            {
+                throw std::runtime_error("Truncated GIF");
+            }
+            data.insert(data.end(), file.begin() + position, file.begin() + position + length);
+            position += length;
+        }
+        const auto indices = decompressLzw(data, minimumCodeSize, width * height);
+
+        // Interlaced images store every 8th row from 0, every 8th from 4, every 4th from 2, then every 2nd from 1
+        std::vector<size_t> rows;
+        if (flags & 0x40)
+        {
+            const size_t passes[4][2] = { { 0, 8 }, { 4, 8 }, { 2, 4 }, { 1, 2 } };
+            for (const auto& pass : passes)
+            {
+                for (auto row = pass[0]; row < height; row += pass[1])
+                {
+                    rows.push_back(row);
+                }
+            }
+        }
+        else
+        {
+            for (size_t row = 0; row < height; ++row)
+            {
+                rows.push_back(row);
+            }
+        }
+
+        for (size_t row = 0; row < height; ++row)
+        {
+            auto* output = image.pixels.data() + (top + rows[row]) * image.width + left;
+            for (size_t x = 0; x < width; ++x)
+            {
+                output[x] = grays[std::min<size_t>(indices[row * width + x], grays.size() - 1)];
+            }
+        }
+        return image;
+    }
+}
+
+GrayImage loadPgm(const std::vector<uint8_t>& file)
+{
+    std::istringstream header(std::string(file.begin(), file.begin() + std::min<size_t>(file.size(), 256)));
+    std::string magic;
+    size_t maximum = 0;
+    GrayImage image;
+    header >> magic >> image.width >> image.height >> maximum;
+    if (!header || magic != "P5" || maximum != 255)
+    {
+        throw std::runtime_error("Only binary 8 bit PGM is supported");
+    }
+
+    // Exactly one whitespace character separates the header from the pixels
+    const auto offset = static_cast<size_t>(header.tellg()) + 1;
+    if (offset + image.width * image.height > file.size())
+    {
+        throw std::runtime_error("Truncated PGM");
+    }
+    image.pixels.assign(file.begin() + offset, file.begin() + offset + image.width * image.height);
+    return image;
+}
+
+} // namespace
+
+std::vector<Sample> load_corpus(const std::string& directory)
+{
+    std::ifstream corpus(directory + "/corpus.txt");
+    if (!corpus)
+    {
+        throw std::runtime_error("Failed to open " + directory + "/corpus.txt");
+    }
+
+    std::vector<Sample> samples;
+    std::string line;
+    while (std::getline(corpus, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        Sample sample;
+        std::string name;
+        std::string text;
+        if (!std::getline(fields, sample.file, '\t') || !std::getline(fields, name, '\t')
+            || !std::getline(fields, text))
+        {
+            throw std::runtime_error("Invalid corpus line: " + line);
+        }
+        sample.symbology = symbology(name);
+        sample.text = unescape(text);
+        // The labels are cropped at the bars, on paper they have the quiet zone around them the decoder expects
+        sample.image = pad(load_image(directory + "/" + sample.file), 32);
+        samples.push_back(std::move(sample));
+    }
+    return samples;
+}
+
+GrayImage load_image(const std::string& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    const std::vector<uint8_t> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    try
+    {
+        const auto extension = path.substr(path.find_last_of('.') + 1);
+        return extension == "pgm" ? loadPgm(file) : loadGif(file);
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+GrayImage pad(const GrayImage& image, size_t margin)
+{
+    GrayImage padded;
+    padded.width = image.width + 2 * margin;
+    padded.height = image.height + 2 * margin;
+    padded.pixels.assign(padded.width * padded.height, 255);
+    for (size_t y = 0; y < image.height; ++y)
+    {
+        std::copy_n(image.pixels.data() + y * image.width, image.width,
+            padded.pixels.data() + (y + margin) * padded.width + margin);
+    }
+    return padded;
+}
+
+GrayImage rotate(const GrayImage& image, size_t quarters)
+{
+    GrayImage rotated = image;
+    for (size_t turn = 0; turn < quarters % 4; ++turn)
+    {
+        const auto source = rotated;
+        rotated.width = source.height;
+        rotated.height = source.width;
+        for (size_t y = 0; y < rotated.height; ++y)
+        {
+            for (size_t x = 0; x < rotated.width; ++x)
+            {
+                rotated.pixels[y * rotated.width + x] = source.pixels[(source.height - 1 - x) * source.width + y];
+            }
+        }
+    }
+    return rotated;
+}
+
+std::vector<uint8_t> create_bayer_frame(
+    peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height, const GrayImage& label)
+{
+    // Colour channel (0 = red, 1 = green, 2 = blue) at the even/odd row and column of the 2x2 cell
+    int cell[2][2] = { { 0, 1 }, { 1, 2 } };
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BayerGR8:
+        cell[0][0] = 1, cell[0][1] = 0, cell[1][0] = 2, cell[1][1] = 1;
+        break;
+    case peak::ipl::PixelFormatName::BayerBG8:
+        cell[0][0] = 2, cell[0][1] = 1, cell[1][0] = 1, cell[1][1] = 0;
+        break;
+    case peak::ipl::PixelFormatName::BayerGB8:
+        cell[0][0] = 1, cell[0][1] = 2, cell[1][0] = 0, cell[1][1] = 1;
+        break;
+    default:
+        break;
+    }
+
+    // Paper under warm light: the label is printed in grey, each channel sees it with its own gain
+    const double gains[3] = { 0.9, 1.0, 0.75 };
+
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 2.0);
+
+    // The label at twice its size, so the half resolution luma shows it at its own size
+    const auto labelLeft = std::min(width / 3, width - std::min(width, 2 * label.width));
+    const auto labelTop = std::min(height / 3, height - std::min(height, 2 * label.height));
+
+    std::vector<uint8_t> frame(width * height);
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            // A tray in shades of grey, lit unevenly
+            auto scene = 90.0 + 60.0 * static_cast<double>(x + y) / static_cast<double>(width + height);
+            if (x >= labelLeft && y >= labelTop && x < labelLeft + 2 * label.width && y < labelTop + 2 * label.height)
+            {
+                scene = 0.9 * label.pixels[((y - labelTop) / 2) * label.width + (x - labelLeft) / 2];
+            }
+
+            const auto value = gains[cell[y & 1][x & 1]] * scene + noise(random);
+            frame[y * width + x] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::round(value))));
+        }
+    }
+    return frame;
+}
+
+size_t check_thin_regions(const BarcodeDecoder& decoder, const GrayImage& image)
+{
+    std::vector<BarcodeDecoder::Region> regions;
+    for (size_t thickness = 1; thickness <= 3; ++thickness)
+    {
+        BarcodeDecoder::Region region;
+        region.width = thickness;
+        region.height = image.height;
+        regions.push_back(region);
+        region.x = image.width - thickness;
+        regions.push_back(region);
+
+        region.x = 0;
+        region.width = image.width;
+        region.height = thickness;
+        regions.push_back(region);
+        region.y = image.height - thickness;
+        regions.push_back(region);
+    }
+
+    size_t failures = 0;
+    for (const auto& region : regions)
+    {
+        if (!decoder.Decode(image.pixels.data(), image.width, image.height, image.width, region).empty())
+        {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+template <typename Operation>
+double measure(size_t iterations, Operation operation)
+{
+    // One untimed run warms up caches and lazy allocations
+    operation();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        operation();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    return elapsed.count() / static_cast<double>(iterations);
+}
@@ -0,0 +1,640 @@
+/*!
+ * \file    acquisitionworker.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The AcquisitionWorker class keeps the data stream armed in software
+ *          trigger mode with all buffers queued, so that a capture only costs
+ *          TriggerSoftware and WaitForFinishedBuffer. Finished buffers are
+ *          handed through a FrameRing to a ConversionPool, converted and
+ *          handed to a WriteBehindQueue as JPEG in FrameID order, so a slow
+ *          disk delays neither the next frame nor the trigger response. With
+ *          a BlackBox the camera runs free, every frame is recorded into it
+ *          and a trigger takes the next finished frame. Smaller JPEG
+ *          outputs such as a thumbnail are written along with each frame.
+ *          Frames no capture asked for feed a LivePreview, in trigger mode
+ *          they are triggered for it while somebody watches and the camera is
+ *          not busy with a capture.
+ *
+ * \version 1.0.0
+ */
+
+#include "acquisitionworker.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+
+AcquisitionWorker::AcquisitionWorker(std::shared_ptr<peak::core::DataStream> dataStream,
+    const std::string& outputPath, size_t conversionThreads, bool useDebayer, bool encodeBayerJpeg,
+    size_t jpegThreads, WriteBehindOptions writeOptions, std::vector<JpegOutput> jpegOutputs)
+    : m_writeQueue(writeOptions)
+{
+    m_dataStream = dataStream;
+    m_nodemapRemoteDevice = m_dataStream->ParentDevice()->RemoteDevice()->NodeMaps().at(0);
+    m_outputPath = outputPath;
+
+    // Twice the thread count keeps every worker busy while the oldest frame is still being converted
+    m_conversionPool = std::make_unique<ConversionPool>(
+        conversionThreads, 2 * conversionThreads,
+        [this](ConvertedFrame& frame) {
+            // A frame its trigger gave up on is not written, the pool has requeued its buffer already
+            if (claimResult(frame.trigger))
+            {
+                deliverResult(writeFrame(frame));
+            }
+        },
+        [this](const std::shared_ptr<peak::core::Buffer>& buffer) {
+            // Queue buffer so that it can be used again by the next trigger
+            m_dataStream->QueueBuffer(buffer);
+        });
+    m_conversionPool->SetUseDebayer(useDebayer);
+    m_conversionPool->SetJpegEncoding(encodeBayerJpeg, 75, jpegThreads);
+    m_conversionPool->SetJpegOutputs(std::move(jpegOutputs));
+    m_conversionPool->SetLatencyRecorder(&m_latency);
+    m_writeQueue.SetLatencyRecorder(&m_latency);
+}
+
+AcquisitionWorker::~AcquisitionWorker()
+{
+    Stop();
+}
+
+void AcquisitionWorker::SetBlackBox(BlackBox* blackBox)
+{
+    m_blackBox = blackBox;
+}
+
+void AcquisitionWorker::SetLivePreview(LivePreview* livePreview)
+{
+    m_livePreview = livePreview;
+}
+
+void AcquisitionWorker::SetBarcodeDecoding(BarcodeDecoderOptions options, Debayer::Region region)
+{
+    m_conversionPool->SetBarcodeDecoding(true, std::move(options), region);
+}
+
+void AcquisitionWorker::Start()
+{
+    // Lock critical features to prevent them from changing during acquisition
+    m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(1);
+
+    // Determine image size
+    m_imageWidth = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Width")->Value();
+    m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
+
+    // Pre-allocate the conversion once, so a trigger never pays for it
+    const auto inputPixelFormat = static_cast<peak::ipl::PixelFormatName>(
+        m_nodemapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("PixelFormat")
+            ->CurrentEntry()
+            ->Value());
+
+    m_conversionPool->Start(inputPixelFormat, peak::ipl::PixelFormatName::RGB8, m_imageWidth, m_imageHeight);
+
+    // Start acquisition. With TriggerMode "On" the camera now waits for TriggerSoftware with all buffers queued, with
+    // "Off" and a black box it runs free.
+    m_dataStream->StartAcquisition();
+    m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->Execute();
+    m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->WaitUntilDone();
+
+    m_writeQueue.Start();
+
+    if (m_livePreview)
+    {
+        m_livePreview->Start([this](const std::shared_ptr<peak::core::Buffer>& buffer) {
+            try
+            {
+                m_dataStream->QueueBuffer(buffer);
+            }
+            catch (const std::exception& e)
+            {
+                m_errorCounter++;
+                std::cout << "EXCEPTION: " << e.what() << std::endl;
+            }
+        });
+    }
+
+    m_pendingTrigger = 0;
+    m_frameOverdue = false;
+    m_staleBefore_ns = 0;
+
+    m_running = true;
+    m_conversionThread = std::thread(&AcquisitionWorker::dispatchFrames, this);
+    m_thread = std::thread(&AcquisitionWorker::run, this);
+    if (m_livePreview && !m_blackBox)
+    {
+        m_previewThread = std::thread(&AcquisitionWorker::triggerPreviews, this);
+    }
+}
+
+void AcquisitionWorker::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_running = false;
+
+    m_previewCondition.notify_all();
+    if (m_previewThread.joinable())
+    {
+        m_previewThread.join();
+    }
+
+    try
+    {
+        // Abort a pending WaitForFinishedBuffer so the worker thread can terminate
+        m_dataStream->KillWait();
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+    }
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    m_frameRing.WakeConsumer();
+    if (m_conversionThread.joinable())
+    {
+        m_conversionThread.join();
+    }
+
+    // Frames the conversion thread did not get to go back to the data stream, so the next Start() has every buffer
+    m_frameRing.Drain([this](Frame& frame) {
+        try
+        {
+            m_dataStream->QueueBuffer(frame.buffer);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    });
+
+    // Gives back the buffer of a preview frame still being encoded
+    if (m_livePreview)
+    {
+        m_livePreview->Stop();
+    }
+
+    // Finishes the frames already submitted, their results still reach a waiting trigger
+    m_conversionPool->Stop();
+
+    // Writes the files still queued
+    m_writeQueue.Stop();
+
+    // Release a caller that is still waiting for a triggered frame
+    {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        if (m_triggerPending)
+        {
+            m_result = CaptureResult();
+            m_result.error = "Acquisition stopped";
+            m_triggerPending = false;
+            m_resultReady = true;
+        }
+    }
+    m_resultCondition.notify_all();
+}
+
+CaptureResult AcquisitionWorker::Trigger(uint64_t timeout_ms)
+{
+    std::lock_guard<std::mutex> triggerLock(m_triggerMutex);
+
+    CaptureResult result;
+
+    if (!m_running)
+    {
+        result.error = "Acquisition is not running";
+        return result;
+    }
+
+    // The frame of a trigger that timed out may still arrive after this trigger fired. The device timestamp latched
+    // now tells it apart, which costs a node access and is only done after such a timeout. Timestamps are in ns.
+    if (!m_blackBox && m_frameOverdue.exchange(false))
+    {
+        try
+        {
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TimestampLatch")->Execute();
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TimestampLatch")->WaitUntilDone();
+            m_staleBefore_ns = static_cast<uint64_t>(
+                m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("TimestampLatchValue")->Value());
+        }
+        catch (const std::exception& e)
+        {
+            // Without the latch the late frame answers this trigger
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        generation = ++m_generation;
+        m_triggerGeneration = generation;
+        m_triggerPending = true;
+        m_resultReady = false;
+        m_resultClaimed = false;
+        m_triggerTime = std::chrono::steady_clock::now();
+    }
+    m_pendingTrigger = generation;
+    m_waitStart = m_triggerTime.time_since_epoch().count();
+
+    try
+    {
+        // A free running camera delivers the next frame anyway
+        if (!m_blackBox)
+        {
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TriggerSoftware")->Execute();
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TriggerSoftware")->WaitUntilDone();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        m_triggerPending = false;
+        m_triggerGeneration = 0;
+        m_pendingTrigger = 0;
+        m_waitStart = 0;
+
+        result.error = e.what();
+        return result;
+    }
+
+    std::unique_lock<std::mutex> lock(m_resultMutex);
+    if (!m_resultCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+            [this] { return m_resultReady || m_resultClaimed; }))
+    {
+        // The frame, if it still comes, carries this generation and is requeued without being converted or written.
+        // Once it is in the conversion pool the sink drops it instead.
+        m_triggerPending = false;
+        m_triggerGeneration = 0;
+        auto pending = generation;
+        if (m_pendingTrigger.compare_exchange_strong(pending, 0) && !m_blackBox)
+        {
+            m_frameOverdue = true;
+        }
+
+        result.error = "Timeout while waiting for the triggered frame";
+        return result;
+    }
+
+    // The sink has the frame, queuing its files takes no time
+    m_resultCondition.wait(lock, [this] { return m_resultReady; });
+    return m_result;
+}
+
+unsigned int AcquisitionWorker::FrameCounter() const
+{
+    return m_frameCounter;
+}
+
+unsigned int AcquisitionWorker::ErrorCounter() const
+{
+    return m_errorCounter;
+}
+
+FrameRingCounters AcquisitionWorker::RingCounters() const
+{
+    return m_frameRing.Counters();
+}
+
+ConversionPoolCounters AcquisitionWorker::PoolCounters() const
+{
+    return m_conversionPool->Counters();
+}
+
+WriteBehindCounters AcquisitionWorker::WriteCounters() const
+{
+    return m_writeQueue.Counters();
+}
+
+const LatencyRecorder& AcquisitionWorker::Latency() const
+{
+    return m_latency;
+}
+
+LatencyRecorder& AcquisitionWorker::Latency()
+{
+    return m_latency;
+}
+
+size_t AcquisitionWorker::BuffersInFlight() const
+{
+    // Frames waiting in the ring, plus the frames submitted to the pool that are not converted yet, plus the frame the
+    // live preview encodes
+    return FrameRingCapacity + m_conversionPool->ReorderWindow() + (m_livePreview ? 1 : 0);
+}
+
+void AcquisitionWorker::run()
+{
+    while (m_running)
+    {
+        std::shared_ptr<peak::core::Buffer> buffer;
+
+        try
+        {
+            // Get buffer from device's datastream. The timeout only bounds the reaction time to Stop().
+            buffer = m_dataStream->WaitForFinishedBuffer(500);
+        }
+        catch (const peak::core::TimeoutException&)
+        {
+            continue;
+        }
+        catch (const peak::core::AbortedException&)
+        {
+            continue;
+        }
+        catch (const std::exception& e)
+        {
+            m_errorCounter++;
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+
+            // Without a sleep a broken stream would keep this thread spinning
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        if (m_blackBox)
+        {
+            m_blackBox->Record(buffer);
+        }
+
+        const auto waitStart = m_waitStart.exchange(0);
+        if (waitStart != 0)
+        {
+            m_latency.Record(LatencyStage::Wait,
+                std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(waitStart)));
+        }
+
+        // A preview trigger holds the trigger mutex until its frame is here, so no capture frame can be mistaken for it
+        const bool previewFrame = !m_blackBox && m_previewPending.exchange(false);
+        if (previewFrame)
+        {
+            // Passing through the mutex keeps the notification from slipping in before triggerPreviews() waits
+            {
+                std::lock_guard<std::mutex> lock(m_previewMutex);
+            }
+            m_previewCondition.notify_all();
+        }
+
+        // The first frame after a trigger answers it. A frame exposed before the trigger fired is the overdue one of a
+        // trigger that timed out, it answers nothing.
+        auto trigger = previewFrame ? 0 : m_pendingTrigger.exchange(0);
+        const auto staleBefore = m_staleBefore_ns.load();
+        if (trigger && staleBefore && buffer->Timestamp_ns() < staleBefore)
+        {
+            // Hands the trigger back to the next frame, unless it has timed out meanwhile
+            uint64_t none = 0;
+            m_pendingTrigger.compare_exchange_strong(none, trigger);
+            trigger = 0;
+        }
+        if (!trigger && !previewFrame && !m_blackBox)
+        {
+            // The overdue frame arrived before the next trigger fired
+            m_frameOverdue = false;
+        }
+
+        // A free running camera delivers far more frames than are triggered, only the triggered ones are converted.
+        // The others, and frames no trigger waits for any more, go to the live preview if it wants one.
+        const bool untriggered = trigger == 0;
+        if (untriggered && m_livePreview && m_livePreview->Offer(buffer))
+        {
+            continue;
+        }
+
+        auto frame = Frame::FromBuffer(buffer);
+        frame.trigger = trigger;
+        if (untriggered || !m_frameRing.TryPush(std::move(frame)))
+        {
+            // Not triggered, or the conversion thread is behind. Requeue the buffer right away instead of starving
+            // the camera, in the latter case the frame is counted as dropped by the ring.
+            try
+            {
+                LatencyRecorder::Scope timing(&m_latency, LatencyStage::Requeue);
+                m_dataStream->QueueBuffer(buffer);
+            }
+            catch (const std::exception& e)
+            {
+                m_errorCounter++;
+                std::cout << "EXCEPTION: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+void AcquisitionWorker::dispatchFrames()
+{
+    while (m_running)
+    {
+        Frame frame;
+        if (!m_frameRing.Pop(frame, std::chrono::milliseconds(100)))
+        {
+            continue;
+        }
+
+        // Waiting for room in the reorder window is fine here, the frame ring in front absorbs the back-pressure
+        auto buffer = frame.buffer;
+        bool submitted = false;
+        while (m_running && !submitted)
+        {
+            submitted = m_conversionPool->Submit(frame, std::chrono::milliseconds(100));
+        }
+
+        if (!submitted)
+        {
+            try
+            {
+                m_dataStream->QueueBuffer(buffer);
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "EXCEPTION: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+void AcquisitionWorker::triggerPreviews()
+{
+    // Bounds how long a lost preview frame can hold back a capture
+    const auto frameTimeout = std::chrono::milliseconds(1000);
+    // How often to look for viewers and for a free camera
+    const auto pollInterval = std::chrono::milliseconds(10);
+
+    while (m_running)
+    {
+        if (!m_livePreview->Wanted())
+        {
+            std::unique_lock<std::mutex> lock(m_previewMutex);
+            m_previewCondition.wait_for(lock, pollInterval, [this] { return !m_running; });
+            continue;
+        }
+
+        // A capture has the camera, the preview skips a beat instead of delaying the next one
+        std::unique_lock<std::mutex> triggerLock(m_triggerMutex, std::try_to_lock);
+        if (!triggerLock.owns_lock())
+        {
+            std::unique_lock<std::mutex> lock(m_previewMutex);
+            m_previewCondition.wait_for(lock, pollInterval, [this] { return !m_running; });
+            continue;
+        }
+
+        m_previewPending = true;
+        try
+        {
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TriggerSoftware")->Execute();
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("TriggerSoftware")->WaitUntilDone();
+        }
+        catch (const std::exception& e)
+        {
+            m_previewPending = false;
+            m_errorCounter++;
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+
+            // A broken trigger would otherwise be retried at full speed
+            std::unique_lock<std::mutex> lock(m_previewMutex);
+            m_previewCondition.wait_for(lock, std::chrono::milliseconds(100), [this] { return !m_running; });
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_previewMutex);
+        if (!m_previewCondition.wait_for(
+                lock, frameTimeout, [this] { return !m_running || !m_previewPending; }))
+        {
+            // A frame arriving after this point goes down the capture path, like any frame in trigger mode used to
+            m_previewPending = false;
+        }
+    }
+}
+
+CaptureResult AcquisitionWorker::writeFrame(ConvertedFrame& frame)
+{
+    CaptureResult result;
+    result.frameId = frame.frameId;
+    result.timestamp_ns = frame.timestamp_ns;
+    result.error = frame.error;
+    result.barcodes = std::move(frame.barcodes);
+
+    if (!result.error.empty())
+    {
+        m_errorCounter++;
+        return result;
+    }
+
+    const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+
+    // The FrameID keeps two frames of the same millisecond, or of a clock stepped back, from replacing each other
+    const auto name = std::to_string(now_ms) + "-" + std::to_string(frame.frameId);
+    result.path = m_outputPath + "/" + name + ".jpg";
+
+    std::vector<WriteBehindJob> jobs(1);
+    auto& job = jobs.front();
+    job.path = result.path;
+    if (!frame.jpeg.empty())
+    {
+        // Encoded straight from the Bayer buffer by the conversion pool
+        job.data = std::move(frame.jpeg);
+    }
+    else
+    {
+        // The lease keeps the pool memory behind the image alive until the file is written
+        auto image = frame.image;
+        auto imageMemory = frame.imageMemory;
+        job.writeFile = [image, imageMemory](const std::string& path) {
+            peak::ipl::ImageWriter::WriteAsJPG(path, image);
+        };
+    }
+
+    // The file shows up under its final name once it is complete, the trigger does not wait for that
+    job.done = [this](const WriteBehindResult& written) {
+        if (written.success)
+        {
+            m_frameCounter++;
+        }
+        else
+        {
+            m_errorCounter++;
+            std::cout << "EXCEPTION: " << written.error << std::endl;
+        }
+    };
+
+    // Only the full size file counts as the frame, a failed smaller one is an error of its own
+    for (auto& scaled : frame.scaled)
+    {
+        CaptureOutput output;
+        output.name = scaled.name;
+        output.path = m_outputPath + "/" + name + "_" + scaled.name + ".jpg";
+        output.width = scaled.width;
+        output.height = scaled.height;
+
+        WriteBehindJob scaledJob;
+        scaledJob.path = output.path;
+        scaledJob.data = std::move(scaled.jpeg);
+        scaledJob.done = [this](const WriteBehindResult& written) {
+            if (!written.success)
+            {
+                m_errorCounter++;
+                std::cout << "EXCEPTION: " << written.error << std::endl;
+            }
+        };
+
+        jobs.push_back(std::move(scaledJob));
+        result.outputs.push_back(std::move(output));
+    }
+
+    if (!m_writeQueue.SubmitAll(std::move(jobs)))
+    {
+        // The disk is too far behind. Failing this capture keeps the trigger response and the next frames on time.
+        result.error = "Write queue is full";
+        result.outputs.clear();
+        m_errorCounter++;
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
+
+bool AcquisitionWorker::claimResult(uint64_t trigger)
+{
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    if (!m_triggerPending || trigger != m_triggerGeneration)
+    {
+        return false;
+    }
+
+    m_resultClaimed = true;
+    return true;
+}
+
+void AcquisitionWorker::deliverResult(CaptureResult result)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        if (!m_triggerPending)
+        {
+            // Nobody is waiting for this frame, e.g. the trigger already timed out
+            return;
+        }
+
+        const auto latency = std::chrono::steady_clock::now() - m_triggerTime;
+        result.latency_ms = std::chrono::duration<double, std::milli>(latency).count();
+        m_latency.Record(LatencyStage::Trigger, latency);
+
+        m_result = result;
+        m_triggerPending = false;
+        m_resultReady = true;
+    }
+    m_resultCondition.notify_all();
+}
@@ -0,0 +1,195 @@
+/*!
+ * \file    acquisitionworker.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The AcquisitionWorker class keeps the data stream armed in software
+ *          trigger mode with all buffers queued, so that a capture only costs
+ *          TriggerSoftware and WaitForFinishedBuffer. Finished buffers are
+ *          handed through a FrameRing to a ConversionPool, converted and
+ *          handed to a WriteBehindQueue as JPEG in FrameID order, so a slow
+ *          disk delays neither the next frame nor the trigger response. With
+ *          a BlackBox the camera runs free, every frame is recorded into it
+ *          and a trigger takes the next finished frame. Smaller JPEG
+ *          outputs such as a thumbnail are written along with each frame.
+ *          Frames no capture asked for feed a LivePreview, in trigger mode
+ *          they are triggered for it while somebody watches and the camera is
+ *          not busy with a capture.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef ACQUISITIONWORKER_H
+#define ACQUISITIONWORKER_H
+
+#include <peak/peak.hpp>
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "blackbox.h"
+#include "conversionpool.h"
+#include "framering.h"
+#include "latencyhistogram.h"
+#include "livepreview.h"
+#include "writebehind.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// A smaller JPEG written next to the full size one, see ConversionPool::SetJpegOutputs()
+struct CaptureOutput
+{
+    std::string name;
+    std::string path;
+    size_t width = 0;
+    size_t height = 0;
+};
+
+
+struct CaptureResult
+{
+    bool success = false;
+    std::string error;
+    std::string path;
+    // Queued together with the full size file, so either all of them are written or the capture failed
+    std::vector<CaptureOutput> outputs;
+    uint64_t frameId = 0;
+    uint64_t timestamp_ns = 0;
+    double latency_ms = 0.0;
+    // Read from the frame itself, most votes first. Empty unless barcode decoding is on.
+    std::vector<DecodedBarcode> barcodes;
+};
+
+
+class AcquisitionWorker
+{
+
+public:
+    AcquisitionWorker(std::shared_ptr<peak::core::DataStream> dataStream, const std::string& outputPath,
+        size_t conversionThreads, bool useDebayer, bool encodeBayerJpeg, size_t jpegThreads,
+        WriteBehindOptions writeOptions, std::vector<JpegOutput> jpegOutputs = std::vector<JpegOutput>());
+    ~AcquisitionWorker();
+
+    /*!
+     * \brief Records every finished buffer in \p blackBox, which must outlive the worker, null turns recording off.
+     *        Meant for a free running camera: Trigger() then takes the next frame finished after it instead of
+     *        executing TriggerSoftware, and frames no trigger waits for are requeued right after recording. Call
+     *        before Start().
+     */
+    void SetBlackBox(BlackBox* blackBox);
+
+    /*!
+     * \brief Feeds \p livePreview, which must outlive the worker, with frames no capture waits for. Null turns it off.
+     *        A free running camera offers its untriggered frames. In trigger mode a preview frame is triggered
+     *        whenever the preview wants one and no capture holds the camera, and a capture waits for at most the
+     *        one preview frame in flight. Preview frames are never converted or written. Call before Start().
+     */
+    void SetLivePreview(LivePreview* livePreview);
+
+    /*!
+     * \brief Decodes the barcodes of every captured frame within \p region of the sensor, empty for all of it, and
+     *        reports them in CaptureResult::barcodes. See ConversionPool::SetBarcodeDecoding(). Call before Start().
+     */
+    void SetBarcodeDecoding(BarcodeDecoderOptions options, Debayer::Region region);
+
+    void Start();
+    void Stop();
+
+    CaptureResult Trigger(uint64_t timeout_ms);
+
+    unsigned int FrameCounter() const;
+    unsigned int ErrorCounter() const;
+    FrameRingCounters RingCounters() const;
+    ConversionPoolCounters PoolCounters() const;
+    WriteBehindCounters WriteCounters() const;
+
+    // Per-stage latencies of all frames since construction: wait, convert/encode, barcode, requeue, write_queue,
+    // write and trigger
+    const LatencyRecorder& Latency() const;
+    // The same recorder, for stages measured outside the worker such as http
+    LatencyRecorder& Latency();
+
+    // Number of buffers that may be held outside the data stream, to be announced on top of the required minimum
+    size_t BuffersInFlight() const;
+
+    // Number of finished buffers that may wait for the conversion pool
+    static const size_t FrameRingCapacity = 4;
+
+private:
+    void run();
+    void dispatchFrames();
+    void triggerPreviews();
+    bool claimResult(uint64_t trigger);
+    CaptureResult writeFrame(ConvertedFrame& frame);
+    void deliverResult(CaptureResult result);
+
+    std::shared_ptr<peak::core::DataStream> m_dataStream;
+    std::shared_ptr<peak::core::NodeMap> m_nodemapRemoteDevice;
+
+    std::string m_outputPath;
+
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+
+    std::atomic<unsigned int> m_frameCounter{ 0 };
+    std::atomic<unsigned int> m_errorCounter{ 0 };
+
+    LatencyRecorder m_latency;
+    // TriggerSoftware time of the pending trigger, in steady_clock ticks, 0 if none. Read by the acquisition thread
+    // to time the wait for the triggered buffer.
+    std::atomic<std::chrono::steady_clock::rep> m_waitStart{ 0 };
+    // Generation of the trigger still waiting for its frame, 0 if none. The acquisition thread takes it for the next
+    // frame, so every trigger is answered by at most one frame.
+    std::atomic<uint64_t> m_pendingTrigger{ 0 };
+    // A trigger in trigger mode gave up before its frame arrived, the frame may still come after the next trigger
+    std::atomic<bool> m_frameOverdue{ false };
+    // Device timestamp latched before the last trigger after an overdue frame. Older frames answer no trigger.
+    std::atomic<uint64_t> m_staleBefore_ns{ 0 };
+
+    size_t m_imageWidth = 0;
+    size_t m_imageHeight = 0;
+
+    // Hands finished buffers from the acquisition loop to the thread feeding the conversion pool
+    FrameRing<> m_frameRing{ FrameRingCapacity };
+    std::thread m_conversionThread;
+
+    std::unique_ptr<ConversionPool> m_conversionPool;
+
+    BlackBox* m_blackBox = nullptr;
+
+    // Writes the JPEG files on its own threads, the capture result only waits until a frame is queued
+    WriteBehindQueue m_writeQueue;
+
+    // Serializes triggers, a capture is complete before the next one is fired
+    std::mutex m_triggerMutex;
+
+    LivePreview* m_livePreview = nullptr;
+    std::thread m_previewThread;
+    // The next finished buffer belongs to a preview trigger. Cleared by the acquisition thread when it arrives.
+    std::atomic<bool> m_previewPending{ false };
+    std::mutex m_previewMutex;
+    std::condition_variable m_previewCondition;
+
+    // Hands the result of a triggered frame from the conversion pool to the trigger caller
+    std::mutex m_resultMutex;
+    std::condition_variable m_resultCondition;
+    bool m_triggerPending = false;
+    bool m_resultReady = false;
+    // Generations count the triggers, m_triggerGeneration is the pending one
+    uint64_t m_generation = 0;
+    uint64_t m_triggerGeneration = 0;
+    // The sink is writing the frame of the pending trigger, so the trigger waits for it past its timeout
+    bool m_resultClaimed = false;
+    std::chrono::steady_clock::time_point m_triggerTime;
+    CaptureResult m_result;
+};
+
+#endif // ACQUISITIONWORKER_H
@@ -0,0 +1,90 @@
+/*!
+ * \file    barcodecorrelator.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeCorrelator class pairs scanned barcodes with
+ *          captures, so both go to the validator in the same request. A
+ *          barcode waits for the next capture, or joins the most recent
+ *          capture whose validation was not sent yet. Barcodes older than
+ *          the window are dropped instead of being paired with an unrelated
+ *          sample.
+ *
+ * \version 1.0.0
+ */
+
+#include "barcodecorrelator.h"
+
+#include <utility>
+
+
+BarcodeCorrelator::BarcodeCorrelator(BarcodeCorrelatorOptions options, Amend amend)
+    : m_options(std::move(options))
+    , m_amend(std::move(amend))
+{}
+
+void BarcodeCorrelator::Scanned(const std::string& barcode)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters.scanned++;
+
+    if (m_options.attach == BarcodeAttach::Recent && m_validation && now - m_captured <= m_options.window)
+    {
+        const auto validation = m_validation;
+        m_validation = 0;
+        if (m_amend(validation, barcode))
+        {
+            m_counters.attached++;
+            return;
+        }
+    }
+
+    // Only the last scan counts, e.g. when the operator scans again after a misread
+    if (!m_barcode.empty())
+    {
+        m_counters.expired++;
+    }
+    m_barcode = barcode;
+    m_scanned = now;
+}
+
+std::string BarcodeCorrelator::TakeForCapture()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_barcode.empty())
+    {
+        return std::string();
+    }
+
+    std::string barcode;
+    barcode.swap(m_barcode);
+    if (std::chrono::steady_clock::now() - m_scanned > m_options.window)
+    {
+        m_counters.expired++;
+        return std::string();
+    }
+
+    m_counters.attached++;
+    return barcode;
+}
+
+void BarcodeCorrelator::Captured(uint64_t validation)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_validation = validation;
+    m_captured = std::chrono::steady_clock::now();
+}
+
+BarcodeCorrelatorCounters BarcodeCorrelator::Counters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counters;
+}
+
+const BarcodeCorrelatorOptions& BarcodeCorrelator::Options() const
+{
+    return m_options;
+}
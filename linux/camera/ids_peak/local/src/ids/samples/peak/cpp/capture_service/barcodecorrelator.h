@@ -0,0 +1,93 @@
+/*!
+ * \file    barcodecorrelator.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeCorrelator class pairs scanned barcodes with
+ *          captures, so both go to the validator in the same request. A
+ *          barcode waits for the next capture, or joins the most recent
+ *          capture whose validation was not sent yet. Barcodes older than
+ *          the window are dropped instead of being paired with an unrelated
+ *          sample.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BARCODECORRELATOR_H
+#define BARCODECORRELATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+
+enum class BarcodeAttach
+{
+    // Scan first, then capture
+    Next,
+    // Capture first, then scan. A scan without such a capture waits for the next one.
+    Recent
+};
+
+
+struct BarcodeCorrelatorOptions
+{
+    BarcodeAttach attach = BarcodeAttach::Next;
+    // Longest time between a scan and the capture it belongs to
+    std::chrono::milliseconds window{ 30000 };
+};
+
+
+/*!
+ * \brief Counters of a correlator. All values are totals since construction.
+ */
+struct BarcodeCorrelatorCounters
+{
+    uint64_t scanned = 0;
+    uint64_t attached = 0;
+    // Outlived the window or replaced by the next scan before a capture took them
+    uint64_t expired = 0;
+};
+
+
+class BarcodeCorrelator
+{
+
+public:
+    // Adds a barcode to a queued validation, e.g. ValidationDispatcher::SetBarcode(). False if it was sent already.
+    using Amend = std::function<bool(uint64_t validation, const std::string& barcode)>;
+
+    BarcodeCorrelator(BarcodeCorrelatorOptions options, Amend amend);
+
+    BarcodeCorrelator(const BarcodeCorrelator&) = delete;
+    BarcodeCorrelator& operator=(const BarcodeCorrelator&) = delete;
+
+    // A barcode from a scanner. Thread-safe.
+    void Scanned(const std::string& barcode);
+
+    // The barcode of a capture about to be validated, empty if none is waiting. Thread-safe.
+    std::string TakeForCapture();
+
+    // Remembers the validation of a capture taken without a barcode, for BarcodeAttach::Recent. Thread-safe.
+    void Captured(uint64_t validation);
+
+    BarcodeCorrelatorCounters Counters() const;
+    const BarcodeCorrelatorOptions& Options() const;
+
+private:
+    const BarcodeCorrelatorOptions m_options;
+    Amend m_amend;
+
+    mutable std::mutex m_mutex;
+    std::string m_barcode;
+    std::chrono::steady_clock::time_point m_scanned;
+    // Validation of the most recent capture without a barcode, 0 if none
+    uint64_t m_validation = 0;
+    std::chrono::steady_clock::time_point m_captured;
+    BarcodeCorrelatorCounters m_counters;
+};
+
+#endif // BARCODECORRELATOR_H
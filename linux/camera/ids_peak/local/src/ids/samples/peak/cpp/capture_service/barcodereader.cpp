@@ -0,0 +1,366 @@
+/*!
+ * \file    barcodereader.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeReader class reads HID barcode scanners through evdev
+ *          like barcode/scan.py. It grabs every input device whose name
+ *          starts with the configured prefix, waits on all of them with one
+ *          epoll thread, decodes key events through a keycode table and
+ *          publishes a barcode whenever its terminating key arrives. Scanners
+ *          plugged in later are picked up by a periodic rescan.
+ *
+ * \version 1.0.0
+ */
+
+#include "barcodereader.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+
+// Longest barcode kept without a terminator, a scanner stuck on another ending does not grow it forever
+const size_t maximumLength = 4096;
+
+using KeyTable = std::array<std::array<char, 2>, KEY_SPACE + 1>;
+
+// US layout rows of the keys a scanner types, without and with shift, as key_map in scan.py
+KeyTable buildKeyTable()
+{
+    struct Row
+    {
+        uint16_t first;
+        const char* plain;
+        const char* shifted;
+    };
+    const Row rows[] = {
+        { KEY_1, "1234567890-=", "!@#$%^&*()_+" },
+        { KEY_Q, "qwertyuiop[]", "QWERTYUIOP{}" },
+        { KEY_A, "asdfghjkl;'`", "ASDFGHJKL:\"~" },
+        { KEY_BACKSLASH, "\\zxcvbnm,./", "|ZXCVBNM<>?" },
+        { KEY_SPACE, " ", " " },
+    };
+
+    KeyTable table{};
+    for (const auto& row : rows)
+    {
+        for (size_t i = 0; row.plain[i]; i++)
+        {
+            table[row.first + i] = { { row.plain[i], row.shifted[i] } };
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+
+BarcodeReader::BarcodeReader(BarcodeReaderOptions options, Publish publish)
+    : m_options(std::move(options))
+    , m_publish(std::move(publish))
+{}
+
+BarcodeReader::~BarcodeReader()
+{
+    Stop();
+}
+
+void BarcodeReader::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        return;
+    }
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = m_wake;
+    if (m_epoll < 0 || m_wake < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event) < 0)
+    {
+        const auto error = std::string("Failed to set up the barcode reader: ") + std::strerror(errno);
+        for (auto fd : { m_epoll, m_wake })
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+        m_epoll = -1;
+        m_wake = -1;
+        throw std::runtime_error(error);
+    }
+
+    m_counters = BarcodeReaderCounters();
+    m_running = true;
+    m_thread = std::thread(&BarcodeReader::run, this);
+}
+
+void BarcodeReader::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+
+    const uint64_t one = 1;
+    if (write(m_wake, &one, sizeof(one)) < 0)
+    {
+        // The counter can't overflow from a single write, the thread wakes up regardless
+    }
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    while (!m_scanners.empty())
+    {
+        drop(m_scanners.begin()->first);
+    }
+    close(m_wake);
+    close(m_epoll);
+    m_wake = -1;
+    m_epoll = -1;
+}
+
+BarcodeReaderCounters BarcodeReader::Counters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counters;
+}
+
+const BarcodeReaderOptions& BarcodeReader::Options() const
+{
+    return m_options;
+}
+
+char BarcodeReader::Decode(uint16_t keycode, bool shift)
+{
+    static const KeyTable table = buildKeyTable();
+    return keycode < table.size() ? table[keycode][shift ? 1 : 0] : 0;
+}
+
+void BarcodeReader::run()
+{
+    auto nextRescan = std::chrono::steady_clock::now();
+    while (true)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextRescan)
+        {
+            rescan();
+            nextRescan = now + m_options.rescanInterval;
+        }
+
+        const auto timeout =
+            std::chrono::duration_cast<std::chrono::milliseconds>(nextRescan - std::chrono::steady_clock::now());
+        std::array<epoll_event, 16> events;
+        const auto count = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()),
+            static_cast<int>(std::max<int64_t>(timeout.count(), 0) + 1));
+        if (count < 0 && errno != EINTR)
+        {
+            std::cout << "EXCEPTION: Barcode reader epoll failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            const auto fd = events[i].data.fd;
+            if (fd == m_wake)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_running)
+                {
+                    return;
+                }
+                continue;
+            }
+
+            // Input still pending is read first, EPOLLHUP then shows up as ENODEV
+            read(fd);
+        }
+    }
+}
+
+void BarcodeReader::rescan()
+{
+    DIR* directory = opendir(m_options.inputPath.c_str());
+    if (!directory)
+    {
+        return;
+    }
+
+    while (const auto* entry = readdir(directory))
+    {
+        const std::string name = entry->d_name;
+        const auto path = m_options.inputPath + "/" + name;
+        if (name.compare(0, 5, "event") != 0)
+        {
+            continue;
+        }
+        bool open = false;
+        for (const auto& scanner : m_scanners)
+        {
+            open = open || scanner.second.path == path;
+        }
+        if (open)
+        {
+            continue;
+        }
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        char deviceName[256] = {};
+        if (ioctl(fd, EVIOCGNAME(sizeof(deviceName) - 1), deviceName) < 0
+            || std::string(deviceName).compare(0, m_options.namePrefix.size(), m_options.namePrefix) != 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        if (m_options.grab && ioctl(fd, EVIOCGRAB, 1) < 0)
+        {
+            // E.g. scan.py still holds it. Tried again on every rescan, but reported once.
+            if (m_refused.insert(path).second)
+            {
+                std::cout << "EXCEPTION: Failed to grab " << path << " (" << deviceName
+                          << "): " << std::strerror(errno) << std::endl;
+            }
+            close(fd);
+            continue;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        m_refused.erase(path);
+        m_scanners[fd].path = path;
+        std::cout << "Reading barcodes from " << path << " (" << deviceName << ")" << std::endl;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.scanners = m_scanners.size();
+    }
+    closedir(directory);
+}
+
+void BarcodeReader::read(int fd)
+{
+    auto& scanner = m_scanners[fd];
+    while (true)
+    {
+        std::array<input_event, 64> events;
+        const auto count = ::read(fd, events.data(), sizeof(events));
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        if (count <= 0)
+        {
+            // ENODEV once the scanner is unplugged
+            std::cout << "Lost barcode scanner " << scanner.path << std::endl;
+            drop(fd);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_counters.lost++;
+            return;
+        }
+
+        uint64_t unknown = 0;
+        for (size_t i = 0; i < static_cast<size_t>(count) / sizeof(input_event); i++)
+        {
+            const auto& event = events[i];
+            if (event.type != EV_KEY)
+            {
+                continue;
+            }
+            if (event.code == KEY_LEFTSHIFT || event.code == KEY_RIGHTSHIFT)
+            {
+                // 0 is up, 1 down and 2 auto repeat
+                scanner.shift = event.value != 0;
+                continue;
+            }
+            if (event.value != 1)
+            {
+                continue;
+            }
+
+            if (event.code == m_options.terminator || (m_options.terminator == KEY_ENTER && event.code == KEY_KPENTER))
+            {
+                if (!scanner.barcode.empty())
+                {
+                    m_publish(scanner.barcode, scanner.path);
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_counters.barcodes++;
+                }
+                scanner.barcode.clear();
+                continue;
+            }
+
+            const auto character = Decode(event.code, scanner.shift);
+            if (!character)
+            {
+                unknown++;
+            }
+            else if (scanner.barcode.size() < maximumLength)
+            {
+                scanner.barcode += character;
+            }
+        }
+
+        if (unknown)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_counters.unknownKeys += unknown;
+        }
+    }
+}
+
+void BarcodeReader::drop(int fd)
+{
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    if (m_options.grab)
+    {
+        ioctl(fd, EVIOCGRAB, 0);
+    }
+    close(fd);
+    m_scanners.erase(fd);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters.scanners = m_scanners.size();
+}
@@ -0,0 +1,117 @@
+/*!
+ * \file    barcodereader.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeReader class reads HID barcode scanners through evdev
+ *          like barcode/scan.py. It grabs every input device whose name
+ *          starts with the configured prefix, waits on all of them with one
+ *          epoll thread, decodes key events through a keycode table and
+ *          publishes a barcode whenever its terminating key arrives. Scanners
+ *          plugged in later are picked up by a periodic rescan.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BARCODEREADER_H
+#define BARCODEREADER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+
+struct BarcodeReaderOptions
+{
+    // Device name prefix of the scanners, the Zebra/Symbol scanner of scan.py by default
+    std::string namePrefix = "Symbol Technologies, Inc, 2008 Symbol Bar Code Scanner::EA";
+    // Directory of the evdev device nodes
+    std::string inputPath = "/dev/input";
+    // Ends a barcode, e.g. KEY_ENTER (28) or KEY_TAB (15). Keypad enter counts as enter.
+    uint16_t terminator = 28;
+    // Exclusive access, so scans don't end up as keystrokes on the console
+    bool grab = true;
+    // Looks for newly plugged scanners this often
+    std::chrono::milliseconds rescanInterval{ 2000 };
+};
+
+
+/*!
+ * \brief Counters of a reader. All values are totals since Start(), except scanners.
+ */
+struct BarcodeReaderCounters
+{
+    // Scanners open right now
+    size_t scanners = 0;
+    uint64_t barcodes = 0;
+    // Key presses without a character in the table
+    uint64_t unknownKeys = 0;
+    // Scanners that failed or were unplugged
+    uint64_t lost = 0;
+};
+
+
+class BarcodeReader
+{
+
+public:
+    // Called on the reader thread with every complete barcode and the device node it came from
+    using Publish = std::function<void(const std::string& barcode, const std::string& device)>;
+
+    BarcodeReader(BarcodeReaderOptions options, Publish publish);
+    ~BarcodeReader();
+
+    BarcodeReader(const BarcodeReader&) = delete;
+    BarcodeReader& operator=(const BarcodeReader&) = delete;
+
+    // Throws std::runtime_error if epoll or the wake-up event can't be created. Finding no scanner is fine.
+    void Start();
+
+    // Releases and closes every scanner
+    void Stop();
+
+    BarcodeReaderCounters Counters() const;
+    const BarcodeReaderOptions& Options() const;
+
+    // Character of \p keycode, with or without shift, 0 if the table has none
+    static char Decode(uint16_t keycode, bool shift);
+
+private:
+    struct Scanner
+    {
+        std::string path;
+        std::string barcode;
+        bool shift = false;
+    };
+
+    void run();
+    void rescan();
+    void read(int fd);
+    void drop(int fd);
+
+    const BarcodeReaderOptions m_options;
+    Publish m_publish;
+
+    std::thread m_thread;
+    int m_epoll = -1;
+    // Wakes the thread for Stop()
+    int m_wake = -1;
+
+    // Only used by the reader thread, by file descriptor
+    std::map<int, Scanner> m_scanners;
+    // Matching devices that could not be grabbed, so the failure is only reported once
+    std::set<std::string> m_refused;
+
+    mutable std::mutex m_mutex;
+    bool m_running = false;
+    BarcodeReaderCounters m_counters;
+};
+
+#endif // BARCODEREADER_H
@@ -0,0 +1,1711 @@
+/*!
+ * \file    capture_service.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application is the long-lived capture service of aCCumen Junior.
+ *          It opens the camera once, keeps the data stream armed in software
+ *          trigger mode and serves captures over a local control socket, so
+ *          that a trigger does not pay for data stream and buffer setup. With
+ *          a black box the camera runs free instead and the last seconds of
+ *          raw frames are kept in memory, to be dumped on an event.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <pthread.h>
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <cstdint>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <peak/peak.hpp>
+
+#include "acquisitionworker.h"
+#include "barcodecorrelator.h"
+#include "barcodereader.h"
+#include "blackbox.h"
+#include "bufferpool.h"
+#include "controlserver.h"
+#include "httpclient.h"
+#include "httpserver.h"
+#include "livepreview.h"
+#include "remoteeventwatcher.h"
+#include "triggerscheduler.h"
+#include "validationdispatcher.h"
+
+
+struct Options
+{
+    size_t device = 0;
+    std::string path = "/tmp";
+    std::string socket = "/tmp/capture_service.sock";
+    // Longest wait for a triggered frame, and the deadline of a trigger request that brings none
+    uint64_t timeout_ms = 2000;
+    // Trigger requests waiting for the camera beyond this are answered busy
+    size_t triggerQueue = 8;
+    // Requests arriving this long after a capture was triggered share its frame, negative for the exposure time
+    int64_t coalesce_us = -1;
+    // 0 selects one conversion thread per core, leaving one core for acquisition
+    size_t threads = 0;
+    // "native" debayers Bayer formats with the in-tree SIMD kernels, "ipl" uses the IDS peak IPL
+    std::string converter = "ipl";
+    // "direct" encodes Bayer frames straight to JPEG via YCbCr 4:2:0, "ipl" converts to RGB8 and uses the IPL writer
+    std::string encoder = "direct";
+    // Threads sharing the direct encode of one frame in strips, 0 for one per core, 1 encodes on the conversion thread
+    size_t jpegThreads = 0;
+    // Smaller JPEGs written next to every direct encoded frame as name:longSide[:quality],..., "none" for none
+    std::string outputs = "thumbnail:640,preview:160";
+    // Seconds between latency dumps to stdout, 0 disables them. LATENCY on the socket works either way.
+    uint64_t latencyInterval_s = 60;
+    // "pool" announces page aligned, prefaulted, locked buffers allocated by the service, "producer" lets the
+    // GenTL producer allocate them
+    std::string bufferMemory = "pool";
+    // Back the pool with 2 MB huge pages
+    bool hugePages = false;
+    // Longest time a frame may be held between WaitForFinishedBuffer and QueueBuffer, sizes the buffer pool
+    double worstCaseProcessing_ms = 0.0;
+    // JPEG files are written behind the trigger response by these threads. A capture fails instead of waiting once
+    // writeQueue files are pending.
+    size_t writeThreads = 1;
+    size_t writeQueue = 16;
+    // 0 leaves durability to the kernel's writeback, N fsyncs up to N pending files together before they appear
+    size_t fsyncBatch = 0;
+    // "on" writes through io_uring where the kernel allows it, "off" always uses write()
+    std::string ioUring = "on";
+    // Memory of the black box ring in MB, 0 turns it off and keeps the camera in software trigger mode
+    uint64_t blackBoxBudget_mb = 0;
+    // Window dumped around an event, and the directory of the dumps (default: <path>/blackbox)
+    double blackBoxPre_s = 5.0;
+    double blackBoxPost_s = 2.0;
+    std::string blackBoxPath;
+    // Serves the routes of app.py on this port, 0 leaves HTTP to the Flask app
+    uint16_t httpPort = 0;
+    std::string httpHost = "0.0.0.0";
+    // Threads running triggers and validation, so overlapping triggers can share a capture
+    size_t httpWorkers = 4;
+    // Posted after every HTTP trigger like validate_image() in api_client.py, empty to skip validation
+    std::string validateUrl = "http://localhost:9099/ccms/validate/image";
+    // Validations not answered yet, sent after a restart. Empty keeps them in memory only.
+    std::string validateJournal = "validation.journal";
+    // Validations waiting for the validator beyond this are dropped
+    size_t validateQueue = 256;
+    size_t validateAttempts = 8;
+    // Name prefix of the HID scanners whose barcodes go into the validation request, empty to read none
+    std::string barcodeScanner = "Symbol Technologies, Inc, 2008 Symbol Bar Code Scanner::EA";
+    // Key ending a barcode, KEY_ENTER or KEY_TAB
+    uint16_t barcodeTerminator = 28;
+    // Whether a barcode goes to the next capture or the most recent one, and how far apart they may be
+    BarcodeAttach barcodeAttach = BarcodeAttach::Next;
+    uint64_t barcodeWindow_ms = 30000;
+    // Wait before a capture without a barcode is validated, negative for 2000 when attaching to the most recent
+    int64_t barcodeHold_ms = -1;
+    // Reads Code 128, EAN, QR Code and Data Matrix from every captured frame, used when no scanned barcode is waiting
+    bool barcodeDecode = false;
+    // Part of the sensor holding the label as x,y,width,height, empty for the whole frame
+    std::string barcodeRegion;
+    // Network interface whose MAC address is the hardwareId of the validation request
+    std::string interface = std::getenv("INTERFACE") ? std::getenv("INTERFACE") : "eno1";
+    std::string userId = "B12345";
+    // Offered by /ota and served under /files/<name>
+    std::string firmwarePath = "/tmp/firmware.py";
+    // Firmware logs posted to /log, in the format of the Flask app's log
+    std::string logFile = "accumen_junior.log";
+    // LED ring colour returned by /rgb
+    int red = 255;
+    int green = 255;
+    int blue = 255;
+    // MJPEG live view on /stream: frames per second at most (0 turns it off), long side and quality of a frame
+    double previewFps = 10.0;
+    size_t previewSize = 640;
+    int previewQuality = 70;
+};
+
+// Calls stop when it goes out of scope, e.g. to stop a server before the objects its handlers use on every way out
+struct ScopedStop
+{
+    std::function<void()> stop;
+
+    ~ScopedStop()
+    {
+        if (stop)
+        {
+            stop();
+        }
+    }
+};
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line. Unknown arguments are reported and
+ * the defaults are kept. Throws std::invalid_argument on a malformed value.
+ */
+Options parse_options(int argc, char* argv[]);
+
+/*! \brief Print Usage function
+ *
+ * The function prints the command line options, see linux/camera/README.md
+ * for what they do.
+ */
+void print_usage();
+
+/*! \brief Parse Outputs function
+ *
+ * The function parses the --outputs list, e.g. "thumbnail:640,preview:160:60".
+ * Throws std::invalid_argument on a malformed entry.
+ */
+std::vector<JpegOutput> parse_outputs(const std::string& outputs);
+
+/*! \brief Parse Region function
+ *
+ * The function parses the --barcode-region rectangle, e.g. "1200,800,1600,1200".
+ * Empty text gives an empty region. Throws std::invalid_argument on anything
+ * but four numbers.
+ */
+Debayer::Region parse_region(const std::string& region);
+
+/*! \brief Frame Barcode function
+ *
+ * The function returns the text of the barcode decoded from a capture that
+ * goes into its validation: the one with the most votes, empty if none was
+ * read or it holds characters the validation journal cannot store.
+ */
+std::string frame_barcode(const CaptureResult& result);
+
+/*! \brief Load UserSet Default function
+ *
+ * The function loads the UserSet Default, if the device supports it.
+ */
+void load_userset_default(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice);
+
+/*! \brief Configure Device function
+ *
+ * The function puts the device into software trigger mode, or lets it run
+ * free for the black box, and applies the capture settings of the station
+ * (ROI, exposure, gain, white balance).
+ */
+void configure_device(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice, bool freeRunning);
+
+/*! \brief Close Device function
+ *
+ * The function stops the acquisition, revokes all buffers and unlocks the
+ * transport layer parameters.
+ */
+void close_device(std::shared_ptr<peak::core::DataStream> dataStream,
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice);
+
+/*! \brief To JSON function
+ *
+ * The function formats the outcome of a trigger request as the JSON object
+ * returned by capture_optimised() in camera_ids_cli.py, with the status of
+ * the request and the barcodes decoded from the frame added.
+ */
+std::string to_json(const TriggerOutcome& outcome);
+
+/*! \brief Trigger Deadline function
+ *
+ * The function turns the milliseconds a trigger request may take, e.g. the
+ * argument of "TRIGGER 500", into a deadline. Empty text gives the default.
+ * Throws std::invalid_argument for anything but a positive number.
+ */
+std::chrono::steady_clock::time_point trigger_deadline(const std::string& milliseconds, uint64_t default_ms);
+
+/*! \brief JSON Escape function
+ *
+ * The function escapes quotes, backslashes and control characters for use
+ * inside a JSON string.
+ */
+std::string json_escape(const std::string& text);
+
+/*! \brief JSON Value function
+ *
+ * The function returns the value of the first \p key in a flat JSON object:
+ * the unescaped text of a string, the literal of anything else, empty if the
+ * key is absent. Enough for the small bodies of the firmware and validator.
+ */
+std::string json_value(const std::string& json, const std::string& key);
+
+/*! \brief Read Hardware ID function
+ *
+ * The function reads the MAC address of \p interface in upper case, as
+ * getmac.get_mac_address() does in api_client.py. Empty if it has none.
+ */
+std::string read_hardware_id(const std::string& interface);
+
+/*! \brief Read Firmware Version function
+ *
+ * The function returns the VERSION of a firmware.py, as app.py does, empty if
+ * the file or the line is missing.
+ */
+std::string read_firmware_version(const std::string& path);
+
+/*! \brief Compare Versions function
+ *
+ * The function compares two semantic versions like semver.compare(): negative
+ * if \p a is older than \p b, zero if equal, positive if newer. Build metadata
+ * is ignored. Throws std::invalid_argument for anything that is not semver.
+ */
+int compare_versions(const std::string& a, const std::string& b);
+
+/*! \brief Latency To JSON function
+ *
+ * The function formats the per-stage latency percentiles of the
+ * acquisition worker as the JSON object returned by the LATENCY command.
+ */
+std::string latency_to_json(const LatencyRecorder& latency);
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"capture_service\" v" << VERSION << std::endl;
+
+    Options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    // Block termination signals in all threads, they are consumed with sigwait() below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    // initialize peak library
+    peak::Library::Initialize();
+
+    std::shared_ptr<peak::core::Device> device;
+    std::shared_ptr<peak::core::DataStream> dataStream;
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice;
+    int exitCode = EXIT_SUCCESS;
+
+    try
+    {
+        auto& deviceManager = peak::DeviceManager::Instance();
+        deviceManager.Update();
+
+        if (deviceManager.Devices().size() <= options.device)
+        {
+            std::cout << "Device " << options.device << " not found. Exiting program." << std::endl;
+            peak::Library::Close();
+            return EXIT_FAILURE;
+        }
+
+        device =
+            deviceManager.Devices().at(options.device)->OpenDevice(peak::core::DeviceAccessType::Control);
+        std::cout << "Opened device: " << device->DisplayName() << std::endl;
+
+        nodeMapRemoteDevice = device->RemoteDevice()->NodeMaps().at(0);
+        dataStream = device->DataStreams().at(0)->OpenDataStream();
+
+        load_userset_default(nodeMapRemoteDevice);
+        const bool useBlackBox = (options.blackBoxBudget_mb > 0);
+        configure_device(nodeMapRemoteDevice, useBlackBox);
+
+        auto conversionThreads = options.threads;
+        if (conversionThreads == 0)
+        {
+            conversionThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        const bool useDebayer = (options.converter == "native");
+        const bool encodeBayerJpeg = (options.encoder == "direct");
+        auto jpegThreads = options.jpegThreads;
+        if (jpegThreads == 0)
+        {
+            jpegThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        WriteBehindOptions writeOptions;
+        writeOptions.threads = options.writeThreads;
+        writeOptions.capacity = options.writeQueue;
+        writeOptions.syncBatch = options.fsyncBatch;
+        writeOptions.useIoUring = (options.ioUring == "on");
+
+        // Declared before the worker, whose acquisition thread records into it until the worker is destroyed
+        std::unique_ptr<BlackBox> blackBox;
+        if (useBlackBox)
+        {
+            BlackBoxOptions blackBoxOptions;
+            blackBoxOptions.directory =
+                options.blackBoxPath.empty() ? options.path + "/blackbox" : options.blackBoxPath;
+            blackBoxOptions.budget_bytes = options.blackBoxBudget_mb << 20;
+            blackBoxOptions.preEvent_s = options.blackBoxPre_s;
+            blackBoxOptions.postEvent_s = options.blackBoxPost_s;
+            blackBox = std::make_unique<BlackBox>(blackBoxOptions);
+        }
+
+        // Exists before the worker so the live preview can ask it for viewers, it is started once the routes are set
+        std::unique_ptr<HttpServer> httpServer;
+        if (options.httpPort > 0)
+        {
+            HttpServerOptions httpOptions;
+            httpOptions.host = options.httpHost;
+            httpOptions.port = options.httpPort;
+            httpOptions.workerThreads = options.httpWorkers;
+            httpServer = std::make_unique<HttpServer>(httpOptions);
+        }
+
+        // Declared before the worker, which offers it frames until the worker is destroyed
+        std::unique_ptr<LivePreview> livePreview;
+        if (httpServer && options.previewFps > 0.0)
+        {
+            const auto pixelFormat = static_cast<peak::ipl::PixelFormatName>(
+                nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("PixelFormat")
+                    ->CurrentEntry()
+                    ->Value());
+            if (PreviewJpegEncoder::IsSupported(pixelFormat))
+            {
+                LivePreviewOptions previewOptions;
+                previewOptions.longSide = options.previewSize;
+                previewOptions.quality = options.previewQuality;
+                previewOptions.maxFps = options.previewFps;
+
+                auto* server = httpServer.get();
+                livePreview = std::make_unique<LivePreview>(previewOptions,
+                    [server] { return server->StreamClients("preview"); },
+                    [server](std::shared_ptr<const std::string> part) { server->Publish("preview", std::move(part)); });
+            }
+            else
+            {
+                std::cout << "Live preview needs a Bayer pixel format, /stream is off" << std::endl;
+            }
+        }
+
+        // The smaller outputs come out of the direct encoder's debayer pass, the IPL path writes the full size only
+        const auto jpegOutputs = encodeBayerJpeg ? parse_outputs(options.outputs) : std::vector<JpegOutput>();
+
+        AcquisitionWorker acquisitionWorker(dataStream, options.path, conversionThreads, useDebayer, encodeBayerJpeg,
+            jpegThreads, writeOptions, jpegOutputs);
+        std::cout << "Converting on " << conversionThreads << " thread(s) with "
+                  << (encodeBayerJpeg ? "direct Bayer to JPEG encoding on " + std::to_string(jpegThreads)
+                                            + " strip thread(s)"
+                                      : (useDebayer ? std::string("native ") + Debayer::IsaName(Debayer::BestIsa())
+                                                 + " kernels"
+                                                    : std::string("IDS peak IPL")))
+                  << std::endl;
+        for (const auto& output : jpegOutputs)
+        {
+            std::cout << "Writing " << output.name << " JPEGs with a long side of at least " << output.longSide
+                      << " at quality " << output.quality << std::endl;
+        }
+
+        if (options.barcodeDecode)
+        {
+            const auto pixelFormat = static_cast<peak::ipl::PixelFormatName>(
+                nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("PixelFormat")
+                    ->CurrentEntry()
+                    ->Value());
+            if (FrameBarcodeDecoder::IsSupported(pixelFormat))
+            {
+                const auto region = parse_region(options.barcodeRegion);
+                acquisitionWorker.SetBarcodeDecoding(BarcodeDecoderOptions(), region);
+                std::cout << "Decoding barcodes from "
+                          << (region.width ? options.barcodeRegion + " of every frame" : std::string("every frame"))
+                          << " with " << BarcodeDecoder::IsaName(BarcodeDecoder::BestIsa()) << " kernels"
+                          << std::endl;
+            }
+            else
+            {
+                std::cout << "Barcode decoding needs a Mono8 or Bayer pixel format, it is off" << std::endl;
+            }
+        }
+
+        // Its buffer counts towards the buffers in flight, so it is set before they are announced
+        if (livePreview)
+        {
+            livePreview->SetLatencyRecorder(&acquisitionWorker.Latency());
+            acquisitionWorker.SetLivePreview(livePreview.get());
+            std::cout << "Live preview of up to " << options.previewFps << " fps with a long side of "
+                      << options.previewSize << " at quality " << options.previewQuality << std::endl;
+        }
+
+        // Allocate and announce image buffers and queue them once for the lifetime of the service. The extra buffers
+        // cover frames waiting in the frame ring and in the conversion pool, or the frames arriving at the maximum
+        // frame rate while one frame is held for the worst case processing time, whichever is more.
+        auto payloadSize = nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")->Value();
+        const auto bufferCountMin = dataStream->NumBuffersAnnouncedMinRequired();
+        auto bufferCountMax = bufferCountMin + acquisitionWorker.BuffersInFlight();
+        try
+        {
+            const auto frameRate =
+                nodeMapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("AcquisitionFrameRate")->Value();
+            bufferCountMax = std::max(bufferCountMax,
+                BufferPool::BufferCount(frameRate, options.worstCaseProcessing_ms, bufferCountMin));
+        }
+        catch (const std::exception&)
+        {
+            // AcquisitionFrameRate is not available, keep the count derived from the pipeline depth
+        }
+
+        BufferPoolOptions poolOptions;
+        poolOptions.hugePages = options.hugePages;
+        BufferPool bufferPool(dataStream, poolOptions);
+        if (options.bufferMemory == "pool")
+        {
+            // The revocation callbacks free the memory when close_device() revokes the buffers
+            bufferPool.Announce(bufferCountMax, static_cast<size_t>(payloadSize));
+            bufferPool.QueueAll();
+
+            const auto pool = bufferPool.Counters();
+            std::cout << "Announced " << pool.announced << " buffer(s) of " << pool.bytesPerBuffer / 1024 << " kB, "
+                      << pool.hugePageBuffers << " on huge pages, " << pool.lockedBuffers << " locked" << std::endl;
+        }
+        else
+        {
+            for (size_t bufferCount = 0; bufferCount < bufferCountMax; ++bufferCount)
+            {
+                auto buffer = dataStream->AllocAndAnnounceBuffer(static_cast<size_t>(payloadSize), nullptr);
+                dataStream->QueueBuffer(buffer);
+            }
+        }
+
+        if (blackBox)
+        {
+            blackBox->Start(static_cast<size_t>(payloadSize));
+            acquisitionWorker.SetBlackBox(blackBox.get());
+            std::cout << "Black box of " << blackBox->Counters().slots << " frame(s), dumping "
+                      << options.blackBoxPre_s << " s before to " << options.blackBoxPost_s << " s after an event"
+                      << std::endl;
+        }
+
+        acquisitionWorker.Start();
+
+        // Dropped frames and camera errors are dumped without anyone asking
+        RemoteEventWatcher eventWatcher(device, [&](const std::string& event) { blackBox->Dump(event); });
+        if (blackBox)
+        {
+            const auto events = eventWatcher.Start({ "FrameDropped", "Error", "CriticalError" });
+            std::cout << "Dumping the black box on " << events.size() << " remote device event(s)";
+            for (const auto& event : events)
+            {
+                std::cout << " " << event;
+            }
+            std::cout << std::endl;
+        }
+
+        std::cout << "Writing on " << writeOptions.threads << " thread(s), "
+                  << acquisitionWorker.WriteCounters().ioUringWriters << " with io_uring, queue of "
+                  << writeOptions.capacity << ", fsync batch " << writeOptions.syncBatch << std::endl;
+
+        // The only caller of the worker's Trigger(), so the socket and HTTP never race for the camera
+        TriggerSchedulerOptions schedulerOptions;
+        schedulerOptions.queueCapacity = options.triggerQueue;
+        schedulerOptions.captureTimeout_ms = options.timeout_ms;
+        schedulerOptions.coalesceWindow = std::chrono::microseconds(std::max<int64_t>(options.coalesce_us, 0));
+        if (options.coalesce_us < 0)
+        {
+            try
+            {
+                schedulerOptions.coalesceWindow = std::chrono::microseconds(static_cast<int64_t>(
+                    nodeMapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("ExposureTime")->Value()));
+            }
+            catch (const std::exception&)
+            {
+                // ExposureTime is not available, only requests waiting for the camera are coalesced
+            }
+        }
+        TriggerScheduler triggerScheduler(
+            schedulerOptions, [&](uint64_t timeout_ms) { return acquisitionWorker.Trigger(timeout_ms); });
+        triggerScheduler.Start();
+        std::cout << "Scheduling triggers with a queue of " << schedulerOptions.queueCapacity << ", coalescing within "
+                  << schedulerOptions.coalesceWindow.count() << " us" << std::endl;
+
+        // The routes of app.py, so the station firmware can talk to the service without the Flask hop
+        std::unique_ptr<ValidationDispatcher> validator;
+        std::unique_ptr<BarcodeCorrelator> barcodes;
+        std::unique_ptr<BarcodeReader> barcodeReader;
+        std::mutex logMutex;
+        std::ofstream firmwareLog;
+        if (httpServer)
+        {
+            const auto hardwareId = read_hardware_id(options.interface);
+            if (!options.validateUrl.empty())
+            {
+                ValidationDispatcherOptions validateOptions;
+                validateOptions.journalPath = options.validateJournal;
+                validateOptions.queueCapacity = options.validateQueue;
+                validateOptions.maxAttempts = options.validateAttempts;
+                validateOptions.holdBack = std::chrono::milliseconds(options.barcodeHold_ms >= 0
+                        ? options.barcodeHold_ms
+                        : (options.barcodeAttach == BarcodeAttach::Recent ? 2000 : 0));
+
+                // The JSON of validate_image(), the hardware ID is read once instead of on every request
+                const auto body = [&options, hardwareId](const ValidationRequest& request) {
+                    std::ostringstream json;
+                    json << "{\"barcode\": "
+                         << (request.barcode.empty() ? std::string("null") : "\"" + json_escape(request.barcode) + "\"")
+                         << ", \"imagePath\": \"" << json_escape(request.imagePath)
+                         << "\", \"hardwareType\": \"Junior\", \"hardwareId\": \"" << json_escape(hardwareId)
+                         << "\", \"userId\": \"" << json_escape(options.userId) << "\"}";
+                    return json.str();
+                };
+
+                // A rejected sample keeps the frames around it for diagnosis
+                const auto done = [&blackBox](const ValidationResult& result) {
+                    if (!result.delivered)
+                    {
+                        std::cout << "EXCEPTION: Validation of " << result.request.imagePath << " given up after "
+                                  << result.attempts << " attempt(s): " << result.error << std::endl;
+                        return;
+                    }
+                    std::cout << "Validation " << result.status << ": " << result.body << std::endl;
+
+                    const auto error = json_value(result.body, "error");
+                    const bool rejected = result.status >= 400
+                        || !(error.empty() || error == "null" || error == "false" || error == "0");
+                    if (rejected && blackBox)
+                    {
+                        blackBox->Dump("validation");
+                    }
+                };
+
+                validator = std::make_unique<ValidationDispatcher>(validateOptions,
+                    HttpUrl::Parse(options.validateUrl),
+                    HttpClient::Headers{ { "Content-Type", "application/json" }, { "Accept", "application/json" },
+                        { "Current-Role", "ROLE_ANALYST" } },
+                    body, done);
+                validator->Start();
+
+                // Barcodes ride along with the validation of their capture instead of being posted on their own
+                BarcodeCorrelatorOptions barcodeOptions;
+                barcodeOptions.attach = options.barcodeAttach;
+                barcodeOptions.window = std::chrono::milliseconds(options.barcodeWindow_ms);
+                barcodes = std::make_unique<BarcodeCorrelator>(barcodeOptions,
+                    [&validator](uint64_t validation, const std::string& barcode) {
+                        return validator->SetBarcode(validation, barcode);
+                    });
+                if (!options.barcodeScanner.empty())
+                {
+                    BarcodeReaderOptions readerOptions;
+                    readerOptions.namePrefix = options.barcodeScanner;
+                    readerOptions.terminator = options.barcodeTerminator;
+                    barcodeReader = std::make_unique<BarcodeReader>(
+                        readerOptions, [&barcodes](const std::string& barcode, const std::string& device) {
+                            std::cout << "Scanned: " << barcode << " on " << device << std::endl;
+                            barcodes->Scanned(barcode);
+                        });
+                    barcodeReader->Start();
+                }
+
+                std::cout << "Validating every HTTP trigger at " << options.validateUrl << " as " << hardwareId
+                          << std::endl;
+            }
+            firmwareLog.open(options.logFile, std::ios::app);
+
+            httpServer->SetLatencyRecorder(&acquisitionWorker.Latency());
+
+            httpServer->Route("GET", "/", [](const HttpRequest&) { return HttpResponse::Json(200, "{\"ok\": true}"); });
+
+            // A coalesced trigger shares the image, which is validated once
+            const auto validate = [&](const CaptureResult& result) {
+                // A scanned barcode is the operator's choice, the one on the frame only stands in for it
+                auto barcode = barcodes->TakeForCapture();
+                if (barcode.empty())
+                {
+                    barcode = frame_barcode(result);
+                }
+                const auto validation = validator->Submit({ result.path, barcode });
+                if (!validation)
+                {
+                    std::cout << "EXCEPTION: Validation queue is full, " << result.path << " is not validated"
+                              << std::endl;
+                }
+                else if (barcode.empty())
+                {
+                    barcodes->Captured(validation);
+                }
+            };
+
+            // Triggers block until the frame is queued for writing and its validation is journaled. They run on the
+            // worker threads while the loop keeps answering the other routes. Overlapping triggers meet in the
+            // scheduler, which decides whether they share a capture. ?deadline_ms= bounds the wait for the frame.
+            httpServer->Route("POST", "/",
+                [&, validate](const HttpRequest& httpRequest) {
+                    std::chrono::steady_clock::time_point deadline;
+                    try
+                    {
+                        deadline = trigger_deadline(httpRequest.QueryParameter("deadline_ms"), options.timeout_ms);
+                    }
+                    catch (const std::exception&)
+                    {
+                        return HttpResponse::Json(400, "{\"error\": \"deadline_ms must be a positive number\"}");
+                    }
+
+                    // A capture whose triggers all went late while it was in flight is written and validated anyway
+                    const auto outcome =
+                        validator ? triggerScheduler.Trigger(deadline, validate) : triggerScheduler.Trigger(deadline);
+                    const auto& result = outcome.result;
+                    const auto json = to_json(outcome);
+                    if (outcome.status == TriggerStatus::Late)
+                    {
+                        return HttpResponse::Json(504, json);
+                    }
+                    if (!result.success)
+                    {
+                        return HttpResponse::Json(503, json);
+                    }
+                    // Journaled before the answer, the validator's round trip is not part of the trigger any more
+                    if (validator && outcome.status == TriggerStatus::Captured)
+                    {
+                        validate(result);
+                    }
+                    return HttpResponse::Json(200, json);
+                },
+                HttpServer::Dispatch::Worker);
+
+            httpServer->Route("POST", "/blackbox", [&](const HttpRequest& request) {
+                if (!blackBox)
+                {
+                    return HttpResponse::Json(503, "{\"error\": \"black box is off\"}");
+                }
+                const auto reason = json_value(request.body, "reason");
+                blackBox->Dump(reason.empty() ? std::string("http") : reason);
+                return HttpResponse::Json(200, "{\"success\": true}");
+            });
+
+            const auto firmwareName = options.firmwarePath.substr(options.firmwarePath.rfind('/') + 1);
+            httpServer->Route("GET", "/ota", [&, firmwareName](const HttpRequest& request) {
+                // Read on every request, so a new firmware file is offered without a restart
+                const auto version = request.QueryParameter("version");
+                const auto firmwareVersion = read_firmware_version(options.firmwarePath);
+                std::cout << "Device firmware version: " << version << ", current: " << firmwareVersion << std::endl;
+                if (version.empty() || firmwareVersion.empty())
+                {
+                    return HttpResponse::Json(200, "{}");
+                }
+
+                try
+                {
+                    if (compare_versions(firmwareVersion, version) > 0)
+                    {
+                        return HttpResponse::Json(200, "{\"version\": \"" + json_escape(firmwareVersion)
+                                + "\", \"fpath\": \"/files/" + json_escape(firmwareName) + "\"}");
+                    }
+                }
+                catch (const std::invalid_argument& e)
+                {
+                    return HttpResponse::Json(400, "{\"error\": \"" + json_escape(e.what()) + "\"}");
+                }
+                return HttpResponse::Json(200, "{}");
+            });
+
+            httpServer->Route("GET", "/files/" + firmwareName, [&](const HttpRequest&) {
+                std::ifstream file(options.firmwarePath, std::ios::binary);
+                if (!file)
+                {
+                    return HttpResponse::Json(404, "{\"error\": \"no firmware\"}");
+                }
+
+                HttpResponse response;
+                response.contentType = "application/octet-stream";
+                response.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                return response;
+            });
+
+            httpServer->Route("GET", "/rgb", [&](const HttpRequest&) {
+                std::ostringstream rgb;
+                rgb << "{\"red\": " << options.red << ", \"green\": " << options.green
+                    << ", \"blue\": " << options.blue << "}";
+                return HttpResponse::Json(200, rgb.str());
+            });
+
+            // Same line format as the logging setup of app.py, so both can share one log file
+            const auto firmwareLogRoute = [&](const HttpRequest& request) {
+                if (request.body.empty())
+                {
+                    return HttpResponse::Json(200, "{\"ok\": true}");
+                }
+
+                const auto level = json_value(request.body, "level");
+                const char* levelName = (level == "info") ? "INFO"
+                    : (level == "warn")                   ? "WARNING"
+                    : (level == "error")                  ? "ERROR"
+                                                          : "DEBUG";
+
+                const auto now = std::chrono::system_clock::now();
+                const auto time = std::chrono::system_clock::to_time_t(now);
+                const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count()
+                    % 1000;
+                std::tm local{};
+                localtime_r(&time, &local);
+
+                std::lock_guard<std::mutex> lock(logMutex);
+                firmwareLog << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << "," << std::setw(3) << std::setfill('0')
+                            << ms << " - capture_service - " << levelName
+                            << " - FW: " << json_value(request.body, "text") << std::endl;
+                return HttpResponse::Json(200, "{\"ok\": true}");
+            };
+            httpServer->Route("POST", "/log", firmwareLogRoute);
+            httpServer->Route("POST", "/logs", firmwareLogRoute);
+
+            // Live view for focusing and aligning the station, e.g. <img src="http://junior.local:8000/stream?fps=5">.
+            // Every client shares the same encoded frames, fps only lowers the rate a client gets them at.
+            if (livePreview)
+            {
+                httpServer->Route("GET", "/stream", [&](const HttpRequest& request) {
+                    HttpResponse response;
+                    response.contentType = LivePreview::ContentType();
+                    response.stream = "preview";
+                    response.maxRate = options.previewFps;
+
+                    const auto fps = request.QueryParameter("fps");
+                    if (!fps.empty())
+                    {
+                        double rate = 0.0;
+                        try
+                        {
+                            rate = std::stod(fps);
+                        }
+                        catch (const std::exception&)
+                        {
+                            // Not a number, answered like a rate of 0
+                        }
+                        if (!(rate > 0.0))
+                        {
+                            return HttpResponse::Json(400, "{\"error\": \"fps must be a positive number\"}");
+                        }
+                        response.maxRate = std::min(rate, options.previewFps);
+                    }
+                    return response;
+                });
+            }
+
+            httpServer->Start();
+            std::cout << "Serving HTTP on " << options.httpHost << ":" << options.httpPort << " with "
+                      << options.httpWorkers << " worker thread(s)" << std::endl;
+        }
+        ScopedStop stopHttp{ [&httpServer] {
+            if (httpServer)
+            {
+                httpServer->Stop();
+            }
+        } };
+
+        ControlServer controlServer(options.socket, [&](const std::string& command) {
+            if (command == "TRIGGER" || command.compare(0, 8, "TRIGGER ") == 0)
+            {
+                // "TRIGGER <ms>" gives up after <ms> instead of --timeout
+                try
+                {
+                    return to_json(triggerScheduler.Trigger(
+                        trigger_deadline(command.size() > 8 ? command.substr(8) : std::string(), options.timeout_ms)));
+                }
+                catch (const std::invalid_argument&)
+                {
+                    return std::string("{\"error\": \"deadline must be a positive number\", \"status\": \"failed\"}");
+                }
+            }
+            if (command == "STATUS")
+            {
+                const auto ring = acquisitionWorker.RingCounters();
+                const auto pool = acquisitionWorker.PoolCounters();
+                const auto write = acquisitionWorker.WriteCounters();
+                std::ostringstream status;
+                status << "{\"frames\": " << acquisitionWorker.FrameCounter()
+                       << ", \"errors\": " << acquisitionWorker.ErrorCounter()
+                       << ", \"dropped\": " << ring.rejected << ", \"ring_depth\": " << ring.depth
+                       << ", \"ring_high_watermark\": " << ring.highWatermark
+                       << ", \"conversions\": " << pool.converted << ", \"conversions_in_flight\": " << pool.inFlight
+                       << ", \"write_queue_depth\": " << write.depth
+                       << ", \"write_queue_high_watermark\": " << write.highWatermark
+                       << ", \"writes\": " << write.written << ", \"write_errors\": " << write.failed
+                       << ", \"write_rejected\": " << write.rejected << ", \"written_bytes\": " << write.bytes
+                       << ", \"fsync_batches\": " << write.syncs << ", \"io_uring_writers\": " << write.ioUringWriters;
+                if (httpServer)
+                {
+                    const auto http = httpServer->Counters();
+                    status << ", \"http_connections\": " << http.connections << ", \"http_accepted\": " << http.accepted
+                           << ", \"http_rejected\": " << http.rejected << ", \"http_requests\": " << http.requests
+                           << ", \"http_client_errors\": " << http.clientErrors
+                           << ", \"http_server_errors\": " << http.serverErrors
+                           << ", \"http_worker_depth\": " << http.workerDepth << ", \"http_streams\": " << http.streams
+                           << ", \"http_stream_parts\": " << http.streamParts
+                           << ", \"http_stream_skipped\": " << http.streamSkipped;
+                }
+                const auto triggers = triggerScheduler.Counters();
+                status << ", \"trigger_requests\": " << triggers.requests
+                       << ", \"trigger_captures\": " << triggers.captures
+                       << ", \"trigger_coalesced\": " << triggers.coalesced << ", \"trigger_busy\": " << triggers.busy
+                       << ", \"trigger_late\": " << triggers.late << ", \"trigger_failed\": " << triggers.failed
+                       << ", \"trigger_orphaned\": " << triggers.orphaned
+                       << ", \"trigger_queue_depth\": " << triggers.depth;
+                if (validator)
+                {
+                    const auto validations = validator->Counters();
+                    status << ", \"validation_submitted\": " << validations.submitted
+                           << ", \"validation_delivered\": " << validations.delivered
+                           << ", \"validation_retries\": " << validations.retries
+                           << ", \"validation_failed\": " << validations.failed
+                           << ", \"validation_rejected\": " << validations.rejected
+                           << ", \"validation_recovered\": " << validations.recovered
+                           << ", \"validation_connections\": " << validations.connections
+                           << ", \"validation_queue_depth\": " << validations.depth;
+
+                    const auto scans = barcodes->Counters();
+                    status << ", \"barcode_scanned\": " << scans.scanned << ", \"barcode_attached\": " << scans.attached
+                           << ", \"barcode_expired\": " << scans.expired;
+                }
+                if (barcodeReader)
+                {
+                    const auto reader = barcodeReader->Counters();
+                    status << ", \"barcode_scanners\": " << reader.scanners
+                           << ", \"barcode_reads\": " << reader.barcodes
+                           << ", \"barcode_unknown_keys\": " << reader.unknownKeys
+                           << ", \"barcode_lost_scanners\": " << reader.lost;
+                }
+                if (livePreview)
+                {
+                    const auto preview = livePreview->Counters();
+                    status << ", \"preview_frames\": " << preview.frames << ", \"preview_errors\": " << preview.errors
+                           << ", \"preview_width\": " << preview.width << ", \"preview_height\": " << preview.height;
+                }
+                if (blackBox)
+                {
+                    const auto box = blackBox->Counters();
+                    status << ", \"black_box_recorded\": " << box.recorded << ", \"black_box_slots\": " << box.slots
+                           << ", \"black_box_span_s\": " << box.span_s << ", \"black_box_events\": " << box.events
+                           << ", \"black_box_coalesced\": " << box.coalesced << ", \"black_box_dumps\": " << box.dumps
+                           << ", \"black_box_failed_dumps\": " << box.failedDumps
+                           << ", \"black_box_dumped_frames\": " << box.dumpedFrames
+                           << ", \"black_box_lost_frames\": " << box.lostFrames
+                           << ", \"black_box_remote_events\": " << eventWatcher.EventCounter()
+                           << ", \"black_box_last_dump\": \"" << box.lastDump << "\"";
+                }
+                status << "}";
+                return status.str();
+            }
+            if (command == "DUMP" || command.compare(0, 5, "DUMP ") == 0)
+            {
+                if (!blackBox)
+                {
+                    return std::string("{\"error\": \"black box is off\"}");
+                }
+
+                // Returns at once, the dump is written on the black box thread
+                blackBox->Dump(command.size() > 5 ? command.substr(5) : std::string("manual"));
+                return std::string("{\"success\": true}");
+            }
+            if (command.compare(0, 8, "BARCODE ") == 0 && command.size() > 8)
+            {
+                // A barcode from elsewhere than the scanners, e.g. a keyboard wedge or a test
+                if (!barcodes)
+                {
+                    return std::string("{\"error\": \"validation is off\"}");
+                }
+                barcodes->Scanned(command.substr(8));
+                return std::string("{\"success\": true}");
+            }
+            if (command == "LATENCY")
+            {
+                return latency_to_json(acquisitionWorker.Latency());
+            }
+            return std::string("{\"error\": \"unknown command\"}");
+        });
+        controlServer.Start();
+
+        std::cout << "Armed, listening on " << options.socket << std::endl;
+
+        // Periodic latency dump, so tail latencies show up in the service log without polling the socket
+        std::mutex dumpMutex;
+        std::condition_variable dumpCondition;
+        bool dumpStop = false;
+        std::thread dumpThread;
+        if (options.latencyInterval_s > 0)
+        {
+            dumpThread = std::thread([&] {
+                std::unique_lock<std::mutex> lock(dumpMutex);
+                while (!dumpCondition.wait_for(
+                    lock, std::chrono::seconds(options.latencyInterval_s), [&] { return dumpStop; }))
+                {
+                    acquisitionWorker.Latency().Dump(std::cout);
+                }
+            });
+        }
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        std::cout << "Received signal " << signal << ", shutting down" << std::endl;
+
+        if (dumpThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(dumpMutex);
+                dumpStop = true;
+            }
+            dumpCondition.notify_all();
+            dumpThread.join();
+        }
+        acquisitionWorker.Latency().Dump(std::cout);
+
+        if (httpServer)
+        {
+            httpServer->Stop();
+        }
+        controlServer.Stop();
+        triggerScheduler.Stop();
+        if (barcodeReader)
+        {
+            barcodeReader->Stop();
+        }
+        if (validator)
+        {
+            validator->Stop();
+        }
+        eventWatcher.Stop();
+        acquisitionWorker.Stop();
+        if (blackBox)
+        {
+            blackBox->Stop();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        exitCode = EXIT_FAILURE;
+    }
+
+    close_device(dataStream, nodeMapRemoteDevice);
+
+    // close peak library
+    peak::Library::Close();
+    return exitCode;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+    Options options;
+
+    // The flag being parsed, so a bad value can be reported with it
+    std::string argument;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            argument = argv[i];
+            const bool hasValue = (i + 1) < argc;
+
+            if (argument == "--device" && hasValue)
+            {
+                options.device = std::stoul(argv[++i]);
+            }
+            else if (argument == "--path" && hasValue)
+            {
+                options.path = argv[++i];
+            }
+            else if (argument == "--socket" && hasValue)
+            {
+                options.socket = argv[++i];
+            }
+            else if (argument == "--timeout" && hasValue)
+            {
+                options.timeout_ms = std::stoull(argv[++i]);
+            }
+            else if (argument == "--trigger-queue" && hasValue)
+            {
+                options.triggerQueue = std::stoul(argv[++i]);
+            }
+            else if (argument == "--coalesce-us" && hasValue)
+            {
+                options.coalesce_us = std::stoll(argv[++i]);
+            }
+            else if (argument == "--threads" && hasValue)
+            {
+                options.threads = std::stoul(argv[++i]);
+            }
+            else if (argument == "--converter" && hasValue)
+            {
+                options.converter = argv[++i];
+            }
+            else if (argument == "--encoder" && hasValue)
+            {
+                options.encoder = argv[++i];
+            }
+            else if (argument == "--jpeg-threads" && hasValue)
+            {
+                options.jpegThreads = std::stoul(argv[++i]);
+            }
+            else if (argument == "--outputs" && hasValue)
+            {
+                options.outputs = argv[++i];
+            }
+            else if (argument == "--latency-interval" && hasValue)
+            {
+                options.latencyInterval_s = std::stoull(argv[++i]);
+            }
+            else if (argument == "--buffer-memory" && hasValue)
+            {
+                options.bufferMemory = argv[++i];
+            }
+            else if (argument == "--hugepages")
+            {
+                options.hugePages = true;
+            }
+            else if (argument == "--worst-case-ms" && hasValue)
+            {
+                options.worstCaseProcessing_ms = std::stod(argv[++i]);
+            }
+            else if (argument == "--write-threads" && hasValue)
+            {
+                options.writeThreads = std::stoul(argv[++i]);
+            }
+            else if (argument == "--write-queue" && hasValue)
+            {
+                options.writeQueue = std::stoul(argv[++i]);
+            }
+            else if (argument == "--fsync-batch" && hasValue)
+            {
+                options.fsyncBatch = std::stoul(argv[++i]);
+            }
+            else if (argument == "--io-uring" && hasValue)
+            {
+                options.ioUring = argv[++i];
+            }
+            else if (argument == "--black-box-mb" && hasValue)
+            {
+                options.blackBoxBudget_mb = std::stoull(argv[++i]);
+            }
+            else if (argument == "--black-box-pre" && hasValue)
+            {
+                options.blackBoxPre_s = std::stod(argv[++i]);
+            }
+            else if (argument == "--black-box-post" && hasValue)
+            {
+                options.blackBoxPost_s = std::stod(argv[++i]);
+            }
+            else if (argument == "--black-box-path" && hasValue)
+            {
+                options.blackBoxPath = argv[++i];
+            }
+            else if (argument == "--http-port" && hasValue)
+            {
+                options.httpPort = static_cast<uint16_t>(std::stoul(argv[++i]));
+            }
+            else if (argument == "--http-host" && hasValue)
+            {
+                options.httpHost = argv[++i];
+            }
+            else if (argument == "--http-workers" && hasValue)
+            {
+                options.httpWorkers = std::max<size_t>(std::stoul(argv[++i]), 1);
+            }
+            else if (argument == "--validate-url" && hasValue)
+            {
+                options.validateUrl = argv[++i];
+            }
+            else if (argument == "--validate-journal" && hasValue)
+            {
+                options.validateJournal = argv[++i];
+            }
+            else if (argument == "--validate-queue" && hasValue)
+            {
+                options.validateQueue = std::stoul(argv[++i]);
+            }
+            else if (argument == "--validate-attempts" && hasValue)
+            {
+                options.validateAttempts = std::max<size_t>(std::stoul(argv[++i]), 1);
+            }
+            else if (argument == "--barcode-scanner" && hasValue)
+            {
+                options.barcodeScanner = argv[++i];
+            }
+            else if (argument == "--barcode-terminator" && hasValue)
+            {
+                const std::string terminator = argv[++i];
+                if (terminator != "enter" && terminator != "tab")
+                {
+                    throw std::invalid_argument("--barcode-terminator must be enter or tab");
+                }
+                options.barcodeTerminator = terminator == "tab" ? 15 : 28;
+            }
+            else if (argument == "--barcode-attach" && hasValue)
+            {
+                const std::string attach = argv[++i];
+                if (attach != "next" && attach != "recent")
+                {
+                    throw std::invalid_argument("--barcode-attach must be next or recent");
+                }
+                options.barcodeAttach = attach == "recent" ? BarcodeAttach::Recent : BarcodeAttach::Next;
+            }
+            else if (argument == "--barcode-window-ms" && hasValue)
+            {
+                options.barcodeWindow_ms = std::stoull(argv[++i]);
+            }
+            else if (argument == "--barcode-hold-ms" && hasValue)
+            {
+                options.barcodeHold_ms = std::stoll(argv[++i]);
+            }
+            else if (argument == "--barcode-decode")
+            {
+                options.barcodeDecode = true;
+            }
+            else if (argument == "--barcode-region" && hasValue)
+            {
+                options.barcodeRegion = argv[++i];
+            }
+            else if (argument == "--interface" && hasValue)
+            {
+                options.interface = argv[++i];
+            }
+            else if (argument == "--user-id" && hasValue)
+            {
+                options.userId = argv[++i];
+            }
+            else if (argument == "--firmware" && hasValue)
+            {
+                options.firmwarePath = argv[++i];
+            }
+            else if (argument == "--log-file" && hasValue)
+            {
+                options.logFile = argv[++i];
+            }
+            else if (argument == "--rgb" && hasValue)
+            {
+                // r,g,b like the --red/--green/--blue of app.py
+                char separator = 0;
+                std::istringstream rgb(argv[++i]);
+                rgb >> options.red >> separator >> options.green >> separator >> options.blue;
+            }
+            else if (argument == "--preview-fps" && hasValue)
+            {
+                options.previewFps = std::stod(argv[++i]);
+            }
+            else if (argument == "--preview-size" && hasValue)
+            {
+                options.previewSize = std::stoul(argv[++i]);
+            }
+            else if (argument == "--preview-quality" && hasValue)
+            {
+                options.previewQuality = std::stoi(argv[++i]);
+            }
+            else
+            {
+                std::cout << "Ignoring unknown argument: " << argument << std::endl;
+            }
+        }
+    }
+    catch (const std::logic_error& e)
+    {
+        // std::stoul() and friends only name themselves in what()
+        throw std::invalid_argument("Invalid value for " + argument + " (" + e.what() + ")");
+    }
+
+    return options;
+}
+
+void print_usage()
+{
+    std::cout << "Usage: capture_service_cpp [OPTION VALUE]..." << std::endl
+              << "  Camera:    --device N --path DIR --timeout MS --trigger-queue N --coalesce-us US" << std::endl
+              << "  Pipeline:  --threads N --converter ipl|native --encoder direct|ipl --jpeg-threads N" << std::endl
+              << "             --outputs NAME:LONG_SIDE[:QUALITY],...|none --latency-interval S" << std::endl
+              << "  Buffers:   --buffer-memory pool|producer --hugepages --worst-case-ms MS" << std::endl
+              << "  Writing:   --write-threads N --write-queue N --fsync-batch N --io-uring on|off" << std::endl
+              << "  Black box: --black-box-mb MB --black-box-pre S --black-box-post S --black-box-path DIR" << std::endl
+              << "  Control:   --socket PATH --http-port PORT --http-host HOST --http-workers N" << std::endl
+              << "  Validate:  --validate-url URL --validate-journal PATH --validate-queue N --validate-attempts N"
+              << std::endl
+              << "  Barcodes:  --barcode-scanner NAME --barcode-terminator enter|tab --barcode-attach next|recent"
+              << std::endl
+              << "             --barcode-window-ms MS --barcode-hold-ms MS --barcode-decode --barcode-region X,Y,W,H"
+              << std::endl
+              << "  Station:   --interface NAME --user-id ID --firmware PATH --log-file PATH --rgb R,G,B" << std::endl
+              << "  Preview:   --preview-fps FPS --preview-size PX --preview-quality Q" << std::endl;
+}
+
+std::vector<JpegOutput> parse_outputs(const std::string& outputs)
+{
+    std::vector<JpegOutput> parsed;
+    if (outputs.empty() || outputs == "none")
+    {
+        return parsed;
+    }
+
+    std::istringstream list(outputs);
+    std::string entry;
+    while (std::getline(list, entry, ','))
+    {
+        std::istringstream fields(entry);
+        std::string name;
+        std::string longSide;
+        std::string quality;
+        std::getline(fields, name, ':');
+        std::getline(fields, longSide, ':');
+        std::getline(fields, quality, ':');
+
+        // The name ends up in the file name, so keep it to characters that need no quoting anywhere
+        const auto valid = !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+        });
+        if (!valid || longSide.empty())
+        {
+            throw std::invalid_argument("Invalid output \"" + entry + "\", expected name:longSide[:quality]");
+        }
+
+        JpegOutput output;
+        output.name = name;
+        output.longSide = std::stoul(longSide);
+        if (!quality.empty())
+        {
+            output.quality = std::stoi(quality);
+        }
+        parsed.push_back(output);
+    }
+
+    return parsed;
+}
+
+Debayer::Region parse_region(const std::string& region)
+{
+    Debayer::Region parsed;
+    if (region.empty())
+    {
+        return parsed;
+    }
+
+    std::istringstream fields(region);
+    std::vector<size_t> values;
+    std::string field;
+    while (std::getline(fields, field, ','))
+    {
+        if (field.empty() || field.size() > 9 || field.find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw std::invalid_argument("Invalid region \"" + region + "\", expected x,y,width,height");
+        }
+        values.push_back(std::stoul(field));
+    }
+    if (values.size() != 4 || values[2] == 0 || values[3] == 0)
+    {
+        throw std::invalid_argument("Invalid region \"" + region + "\", expected x,y,width,height");
+    }
+
+    parsed.x = values[0];
+    parsed.y = values[1];
+    parsed.width = values[2];
+    parsed.height = values[3];
+    return parsed;
+}
+
+std::string frame_barcode(const CaptureResult& result)
+{
+    if (result.barcodes.empty())
+    {
+        return std::string();
+    }
+
+    // Code 128 may carry control characters, the journal keeps one request per line with tab separated fields
+    const auto& text = result.barcodes.front().text;
+    if (text.find_first_of("\t\r\n") != std::string::npos)
+    {
+        std::cout << "EXCEPTION: Barcode of " << result.path << " holds a tab or line break, it is not validated"
+                  << std::endl;
+        return std::string();
+    }
+    return text;
+}
+
+void load_userset_default(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice)
+{
+    try
+    {
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("UserSetSelector")
+            ->SetCurrentEntry("Default");
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("UserSetLoad")->Execute();
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("UserSetLoad")->WaitUntilDone();
+    }
+    catch (const peak::core::NotFoundException&)
+    {
+        // UserSet is not available
+    }
+}
+
+void configure_device(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice, bool freeRunning)
+{
+    // Software trigger on exposure start, the stream stays armed between triggers. The black box needs the frames
+    // before a trigger, so the camera runs free at AcquisitionFrameRate then.
+    nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("TriggerSelector")
+        ->SetCurrentEntry("ExposureStart");
+    nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("TriggerSource")->SetCurrentEntry("Software");
+    nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("TriggerMode")
+        ->SetCurrentEntry(freeRunning ? "Off" : "On");
+
+    // The remaining settings mirror initialise_camera() in camera_ids_cli.py and are optional per model
+    try
+    {
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("OffsetX")->SetValue(0);
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("OffsetY")->SetValue(0);
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Width")->SetValue(4000);
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->SetValue(3000);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "ROI set error: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("ExposureTime")->SetValue(150000.0);
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("GainSelector")
+            ->SetCurrentEntry("AnalogAll");
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("Gain")->SetValue(1.0);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Exposure set error: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("ExposureAuto")
+            ->SetCurrentEntry("Continuous");
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("GainAuto")->SetCurrentEntry("Continuous");
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("BalanceWhiteAuto")
+            ->SetCurrentEntry("Continuous");
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Auto features set error: " << e.what() << std::endl;
+    }
+}
+
+void close_device(std::shared_ptr<peak::core::DataStream> dataStream,
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice)
+{
+    if (nodeMapRemoteDevice)
+    {
+        try
+        {
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->Execute();
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    if (dataStream)
+    {
+        try
+        {
+            dataStream->KillWait();
+            dataStream->StopAcquisition(peak::core::AcquisitionStopMode::Default);
+            dataStream->Flush(peak::core::DataStreamFlushMode::DiscardAll);
+
+            for (const auto& buffer : dataStream->AnnouncedBuffers())
+            {
+                dataStream->RevokeBuffer(buffer);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    if (nodeMapRemoteDevice)
+    {
+        try
+        {
+            // Unlock parameters after acquisition stop
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(0);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::string json_escape(const std::string& text)
+{
+    std::ostringstream escaped;
+    for (const auto c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }
+        else
+        {
+            escaped << c;
+        }
+    }
+    return escaped.str();
+}
+
+std::string to_json(const TriggerOutcome& outcome)
+{
+    const auto& result = outcome.result;
+    const auto status = TriggerScheduler::StatusName(outcome.status);
+
+    std::ostringstream json;
+    if (!result.success || outcome.status == TriggerStatus::Late)
+    {
+        json << "{\"error\": \"" << json_escape(result.error) << "\", \"status\": \"" << status << "\"}";
+        return json.str();
+    }
+
+    json << "{\"path\": \"" << json_escape(result.path) << "\", \"attempts\": 1"
+         << ", \"frame_id\": " << result.frameId << ", \"timestamp_ns\": " << result.timestamp_ns
+         << ", \"latency_ms\": " << std::fixed << std::setprecision(3) << result.latency_ms << ", \"status\": \""
+         << status << "\", \"batch\": " << outcome.batch << ", \"queued_ms\": " << outcome.queued_ms
+         << ", \"outputs\": {";
+    for (size_t i = 0; i < result.outputs.size(); ++i)
+    {
+        const auto& output = result.outputs[i];
+        json << (i > 0 ? ", " : "") << "\"" << json_escape(output.name) << "\": {\"path\": \""
+             << json_escape(output.path) << "\", \"width\": " << output.width << ", \"height\": " << output.height
+             << "}";
+    }
+    json << "}, \"barcodes\": [";
+    for (size_t i = 0; i < result.barcodes.size(); ++i)
+    {
+        const auto& barcode = result.barcodes[i];
+        json << (i > 0 ? ", " : "") << "{\"symbology\": \"" << BarcodeSymbologyName(barcode.symbology)
+             << "\", \"text\": \"" << json_escape(barcode.text) << "\", \"votes\": " << barcode.votes << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+std::chrono::steady_clock::time_point trigger_deadline(const std::string& milliseconds, uint64_t default_ms)
+{
+    auto timeout_ms = default_ms;
+    if (!milliseconds.empty())
+    {
+        if (milliseconds.size() > 9 || milliseconds.find_first_not_of("0123456789") != std::string::npos
+            || std::stoull(milliseconds) == 0)
+        {
+            throw std::invalid_argument("Invalid deadline: " + milliseconds);
+        }
+        timeout_ms = std::stoull(milliseconds);
+    }
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+}
+
+std::string latency_to_json(const LatencyRecorder& latency)
+{
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3) << "{";
+    for (size_t index = 0; index < static_cast<size_t>(LatencyStage::Count); ++index)
+    {
+        const auto stage = static_cast<LatencyStage>(index);
+        const auto summary = latency.Summary(stage);
+        json << (index ? ", " : "") << "\"" << LatencyStageName(stage) << "\": {\"count\": " << summary.count
+             << ", \"mean_ms\": " << summary.mean_us / 1000.0 << ", \"p50_ms\": " << summary.p50_us / 1000.0
+             << ", \"p99_ms\": " << summary.p99_us / 1000.0 << ", \"p999_ms\": " << summary.p999_us / 1000.0
+             << ", \"max_ms\": " << summary.max_us / 1000.0 << "}";
+    }
+    json << "}";
+    return json.str();
+}
+
+std::string json_value(const std::string& json, const std::string& key)
+{
+    const auto quotedKey = "\"" + key + "\"";
+    size_t position = 0;
+    while ((position = json.find(quotedKey, position)) != std::string::npos)
+    {
+        position += quotedKey.size();
+        const auto colon = json.find_first_not_of(" \t\r\n", position);
+        if (colon == std::string::npos || json[colon] != ':')
+        {
+            // The key text appeared as a value
+            continue;
+        }
+
+        const auto start = json.find_first_not_of(" \t\r\n", colon + 1);
+        if (start == std::string::npos)
+        {
+            return std::string();
+        }
+
+        if (json[start] != '"')
+        {
+            const auto end = json.find_first_of(",}] \t\r\n", start);
+            return json.substr(start, end - start);
+        }
+
+        std::string value;
+        for (auto i = start + 1; i < json.size() && json[i] != '"'; ++i)
+        {
+            if (json[i] != '\\' || i + 1 >= json.size())
+            {
+                value.push_back(json[i]);
+                continue;
+            }
+
+            const auto escaped = json[++i];
+            switch (escaped)
+            {
+            case 'n':
+                value.push_back('\n');
+                break;
+            case 't':
+                value.push_back('\t');
+                break;
+            case 'r':
+                value.push_back('\r');
+                break;
+            case 'b':
+                value.push_back('\b');
+                break;
+            case 'f':
+                value.push_back('\f');
+                break;
+            case 'u':
+                // Only ASCII is expected here, anything else becomes '?'
+                if (i + 4 < json.size())
+                {
+                    const auto code = std::strtoul(json.substr(i + 1, 4).c_str(), nullptr, 16);
+                    value.push_back(code < 0x80 ? static_cast<char>(code) : '?');
+                    i += 4;
+                }
+                break;
+            default:
+                value.push_back(escaped);
+                break;
+            }
+        }
+        return value;
+    }
+    return std::string();
+}
+
+std::string read_hardware_id(const std::string& interface)
+{
+    std::ifstream file("/sys/class/net/" + interface + "/address");
+    std::string address;
+    std::getline(file, address);
+    std::transform(address.begin(), address.end(), address.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return address;
+}
+
+std::string read_firmware_version(const std::string& path)
+{
+    std::ifstream file(path);
+    const std::string prefix = "VERSION = ";
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, prefix.size(), prefix) == 0)
+        {
+            auto version = line.substr(prefix.size());
+            version.erase(std::remove(version.begin(), version.end(), '"'), version.end());
+            version.erase(version.find_last_not_of(" \t\r") + 1);
+            return version;
+        }
+    }
+    return std::string();
+}
+
+int compare_versions(const std::string& a, const std::string& b)
+{
+    struct Version
+    {
+        unsigned long core[3] = {};
+        std::vector<std::string> prerelease;
+    };
+
+    auto isNumber = [](const std::string& text) {
+        return !text.empty() && text.find_first_not_of("0123456789") == std::string::npos;
+    };
+
+    auto split = [](const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::istringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator))
+        {
+            parts.push_back(part);
+        }
+        return parts;
+    };
+
+    auto parse = [&](const std::string& text) {
+        const auto withoutBuild = text.substr(0, text.find('+'));
+        const auto dash = withoutBuild.find('-');
+        const auto core = split(withoutBuild.substr(0, dash), '.');
+        if (core.size() != 3 || !std::all_of(core.begin(), core.end(), isNumber))
+        {
+            throw std::invalid_argument("Not a semantic version: " + text);
+        }
+
+        Version version;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            version.core[i] = std::stoul(core[i]);
+        }
+        if (dash != std::string::npos)
+        {
+            version.prerelease = split(withoutBuild.substr(dash + 1), '.');
+        }
+        return version;
+    };
+
+    const auto left = parse(a);
+    const auto right = parse(b);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (left.core[i] != right.core[i])
+        {
+            return left.core[i] < right.core[i] ? -1 : 1;
+        }
+    }
+
+    // A pre-release is older than its release
+    if (left.prerelease.empty() || right.prerelease.empty())
+    {
+        return static_cast<int>(right.prerelease.size() > 0) - static_cast<int>(left.prerelease.size() > 0);
+    }
+
+    for (size_t i = 0; i < std::min(left.prerelease.size(), right.prerelease.size()); ++i)
+    {
+        const auto& l = left.prerelease[i];
+        const auto& r = right.prerelease[i];
+        if (l == r)
+        {
+            continue;
+        }
+        if (isNumber(l) && isNumber(r))
+        {
+            return std::stoul(l) < std::stoul(r) ? -1 : 1;
+        }
+        if (isNumber(l) != isNumber(r))
+        {
+            // Numeric identifiers sort before alphanumeric ones
+            return isNumber(l) ? -1 : 1;
+        }
+        return l < r ? -1 : 1;
+    }
+    return static_cast<int>(left.prerelease.size() > right.prerelease.size())
+        - static_cast<int>(left.prerelease.size() < right.prerelease.size());
+}
@@ -0,0 +1,152 @@
+/*!
+ * \file    controlserver.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ControlServer class accepts line based commands (e.g. "TRIGGER")
+ *          on a local unix domain socket and answers each with one line of
+ *          JSON produced by the registered handler.
+ *
+ * \version 1.0.0
+ */
+
+#include "controlserver.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+
+ControlServer::ControlServer(const std::string& socketPath, Handler handler)
+    : m_socketPath(socketPath)
+    , m_handler(std::move(handler))
+{}
+
+ControlServer::~ControlServer()
+{
+    Stop();
+}
+
+void ControlServer::Start()
+{
+    sockaddr_un address{};
+    if (m_socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Control socket path is too long: " + m_socketPath);
+    }
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_socket < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create control socket: ") + std::strerror(errno));
+    }
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    // Remove a stale socket left behind by a previous run
+    unlink(m_socketPath.c_str());
+
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(m_socket, 8) < 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(m_socket);
+        m_socket = -1;
+        throw std::runtime_error("Failed to listen on " + m_socketPath + ": " + error);
+    }
+
+    m_running = true;
+    m_thread = std::thread(&ControlServer::run, this);
+}
+
+void ControlServer::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_running = false;
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    close(m_socket);
+    m_socket = -1;
+    unlink(m_socketPath.c_str());
+}
+
+void ControlServer::run()
+{
+    while (m_running)
+    {
+        // Poll with a timeout so Stop() is noticed without closing the socket under our feet
+        pollfd pfd{ m_socket, POLLIN, 0 };
+        if (poll(&pfd, 1, 200) <= 0)
+        {
+            continue;
+        }
+
+        const int connection = accept4(m_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0)
+        {
+            continue;
+        }
+
+        handleConnection(connection);
+        close(connection);
+    }
+}
+
+void ControlServer::handleConnection(int connection)
+{
+    // Commands are short, anything beyond this is not a valid command
+    constexpr size_t maxCommandLength = 256;
+
+    std::string command;
+    char c = 0;
+    while (command.size() < maxCommandLength)
+    {
+        pollfd pfd{ connection, POLLIN, 0 };
+        if (poll(&pfd, 1, 1000) <= 0 || read(connection, &c, 1) != 1 || c == '\n')
+        {
+            break;
+        }
+        if (c != '\r')
+        {
+            command.push_back(c);
+        }
+    }
+
+    std::string response;
+    try
+    {
+        response = m_handler(command);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        response = "{\"error\": \"internal error\"}";
+    }
+    response.push_back('\n');
+
+    size_t written = 0;
+    while (written < response.size())
+    {
+        const auto count = send(connection, response.data() + written, response.size() - written, MSG_NOSIGNAL);
+        if (count <= 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(count);
+    }
+}
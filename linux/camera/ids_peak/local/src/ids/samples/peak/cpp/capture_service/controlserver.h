@@ -0,0 +1,48 @@
+/*!
+ * \file    controlserver.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ControlServer class accepts line based commands (e.g. "TRIGGER")
+ *          on a local unix domain socket and answers each with one line of
+ *          JSON produced by the registered handler.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+
+class ControlServer
+{
+
+public:
+    using Handler = std::function<std::string(const std::string& command)>;
+
+    ControlServer(const std::string& socketPath, Handler handler);
+    ~ControlServer();
+
+    void Start();
+    void Stop();
+
+private:
+    void run();
+    void handleConnection(int connection);
+
+    std::string m_socketPath;
+    Handler m_handler;
+
+    int m_socket = -1;
+
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+};
+
+#endif // CONTROLSERVER_H
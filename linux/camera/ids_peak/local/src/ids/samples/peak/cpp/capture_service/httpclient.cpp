@@ -0,0 +1,464 @@
+/*!
+ * \file    httpclient.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The HttpClient class sends plain HTTP/1.1 requests with a bounded
+ *          timeout, e.g. to post a capture to the validator the way
+ *          validate_image() in api_client.py does. It either connects for
+ *          every request or keeps one connection alive between them.
+ *
+ * \version 1.0.0
+ */
+
+#include "httpclient.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+std::string lowerCase(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// Closes the socket on every way out of Post(), unless it is released to be kept
+class Socket
+{
+
+public:
+    explicit Socket(int fd)
+        : m_fd(fd)
+    {}
+
+    ~Socket()
+    {
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+        }
+    }
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    int Fd() const
+    {
+        return m_fd;
+    }
+
+    int Release()
+    {
+        const int fd = m_fd;
+        m_fd = -1;
+        return fd;
+    }
+
+private:
+    int m_fd;
+};
+
+int remaining_ms(Clock::time_point deadline)
+{
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    return static_cast<int>(std::max<decltype(left)>(left, 0));
+}
+
+void waitFor(int fd, short events, Clock::time_point deadline, const char* what)
+{
+    while (true)
+    {
+        pollfd pfd{ fd, events, 0 };
+        const auto ready = poll(&pfd, 1, remaining_ms(deadline));
+        if (ready > 0)
+        {
+            return;
+        }
+        if (ready == 0)
+        {
+            throw std::runtime_error(std::string("HTTP timeout while ") + what);
+        }
+        if (errno != EINTR)
+        {
+            throw std::runtime_error(std::string("HTTP poll failed: ") + std::strerror(errno));
+        }
+    }
+}
+
+int connectTo(const HttpUrl& url, Clock::time_point deadline)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const auto resolved = getaddrinfo(url.host.c_str(), std::to_string(url.port).c_str(), &hints, &addresses);
+    if (resolved != 0)
+    {
+        throw std::runtime_error("Failed to resolve " + url.host + ": " + gai_strerror(resolved));
+    }
+
+    std::string error = "no address";
+    for (auto* address = addresses; address; address = address->ai_next)
+    {
+        const int fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            error = std::strerror(errno);
+            continue;
+        }
+
+        if (connect(fd, address->ai_addr, address->ai_addrlen) < 0 && errno != EINPROGRESS)
+        {
+            error = std::strerror(errno);
+            close(fd);
+            continue;
+        }
+
+        try
+        {
+            waitFor(fd, POLLOUT, deadline, "connecting");
+        }
+        catch (const std::exception&)
+        {
+            close(fd);
+            freeaddrinfo(addresses);
+            throw;
+        }
+
+        int socketError = 0;
+        socklen_t length = sizeof(socketError);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &socketError, &length);
+        if (socketError != 0)
+        {
+            error = std::strerror(socketError);
+            close(fd);
+            continue;
+        }
+
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        freeaddrinfo(addresses);
+        return fd;
+    }
+
+    freeaddrinfo(addresses);
+    throw std::runtime_error("Failed to connect to " + url.host + ":" + std::to_string(url.port) + ": " + error);
+}
+
+// Reads more data into \p input. Returns false at the end of the stream.
+bool receive(int fd, std::string& input, Clock::time_point deadline)
+{
+    while (true)
+    {
+        char buffer[16 * 1024];
+        const auto count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+            input.append(buffer, static_cast<size_t>(count));
+            return true;
+        }
+        if (count == 0)
+        {
+            return false;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            waitFor(fd, POLLIN, deadline, "receiving");
+            continue;
+        }
+        if (errno != EINTR)
+        {
+            throw std::runtime_error(std::string("HTTP receive failed: ") + std::strerror(errno));
+        }
+    }
+}
+
+// Decodes a complete chunked body. Returns false if \p input does not hold all of it yet.
+bool decodeChunked(const std::string& input, size_t start, std::string& body)
+{
+    body.clear();
+    auto position = start;
+    while (true)
+    {
+        const auto lineEnd = input.find("\r\n", position);
+        if (lineEnd == std::string::npos)
+        {
+            return false;
+        }
+
+        // Chunk extensions after ';' are ignored
+        const auto sizeText = input.substr(position, input.find_first_of(";\r", position) - position);
+        size_t size = 0;
+        try
+        {
+            size = std::stoul(sizeText, nullptr, 16);
+        }
+        catch (const std::exception&)
+        {
+            throw std::runtime_error("Malformed chunked HTTP response");
+        }
+
+        position = lineEnd + 2;
+        if (size == 0)
+        {
+            // Trailers, if any, end with an empty line
+            return input.find("\r\n", position) != std::string::npos;
+        }
+        if (input.size() < position + size + 2)
+        {
+            return false;
+        }
+
+        body.append(input, position, size);
+        position += size + 2;
+    }
+}
+
+/*!
+ * \brief Sends \p request on \p fd and reads the response. \p keepOpen is cleared if the connection can't carry
+ *        another request, \p answered is set once the server sent anything.
+ */
+HttpClientResponse exchange(
+    int fd, const std::string& request, Clock::time_point deadline, bool& keepOpen, bool& answered)
+{
+    size_t sent = 0;
+    while (sent < request.size())
+    {
+        const auto count = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (count > 0)
+        {
+            sent += static_cast<size_t>(count);
+        }
+        else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            waitFor(fd, POLLOUT, deadline, "sending");
+        }
+        else if (count < 0 && errno != EINTR)
+        {
+            throw std::runtime_error(std::string("HTTP send failed: ") + std::strerror(errno));
+        }
+    }
+
+    std::string input;
+    size_t headEnd = std::string::npos;
+    while ((headEnd = input.find("\r\n\r\n")) == std::string::npos)
+    {
+        if (!receive(fd, input, deadline))
+        {
+            throw std::runtime_error("HTTP connection closed before the response");
+        }
+        answered = true;
+    }
+
+    HttpClientResponse response;
+    const auto head = input.substr(0, headEnd);
+    const auto statusStart = head.find(' ');
+    if (head.compare(0, 7, "HTTP/1.") != 0 || statusStart == std::string::npos)
+    {
+        throw std::runtime_error("Malformed HTTP response");
+    }
+    response.status = std::atoi(head.c_str() + statusStart + 1);
+
+    bool chunked = false;
+    long long contentLength = -1;
+    size_t lineStart = head.find("\r\n");
+    while (lineStart != std::string::npos && lineStart + 2 < head.size())
+    {
+        lineStart += 2;
+        const auto lineEnd = head.find("\r\n", lineStart);
+        const auto line = head.substr(lineStart, lineEnd - lineStart);
+        const auto colon = line.find(':');
+        if (colon != std::string::npos)
+        {
+            const auto name = lowerCase(line.substr(0, colon));
+            const auto valueStart = std::min(line.find_first_not_of(" \t", colon + 1), line.size());
+            const auto value = lowerCase(line.substr(valueStart));
+            if (name == "transfer-encoding" && value.find("chunked") != std::string::npos)
+            {
+                chunked = true;
+            }
+            else if (name == "content-length")
+            {
+                contentLength = std::atoll(value.c_str());
+            }
+            else if (name == "connection" && value.find("close") != std::string::npos)
+            {
+                keepOpen = false;
+            }
+        }
+        lineStart = lineEnd;
+    }
+
+    const auto bodyStart = headEnd + 4;
+    while (true)
+    {
+        if (chunked && decodeChunked(input, bodyStart, response.body))
+        {
+            return response;
+        }
+        if (!chunked && contentLength >= 0 && input.size() >= bodyStart + static_cast<size_t>(contentLength))
+        {
+            // Anything after the body was not asked for, the connection is out of step then
+            keepOpen = keepOpen && input.size() == bodyStart + static_cast<size_t>(contentLength);
+            response.body = input.substr(bodyStart, static_cast<size_t>(contentLength));
+            return response;
+        }
+
+        if (!receive(fd, input, deadline))
+        {
+            if (chunked || contentLength >= 0)
+            {
+                throw std::runtime_error("HTTP connection closed before the end of the response");
+            }
+
+            // Neither length nor chunks, the body ends with the connection
+            keepOpen = false;
+            response.body = input.substr(bodyStart);
+            return response;
+        }
+    }
+}
+
+// Whether the server closed an idle connection or sent something nobody asked for
+bool stale(int fd)
+{
+    pollfd pfd{ fd, POLLIN, 0 };
+    return poll(&pfd, 1, 0) != 0;
+}
+
+} // namespace
+
+
+HttpUrl HttpUrl::Parse(const std::string& url)
+{
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0)
+    {
+        throw std::invalid_argument("Only http:// URLs are supported: " + url);
+    }
+
+    HttpUrl parsed;
+    const auto authorityEnd = url.find('/', scheme.size());
+    const auto authority = url.substr(scheme.size(), authorityEnd - scheme.size());
+    if (authorityEnd != std::string::npos)
+    {
+        parsed.path = url.substr(authorityEnd);
+    }
+
+    const auto colon = authority.rfind(':');
+    parsed.host = authority.substr(0, colon);
+    if (colon != std::string::npos)
+    {
+        const auto port = authority.substr(colon + 1);
+        if (port.empty() || port.size() > 5 || port.find_first_not_of("0123456789") != std::string::npos
+            || std::stoul(port) > 65535)
+        {
+            throw std::invalid_argument("Invalid port in " + url);
+        }
+        parsed.port = static_cast<uint16_t>(std::stoul(port));
+    }
+
+    if (parsed.host.empty())
+    {
+        throw std::invalid_argument("Missing host in " + url);
+    }
+    return parsed;
+}
+
+
+HttpClient::HttpClient(HttpUrl url, std::chrono::milliseconds timeout, bool keepAlive)
+    : m_url(std::move(url))
+    , m_timeout(timeout)
+    , m_keepAlive(keepAlive)
+{}
+
+HttpClient::~HttpClient()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+}
+
+const HttpUrl& HttpClient::Url() const
+{
+    return m_url;
+}
+
+uint64_t HttpClient::Connections() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_connections;
+}
+
+HttpClientResponse HttpClient::Post(const Headers& headers, const std::string& body) const
+{
+    const auto deadline = Clock::now() + m_timeout;
+
+    std::string request = "POST " + m_url.path + " HTTP/1.1\r\nHost: " + m_url.host + ":"
+        + std::to_string(m_url.port) + "\r\nConnection: " + (m_keepAlive ? "keep-alive" : "close")
+        + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+    for (const auto& header : headers)
+    {
+        request += header.first + ": " + header.second + "\r\n";
+    }
+    request += "\r\n";
+    request += body;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        auto fd = m_fd;
+        m_fd = -1;
+        if (fd >= 0 && stale(fd))
+        {
+            close(fd);
+            fd = -1;
+        }
+        const bool reused = fd >= 0;
+        if (!reused)
+        {
+            fd = connectTo(m_url, deadline);
+            m_connections++;
+        }
+        Socket connection(fd);
+
+        bool keepOpen = m_keepAlive;
+        bool answered = false;
+        try
+        {
+            auto response = exchange(connection.Fd(), request, deadline, keepOpen, answered);
+            if (keepOpen)
+            {
+                m_fd = connection.Release();
+            }
+            return response;
+        }
+        catch (const std::exception&)
+        {
+            // The server may have closed the kept connection just as the request went out, a new one gets it once
+            if (!reused || answered)
+            {
+                throw;
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*!
+ * \file    httpclient.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The HttpClient class sends plain HTTP/1.1 requests with a bounded
+ *          timeout, e.g. to post a capture to the validator the way
+ *          validate_image() in api_client.py does. It either connects for
+ *          every request or keeps one connection alive between them.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef HTTPCLIENT_H
+#define HTTPCLIENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+struct HttpUrl
+{
+    std::string host;
+    uint16_t port = 80;
+    std::string path = "/";
+
+    // Parses http://host[:port][/path]. Throws std::invalid_argument for anything else, https included.
+    static HttpUrl Parse(const std::string& url);
+};
+
+
+struct HttpClientResponse
+{
+    int status = 0;
+    std::string body;
+};
+
+
+class HttpClient
+{
+
+public:
+    using Headers = std::vector<std::pair<std::string, std::string>>;
+
+    /*!
+     * \param timeout Bounds connecting, sending and receiving together
+     * \param keepAlive Sends every request on the same connection while the server keeps it open. Requests are
+     *        serialized then.
+     */
+    HttpClient(HttpUrl url, std::chrono::milliseconds timeout, bool keepAlive = false);
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /*!
+     * \brief Posts \p body to the URL. Throws std::runtime_error if there is no complete response within the
+     *        timeout. Any status is returned as is. A kept connection the server closed in the meantime is replaced
+     *        once.
+     */
+    HttpClientResponse Post(const Headers& headers, const std::string& body) const;
+
+    const HttpUrl& Url() const;
+
+    // Connections opened since construction
+    uint64_t Connections() const;
+
+private:
+    HttpUrl m_url;
+    std::chrono::milliseconds m_timeout;
+    const bool m_keepAlive;
+
+    mutable std::mutex m_mutex;
+    // The kept connection, -1 if there is none
+    mutable int m_fd = -1;
+    mutable uint64_t m_connections = 0;
+};
+
+#endif // HTTPCLIENT_H
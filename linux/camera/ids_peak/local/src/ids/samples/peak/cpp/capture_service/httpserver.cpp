@@ -0,0 +1,1097 @@
+/*!
+ * \file    httpserver.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The HttpServer class serves HTTP/1.1 with keep-alive from a single
+ *          epoll thread, so the routes of the Flask app (app.py) can be
+ *          answered by the capture service itself. Handlers that block, such
+ *          as a trigger, run on a worker thread and never stall the loop.
+ *          Stream responses stay open and receive every part published on
+ *          their channel, e.g. the frames of an MJPEG live view, shared by
+ *          all clients and skipped for clients that are slow or rate limited.
+ *
+ * \version 1.0.0
+ */
+
+#include "httpserver.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+
+// epoll user data of the two descriptors that are not connections, connection IDs start above them
+constexpr uint64_t listenId = 0;
+constexpr uint64_t wakeupId = 1;
+
+// Idle connections are looked for at most this often
+constexpr auto sweepInterval = std::chrono::seconds(1);
+
+std::string lowerCase(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string trim(const std::string& text)
+{
+    const auto first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+    {
+        return std::string();
+    }
+    const auto last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Whether the comma separated header value \p value contains \p token, case-insensitive
+bool hasToken(const std::string& value, const std::string& token)
+{
+    size_t start = 0;
+    while (start <= value.size())
+    {
+        auto end = value.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = value.size();
+        }
+        if (lowerCase(trim(value.substr(start, end - start))) == token)
+        {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+std::string percentDecode(const std::string& text)
+{
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '+')
+        {
+            decoded.push_back(' ');
+        }
+        else if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0)
+        {
+            decoded.push_back(static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2])));
+            i += 2;
+        }
+        else
+        {
+            decoded.push_back(text[i]);
+        }
+    }
+    return decoded;
+}
+
+// Parses the request line and the headers in front of the blank line. Returns false if they are malformed.
+bool parseHead(const std::string& head, HttpRequest& request, std::string& version)
+{
+    const auto lineEnd = head.find("\r\n");
+    const auto requestLine = head.substr(0, lineEnd);
+
+    const auto firstSpace = requestLine.find(' ');
+    const auto secondSpace = requestLine.find(' ', firstSpace + 1);
+    if (firstSpace == std::string::npos || secondSpace == std::string::npos
+        || requestLine.find(' ', secondSpace + 1) != std::string::npos)
+    {
+        return false;
+    }
+
+    request.method = requestLine.substr(0, firstSpace);
+    const auto target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    version = requestLine.substr(secondSpace + 1);
+    if (request.method.empty() || target.empty() || target[0] != '/' || version.compare(0, 7, "HTTP/1.") != 0)
+    {
+        return false;
+    }
+
+    const auto queryStart = target.find('?');
+    request.path = target.substr(0, queryStart);
+    request.query = (queryStart == std::string::npos) ? std::string() : target.substr(queryStart + 1);
+
+    size_t start = (lineEnd == std::string::npos) ? head.size() : lineEnd + 2;
+    while (start < head.size())
+    {
+        auto end = head.find("\r\n", start);
+        if (end == std::string::npos)
+        {
+            end = head.size();
+        }
+
+        const auto line = head.substr(start, end - start);
+        const auto colon = line.find(':');
+        if (colon == std::string::npos || colon == 0)
+        {
+            return false;
+        }
+
+        const auto name = lowerCase(line.substr(0, colon));
+        const auto value = trim(line.substr(colon + 1));
+        auto existing = request.headers.find(name);
+        if (existing == request.headers.end())
+        {
+            request.headers[name] = value;
+        }
+        else if (name == "content-length" && existing->second != value)
+        {
+            // Conflicting lengths are the classic request smuggling vector
+            return false;
+        }
+        else if (name != "content-length")
+        {
+            existing->second += ", " + value;
+        }
+
+        start = end + 2;
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+std::string HttpRequest::Header(const std::string& name) const
+{
+    const auto header = headers.find(name);
+    return (header != headers.end()) ? header->second : std::string();
+}
+
+std::string HttpRequest::QueryParameter(const std::string& name) const
+{
+    size_t start = 0;
+    while (start <= query.size())
+    {
+        auto end = query.find('&', start);
+        if (end == std::string::npos)
+        {
+            end = query.size();
+        }
+
+        const auto parameter = query.substr(start, end - start);
+        const auto equals = parameter.find('=');
+        if (percentDecode(parameter.substr(0, equals)) == name)
+        {
+            return (equals == std::string::npos) ? std::string() : percentDecode(parameter.substr(equals + 1));
+        }
+        start = end + 1;
+    }
+    return std::string();
+}
+
+
+HttpResponse HttpResponse::Json(int status, std::string body)
+{
+    HttpResponse response;
+    response.status = status;
+    response.body = std::move(body);
+    return response;
+}
+
+
+HttpServer::HttpServer(HttpServerOptions options)
+    : m_options(std::move(options))
+{}
+
+HttpServer::~HttpServer()
+{
+    Stop();
+}
+
+void HttpServer::Route(const std::string& method, const std::string& path, Handler handler, Dispatch dispatch)
+{
+    RouteEntry route;
+    route.handler = std::move(handler);
+    route.dispatch = dispatch;
+    m_routes[std::make_pair(method, path)] = std::move(route);
+}
+
+void HttpServer::SetLatencyRecorder(LatencyRecorder* recorder)
+{
+    m_latency = recorder;
+}
+
+void HttpServer::Publish(const std::string& channel, std::shared_ptr<const std::string> part)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& published = m_published[channel];
+        published.sequence++;
+        published.part = std::move(part);
+    }
+
+    if (m_running)
+    {
+        const uint64_t one = 1;
+        if (write(m_wakeup, &one, sizeof(one)) < 0)
+        {
+            std::cout << "EXCEPTION: HTTP wakeup: " << std::strerror(errno) << std::endl;
+        }
+    }
+}
+
+size_t HttpServer::StreamClients(const std::string& channel) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto clients = m_streamClients.find(channel);
+    return (clients != m_streamClients.end()) ? clients->second : 0;
+}
+
+void HttpServer::Start()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(m_options.port);
+    if (inet_pton(AF_INET, m_options.host.c_str(), &address.sin_addr) != 1)
+    {
+        throw std::runtime_error("Invalid HTTP host: " + m_options.host);
+    }
+
+    m_listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenSocket < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create HTTP socket: ") + std::strerror(errno));
+    }
+
+    // A restarted service must not wait for the connections of the previous one to leave TIME_WAIT
+    const int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(m_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(m_listenSocket, SOMAXCONN) < 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(m_listenSocket);
+        m_listenSocket = -1;
+        throw std::runtime_error(
+            "Failed to listen on " + m_options.host + ":" + std::to_string(m_options.port) + ": " + error);
+    }
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epoll < 0 || m_wakeup < 0)
+    {
+        const std::string error = std::strerror(errno);
+        Stop();
+        throw std::runtime_error("Failed to create the HTTP event loop: " + error);
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = listenId;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_listenSocket, &event);
+    event.data.u64 = wakeupId;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event);
+
+    m_nextConnectionId = wakeupId + 1;
+    m_accepted = 0;
+    m_rejected = 0;
+    m_requests = 0;
+    m_clientErrors = 0;
+    m_serverErrors = 0;
+    m_streamParts = 0;
+    m_streamSkipped = 0;
+    m_parts.clear();
+    m_nextDelivery = std::chrono::steady_clock::time_point::max();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workerRunning = true;
+    }
+    m_running = true;
+    for (size_t i = 0; i < std::max<size_t>(m_options.workerThreads, 1); ++i)
+    {
+        m_workerThreads.emplace_back(&HttpServer::runWorker, this);
+    }
+    m_thread = std::thread(&HttpServer::run, this);
+}
+
+void HttpServer::Stop()
+{
+    if (m_running)
+    {
+        m_running = false;
+        const uint64_t one = 1;
+        if (write(m_wakeup, &one, sizeof(one)) < 0)
+        {
+            // The loop still notices m_running within one sweep interval
+        }
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workerRunning = false;
+    }
+    m_workerCondition.notify_all();
+    for (auto& thread : m_workerThreads)
+    {
+        thread.join();
+    }
+    m_workerThreads.clear();
+
+    for (auto& connection : m_connections)
+    {
+        close(connection.second->fd);
+    }
+    m_connections.clear();
+    m_connectionCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workerJobs.clear();
+        m_completions.clear();
+        m_workerDepth = 0;
+        m_streamClients.clear();
+    }
+
+    for (auto* fd : { &m_listenSocket, &m_epoll, &m_wakeup })
+    {
+        if (*fd >= 0)
+        {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+HttpServerCounters HttpServer::Counters() const
+{
+    HttpServerCounters counters;
+    counters.accepted = m_accepted;
+    counters.rejected = m_rejected;
+    counters.requests = m_requests;
+    counters.clientErrors = m_clientErrors;
+    counters.serverErrors = m_serverErrors;
+    counters.connections = m_connectionCount;
+    counters.streamParts = m_streamParts;
+    counters.streamSkipped = m_streamSkipped;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters.workerDepth = m_workerDepth;
+    for (const auto& clients : m_streamClients)
+    {
+        counters.streams += clients.second;
+    }
+    return counters;
+}
+
+const char* HttpServer::StatusText(int status)
+{
+    switch (status)
+    {
+    case 100:
+        return "Continue";
+    case 200:
+        return "OK";
+    case 202:
+        return "Accepted";
+    case 204:
+        return "No Content";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 408:
+        return "Request Timeout";
+    case 409:
+        return "Conflict";
+    case 413:
+        return "Payload Too Large";
+    case 429:
+        return "Too Many Requests";
+    case 500:
+        return "Internal Server Error";
+    case 501:
+        return "Not Implemented";
+    case 503:
+        return "Service Unavailable";
+    case 504:
+        return "Gateway Timeout";
+    default:
+        return "Unknown";
+    }
+}
+
+void HttpServer::run()
+{
+    std::vector<epoll_event> events(64);
+    auto lastSweep = std::chrono::steady_clock::now();
+
+    while (m_running)
+    {
+        // Wakes up in time for a rate limited stream client, rounded up so it is due when the wait ends
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(sweepInterval);
+        const auto start = std::chrono::steady_clock::now();
+        if (m_nextDelivery < start + timeout)
+        {
+            timeout = std::chrono::duration_cast<std::chrono::milliseconds>(m_nextDelivery - start)
+                + std::chrono::milliseconds(1);
+        }
+        // A delivery already overdue, e.g. after a slow iteration, must not turn into a negative timeout, which would
+        // block until the next socket event
+        timeout = std::max(timeout, std::chrono::milliseconds(0));
+
+        const auto count = epoll_wait(
+            m_epoll, events.data(), static_cast<int>(events.size()), static_cast<int>(timeout.count()));
+        if (count < 0 && errno != EINTR)
+        {
+            std::cout << "EXCEPTION: epoll_wait: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto id = events[i].data.u64;
+            if (id == listenId)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (id == wakeupId)
+            {
+                uint64_t value = 0;
+                if (read(m_wakeup, &value, sizeof(value)) < 0)
+                {
+                    // Nothing to read, the completions are collected either way
+                }
+                completeWorkerJobs();
+                deliverParts();
+                continue;
+            }
+
+            // An earlier event of this round may have closed it
+            const auto found = m_connections.find(id);
+            if (found == m_connections.end())
+            {
+                continue;
+            }
+            auto& connection = *found->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                closeConnection(id);
+                continue;
+            }
+            if ((events[i].events & EPOLLIN) && !readFrom(connection))
+            {
+                continue;
+            }
+            service(connection);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= m_nextDelivery)
+        {
+            deliverParts();
+        }
+        if (now - lastSweep >= sweepInterval)
+        {
+            lastSweep = now;
+            closeIdleConnections();
+        }
+    }
+}
+
+void HttpServer::runWorker()
+{
+    while (true)
+    {
+        WorkerJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workerCondition.wait(lock, [this] { return !m_workerRunning || !m_workerJobs.empty(); });
+            if (!m_workerRunning)
+            {
+                return;
+            }
+
+            job = std::move(m_workerJobs.front());
+            m_workerJobs.pop_front();
+        }
+
+        Completion completion;
+        completion.connectionId = job.connectionId;
+        completion.response = invoke(*job.route, job.request);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completions.push_back(std::move(completion));
+        }
+
+        const uint64_t one = 1;
+        if (write(m_wakeup, &one, sizeof(one)) < 0)
+        {
+            std::cout << "EXCEPTION: HTTP wakeup: " << std::strerror(errno) << std::endl;
+        }
+    }
+}
+
+void HttpServer::acceptConnections()
+{
+    while (true)
+    {
+        const int fd = accept4(m_listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // EAGAIN once the backlog is empty. Out of descriptors, the next round retries.
+            return;
+        }
+
+        if (m_connections.size() >= m_options.maxConnections)
+        {
+            close(fd);
+            m_rejected++;
+            continue;
+        }
+
+        // Responses are written in one piece, Nagle would only hold back the tail of a large one
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = m_nextConnectionId++;
+        connection->lastActivity = std::chrono::steady_clock::now();
+        connection->events = EPOLLIN;
+
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.u64 = connection->id;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        m_connections[connection->id] = std::move(connection);
+        m_connectionCount = m_connections.size();
+        m_accepted++;
+    }
+}
+
+bool HttpServer::readFrom(Connection& connection)
+{
+    char buffer[16 * 1024];
+    while (true)
+    {
+        const auto count = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+            connection.lastActivity = std::chrono::steady_clock::now();
+            if (!connection.stream.empty())
+            {
+                // A stream client has nothing more to say, reading only notices when it leaves
+                continue;
+            }
+            connection.input.append(buffer, static_cast<size_t>(count));
+
+            // Nothing larger can become a valid request, handleNext() answers it with 413
+            if (connection.input.size() > m_options.maxRequestBytes)
+            {
+                return true;
+            }
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        // A peer that half-closes after its request, like curl or nc -N can, still gets the answers to what it sent
+        if (count == 0 && connection.stream.empty()
+            && (connection.busy || !connection.input.empty() || pending(connection)))
+        {
+            connection.peerClosed = true;
+            return true;
+        }
+
+        // Closed by the peer or broken
+        closeConnection(connection.id);
+        return false;
+    }
+}
+
+bool HttpServer::service(Connection& connection)
+{
+    while (true)
+    {
+        if (!flush(connection))
+        {
+            return false;
+        }
+        if (pending(connection))
+        {
+            // The socket is full, EPOLLOUT continues
+            break;
+        }
+        if (connection.closeAfterWrite)
+        {
+            closeConnection(connection.id);
+            return false;
+        }
+        if (!connection.stream.empty())
+        {
+            if (!deliver(connection))
+            {
+                break;
+            }
+            continue;
+        }
+        if (connection.busy)
+        {
+            break;
+        }
+        if (!handleNext(connection))
+        {
+            // Everything the peer sent before it shut down its side is answered
+            if (connection.peerClosed)
+            {
+                closeConnection(connection.id);
+                return false;
+            }
+            break;
+        }
+    }
+
+    watch(connection);
+    return true;
+}
+
+bool HttpServer::flush(Connection& connection)
+{
+    if (!sendFrom(connection, connection.output, connection.outputOffset))
+    {
+        return false;
+    }
+    if (connection.outputOffset < connection.output.size())
+    {
+        return true;
+    }
+
+    connection.output.clear();
+    connection.outputOffset = 0;
+
+    // While the worker has the request, nothing of its response has been sent yet
+    if (connection.timing && !connection.busy)
+    {
+        connection.timing = false;
+        if (m_latency)
+        {
+            m_latency->Record(LatencyStage::Http, connection.requestStart);
+        }
+    }
+
+    if (connection.part)
+    {
+        if (!sendFrom(connection, *connection.part, connection.partOffset))
+        {
+            return false;
+        }
+        if (connection.partOffset < connection.part->size())
+        {
+            return true;
+        }
+        connection.part.reset();
+        connection.partOffset = 0;
+    }
+    return true;
+}
+
+bool HttpServer::sendFrom(Connection& connection, const std::string& data, size_t& offset)
+{
+    while (offset < data.size())
+    {
+        const auto count = send(connection.fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (count > 0)
+        {
+            offset += static_cast<size_t>(count);
+            connection.lastActivity = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        closeConnection(connection.id);
+        return false;
+    }
+    return true;
+}
+
+bool HttpServer::deliver(Connection& connection)
+{
+    // A client still sending the previous part picks up the newest one once it is done
+    if (pending(connection))
+    {
+        return false;
+    }
+
+    const auto latest = m_parts.find(connection.stream);
+    if (latest == m_parts.end() || latest->second.sequence == connection.partSequence)
+    {
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < connection.nextPart)
+    {
+        m_nextDelivery = std::min(m_nextDelivery, connection.nextPart);
+        return false;
+    }
+
+    if (connection.partSequence != 0)
+    {
+        m_streamSkipped += latest->second.sequence - connection.partSequence - 1;
+    }
+    connection.part = latest->second.part;
+    connection.partOffset = 0;
+    connection.partSequence = latest->second.sequence;
+    connection.nextPart = now + connection.partInterval;
+    m_streamParts++;
+    return true;
+}
+
+void HttpServer::deliverParts()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_parts = m_published;
+    }
+
+    m_nextDelivery = std::chrono::steady_clock::time_point::max();
+
+    std::vector<uint64_t> streams;
+    for (const auto& connection : m_connections)
+    {
+        if (!connection.second->stream.empty())
+        {
+            streams.push_back(connection.first);
+        }
+    }
+
+    // service() may close a connection, so they are looked up again one by one
+    for (const auto id : streams)
+    {
+        const auto found = m_connections.find(id);
+        if (found != m_connections.end())
+        {
+            service(*found->second);
+        }
+    }
+}
+
+bool HttpServer::handleNext(Connection& connection)
+{
+    const auto headEnd = connection.input.find("\r\n\r\n");
+    if (headEnd == std::string::npos)
+    {
+        if (connection.input.size() > m_options.maxRequestBytes)
+        {
+            connection.keepAlive = false;
+            respond(connection, HttpResponse::Json(413, "{\"error\": \"request too large\"}"));
+            return true;
+        }
+        return false;
+    }
+
+    HttpRequest request;
+    std::string version;
+    if (!parseHead(connection.input.substr(0, headEnd), request, version))
+    {
+        connection.keepAlive = false;
+        respond(connection, HttpResponse::Json(400, "{\"error\": \"bad request\"}"));
+        return true;
+    }
+
+    const auto connectionHeader = request.Header("connection");
+    connection.keepAlive =
+        (version == "HTTP/1.0") ? hasToken(connectionHeader, "keep-alive") : !hasToken(connectionHeader, "close");
+
+    if (!request.Header("transfer-encoding").empty())
+    {
+        // Every client of ours sends a Content-Length, chunked bodies are not worth the parser
+        connection.keepAlive = false;
+        respond(connection, HttpResponse::Json(501, "{\"error\": \"transfer-encoding is not supported\"}"));
+        return true;
+    }
+
+    size_t contentLength = 0;
+    const auto lengthHeader = request.Header("content-length");
+    if (!lengthHeader.empty())
+    {
+        if (lengthHeader.find_first_not_of("0123456789") != std::string::npos || lengthHeader.size() > 12)
+        {
+            connection.keepAlive = false;
+            respond(connection, HttpResponse::Json(400, "{\"error\": \"bad content-length\"}"));
+            return true;
+        }
+        contentLength = std::stoull(lengthHeader);
+    }
+
+    const auto requestSize = headEnd + 4 + contentLength;
+    if (requestSize > m_options.maxRequestBytes)
+    {
+        connection.keepAlive = false;
+        respond(connection, HttpResponse::Json(413, "{\"error\": \"request too large\"}"));
+        return true;
+    }
+
+    if (connection.input.size() < requestSize)
+    {
+        if (!connection.continueSent && hasToken(request.Header("expect"), "100-continue"))
+        {
+            connection.continueSent = true;
+            connection.output += "HTTP/1.1 100 Continue\r\n\r\n";
+        }
+        return false;
+    }
+
+    request.body = connection.input.substr(headEnd + 4, contentLength);
+    connection.input.erase(0, requestSize);
+    connection.continueSent = false;
+    connection.requestStart = std::chrono::steady_clock::now();
+    connection.timing = true;
+    m_requests++;
+
+    const auto route = m_routes.find(std::make_pair(request.method, request.path));
+    if (route == m_routes.end())
+    {
+        const auto knownPath = std::any_of(m_routes.begin(), m_routes.end(),
+            [&request](const decltype(m_routes)::value_type& entry) { return entry.first.second == request.path; });
+        respond(connection, knownPath ? HttpResponse::Json(405, "{\"error\": \"method not allowed\"}")
+                                      : HttpResponse::Json(404, "{\"error\": \"not found\"}"));
+        return true;
+    }
+
+    if (route->second.dispatch == Dispatch::Loop)
+    {
+        respond(connection, invoke(route->second, request));
+        return true;
+    }
+
+    // Reading stops until the response is back, so a connection never has more than one request on the worker
+    connection.busy = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        WorkerJob job;
+        job.connectionId = connection.id;
+        job.request = std::move(request);
+        job.route = &route->second;
+        m_workerJobs.push_back(std::move(job));
+        m_workerDepth++;
+    }
+    m_workerCondition.notify_one();
+    return true;
+}
+
+void HttpServer::respond(Connection& connection, const HttpResponse& response)
+{
+    if (response.status >= 500)
+    {
+        m_serverErrors++;
+    }
+    else if (response.status >= 400)
+    {
+        m_clientErrors++;
+    }
+
+    if (!connection.keepAlive)
+    {
+        connection.closeAfterWrite = true;
+    }
+
+    auto& output = connection.output;
+    output += "HTTP/1.1 " + std::to_string(response.status) + " " + StatusText(response.status) + "\r\n";
+    output += "Content-Type: " + response.contentType + "\r\n";
+
+    if (!response.stream.empty() && response.status < 300)
+    {
+        // The stream ends with the connection, the client must not reuse it or cache any part of it
+        connection.keepAlive = false;
+        connection.closeAfterWrite = false;
+        connection.stream = response.stream;
+        connection.partInterval = (response.maxRate > 0.0)
+            ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / response.maxRate))
+            : std::chrono::steady_clock::duration::zero();
+        connection.input.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_streamClients[connection.stream]++;
+        }
+
+        output += "Cache-Control: no-cache, no-store\r\nConnection: close\r\n\r\n";
+        output += response.body;
+        return;
+    }
+
+    output += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+    output += connection.keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    output += response.body;
+}
+
+void HttpServer::watch(Connection& connection)
+{
+    uint32_t events = 0;
+    // At the end of input the socket stays readable, watching it would spin
+    if (!connection.busy && !connection.closeAfterWrite && !connection.peerClosed)
+    {
+        events |= EPOLLIN;
+    }
+    if (pending(connection))
+    {
+        events |= EPOLLOUT;
+    }
+
+    if (events != connection.events)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = connection.id;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+
+bool HttpServer::pending(const Connection& connection)
+{
+    return connection.outputOffset < connection.output.size() || connection.part;
+}
+
+void HttpServer::closeConnection(uint64_t id)
+{
+    const auto found = m_connections.find(id);
+    if (found == m_connections.end())
+    {
+        return;
+    }
+
+    if (!found->second->stream.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_streamClients[found->second->stream]--;
+    }
+
+    // Closing removes the descriptor from the epoll set. A request still on the worker completes into nothing.
+    close(found->second->fd);
+    m_connections.erase(found);
+    m_connectionCount = m_connections.size();
+}
+
+void HttpServer::completeWorkerJobs()
+{
+    std::deque<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        completions.swap(m_completions);
+        m_workerDepth -= completions.size();
+    }
+
+    for (auto& completion : completions)
+    {
+        const auto found = m_connections.find(completion.connectionId);
+        if (found == m_connections.end())
+        {
+            // The client went away while the worker had its request
+            continue;
+        }
+
+        auto& connection = *found->second;
+        connection.busy = false;
+        respond(connection, completion.response);
+        service(connection);
+    }
+}
+
+void HttpServer::closeIdleConnections()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout = std::chrono::milliseconds(m_options.idleTimeout_ms);
+
+    std::vector<uint64_t> idle;
+    for (const auto& connection : m_connections)
+    {
+        // Also catches clients that stopped reading a response. A stream is only idle while a part is stuck in it.
+        const auto& state = *connection.second;
+        if (!state.busy && now - state.lastActivity > timeout && (state.stream.empty() || pending(state)))
+        {
+            idle.push_back(connection.first);
+        }
+    }
+    for (const auto id : idle)
+    {
+        closeConnection(id);
+    }
+}
+
+HttpResponse HttpServer::invoke(const RouteEntry& route, const HttpRequest& request)
+{
+    try
+    {
+        return route.handler(request);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        return HttpResponse::Json(500, "{\"error\": \"internal error\"}");
+    }
+}
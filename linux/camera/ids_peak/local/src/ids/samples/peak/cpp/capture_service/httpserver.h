@@ -0,0 +1,281 @@
+/*!
+ * \file    httpserver.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The HttpServer class serves HTTP/1.1 with keep-alive from a single
+ *          epoll thread, so the routes of the Flask app (app.py) can be
+ *          answered by the capture service itself. Handlers that block, such
+ *          as a trigger, run on a worker thread and never stall the loop.
+ *          Stream responses stay open and receive every part published on
+ *          their channel, e.g. the frames of an MJPEG live view, shared by
+ *          all clients and skipped for clients that are slow or rate limited.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include "latencyhistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+struct HttpRequest
+{
+    std::string method;
+    // Target without the query string, as sent
+    std::string path;
+    std::string query;
+    // Header names in lower case, repeated headers joined with ", "
+    std::map<std::string, std::string> headers;
+    std::string body;
+
+    // Value of the header \p name in lower case, empty if absent
+    std::string Header(const std::string& name) const;
+    // Percent-decoded value of the query parameter \p name, empty if absent
+    std::string QueryParameter(const std::string& name) const;
+};
+
+
+struct HttpResponse
+{
+    int status = 200;
+    std::string contentType = "application/json";
+    std::string body;
+    // Channel of a stream response, see HttpServer::Publish(). The body is sent without a length and every part
+    // published on the channel follows it until the client disconnects. Ignored for an error status.
+    std::string stream;
+    // Parts per second a stream client gets at most, 0 for all of them
+    double maxRate = 0.0;
+
+    static HttpResponse Json(int status, std::string body);
+};
+
+
+struct HttpServerOptions
+{
+    std::string host = "0.0.0.0";
+    uint16_t port = 8000;
+    // Connections beyond this are closed right after accept
+    size_t maxConnections = 64;
+    // Request line, headers and body together. Larger requests are answered with 413 and the connection is closed.
+    size_t maxRequestBytes = 64 * 1024;
+    // Connections without a request in flight are closed after this long without traffic
+    uint64_t idleTimeout_ms = 30000;
+    // Threads running Dispatch::Worker handlers. One runs them in arrival order, more let a slow handler, e.g. a
+    // trigger waiting for validation, run next to the others.
+    size_t workerThreads = 1;
+};
+
+
+/*!
+ * \brief Counters of a server. All values are totals since Start(), except connections, workerDepth and streams.
+ */
+struct HttpServerCounters
+{
+    uint64_t accepted = 0;
+    // Connections closed at once because maxConnections were open
+    uint64_t rejected = 0;
+    uint64_t requests = 0;
+    uint64_t clientErrors = 0;
+    uint64_t serverErrors = 0;
+    size_t connections = 0;
+    // Requests waiting for or running on a worker thread
+    size_t workerDepth = 0;
+    // Open stream responses of all channels
+    size_t streams = 0;
+    // Parts sent to stream clients, and parts a client never got because a newer one replaced it first
+    uint64_t streamParts = 0;
+    uint64_t streamSkipped = 0;
+};
+
+
+class HttpServer
+{
+
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest& request)>;
+
+    enum class Dispatch
+    {
+        // Runs on the event loop, must not block
+        Loop,
+        // Runs on a worker thread, see HttpServerOptions::workerThreads. A connection has one request there at most.
+        Worker
+    };
+
+    explicit HttpServer(HttpServerOptions options);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /*!
+     * \brief Serves \p method requests for \p path, which is matched exactly without the query string. Exceptions of
+     *        \p handler are answered with 500. Call before Start().
+     */
+    void Route(const std::string& method, const std::string& path, Handler handler, Dispatch dispatch = Dispatch::Loop);
+
+    /*!
+     * \brief Records the time from a complete request to its fully sent response (http) in \p recorder, which must
+     *        outlive the server. Null disables it. Call before Start().
+     */
+    void SetLatencyRecorder(LatencyRecorder* recorder);
+
+    /*!
+     * \brief Hands \p part to every stream client of \p channel without copying it. Only the latest part of a channel
+     *        is kept: a client still sending the previous one, or waiting for its rate limit, gets the newest part
+     *        once it is ready and skips the ones in between. Thread-safe.
+     */
+    void Publish(const std::string& channel, std::shared_ptr<const std::string> part);
+
+    // Open stream responses of \p channel, e.g. to produce parts only while somebody watches. Thread-safe.
+    size_t StreamClients(const std::string& channel) const;
+
+    // Binds and listens, throws std::runtime_error on failure
+    void Start();
+
+    // Waits for the handlers running on the worker threads, then closes every connection
+    void Stop();
+
+    HttpServerCounters Counters() const;
+
+    // Reason phrase of \p status, e.g. "Not Found"
+    static const char* StatusText(int status);
+
+private:
+    struct RouteEntry
+    {
+        Handler handler;
+        Dispatch dispatch = Dispatch::Loop;
+    };
+
+    struct Connection
+    {
+        int fd = -1;
+        uint64_t id = 0;
+        std::string input;
+        std::string output;
+        size_t outputOffset = 0;
+        // A worker thread has the current request
+        bool busy = false;
+        bool keepAlive = true;
+        bool closeAfterWrite = false;
+        bool continueSent = false;
+        // The peer shut down its side after sending requests, which are answered before the connection is closed
+        bool peerClosed = false;
+        // A complete request is waiting for its response to be sent
+        bool timing = false;
+        uint32_t events = 0;
+        std::chrono::steady_clock::time_point requestStart;
+        std::chrono::steady_clock::time_point lastActivity;
+        // Channel of a stream response, empty for a regular connection
+        std::string stream;
+        std::chrono::steady_clock::duration partInterval{ 0 };
+        std::chrono::steady_clock::time_point nextPart;
+        // Published part being sent after output, shared with the other clients of the channel
+        std::shared_ptr<const std::string> part;
+        size_t partOffset = 0;
+        uint64_t partSequence = 0;
+    };
+
+    struct PublishedPart
+    {
+        uint64_t sequence = 0;
+        std::shared_ptr<const std::string> part;
+    };
+
+    struct WorkerJob
+    {
+        uint64_t connectionId = 0;
+        HttpRequest request;
+        const RouteEntry* route = nullptr;
+    };
+
+    struct Completion
+    {
+        uint64_t connectionId = 0;
+        HttpResponse response;
+    };
+
+    void run();
+    void runWorker();
+
+    void acceptConnections();
+    // Each of these may close the connection, which must not be used after they return false
+    bool readFrom(Connection& connection);
+    bool service(Connection& connection);
+    bool flush(Connection& connection);
+    bool sendFrom(Connection& connection, const std::string& data, size_t& offset);
+    // Hands the latest part of its channel to a stream connection that is ready for it. Returns true if it did.
+    bool deliver(Connection& connection);
+    void deliverParts();
+    // Parses and dispatches the next complete request. Returns false if more input is needed.
+    bool handleNext(Connection& connection);
+    void respond(Connection& connection, const HttpResponse& response);
+    void watch(Connection& connection);
+    static bool pending(const Connection& connection);
+    void closeConnection(uint64_t id);
+    void completeWorkerJobs();
+    void closeIdleConnections();
+
+    static HttpResponse invoke(const RouteEntry& route, const HttpRequest& request);
+
+    const HttpServerOptions m_options;
+    LatencyRecorder* m_latency = nullptr;
+    std::map<std::pair<std::string, std::string>, RouteEntry> m_routes;
+
+    int m_listenSocket = -1;
+    int m_epoll = -1;
+    // Wakes the loop for completed worker jobs and for Stop()
+    int m_wakeup = -1;
+
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    std::vector<std::thread> m_workerThreads;
+
+    // Only touched by the loop thread
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> m_connections;
+    uint64_t m_nextConnectionId = 0;
+    std::map<std::string, PublishedPart> m_parts;
+    // Earliest time a rate limited stream client is ready for the part it skipped
+    std::chrono::steady_clock::time_point m_nextDelivery = std::chrono::steady_clock::time_point::max();
+
+    // Protects the worker queue, the completions and the published parts
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workerCondition;
+    std::deque<WorkerJob> m_workerJobs;
+    std::deque<Completion> m_completions;
+    bool m_workerRunning = false;
+    size_t m_workerDepth = 0;
+    std::map<std::string, PublishedPart> m_published;
+    std::map<std::string, size_t> m_streamClients;
+
+    std::atomic<uint64_t> m_accepted{ 0 };
+    std::atomic<uint64_t> m_rejected{ 0 };
+    std::atomic<uint64_t> m_requests{ 0 };
+    std::atomic<uint64_t> m_clientErrors{ 0 };
+    std::atomic<uint64_t> m_serverErrors{ 0 };
+    std::atomic<size_t> m_connectionCount{ 0 };
+    std::atomic<uint64_t> m_streamParts{ 0 };
+    std::atomic<uint64_t> m_streamSkipped{ 0 };
+};
+
+#endif // HTTPSERVER_H
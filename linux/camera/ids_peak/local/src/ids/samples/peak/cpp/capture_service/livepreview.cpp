@@ -0,0 +1,216 @@
+/*!
+ * \file    livepreview.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The LivePreview class turns camera buffers of the armed
+ *          acquisition pipeline into a low resolution MJPEG stream. It takes
+ *          a buffer only while somebody watches and at most at its frame
+ *          rate, encodes it with a PreviewJpegEncoder on its own thread and
+ *          publishes the frame as one multipart/x-mixed-replace part that is
+ *          shared by every client.
+ *
+ * \version 1.0.0
+ */
+
+#include "livepreview.h"
+
+#include <peak/converters/peak_buffer_converter_ipl.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+
+const char* const boundary = "frame";
+
+std::chrono::steady_clock::duration frameInterval(double maxFps)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(maxFps, 0.1)));
+}
+
+} // namespace
+
+
+LivePreview::LivePreview(LivePreviewOptions options, Viewers viewers, Publish publish)
+    : m_options(std::move(options))
+    , m_frameInterval(frameInterval(m_options.maxFps))
+    , m_viewers(std::move(viewers))
+    , m_publish(std::move(publish))
+    , m_encoder(m_options.longSide, m_options.quality)
+{}
+
+LivePreview::~LivePreview()
+{
+    Stop();
+}
+
+void LivePreview::SetLatencyRecorder(LatencyRecorder* recorder)
+{
+    m_latency = recorder;
+}
+
+void LivePreview::Start(Release release)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        return;
+    }
+
+    m_release = std::move(release);
+    m_counters = LivePreviewCounters();
+    m_nextFrame = std::chrono::steady_clock::time_point();
+    m_running = true;
+    m_thread = std::thread(&LivePreview::run, this);
+}
+
+void LivePreview::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    // Taken but never encoded
+    if (m_buffer)
+    {
+        m_release(m_buffer);
+        m_buffer.reset();
+        m_busy = false;
+    }
+}
+
+bool LivePreview::Wanted() const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running || m_busy || std::chrono::steady_clock::now() < m_nextFrame)
+        {
+            return false;
+        }
+    }
+
+    // Asked last, it is the only check that takes a lock of somebody else
+    return m_viewers() > 0;
+}
+
+bool LivePreview::Offer(const std::shared_ptr<peak::core::Buffer>& buffer)
+{
+    if (!Wanted())
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running || m_busy)
+        {
+            return false;
+        }
+
+        // The interval counts from frame to frame, so a slow encode lowers the rate instead of queueing frames
+        m_busy = true;
+        m_buffer = buffer;
+        m_nextFrame = std::chrono::steady_clock::now() + m_frameInterval;
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+const LivePreviewOptions& LivePreview::Options() const
+{
+    return m_options;
+}
+
+LivePreviewCounters LivePreview::Counters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counters;
+}
+
+std::string LivePreview::ContentType()
+{
+    return std::string("multipart/x-mixed-replace; boundary=") + boundary;
+}
+
+void LivePreview::run()
+{
+    while (true)
+    {
+        std::shared_ptr<peak::core::Buffer> buffer;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_running || m_buffer; });
+            if (!m_running)
+            {
+                return;
+            }
+            buffer = std::move(m_buffer);
+        }
+
+        std::vector<uint8_t> jpeg;
+        size_t width = 0;
+        size_t height = 0;
+        std::string error;
+        try
+        {
+            if (buffer->IsIncomplete())
+            {
+                error = "Incomplete frame";
+            }
+            else
+            {
+                LatencyRecorder::Scope timing(m_latency, LatencyStage::Preview);
+                const auto image = peak::BufferTo<peak::ipl::Image>(buffer);
+                jpeg = m_encoder.Encode(image);
+                m_encoder.OutputSize(image.Width(), image.Height(), width, height);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+
+        // The pixels are no longer needed, the camera gets the buffer back before the part is built
+        m_release(buffer);
+        buffer.reset();
+
+        if (!error.empty())
+        {
+            std::cout << "EXCEPTION: " << error << std::endl;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_counters.errors++;
+            m_busy = false;
+            continue;
+        }
+
+        auto part = std::make_shared<std::string>();
+        part->reserve(jpeg.size() + 128);
+        *part += std::string("--") + boundary + "\r\nContent-Type: image/jpeg\r\nContent-Length: "
+            + std::to_string(jpeg.size()) + "\r\n\r\n";
+        part->append(reinterpret_cast<const char*>(jpeg.data()), jpeg.size());
+        *part += "\r\n";
+
+        m_publish(std::move(part));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters.frames++;
+        m_counters.width = width;
+        m_counters.height = height;
+        m_busy = false;
+    }
+}
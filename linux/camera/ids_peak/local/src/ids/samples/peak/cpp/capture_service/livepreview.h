@@ -0,0 +1,129 @@
+/*!
+ * \file    livepreview.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The LivePreview class turns camera buffers of the armed
+ *          acquisition pipeline into a low resolution MJPEG stream. It takes
+ *          a buffer only while somebody watches and at most at its frame
+ *          rate, encodes it with a PreviewJpegEncoder on its own thread and
+ *          publishes the frame as one multipart/x-mixed-replace part that is
+ *          shared by every client.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef LIVEPREVIEW_H
+#define LIVEPREVIEW_H
+
+#include <peak/peak.hpp>
+
+#include "latencyhistogram.h"
+#include "previewjpegencoder.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+struct LivePreviewOptions
+{
+    // Length of the longer side of a preview frame
+    size_t longSide = 640;
+    int quality = 70;
+    // Frames per second taken from the camera at most, a client may ask for fewer
+    double maxFps = 10.0;
+};
+
+
+/*!
+ * \brief Counters of a preview. All values are totals since Start(), except the size of the last frame.
+ */
+struct LivePreviewCounters
+{
+    uint64_t frames = 0;
+    uint64_t errors = 0;
+    size_t width = 0;
+    size_t height = 0;
+};
+
+
+class LivePreview
+{
+
+public:
+    // Number of clients watching, e.g. HttpServer::StreamClients()
+    using Viewers = std::function<size_t()>;
+    // Receives every encoded frame as a complete multipart part, boundary and headers included
+    using Publish = std::function<void(std::shared_ptr<const std::string> part)>;
+    // Gives a buffer taken by Offer() back, e.g. to QueueBuffer
+    using Release = std::function<void(const std::shared_ptr<peak::core::Buffer>& buffer)>;
+
+    LivePreview(LivePreviewOptions options, Viewers viewers, Publish publish);
+    ~LivePreview();
+
+    LivePreview(const LivePreview&) = delete;
+    LivePreview& operator=(const LivePreview&) = delete;
+
+    /*!
+     * \brief Records the encode time of every frame (preview) in \p recorder, which must outlive the preview. Null
+     *        disables it. Call before Start().
+     */
+    void SetLatencyRecorder(LatencyRecorder* recorder);
+
+    void Start(Release release);
+
+    // Waits for the frame being encoded and gives a buffer still held back through the release function
+    void Stop();
+
+    /*!
+     * \brief Whether Offer() would take a buffer now: somebody watches, the previous frame is encoded and the frame
+     *        interval has passed.
+     */
+    bool Wanted() const;
+
+    /*!
+     * \brief Takes \p buffer for encoding if Wanted(). It is given back through the release function once the frame
+     *        is encoded. Returns false if the buffer was not taken, the caller keeps it then. Never blocks.
+     */
+    bool Offer(const std::shared_ptr<peak::core::Buffer>& buffer);
+
+    const LivePreviewOptions& Options() const;
+    LivePreviewCounters Counters() const;
+
+    // Content type of the stream the parts belong to
+    static std::string ContentType();
+
+private:
+    void run();
+
+    const LivePreviewOptions m_options;
+    const std::chrono::steady_clock::duration m_frameInterval;
+    Viewers m_viewers;
+    Publish m_publish;
+    Release m_release;
+    LatencyRecorder* m_latency = nullptr;
+
+    // Only used by the encoding thread
+    PreviewJpegEncoder m_encoder;
+
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = false;
+    // A buffer is waiting for or being encoded
+    bool m_busy = false;
+    std::shared_ptr<peak::core::Buffer> m_buffer;
+    std::chrono::steady_clock::time_point m_nextFrame;
+    LivePreviewCounters m_counters;
+};
+
+#endif // LIVEPREVIEW_H
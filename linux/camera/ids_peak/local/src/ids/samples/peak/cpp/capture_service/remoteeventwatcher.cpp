@@ -0,0 +1,189 @@
+/*!
+ * \file    remoteeventwatcher.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The RemoteEventWatcher class enables remote device events such as
+ *          FrameDropped on the camera and reports every event it receives
+ *          from a thread of its own, e.g. to dump the black box.
+ *
+ * \version 1.0.0
+ */
+
+#include "remoteeventwatcher.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+
+RemoteEventWatcher::RemoteEventWatcher(std::shared_ptr<peak::core::Device> device, Callback callback)
+    : m_device(std::move(device))
+    , m_callback(std::move(callback))
+{
+    m_nodemapRemoteDevice = m_device->RemoteDevice()->NodeMaps().at(0);
+}
+
+RemoteEventWatcher::~RemoteEventWatcher()
+{
+    Stop();
+}
+
+std::vector<std::string> RemoteEventWatcher::Start(const std::vector<std::string>& events)
+{
+    Stop();
+
+    std::vector<std::string> enabled;
+    try
+    {
+        m_eventController = m_device->EnableEvents(peak::core::EventType::RemoteDevice);
+    }
+    catch (const peak::core::NotAvailableException&)
+    {
+        // The camera doesn't support remote device events
+        return enabled;
+    }
+    catch (const peak::core::NotImplementedException&)
+    {
+        // The transport layer doesn't support remote device events
+        return enabled;
+    }
+
+    m_names.clear();
+    for (const auto& event : events)
+    {
+        try
+        {
+            const auto selector =
+                m_nodemapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("EventSelector");
+            const auto entry = selector->FindEntry(event);
+            selector->SetCurrentEntry(entry);
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("EventNotification")
+                ->SetCurrentEntry("On");
+
+            m_names[static_cast<uint64_t>(entry->Value())] = event;
+            enabled.push_back(event);
+        }
+        catch (const peak::core::NotFoundException&)
+        {
+            // The camera doesn't know this event
+        }
+        catch (const peak::core::BadAccessException&)
+        {
+            // The camera knows this event but doesn't support it
+        }
+    }
+
+    if (enabled.empty())
+    {
+        m_eventController.reset();
+        return enabled;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&RemoteEventWatcher::run, this);
+    return enabled;
+}
+
+void RemoteEventWatcher::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_running = false;
+
+    try
+    {
+        // Abort a pending WaitForEvent so the watcher thread can terminate
+        m_eventController->KillWait();
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+    }
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    for (const auto& name : m_names)
+    {
+        try
+        {
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("EventSelector")
+                ->SetCurrentEntry(name.second);
+            m_nodemapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("EventNotification")
+                ->SetCurrentEntry("Off");
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    m_eventController.reset();
+}
+
+uint64_t RemoteEventWatcher::EventCounter() const
+{
+    return m_eventCounter;
+}
+
+void RemoteEventWatcher::run()
+{
+    while (m_running)
+    {
+        std::unique_ptr<peak::core::Event> event;
+
+        try
+        {
+            // The timeout only bounds the reaction time to Stop()
+            event = m_eventController->WaitForEvent(500);
+        }
+        catch (const peak::core::TimeoutException&)
+        {
+            continue;
+        }
+        catch (const peak::core::AbortedException&)
+        {
+            continue;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+
+            // Without a sleep a broken event channel would keep this thread spinning
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        m_eventCounter++;
+
+        try
+        {
+            // Keeps the Event* data nodes current for anyone reading them
+            m_nodemapRemoteDevice->UpdateEventNodes(event);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+
+        const auto name = m_names.find(event->ID());
+        if (name != m_names.end())
+        {
+            m_callback(name->second);
+        }
+        else
+        {
+            std::ostringstream id;
+            id << "event_0x" << std::hex << event->ID();
+            m_callback(id.str());
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*!
+ * \file    remoteeventwatcher.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The RemoteEventWatcher class enables remote device events such as
+ *          FrameDropped on the camera and reports every event it receives
+ *          from a thread of its own, e.g. to dump the black box.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef REMOTEEVENTWATCHER_H
+#define REMOTEEVENTWATCHER_H
+
+#include <peak/peak.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+class RemoteEventWatcher
+{
+
+public:
+    // Called on the watcher thread with the EventSelector name of each event, or its ID in hex if it is unknown
+    using Callback = std::function<void(const std::string& event)>;
+
+    RemoteEventWatcher(std::shared_ptr<peak::core::Device> device, Callback callback);
+    ~RemoteEventWatcher();
+
+    RemoteEventWatcher(const RemoteEventWatcher&) = delete;
+    RemoteEventWatcher& operator=(const RemoteEventWatcher&) = delete;
+
+    /*!
+     * \brief Turns on the notification of each of \p events the camera supports and starts watching. Returns the
+     *        events turned on, none if the camera or the transport layer has no remote device events.
+     */
+    std::vector<std::string> Start(const std::vector<std::string>& events);
+
+    // Turns the notifications off again and joins the watcher thread
+    void Stop();
+
+    uint64_t EventCounter() const;
+
+private:
+    void run();
+
+    std::shared_ptr<peak::core::Device> m_device;
+    std::shared_ptr<peak::core::NodeMap> m_nodemapRemoteDevice;
+    Callback m_callback;
+
+    std::unique_ptr<peak::core::EventController> m_eventController;
+    // Event ID to EventSelector entry, the IDs are the numeric values of the entries
+    std::map<uint64_t, std::string> m_names;
+
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    std::atomic<uint64_t> m_eventCounter{ 0 };
+};
+
+#endif // REMOTEEVENTWATCHER_H
@@ -0,0 +1,264 @@
+/*!
+ * \file    triggerscheduler.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The TriggerScheduler class is the single owner of the camera
+ *          trigger. Capture requests from the socket and from HTTP are queued
+ *          with a deadline and fired by its own thread one capture at a time.
+ *          Requests that land within the exposure of the capture in flight,
+ *          or that wait while it runs, share one capture. A request the
+ *          queue has no room for is answered busy, one whose deadline passes
+ *          first is answered late.
+ *
+ * \version 1.0.0
+ */
+
+#include "triggerscheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+
+double milliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::max(std::chrono::duration<double, std::milli>(duration).count(), 0.0);
+}
+
+} // namespace
+
+
+TriggerScheduler::TriggerScheduler(TriggerSchedulerOptions options, Capture capture)
+    : m_options(std::move(options))
+    , m_capture(std::move(capture))
+{}
+
+TriggerScheduler::~TriggerScheduler()
+{
+    Stop();
+}
+
+void TriggerScheduler::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        return;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&TriggerScheduler::run, this);
+}
+
+void TriggerScheduler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+
+        for (auto& request : m_queue)
+        {
+            request->outcome.status = TriggerStatus::Failed;
+            request->outcome.result.error = "Trigger scheduler stopped";
+            request->done = true;
+            m_counters.failed++;
+        }
+        m_queue.clear();
+        m_counters.depth = 0;
+    }
+    m_queueCondition.notify_all();
+    m_doneCondition.notify_all();
+
+    // Returns once the capture in flight is done, its requests still get the result
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+TriggerOutcome TriggerScheduler::Trigger(std::chrono::steady_clock::time_point deadline, Orphan orphan)
+{
+    auto request = std::make_shared<Request>();
+    request->arrival = std::chrono::steady_clock::now();
+    request->deadline = deadline;
+    request->orphan = std::move(orphan);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_counters.requests++;
+
+    if (!m_running)
+    {
+        m_counters.failed++;
+        request->outcome.result.error = "Trigger scheduler is not running";
+        return request->outcome;
+    }
+
+    if (m_current && request->arrival - m_current->fired <= m_options.coalesceWindow)
+    {
+        // The sensor is still exposing the frame in flight, it was taken no earlier than this request
+        m_current->requests.push_back(request);
+    }
+    else if (m_queue.size() >= m_options.queueCapacity)
+    {
+        m_counters.busy++;
+        request->outcome.status = TriggerStatus::Busy;
+        request->outcome.result.error = "Trigger queue is full";
+        return request->outcome;
+    }
+    else
+    {
+        m_queue.push_back(request);
+        m_counters.depth = m_queue.size();
+        m_queueCondition.notify_one();
+    }
+
+    if (m_doneCondition.wait_until(lock, deadline, [&request] { return request->done; }))
+    {
+        return request->outcome;
+    }
+
+    // Left behind by its deadline. A queued request is withdrawn, a capture in flight completes without it.
+    const auto queued = std::find(m_queue.begin(), m_queue.end(), request);
+    const bool fired = (queued == m_queue.end());
+    if (!fired)
+    {
+        m_queue.erase(queued);
+        m_counters.depth = m_queue.size();
+    }
+
+    m_counters.late++;
+    request->done = true;
+    request->outcome.status = TriggerStatus::Late;
+    request->outcome.result.error =
+        fired ? "Deadline passed before the capture completed" : "Deadline passed while waiting for the camera";
+    return request->outcome;
+}
+
+TriggerSchedulerCounters TriggerScheduler::Counters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counters;
+}
+
+const TriggerSchedulerOptions& TriggerScheduler::Options() const
+{
+    return m_options;
+}
+
+const char* TriggerScheduler::StatusName(TriggerStatus status)
+{
+    switch (status)
+    {
+    case TriggerStatus::Captured:
+        return "captured";
+    case TriggerStatus::Coalesced:
+        return "coalesced";
+    case TriggerStatus::Busy:
+        return "busy";
+    case TriggerStatus::Late:
+        return "late";
+    case TriggerStatus::Failed:
+        return "failed";
+    default:
+        return "unknown";
+    }
+}
+
+void TriggerScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_queueCondition.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+        if (!m_running)
+        {
+            return;
+        }
+
+        // Everything that waited while the previous capture ran is served by the next one
+        auto batch = std::make_shared<Batch>();
+        batch->requests.swap(m_queue);
+        m_counters.depth = 0;
+
+        // A request that is already late is not worth a capture
+        const auto now = std::chrono::steady_clock::now();
+        auto expired = std::stable_partition(batch->requests.begin(), batch->requests.end(),
+            [now](const std::shared_ptr<Request>& request) { return request->deadline > now; });
+        for (auto it = expired; it != batch->requests.end(); ++it)
+        {
+            (*it)->done = true;
+            (*it)->outcome.status = TriggerStatus::Late;
+            (*it)->outcome.result.error = "Deadline passed while waiting for the camera";
+            m_counters.late++;
+        }
+        if (expired != batch->requests.end())
+        {
+            batch->requests.erase(expired, batch->requests.end());
+            m_doneCondition.notify_all();
+        }
+        if (batch->requests.empty())
+        {
+            continue;
+        }
+
+        batch->fired = now;
+        m_current = batch;
+        m_counters.captures++;
+
+        lock.unlock();
+        const auto result = m_capture(m_options.captureTimeout_ms);
+        lock.lock();
+
+        m_current.reset();
+
+        // Requests that joined during the exposure were added to the batch while it was in flight
+        bool first = true;
+        Orphan orphan;
+        for (auto& request : batch->requests)
+        {
+            if (request->done)
+            {
+                // Answered late by its caller
+                if (!orphan)
+                {
+                    orphan = request->orphan;
+                }
+                continue;
+            }
+
+            request->outcome.result = result;
+            request->outcome.batch = batch->requests.size();
+            request->outcome.queued_ms = milliseconds(batch->fired - request->arrival);
+            if (!result.success)
+            {
+                request->outcome.status = TriggerStatus::Failed;
+                m_counters.failed++;
+            }
+            else if (first)
+            {
+                request->outcome.status = TriggerStatus::Captured;
+            }
+            else
+            {
+                request->outcome.status = TriggerStatus::Coalesced;
+                m_counters.coalesced++;
+            }
+            request->done = true;
+            first = false;
+        }
+        m_doneCondition.notify_all();
+
+        // The image was written for nobody, still let the caller that fired it finish its work on it
+        if (result.success && first && orphan)
+        {
+            m_counters.orphaned++;
+            lock.unlock();
+            orphan(result);
+            lock.lock();
+        }
+    }
+}
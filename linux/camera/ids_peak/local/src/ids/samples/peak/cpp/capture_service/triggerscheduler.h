@@ -0,0 +1,161 @@
+/*!
+ * \file    triggerscheduler.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The TriggerScheduler class is the single owner of the camera
+ *          trigger. Capture requests from the socket and from HTTP are queued
+ *          with a deadline and fired by its own thread one capture at a time.
+ *          Requests that land within the exposure of the capture in flight,
+ *          or that wait while it runs, share one capture. A request the
+ *          queue has no room for is answered busy, one whose deadline passes
+ *          first is answered late.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef TRIGGERSCHEDULER_H
+#define TRIGGERSCHEDULER_H
+
+#include "acquisitionworker.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+struct TriggerSchedulerOptions
+{
+    // Requests waiting for a capture beyond this are answered busy at once
+    size_t queueCapacity = 8;
+    // A request arriving this long after the capture in flight was triggered still shares its frame, e.g. the
+    // exposure time
+    std::chrono::microseconds coalesceWindow{ 0 };
+    // Passed to the capture function, bounds one capture independent of the deadlines waiting for it
+    uint64_t captureTimeout_ms = 2000;
+};
+
+
+enum class TriggerStatus
+{
+    // The request fired a capture of its own
+    Captured,
+    // The request shared the capture of another one
+    Coalesced,
+    // The queue was full
+    Busy,
+    // The deadline passed before the capture was complete
+    Late,
+    // The capture failed
+    Failed
+};
+
+
+struct TriggerOutcome
+{
+    TriggerStatus status = TriggerStatus::Failed;
+    // Valid for Captured, Coalesced and Failed. A Late request never sees the capture, which is still written and
+    // handed to the orphan function of Trigger() if no other request received it.
+    CaptureResult result;
+    // Requests served by the capture
+    size_t batch = 0;
+    // From the request until its capture was fired
+    double queued_ms = 0.0;
+};
+
+
+/*!
+ * \brief Counters of a scheduler. All values are totals since construction, except depth.
+ */
+struct TriggerSchedulerCounters
+{
+    uint64_t requests = 0;
+    uint64_t captures = 0;
+    uint64_t coalesced = 0;
+    uint64_t busy = 0;
+    uint64_t late = 0;
+    uint64_t failed = 0;
+    // Captures whose requests were all answered late while they were in flight, handed to an orphan function
+    uint64_t orphaned = 0;
+    // Requests waiting for a capture to be fired
+    size_t depth = 0;
+};
+
+
+class TriggerScheduler
+{
+
+public:
+    // Fires one capture and waits for it, e.g. AcquisitionWorker::Trigger()
+    using Capture = std::function<CaptureResult(uint64_t timeout_ms)>;
+    // Takes a successful capture nobody waits for any more, e.g. to validate the written image anyway
+    using Orphan = std::function<void(const CaptureResult& result)>;
+
+    TriggerScheduler(TriggerSchedulerOptions options, Capture capture);
+    ~TriggerScheduler();
+
+    TriggerScheduler(const TriggerScheduler&) = delete;
+    TriggerScheduler& operator=(const TriggerScheduler&) = delete;
+
+    void Start();
+
+    // Waits for the capture in flight, answers every queued request as failed
+    void Stop();
+
+    /*!
+     * \brief Requests a frame taken no earlier than this call and waits for it until \p deadline. Thread-safe, any
+     *        number of callers may wait at the same time.
+     * \param orphan Called on the scheduler thread with the capture if this request was answered late while the
+     *        capture was in flight and no request of its batch received it. May be empty.
+     */
+    TriggerOutcome Trigger(std::chrono::steady_clock::time_point deadline, Orphan orphan = Orphan());
+
+    TriggerSchedulerCounters Counters() const;
+    const TriggerSchedulerOptions& Options() const;
+
+    // E.g. "coalesced", as reported in the capture JSON
+    static const char* StatusName(TriggerStatus status);
+
+private:
+    struct Request
+    {
+        std::chrono::steady_clock::time_point arrival;
+        std::chrono::steady_clock::time_point deadline;
+        Orphan orphan;
+        bool done = false;
+        TriggerOutcome outcome;
+    };
+
+    struct Batch
+    {
+        std::chrono::steady_clock::time_point fired;
+        std::deque<std::shared_ptr<Request>> requests;
+    };
+
+    void run();
+
+    const TriggerSchedulerOptions m_options;
+    Capture m_capture;
+
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    // Wakes the scheduler thread for a new request or Stop()
+    std::condition_variable m_queueCondition;
+    // Wakes the callers once their batch is done
+    std::condition_variable m_doneCondition;
+    bool m_running = false;
+    std::deque<std::shared_ptr<Request>> m_queue;
+    // The capture in flight, null between captures
+    std::shared_ptr<Batch> m_current;
+    TriggerSchedulerCounters m_counters;
+};
+
+#endif // TRIGGERSCHEDULER_H
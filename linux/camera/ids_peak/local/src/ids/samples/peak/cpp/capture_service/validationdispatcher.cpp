@@ -0,0 +1,452 @@
+/*!
+ * \file    validationdispatcher.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ValidationDispatcher class posts captures to the validator
+ *          off the trigger path. Validations wait in a bounded queue that is
+ *          journaled to disk, so the ones still pending are sent after a
+ *          restart. One thread sends them over a kept connection and retries
+ *          with exponential backoff while the validator is unreachable or the
+ *          image is not on disk yet.
+ *
+ * \version 1.0.0
+ */
+
+#include "validationdispatcher.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+
+// The journal is one line per event: "+ <id>\t<image path>\t<barcode>" when a validation is queued,
+// "* <id>\t<barcode>" when a barcode is added later and "- <id>" once it is answered or given up. Whatever was
+// queued and never finished is pending.
+std::string queuedLine(uint64_t id, const ValidationRequest& request)
+{
+    return "+ " + std::to_string(id) + "\t" + request.imagePath + "\t" + request.barcode + "\n";
+}
+
+std::string barcodeLine(uint64_t id, const std::string& barcode)
+{
+    return "* " + std::to_string(id) + "\t" + barcode + "\n";
+}
+
+std::string finishedLine(uint64_t id)
+{
+    return "- " + std::to_string(id) + "\n";
+}
+
+// Fields are tab separated lines in the journal
+bool journalable(const std::string& text)
+{
+    return text.find_first_of("\t\r\n") == std::string::npos;
+}
+
+void writeAll(int fd, const std::string& text)
+{
+    size_t written = 0;
+    while (written < text.size())
+    {
+        const auto count = write(fd, text.data() + written, text.size() - written);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0)
+        {
+            throw std::runtime_error(std::string("Failed to write the validation journal: ") + std::strerror(errno));
+        }
+        written += static_cast<size_t>(count);
+    }
+}
+
+// 5xx, timeouts and rate limits are the validator's trouble, any other answer is final
+bool retryable(int status)
+{
+    return status >= 500 || status == 408 || status == 429;
+}
+
+} // namespace
+
+
+ValidationDispatcher::ValidationDispatcher(
+    ValidationDispatcherOptions options, HttpUrl url, HttpClient::Headers headers, Body body, Done done)
+    : m_options(std::move(options))
+    , m_client(std::move(url), m_options.timeout, true)
+    , m_headers(std::move(headers))
+    , m_body(std::move(body))
+    , m_done(std::move(done))
+{}
+
+ValidationDispatcher::~ValidationDispatcher()
+{
+    Stop();
+}
+
+void ValidationDispatcher::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_running)
+        {
+            return;
+        }
+    }
+
+    recover();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = true;
+    m_thread = std::thread(&ValidationDispatcher::run, this);
+}
+
+void ValidationDispatcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    if (m_journal >= 0)
+    {
+        close(m_journal);
+        m_journal = -1;
+    }
+}
+
+uint64_t ValidationDispatcher::Submit(ValidationRequest request)
+{
+    Pending pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running || m_queue.size() >= m_options.queueCapacity || !journalable(request.imagePath)
+            || !journalable(request.barcode))
+        {
+            m_counters.rejected++;
+            return 0;
+        }
+        pending.id = m_nextId++;
+    }
+    pending.request = std::move(request);
+    pending.submitted = std::chrono::steady_clock::now();
+    pending.due = pending.submitted;
+    if (pending.request.barcode.empty())
+    {
+        pending.due += m_options.holdBack;
+    }
+    const auto id = pending.id;
+
+    // Journaled before the sender can see it, so its "-" line never comes first
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    journal(queuedLine(pending.id, pending.request));
+    if (m_journal >= 0 && m_options.syncJournal)
+    {
+        fdatasync(m_journal);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(pending));
+        m_counters.submitted++;
+        m_counters.depth = m_queue.size();
+    }
+    m_condition.notify_one();
+    return id;
+}
+
+bool ValidationDispatcher::SetBarcode(uint64_t id, const std::string& barcode)
+{
+    if (barcode.empty() || !journalable(barcode))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto pending = std::find_if(
+            m_queue.begin(), m_queue.end(), [id](const Pending& pending) { return pending.id == id; });
+        // Not queued means in flight or done, the validator already has it without a barcode
+        if (pending == m_queue.end() || pending->attempts > 0 || !pending->request.barcode.empty())
+        {
+            return false;
+        }
+        pending->request.barcode = barcode;
+        pending->due = std::chrono::steady_clock::now();
+    }
+
+    // Without a sync, a crash before the send falls back to the validation without a barcode
+    journal(barcodeLine(id, barcode));
+    m_condition.notify_one();
+    return true;
+}
+
+ValidationDispatcherCounters ValidationDispatcher::Counters() const
+{
+    auto counters = [this] {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counters;
+    }();
+    counters.connections = m_client.Connections();
+    return counters;
+}
+
+const ValidationDispatcherOptions& ValidationDispatcher::Options() const
+{
+    return m_options;
+}
+
+void ValidationDispatcher::recover()
+{
+    if (m_options.journalPath.empty())
+    {
+        return;
+    }
+
+    // Ordered by id, so recovered validations are sent in the order they were taken
+    std::map<uint64_t, ValidationRequest> pending;
+    {
+        std::ifstream file(m_options.journalPath);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.size() < 3 || (line[0] != '+' && line[0] != '*' && line[0] != '-') || line[1] != ' ')
+            {
+                // A line torn by a crash is the last one, whatever it was about never became pending
+                continue;
+            }
+
+            std::istringstream fields(line.substr(2));
+            std::string id;
+            std::getline(fields, id, '\t');
+            if (id.empty() || id.find_first_not_of("0123456789") != std::string::npos)
+            {
+                continue;
+            }
+
+            if (line[0] == '-')
+            {
+                pending.erase(std::stoull(id));
+                continue;
+            }
+            if (line[0] == '*')
+            {
+                const auto request = pending.find(std::stoull(id));
+                if (request != pending.end())
+                {
+                    std::getline(fields, request->second.barcode);
+                }
+                continue;
+            }
+
+            ValidationRequest request;
+            std::getline(fields, request.imagePath, '\t');
+            std::getline(fields, request.barcode);
+            if (!request.imagePath.empty())
+            {
+                pending[std::stoull(id)] = std::move(request);
+            }
+        }
+    }
+
+    // Compacted to the pending validations under new ids, replacing the old journal in one rename
+    const auto compactedPath = m_options.journalPath + ".tmp";
+    const int compacted = open(compactedPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (compacted < 0)
+    {
+        throw std::runtime_error("Failed to open " + compactedPath + ": " + std::strerror(errno));
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::deque<Pending> recovered;
+    uint64_t id = 1;
+    try
+    {
+        std::string lines;
+        for (auto& entry : pending)
+        {
+            Pending item;
+            item.id = id++;
+            item.request = std::move(entry.second);
+            item.submitted = now;
+            item.due = now;
+            item.recovered = true;
+            lines += queuedLine(item.id, item.request);
+            recovered.push_back(std::move(item));
+        }
+        writeAll(compacted, lines);
+        fdatasync(compacted);
+    }
+    catch (const std::exception&)
+    {
+        close(compacted);
+        throw;
+    }
+    close(compacted);
+
+    if (rename(compactedPath.c_str(), m_options.journalPath.c_str()) < 0)
+    {
+        throw std::runtime_error("Failed to replace " + m_options.journalPath + ": " + std::strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    m_journal = open(m_options.journalPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (m_journal < 0)
+    {
+        throw std::runtime_error("Failed to open " + m_options.journalPath + ": " + std::strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // More than the capacity is fine here, journaled validations are never dropped
+    m_nextId = id;
+    m_counters.recovered += recovered.size();
+    m_counters.depth = recovered.size();
+    m_queue = std::move(recovered);
+}
+
+void ValidationDispatcher::journal(const std::string& line)
+{
+    if (m_journal < 0)
+    {
+        return;
+    }
+
+    try
+    {
+        writeAll(m_journal, line);
+    }
+    catch (const std::exception& e)
+    {
+        // The validation itself goes on, only a restart would forget it
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+    }
+}
+
+void ValidationDispatcher::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+        if (!m_running)
+        {
+            return;
+        }
+
+        // Retries wait for their backoff without holding up the validations behind them
+        const auto next = std::min_element(m_queue.begin(), m_queue.end(),
+            [](const Pending& a, const Pending& b) { return a.due < b.due; });
+        if (next->due > std::chrono::steady_clock::now())
+        {
+            m_condition.wait_until(lock, next->due);
+            continue;
+        }
+
+        auto pending = std::move(*next);
+        m_queue.erase(next);
+        m_counters.depth = m_queue.size();
+        lock.unlock();
+
+        pending.attempts++;
+        ValidationResult result;
+        result.request = pending.request;
+        result.attempts = pending.attempts;
+        bool retry = false;
+        if (access(pending.request.imagePath.c_str(), F_OK) != 0 && errno == ENOENT)
+        {
+            // Still in the write queue, the validator would not find it either
+            result.error = "Image not on disk yet: " + pending.request.imagePath;
+            retry = true;
+        }
+        else
+        {
+            try
+            {
+                const auto response = m_client.Post(m_headers, m_body(pending.request));
+                result.status = response.status;
+                result.body = response.body;
+                result.delivered = !retryable(response.status);
+                if (!result.delivered)
+                {
+                    result.error = "Validator answered " + std::to_string(response.status);
+                }
+                retry = !result.delivered;
+            }
+            catch (const std::exception& e)
+            {
+                result.error = e.what();
+                retry = true;
+            }
+        }
+
+        if (retry && pending.attempts < m_options.maxAttempts)
+        {
+            const auto shift = std::min<size_t>(pending.attempts - 1, 16);
+            const auto delay = std::min(m_options.retryDelay * (1 << shift), m_options.maxRetryDelay);
+            pending.due = std::chrono::steady_clock::now() + delay;
+
+            lock.lock();
+            m_counters.retries++;
+            m_queue.push_back(std::move(pending));
+            m_counters.depth = m_queue.size();
+            continue;
+        }
+
+        if (!pending.recovered)
+        {
+            result.latency_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pending.submitted)
+                    .count();
+        }
+        if (m_done)
+        {
+            m_done(result);
+        }
+
+        {
+            std::lock_guard<std::mutex> journalLock(m_journalMutex);
+            journal(finishedLine(pending.id));
+
+            // Nothing pending, the journal starts over instead of growing forever. Submit() journals under the same
+            // lock before queueing, so no queued line is lost.
+            std::lock_guard<std::mutex> queueLock(m_mutex);
+            if (result.delivered)
+            {
+                m_counters.delivered++;
+            }
+            else
+            {
+                m_counters.failed++;
+            }
+            if (m_queue.empty() && m_journal >= 0 && ftruncate(m_journal, 0) < 0)
+            {
+                std::cout << "EXCEPTION: Failed to truncate the validation journal: " << std::strerror(errno)
+                          << std::endl;
+            }
+        }
+
+        lock.lock();
+    }
+}
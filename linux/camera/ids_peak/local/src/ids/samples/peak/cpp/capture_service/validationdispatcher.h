@@ -0,0 +1,167 @@
+/*!
+ * \file    validationdispatcher.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ValidationDispatcher class posts captures to the validator
+ *          off the trigger path. Validations wait in a bounded queue that is
+ *          journaled to disk, so the ones still pending are sent after a
+ *          restart. One thread sends them over a kept connection and retries
+ *          with exponential backoff while the validator is unreachable or the
+ *          image is not on disk yet.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef VALIDATIONDISPATCHER_H
+#define VALIDATIONDISPATCHER_H
+
+#include "httpclient.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+struct ValidationDispatcherOptions
+{
+    // Validations waiting to be sent, Submit() rejects more
+    size_t queueCapacity = 256;
+    // Journal of the pending validations, empty keeps them in memory only
+    std::string journalPath;
+    // Syncs the journal before Submit() returns, so an accepted validation survives a power cut
+    bool syncJournal = true;
+    // Sends of one validation, including the first, before it is given up
+    size_t maxAttempts = 8;
+    // Wait before the first retry, doubled for every further one up to maxRetryDelay
+    std::chrono::milliseconds retryDelay{ 500 };
+    std::chrono::milliseconds maxRetryDelay{ 30000 };
+    // Bounds one request to the validator
+    std::chrono::milliseconds timeout{ 10000 };
+    // Wait before the first send of a validation without a barcode, so SetBarcode() can still add one
+    std::chrono::milliseconds holdBack{ 0 };
+};
+
+
+struct ValidationRequest
+{
+    std::string imagePath;
+    // Empty sends null
+    std::string barcode;
+};
+
+
+struct ValidationResult
+{
+    ValidationRequest request;
+    // The validator answered, see status and body. False if the validation was given up, see error.
+    bool delivered = false;
+    int status = 0;
+    std::string body;
+    std::string error;
+    size_t attempts = 0;
+    // Submit() until the answer, 0 for validations recovered from the journal
+    double latency_ms = 0.0;
+};
+
+
+/*!
+ * \brief Counters of a dispatcher. All values are totals since construction, except depth.
+ */
+struct ValidationDispatcherCounters
+{
+    uint64_t submitted = 0;
+    uint64_t delivered = 0;
+    uint64_t retries = 0;
+    // Given up after maxAttempts
+    uint64_t failed = 0;
+    // Not accepted because the queue was full or stopped
+    uint64_t rejected = 0;
+    // Read back from the journal on Start()
+    uint64_t recovered = 0;
+    uint64_t connections = 0;
+    size_t depth = 0;
+};
+
+
+class ValidationDispatcher
+{
+
+public:
+    // Builds the request body of a validation, e.g. the JSON of validate_image()
+    using Body = std::function<std::string(const ValidationRequest& request)>;
+    // Called on the dispatcher thread for every validation that was answered or given up
+    using Done = std::function<void(const ValidationResult& result)>;
+
+    ValidationDispatcher(ValidationDispatcherOptions options, HttpUrl url, HttpClient::Headers headers, Body body,
+        Done done);
+    ~ValidationDispatcher();
+
+    ValidationDispatcher(const ValidationDispatcher&) = delete;
+    ValidationDispatcher& operator=(const ValidationDispatcher&) = delete;
+
+    // Queues the validations left in the journal, then starts sending. Throws std::runtime_error if the journal
+    // can't be opened.
+    void Start();
+
+    // Finishes the request in flight, the validations still queued stay in the journal
+    void Stop();
+
+    /*!
+     * \brief Queues \p request and journals it without waiting for the validator. Returns its id, 0 if the queue is
+     *        full or not running, the validation is dropped then.
+     */
+    uint64_t Submit(ValidationRequest request);
+
+    /*!
+     * \brief Adds \p barcode to the validation \p id if it has none and was not sent yet, and sends it right away.
+     *        Returns false otherwise.
+     */
+    bool SetBarcode(uint64_t id, const std::string& barcode);
+
+    ValidationDispatcherCounters Counters() const;
+    const ValidationDispatcherOptions& Options() const;
+
+private:
+    struct Pending
+    {
+        uint64_t id = 0;
+        ValidationRequest request;
+        size_t attempts = 0;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point due;
+        bool recovered = false;
+    };
+
+    void run();
+    void recover();
+    void journal(const std::string& line);
+
+    const ValidationDispatcherOptions m_options;
+    HttpClient m_client;
+    const HttpClient::Headers m_headers;
+    Body m_body;
+    Done m_done;
+
+    std::thread m_thread;
+
+    // Appends of Submit() and the sender thread, -1 without a journal
+    std::mutex m_journalMutex;
+    int m_journal = -1;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = false;
+    std::deque<Pending> m_queue;
+    uint64_t m_nextId = 1;
+    ValidationDispatcherCounters m_counters;
+};
+
+#endif // VALIDATIONDISPATCHER_H
@@ -26,6 +26,7 @@
  */
 
 #include "acquisitionworker.h"
+#include "qimagelease.h"
 
 #include <QDebug>
 #include <cmath>
@@ -33,6 +34,8 @@
 #include <peak_ipl/peak_ipl.hpp>
 #include <peak/converters/peak_buffer_converter_ipl.hpp>
 
+const size_t AcquisitionWorker::DisplayImageCount;
+
 AcquisitionWorker::AcquisitionWorker(QObject* parent) : QObject(parent)
 {
     m_running = false;
@@ -57,6 +60,9 @@ void AcquisitionWorker::start()
         m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
         m_size = static_cast<const size_t>(m_imageWidth * m_imageHeight * m_bytesPerPixel);
 
+        // Allocate the display images once, the acquisition loop only recycles them
+        m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, m_imageWidth * m_imageHeight * 4);
+
         // Pre-allocate images for conversion that can be used simultaneously
         // This is not mandatory but it can increase the speed of image conversions
         size_t imageCount = 1;
@@ -98,7 +104,15 @@ void AcquisitionWorker::start()
                 chunkDataExposureTime_ms = round(chunkData) / 1000.0;
             }
 
-            QImage qImage(static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight), QImage::Format_RGB32);
+            // Take a display image from the pool. While the display still holds all of them the frame is not displayed,
+            // the buffer goes straight back to the camera.
+            auto qImage = ToQImage(m_imagePool->TryAcquire(), static_cast<int>(m_imageWidth),
+                static_cast<int>(m_imageHeight), static_cast<int>(m_imageWidth * 4), QImage::Format_RGB32);
+            if (qImage.isNull())
+            {
+                m_dataStream->QueueBuffer(buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to RGBa8 format
 
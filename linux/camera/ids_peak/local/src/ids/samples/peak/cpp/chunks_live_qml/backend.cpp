@@ -24,6 +24,8 @@
 #include "backend.h"
 #include <QDebug>
 
+#include <utility>
+
 #define VERSION "1.2.0"
 
 BackEnd::BackEnd(QObject* parent) : QObject(parent)
@@ -36,11 +38,13 @@ BackEnd::BackEnd(QObject* parent) : QObject(parent)
     connect(&m_acquisitionThread, &QThread::started, m_acquisitionWorker, &AcquisitionWorker::start);
     connect(&m_acquisitionThread, &QThread::finished, m_acquisitionWorker, &QObject::deleteLater);
 
-    // Connect the worker new image signal with the corresponding slot of the backend
-    connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, this, &BackEnd::imageReceived);
+    // Connect the worker new image signal with the mailbox of the backend. The image is handed over directly instead of
+    // queueing one event per frame, so a busy GUI thread skips to the newest image.
+    connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, this, &BackEnd::onImageReceived,
+        Qt::DirectConnection);
 
     // Connect the worker counter updated signal with with the corresponding slot of the backend
-    connect(m_acquisitionWorker, &AcquisitionWorker::counterChanged, this, &BackEnd::counterChanged);
+    connect(m_acquisitionWorker, &AcquisitionWorker::counterChanged, this, &BackEnd::onCounterChanged);
 
     // Connect the signal from the acquisition worker when an exception was thrown and a message should be printed
     // with the messagebox trigger slot in the BackEnd class
@@ -314,3 +318,30 @@ QString BackEnd::QtVersion() const
 {
     return qVersion();
 }
+
+void BackEnd::onImageReceived(QImage image, double chunkDataExposureTime_ms)
+{
+    DisplayFrame frame;
+    frame.image = std::move(image);
+    frame.chunkDataExposureTime_ms = chunkDataExposureTime_ms;
+
+    // Only the frame that fills the empty mailbox queues an event, later ones replace it until it is shown
+    if (m_mailbox.Post(std::move(frame)))
+    {
+        QMetaObject::invokeMethod(this, "deliverLatestImage", Qt::QueuedConnection);
+    }
+}
+
+void BackEnd::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter)
+{
+    emit counterChanged(frameCounter, errorCounter, static_cast<unsigned int>(m_mailbox.Counters().coalesced));
+}
+
+void BackEnd::deliverLatestImage()
+{
+    DisplayFrame frame;
+    if (m_mailbox.Take(frame))
+    {
+        emit imageReceived(frame.image, frame.chunkDataExposureTime_ms);
+    }
+}
@@ -31,6 +31,7 @@
 #include <cstdint>
 
 #include "acquisitionworker.h"
+#include "framemailbox.h"
 #include <peak/peak.hpp>
 
 class BackEnd : public QObject
@@ -59,9 +60,26 @@ private:
 
     QImage* m_image = new QImage;
 
+    // An image together with the chunk data shown next to it
+    struct DisplayFrame
+    {
+        QImage image;
+        double chunkDataExposureTime_ms = -1;
+    };
+
+    // Only the newest frame waits for the GUI thread, however long it is busy
+    FrameMailbox<DisplayFrame> m_mailbox;
+
+private slots:
+    // Called directly in the acquisition thread
+    void onImageReceived(QImage image, double chunkDataExposureTime_ms);
+    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    // Called in the GUI thread, passes the newest frame on to QML
+    void deliverLatestImage();
+
 signals:
     void imageReceived(QImage image, double chunkDataExposureTime_ms);
-    void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void counterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int coalescedCounter);
     void messageBoxTrigger(QString messageTitle, QString messageText, bool critical);
 };
 
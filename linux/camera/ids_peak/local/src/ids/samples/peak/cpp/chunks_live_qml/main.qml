@@ -28,7 +28,7 @@ Window {
             }
         }
         onCounterChanged: {
-            counterText.text = "Acquired: " + frameCounter + ", errors: " + errorCounter
+            counterText.text = "Acquired: " + frameCounter + ", errors: " + errorCounter + ", not displayed: " + coalescedCounter
         }
         onMessageBoxTrigger: {
             if(critical)
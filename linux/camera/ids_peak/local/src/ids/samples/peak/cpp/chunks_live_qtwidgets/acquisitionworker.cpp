@@ -26,19 +26,19 @@
  */
 
 #include "acquisitionworker.h"
+#include "qimagelease.h"
 
 #include <QDebug>
+#include <chrono>
 #include <cmath>
 
 #include <peak_ipl/peak_ipl.hpp>
 #include <peak/converters/peak_buffer_converter_ipl.hpp>
 
+const size_t AcquisitionWorker::DisplayImageCount;
+
 AcquisitionWorker::AcquisitionWorker(QObject* parent) : QObject(parent)
 {
-    m_running = false;
-    m_frameCounter = 0;
-    m_errorCounter = 0;
-
     // 1 byte for each channel of RGBa
     m_bytesPerPixel = 4;
 
@@ -57,6 +57,9 @@ void AcquisitionWorker::start()
         m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
         m_size = static_cast<const size_t>(m_imageWidth * m_imageHeight * m_bytesPerPixel);
 
+        // Allocate the display images once, the conversion loop only recycles them
+        m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, m_imageWidth * m_imageHeight * 4);
+
         // Pre-allocate images for conversion that can be used simultaneously
         // This is not mandatory but it can increase the speed of image conversions
         size_t imageCount = 1;
@@ -81,6 +84,9 @@ void AcquisitionWorker::start()
 
     m_running = true;
 
+    // Conversion runs in its own thread, so this loop only waits for buffers and hands them off
+    m_conversionThread = std::thread(&AcquisitionWorker::convertFrames, this);
+
     while (m_running)
     {
         try
@@ -88,33 +94,91 @@ void AcquisitionWorker::start()
             // Get buffer from device's datastream
             const auto buffer = m_dataStream->WaitForFinishedBuffer(5000);
 
-            double chunkDataExposureTime_ms = -1;
+            ChunkFrame chunkFrame;
+            chunkFrame.frame = Frame::FromBuffer(buffer);
+
+            // Chunk nodes belong to the remote nodemap, so they are read here before the buffer is handed off
             if (buffer->HasChunks() && m_enableChunks)
             {
                 m_nodemapRemoteDevice->UpdateChunkNodes(buffer);
 
                 // Get the value of the exposure time chunk
                 const auto chunkData = m_nodemapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("ChunkExposureTime")->Value();
-                chunkDataExposureTime_ms = round(chunkData) / 1000.0;
+                chunkFrame.chunkDataExposureTime_ms = round(chunkData) / 1000.0;
             }
 
-            QImage qImage(static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight), QImage::Format_RGB32);
+            if (!m_frameRing.TryPush(std::move(chunkFrame)))
+            {
+                // The conversion thread is behind. Requeue the buffer right away instead of starving the camera,
+                // the frame is counted as dropped by the ring.
+                m_dataStream->QueueBuffer(buffer);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            m_errorCounter++;
+
+            qDebug() << "Exception: " << e.what();
+            emit messageBoxTrigger("Exception", e.what());
+
+            // Send signal with current frame and error counter
+            emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
+        }
+    }
+
+    m_frameRing.WakeConsumer();
+    m_conversionThread.join();
+
+    // Frames the conversion thread did not get to go back to the data stream, so the next Start() has every buffer
+    m_frameRing.Drain([this](ChunkFrame& chunkFrame) {
+        try
+        {
+            m_dataStream->QueueBuffer(chunkFrame.frame.buffer);
+        }
+        catch (const std::exception& e)
+        {
+            qDebug() << "Exception: " << e.what();
+        }
+    });
+}
+
+void AcquisitionWorker::convertFrames()
+{
+    while (m_running)
+    {
+        ChunkFrame chunkFrame;
+        if (!m_frameRing.Pop(chunkFrame, std::chrono::milliseconds(100)))
+        {
+            continue;
+        }
+
+        try
+        {
+            // Take a display image from the pool. While the display still holds all of them this thread waits and the
+            // frame ring absorbs, and eventually drops, the frames in the meantime.
+            auto qImage = ToQImage(m_imagePool->Acquire(std::chrono::milliseconds(100)), static_cast<int>(m_imageWidth),
+                static_cast<int>(m_imageHeight), static_cast<int>(m_imageWidth * 4), QImage::Format_RGB32);
+            if (qImage.isNull())
+            {
+                m_dataStream->QueueBuffer(chunkFrame.frame.buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to RGBa8 format
 
             // Using the image converter ...
-            m_imageConverter->Convert(peak::BufferTo<peak::ipl::Image>(buffer),
+            m_imageConverter->Convert(peak::BufferTo<peak::ipl::Image>(chunkFrame.frame.buffer),
                 peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
 
             // ... or without image converter
-            // peak::BufferTo<peak::ipl::Image>(buffer).ConvertTo(
+            // peak::BufferTo<peak::ipl::Image>(chunkFrame.frame.buffer).ConvertTo(
             //     peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
-            
+
             // Queue buffer so that it can be used again
-            m_dataStream->QueueBuffer(buffer);
+            m_dataStream->QueueBuffer(chunkFrame.frame.buffer);
 
             // Emit signal that the image is ready to be displayed
-            emit imageReceived(qImage, chunkDataExposureTime_ms);
+            emit imageReceived(qImage, chunkFrame.chunkDataExposureTime_ms);
 
             m_frameCounter++;
         }
@@ -126,8 +190,8 @@ void AcquisitionWorker::start()
             emit messageBoxTrigger("Exception", e.what());
         }
 
-        // Send signal with current frame and error counter
-        emit counterChanged(m_frameCounter, m_errorCounter);
+        // Send signal with current frame, error and dropped counter
+        emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
     }
 }
 
@@ -35,6 +35,21 @@
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
 
+#include "framering.h"
+#include "imagepool.h"
+
+#include <atomic>
+#include <thread>
+
+/*!
+ * \brief A frame in the hand-off ring, with the chunk data that has to be read in the acquisition thread.
+ */
+struct ChunkFrame
+{
+    Frame frame;
+    double chunkDataExposureTime_ms = -1;
+};
+
 class AcquisitionWorker : public QObject
 {
     Q_OBJECT
@@ -53,15 +68,24 @@ public:
 
     void setEnableChunks(bool enable);
 
+    // Number of finished buffers that may wait for conversion. These buffers are announced in addition to
+    // NumBuffersAnnouncedMinRequired(), so the camera is not starved while frames wait in the ring.
+    static const size_t FrameRingCapacity = 4;
+
+    // Number of display images: one being converted, one queued for the display, one shown and one spare
+    static const size_t DisplayImageCount = 4;
+
 private:
+    void convertFrames();
+
     std::shared_ptr<peak::core::DataStream> m_dataStream;
     std::shared_ptr<peak::core::NodeMap> m_nodemapRemoteDevice;
 
-    bool m_running = false;
+    std::atomic<bool> m_running{ false };
     bool m_enableChunks = true;
 
-    unsigned int m_frameCounter = 0;
-    unsigned int m_errorCounter = 0;
+    std::atomic<unsigned int> m_frameCounter{ 0 };
+    std::atomic<unsigned int> m_errorCounter{ 0 };
 
     size_t m_imageWidth = 0;
     size_t m_imageHeight = 0;
@@ -70,9 +94,16 @@ private:
 
     std::unique_ptr<peak::ipl::ImageConverter> m_imageConverter;
 
+    // Hands finished buffers from the acquisition loop to the conversion thread
+    FrameRing<ChunkFrame> m_frameRing{ FrameRingCapacity };
+    std::thread m_conversionThread;
+
+    // Display images, recycled once the display has released them
+    std::unique_ptr<ImagePool> m_imagePool;
+
 signals:
     void imageReceived(QImage image, double chunkDataExposureTime_ms);
-    void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void counterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void messageBoxTrigger(QString messageTitle, QString messageText);
 };
 
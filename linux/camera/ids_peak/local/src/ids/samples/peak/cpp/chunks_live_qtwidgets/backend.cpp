@@ -222,8 +222,8 @@ bool BackEnd::openDevice()
             // Get the payload size for correct buffer allocation
             const auto payloadSize = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")->Value();
 
-            // Get the minimum number of buffers that must be announced
-            const auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired();
+            // Get the minimum number of buffers that must be announced, plus the buffers that may wait for conversion
+            const auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired() + AcquisitionWorker::FrameRingCapacity;
 
             // Allocate and announce image buffers and queue them
             for (size_t bufferCount = 0; bufferCount < bufferCountMax; ++bufferCount)
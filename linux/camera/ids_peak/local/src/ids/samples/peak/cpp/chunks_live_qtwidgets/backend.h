@@ -59,7 +59,7 @@ private:
 
 signals:
     void imageReceived(QImage image, double chunkDataExposureTime_ms);
-    void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void counterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void messageBoxTrigger(QString messageTitle, QString messageText);
 };
 
@@ -118,10 +118,10 @@ void MainWindow::createStatusBar()
     m_layout->addWidget(statusBar);
 }
 
-void MainWindow::updateCounters(unsigned int frameCounter, unsigned int errorCounter)
+void MainWindow::updateCounters(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter)
 {
-    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2")
-            .arg(QString::number(frameCounter), QString::number(errorCounter)));
+    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2, dropped: %3")
+            .arg(QString::number(frameCounter), QString::number(errorCounter), QString::number(droppedCounter)));
 }
 
 void MainWindow::on_aboutQt_linkActivated(const QString& link)
@@ -54,7 +54,7 @@ private:
     void createStatusBar();
 
 private slots:
-    void updateCounters(unsigned int frameCounter, unsigned int errorCounter);
+    void updateCounters(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void on_aboutQt_linkActivated(const QString& link);
     void showMessageBox(QString messageTitle, QString messageText);
 };
@@ -0,0 +1,1488 @@
+/*!
+ * \file    barcodedecoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeDecoder class reads Code 128 and EAN-13/EAN-8
+ *          barcodes and QR Code and Data Matrix symbols from a Mono8 image,
+ *          e.g. the sample label in a captured frame. Tiles with strongly
+ *          directional gradients are grouped into candidate regions, which
+ *          are read along scan lines across their bars. For the matrix codes
+ *          the image is binarized with a threshold per tile and passed to
+ *          MatrixCodeDecoder. The gradient, statistics and binarization
+ *          kernels exist for AVX2, SSE4.1 and plain C++, the fastest one
+ *          supported by the CPU is selected at runtime.
+ *
+ * \version 1.0.0
+ */
+
+#include "barcodedecoder.h"
+#include "matrixcodedecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define BARCODE_X86
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+// MSVC emits any intrinsic without per-function target flags
+#        define BARCODE_TARGET(isa)
+#    else
+#        define BARCODE_TARGET(isa) __attribute__((target(isa)))
+#    endif
+#endif
+
+
+namespace
+{
+
+// Sums of the absolute differences between every pixel and its right, lower right, lower and lower left neighbour
+// for one row of tiles, four per tile at 0, 45, 90 and 135 degrees. The row and the column after the tiles must exist,
+// the lower left difference of a pixel is taken between its lower and its right neighbour.
+using TileRowFunction = void (*)(const uint8_t* row, size_t stride, size_t tileCount, uint32_t* sums);
+// Darkest and brightest pixel of a line
+using RangeFunction = void (*)(const uint8_t* line, size_t length, uint8_t& darkest, uint8_t& brightest);
+// Sets bit i of \p dark for every pixel at or below \p threshold. \p dark holds (length + 63) / 64 words.
+using ThresholdFunction = void (*)(const uint8_t* line, size_t length, uint8_t threshold, uint64_t* dark);
+// Darkest and brightest pixel and the sum of all pixels of each tile of one row of tiles
+using TileStatsFunction = void (*)(
+    const uint8_t* row, size_t stride, size_t tileCount, uint8_t* darkest, uint8_t* brightest, uint32_t* sums);
+// Like ThresholdFunction, with threshold x / TileSize for pixel x
+using TileThresholdFunction = void (*)(const uint8_t* line, size_t length, const uint8_t* thresholds, uint64_t* dark);
+
+struct Kernels
+{
+    TileRowFunction tileRow;
+    RangeFunction range;
+    ThresholdFunction threshold;
+    TileStatsFunction tileStats;
+    TileThresholdFunction tileThreshold;
+};
+
+inline uint32_t absoluteDifference(uint8_t a, uint8_t b)
+{
+    return a > b ? static_cast<uint32_t>(a - b) : static_cast<uint32_t>(b - a);
+}
+
+void tileRangeScalar(const uint8_t* row, size_t stride, size_t begin, size_t end, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+
+    for (size_t tile = begin; tile < end; ++tile)
+    {
+        uint32_t tileSums[4] = {};
+        for (size_t y = 0; y < size; ++y)
+        {
+            const auto* above = row + y * stride + tile * size;
+            const auto* below = above + stride;
+            for (size_t x = 0; x < size; ++x)
+            {
+                tileSums[0] += absoluteDifference(above[x + 1], above[x]);
+                tileSums[1] += absoluteDifference(below[x + 1], above[x]);
+                tileSums[2] += absoluteDifference(below[x], above[x]);
+                tileSums[3] += absoluteDifference(below[x], above[x + 1]);
+            }
+        }
+        std::copy(tileSums, tileSums + 4, sums + 4 * tile);
+    }
+}
+
+void tileRowScalar(const uint8_t* row, size_t stride, size_t tileCount, uint32_t* sums)
+{
+    tileRangeScalar(row, stride, 0, tileCount, sums);
+}
+
+void rangeScalar(const uint8_t* line, size_t length, uint8_t& darkest, uint8_t& brightest)
+{
+    const auto range = std::minmax_element(line, line + length);
+    darkest = *range.first;
+    brightest = *range.second;
+}
+
+void thresholdRangeScalar(const uint8_t* line, size_t begin, size_t end, uint8_t threshold, uint64_t* dark)
+{
+    for (size_t x = begin; x < end; ++x)
+    {
+        if (line[x] <= threshold)
+        {
+            dark[x / 64] |= uint64_t{ 1 } << (x % 64);
+        }
+    }
+}
+
+void thresholdScalar(const uint8_t* line, size_t length, uint8_t threshold, uint64_t* dark)
+{
+    std::fill(dark, dark + (length + 63) / 64, 0);
+    thresholdRangeScalar(line, 0, length, threshold, dark);
+}
+
+// Statistics of any rectangle, for the tiles cut off at the right and bottom edge as well
+void rectangleStatsScalar(const uint8_t* origin, size_t stride, size_t width, size_t height, uint8_t& darkest,
+    uint8_t& brightest, uint32_t& sum)
+{
+    darkest = 255;
+    brightest = 0;
+    sum = 0;
+    for (size_t y = 0; y < height; ++y)
+    {
+        const auto* row = origin + y * stride;
+        for (size_t x = 0; x < width; ++x)
+        {
+            darkest = std::min(darkest, row[x]);
+            brightest = std::max(brightest, row[x]);
+            sum += row[x];
+        }
+    }
+}
+
+void tileStatsScalar(
+    const uint8_t* row, size_t stride, size_t tileCount, uint8_t* darkest, uint8_t* brightest, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+
+    for (size_t tile = 0; tile < tileCount; ++tile)
+    {
+        rectangleStatsScalar(row + tile * size, stride, size, size, darkest[tile], brightest[tile], sums[tile]);
+    }
+}
+
+void tileThresholdRangeScalar(const uint8_t* line, size_t begin, size_t end, const uint8_t* thresholds, uint64_t* dark)
+{
+    for (size_t x = begin; x < end; ++x)
+    {
+        if (line[x] <= thresholds[x / BarcodeDecoder::TileSize])
+        {
+            dark[x / 64] |= uint64_t{ 1 } << (x % 64);
+        }
+    }
+}
+
+void tileThresholdScalar(const uint8_t* line, size_t length, const uint8_t* thresholds, uint64_t* dark)
+{
+    std::fill(dark, dark + (length + 63) / 64, 0);
+    tileThresholdRangeScalar(line, 0, length, thresholds, dark);
+}
+
+#ifdef BARCODE_X86
+
+BARCODE_TARGET("sse4.1")
+inline __m128i absoluteDifferenceSse41(__m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+// psadbw against zero sums 8 absolute differences into each 64 bit half of the accumulator
+BARCODE_TARGET("sse4.1")
+void tileRowSse41(const uint8_t* row, size_t stride, size_t tileCount, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    const auto zero = _mm_setzero_si128();
+
+    for (size_t tile = 0; tile < tileCount; ++tile)
+    {
+        __m128i tileSums[4] = { zero, zero, zero, zero };
+        for (size_t y = 0; y < size; ++y)
+        {
+            const auto* above = row + y * stride + tile * size;
+            const auto* below = above + stride;
+            const auto pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above));
+            const auto right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + 1));
+            const auto lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below));
+            const auto lowerRight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + 1));
+
+            tileSums[0] = _mm_add_epi64(tileSums[0], _mm_sad_epu8(absoluteDifferenceSse41(right, pixel), zero));
+            tileSums[1] = _mm_add_epi64(tileSums[1], _mm_sad_epu8(absoluteDifferenceSse41(lowerRight, pixel), zero));
+            tileSums[2] = _mm_add_epi64(tileSums[2], _mm_sad_epu8(absoluteDifferenceSse41(lower, pixel), zero));
+            tileSums[3] = _mm_add_epi64(tileSums[3], _mm_sad_epu8(absoluteDifferenceSse41(lower, right), zero));
+        }
+        for (size_t direction = 0; direction < 4; ++direction)
+        {
+            sums[4 * tile + direction] = static_cast<uint32_t>(
+                _mm_cvtsi128_si32(tileSums[direction]) + _mm_extract_epi32(tileSums[direction], 2));
+        }
+    }
+}
+
+BARCODE_TARGET("sse4.1")
+void rangeSse41(const uint8_t* line, size_t length, uint8_t& darkest, uint8_t& brightest)
+{
+    constexpr size_t lanes = 16;
+    if (length < lanes)
+    {
+        rangeScalar(line, length, darkest, brightest);
+        return;
+    }
+
+    auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line));
+    auto high = low;
+    size_t x = lanes;
+    for (; x + lanes <= length; x += lanes)
+    {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        low = _mm_min_epu8(low, pixels);
+        high = _mm_max_epu8(high, pixels);
+    }
+    // The last, overlapping block covers the tail
+    const auto tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + length - lanes));
+    low = _mm_min_epu8(low, tail);
+    high = _mm_max_epu8(high, tail);
+
+    // phminposuw finds the minimum of 16 bit lanes, so the bytes are widened and the maximum is found as the
+    // minimum of the inverted values
+    const auto ones = _mm_set1_epi8(static_cast<char>(0xFF));
+    low = _mm_min_epu8(low, _mm_srli_si128(low, 8));
+    high = _mm_xor_si128(_mm_max_epu8(high, _mm_srli_si128(high, 8)), ones);
+    darkest = static_cast<uint8_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_cvtepu8_epi16(low))));
+    brightest = static_cast<uint8_t>(~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_cvtepu8_epi16(high))));
+}
+
+BARCODE_TARGET("sse4.1")
+void thresholdSse41(const uint8_t* line, size_t length, uint8_t threshold, uint64_t* dark)
+{
+    constexpr size_t lanes = 16;
+    std::fill(dark, dark + (length + 63) / 64, 0);
+
+    // a <= t exactly when max(a, t) == t, which avoids a signed compare of unsigned bytes
+    const auto limit = _mm_set1_epi8(static_cast<char>(threshold));
+    size_t x = 0;
+    for (; x + lanes <= length; x += lanes)
+    {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(pixels, limit), limit));
+        dark[x / 64] |= static_cast<uint64_t>(static_cast<uint32_t>(mask)) << (x % 64);
+    }
+
+    thresholdRangeScalar(line, x, length, threshold, dark);
+}
+
+// Darkest and brightest of 16 bytes, with the same phminposuw reduction as rangeSse41
+BARCODE_TARGET("sse4.1")
+inline void reduceRangeSse41(__m128i low, __m128i high, uint8_t& darkest, uint8_t& brightest)
+{
+    const auto ones = _mm_set1_epi8(static_cast<char>(0xFF));
+    low = _mm_min_epu8(low, _mm_srli_si128(low, 8));
+    high = _mm_xor_si128(_mm_max_epu8(high, _mm_srli_si128(high, 8)), ones);
+    darkest = static_cast<uint8_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_cvtepu8_epi16(low))));
+    brightest = static_cast<uint8_t>(~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_cvtepu8_epi16(high))));
+}
+
+// One tile row of 16 bytes per register, psadbw against zero sums the pixels
+BARCODE_TARGET("sse4.1")
+void tileStatsSse41(
+    const uint8_t* row, size_t stride, size_t tileCount, uint8_t* darkest, uint8_t* brightest, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    const auto zero = _mm_setzero_si128();
+
+    for (size_t tile = 0; tile < tileCount; ++tile)
+    {
+        const auto* origin = row + tile * size;
+        auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origin));
+        auto high = low;
+        auto sum = _mm_sad_epu8(low, zero);
+        for (size_t y = 1; y < size; ++y)
+        {
+            const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(origin + y * stride));
+            low = _mm_min_epu8(low, pixels);
+            high = _mm_max_epu8(high, pixels);
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(pixels, zero));
+        }
+        reduceRangeSse41(low, high, darkest[tile], brightest[tile]);
+        sums[tile] = static_cast<uint32_t>(_mm_cvtsi128_si32(sum) + _mm_extract_epi32(sum, 2));
+    }
+}
+
+BARCODE_TARGET("sse4.1")
+void tileThresholdSse41(const uint8_t* line, size_t length, const uint8_t* thresholds, uint64_t* dark)
+{
+    constexpr size_t lanes = 16;
+    static_assert(lanes == BarcodeDecoder::TileSize, "one register per tile");
+    std::fill(dark, dark + (length + 63) / 64, 0);
+
+    size_t x = 0;
+    for (; x + lanes <= length; x += lanes)
+    {
+        const auto limit = _mm_set1_epi8(static_cast<char>(thresholds[x / lanes]));
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(pixels, limit), limit));
+        dark[x / 64] |= static_cast<uint64_t>(static_cast<uint32_t>(mask)) << (x % 64);
+    }
+
+    tileThresholdRangeScalar(line, x, length, thresholds, dark);
+}
+
+BARCODE_TARGET("avx2")
+inline __m256i absoluteDifferenceAvx2(__m256i a, __m256i b)
+{
+    return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+// Two tiles per iteration, psadbw leaves the sums of the first tile in the lower and of the second in the upper lane
+BARCODE_TARGET("avx2")
+void tileRowAvx2(const uint8_t* row, size_t stride, size_t tileCount, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    const auto zero = _mm256_setzero_si256();
+
+    size_t tile = 0;
+    for (; tile + 2 <= tileCount; tile += 2)
+    {
+        __m256i tileSums[4] = { zero, zero, zero, zero };
+        for (size_t y = 0; y < size; ++y)
+        {
+            const auto* above = row + y * stride + tile * size;
+            const auto* below = above + stride;
+            const auto pixel = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above));
+            const auto right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + 1));
+            const auto lower = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below));
+            const auto lowerRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + 1));
+
+            const __m256i differences[4] = { absoluteDifferenceAvx2(right, pixel),
+                absoluteDifferenceAvx2(lowerRight, pixel), absoluteDifferenceAvx2(lower, pixel),
+                absoluteDifferenceAvx2(lower, right) };
+            for (size_t direction = 0; direction < 4; ++direction)
+            {
+                tileSums[direction] =
+                    _mm256_add_epi64(tileSums[direction], _mm256_sad_epu8(differences[direction], zero));
+            }
+        }
+        for (size_t direction = 0; direction < 4; ++direction)
+        {
+            const auto& sum = tileSums[direction];
+            sums[4 * tile + direction] =
+                static_cast<uint32_t>(_mm256_extract_epi32(sum, 0) + _mm256_extract_epi32(sum, 2));
+            sums[4 * (tile + 1) + direction] =
+                static_cast<uint32_t>(_mm256_extract_epi32(sum, 4) + _mm256_extract_epi32(sum, 6));
+        }
+    }
+
+    if (tile < tileCount)
+    {
+        tileRowSse41(row + tile * size, stride, tileCount - tile, sums + 4 * tile);
+    }
+}
+
+BARCODE_TARGET("avx2")
+void thresholdAvx2(const uint8_t* line, size_t length, uint8_t threshold, uint64_t* dark)
+{
+    constexpr size_t lanes = 32;
+    std::fill(dark, dark + (length + 63) / 64, 0);
+
+    const auto limit = _mm256_set1_epi8(static_cast<char>(threshold));
+    size_t x = 0;
+    for (; x + lanes <= length; x += lanes)
+    {
+        const auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + x));
+        const auto mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(pixels, limit), limit));
+        dark[x / 64] |= static_cast<uint64_t>(static_cast<uint32_t>(mask)) << (x % 64);
+    }
+
+    thresholdRangeScalar(line, x, length, threshold, dark);
+}
+
+// Two tiles per iteration like tileRowAvx2, each 128 bit lane holds one
+BARCODE_TARGET("avx2")
+void tileStatsAvx2(
+    const uint8_t* row, size_t stride, size_t tileCount, uint8_t* darkest, uint8_t* brightest, uint32_t* sums)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    const auto zero = _mm256_setzero_si256();
+
+    size_t tile = 0;
+    for (; tile + 2 <= tileCount; tile += 2)
+    {
+        const auto* origin = row + tile * size;
+        auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(origin));
+        auto high = low;
+        auto sum = _mm256_sad_epu8(low, zero);
+        for (size_t y = 1; y < size; ++y)
+        {
+            const auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(origin + y * stride));
+            low = _mm256_min_epu8(low, pixels);
+            high = _mm256_max_epu8(high, pixels);
+            sum = _mm256_add_epi64(sum, _mm256_sad_epu8(pixels, zero));
+        }
+        reduceRangeSse41(_mm256_castsi256_si128(low), _mm256_castsi256_si128(high), darkest[tile], brightest[tile]);
+        reduceRangeSse41(_mm256_extracti128_si256(low, 1), _mm256_extracti128_si256(high, 1), darkest[tile + 1],
+            brightest[tile + 1]);
+        sums[tile] = static_cast<uint32_t>(_mm256_extract_epi32(sum, 0) + _mm256_extract_epi32(sum, 2));
+        sums[tile + 1] = static_cast<uint32_t>(_mm256_extract_epi32(sum, 4) + _mm256_extract_epi32(sum, 6));
+    }
+
+    if (tile < tileCount)
+    {
+        tileStatsSse41(row + tile * size, stride, tileCount - tile, darkest + tile, brightest + tile, sums + tile);
+    }
+}
+
+// Two tiles per register, each 128 bit lane compares against the threshold of its tile
+BARCODE_TARGET("avx2")
+void tileThresholdAvx2(const uint8_t* line, size_t length, const uint8_t* thresholds, uint64_t* dark)
+{
+    constexpr size_t lanes = 32;
+    const auto size = BarcodeDecoder::TileSize;
+    std::fill(dark, dark + (length + 63) / 64, 0);
+
+    size_t x = 0;
+    for (; x + lanes <= length; x += lanes)
+    {
+        const auto limit = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_set1_epi8(static_cast<char>(thresholds[x / size]))),
+            _mm_set1_epi8(static_cast<char>(thresholds[x / size + 1])), 1);
+        const auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + x));
+        const auto mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(pixels, limit), limit));
+        dark[x / 64] |= static_cast<uint64_t>(static_cast<uint32_t>(mask)) << (x % 64);
+    }
+    if (x + size <= length)
+    {
+        const auto limit = _mm_set1_epi8(static_cast<char>(thresholds[x / size]));
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(pixels, limit), limit));
+        dark[x / 64] |= static_cast<uint64_t>(static_cast<uint32_t>(mask)) << (x % 64);
+        x += size;
+    }
+
+    tileThresholdRangeScalar(line, x, length, thresholds, dark);
+}
+
+bool cpuSupports(BarcodeDecoder::Isa isa)
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    __cpuidex(info, 7, 0);
+    const bool avx2Instructions = (info[1] & (1 << 5)) != 0;
+    // The OS must save the YMM registers on context switches
+    const bool avx2 = avx2Instructions && avx && osxsave && ((_xgetbv(0) & 0x6) == 0x6);
+#    else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#    endif
+
+    switch (isa)
+    {
+    case BarcodeDecoder::Isa::Scalar:
+        return true;
+    case BarcodeDecoder::Isa::SSE41:
+        return sse41;
+    case BarcodeDecoder::Isa::AVX2:
+        return avx2 && sse41;
+    }
+    return false;
+}
+
+#else
+
+bool cpuSupports(BarcodeDecoder::Isa isa)
+{
+    return isa == BarcodeDecoder::Isa::Scalar;
+}
+
+#endif // BARCODE_X86
+
+Kernels kernels(BarcodeDecoder::Isa isa)
+{
+#ifdef BARCODE_X86
+    switch (isa)
+    {
+    case BarcodeDecoder::Isa::AVX2:
+        // A scan line is too short for a 32 byte min/max to pay off
+        return { tileRowAvx2, rangeSse41, thresholdAvx2, tileStatsAvx2, tileThresholdAvx2 };
+    case BarcodeDecoder::Isa::SSE41:
+        return { tileRowSse41, rangeSse41, thresholdSse41, tileStatsSse41, tileThresholdSse41 };
+    case BarcodeDecoder::Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    return { tileRowScalar, rangeScalar, thresholdScalar, tileStatsScalar, tileThresholdScalar };
+}
+
+
+// Widths of the elements of a scan line in pixels. Even indices are light, odd ones dark, so a line that starts dark
+// starts with an empty light element.
+using Runs = std::vector<float>;
+
+// Quiet zone before and after a symbol in modules. The standards ask for 10 (Code 128) and 7 (EAN), printed labels
+// are often tighter.
+const float minQuietModules = 5.0f;
+
+const float noMatch = std::numeric_limits<float>::max();
+
+/*!
+ * Mean deviation of \p count elements from \p pattern in modules, scaled to the width of the elements. noMatch if a
+ * single element is off by more than \p maxElementVariance modules.
+ */
+float patternVariance(const float* runs, const uint8_t* pattern, size_t count, float maxElementVariance)
+{
+    float total = 0.0f;
+    unsigned modules = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += runs[i];
+        modules += pattern[i];
+    }
+    if (total <= 0.0f)
+    {
+        return noMatch;
+    }
+
+    const auto unit = total / static_cast<float>(modules);
+    float variance = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto deviation = std::abs(runs[i] - static_cast<float>(pattern[i]) * unit) / unit;
+        if (deviation > maxElementVariance)
+        {
+            return noMatch;
+        }
+        variance += deviation;
+    }
+    return variance / static_cast<float>(modules);
+}
+
+float sum(const float* runs, size_t count)
+{
+    float total = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += runs[i];
+    }
+    return total;
+}
+
+
+// Bar and space widths of the Code 128 symbols in modules, the stop pattern last
+const uint8_t code128Patterns[107][7] = {
+    { 2, 1, 2, 2, 2, 2 }, { 2, 2, 2, 1, 2, 2 }, { 2, 2, 2, 2, 2, 1 }, { 1, 2, 1, 2, 2, 3 }, { 1, 2, 1, 3, 2, 2 },
+    { 1, 3, 1, 2, 2, 2 }, { 1, 2, 2, 2, 1, 3 }, { 1, 2, 2, 3, 1, 2 }, { 1, 3, 2, 2, 1, 2 }, { 2, 2, 1, 2, 1, 3 },
+    { 2, 2, 1, 3, 1, 2 }, { 2, 3, 1, 2, 1, 2 }, { 1, 1, 2, 2, 3, 2 }, { 1, 2, 2, 1, 3, 2 }, { 1, 2, 2, 2, 3, 1 },
+    { 1, 1, 3, 2, 2, 2 }, { 1, 2, 3, 1, 2, 2 }, { 1, 2, 3, 2, 2, 1 }, { 2, 2, 3, 2, 1, 1 }, { 2, 2, 1, 1, 3, 2 },
+    { 2, 2, 1, 2, 3, 1 }, { 2, 1, 3, 2, 1, 2 }, { 2, 2, 3, 1, 1, 2 }, { 3, 1, 2, 1, 3, 1 }, { 3, 1, 1, 2, 2, 2 },
+    { 3, 2, 1, 1, 2, 2 }, { 3, 2, 1, 2, 2, 1 }, { 3, 1, 2, 2, 1, 2 }, { 3, 2, 2, 1, 1, 2 }, { 3, 2, 2, 2, 1, 1 },
+    { 2, 1, 2, 1, 2, 3 }, { 2, 1, 2, 3, 2, 1 }, { 2, 3, 2, 1, 2, 1 }, { 1, 1, 1, 3, 2, 3 }, { 1, 3, 1, 1, 2, 3 },
+    { 1, 3, 1, 3, 2, 1 }, { 1, 1, 2, 3, 1, 3 }, { 1, 3, 2, 1, 1, 3 }, { 1, 3, 2, 3, 1, 1 }, { 2, 1, 1, 3, 1, 3 },
+    { 2, 3, 1, 1, 1, 3 }, { 2, 3, 1, 3, 1, 1 }, { 1, 1, 2, 1, 3, 3 }, { 1, 1, 2, 3, 3, 1 }, { 1, 3, 2, 1, 3, 1 },
+    { 1, 1, 3, 1, 2, 3 }, { 1, 1, 3, 3, 2, 1 }, { 1, 3, 3, 1, 2, 1 }, { 3, 1, 3, 1, 2, 1 }, { 2, 1, 1, 3, 3, 1 },
+    { 2, 3, 1, 1, 3, 1 }, { 2, 1, 3, 1, 1, 3 }, { 2, 1, 3, 3, 1, 1 }, { 2, 1, 3, 1, 3, 1 }, { 3, 1, 1, 1, 2, 3 },
+    { 3, 1, 1, 3, 2, 1 }, { 3, 3, 1, 1, 2, 1 }, { 3, 1, 2, 1, 1, 3 }, { 3, 1, 2, 3, 1, 1 }, { 3, 3, 2, 1, 1, 1 },
+    { 3, 1, 4, 1, 1, 1 }, { 2, 2, 1, 4, 1, 1 }, { 4, 3, 1, 1, 1, 1 }, { 1, 1, 1, 2, 2, 4 }, { 1, 1, 1, 4, 2, 2 },
+    { 1, 2, 1, 1, 2, 4 }, { 1, 2, 1, 4, 2, 1 }, { 1, 4, 1, 1, 2, 2 }, { 1, 4, 1, 2, 2, 1 }, { 1, 1, 2, 2, 1, 4 },
+    { 1, 1, 2, 4, 1, 2 }, { 1, 2, 2, 1, 1, 4 }, { 1, 2, 2, 4, 1, 1 }, { 1, 4, 2, 1, 1, 2 }, { 1, 4, 2, 2, 1, 1 },
+    { 2, 4, 1, 2, 1, 1 }, { 2, 2, 1, 1, 1, 4 }, { 4, 1, 3, 1, 1, 1 }, { 2, 4, 1, 1, 1, 2 }, { 1, 3, 4, 1, 1, 1 },
+    { 1, 1, 1, 2, 4, 2 }, { 1, 2, 1, 1, 4, 2 }, { 1, 2, 1, 2, 4, 1 }, { 1, 1, 4, 2, 1, 2 }, { 1, 2, 4, 1, 1, 2 },
+    { 1, 2, 4, 2, 1, 1 }, { 4, 1, 1, 2, 1, 2 }, { 4, 2, 1, 1, 1, 2 }, { 4, 2, 1, 2, 1, 1 }, { 2, 1, 2, 1, 4, 1 },
+    { 2, 1, 4, 1, 2, 1 }, { 4, 1, 2, 1, 2, 1 }, { 1, 1, 1, 1, 4, 3 }, { 1, 1, 1, 3, 4, 1 }, { 1, 3, 1, 1, 4, 1 },
+    { 1, 1, 4, 1, 1, 3 }, { 1, 1, 4, 3, 1, 1 }, { 4, 1, 1, 1, 1, 3 }, { 4, 1, 1, 3, 1, 1 }, { 1, 1, 3, 1, 4, 1 },
+    { 1, 1, 4, 1, 3, 1 }, { 3, 1, 1, 1, 4, 1 }, { 4, 1, 1, 1, 3, 1 }, { 2, 1, 1, 4, 1, 2 }, { 2, 1, 1, 2, 1, 4 },
+    { 2, 1, 1, 2, 3, 2 }, { 2, 3, 3, 1, 1, 1, 2 }
+};
+
+const int code128StartA = 103;
+const int code128StartC = 105;
+const int code128Stop = 106;
+// Looser than EAN, the checksum over all symbols catches what slips through
+const float code128MaxVariance = 0.25f;
+const float code128MaxElementVariance = 0.7f;
+
+// Best matching symbol of the 6 elements at \p runs, -1 if none matches well enough
+int code128Symbol(const float* runs, int first, int last)
+{
+    int best = -1;
+    auto bestVariance = code128MaxVariance;
+    for (int symbol = first; symbol <= last; ++symbol)
+    {
+        const auto variance = patternVariance(runs, code128Patterns[symbol], 6, code128MaxElementVariance);
+        if (variance < bestVariance)
+        {
+            bestVariance = variance;
+            best = symbol;
+        }
+    }
+    return best;
+}
+
+/*!
+ * Text of the symbol values between the start and the check symbol. Code sets A and B map values to ASCII, C to
+ * digit pairs. FNC1 outside the first position becomes the GS separator of GS1, FNC2 and FNC3 are dropped.
+ */
+std::string code128Text(const std::vector<int>& values)
+{
+    enum CodeSet
+    {
+        SetA,
+        SetB,
+        SetC
+    };
+
+    auto codeSet = static_cast<CodeSet>(values.front() - code128StartA);
+    bool shift = false;
+    bool extended = false;
+    std::string text;
+
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        const auto value = values[i];
+        const auto set = shift ? (codeSet == SetA ? SetB : SetA) : codeSet;
+        shift = false;
+
+        if (set == SetC)
+        {
+            if (value < 100)
+            {
+                text += static_cast<char>('0' + value / 10);
+                text += static_cast<char>('0' + value % 10);
+            }
+            else if (value == 100)
+            {
+                codeSet = SetB;
+            }
+            else if (value == 101)
+            {
+                codeSet = SetA;
+            }
+            else if (value == 102 && i > 1)
+            {
+                text += '\x1D';
+            }
+            continue;
+        }
+
+        if (value < 96)
+        {
+            auto character = (set == SetA && value >= 64) ? value - 64 : value + 32;
+            if (extended)
+            {
+                character += 128;
+                extended = false;
+            }
+            text += static_cast<char>(character);
+            continue;
+        }
+
+        switch (value)
+        {
+        case 98:
+            shift = true;
+            break;
+        case 99:
+            codeSet = SetC;
+            break;
+        case 100:
+            if (set == SetB)
+            {
+                extended = true;
+            }
+            else
+            {
+                codeSet = SetB;
+            }
+            break;
+        case 101:
+            if (set == SetA)
+            {
+                extended = true;
+            }
+            else
+            {
+                codeSet = SetA;
+            }
+            break;
+        case 102:
+            if (i > 1)
+            {
+                text += '\x1D';
+            }
+            break;
+        default:
+            // FNC2 and FNC3 are instructions to the reader
+            break;
+        }
+    }
+    return text;
+}
+
+// Reads a Code 128 symbol whose start symbol begins at the dark element \p start. Returns the index past its trailing
+// quiet zone, or 0 if there is no valid symbol.
+size_t decodeCode128(const Runs& runs, size_t start, std::string& text)
+{
+    if (start + 6 > runs.size())
+    {
+        return 0;
+    }
+    const auto startSymbol = code128Symbol(&runs[start], code128StartA, code128StartC);
+    if (startSymbol < 0 || runs[start - 1] < minQuietModules * sum(&runs[start], 6) / 11.0f)
+    {
+        return 0;
+    }
+
+    std::vector<int> values{ startSymbol };
+    size_t position = start + 6;
+    while (true)
+    {
+        if (position + 6 > runs.size())
+        {
+            return 0;
+        }
+        const auto symbol = code128Symbol(&runs[position], 0, code128Stop);
+        if (symbol < 0)
+        {
+            return 0;
+        }
+        if (symbol == code128Stop)
+        {
+            break;
+        }
+        values.push_back(symbol);
+        position += 6;
+    }
+
+    // The stop pattern has a seventh element, a bar of two modules, followed by the quiet zone
+    const auto module = sum(&runs[position], 6) / 11.0f;
+    if (position + 8 > runs.size() || std::abs(runs[position + 6] - 2.0f * module) > module
+        || runs[position + 7] < minQuietModules * module)
+    {
+        return 0;
+    }
+
+    // Start, at least one data symbol and the check symbol
+    if (values.size() < 3)
+    {
+        return 0;
+    }
+    int checksum = values.front();
+    for (size_t i = 1; i + 1 < values.size(); ++i)
+    {
+        checksum += static_cast<int>(i) * values[i];
+    }
+    if (checksum % 103 != values.back())
+    {
+        return 0;
+    }
+
+    values.pop_back();
+    text = code128Text(values);
+    return position + 8;
+}
+
+
+// Space, bar, space and bar widths of the left hand odd parity (L) digits of EAN. Even parity (G) digits are their
+// mirror image, right hand (R) digits have the same widths starting with a bar.
+const uint8_t eanDigitPatterns[10][4] = { { 3, 2, 1, 1 }, { 2, 2, 2, 1 }, { 2, 1, 2, 2 }, { 1, 4, 1, 1 },
+    { 1, 1, 3, 2 }, { 1, 2, 3, 1 }, { 1, 1, 1, 4 }, { 1, 3, 1, 2 }, { 1, 2, 1, 3 }, { 3, 1, 1, 2 } };
+
+// Parities of the six left hand digits of EAN-13, one bit per digit from the first, set for G. The pattern encodes
+// the leading digit.
+const uint8_t ean13Parities[10] = { 0x00, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A };
+
+const uint8_t eanGuard[5] = { 1, 1, 1, 1, 1 };
+const float eanMaxVariance = 0.48f;
+const float eanMaxElementVariance = 0.7f;
+
+// Digit of the 4 elements at \p runs, -1 if none matches well enough. \p even is set if it has G parity.
+int eanDigit(const float* runs, bool allowEven, bool& even)
+{
+    int best = -1;
+    auto bestVariance = eanMaxVariance;
+    for (int digit = 0; digit < 10; ++digit)
+    {
+        const auto* pattern = eanDigitPatterns[digit];
+        auto variance = patternVariance(runs, pattern, 4, eanMaxElementVariance);
+        if (variance < bestVariance)
+        {
+            bestVariance = variance;
+            best = digit;
+            even = false;
+        }
+        if (!allowEven)
+        {
+            continue;
+        }
+
+        const uint8_t mirrored[4] = { pattern[3], pattern[2], pattern[1], pattern[0] };
+        variance = patternVariance(runs, mirrored, 4, eanMaxElementVariance);
+        if (variance < bestVariance)
+        {
+            bestVariance = variance;
+            best = digit;
+            even = true;
+        }
+    }
+    return best;
+}
+
+// Reads an EAN-13 or EAN-8 symbol whose start guard begins at the dark element \p start, see decodeCode128()
+size_t decodeEan(const Runs& runs, size_t start, size_t digitsPerHalf, std::string& text)
+{
+    // Guard, two halves of 4 elements per digit separated by the middle guard, guard, quiet zone
+    const size_t elements = 3 + 4 * digitsPerHalf + 5 + 4 * digitsPerHalf + 3;
+    if (start + elements + 1 > runs.size())
+    {
+        return 0;
+    }
+
+    const auto module = sum(&runs[start], elements) / static_cast<float>(3 + 14 * digitsPerHalf + 5 + 3);
+    const auto middle = start + 3 + 4 * digitsPerHalf;
+    const auto end = middle + 5 + 4 * digitsPerHalf;
+    if (runs[start - 1] < minQuietModules * module || runs[end + 3] < minQuietModules * module
+        || patternVariance(&runs[start], eanGuard, 3, eanMaxElementVariance) > eanMaxVariance
+        || patternVariance(&runs[middle], eanGuard, 5, eanMaxElementVariance) > eanMaxVariance
+        || patternVariance(&runs[end], eanGuard, 3, eanMaxElementVariance) > eanMaxVariance)
+    {
+        return 0;
+    }
+
+    std::string digits;
+    unsigned parities = 0;
+    for (size_t i = 0; i < 2 * digitsPerHalf; ++i)
+    {
+        const bool left = i < digitsPerHalf;
+        const auto position = left ? start + 3 + 4 * i : middle + 5 + 4 * (i - digitsPerHalf);
+        bool even = false;
+        const auto digit = eanDigit(&runs[position], left && digitsPerHalf == 6, even);
+        if (digit < 0)
+        {
+            return 0;
+        }
+        if (left)
+        {
+            parities = (parities << 1) | (even ? 1u : 0u);
+        }
+        digits += static_cast<char>('0' + digit);
+    }
+
+    if (digitsPerHalf == 6)
+    {
+        const auto leading = std::find(std::begin(ean13Parities), std::end(ean13Parities), parities);
+        if (leading == std::end(ean13Parities))
+        {
+            return 0;
+        }
+        digits.insert(digits.begin(), static_cast<char>('0' + (leading - std::begin(ean13Parities))));
+    }
+
+    // Weights alternate 3 and 1 from the digit before the check digit backwards
+    int checksum = 0;
+    for (size_t i = 0; i + 1 < digits.size(); ++i)
+    {
+        const auto weight = ((digits.size() - 1 - i) % 2 == 1) ? 3 : 1;
+        checksum += weight * (digits[i] - '0');
+    }
+    if ((10 - checksum % 10) % 10 != digits.back() - '0')
+    {
+        return 0;
+    }
+
+    text = digits;
+    return end + 4;
+}
+
+/*!
+ * Decodes every symbol on a line and counts each text in \p votes. Symbols read backwards, e.g. a label upside down,
+ * are found by the caller passing the reversed runs as well.
+ */
+void decodeRuns(const Runs& runs, const BarcodeDecoderOptions& options,
+    std::map<std::pair<BarcodeSymbology, std::string>, size_t>& votes)
+{
+    for (size_t start = 1; start < runs.size(); start += 2)
+    {
+        std::string text;
+        size_t next = 0;
+        auto symbology = BarcodeSymbology::Code128;
+        if (options.code128)
+        {
+            next = decodeCode128(runs, start, text);
+        }
+        if (!next && options.ean)
+        {
+            symbology = BarcodeSymbology::Ean13;
+            next = decodeEan(runs, start, 6, text);
+        }
+        if (!next && options.ean)
+        {
+            symbology = BarcodeSymbology::Ean8;
+            next = decodeEan(runs, start, 4, text);
+        }
+        if (next)
+        {
+            votes[std::make_pair(symbology, text)]++;
+            // Continues at the first bar after the quiet zone, which may belong to the next symbol
+            start = next - 1;
+        }
+    }
+}
+
+/*!
+ * Element widths of a binarized line. Each edge is placed where the line crosses \p threshold by linear
+ * interpolation between the two pixels around it, so modules of about two pixels still read reliably.
+ */
+void runsOf(const uint8_t* line, size_t length, const uint64_t* dark, float threshold, Runs& runs)
+{
+    runs.clear();
+    const bool startsDark = (dark[0] & 1) != 0;
+    if (startsDark)
+    {
+        runs.push_back(0.0f);
+    }
+
+    float edge = 0.0f;
+    const size_t words = (length + 63) / 64;
+    for (size_t word = 0; word < words; ++word)
+    {
+        // Bit i of changes is set where pixel i and i + 1 differ
+        const auto next = word + 1 < words ? dark[word + 1] : 0;
+        auto changes = dark[word] ^ ((dark[word] >> 1) | (next << 63));
+        if (word == words - 1)
+        {
+            const auto bits = (length - 1) % 64;
+            changes &= bits ? (uint64_t{ 1 } << bits) - 1 : 0;
+        }
+
+        while (changes)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit = 0;
+            _BitScanForward64(&bit, changes);
+#else
+            const auto bit = __builtin_ctzll(changes);
+#endif
+            changes &= changes - 1;
+
+            const auto x = word * 64 + bit;
+            const auto before = static_cast<float>(line[x]);
+            const auto after = static_cast<float>(line[x + 1]);
+            const auto crossing = std::min(std::max((threshold - before) / (after - before), 0.0f), 1.0f);
+            const auto position = static_cast<float>(x) + 0.5f + crossing;
+            runs.push_back(position - edge);
+            edge = position;
+        }
+    }
+    runs.push_back(static_cast<float>(length) - edge);
+}
+
+// A group of neighbouring tiles crossed by parallel edges, in pixels
+struct Candidate
+{
+    // Unit vector across the edges, the direction to scan in
+    float acrossX;
+    float acrossY;
+    // Centre and extent of the tiles across and along the edges, relative to the centre
+    float centerX;
+    float centerY;
+    float acrossMin;
+    float acrossMax;
+    float alongMin;
+    float alongMax;
+};
+
+/*!
+ * Tiles whose gradient is much stronger across one direction than along it, i.e. that are crossed by parallel edges,
+ * grouped into candidates of similar edge direction. Text and noise have edges in all directions and are left out.
+ *
+ * Across a straight edge whose normal has the angle theta, the differences in the direction phi sum to about
+ * |cos(theta - phi)| per step, so their squares over the four directions of the tile kernel add up to a vector at
+ * twice theta. Its length relative to the total tells how much the edges agree.
+ */
+std::vector<Candidate> candidates(const Kernels& kernels, const uint8_t* image, size_t width, size_t height,
+    size_t stride, uint8_t minContrast)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    if (width <= size || height <= size)
+    {
+        return std::vector<Candidate>();
+    }
+    const auto columns = (width - 1) / size;
+    const auto rows = (height - 1) / size;
+
+    // A mean difference of a quarter of the minimum contrast per pixel, e.g. such edges every four pixels
+    const auto minGradient = static_cast<uint32_t>(minContrast) * size * size / 4;
+    // Straight edges reach 0.5, a tile with edges in all directions 0
+    const float minCoherence = 0.2f;
+    // Edge directions are grouped in bins of 180 / 16 degrees, neighbouring bins join one candidate
+    const int bins = 16;
+    const float diagonal = 1.0f / std::sqrt(2.0f);
+    const float pi = 3.14159265f;
+
+    struct Tile
+    {
+        float doubleCos;
+        float doubleSin;
+        // Edge direction bin plus one, 0 if the tile is no candidate
+        int bin;
+    };
+    std::vector<Tile> tiles(columns * rows);
+    std::vector<uint32_t> sums(4 * columns);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        kernels.tileRow(image + row * size * stride, stride, columns, sums.data());
+        for (size_t column = 0; column < columns; ++column)
+        {
+            const auto* tile = &sums[4 * column];
+            auto& result = tiles[row * columns + column];
+            result = { 0.0f, 0.0f, 0 };
+            if (*std::max_element(tile, tile + 4) < minGradient)
+            {
+                continue;
+            }
+
+            // Diagonal steps are longer by sqrt(2)
+            const float directions[4] = { static_cast<float>(tile[0]), tile[1] * diagonal,
+                static_cast<float>(tile[2]), tile[3] * diagonal };
+            float squares[4];
+            std::transform(directions, directions + 4, squares, [](float value) { return value * value; });
+            const auto total = squares[0] + squares[1] + squares[2] + squares[3];
+            result.doubleCos = squares[0] - squares[2];
+            result.doubleSin = squares[1] - squares[3];
+            if (std::hypot(result.doubleCos, result.doubleSin) < minCoherence * total)
+            {
+                continue;
+            }
+
+            const auto angle = std::atan2(result.doubleSin, result.doubleCos) / 2.0f;
+            result.bin = static_cast<int>(std::lround(angle / pi * bins) + bins) % bins + 1;
+        }
+    }
+
+    // Connected tiles of similar edge direction, including diagonal neighbours
+    std::vector<Candidate> found;
+    std::vector<size_t> stack;
+    std::vector<size_t> members;
+    for (size_t index = 0; index < tiles.size(); ++index)
+    {
+        if (!tiles[index].bin)
+        {
+            continue;
+        }
+
+        float doubleCos = 0.0f;
+        float doubleSin = 0.0f;
+        members.clear();
+        stack.push_back(index);
+        const auto bin = tiles[index].bin;
+        tiles[index].bin = -bin;
+        while (!stack.empty())
+        {
+            const auto tile = stack.back();
+            stack.pop_back();
+            members.push_back(tile);
+            doubleCos += tiles[tile].doubleCos;
+            doubleSin += tiles[tile].doubleSin;
+
+            const auto column = tile % columns;
+            const auto row = tile / columns;
+            for (size_t y = row ? row - 1 : 0; y <= std::min(row + 1, rows - 1); ++y)
+            {
+                for (size_t x = column ? column - 1 : 0; x <= std::min(column + 1, columns - 1); ++x)
+                {
+                    auto& neighbour = tiles[y * columns + x];
+                    const auto distance = std::abs(neighbour.bin - bin);
+                    if (neighbour.bin > 0 && (distance <= 1 || distance == bins - 1))
+                    {
+                        // Visited tiles keep their negated bin, so they join no other candidate
+                        neighbour.bin = -neighbour.bin;
+                        stack.push_back(y * columns + x);
+                    }
+                }
+            }
+        }
+
+        // A single tile is too small for a symbol and mostly a stray edge
+        if (members.size() < 2)
+        {
+            continue;
+        }
+
+        Candidate candidate;
+        const auto angle = std::atan2(doubleSin, doubleCos) / 2.0f;
+        candidate.acrossX = std::cos(angle);
+        candidate.acrossY = std::sin(angle);
+
+        float left = static_cast<float>(width);
+        float top = static_cast<float>(height);
+        float right = 0.0f;
+        float bottom = 0.0f;
+        for (const auto tile : members)
+        {
+            const auto x = static_cast<float>((tile % columns) * size + size / 2);
+            const auto y = static_cast<float>((tile / columns) * size + size / 2);
+            left = std::min(left, x);
+            top = std::min(top, y);
+            right = std::max(right, x);
+            bottom = std::max(bottom, y);
+        }
+        candidate.centerX = (left + right) / 2.0f;
+        candidate.centerY = (top + bottom) / 2.0f;
+
+        // Tile centres are up to half a tile inside the bars
+        const auto half = static_cast<float>(size) / 2.0f;
+        candidate.acrossMin = candidate.alongMin = std::numeric_limits<float>::max();
+        candidate.acrossMax = candidate.alongMax = -std::numeric_limits<float>::max();
+        for (const auto tile : members)
+        {
+            const auto x = static_cast<float>((tile % columns) * size + size / 2) - candidate.centerX;
+            const auto y = static_cast<float>((tile / columns) * size + size / 2) - candidate.centerY;
+            const auto across = x * candidate.acrossX + y * candidate.acrossY;
+            const auto along = y * candidate.acrossX - x * candidate.acrossY;
+            candidate.acrossMin = std::min(candidate.acrossMin, across - half);
+            candidate.acrossMax = std::max(candidate.acrossMax, across + half);
+            candidate.alongMin = std::min(candidate.alongMin, along - half);
+            candidate.alongMax = std::max(candidate.alongMax, along + half);
+        }
+        found.push_back(candidate);
+    }
+    return found;
+}
+
+// Samples at (x + t * stepX, y + t * stepY) for t from first to last
+struct ScanLine
+{
+    float x;
+    float y;
+    float stepX;
+    float stepY;
+    long first;
+    long last;
+};
+
+/*!
+ * Lines across the edges of a candidate, spread over its extent along them and long enough to take in the quiet
+ * zones on both sides.
+ */
+void scanLines(const Candidate& candidate, size_t count, std::vector<ScanLine>& lines)
+{
+    const auto length = candidate.acrossMax - candidate.acrossMin;
+    const auto margin = length / 2.0f + static_cast<float>(BarcodeDecoder::TileSize);
+    const auto first = static_cast<long>(std::floor(candidate.acrossMin - margin));
+    const auto last = static_cast<long>(std::ceil(candidate.acrossMax + margin));
+
+    for (size_t line = 0; line < count; ++line)
+    {
+        // Evenly spread over the middle three quarters, the ends may only be partly covered by bars
+        const auto fraction = (static_cast<float>(line) + 0.5f) / static_cast<float>(count);
+        const auto along = candidate.alongMin + (candidate.alongMax - candidate.alongMin) * (0.125f + 0.75f * fraction);
+        lines.push_back({ candidate.centerX - along * candidate.acrossY, candidate.centerY + along * candidate.acrossX,
+            candidate.acrossX, candidate.acrossY, first, last });
+    }
+}
+
+// The pixels of \p line inside the image, in order, interpolated bilinearly between the pixels around each sample
+void gather(const uint8_t* image, size_t width, size_t height, size_t stride, const ScanLine& line,
+    std::vector<uint8_t>& pixels)
+{
+    pixels.clear();
+    const auto right = static_cast<float>(width - 1);
+    const auto bottom = static_cast<float>(height - 1);
+    for (long t = line.first; t <= line.last; ++t)
+    {
+        const auto x = line.x + static_cast<float>(t) * line.stepX;
+        const auto y = line.y + static_cast<float>(t) * line.stepY;
+        if (!(x >= 0.0f && y >= 0.0f && x <= right && y <= bottom))
+        {
+            // Inside the image the line is one piece, so once out it never comes back
+            if (!pixels.empty())
+            {
+                break;
+            }
+            continue;
+        }
+
+        const auto column = std::min(static_cast<size_t>(x), width - 2);
+        const auto row = std::min(static_cast<size_t>(y), height - 2);
+        const auto fractionX = x - static_cast<float>(column);
+        const auto fractionY = y - static_cast<float>(row);
+        const auto* pixel = image + row * stride + column;
+        const auto upper = pixel[0] + fractionX * (pixel[1] - pixel[0]);
+        const auto lower = pixel[stride] + fractionX * (pixel[stride + 1] - pixel[stride]);
+        pixels.push_back(static_cast<uint8_t>(upper + fractionY * (lower - upper) + 0.5f));
+    }
+}
+
+// Tiles with less contrast than this are taken as plain background or plain print
+const int flatTileRange = 24;
+
+/*!
+ * Binarizes the image with a threshold per tile for the matrix codes, which have no scan line to take a threshold
+ * from. A tile's black point is its mean, or for a flat tile half its darkest pixel unless its neighbours above and
+ * to the left suggest it is dark. The threshold is the mean black point of the 5x5 tiles around, which keeps a module
+ * on the border between a dark and a light area on the right side.
+ */
+BinaryImage binarize(const Kernels& kernels, const uint8_t* image, size_t width, size_t height, size_t stride)
+{
+    const auto size = BarcodeDecoder::TileSize;
+    const auto columns = (width + size - 1) / size;
+    const auto rows = (height + size - 1) / size;
+    const auto fullColumns = width / size;
+
+    std::vector<uint8_t> darkest(columns);
+    std::vector<uint8_t> brightest(columns);
+    std::vector<uint32_t> sums(columns);
+    std::vector<int> blackPoints(columns * rows);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const auto* origin = image + row * size * stride;
+        const auto tileHeight = std::min(size, height - row * size);
+        if (tileHeight == size)
+        {
+            kernels.tileStats(origin, stride, fullColumns, darkest.data(), brightest.data(), sums.data());
+        }
+        for (size_t column = tileHeight == size ? fullColumns : 0; column < columns; ++column)
+        {
+            const auto tileWidth = std::min(size, width - column * size);
+            rectangleStatsScalar(origin + column * size, stride, tileWidth, tileHeight, darkest[column],
+                brightest[column], sums[column]);
+        }
+
+        for (size_t column = 0; column < columns; ++column)
+        {
+            const auto pixels = std::min(size, width - column * size) * std::min(size, height - row * size);
+            auto blackPoint = static_cast<int>(sums[column] / pixels);
+            if (brightest[column] - darkest[column] <= flatTileRange)
+            {
+                blackPoint = darkest[column] / 2;
+                if (row > 0 && column > 0)
+                {
+                    const auto* above = &blackPoints[(row - 1) * columns];
+                    const auto neighbours = (above[column] + 2 * blackPoints[row * columns + column - 1]
+                                                + above[column - 1])
+                        / 4;
+                    if (darkest[column] < neighbours)
+                    {
+                        blackPoint = neighbours;
+                    }
+                }
+            }
+            blackPoints[row * columns + column] = blackPoint;
+        }
+    }
+
+    BinaryImage binary;
+    binary.width = width;
+    binary.height = height;
+    binary.stride = (width + 63) / 64;
+    binary.bits.resize(binary.stride * height);
+    std::vector<uint8_t> thresholds(columns);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const auto top = row >= 2 ? row - 2 : 0;
+        const auto bottom = std::min(rows - 1, row + 2);
+        for (size_t column = 0; column < columns; ++column)
+        {
+            const auto left = column >= 2 ? column - 2 : 0;
+            const auto right = std::min(columns - 1, column + 2);
+            int sum = 0;
+            for (auto y = top; y <= bottom; ++y)
+            {
+                for (auto x = left; x <= right; ++x)
+                {
+                    sum += blackPoints[y * columns + x];
+                }
+            }
+            thresholds[column] = static_cast<uint8_t>(sum / static_cast<int>((bottom - top + 1) * (right - left + 1)));
+        }
+
+        for (auto y = row * size; y < std::min(height, (row + 1) * size); ++y)
+        {
+            kernels.tileThreshold(image + y * stride, width, thresholds.data(), &binary.bits[y * binary.stride]);
+        }
+    }
+    return binary;
+}
+
+} // namespace
+
+
+const char* BarcodeSymbologyName(BarcodeSymbology symbology)
+{
+    switch (symbology)
+    {
+    case BarcodeSymbology::Code128:
+        return "code128";
+    case BarcodeSymbology::Ean13:
+        return "ean13";
+    case BarcodeSymbology::Ean8:
+        return "ean8";
+    case BarcodeSymbology::QrCode:
+        return "qrcode";
+    case BarcodeSymbology::DataMatrix:
+        return "datamatrix";
+    }
+    return "unknown";
+}
+
+
+BarcodeDecoder::BarcodeDecoder(BarcodeDecoderOptions options)
+    : m_options(std::move(options))
+    , m_isa(BestIsa())
+{}
+
+BarcodeDecoder::BarcodeDecoder(BarcodeDecoderOptions options, Isa isa)
+    : m_options(std::move(options))
+    , m_isa(cpuSupports(isa) ? isa : BestIsa())
+{}
+
+BarcodeDecoder::Isa BarcodeDecoder::BestIsa()
+{
+    static const Isa best = cpuSupports(Isa::AVX2) ? Isa::AVX2
+                                                   : (cpuSupports(Isa::SSE41) ? Isa::SSE41 : Isa::Scalar);
+    return best;
+}
+
+std::vector<BarcodeDecoder::Isa> BarcodeDecoder::AvailableIsas()
+{
+    std::vector<Isa> isas;
+    for (const auto isa : { Isa::Scalar, Isa::SSE41, Isa::AVX2 })
+    {
+        if (cpuSupports(isa))
+        {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
+
+const char* BarcodeDecoder::IsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::SSE41:
+        return "sse4.1";
+    case Isa::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+BarcodeDecoder::Isa BarcodeDecoder::SelectedIsa() const
+{
+    return m_isa;
+}
+
+const BarcodeDecoderOptions& BarcodeDecoder::Options() const
+{
+    return m_options;
+}
+
+std::vector<DecodedBarcode> BarcodeDecoder::Decode(
+    const uint8_t* image, size_t width, size_t height, size_t stride) const
+{
+    Region region;
+    region.width = width;
+    region.height = height;
+    return Decode(image, width, height, stride, region);
+}
+
+std::vector<DecodedBarcode> BarcodeDecoder::Decode(
+    const uint8_t* image, size_t width, size_t height, size_t stride, const Region& region) const
+{
+    if (region.width == 0 || region.height == 0 || region.x + region.width > width
+        || region.y + region.height > height || stride < width)
+    {
+        throw std::invalid_argument("BarcodeDecoder: region is not inside the image");
+    }
+    if (region.width < 2 || region.height < 2)
+    {
+        // Holds no barcode, and gather() interpolates between 2x2 pixels
+        return std::vector<DecodedBarcode>();
+    }
+
+    const auto functions = kernels(m_isa);
+    const auto* origin = image + region.y * stride + region.x;
+    const auto lineCount = std::max<size_t>(m_options.linesPerRegion, 1);
+
+    std::vector<ScanLine> lines;
+    for (const auto& candidate :
+        candidates(functions, origin, region.width, region.height, stride, m_options.minContrast))
+    {
+        scanLines(candidate, lineCount, lines);
+    }
+    if (lines.empty())
+    {
+        // Nothing looks like bars, e.g. a symbol too small for the tiles. Horizontal and vertical lines over the whole
+        // region still find one that is upright.
+        const auto right = static_cast<long>(region.width) - 1;
+        const auto bottom = static_cast<long>(region.height) - 1;
+        for (size_t line = 0; line < lineCount; ++line)
+        {
+            const auto fraction = (static_cast<float>(line) + 0.5f) / static_cast<float>(lineCount);
+            lines.push_back({ 0.0f, std::floor(fraction * static_cast<float>(bottom)), 1.0f, 0.0f, 0, right });
+            lines.push_back({ std::floor(fraction * static_cast<float>(right)), 0.0f, 0.0f, 1.0f, 0, bottom });
+        }
+    }
+
+    std::map<std::pair<BarcodeSymbology, std::string>, size_t> votes;
+    std::vector<uint8_t> pixels;
+    std::vector<uint64_t> dark;
+    Runs runs;
+    Runs reversed;
+    for (const auto& line : lines)
+    {
+        gather(origin, region.width, region.height, stride, line, pixels);
+        if (pixels.size() < 2)
+        {
+            continue;
+        }
+
+        uint8_t darkest = 0;
+        uint8_t brightest = 0;
+        functions.range(pixels.data(), pixels.size(), darkest, brightest);
+        if (brightest - darkest < m_options.minContrast)
+        {
+            continue;
+        }
+
+        const auto threshold = static_cast<uint8_t>((darkest + brightest) / 2);
+        dark.resize((pixels.size() + 63) / 64);
+        functions.threshold(pixels.data(), pixels.size(), threshold, dark.data());
+        // Edges sit where the line crosses halfway between the pixel values, the integer threshold only decides
+        // which side a pixel is on
+        runsOf(pixels.data(), pixels.size(), dark.data(), threshold + 0.5f, runs);
+        decodeRuns(runs, m_options, votes);
+
+        reversed.assign(runs.rbegin(), runs.rend());
+        if (runs.size() % 2 == 0)
+        {
+            // Ended dark, so the reversed line starts dark
+            reversed.insert(reversed.begin(), 0.0f);
+        }
+        decodeRuns(reversed, m_options, votes);
+    }
+
+    std::vector<DecodedBarcode> barcodes;
+    for (const auto& vote : votes)
+    {
+        if (vote.second >= m_options.minVotes)
+        {
+            DecodedBarcode barcode;
+            barcode.symbology = vote.first.first;
+            barcode.text = vote.first.second;
+            barcode.votes = vote.second;
+            barcodes.push_back(std::move(barcode));
+        }
+    }
+
+    if (m_options.qrCode || m_options.dataMatrix)
+    {
+        const auto matrixCodes =
+            MatrixCodeDecoder(m_options).Decode(binarize(functions, origin, region.width, region.height, stride));
+        barcodes.insert(barcodes.end(), matrixCodes.begin(), matrixCodes.end());
+    }
+    std::stable_sort(barcodes.begin(), barcodes.end(),
+        [](const DecodedBarcode& a, const DecodedBarcode& b) { return a.votes > b.votes; });
+    return barcodes;
+}
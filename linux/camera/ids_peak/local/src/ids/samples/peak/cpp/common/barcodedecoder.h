@@ -0,0 +1,122 @@
+/*!
+ * \file    barcodedecoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BarcodeDecoder class reads Code 128 and EAN-13/EAN-8
+ *          barcodes and QR Code and Data Matrix symbols from a Mono8 image,
+ *          e.g. the sample label in a captured frame. Tiles with strongly
+ *          directional gradients are grouped into candidate regions, which
+ *          are read along scan lines across their bars. For the matrix codes
+ *          the image is binarized with a threshold per tile and passed to
+ *          MatrixCodeDecoder. The gradient, statistics and binarization
+ *          kernels exist for AVX2, SSE4.1 and plain C++, the fastest one
+ *          supported by the CPU is selected at runtime.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BARCODEDECODER_H
+#define BARCODEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+enum class BarcodeSymbology
+{
+    Code128,
+    // UPC-A reads as EAN-13 with a leading 0
+    Ean13,
+    Ean8,
+    QrCode,
+    // ECC 200
+    DataMatrix
+};
+
+const char* BarcodeSymbologyName(BarcodeSymbology symbology);
+
+
+struct DecodedBarcode
+{
+    BarcodeSymbology symbology = BarcodeSymbology::Code128;
+    std::string text;
+    // Scan lines that read this text, more means a clearer print. A QR Code or Data Matrix symbol has one, its error
+    // correction already vouches for the text.
+    size_t votes = 0;
+};
+
+
+struct BarcodeDecoderOptions
+{
+    bool code128 = true;
+    bool ean = true;
+    bool qrCode = true;
+    bool dataMatrix = true;
+    // Scan lines across each candidate region
+    size_t linesPerRegion = 8;
+    // Scan lines that must agree on a linear barcode before it is reported. One risks misreads of EAN, whose check
+    // digit only catches most errors.
+    size_t minVotes = 2;
+    // Difference between the darkest and the brightest pixel of a scan line, below it the line is skipped
+    uint8_t minContrast = 40;
+};
+
+
+class BarcodeDecoder
+{
+
+public:
+    enum class Isa
+    {
+        Scalar,
+        SSE41,
+        AVX2
+    };
+
+    // Rectangle of an image in pixels
+    struct Region
+    {
+        size_t x = 0;
+        size_t y = 0;
+        size_t width = 0;
+        size_t height = 0;
+    };
+
+    // Uses the best instruction set supported by this CPU
+    explicit BarcodeDecoder(BarcodeDecoderOptions options = BarcodeDecoderOptions());
+    // Uses the given instruction set, falls back to the best supported one if the CPU lacks it
+    BarcodeDecoder(BarcodeDecoderOptions options, Isa isa);
+
+    static Isa BestIsa();
+    static std::vector<Isa> AvailableIsas();
+    static const char* IsaName(Isa isa);
+
+    Isa SelectedIsa() const;
+    const BarcodeDecoderOptions& Options() const;
+
+    /*!
+     * \brief Decodes every barcode in the Mono8 image, most votes first. \p stride is in bytes. Bars may run in any
+     *        direction.
+     */
+    std::vector<DecodedBarcode> Decode(const uint8_t* image, size_t width, size_t height, size_t stride) const;
+
+    /*!
+     * \brief Decodes the barcodes within \p region only, e.g. where the sample label is. Throws std::invalid_argument
+     *        if the region is not inside the image. A region less than 2 pixels wide or high reads nothing.
+     */
+    std::vector<DecodedBarcode> Decode(
+        const uint8_t* image, size_t width, size_t height, size_t stride, const Region& region) const;
+
+    // Side length of the gradient tiles in pixels
+    static const size_t TileSize = 16;
+
+private:
+    BarcodeDecoderOptions m_options;
+    Isa m_isa;
+};
+
+#endif // BARCODEDECODER_H
@@ -0,0 +1,315 @@
+/*!
+ * \file    bayerjpegencoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BayerJpegEncoder class encodes an 8 bit Bayer image to JPEG
+ *          without an RGB intermediate. Strips of 16 rows are debayered
+ *          straight into YCbCr 4:2:0 planes and handed to the raw data
+ *          interface of libjpeg(-turbo), so the only full frame produced is
+ *          the compressed JPEG.
+ *
+ * \version 1.0.0
+ */
+
+#include "bayerjpegencoder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+// jpeglib.h needs FILE and size_t declared before it
+#include <jpeglib.h>
+
+
+namespace
+{
+
+// One iMCU row of 4:2:0 data: 16 luma rows and 8 rows of each chroma plane
+constexpr size_t stripRows = 16;
+
+struct ErrorManager
+{
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void errorExit(j_common_ptr info)
+{
+    auto* error = reinterpret_cast<ErrorManager*>(info->err);
+    (*info->err->format_message)(info, error->message);
+    std::longjmp(error->jump, 1);
+}
+
+void silentOutput(j_common_ptr)
+{
+    // Warnings are not printed to stderr, errors are reported through errorExit
+}
+
+// Strip buffers, padded to whole 16x16 macroblocks as required by jpeg_write_raw_data
+struct Strip
+{
+    size_t lumaStride;
+    size_t chromaStride;
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> cb;
+    std::vector<uint8_t> cr;
+    JSAMPROW lumaRows[stripRows];
+    JSAMPROW cbRows[stripRows / 2];
+    JSAMPROW crRows[stripRows / 2];
+    JSAMPARRAY planes[3];
+
+    explicit Strip(size_t width)
+        : lumaStride((width + 15) / 16 * 16)
+        , chromaStride(lumaStride / 2)
+        , luma(lumaStride * stripRows)
+        , cb(chromaStride * stripRows / 2)
+        , cr(chromaStride * stripRows / 2)
+    {
+        for (size_t i = 0; i < stripRows; ++i)
+        {
+            lumaRows[i] = luma.data() + i * lumaStride;
+        }
+        for (size_t i = 0; i < stripRows / 2; ++i)
+        {
+            cbRows[i] = cb.data() + i * chromaStride;
+            crRows[i] = cr.data() + i * chromaStride;
+        }
+        planes[0] = lumaRows;
+        planes[1] = cbRows;
+        planes[2] = crRows;
+    }
+};
+
+// Replicates the last valid column and row into the padding of a plane
+void padPlane(uint8_t* plane, size_t stride, size_t validWidth, size_t validRows, size_t rows)
+{
+    for (size_t y = 0; y < validRows; ++y)
+    {
+        auto* row = plane + y * stride;
+        std::fill(row + validWidth, row + stride, row[validWidth - 1]);
+    }
+    for (size_t y = validRows; y < rows; ++y)
+    {
+        std::memcpy(plane + y * stride, plane + (validRows - 1) * stride, stride);
+    }
+}
+
+// Fills the first \p rows rows of the strip with rows y to y + rows of the output image
+using StripSource = std::function<void(size_t y, size_t rows, Strip& strip)>;
+
+// Everything between setjmp and the end of this function is plain C state, so a longjmp does not skip destructors.
+// The strip source is only called between libjpeg calls, which are the only ones that jump.
+bool compress(jpeg_compress_struct& info, ErrorManager& error, Strip& strip, size_t width, size_t rowCount,
+    int quality, const StripSource& source, const BayerJpegEncoder::StripObserver& observer, size_t firstRow,
+    unsigned char** output, unsigned long* outputSize, std::string& exceptionMessage)
+{
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = errorExit;
+    error.manager.output_message = silentOutput;
+
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_compress(&info);
+        return false;
+    }
+
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, output, outputSize);
+
+    info.image_width = static_cast<JDIMENSION>(width);
+    info.image_height = static_cast<JDIMENSION>(rowCount);
+    info.input_components = 3;
+    info.in_color_space = JCS_YCbCr;
+
+    jpeg_set_defaults(&info);
+    jpeg_set_colorspace(&info, JCS_YCbCr);
+    jpeg_set_quality(&info, quality, TRUE);
+
+    // The planes are already subsampled, libjpeg only has to run the DCT and the entropy coder
+    info.raw_data_in = TRUE;
+    info.comp_info[0].h_samp_factor = 2;
+    info.comp_info[0].v_samp_factor = 2;
+    info.comp_info[1].h_samp_factor = 1;
+    info.comp_info[1].v_samp_factor = 1;
+    info.comp_info[2].h_samp_factor = 1;
+    info.comp_info[2].v_samp_factor = 1;
+
+    jpeg_start_compress(&info, TRUE);
+
+    const auto chromaWidth = (width + 1) / 2;
+
+    for (size_t y = 0; y < rowCount; y += stripRows)
+    {
+        const auto rows = std::min(stripRows, rowCount - y);
+        const auto chromaRows = (rows + 1) / 2;
+
+        try
+        {
+            source(y, rows, strip);
+
+            padPlane(strip.luma.data(), strip.lumaStride, width, rows, stripRows);
+            padPlane(strip.cb.data(), strip.chromaStride, chromaWidth, chromaRows, stripRows / 2);
+            padPlane(strip.cr.data(), strip.chromaStride, chromaWidth, chromaRows, stripRows / 2);
+
+            if (observer)
+            {
+                YCbCr420Planes planes;
+                planes.luma = strip.luma.data();
+                planes.lumaStride = strip.lumaStride;
+                planes.cb = strip.cb.data();
+                planes.cr = strip.cr.data();
+                planes.chromaStride = strip.chromaStride;
+                planes.width = width;
+                planes.rows = rows;
+                observer(firstRow + y, planes);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            exceptionMessage = e.what();
+            jpeg_destroy_compress(&info);
+            return false;
+        }
+
+        jpeg_write_raw_data(&info, strip.planes, static_cast<JDIMENSION>(stripRows));
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return true;
+}
+
+std::vector<uint8_t> encode(size_t width, size_t rowCount, int quality, const StripSource& source,
+    const BayerJpegEncoder::StripObserver& observer, size_t firstRow)
+{
+    jpeg_compress_struct info;
+    ErrorManager error;
+    error.message[0] = '\0';
+    Strip strip(width);
+    std::string exceptionMessage;
+
+    unsigned char* output = nullptr;
+    unsigned long outputSize = 0;
+
+    const auto success = compress(info, error, strip, width, rowCount, quality, source, observer, firstRow, &output,
+        &outputSize, exceptionMessage);
+
+    std::vector<uint8_t> jpeg;
+    if (success)
+    {
+        jpeg.assign(output, output + outputSize);
+    }
+    std::free(output);
+
+    if (!success)
+    {
+        throw std::runtime_error("BayerJpegEncoder: "
+            + (exceptionMessage.empty() ? std::string(error.message) : exceptionMessage));
+    }
+
+    return jpeg;
+}
+
+} // namespace
+
+
+BayerJpegEncoder::BayerJpegEncoder(int quality)
+    : m_quality(std::min(100, std::max(1, quality)))
+{}
+
+bool BayerJpegEncoder::IsSupported(peak::ipl::PixelFormatName inputPixelFormat)
+{
+    // The output format only matters for validation, any Bayer format Debayer accepts can be encoded
+    return Debayer::IsSupported(inputPixelFormat, peak::ipl::PixelFormatName::Mono8);
+}
+
+int BayerJpegEncoder::Quality() const
+{
+    return m_quality;
+}
+
+std::vector<uint8_t> BayerJpegEncoder::Encode(const peak::ipl::Image& bayerImage) const
+{
+    return Encode(
+        bayerImage.Data(), bayerImage.Width(), bayerImage.Height(), bayerImage.PixelFormat().PixelFormatName());
+}
+
+std::vector<uint8_t> BayerJpegEncoder::Encode(
+    const uint8_t* bayer, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat) const
+{
+    return EncodeRows(bayer, width, height, inputPixelFormat, 0, height);
+}
+
+std::vector<uint8_t> BayerJpegEncoder::EncodeRows(const uint8_t* bayer, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, size_t firstRow, size_t rowCount,
+    const StripObserver& observer) const
+{
+    if (!IsSupported(inputPixelFormat))
+    {
+        throw std::invalid_argument("BayerJpegEncoder: unsupported input pixel format");
+    }
+    if (firstRow % 2 != 0 || rowCount == 0 || firstRow + rowCount > height)
+    {
+        throw std::invalid_argument("BayerJpegEncoder: invalid row band");
+    }
+
+    // The debayer sees the full image, so the rows next to the band are interpolated as in a full frame encode
+    const StripSource debayerRows = [&](size_t y, size_t rows, Strip& strip) {
+        m_debayer.ConvertToYCbCr420(bayer, width, height, inputPixelFormat, firstRow + y, rows, strip.luma.data(),
+            strip.lumaStride, strip.cb.data(), strip.cr.data(), strip.chromaStride);
+    };
+
+    return encode(width, rowCount, m_quality, debayerRows, observer, firstRow);
+}
+
+std::vector<uint8_t> BayerJpegEncoder::EncodePlanes(const YCbCr420Planes& image, int quality)
+{
+    if (image.width == 0 || image.rows == 0)
+    {
+        throw std::invalid_argument("BayerJpegEncoder: empty planes");
+    }
+
+    const auto chromaWidth = (image.width + 1) / 2;
+    const StripSource copyRows = [&](size_t y, size_t rows, Strip& strip) {
+        for (size_t row = 0; row < rows; ++row)
+        {
+            std::memcpy(strip.luma.data() + row * strip.lumaStride, image.luma + (y + row) * image.lumaStride,
+                image.width);
+        }
+        const auto chromaY = y / 2;
+        const auto chromaRows = std::min((rows + 1) / 2, (image.rows + 1) / 2 - chromaY);
+        for (size_t row = 0; row < chromaRows; ++row)
+        {
+            std::memcpy(strip.cb.data() + row * strip.chromaStride, image.cb + (chromaY + row) * image.chromaStride,
+                chromaWidth);
+            std::memcpy(strip.cr.data() + row * strip.chromaStride, image.cr + (chromaY + row) * image.chromaStride,
+                chromaWidth);
+        }
+    };
+
+    return encode(image.width, image.rows, std::min(100, std::max(1, quality)), copyRows, StripObserver(), 0);
+}
+
+void BayerJpegEncoder::WriteFile(const std::string& path, const std::vector<uint8_t>& jpeg)
+{
+    auto* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    const auto written = std::fwrite(jpeg.data(), 1, jpeg.size(), file);
+    const auto closed = std::fclose(file);
+
+    if (written != jpeg.size() || closed != 0)
+    {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
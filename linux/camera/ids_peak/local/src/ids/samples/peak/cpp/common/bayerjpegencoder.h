@@ -0,0 +1,90 @@
+/*!
+ * \file    bayerjpegencoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BayerJpegEncoder class encodes an 8 bit Bayer image to JPEG
+ *          without an RGB intermediate. Strips of 16 rows are debayered
+ *          straight into YCbCr 4:2:0 planes and handed to the raw data
+ *          interface of libjpeg(-turbo), so the only full frame produced is
+ *          the compressed JPEG.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BAYERJPEGENCODER_H
+#define BAYERJPEGENCODER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "debayer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+/*!
+ * \brief Borrowed YCbCr 4:2:0 planes. The chroma planes are (width + 1) / 2 wide and (rows + 1) / 2 high.
+ */
+struct YCbCr420Planes
+{
+    const uint8_t* luma = nullptr;
+    size_t lumaStride = 0;
+    const uint8_t* cb = nullptr;
+    const uint8_t* cr = nullptr;
+    size_t chromaStride = 0;
+    size_t width = 0;
+    size_t rows = 0;
+};
+
+
+class BayerJpegEncoder
+{
+
+public:
+    // 75 is the default of peak::ipl::ImageWriter::JPEGParameter and of PIL
+    explicit BayerJpegEncoder(int quality = 75);
+
+    /*!
+     * \brief Called with every strip right after it is debayered, before it is compressed, e.g. to downscale the
+     *        frame on the way. \p firstRow is the strip's row in the image. The planes are padded to whole 16x16
+     *        macroblocks by replicating the last row and column, so reading one row or column past the strip is safe.
+     */
+    using StripObserver = std::function<void(size_t firstRow, const YCbCr420Planes& strip)>;
+
+    static bool IsSupported(peak::ipl::PixelFormatName inputPixelFormat);
+
+    int Quality() const;
+
+    /*! \brief Encodes a Bayer image, e.g. peak::BufferTo<peak::ipl::Image>(buffer), into an in-memory JPEG. */
+    std::vector<uint8_t> Encode(const peak::ipl::Image& bayerImage) const;
+
+    /*! \brief Encodes a raw, tightly packed Bayer image into an in-memory JPEG. */
+    std::vector<uint8_t> Encode(
+        const uint8_t* bayer, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat) const;
+
+    /*!
+     * \brief Encodes the \p rowCount rows from \p firstRow on as a JPEG of its own, \p rowCount rows high. Rows
+     *        outside the band are still used for interpolation, so a band decodes to exactly the pixels it has in
+     *        a full image encode when it starts on a multiple of 16 rows. \p firstRow must be even.
+     */
+    std::vector<uint8_t> EncodeRows(const uint8_t* bayer, size_t width, size_t height,
+        peak::ipl::PixelFormatName inputPixelFormat, size_t firstRow, size_t rowCount,
+        const StripObserver& observer = StripObserver()) const;
+
+    /*! \brief Encodes planes that are already YCbCr 4:2:0, e.g. a downscaled frame, into an in-memory JPEG. */
+    static std::vector<uint8_t> EncodePlanes(const YCbCr420Planes& image, int quality);
+
+    /*! \brief Writes an encoded JPEG to \p path. Throws std::runtime_error on failure. */
+    static void WriteFile(const std::string& path, const std::vector<uint8_t>& jpeg);
+
+private:
+    int m_quality;
+    Debayer m_debayer;
+};
+
+#endif // BAYERJPEGENCODER_H
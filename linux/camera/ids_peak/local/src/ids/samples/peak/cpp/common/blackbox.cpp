@@ -0,0 +1,442 @@
+/*!
+ * \file    blackbox.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BlackBox class keeps the most recent raw frames in a ring of
+ *          fixed memory, sized by a byte budget. On an event, e.g. a trigger,
+ *          a dropped frame or a failed validation, a dump thread writes the
+ *          frames from shortly before to shortly after the event to a
+ *          FrameJournal directory of their own, while the ring keeps
+ *          recording.
+ *
+ * \version 1.0.0
+ */
+
+#include "blackbox.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+
+const size_t BlackBox::MinimumSlots;
+
+
+namespace
+{
+
+// Record() notifies the dump thread without taking the mutex, so a wakeup may be missed. The dump thread polls at
+// this interval to bound the delay that causes.
+constexpr auto framePollInterval = std::chrono::milliseconds(20);
+
+// A dump ends this long after its window even if no frame newer than the window arrived, e.g. the camera stopped
+constexpr uint64_t windowGrace_ns = 1000000000ull;
+
+// Frames per segment file of a dump, so a short dump does not preallocate a large file
+constexpr uint64_t framesPerSegment = 16;
+
+uint64_t hostTime_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+uint64_t toNanoseconds(double seconds)
+{
+    return static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9);
+}
+
+// Reasons end up in directory names and JSON, anything but letters, digits, '-' and '_' is replaced
+std::string sanitize(const std::string& reason)
+{
+    std::string name = reason.substr(0, 32);
+    for (auto& c : name)
+    {
+        const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-'
+            || c == '_';
+        if (!allowed)
+        {
+            c = '_';
+        }
+    }
+    return name.empty() ? std::string("event") : name;
+}
+
+std::string dumpName(uint64_t time_ns, const std::string& reason)
+{
+    const auto seconds = static_cast<time_t>(time_ns / 1000000000ull);
+    struct tm local;
+    localtime_r(&seconds, &local);
+
+    char name[64];
+    const auto length = std::strftime(name, sizeof(name), "%Y%m%d_%H%M%S", &local);
+    std::snprintf(name + length, sizeof(name) - length, "_%03u",
+        static_cast<unsigned int>(time_ns / 1000000ull % 1000ull));
+    return std::string(name) + "_" + sanitize(reason);
+}
+
+} // namespace
+
+
+BlackBox::BlackBox(BlackBoxOptions options)
+    : m_options(std::move(options))
+{}
+
+BlackBox::~BlackBox()
+{
+    Stop();
+}
+
+void BlackBox::Start(size_t slotSize)
+{
+    Stop();
+
+    if (slotSize == 0 || m_options.budget_bytes / slotSize < MinimumSlots)
+    {
+        throw std::invalid_argument("The black box budget of " + std::to_string(m_options.budget_bytes >> 20)
+            + " MB holds fewer than " + std::to_string(MinimumSlots) + " frames of " + std::to_string(slotSize)
+            + " bytes");
+    }
+
+    if (::mkdir(m_options.directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("Failed to create " + m_options.directory + ": " + std::strerror(errno));
+    }
+
+    m_slotSize = slotSize;
+    m_slotCount = static_cast<size_t>(m_options.budget_bytes / slotSize);
+    m_slots.reset(new Slot[m_slotCount]);
+    // Value-initialized, so the whole budget is touched once here instead of page by page while recording
+    m_memory.reset(new uint8_t[m_slotCount * m_slotSize]());
+
+    m_recorded = 0;
+    m_lastFrameId = 0;
+    m_oversized = 0;
+    m_dumpedFrames = 0;
+    m_lostFrames = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = true;
+        m_dumping = false;
+        m_hasPending = false;
+        m_events = 0;
+        m_coalesced = 0;
+        m_dumps = 0;
+        m_failedDumps = 0;
+        m_lastDump.clear();
+    }
+
+    m_thread = std::thread(&BlackBox::run, this);
+}
+
+void BlackBox::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void BlackBox::Record(const std::shared_ptr<peak::core::Buffer>& buffer)
+{
+    if (m_slotCount == 0)
+    {
+        return;
+    }
+
+    auto entry = FrameJournalWriter::Describe(buffer);
+    if (entry.payloadSize > m_slotSize)
+    {
+        m_oversized++;
+        return;
+    }
+
+    const bool gap = m_lastFrameId != 0 && entry.frameId > m_lastFrameId + 1;
+    m_lastFrameId = entry.frameId;
+
+    // Seqlock: a reader that sees the same complete version before and after copying has a consistent frame
+    const auto sequence = m_recorded.load(std::memory_order_relaxed);
+    auto& slot = m_slots[sequence % m_slotCount];
+    slot.version.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.entry = entry;
+    std::memcpy(m_memory.get() + (sequence % m_slotCount) * m_slotSize, buffer->BasePtr(), entry.payloadSize);
+
+    slot.version.store(2 * sequence + 2, std::memory_order_release);
+    m_recorded.store(sequence + 1, std::memory_order_release);
+    m_condition.notify_one();
+
+    if (gap && m_options.dumpOnFrameGap)
+    {
+        Dump("frame_gap");
+    }
+}
+
+void BlackBox::Dump(const std::string& reason)
+{
+    const auto name = sanitize(reason);
+    const auto now = hostTime_ns();
+    const auto end = now + toNanoseconds(m_options.postEvent_s);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+
+        m_events++;
+        if (m_dumping && now <= m_active.end_ns)
+        {
+            m_active.end_ns = std::max(m_active.end_ns, end);
+            m_active.reasons += "," + name;
+            m_coalesced++;
+            return;
+        }
+        if (m_hasPending)
+        {
+            m_pending.end_ns = std::max(m_pending.end_ns, end);
+            m_pending.reasons += "," + name;
+            m_coalesced++;
+            return;
+        }
+
+        m_pending.reasons = name;
+        m_pending.time_ns = now;
+        m_pending.end_ns = end;
+        m_hasPending = true;
+    }
+    m_condition.notify_all();
+}
+
+BlackBoxCounters BlackBox::Counters() const
+{
+    BlackBoxCounters counters;
+    counters.recorded = m_recorded;
+    counters.oversized = m_oversized;
+    counters.slots = m_slotCount;
+    counters.dumpedFrames = m_dumpedFrames;
+    counters.lostFrames = m_lostFrames;
+
+    const auto recorded = counters.recorded;
+    if (m_slotCount > 0 && recorded >= 2)
+    {
+        const auto oldest = recorded > m_slotCount ? recorded - m_slotCount : 0;
+        FrameJournalEntry first;
+        FrameJournalEntry last;
+        // The oldest slot may just be overwritten, the next one then is the oldest
+        if ((readEntry(oldest, first) || readEntry(oldest + 1, first)) && readEntry(recorded - 1, last)
+            && last.hostTimestamp_ns > first.hostTimestamp_ns)
+        {
+            counters.span_s = static_cast<double>(last.hostTimestamp_ns - first.hostTimestamp_ns) / 1e9;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters.events = m_events;
+    counters.coalesced = m_coalesced;
+    counters.dumps = m_dumps;
+    counters.failedDumps = m_failedDumps;
+    counters.lastDump = m_lastDump;
+    return counters;
+}
+
+void BlackBox::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || m_hasPending; });
+        if (!m_hasPending)
+        {
+            break;
+        }
+
+        m_active = std::move(m_pending);
+        m_hasPending = false;
+        m_dumping = true;
+        const auto event = m_active;
+
+        lock.unlock();
+        dump(event);
+        lock.lock();
+
+        m_dumping = false;
+    }
+}
+
+void BlackBox::dump(Event event)
+{
+    const auto start_ns = event.time_ns - std::min(event.time_ns, toNanoseconds(m_options.preEvent_s));
+
+    // Walk back from the newest frame to the first one inside the pre-event window
+    const auto recorded = m_recorded.load(std::memory_order_acquire);
+    auto sequence = recorded;
+    while (sequence > 0 && recorded - sequence + 1 < m_slotCount)
+    {
+        FrameJournalEntry entry;
+        if (!readEntry(sequence - 1, entry) || entry.hostTimestamp_ns < start_ns)
+        {
+            break;
+        }
+        sequence--;
+    }
+
+    const auto directory = m_options.directory + "/" + dumpName(event.time_ns, event.reasons);
+    const auto firstSequence = sequence;
+    uint64_t frames = 0;
+    uint64_t lost = 0;
+
+    try
+    {
+        FrameJournalOptions journalOptions;
+        journalOptions.directory = directory;
+        journalOptions.segmentSize_bytes = framesPerSegment * m_slotSize;
+        // The dump thread may fall behind the ring, but never the camera
+        journalOptions.eagerWriteback = false;
+        FrameJournalWriter writer(journalOptions);
+
+        std::vector<uint8_t> payload(m_slotSize);
+        while (true)
+        {
+            uint64_t end_ns = 0;
+            bool running = true;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait_for(lock, framePollInterval, [&] {
+                    return !m_running || m_recorded.load(std::memory_order_acquire) > sequence;
+                });
+                end_ns = m_active.end_ns;
+                running = m_running;
+            }
+
+            const auto available = m_recorded.load(std::memory_order_acquire);
+            if (available <= sequence)
+            {
+                if (!running || hostTime_ns() > end_ns + windowGrace_ns)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            // Skip what the ring has overwritten already, the slot after the oldest is about to be
+            if (available - sequence >= m_slotCount)
+            {
+                const auto skipped = available - m_slotCount + 1 - sequence;
+                lost += skipped;
+                m_lostFrames += skipped;
+                sequence += skipped;
+            }
+
+            FrameJournalEntry entry;
+            if (!readFrame(sequence, entry, payload.data()))
+            {
+                lost++;
+                m_lostFrames++;
+                sequence++;
+                continue;
+            }
+
+            if (entry.hostTimestamp_ns > end_ns)
+            {
+                break;
+            }
+
+            if (writer.Append(entry, payload.data(), static_cast<size_t>(entry.payloadSize)))
+            {
+                frames++;
+                m_dumpedFrames++;
+            }
+            sequence++;
+        }
+
+        uint64_t end_ns = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            end_ns = m_active.end_ns;
+            event.reasons = m_active.reasons;
+        }
+
+        std::ofstream description(directory + "/event.json");
+        description << "{\"reasons\": \"" << event.reasons << "\", \"event_ns\": " << event.time_ns
+                    << ", \"window_start_ns\": " << start_ns << ", \"window_end_ns\": " << end_ns
+                    << ", \"first_sequence\": " << firstSequence << ", \"frames\": " << frames
+                    << ", \"lost\": " << lost << "}" << std::endl;
+        if (!description)
+        {
+            throw std::runtime_error("Failed to write " + directory + "/event.json");
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failedDumps++;
+        return;
+    }
+
+    std::cout << "Black box dump \"" << event.reasons << "\": " << frames << " frame(s), " << lost << " lost, in "
+              << directory << std::endl;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dumps++;
+    m_lastDump = directory;
+}
+
+bool BlackBox::readEntry(uint64_t sequence, FrameJournalEntry& entry) const
+{
+    const auto& slot = m_slots[sequence % m_slotCount];
+    const auto expected = 2 * sequence + 2;
+    if (slot.version.load(std::memory_order_acquire) != expected)
+    {
+        return false;
+    }
+
+    entry = slot.entry;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.version.load(std::memory_order_relaxed) == expected;
+}
+
+bool BlackBox::readFrame(uint64_t sequence, FrameJournalEntry& entry, uint8_t* payload) const
+{
+    const auto& slot = m_slots[sequence % m_slotCount];
+    const auto expected = 2 * sequence + 2;
+    if (slot.version.load(std::memory_order_acquire) != expected)
+    {
+        return false;
+    }
+
+    entry = slot.entry;
+    // A torn entry is detected below, its size must not overrun the slot before that
+    const auto size = std::min<uint64_t>(entry.payloadSize, m_slotSize);
+    std::memcpy(payload, m_memory.get() + (sequence % m_slotCount) * m_slotSize, static_cast<size_t>(size));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.version.load(std::memory_order_relaxed) == expected;
+}
@@ -0,0 +1,157 @@
+/*!
+ * \file    blackbox.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BlackBox class keeps the most recent raw frames in a ring of
+ *          fixed memory, sized by a byte budget. On an event, e.g. a trigger,
+ *          a dropped frame or a failed validation, a dump thread writes the
+ *          frames from shortly before to shortly after the event to a
+ *          FrameJournal directory of their own, while the ring keeps
+ *          recording.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include "framejournal.h"
+
+#include <peak/peak.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+struct BlackBoxOptions
+{
+    // Every dump is a FrameJournal directory below this one, named <YYYYmmdd_HHMMSS_mmm>_<reason>
+    std::string directory;
+    // Memory of the ring. It is divided into slots of the largest payload, so this bounds how far back it reaches.
+    uint64_t budget_bytes = 256ull << 20;
+    // Window dumped around an event, in host time
+    double preEvent_s = 5.0;
+    double postEvent_s = 2.0;
+    // Dump when the FrameID of a recorded frame skips ahead, i.e. the camera or the stream lost frames
+    bool dumpOnFrameGap = true;
+};
+
+
+/*!
+ * \brief Counters of a black box. All values are totals since Start(), except slots and span_s.
+ */
+struct BlackBoxCounters
+{
+    uint64_t recorded = 0;
+    // Frames not recorded because their payload did not fit into a slot
+    uint64_t oversized = 0;
+    size_t slots = 0;
+    // Host time between the oldest and the newest frame in the ring, i.e. the longest pre-event window available
+    double span_s = 0.0;
+    uint64_t events = 0;
+    // Events that extended a dump that was running or pending instead of starting another one
+    uint64_t coalesced = 0;
+    uint64_t dumps = 0;
+    uint64_t failedDumps = 0;
+    uint64_t dumpedFrames = 0;
+    // Frames of a dump window that were overwritten in the ring before the dump thread got to them
+    uint64_t lostFrames = 0;
+    // Directory of the last finished dump
+    std::string lastDump;
+};
+
+
+class BlackBox
+{
+
+public:
+    explicit BlackBox(BlackBoxOptions options);
+    ~BlackBox();
+
+    BlackBox(const BlackBox&) = delete;
+    BlackBox& operator=(const BlackBox&) = delete;
+
+    /*!
+     * \brief Allocates budget_bytes / \p slotSize slots of \p slotSize bytes and starts the dump thread. Throws if the
+     *        budget holds fewer than MinimumSlots.
+     */
+    void Start(size_t slotSize);
+
+    // Finishes a running dump with the frames already recorded, then joins the dump thread
+    void Stop();
+
+    /*!
+     * \brief Copies a finished buffer into the oldest slot. Called by the acquisition thread only, the buffer may be
+     *        requeued as soon as this returns. Never waits for a dump.
+     */
+    void Record(const std::shared_ptr<peak::core::Buffer>& buffer);
+
+    /*!
+     * \brief Requests a dump of the window around now and returns at once. Thread-safe. An event within the window of
+     *        a running or pending dump extends that dump to its own post-event window instead.
+     */
+    void Dump(const std::string& reason);
+
+    BlackBoxCounters Counters() const;
+
+    static const size_t MinimumSlots = 2;
+
+private:
+    struct Slot
+    {
+        // 2 * sequence + 1 while frame number sequence is copied in, 2 * sequence + 2 once it is complete
+        std::atomic<uint64_t> version{ 0 };
+        FrameJournalEntry entry;
+    };
+
+    struct Event
+    {
+        std::string reasons;
+        uint64_t time_ns = 0;
+        uint64_t end_ns = 0;
+    };
+
+    void run();
+    void dump(Event event);
+    bool readEntry(uint64_t sequence, FrameJournalEntry& entry) const;
+    bool readFrame(uint64_t sequence, FrameJournalEntry& entry, uint8_t* payload) const;
+
+    const BlackBoxOptions m_options;
+
+    size_t m_slotSize = 0;
+    size_t m_slotCount = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<uint8_t[]> m_memory;
+
+    // Number of frames recorded, the next one gets this sequence number. Written by the acquisition thread only.
+    std::atomic<uint64_t> m_recorded{ 0 };
+    uint64_t m_lastFrameId = 0;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = false;
+    bool m_dumping = false;
+    Event m_active;
+    bool m_hasPending = false;
+    Event m_pending;
+
+    std::atomic<uint64_t> m_oversized{ 0 };
+    std::atomic<uint64_t> m_dumpedFrames{ 0 };
+    std::atomic<uint64_t> m_lostFrames{ 0 };
+    uint64_t m_events = 0;
+    uint64_t m_coalesced = 0;
+    uint64_t m_dumps = 0;
+    uint64_t m_failedDumps = 0;
+    std::string m_lastDump;
+};
+
+#endif // BLACKBOX_H
@@ -0,0 +1,238 @@
+/*!
+ * \file    bufferpool.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BufferPool class allocates the image buffers of a data stream
+ *          itself: page aligned, optionally backed by 2 MB huge pages,
+ *          prefaulted and locked in RAM. The memory is announced through
+ *          DataStream::AnnounceBuffer and freed by the revocation callback.
+ *
+ * \version 1.0.0
+ */
+
+#include "bufferpool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+
+namespace
+{
+
+constexpr size_t hugePageSize = size_t{ 2 } << 20;
+
+size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t pageSize()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace
+
+
+size_t BufferPool::BufferCount(double frameRate, double worstCaseProcessing_ms, size_t minimumRequired)
+{
+    // Frames that arrive while the slowest frame is still held downstream, each needs its own buffer
+    const auto held = (frameRate > 0.0 && worstCaseProcessing_ms > 0.0)
+        ? static_cast<size_t>(std::ceil(frameRate * worstCaseProcessing_ms / 1000.0))
+        : size_t{ 0 };
+
+    return std::max<size_t>(minimumRequired, 1) + held;
+}
+
+BufferPool::BufferPool(std::shared_ptr<peak::core::DataStream> dataStream, BufferPoolOptions options)
+    : m_dataStream(std::move(dataStream))
+    , m_options(options)
+    , m_counters(std::make_shared<SharedCounters>())
+{}
+
+void BufferPool::Announce(size_t count, size_t payloadSize)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto allocation = allocate(payloadSize, m_options);
+        auto* memory = allocation->memory;
+
+        // The callback owns the allocation from here on. It must not touch the pool, which may be gone by then.
+        auto counters = m_counters;
+        auto* userPtr = allocation.get();
+        std::shared_ptr<peak::core::Buffer> buffer;
+        try
+        {
+            buffer = m_dataStream->AnnounceBuffer(memory, payloadSize, userPtr, [counters](void*, void* userPtr) {
+                release(static_cast<BufferAllocation*>(userPtr));
+                counters->revoked++;
+            });
+        }
+        catch (const std::exception&)
+        {
+            release(allocation.release());
+            throw;
+        }
+
+        m_counters->announced++;
+        m_counters->bytesPerBuffer = allocation->mappedSize;
+        if (allocation->hugePages)
+        {
+            m_counters->hugePageBuffers++;
+        }
+        if (allocation->locked)
+        {
+            m_counters->lockedBuffers++;
+        }
+
+        allocation.release();
+        m_buffers.push_back(std::move(buffer));
+    }
+}
+
+void BufferPool::QueueAll()
+{
+    for (const auto& buffer : m_buffers)
+    {
+        m_dataStream->QueueBuffer(buffer);
+    }
+}
+
+void BufferPool::RevokeAll()
+{
+    while (!m_buffers.empty())
+    {
+        m_dataStream->RevokeBuffer(m_buffers.back());
+        m_buffers.pop_back();
+    }
+}
+
+BufferPoolCounters BufferPool::Counters() const
+{
+    BufferPoolCounters counters;
+    counters.announced = m_counters->announced;
+    counters.revoked = m_counters->revoked;
+    counters.hugePageBuffers = m_counters->hugePageBuffers;
+    counters.lockedBuffers = m_counters->lockedBuffers;
+    counters.bytesPerBuffer = m_counters->bytesPerBuffer;
+    return counters;
+}
+
+std::unique_ptr<BufferAllocation> BufferPool::allocate(size_t size, const BufferPoolOptions& options)
+{
+    auto allocation = std::make_unique<BufferAllocation>();
+    allocation->size = size;
+
+#if defined(_WIN32)
+    allocation->mappedSize = roundUp(size, pageSize());
+    allocation->memory =
+        VirtualAlloc(nullptr, allocation->mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!allocation->memory)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Large pages need SeLockMemoryPrivilege on Windows, only locking is attempted
+    if (options.lockMemory)
+    {
+        allocation->locked = VirtualLock(allocation->memory, allocation->mappedSize) != 0;
+    }
+#else
+    void* memory = MAP_FAILED;
+
+    if (options.hugePages)
+    {
+        // Explicit huge pages are prefaulted by MAP_POPULATE and cannot be swapped
+        allocation->mappedSize = roundUp(size, hugePageSize);
+        memory = mmap(nullptr, allocation->mappedSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        allocation->hugePages = (memory != MAP_FAILED);
+
+        if (memory == MAP_FAILED)
+        {
+            // No huge pages reserved: ask for transparent huge pages and touch every page to prefault them
+            memory = mmap(nullptr, allocation->mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory != MAP_FAILED)
+            {
+#    if defined(MADV_HUGEPAGE)
+                madvise(memory, allocation->mappedSize, MADV_HUGEPAGE);
+#    endif
+                const auto step = pageSize();
+                for (size_t offset = 0; offset < allocation->mappedSize; offset += step)
+                {
+                    static_cast<volatile uint8_t*>(memory)[offset] = 0;
+                }
+            }
+        }
+    }
+    else
+    {
+        // Page aligned and prefaulted, so the first frame written into it does not take a page fault per 4 kB
+        allocation->mappedSize = roundUp(size, pageSize());
+        memory = mmap(nullptr, allocation->mappedSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    }
+
+    if (memory == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    allocation->memory = memory;
+
+    if (options.lockMemory)
+    {
+        allocation->locked = (mlock(memory, allocation->mappedSize) == 0);
+        if (!allocation->locked)
+        {
+            // Typically RLIMIT_MEMLOCK, see "ulimit -l". The buffer is still usable, it may just be paged out.
+            static std::atomic<bool> reported{ false };
+            if (!reported.exchange(true))
+            {
+                std::cout << "mlock of image buffers failed: " << std::strerror(errno) << std::endl;
+            }
+        }
+    }
+#endif
+
+    return allocation;
+}
+
+void BufferPool::release(BufferAllocation* allocation)
+{
+    if (!allocation)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    if (allocation->locked)
+    {
+        VirtualUnlock(allocation->memory, allocation->mappedSize);
+    }
+    VirtualFree(allocation->memory, 0, MEM_RELEASE);
+#else
+    // munmap also drops the lock
+    munmap(allocation->memory, allocation->mappedSize);
+#endif
+
+    delete allocation;
+}
@@ -0,0 +1,118 @@
+/*!
+ * \file    bufferpool.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BufferPool class allocates the image buffers of a data stream
+ *          itself: page aligned, optionally backed by 2 MB huge pages,
+ *          prefaulted and locked in RAM. The memory is announced through
+ *          DataStream::AnnounceBuffer and freed by the revocation callback.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <peak/peak.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+struct BufferPoolOptions
+{
+    // Back the buffers with 2 MB huge pages: explicit ones (vm.nr_hugepages) if available, transparent ones otherwise
+    bool hugePages = false;
+    // Lock the buffers in RAM with mlock, so they are never paged out. Needs a sufficient RLIMIT_MEMLOCK.
+    bool lockMemory = true;
+};
+
+
+/*!
+ * \brief Counters of a pool. Buffers revoked after the pool was destroyed are still counted by the callbacks.
+ */
+struct BufferPoolCounters
+{
+    size_t announced = 0;
+    size_t revoked = 0;
+    size_t hugePageBuffers = 0;
+    size_t lockedBuffers = 0;
+    // Bytes mapped per buffer, the payload size rounded up to the page size
+    size_t bytesPerBuffer = 0;
+};
+
+
+/*!
+ * \brief Describes the memory behind a pool buffer. Passed as the user pointer, so a stage holding a peak Buffer can
+ *        reference the camera memory without copying it.
+ */
+struct BufferAllocation
+{
+    void* memory = nullptr;
+    size_t size = 0;
+    size_t mappedSize = 0;
+    bool hugePages = false;
+    bool locked = false;
+};
+
+
+class BufferPool
+{
+
+public:
+    /*!
+     * \brief Number of buffers needed so that frames arriving at \p frameRate never find the input pool empty, when a
+     *        frame may be held for up to \p worstCaseProcessing_ms. \p minimumRequired is the producer's minimum,
+     *        NumBuffersAnnouncedMinRequired().
+     */
+    static size_t BufferCount(double frameRate, double worstCaseProcessing_ms, size_t minimumRequired);
+
+    BufferPool(std::shared_ptr<peak::core::DataStream> dataStream, BufferPoolOptions options);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /*!
+     * \brief Allocates and announces \p count buffers of \p payloadSize bytes. Throws if the memory cannot be
+     *        allocated; huge pages and memory locking fall back silently and are reported by Counters().
+     */
+    void Announce(size_t count, size_t payloadSize);
+
+    // Queues every buffer announced by this pool
+    void QueueAll();
+
+    /*!
+     * \brief Revokes every buffer announced by this pool. The acquisition must be stopped and the buffers flushed.
+     *        The memory is freed by the revocation callbacks.
+     */
+    void RevokeAll();
+
+    BufferPoolCounters Counters() const;
+
+private:
+    struct SharedCounters
+    {
+        std::atomic<size_t> announced{ 0 };
+        std::atomic<size_t> revoked{ 0 };
+        std::atomic<size_t> hugePageBuffers{ 0 };
+        std::atomic<size_t> lockedBuffers{ 0 };
+        std::atomic<size_t> bytesPerBuffer{ 0 };
+    };
+
+    static std::unique_ptr<BufferAllocation> allocate(size_t size, const BufferPoolOptions& options);
+    static void release(BufferAllocation* allocation);
+
+    std::shared_ptr<peak::core::DataStream> m_dataStream;
+    BufferPoolOptions m_options;
+    std::vector<std::shared_ptr<peak::core::Buffer>> m_buffers;
+
+    // Shared with the revocation callbacks, which may run after the pool is gone
+    std::shared_ptr<SharedCounters> m_counters;
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,252 @@
+/*!
+ * \file    buffertuner.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BufferTuner class sizes the announced buffer set of a data
+ *          stream from its loss counters and input pool depth. It grows the
+ *          set when frames are lost for lack of a buffer and gives memory
+ *          back after a long loss-free stretch with spare buffers.
+ *
+ * \version 1.0.0
+ */
+
+#include "buffertuner.h"
+
+#include <algorithm>
+#include <sstream>
+
+
+namespace
+{
+
+// Increment of a cumulative counter, which restarts from 0 when the acquisition is restarted
+uint64_t increment(uint64_t previous, uint64_t current)
+{
+    return current >= previous ? current - previous : current;
+}
+
+uint64_t readCounter(const std::shared_ptr<peak::core::NodeMap>& nodeMap, const std::string& name)
+{
+    try
+    {
+        if (nodeMap->HasNode(name))
+        {
+            return static_cast<uint64_t>(nodeMap->FindNode<peak::core::nodes::IntegerNode>(name)->Value());
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Not readable in the current state
+    }
+
+    return 0;
+}
+
+} // namespace
+
+
+BufferTuner::BufferTuner(BufferTunerOptions options)
+    : m_options(options)
+{
+    m_options.minimumBuffers = std::max<size_t>(m_options.minimumBuffers, 1);
+    resetWindow();
+}
+
+void BufferTuner::Observe(const BufferTunerSample& sample)
+{
+    if (m_havePrevious)
+    {
+        m_window.incomplete += increment(m_previous.incomplete, sample.incomplete);
+        m_window.dropped += increment(m_previous.dropped, sample.dropped);
+        m_window.lost += increment(m_previous.lost, sample.lost);
+        m_window.underruns += increment(m_previous.underruns, sample.underruns);
+    }
+
+    m_lowestQueued = std::min(m_lowestQueued, sample.queued);
+    m_previous = sample;
+    m_havePrevious = true;
+}
+
+bool BufferTuner::WindowElapsed() const
+{
+    return std::chrono::steady_clock::now() - m_windowStart >= m_options.window;
+}
+
+BufferTunerDecision BufferTuner::Decide(size_t announced)
+{
+    BufferTunerDecision decision;
+    decision.from = announced;
+    decision.to = announced;
+    decision.incomplete = m_window.incomplete;
+    decision.dropped = m_window.dropped;
+    decision.lost = m_window.lost;
+    decision.underruns = m_window.underruns;
+    decision.lowestQueued = m_lowestQueued == SIZE_MAX ? 0 : m_lowestQueued;
+
+    const auto maximum = MaximumBuffers();
+    // Lost frames and underruns may count the same event twice
+    const auto losses = std::max(m_window.lost, m_window.underruns);
+    const bool sampled = m_lowestQueued != SIZE_MAX;
+
+    std::ostringstream reason;
+
+    if (announced > maximum)
+    {
+        decision.action = BufferTunerAction::Shrink;
+        decision.to = maximum;
+        reason << "over the limit of " << maximum << " buffers";
+    }
+    else if (losses > 0)
+    {
+        m_lossFloor = std::max(m_lossFloor, announced);
+        m_cleanWindows = 0;
+
+        // Grow by half the set: a burst that outlasted the set needs a proportionally larger one
+        decision.to = std::min(maximum, announced + std::max<size_t>(2, announced / 2));
+        decision.action = decision.to > announced ? BufferTunerAction::Grow : BufferTunerAction::Keep;
+        reason << losses << " frame(s) lost for lack of a buffer";
+        if (decision.action == BufferTunerAction::Keep)
+        {
+            reason << ", already at the limit of " << maximum << " buffers";
+        }
+    }
+    else if (sampled && m_lowestQueued == 0)
+    {
+        // The input pool ran empty without a loss yet, one more buffer of headroom
+        m_cleanWindows = 0;
+        decision.to = std::min(maximum, announced + 1);
+        decision.action = decision.to > announced ? BufferTunerAction::Grow : BufferTunerAction::Keep;
+        reason << "input pool ran empty";
+    }
+    else if (sampled && m_lowestQueued > m_options.spareBuffers)
+    {
+        if (++m_cleanWindows >= m_options.cleanWindowsToShrink)
+        {
+            m_cleanWindows = 0;
+
+            // Give back half the surplus at a time, never down to a count that has lost frames before. A floor above
+            // the announced count, e.g. after the set was lowered to fit the memory budget, keeps it: idle buffers
+            // are no reason to grow.
+            const auto surplus = std::max<size_t>(1, (m_lowestQueued - m_options.spareBuffers) / 2);
+            const auto floor = std::max(m_options.minimumBuffers, m_lossFloor + 1);
+            decision.to =
+                std::min(announced, std::max(floor, announced > surplus ? announced - surplus : size_t{ 0 }));
+            decision.action = decision.to < announced ? BufferTunerAction::Shrink : BufferTunerAction::Keep;
+            reason << "at least " << m_lowestQueued << " buffers idle for " << m_options.cleanWindowsToShrink
+                   << " windows";
+        }
+        else
+        {
+            reason << "no loss";
+        }
+    }
+    else
+    {
+        m_cleanWindows = 0;
+        reason << "no loss";
+    }
+
+    if (decision.dropped > 0 || decision.incomplete > 0)
+    {
+        reason << "; " << decision.dropped << " dropped and " << decision.incomplete
+               << " incomplete frame(s) are camera or interface limits, not buffer related";
+    }
+
+    std::ostringstream text;
+    switch (decision.action)
+    {
+    case BufferTunerAction::Grow:
+        text << "grow " << decision.from << " -> " << decision.to << " buffers: ";
+        break;
+    case BufferTunerAction::Shrink:
+        text << "shrink " << decision.from << " -> " << decision.to << " buffers: ";
+        break;
+    default:
+        text << "keep " << decision.from << " buffers: ";
+        break;
+    }
+    decision.reason = text.str() + reason.str();
+
+    resetWindow();
+    return decision;
+}
+
+void BufferTuner::Restart()
+{
+    m_havePrevious = false;
+    resetWindow();
+}
+
+size_t BufferTuner::MaximumBuffers() const
+{
+    auto maximum = m_options.maximumBuffers;
+    if (m_options.memoryBudget_bytes > 0 && m_options.payloadSize > 0)
+    {
+        maximum = std::min(maximum, m_options.memoryBudget_bytes / m_options.payloadSize);
+    }
+
+    return std::max(maximum, m_options.minimumBuffers);
+}
+
+BufferTunerSample BufferTuner::ReadSample(const std::shared_ptr<peak::core::DataStream>& dataStream)
+{
+    BufferTunerSample sample;
+
+    const auto nodeMap = dataStream->NodeMaps().at(0);
+    sample.incomplete = readCounter(nodeMap, "StreamIncompleteFrameCount");
+    sample.dropped = readCounter(nodeMap, "StreamDroppedFrameCount");
+    sample.lost = readCounter(nodeMap, "StreamLostFrameCount");
+
+    try
+    {
+        sample.underruns = dataStream->NumUnderruns();
+        sample.queued = dataStream->NumBuffersQueued();
+    }
+    catch (const std::exception&)
+    {
+        // Stream info not provided by the producer
+    }
+
+    return sample;
+}
+
+void BufferTuner::ApplyBufferCount(
+    const std::shared_ptr<peak::core::DataStream>& dataStream, size_t count, size_t payloadSize)
+{
+    auto nodemapRemoteDevice = dataStream->ParentDevice()->RemoteDevice()->NodeMaps().at(0);
+
+    nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->Execute();
+    nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->WaitUntilDone();
+    dataStream->StopAcquisition(peak::core::AcquisitionStopMode::Default);
+
+    // All buffers leave the input pool and the output queue, so any of them may be revoked
+    dataStream->Flush(peak::core::DataStreamFlushMode::DiscardAll);
+
+    auto buffers = dataStream->AnnouncedBuffers();
+    while (buffers.size() > count)
+    {
+        dataStream->RevokeBuffer(buffers.back());
+        buffers.pop_back();
+    }
+    while (buffers.size() < count)
+    {
+        buffers.push_back(dataStream->AllocAndAnnounceBuffer(payloadSize, nullptr));
+    }
+
+    for (const auto& buffer : buffers)
+    {
+        dataStream->QueueBuffer(buffer);
+    }
+
+    dataStream->StartAcquisition();
+    nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->Execute();
+}
+
+void BufferTuner::resetWindow()
+{
+    m_window = BufferTunerSample();
+    m_lowestQueued = SIZE_MAX;
+    m_windowStart = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,149 @@
+/*!
+ * \file    buffertuner.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The BufferTuner class sizes the announced buffer set of a data
+ *          stream from its loss counters and input pool depth. It grows the
+ *          set when frames are lost for lack of a buffer and gives memory
+ *          back after a long loss-free stretch with spare buffers.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef BUFFERTUNER_H
+#define BUFFERTUNER_H
+
+#include <peak/peak.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+struct BufferTunerOptions
+{
+    // Never announce fewer buffers, at least NumBuffersAnnouncedMinRequired()
+    size_t minimumBuffers = 1;
+    // Never announce more buffers
+    size_t maximumBuffers = 64;
+    // Upper bound for all buffers together, 0 for none. Needs payloadSize.
+    size_t memoryBudget_bytes = 0;
+    size_t payloadSize = 0;
+    // Decisions are taken once per window
+    std::chrono::milliseconds window{ 2000 };
+    // Consecutive loss-free windows with spare buffers before the set is shrunk
+    unsigned int cleanWindowsToShrink = 15;
+    // Free buffers to keep in the input pool at its lowest point when shrinking
+    size_t spareBuffers = 2;
+};
+
+
+/*!
+ * \brief Snapshot of the stream counters. The loss counters are the cumulative values of the data stream nodes,
+ *        queued is the input pool depth when the sample was taken.
+ */
+struct BufferTunerSample
+{
+    // Missing packets on the interface (StreamIncompleteFrameCount)
+    uint64_t incomplete = 0;
+    // Camera buffer overrun, sensor data too fast for the interface (StreamDroppedFrameCount)
+    uint64_t dropped = 0;
+    // User buffer overrun, no free buffer for a frame (StreamLostFrameCount)
+    uint64_t lost = 0;
+    // Frames the producer could not deliver for lack of a queued buffer (NumUnderruns)
+    uint64_t underruns = 0;
+    // Buffers in the input pool (NumBuffersQueued)
+    size_t queued = 0;
+};
+
+
+enum class BufferTunerAction
+{
+    Keep,
+    Grow,
+    Shrink
+};
+
+
+struct BufferTunerDecision
+{
+    BufferTunerAction action = BufferTunerAction::Keep;
+    size_t from = 0;
+    size_t to = 0;
+
+    // Counter increments within the window
+    uint64_t incomplete = 0;
+    uint64_t dropped = 0;
+    uint64_t lost = 0;
+    uint64_t underruns = 0;
+    // Lowest input pool depth seen within the window
+    size_t lowestQueued = 0;
+
+    // Human readable summary, e.g. "grow 6 -> 9 buffers: 4 lost frames"
+    std::string reason;
+};
+
+
+/*!
+ * \brief Decides the buffer count of one data stream.
+ *
+ * Observe() is called by the acquisition loop for every frame, Decide() once WindowElapsed(). Applying a decision is
+ * left to the caller, typically with ApplyBufferCount() between two acquisitions. Not thread-safe, owned by the
+ * acquisition thread.
+ *
+ * Only lost frames and underruns are caused by too few buffers. Dropped and incomplete frames are reported, but do
+ * not change the buffer count: they originate in the camera and on the interface.
+ */
+class BufferTuner
+{
+
+public:
+    explicit BufferTuner(BufferTunerOptions options);
+
+    void Observe(const BufferTunerSample& sample);
+
+    bool WindowElapsed() const;
+
+    // Ends the window and returns the buffer count for the next one
+    BufferTunerDecision Decide(size_t announced);
+
+    // To be called after the acquisition was restarted, the stream counters may have been reset
+    void Restart();
+
+    // maximumBuffers, lowered to fit the memory budget
+    size_t MaximumBuffers() const;
+
+    // Reads the counters of \p dataStream. Nodes the producer does not provide read as 0.
+    static BufferTunerSample ReadSample(const std::shared_ptr<peak::core::DataStream>& dataStream);
+
+    /*!
+     * \brief Stops the acquisition of the device and the data stream, announces or revokes producer allocated
+     *        buffers of \p payloadSize bytes until \p count are announced, queues all of them and restarts the
+     *        acquisition. Frames waiting in the output queue are discarded. The caller must not hold a buffer.
+     */
+    static void ApplyBufferCount(
+        const std::shared_ptr<peak::core::DataStream>& dataStream, size_t count, size_t payloadSize);
+
+private:
+    void resetWindow();
+
+    BufferTunerOptions m_options;
+
+    bool m_havePrevious = false;
+    BufferTunerSample m_previous;
+
+    // Increments and lowest pool depth of the current window
+    BufferTunerSample m_window;
+    size_t m_lowestQueued = SIZE_MAX;
+    std::chrono::steady_clock::time_point m_windowStart;
+
+    unsigned int m_cleanWindows = 0;
+    // Highest count at which frames were lost, shrinking stays above it
+    size_t m_lossFloor = 0;
+};
+
+#endif // BUFFERTUNER_H
@@ -0,0 +1,366 @@
+/*!
+ * \file    conversionpool.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ConversionPool class runs one ImageConverter per worker thread,
+ *          so that full resolution debayering can use more than one core.
+ *          Converted frames are released in submission (FrameID) order
+ *          through a bounded reorder window.
+ *
+ * \version 1.0.0
+ */
+
+#include "conversionpool.h"
+
+#include <peak/converters/peak_buffer_converter_ipl.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+
+ConversionPool::ConversionPool(size_t threadCount, size_t reorderWindow, Sink sink, Release release)
+    : m_threadCount(std::max<size_t>(threadCount, 1))
+    , m_reorderWindow(std::max<size_t>(reorderWindow, m_threadCount))
+    , m_sink(std::move(sink))
+    , m_release(std::move(release))
+    , m_slots(m_reorderWindow)
+{}
+
+ConversionPool::~ConversionPool()
+{
+    Stop();
+}
+
+void ConversionPool::SetUseDebayer(bool useDebayer)
+{
+    m_useDebayer = useDebayer;
+}
+
+void ConversionPool::SetJpegEncoding(bool encodeJpeg, int quality, size_t stripThreads)
+{
+    m_encodeJpeg = encodeJpeg;
+    m_jpegEncoder = BayerJpegEncoder(quality);
+    m_jpegStripThreads = std::max<size_t>(stripThreads, 1);
+}
+
+void ConversionPool::SetJpegOutputs(std::vector<JpegOutput> outputs)
+{
+    m_jpegOutputs = std::move(outputs);
+}
+
+void ConversionPool::SetBarcodeDecoding(bool decodeBarcodes, BarcodeDecoderOptions options, Debayer::Region region)
+{
+    m_decodeBarcodes = decodeBarcodes;
+    m_barcodeOptions = std::move(options);
+    m_barcodeRegion = region;
+}
+
+void ConversionPool::SetLatencyRecorder(LatencyRecorder* recorder)
+{
+    m_latency = recorder;
+}
+
+void ConversionPool::Start(peak::ipl::PixelFormatName inputPixelFormat,
+    peak::ipl::PixelFormatName outputPixelFormat, size_t width, size_t height)
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    m_inputPixelFormat = inputPixelFormat;
+    m_outputPixelFormat = outputPixelFormat;
+    m_jpegActive = m_encodeJpeg && BayerJpegEncoder::IsSupported(inputPixelFormat);
+    m_debayerActive = !m_jpegActive && m_useDebayer && Debayer::IsSupported(inputPixelFormat, outputPixelFormat);
+
+    m_width = width;
+    m_height = height;
+
+    // The window holds at most every image in flight plus the one currently in the sink. All workers convert into
+    // one pool of that size, so no conversion allocates after this point. Images still held by a previous sink keep
+    // their old pool alive until they are released.
+    const size_t imageCount = m_reorderWindow + 1;
+    m_imagePool.reset();
+    if (!m_jpegActive)
+    {
+        const auto imageSize =
+            width * height * peak::ipl::PixelFormat(outputPixelFormat).NumStorageBitsPerPixel() / 8;
+        m_imagePool = std::make_unique<ImagePool>(imageCount, imageSize);
+    }
+
+    // Created once per Start(), a stopped pool leaves the strip threads of the previous run idle. The multi-size
+    // encoder brings its own strip encoder.
+    m_multiSizeEncoder.reset();
+    if (m_jpegActive && !m_jpegOutputs.empty())
+    {
+        m_multiSizeEncoder =
+            std::make_unique<MultiSizeJpegEncoder>(m_jpegOutputs, m_jpegStripThreads, m_jpegEncoder.Quality());
+        m_stripEncoder.reset();
+    }
+    else if (m_jpegActive && m_jpegStripThreads > 1)
+    {
+        if (!m_stripEncoder || m_stripEncoder->ThreadCount() != m_jpegStripThreads
+            || m_stripEncoder->Quality() != m_jpegEncoder.Quality())
+        {
+            m_stripEncoder = std::make_unique<StripJpegEncoder>(m_jpegStripThreads, m_jpegEncoder.Quality());
+        }
+    }
+    else
+    {
+        m_stripEncoder.reset();
+    }
+
+    m_imageConverters.clear();
+    m_barcodeDecoders.clear();
+    for (size_t i = 0; i < m_threadCount; ++i)
+    {
+        m_imageConverters.push_back(std::make_unique<peak::ipl::ImageConverter>());
+        if (m_decodeBarcodes && FrameBarcodeDecoder::IsSupported(inputPixelFormat))
+        {
+            m_barcodeDecoders.push_back(
+                std::make_unique<FrameBarcodeDecoder>(m_barcodeOptions, m_barcodeRegion, m_latency));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nextSubmit = 0;
+        m_nextRelease = 0;
+        m_running = true;
+    }
+    m_converted = 0;
+    m_failed = 0;
+
+    for (size_t i = 0; i < m_threadCount; ++i)
+    {
+        m_threads.emplace_back(&ConversionPool::run, this, i);
+    }
+}
+
+void ConversionPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_jobCondition.notify_all();
+    m_windowCondition.notify_all();
+
+    // Workers finish the jobs already queued, so every submitted buffer is released exactly once
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+bool ConversionPool::Submit(Frame frame, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    const auto hasRoom = m_windowCondition.wait_for(lock, timeout,
+        [this] { return !m_running || (m_nextSubmit - m_nextRelease) < m_reorderWindow; });
+    if (!hasRoom || !m_running)
+    {
+        return false;
+    }
+
+    Job job;
+    job.sequence = m_nextSubmit++;
+    job.frame = std::move(frame);
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+
+    m_jobCondition.notify_one();
+    return true;
+}
+
+size_t ConversionPool::ThreadCount() const
+{
+    return m_threadCount;
+}
+
+size_t ConversionPool::ReorderWindow() const
+{
+    return m_reorderWindow;
+}
+
+ConversionPoolCounters ConversionPool::Counters() const
+{
+    ConversionPoolCounters counters;
+    counters.converted = m_converted;
+    counters.failed = m_failed;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters.submitted = m_nextSubmit;
+    counters.inFlight = static_cast<size_t>(m_nextSubmit - m_nextRelease);
+    return counters;
+}
+
+void ConversionPool::run(size_t workerIndex)
+{
+    auto& imageConverter = *m_imageConverters.at(workerIndex);
+    auto* barcodeDecoder = m_barcodeDecoders.empty() ? nullptr : m_barcodeDecoders.at(workerIndex).get();
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobCondition.wait(lock, [this] { return !m_running || !m_jobs.empty(); });
+            if (m_jobs.empty())
+            {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        ConvertedFrame converted;
+        converted.frameId = job.frame.frameId;
+        converted.timestamp_ns = job.frame.timestamp_ns;
+        converted.trigger = job.frame.trigger;
+
+        try
+        {
+            // Reads the camera buffer alongside the conversion below, which only has to wait for it if the decode
+            // takes longer
+            if (barcodeDecoder && !job.frame.buffer->IsIncomplete())
+            {
+                barcodeDecoder->Begin(static_cast<const uint8_t*>(job.frame.buffer->BasePtr()), m_width, m_height,
+                    m_inputPixelFormat);
+            }
+
+            if (job.frame.buffer->IsIncomplete())
+            {
+                converted.error = "Incomplete frame";
+            }
+            else if (m_jpegActive)
+            {
+                LatencyRecorder::Scope timing(m_latency, LatencyStage::Encode);
+                const auto input = peak::BufferTo<peak::ipl::Image>(job.frame.buffer);
+                if (m_multiSizeEncoder)
+                {
+                    converted.jpeg = m_multiSizeEncoder->Encode(input, converted.scaled);
+                }
+                else
+                {
+                    converted.jpeg = m_stripEncoder ? m_stripEncoder->Encode(input) : m_jpegEncoder.Encode(input);
+                }
+            }
+            else
+            {
+                // The image is converted into pool memory, so the camera buffer is free as soon as this returns. The
+                // pool only runs dry if the sink holds on to frames, the image is allocated then.
+                LatencyRecorder::Scope timing(m_latency, LatencyStage::Convert);
+                const auto input = peak::BufferTo<peak::ipl::Image>(job.frame.buffer);
+                converted.imageMemory = m_imagePool->TryAcquire();
+                auto* output = converted.imageMemory.Data();
+                const auto outputSize = converted.imageMemory.Size();
+
+                if (m_debayerActive && output)
+                {
+                    m_debayer.Convert(input, m_outputPixelFormat, output, outputSize);
+                    converted.image = peak::ipl::Image(peak::ipl::PixelFormat(m_outputPixelFormat), output,
+                        outputSize, m_width, m_height, converted.timestamp_ns);
+                }
+                else if (m_debayerActive)
+                {
+                    converted.image = m_debayer.Convert(input, m_outputPixelFormat);
+                }
+                else if (output)
+                {
+                    converted.image = imageConverter.Convert(input, m_outputPixelFormat, output, outputSize);
+                }
+                else
+                {
+                    converted.image = imageConverter.Convert(input, m_outputPixelFormat);
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            converted.error = e.what();
+        }
+
+        // The decoder must be done with the buffer before it is queued again
+        if (barcodeDecoder)
+        {
+            converted.barcodes = barcodeDecoder->Finish();
+        }
+
+        try
+        {
+            LatencyRecorder::Scope timing(m_latency, LatencyStage::Requeue);
+            m_release(job.frame.buffer);
+        }
+        catch (const std::exception& e)
+        {
+            if (converted.error.empty())
+            {
+                converted.error = e.what();
+            }
+        }
+        job.frame.buffer.reset();
+
+        if (converted.error.empty())
+        {
+            m_converted++;
+        }
+        else
+        {
+            m_failed++;
+        }
+
+        complete(job.sequence, std::move(converted));
+    }
+}
+
+void ConversionPool::complete(uint64_t sequence, ConvertedFrame frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& slot = m_slots[sequence % m_reorderWindow];
+        slot.frame = std::move(frame);
+        slot.ready = true;
+    }
+
+    // Drain every frame that is now in order. Whoever holds the sink mutex drains for all workers, a worker that
+    // finishes out of order simply leaves its frame in the window.
+    std::lock_guard<std::mutex> sinkLock(m_sinkMutex);
+    while (true)
+    {
+        ConvertedFrame next;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& slot = m_slots[m_nextRelease % m_reorderWindow];
+            if (!slot.ready)
+            {
+                break;
+            }
+
+            next = std::move(slot.frame);
+            slot.frame = ConvertedFrame();
+            slot.ready = false;
+            m_nextRelease++;
+        }
+        m_windowCondition.notify_one();
+
+        try
+        {
+            m_sink(next);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+}
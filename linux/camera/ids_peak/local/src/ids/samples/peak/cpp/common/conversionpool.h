@@ -0,0 +1,214 @@
+/*!
+ * \file    conversionpool.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ConversionPool class runs one ImageConverter per worker thread,
+ *          so that full resolution debayering can use more than one core.
+ *          Converted frames are released in submission (FrameID) order
+ *          through a bounded reorder window.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef CONVERSIONPOOL_H
+#define CONVERSIONPOOL_H
+
+#include <peak/peak.hpp>
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "bayerjpegencoder.h"
+#include "debayer.h"
+#include "framebarcodedecoder.h"
+#include "framering.h"
+#include "imagepool.h"
+#include "latencyhistogram.h"
+#include "multisizejpegencoder.h"
+#include "stripjpegencoder.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/*!
+ * \brief A converted frame. The camera buffer has already been released when the frame reaches the sink.
+ *
+ * With JPEG encoding active, \p jpeg holds the encoded frame and \p image stays empty. \p scaled holds the smaller
+ * JPEG outputs, if any, encoded from the same debayer pass. \p barcodes holds the barcodes read from the frame while
+ * it was converted, if barcode decoding is enabled.
+ */
+struct ConvertedFrame
+{
+    uint64_t frameId = 0;
+    uint64_t timestamp_ns = 0;
+    // Frame::trigger of the submitted frame
+    uint64_t trigger = 0;
+    // Pool memory behind \p image, declared first so that it is released after the image
+    ImageLease imageMemory;
+    peak::ipl::Image image;
+    std::vector<uint8_t> jpeg;
+    std::vector<ScaledJpeg> scaled;
+    std::vector<DecodedBarcode> barcodes;
+    std::string error;
+};
+
+
+/*!
+ * \brief Counters of a pool. All values are totals since Start().
+ */
+struct ConversionPoolCounters
+{
+    uint64_t submitted = 0;
+    uint64_t converted = 0;
+    uint64_t failed = 0;
+    size_t inFlight = 0;
+};
+
+
+class ConversionPool
+{
+
+public:
+    // Called for each converted frame in submission order, never concurrently
+    using Sink = std::function<void(ConvertedFrame& frame)>;
+    // Called from a worker thread as soon as the buffer is no longer needed, e.g. to queue it again
+    using Release = std::function<void(const std::shared_ptr<peak::core::Buffer>& buffer)>;
+
+    /*!
+     * \param threadCount Number of worker threads, each with its own ImageConverter
+     * \param reorderWindow Maximum number of frames between Submit() and the sink
+     */
+    ConversionPool(size_t threadCount, size_t reorderWindow, Sink sink, Release release);
+    ~ConversionPool();
+
+    ConversionPool(const ConversionPool&) = delete;
+    ConversionPool& operator=(const ConversionPool&) = delete;
+
+    /*!
+     * \brief Converts supported Bayer formats with the in-tree Debayer kernels instead of the IDS peak IPL.
+     *        Takes effect on the next Start(). Unsupported formats keep using the IPL.
+     */
+    void SetUseDebayer(bool useDebayer);
+
+    /*!
+     * \brief Encodes Bayer frames straight to JPEG with BayerJpegEncoder instead of converting them.
+     *        Takes effect on the next Start(). Other input formats are still converted.
+     *
+     * With \p stripThreads > 1 every frame is encoded in strips on that many threads by a StripJpegEncoder shared by
+     * all workers, so the encode latency of a single frame drops as well as the time per frame.
+     */
+    void SetJpegEncoding(bool encodeJpeg, int quality = 75, size_t stripThreads = 1);
+
+    /*!
+     * \brief Encodes every JPEG frame at the size of each of \p outputs as well, e.g. a thumbnail and a preview,
+     *        with a MultiSizeJpegEncoder. The frame is only debayered once. Empty for the full size only.
+     *        Takes effect on the next Start().
+     */
+    void SetJpegOutputs(std::vector<JpegOutput> outputs);
+
+    /*!
+     * \brief Decodes the barcodes of every frame with a FrameBarcodeDecoder per worker, next to its conversion or
+     *        encode, so the barcodes are ready with the frame. \p region limits the search to part of the sensor,
+     *        empty for the whole frame. Takes effect on the next Start(), unsupported input formats are not decoded.
+     */
+    void SetBarcodeDecoding(bool decodeBarcodes, BarcodeDecoderOptions options = BarcodeDecoderOptions(),
+        Debayer::Region region = Debayer::Region());
+
+    /*!
+     * \brief Records the convert, encode, barcode and requeue time of every frame in \p recorder, which must outlive
+     *        the pool. Null disables the instrumentation. Takes effect on the next Start().
+     */
+    void SetLatencyRecorder(LatencyRecorder* recorder);
+
+    void Start(peak::ipl::PixelFormatName inputPixelFormat, peak::ipl::PixelFormatName outputPixelFormat,
+        size_t width, size_t height);
+    void Stop();
+
+    /*!
+     * \brief Submits a frame for conversion. Frames must be submitted in FrameID order, i.e. in the order the data
+     *        stream finished them.
+     *
+     * Waits up to \p timeout while the reorder window is full. Returns false if the frame was not accepted, the
+     * caller still owns the buffer in that case.
+     */
+    bool Submit(Frame frame, std::chrono::milliseconds timeout);
+
+    size_t ThreadCount() const;
+    size_t ReorderWindow() const;
+    ConversionPoolCounters Counters() const;
+
+private:
+    struct Slot
+    {
+        bool ready = false;
+        ConvertedFrame frame;
+    };
+
+    struct Job
+    {
+        uint64_t sequence = 0;
+        Frame frame;
+    };
+
+    void run(size_t workerIndex);
+    void complete(uint64_t sequence, ConvertedFrame frame);
+
+    const size_t m_threadCount;
+    const size_t m_reorderWindow;
+    Sink m_sink;
+    Release m_release;
+
+    peak::ipl::PixelFormatName m_outputPixelFormat = peak::ipl::PixelFormatName::BGRa8;
+    std::vector<std::unique_ptr<peak::ipl::ImageConverter>> m_imageConverters;
+    bool m_useDebayer = false;
+    bool m_debayerActive = false;
+    Debayer m_debayer;
+    bool m_encodeJpeg = false;
+    bool m_jpegActive = false;
+    BayerJpegEncoder m_jpegEncoder;
+    size_t m_jpegStripThreads = 1;
+    std::unique_ptr<StripJpegEncoder> m_stripEncoder;
+    std::vector<JpegOutput> m_jpegOutputs;
+    std::unique_ptr<MultiSizeJpegEncoder> m_multiSizeEncoder;
+    bool m_decodeBarcodes = false;
+    BarcodeDecoderOptions m_barcodeOptions;
+    Debayer::Region m_barcodeRegion;
+    // One per worker while barcode decoding is active, empty otherwise
+    std::vector<std::unique_ptr<FrameBarcodeDecoder>> m_barcodeDecoders;
+    peak::ipl::PixelFormatName m_inputPixelFormat = peak::ipl::PixelFormatName::Mono8;
+    LatencyRecorder* m_latency = nullptr;
+    // Output images, shared by all workers and recycled once the sink is done with a frame
+    std::unique_ptr<ImagePool> m_imagePool;
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<std::thread> m_threads;
+
+    bool m_running = false;
+
+    // Protects the job queue, the reorder slots and the sequence numbers
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobCondition;
+    std::condition_variable m_windowCondition;
+    std::deque<Job> m_jobs;
+    std::vector<Slot> m_slots;
+    uint64_t m_nextSubmit = 0;
+    uint64_t m_nextRelease = 0;
+
+    // Serializes the sink, so frames leave the pool in order even if several workers drain the window
+    std::mutex m_sinkMutex;
+
+    std::atomic<uint64_t> m_converted{ 0 };
+    std::atomic<uint64_t> m_failed{ 0 };
+};
+
+#endif // CONVERSIONPOOL_H
@@ -0,0 +1,943 @@
+/*!
+ * \file    debayer.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The Debayer class converts 8 bit Bayer images to BGRa8, RGB8 or
+ *          Mono8 with bilinear interpolation. Kernels exist for AVX2, SSE4.1
+ *          and plain C++, the fastest one supported by the CPU is selected at
+ *          runtime. It can be used in place of peak::ipl::ImageConverter for
+ *          these formats.
+ *
+ * \version 1.0.0
+ */
+
+#include "debayer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define DEBAYER_X86
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#        include <intrin.h>
+// MSVC emits any intrinsic without per-function target flags
+#        define DEBAYER_TARGET(isa)
+#    else
+#        define DEBAYER_TARGET(isa) __attribute__((target(isa)))
+#    endif
+#endif
+
+
+namespace
+{
+
+// Bayer pattern of the input, described by the position of the red pixel in the 2x2 cell. Blue is on the other row
+// and the other column.
+struct BayerLayout
+{
+    size_t redRowParity;
+    size_t redColumnParity;
+};
+
+// One output row, computed from the Bayer rows above, at and below it. Border rows and columns are mirrored, which
+// keeps the Bayer phase intact.
+struct RowJob
+{
+    const uint8_t* up;
+    const uint8_t* center;
+    const uint8_t* down;
+    size_t width;
+    // Column parity of the pixels that carry the row's own colour (red in a red row, blue in a blue row)
+    size_t colorColumn;
+    bool blueRow;
+    uint8_t* r;
+    uint8_t* g;
+    uint8_t* b;
+};
+
+enum class OutputFormat
+{
+    BGRa8,
+    RGB8,
+    Mono8
+};
+
+using PlaneRowFunction = void (*)(const RowJob& job);
+using PackRowFunction = void (*)(
+    const uint8_t* r, const uint8_t* g, const uint8_t* b, size_t width, OutputFormat format, uint8_t* output);
+
+// All kernels are defined in terms of this rounding average, so every instruction set produces identical output
+inline uint8_t average(uint8_t a, uint8_t b)
+{
+    return static_cast<uint8_t>((a + b + 1) >> 1);
+}
+
+// BT.601 luma weights scaled to 256
+inline uint8_t luma(uint8_t r, uint8_t g, uint8_t b)
+{
+    return static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+bool bayerLayout(peak::ipl::PixelFormatName pixelFormat, BayerLayout& layout)
+{
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BayerRG8:
+        layout = { 0, 0 };
+        return true;
+    case peak::ipl::PixelFormatName::BayerGR8:
+        layout = { 0, 1 };
+        return true;
+    case peak::ipl::PixelFormatName::BayerBG8:
+        layout = { 1, 1 };
+        return true;
+    case peak::ipl::PixelFormatName::BayerGB8:
+        layout = { 1, 0 };
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool outputFormat(peak::ipl::PixelFormatName pixelFormat, OutputFormat& format, size_t& bytesPerPixel)
+{
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BGRa8:
+        format = OutputFormat::BGRa8;
+        bytesPerPixel = 4;
+        return true;
+    case peak::ipl::PixelFormatName::RGB8:
+        format = OutputFormat::RGB8;
+        bytesPerPixel = 3;
+        return true;
+    case peak::ipl::PixelFormatName::Mono8:
+        format = OutputFormat::Mono8;
+        bytesPerPixel = 1;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void planeRowRangeScalar(const RowJob& job, size_t begin, size_t end)
+{
+    const auto last = job.width - 1;
+
+    for (size_t x = begin; x < end; ++x)
+    {
+        const auto left = (x == 0) ? 1 : x - 1;
+        const auto right = (x == last) ? last - 1 : x + 1;
+
+        const auto h = average(job.center[left], job.center[right]);
+        const auto v = average(job.up[x], job.down[x]);
+
+        uint8_t own = 0;
+        uint8_t green = 0;
+        uint8_t other = 0;
+
+        if ((x & 1) == job.colorColumn)
+        {
+            own = job.center[x];
+            green = average(h, v);
+            other = average(average(job.up[left], job.up[right]), average(job.down[left], job.down[right]));
+        }
+        else
+        {
+            own = h;
+            green = job.center[x];
+            other = v;
+        }
+
+        job.r[x] = job.blueRow ? other : own;
+        job.g[x] = green;
+        job.b[x] = job.blueRow ? own : other;
+    }
+}
+
+void planeRowScalar(const RowJob& job)
+{
+    planeRowRangeScalar(job, 0, job.width);
+}
+
+void packRowRangeScalar(const uint8_t* r, const uint8_t* g, const uint8_t* b, size_t begin, size_t end,
+    OutputFormat format, uint8_t* output)
+{
+    switch (format)
+    {
+    case OutputFormat::BGRa8:
+        for (size_t x = begin; x < end; ++x)
+        {
+            output[4 * x + 0] = b[x];
+            output[4 * x + 1] = g[x];
+            output[4 * x + 2] = r[x];
+            output[4 * x + 3] = 0xFF;
+        }
+        break;
+    case OutputFormat::RGB8:
+        for (size_t x = begin; x < end; ++x)
+        {
+            output[3 * x + 0] = r[x];
+            output[3 * x + 1] = g[x];
+            output[3 * x + 2] = b[x];
+        }
+        break;
+    case OutputFormat::Mono8:
+        for (size_t x = begin; x < end; ++x)
+        {
+            output[x] = luma(r[x], g[x], b[x]);
+        }
+        break;
+    }
+}
+
+void packRowScalar(
+    const uint8_t* r, const uint8_t* g, const uint8_t* b, size_t width, OutputFormat format, uint8_t* output)
+{
+    packRowRangeScalar(r, g, b, 0, width, format, output);
+}
+
+#ifdef DEBAYER_X86
+
+// Byte shuffles interleaving 16 pixels of three planes into 48 bytes of RGB8. Index [i][c] selects the bytes of
+// channel c that go to output block i, 0x80 leaves a byte zero.
+struct RGB8Shuffles
+{
+    uint8_t masks[3][3][16];
+
+    RGB8Shuffles()
+    {
+        for (size_t block = 0; block < 3; ++block)
+        {
+            for (size_t channel = 0; channel < 3; ++channel)
+            {
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    const auto byte = block * 16 + i;
+                    masks[block][channel][i] =
+                        (byte % 3 == channel) ? static_cast<uint8_t>(byte / 3) : static_cast<uint8_t>(0x80);
+                }
+            }
+        }
+    }
+};
+
+const RGB8Shuffles& rgb8Shuffles()
+{
+    static const RGB8Shuffles shuffles;
+    return shuffles;
+}
+
+DEBAYER_TARGET("sse4.1")
+void planeRowSse41(const RowJob& job)
+{
+    constexpr size_t lanes = 16;
+
+    // The vector loop starts at column 1, so lane i is at an even column for odd i
+    const auto mask = _mm_set1_epi16(static_cast<short>(job.colorColumn == 0 ? 0xFF00 : 0x00FF));
+
+    size_t x = 1;
+    for (; x + lanes + 1 <= job.width; x += lanes)
+    {
+        const auto centerLeft = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.center + x - 1));
+        const auto center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.center + x));
+        const auto centerRight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.center + x + 1));
+        const auto upLeft = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.up + x - 1));
+        const auto up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.up + x));
+        const auto upRight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.up + x + 1));
+        const auto downLeft = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.down + x - 1));
+        const auto down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.down + x));
+        const auto downRight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.down + x + 1));
+
+        const auto h = _mm_avg_epu8(centerLeft, centerRight);
+        const auto v = _mm_avg_epu8(up, down);
+        const auto cross = _mm_avg_epu8(h, v);
+        const auto diagonal = _mm_avg_epu8(_mm_avg_epu8(upLeft, upRight), _mm_avg_epu8(downLeft, downRight));
+
+        const auto own = _mm_blendv_epi8(h, center, mask);
+        const auto green = _mm_blendv_epi8(center, cross, mask);
+        const auto other = _mm_blendv_epi8(v, diagonal, mask);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(job.r + x), job.blueRow ? other : own);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(job.g + x), green);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(job.b + x), job.blueRow ? own : other);
+    }
+
+    planeRowRangeScalar(job, 0, 1);
+    planeRowRangeScalar(job, x, job.width);
+}
+
+DEBAYER_TARGET("avx2")
+void planeRowAvx2(const RowJob& job)
+{
+    constexpr size_t lanes = 32;
+
+    // The vector loop starts at column 1, so lane i is at an even column for odd i
+    const auto mask = _mm256_set1_epi16(static_cast<short>(job.colorColumn == 0 ? 0xFF00 : 0x00FF));
+
+    size_t x = 1;
+    for (; x + lanes + 1 <= job.width; x += lanes)
+    {
+        const auto centerLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.center + x - 1));
+        const auto center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.center + x));
+        const auto centerRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.center + x + 1));
+        const auto upLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.up + x - 1));
+        const auto up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.up + x));
+        const auto upRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.up + x + 1));
+        const auto downLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.down + x - 1));
+        const auto down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.down + x));
+        const auto downRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(job.down + x + 1));
+
+        const auto h = _mm256_avg_epu8(centerLeft, centerRight);
+        const auto v = _mm256_avg_epu8(up, down);
+        const auto cross = _mm256_avg_epu8(h, v);
+        const auto diagonal =
+            _mm256_avg_epu8(_mm256_avg_epu8(upLeft, upRight), _mm256_avg_epu8(downLeft, downRight));
+
+        const auto own = _mm256_blendv_epi8(h, center, mask);
+        const auto green = _mm256_blendv_epi8(center, cross, mask);
+        const auto other = _mm256_blendv_epi8(v, diagonal, mask);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.r + x), job.blueRow ? other : own);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.g + x), green);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.b + x), job.blueRow ? own : other);
+    }
+
+    planeRowRangeScalar(job, 0, 1);
+    planeRowRangeScalar(job, x, job.width);
+}
+
+// Luma of the lower 8 pixels as 16 bit lanes. The weighted sum is at most 65408 and is shifted as unsigned, so 16 bit
+// lanes are sufficient.
+DEBAYER_TARGET("sse4.1")
+inline __m128i lumaSse41(__m128i red, __m128i green, __m128i blue)
+{
+    auto sum = _mm_mullo_epi16(_mm_cvtepu8_epi16(red), _mm_set1_epi16(77));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_cvtepu8_epi16(green), _mm_set1_epi16(150)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_cvtepu8_epi16(blue), _mm_set1_epi16(29)));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+}
+
+// Packing is bound by memory bandwidth, so the AVX2 path uses it as well
+DEBAYER_TARGET("sse4.1")
+void packRowSse41(
+    const uint8_t* r, const uint8_t* g, const uint8_t* b, size_t width, OutputFormat format, uint8_t* output)
+{
+    constexpr size_t lanes = 16;
+    size_t x = 0;
+
+    switch (format)
+    {
+    case OutputFormat::BGRa8: {
+        const auto alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; x + lanes <= width; x += lanes)
+        {
+            const auto blue = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+            const auto green = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + x));
+            const auto red = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + x));
+
+            const auto blueGreenLow = _mm_unpacklo_epi8(blue, green);
+            const auto blueGreenHigh = _mm_unpackhi_epi8(blue, green);
+            const auto redAlphaLow = _mm_unpacklo_epi8(red, alpha);
+            const auto redAlphaHigh = _mm_unpackhi_epi8(red, alpha);
+
+            auto* destination = reinterpret_cast<__m128i*>(output + 4 * x);
+            _mm_storeu_si128(destination + 0, _mm_unpacklo_epi16(blueGreenLow, redAlphaLow));
+            _mm_storeu_si128(destination + 1, _mm_unpackhi_epi16(blueGreenLow, redAlphaLow));
+            _mm_storeu_si128(destination + 2, _mm_unpacklo_epi16(blueGreenHigh, redAlphaHigh));
+            _mm_storeu_si128(destination + 3, _mm_unpackhi_epi16(blueGreenHigh, redAlphaHigh));
+        }
+        break;
+    }
+    case OutputFormat::RGB8: {
+        const auto& shuffles = rgb8Shuffles();
+        for (; x + lanes <= width; x += lanes)
+        {
+            const __m128i channels[3] = { _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + x)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + x)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x)) };
+
+            auto* destination = reinterpret_cast<__m128i*>(output + 3 * x);
+            for (size_t block = 0; block < 3; ++block)
+            {
+                auto interleaved = _mm_setzero_si128();
+                for (size_t channel = 0; channel < 3; ++channel)
+                {
+                    const auto mask =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffles.masks[block][channel]));
+                    interleaved = _mm_or_si128(interleaved, _mm_shuffle_epi8(channels[channel], mask));
+                }
+                _mm_storeu_si128(destination + block, interleaved);
+            }
+        }
+        break;
+    }
+    case OutputFormat::Mono8: {
+        for (; x + lanes <= width; x += lanes)
+        {
+            const auto red = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + x));
+            const auto green = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + x));
+            const auto blue = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+
+            const auto low = lumaSse41(red, green, blue);
+            const auto high =
+                lumaSse41(_mm_srli_si128(red, 8), _mm_srli_si128(green, 8), _mm_srli_si128(blue, 8));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), _mm_packus_epi16(low, high));
+        }
+        break;
+    }
+    }
+
+    packRowRangeScalar(r, g, b, x, width, format, output);
+}
+
+bool cpuSupports(Debayer::Isa isa)
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    __cpuidex(info, 7, 0);
+    const bool avx2Instructions = (info[1] & (1 << 5)) != 0;
+    // The OS must save the YMM registers on context switches
+    const bool avx2 = avx2Instructions && avx && osxsave && ((_xgetbv(0) & 0x6) == 0x6);
+#    else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#    endif
+
+    switch (isa)
+    {
+    case Debayer::Isa::Scalar:
+        return true;
+    case Debayer::Isa::SSE41:
+        return sse41;
+    case Debayer::Isa::AVX2:
+        return avx2 && sse41;
+    }
+    return false;
+}
+
+#else
+
+bool cpuSupports(Debayer::Isa isa)
+{
+    return isa == Debayer::Isa::Scalar;
+}
+
+#endif // DEBAYER_X86
+
+PlaneRowFunction planeRowFunction(Debayer::Isa isa)
+{
+#ifdef DEBAYER_X86
+    switch (isa)
+    {
+    case Debayer::Isa::AVX2:
+        return planeRowAvx2;
+    case Debayer::Isa::SSE41:
+        return planeRowSse41;
+    case Debayer::Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    return planeRowScalar;
+}
+
+PackRowFunction packRowFunction(Debayer::Isa isa)
+{
+#ifdef DEBAYER_X86
+    if (isa != Debayer::Isa::Scalar)
+    {
+        return packRowSse41;
+    }
+#else
+    (void)isa;
+#endif
+    return packRowScalar;
+}
+
+void prepareRow(RowJob& job, const BayerLayout& layout, const uint8_t* input, size_t stride, size_t height, size_t y)
+{
+    const auto yUp = (y == 0) ? 1 : y - 1;
+    const auto yDown = (y == height - 1) ? height - 2 : y + 1;
+
+    const bool redRow = (y & 1) == layout.redRowParity;
+
+    job.up = input + yUp * stride;
+    job.center = input + y * stride;
+    job.down = input + yDown * stride;
+    job.blueRow = !redRow;
+    job.colorColumn = redRow ? layout.redColumnParity : 1 - layout.redColumnParity;
+}
+
+// JFIF Cb/Cr of the mean colour of a 2x2 block, \p sumX is the sum of up to four samples and \p count their number
+inline void chroma(int sumR, int sumG, int sumB, int count, uint8_t& cb, uint8_t& cr)
+{
+    const auto r = (sumR + count / 2) / count;
+    const auto g = (sumG + count / 2) / count;
+    const auto b = (sumB + count / 2) / count;
+
+    // Offset by 128 << 8 before shifting, so the shift never sees a negative value. Pure blue and pure red reach
+    // 256 and are clamped, the cast would wrap them to 0.
+    cb = static_cast<uint8_t>(std::min((-43 * r - 85 * g + 128 * b + (128 << 8) + 128) >> 8, 255));
+    cr = static_cast<uint8_t>(std::min((128 * r - 107 * g - 21 * b + (128 << 8) + 128) >> 8, 255));
+}
+
+// Cb/Cr of the 2x2 blocks of \p rows (1 or 2) rows of colour planes, \p width pixels wide
+void chromaRow(const uint8_t* const r[2], const uint8_t* const g[2], const uint8_t* const b[2], size_t rows,
+    size_t width, uint8_t* cb, uint8_t* cr)
+{
+    for (size_t x = 0; x < width; x += 2)
+    {
+        const size_t columns = std::min<size_t>(2, width - x);
+
+        int sumR = 0;
+        int sumG = 0;
+        int sumB = 0;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            for (size_t j = 0; j < columns; ++j)
+            {
+                sumR += r[i][x + j];
+                sumG += g[i][x + j];
+                sumB += b[i][x + j];
+            }
+        }
+
+        chroma(sumR, sumG, sumB, static_cast<int>(rows * columns), cb[x / 2], cr[x / 2]);
+    }
+}
+
+// Demosaics \p width x \p height pixels whose rows are \p inputStride bytes apart
+void convertRows(Debayer::Isa isa, const uint8_t* input, size_t width, size_t height, size_t inputStride,
+    const BayerLayout& layout, OutputFormat format, uint8_t* output, size_t outputStride)
+{
+    const auto planeRow = planeRowFunction(isa);
+    const auto packRow = packRowFunction(isa);
+
+    // One row of each colour plane, kept in L1 between interpolation and packing
+    std::vector<uint8_t> planes(3 * width);
+
+    RowJob job;
+    job.width = width;
+    job.r = planes.data();
+    job.g = planes.data() + width;
+    job.b = planes.data() + 2 * width;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        prepareRow(job, layout, input, inputStride, height, y);
+        planeRow(job);
+        packRow(job.r, job.g, job.b, width, format, output + y * outputStride);
+    }
+}
+
+// Which Bayer cells every output pixel of a scaled conversion is taken from, see Debayer::ConvertScaled
+struct ScaledSampling
+{
+    const uint8_t* input = nullptr;
+    size_t inputStride = 0;
+    size_t cellRows = 0;
+    size_t outputWidth = 0;
+    size_t outputHeight = 0;
+
+    // Cells sampled per output pixel and axis: the centre one, or the ones at a quarter and three quarters of the
+    // pixel's footprint when it covers at least 2 cells
+    size_t samplesX = 1;
+    size_t samplesY = 1;
+
+    // Byte offset of the sampled cells of every output column, computed once instead of per row
+    std::vector<size_t> columnOffsets;
+
+    // Offsets of the colours inside a cell, relative to its top left pixel
+    size_t redOffset = 0;
+    size_t blueOffset = 0;
+    size_t green1Offset = 0;
+    size_t green2Offset = 0;
+};
+
+// Samples \p width x \p height pixels whose rows are \p inputStride bytes apart
+ScaledSampling scaledSampling(const uint8_t* input, size_t width, size_t height, size_t inputStride,
+    const BayerLayout& layout, size_t outputWidth, size_t outputHeight)
+{
+    ScaledSampling sampling;
+    sampling.input = input;
+    sampling.inputStride = inputStride;
+    sampling.cellRows = height / 2;
+    sampling.outputWidth = outputWidth;
+    sampling.outputHeight = outputHeight;
+
+    const size_t cellColumns = width / 2;
+    sampling.samplesX = cellColumns >= 2 * outputWidth ? 2 : 1;
+    sampling.samplesY = sampling.cellRows >= 2 * outputHeight ? 2 : 1;
+
+    sampling.columnOffsets.resize(outputWidth * sampling.samplesX);
+    for (size_t x = 0; x < outputWidth; ++x)
+    {
+        for (size_t s = 0; s < sampling.samplesX; ++s)
+        {
+            const size_t fraction = 2 * sampling.samplesX;
+            const size_t cell = ((fraction * x + 2 * s + 1) * cellColumns) / (fraction * outputWidth);
+            sampling.columnOffsets[x * sampling.samplesX + s] = 2 * cell;
+        }
+    }
+
+    sampling.redOffset = layout.redRowParity * inputStride + layout.redColumnParity;
+    sampling.blueOffset = (1 - layout.redRowParity) * inputStride + (1 - layout.redColumnParity);
+    sampling.green1Offset = layout.redRowParity * inputStride + (1 - layout.redColumnParity);
+    sampling.green2Offset = (1 - layout.redRowParity) * inputStride + layout.redColumnParity;
+    return sampling;
+}
+
+// Fills one row of each colour plane with output row \p y
+void scaledRow(const ScaledSampling& sampling, size_t y, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+    const uint8_t* rows[2];
+    for (size_t s = 0; s < sampling.samplesY; ++s)
+    {
+        const size_t fraction = 2 * sampling.samplesY;
+        const size_t cell = ((fraction * y + 2 * s + 1) * sampling.cellRows) / (fraction * sampling.outputHeight);
+        rows[s] = sampling.input + 2 * cell * sampling.inputStride;
+    }
+
+    const unsigned int samples = static_cast<unsigned int>(sampling.samplesX * sampling.samplesY);
+    const unsigned int half = samples / 2;
+
+    for (size_t x = 0; x < sampling.outputWidth; ++x)
+    {
+        unsigned int sumR = 0;
+        unsigned int sumG = 0;
+        unsigned int sumB = 0;
+        for (size_t sy = 0; sy < sampling.samplesY; ++sy)
+        {
+            for (size_t sx = 0; sx < sampling.samplesX; ++sx)
+            {
+                const auto* cell = rows[sy] + sampling.columnOffsets[x * sampling.samplesX + sx];
+                sumR += cell[sampling.redOffset];
+                sumB += cell[sampling.blueOffset];
+                sumG += average(cell[sampling.green1Offset], cell[sampling.green2Offset]);
+            }
+        }
+
+        r[x] = static_cast<uint8_t>((sumR + half) / samples);
+        g[x] = static_cast<uint8_t>((sumG + half) / samples);
+        b[x] = static_cast<uint8_t>((sumB + half) / samples);
+    }
+}
+
+// Scales \p width x \p height pixels whose rows are \p inputStride bytes apart, see Debayer::ConvertScaled
+void convertScaledRows(Debayer::Isa isa, const uint8_t* input, size_t width, size_t height, size_t inputStride,
+    const BayerLayout& layout, OutputFormat format, uint8_t* output, size_t outputWidth, size_t outputHeight,
+    size_t outputStride)
+{
+    const auto sampling = scaledSampling(input, width, height, inputStride, layout, outputWidth, outputHeight);
+    const auto packRow = packRowFunction(isa);
+
+    std::vector<uint8_t> planes(3 * outputWidth);
+    auto* r = planes.data();
+    auto* g = planes.data() + outputWidth;
+    auto* b = planes.data() + 2 * outputWidth;
+
+    for (size_t y = 0; y < outputHeight; ++y)
+    {
+        scaledRow(sampling, y, r, g, b);
+        packRow(r, g, b, outputWidth, format, output + y * outputStride);
+    }
+}
+
+} // namespace
+
+
+Debayer::Debayer()
+    : m_isa(BestIsa())
+{}
+
+Debayer::Debayer(Isa isa)
+    : m_isa(cpuSupports(isa) ? isa : BestIsa())
+{}
+
+bool Debayer::IsSupported(
+    peak::ipl::PixelFormatName inputPixelFormat, peak::ipl::PixelFormatName outputPixelFormat)
+{
+    BayerLayout layout;
+    OutputFormat format;
+    size_t bytesPerPixel = 0;
+    return bayerLayout(inputPixelFormat, layout) && outputFormat(outputPixelFormat, format, bytesPerPixel);
+}
+
+Debayer::Isa Debayer::BestIsa()
+{
+    static const Isa best = cpuSupports(Isa::AVX2) ? Isa::AVX2
+                                                   : (cpuSupports(Isa::SSE41) ? Isa::SSE41 : Isa::Scalar);
+    return best;
+}
+
+std::vector<Debayer::Isa> Debayer::AvailableIsas()
+{
+    std::vector<Isa> isas;
+    for (const auto isa : { Isa::Scalar, Isa::SSE41, Isa::AVX2 })
+    {
+        if (cpuSupports(isa))
+        {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
+
+const char* Debayer::IsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::SSE41:
+        return "sse4.1";
+    case Isa::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+Debayer::Isa Debayer::SelectedIsa() const
+{
+    return m_isa;
+}
+
+peak::ipl::Image Debayer::Convert(
+    const peak::ipl::Image& inputImage, peak::ipl::PixelFormatName outputPixelFormat) const
+{
+    peak::ipl::Image outputImage(
+        peak::ipl::PixelFormat(outputPixelFormat), inputImage.Width(), inputImage.Height(), inputImage.Timestamp());
+    Convert(inputImage, outputPixelFormat, outputImage.Data(), outputImage.ByteCount());
+    return outputImage;
+}
+
+void Debayer::Convert(const peak::ipl::Image& inputImage, peak::ipl::PixelFormatName outputPixelFormat,
+    uint8_t* outputBuffer, size_t outputBufferSize) const
+{
+    OutputFormat format;
+    size_t bytesPerPixel = 0;
+    if (!outputFormat(outputPixelFormat, format, bytesPerPixel))
+    {
+        throw std::invalid_argument("Debayer: unsupported output pixel format");
+    }
+
+    const auto outputStride = inputImage.Width() * bytesPerPixel;
+    if (outputBufferSize < outputStride * inputImage.Height())
+    {
+        throw std::invalid_argument("Debayer: output buffer is too small");
+    }
+
+    Convert(inputImage.Data(), inputImage.Width(), inputImage.Height(),
+        inputImage.PixelFormat().PixelFormatName(), outputBuffer, outputStride, outputPixelFormat);
+}
+
+void Debayer::Convert(const uint8_t* input, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, uint8_t* output, size_t outputStride,
+    peak::ipl::PixelFormatName outputPixelFormat) const
+{
+    BayerLayout layout;
+    if (!bayerLayout(inputPixelFormat, layout))
+    {
+        throw std::invalid_argument("Debayer: unsupported input pixel format");
+    }
+
+    OutputFormat format;
+    size_t bytesPerPixel = 0;
+    if (!outputFormat(outputPixelFormat, format, bytesPerPixel))
+    {
+        throw std::invalid_argument("Debayer: unsupported output pixel format");
+    }
+
+    if (width < 2 || height < 2)
+    {
+        throw std::invalid_argument(
+            "Debayer: image size " + std::to_string(width) + "x" + std::to_string(height) + " is too small");
+    }
+
+    convertRows(m_isa, input, width, height, width, layout, format, output, outputStride);
+}
+
+void Debayer::ConvertScaled(const uint8_t* input, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, uint8_t* output, size_t outputWidth, size_t outputHeight,
+    size_t outputStride, peak::ipl::PixelFormatName outputPixelFormat) const
+{
+    BayerLayout layout;
+    if (!bayerLayout(inputPixelFormat, layout))
+    {
+        throw std::invalid_argument("Debayer: unsupported input pixel format");
+    }
+
+    OutputFormat format;
+    size_t bytesPerPixel = 0;
+    if (!outputFormat(outputPixelFormat, format, bytesPerPixel))
+    {
+        throw std::invalid_argument("Debayer: unsupported output pixel format");
+    }
+
+    const size_t cellColumns = width / 2;
+    const size_t cellRows = height / 2;
+    if (outputWidth == 0 || outputHeight == 0 || outputWidth > cellColumns || outputHeight > cellRows)
+    {
+        throw std::invalid_argument("Debayer: scaled size " + std::to_string(outputWidth) + "x"
+            + std::to_string(outputHeight) + " is not within half of " + std::to_string(width) + "x"
+            + std::to_string(height));
+    }
+
+    convertScaledRows(
+        m_isa, input, width, height, width, layout, format, output, outputWidth, outputHeight, outputStride);
+}
+
+void Debayer::ConvertRegion(const uint8_t* input, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, const Region& region, uint8_t* output, size_t outputWidth,
+    size_t outputHeight, size_t outputStride, peak::ipl::PixelFormatName outputPixelFormat) const
+{
+    BayerLayout layout;
+    if (!bayerLayout(inputPixelFormat, layout))
+    {
+        throw std::invalid_argument("Debayer: unsupported input pixel format");
+    }
+
+    OutputFormat format;
+    size_t bytesPerPixel = 0;
+    if (!outputFormat(outputPixelFormat, format, bytesPerPixel))
+    {
+        throw std::invalid_argument("Debayer: unsupported output pixel format");
+    }
+
+    if (region.width < 2 || region.height < 2 || region.x + region.width > width || region.y + region.height > height)
+    {
+        throw std::invalid_argument("Debayer: region " + std::to_string(region.width) + "x"
+            + std::to_string(region.height) + "+" + std::to_string(region.x) + "+" + std::to_string(region.y)
+            + " does not lie inside " + std::to_string(width) + "x" + std::to_string(height));
+    }
+
+    // Seen from an odd offset, red sits in the other row or column of the cell
+    layout.redRowParity = (layout.redRowParity + region.y) & 1;
+    layout.redColumnParity = (layout.redColumnParity + region.x) & 1;
+
+    const auto* regionInput = input + region.y * width + region.x;
+
+    if (outputWidth == region.width && outputHeight == region.height)
+    {
+        convertRows(m_isa, regionInput, region.width, region.height, width, layout, format, output, outputStride);
+        return;
+    }
+
+    if (outputWidth == 0 || outputHeight == 0 || outputWidth > region.width / 2 || outputHeight > region.height / 2)
+    {
+        throw std::invalid_argument("Debayer: scaled size " + std::to_string(outputWidth) + "x"
+            + std::to_string(outputHeight) + " is neither the region size nor within half of it");
+    }
+
+    convertScaledRows(m_isa, regionInput, region.width, region.height, width, layout, format, output, outputWidth,
+        outputHeight, outputStride);
+}
+
+void Debayer::ConvertToYCbCr420(const uint8_t* input, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, size_t firstRow, size_t rowCount, uint8_t* luma,
+    size_t lumaStride, uint8_t* cb, uint8_t* cr, size_t chromaStride) const
+{
+    BayerLayout layout;
+    if (!bayerLayout(inputPixelFormat, layout))
+    {
+        throw std::invalid_argument("Debayer: unsupported input pixel format");
+    }
+
+    if (width < 2 || height < 2)
+    {
+        throw std::invalid_argument(
+            "Debayer: image size " + std::to_string(width) + "x" + std::to_string(height) + " is too small");
+    }
+
+    if ((firstRow & 1) != 0 || firstRow + rowCount > height)
+    {
+        throw std::invalid_argument("Debayer: row range must start on an even row and lie inside the image");
+    }
+
+    const auto planeRow = planeRowFunction(m_isa);
+    const auto packRow = packRowFunction(m_isa);
+
+    // Two rows of each colour plane, the chroma of a row pair is the mean of its 2x2 blocks
+    std::vector<uint8_t> planes(6 * width);
+
+    RowJob jobs[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+        jobs[i].width = width;
+        jobs[i].r = planes.data() + (3 * i) * width;
+        jobs[i].g = planes.data() + (3 * i + 1) * width;
+        jobs[i].b = planes.data() + (3 * i + 2) * width;
+    }
+
+    for (size_t y = firstRow; y < firstRow + rowCount; y += 2)
+    {
+        const size_t rows = std::min<size_t>(2, firstRow + rowCount - y);
+
+        for (size_t i = 0; i < rows; ++i)
+        {
+            prepareRow(jobs[i], layout, input, width, height, y + i);
+            planeRow(jobs[i]);
+            packRow(jobs[i].r, jobs[i].g, jobs[i].b, width, OutputFormat::Mono8,
+                luma + (y - firstRow + i) * lumaStride);
+        }
+
+        const uint8_t* r[2] = { jobs[0].r, jobs[1].r };
+        const uint8_t* g[2] = { jobs[0].g, jobs[1].g };
+        const uint8_t* b[2] = { jobs[0].b, jobs[1].b };
+        chromaRow(r, g, b, rows, width, cb + ((y - firstRow) / 2) * chromaStride,
+            cr + ((y - firstRow) / 2) * chromaStride);
+    }
+}
+
+void Debayer::ConvertScaledToYCbCr420(const uint8_t* input, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, size_t outputWidth, size_t outputHeight, uint8_t* luma,
+    size_t lumaStride, uint8_t* cb, uint8_t* cr, size_t chromaStride) const
+{
+    BayerLayout layout;
+    if (!bayerLayout(inputPixelFormat, layout))
+    {
+        throw std::invalid_argument("Debayer: unsupported input pixel format");
+    }
+
+    if (outputWidth == 0 || outputHeight == 0 || outputWidth > width / 2 || outputHeight > height / 2)
+    {
+        throw std::invalid_argument("Debayer: scaled size " + std::to_string(outputWidth) + "x"
+            + std::to_string(outputHeight) + " is not within half of " + std::to_string(width) + "x"
+            + std::to_string(height));
+    }
+
+    const auto sampling = scaledSampling(input, width, height, width, layout, outputWidth, outputHeight);
+    const auto packRow = packRowFunction(m_isa);
+
+    // Two rows of each colour plane, as in ConvertToYCbCr420
+    std::vector<uint8_t> planes(6 * outputWidth);
+    uint8_t* r[2] = { planes.data(), planes.data() + 3 * outputWidth };
+    uint8_t* g[2] = { r[0] + outputWidth, r[1] + outputWidth };
+    uint8_t* b[2] = { g[0] + outputWidth, g[1] + outputWidth };
+
+    for (size_t y = 0; y < outputHeight; y += 2)
+    {
+        const size_t rows = std::min<size_t>(2, outputHeight - y);
+
+        for (size_t i = 0; i < rows; ++i)
+        {
+            scaledRow(sampling, y + i, r[i], g[i], b[i]);
+            packRow(r[i], g[i], b[i], outputWidth, OutputFormat::Mono8, luma + (y + i) * lumaStride);
+        }
+
+        chromaRow(r, g, b, rows, outputWidth, cb + (y / 2) * chromaStride, cr + (y / 2) * chromaStride);
+    }
+}
@@ -0,0 +1,111 @@
+/*!
+ * \file    debayer.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The Debayer class converts 8 bit Bayer images to BGRa8, RGB8 or
+ *          Mono8 with bilinear interpolation. Kernels exist for AVX2, SSE4.1
+ *          and plain C++, the fastest one supported by the CPU is selected at
+ *          runtime. It can be used in place of peak::ipl::ImageConverter for
+ *          these formats.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef DEBAYER_H
+#define DEBAYER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+class Debayer
+{
+
+public:
+    enum class Isa
+    {
+        Scalar,
+        SSE41,
+        AVX2
+    };
+
+    // Rectangle of an image in pixels
+    struct Region
+    {
+        size_t x = 0;
+        size_t y = 0;
+        size_t width = 0;
+        size_t height = 0;
+    };
+
+    // Uses the best instruction set supported by this CPU
+    Debayer();
+    // Uses the given instruction set, falls back to the best supported one if the CPU lacks it
+    explicit Debayer(Isa isa);
+
+    static bool IsSupported(peak::ipl::PixelFormatName inputPixelFormat, peak::ipl::PixelFormatName outputPixelFormat);
+
+    static Isa BestIsa();
+    static std::vector<Isa> AvailableIsas();
+    static const char* IsaName(Isa isa);
+
+    Isa SelectedIsa() const;
+
+    /*! \brief Converts into a new image, like peak::ipl::ImageConverter::Convert. */
+    peak::ipl::Image Convert(const peak::ipl::Image& inputImage, peak::ipl::PixelFormatName outputPixelFormat) const;
+
+    /*! \brief Converts into \p outputBuffer, e.g. the bits of a QImage, like peak::ipl::ImageConverter::Convert. */
+    void Convert(const peak::ipl::Image& inputImage, peak::ipl::PixelFormatName outputPixelFormat,
+        uint8_t* outputBuffer, size_t outputBufferSize) const;
+
+    /*! \brief Converts a raw, tightly packed Bayer image. \p outputStride is in bytes. */
+    void Convert(const uint8_t* input, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat,
+        uint8_t* output, size_t outputStride, peak::ipl::PixelFormatName outputPixelFormat) const;
+
+    /*!
+     * \brief Converts a raw Bayer image straight to \p outputWidth x \p outputHeight, e.g. a preview at the size of
+     *        the viewport. Each output pixel is taken from the 2x2 Bayer cell at its centre, or averaged over 2x2
+     *        cells when shrinking by 4 or more, so the work scales with the output size instead of the sensor size.
+     *        The output may be at most half the input size in each direction.
+     */
+    void ConvertScaled(const uint8_t* input, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat,
+        uint8_t* output, size_t outputWidth, size_t outputHeight, size_t outputStride,
+        peak::ipl::PixelFormatName outputPixelFormat) const;
+
+    /*!
+     * \brief Converts \p region of a raw Bayer image, e.g. the part visible in a zoomed view, without touching the
+     *        rest of it. The output is the region at full resolution if \p outputWidth x \p outputHeight equals its
+     *        size, otherwise the region is scaled like ConvertScaled(). The region may start on any pixel, its Bayer
+     *        phase follows from the offset.
+     */
+    void ConvertRegion(const uint8_t* input, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat,
+        const Region& region, uint8_t* output, size_t outputWidth, size_t outputHeight, size_t outputStride,
+        peak::ipl::PixelFormatName outputPixelFormat) const;
+
+    /*!
+     * \brief Converts the rows [firstRow, firstRow + rowCount) of a raw Bayer image to full range (JFIF) YCbCr with
+     *        4:2:0 chroma subsampling, written to separate planes. \p firstRow must be even. Row 0 of each plane
+     *        corresponds to \p firstRow, so an encoder can convert one strip at a time.
+     */
+    void ConvertToYCbCr420(const uint8_t* input, size_t width, size_t height,
+        peak::ipl::PixelFormatName inputPixelFormat, size_t firstRow, size_t rowCount, uint8_t* luma,
+        size_t lumaStride, uint8_t* cb, uint8_t* cr, size_t chromaStride) const;
+
+    /*!
+     * \brief Converts a raw Bayer image straight to \p outputWidth x \p outputHeight YCbCr 4:2:0 planes, sampled
+     *        like ConvertScaled() and with the colours of ConvertToYCbCr420(), e.g. for a live preview JPEG.
+     */
+    void ConvertScaledToYCbCr420(const uint8_t* input, size_t width, size_t height,
+        peak::ipl::PixelFormatName inputPixelFormat, size_t outputWidth, size_t outputHeight, uint8_t* luma,
+        size_t lumaStride, uint8_t* cb, uint8_t* cr, size_t chromaStride) const;
+
+private:
+    Isa m_isa;
+};
+
+#endif // DEBAYER_H
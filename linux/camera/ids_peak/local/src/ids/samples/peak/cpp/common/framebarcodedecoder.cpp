@@ -0,0 +1,163 @@
+/*!
+ * \file    framebarcodedecoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameBarcodeDecoder class decodes the barcodes of a raw
+ *          camera frame on a thread of its own, so the caller can encode the
+ *          same frame meanwhile. Bayer frames are decoded from their half
+ *          resolution luma, which keeps the bars of a label a few pixels wide
+ *          and takes a fraction of the time of a full debayer.
+ *
+ * \version 1.0.0
+ */
+
+#include "framebarcodedecoder.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+
+FrameBarcodeDecoder::FrameBarcodeDecoder(
+    BarcodeDecoderOptions options, Debayer::Region region, LatencyRecorder* latency)
+    : m_decoder(std::move(options))
+    , m_region(region)
+    , m_latency(latency)
+{
+    m_thread = std::thread(&FrameBarcodeDecoder::run, this);
+}
+
+FrameBarcodeDecoder::~FrameBarcodeDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+bool FrameBarcodeDecoder::IsSupported(peak::ipl::PixelFormatName pixelFormat)
+{
+    return pixelFormat == peak::ipl::PixelFormatName::Mono8
+        || Debayer::IsSupported(pixelFormat, peak::ipl::PixelFormatName::Mono8);
+}
+
+void FrameBarcodeDecoder::Begin(
+    const uint8_t* frame, size_t width, size_t height, peak::ipl::PixelFormatName pixelFormat)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // A frame still in the works would outlive its buffer otherwise
+        m_condition.wait(lock, [this] { return !m_frame; });
+        m_frame = frame;
+        m_width = width;
+        m_height = height;
+        m_pixelFormat = pixelFormat;
+        m_pending = true;
+        m_barcodes.clear();
+    }
+    m_condition.notify_all();
+}
+
+std::vector<DecodedBarcode> FrameBarcodeDecoder::Finish()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_frame; });
+
+    std::vector<DecodedBarcode> barcodes;
+    if (m_pending)
+    {
+        barcodes.swap(m_barcodes);
+        m_pending = false;
+    }
+    return barcodes;
+}
+
+const Debayer::Region& FrameBarcodeDecoder::Region() const
+{
+    return m_region;
+}
+
+void FrameBarcodeDecoder::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || m_frame; });
+        if (!m_frame)
+        {
+            return;
+        }
+
+        const auto* frame = m_frame;
+        const auto width = m_width;
+        const auto height = m_height;
+        const auto pixelFormat = m_pixelFormat;
+        lock.unlock();
+
+        std::vector<DecodedBarcode> barcodes;
+        try
+        {
+            LatencyRecorder::Scope timing(m_latency, LatencyStage::Barcode);
+            barcodes = decode(frame, width, height, pixelFormat);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+
+        lock.lock();
+        m_barcodes = std::move(barcodes);
+        m_frame = nullptr;
+        m_condition.notify_all();
+    }
+}
+
+std::vector<DecodedBarcode> FrameBarcodeDecoder::decode(
+    const uint8_t* frame, size_t width, size_t height, peak::ipl::PixelFormatName pixelFormat)
+{
+    Debayer::Region region;
+    if (m_region.width && m_region.height)
+    {
+        region.x = std::min(m_region.x, width);
+        region.y = std::min(m_region.y, height);
+        region.width = std::min(m_region.width, width - region.x);
+        region.height = std::min(m_region.height, height - region.y);
+    }
+    else
+    {
+        region.width = width;
+        region.height = height;
+    }
+
+    if (pixelFormat == peak::ipl::PixelFormatName::Mono8)
+    {
+        if (region.width < 2 || region.height < 2)
+        {
+            return std::vector<DecodedBarcode>();
+        }
+
+        BarcodeDecoder::Region monoRegion;
+        monoRegion.x = region.x;
+        monoRegion.y = region.y;
+        monoRegion.width = region.width;
+        monoRegion.height = region.height;
+        return m_decoder.Decode(frame, width, height, width, monoRegion);
+    }
+
+    // One luma pixel per 2x2 Bayer cell, so the colour filter does not show up as a pattern the bars compete with
+    const auto lumaWidth = region.width / 2;
+    const auto lumaHeight = region.height / 2;
+    if (lumaWidth < 2 || lumaHeight < 2)
+    {
+        return std::vector<DecodedBarcode>();
+    }
+
+    m_luma.resize(lumaWidth * lumaHeight);
+    m_debayer.ConvertRegion(frame, width, height, pixelFormat, region, m_luma.data(), lumaWidth, lumaHeight,
+        lumaWidth, peak::ipl::PixelFormatName::Mono8);
+    return m_decoder.Decode(m_luma.data(), lumaWidth, lumaHeight, lumaWidth);
+}
@@ -0,0 +1,90 @@
+/*!
+ * \file    framebarcodedecoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameBarcodeDecoder class decodes the barcodes of a raw
+ *          camera frame on a thread of its own, so the caller can encode the
+ *          same frame meanwhile. Bayer frames are decoded from their half
+ *          resolution luma, which keeps the bars of a label a few pixels wide
+ *          and takes a fraction of the time of a full debayer.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef FRAMEBARCODEDECODER_H
+#define FRAMEBARCODEDECODER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "barcodedecoder.h"
+#include "debayer.h"
+#include "latencyhistogram.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+class FrameBarcodeDecoder
+{
+
+public:
+    /*!
+     * \param region Part of the sensor to search in pixels, e.g. where the sample label is. Empty for the whole
+     *        frame, otherwise clipped to it.
+     * \param latency Records the decode time of every frame, may be null. Must outlive the decoder.
+     */
+    FrameBarcodeDecoder(BarcodeDecoderOptions options, Debayer::Region region, LatencyRecorder* latency = nullptr);
+    ~FrameBarcodeDecoder();
+
+    FrameBarcodeDecoder(const FrameBarcodeDecoder&) = delete;
+    FrameBarcodeDecoder& operator=(const FrameBarcodeDecoder&) = delete;
+
+    // Mono8 and the Bayer formats Debayer converts to Mono8
+    static bool IsSupported(peak::ipl::PixelFormatName pixelFormat);
+
+    /*!
+     * \brief Starts decoding a raw, tightly packed frame and returns immediately. \p frame must stay valid until
+     *        Finish() returns, e.g. the camera buffer must not be queued again before.
+     */
+    void Begin(const uint8_t* frame, size_t width, size_t height, peak::ipl::PixelFormatName pixelFormat);
+
+    /*!
+     * \brief Waits for the frame of Begin() and returns its barcodes, most votes first. Empty if nothing was read,
+     *        the decode failed or Begin() was not called.
+     */
+    std::vector<DecodedBarcode> Finish();
+
+    const Debayer::Region& Region() const;
+
+private:
+    void run();
+    std::vector<DecodedBarcode> decode(
+        const uint8_t* frame, size_t width, size_t height, peak::ipl::PixelFormatName pixelFormat);
+
+    const BarcodeDecoder m_decoder;
+    const Debayer m_debayer;
+    const Debayer::Region m_region;
+    LatencyRecorder* const m_latency;
+    // Half resolution luma of the region, only touched by the decode thread
+    std::vector<uint8_t> m_luma;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    // The frame of Begin() while it is decoded, null otherwise
+    const uint8_t* m_frame = nullptr;
+    size_t m_width = 0;
+    size_t m_height = 0;
+    peak::ipl::PixelFormatName m_pixelFormat = peak::ipl::PixelFormatName::Mono8;
+    bool m_pending = false;
+    std::vector<DecodedBarcode> m_barcodes;
+    bool m_running = true;
+    std::thread m_thread;
+};
+
+#endif // FRAMEBARCODEDECODER_H
@@ -0,0 +1,433 @@
+/*!
+ * \file    framejournal.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameJournalWriter class appends raw, undebayered buffers to
+ *          preallocated, memory-mapped segment files and records every frame
+ *          in an index. The FrameJournalReader class gives offline tools
+ *          random access to the journaled frames, e.g. to convert any of them
+ *          long after the capture.
+ *
+ * \version 1.0.0
+ */
+
+#include "framejournal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+const size_t FrameJournalEntry::MaximumChunks;
+
+
+namespace
+{
+
+// Frames start on page boundaries, so a reader can map or read any frame on its own
+constexpr uint64_t frameAlignment = 4096;
+
+struct IndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+};
+
+const char indexMagic[8] = { 'P', 'K', 'J', 'O', 'U', 'R', 'N', 'L' };
+
+std::runtime_error systemError(const std::string& what, const std::string& path)
+{
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+uint64_t alignUp(uint64_t value)
+{
+    return (value + frameAlignment - 1) / frameAlignment * frameAlignment;
+}
+
+void writeAll(int file, const void* data, size_t size, const std::string& path)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        const auto written = ::write(file, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw systemError("Failed to write", path);
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+
+FrameJournalWriter::FrameJournalWriter(FrameJournalOptions options)
+    : m_options(std::move(options))
+{
+    if (::mkdir(m_options.directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw systemError("Failed to create", m_options.directory);
+    }
+
+    // A journal is written once, appending to an existing one would mix captures
+    const auto indexPath = FrameJournalReader::IndexPath(m_options.directory);
+    m_indexFile = ::open(indexPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+    if (m_indexFile < 0)
+    {
+        throw systemError("Failed to create", indexPath);
+    }
+
+    IndexHeader header;
+    std::memcpy(header.magic, indexMagic, sizeof(header.magic));
+    header.version = FrameJournalVersion;
+    header.entrySize = sizeof(FrameJournalEntry);
+    writeAll(m_indexFile, &header, sizeof(header), indexPath);
+
+    m_options.segmentSize_bytes = alignUp(std::max(m_options.segmentSize_bytes, frameAlignment));
+}
+
+FrameJournalWriter::~FrameJournalWriter()
+{
+    try
+    {
+        closeSegment();
+    }
+    catch (const std::exception&)
+    {
+        // Nothing left to report to
+    }
+
+    if (m_indexFile >= 0)
+    {
+        ::fsync(m_indexFile);
+        ::close(m_indexFile);
+    }
+}
+
+bool FrameJournalWriter::Append(const std::shared_ptr<peak::core::Buffer>& buffer)
+{
+    const auto entry = Describe(buffer);
+    return Append(entry, static_cast<const uint8_t*>(buffer->BasePtr()), entry.payloadSize);
+}
+
+FrameJournalEntry FrameJournalWriter::Describe(const std::shared_ptr<peak::core::Buffer>& buffer)
+{
+    FrameJournalEntry entry;
+    entry.frameId = buffer->FrameID();
+    entry.deviceTimestamp_ns = buffer->Timestamp_ns();
+    entry.hostTimestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+                                                       .count());
+    entry.pixelFormat = buffer->PixelFormat();
+    entry.width = static_cast<uint32_t>(buffer->Width());
+    entry.height = static_cast<uint32_t>(buffer->Height());
+    entry.flags = buffer->IsIncomplete() ? FrameJournalIncomplete : 0;
+
+    const auto* base = static_cast<const uint8_t*>(buffer->BasePtr());
+    auto payloadSize = buffer->DeliveredDataSize();
+    if (payloadSize == 0 || payloadSize > buffer->Size())
+    {
+        payloadSize = buffer->Size();
+    }
+
+    entry.imageOffset = buffer->ImageOffset();
+    entry.imageSize = payloadSize > entry.imageOffset ? payloadSize - entry.imageOffset : 0;
+
+    if (buffer->HasChunks())
+    {
+        const auto chunks = buffer->Chunks();
+
+        // Like peak::BufferTo<peak::ipl::Image>, the first chunk holds the image data
+        if (!chunks.empty())
+        {
+            entry.imageSize = std::min<uint64_t>(entry.imageSize, chunks[0]->Size());
+        }
+
+        for (const auto& chunk : chunks)
+        {
+            if (entry.chunkCount == FrameJournalEntry::MaximumChunks)
+            {
+                entry.flags |= FrameJournalChunksTruncated;
+                break;
+            }
+
+            auto& record = entry.chunks[entry.chunkCount++];
+            record.id = chunk->ID();
+            record.offset = static_cast<uint64_t>(static_cast<const uint8_t*>(chunk->BasePtr()) - base);
+            record.size = chunk->Size();
+        }
+    }
+
+    entry.payloadSize = payloadSize;
+    return entry;
+}
+
+bool FrameJournalWriter::Append(FrameJournalEntry entry, const uint8_t* payload, size_t payloadSize)
+{
+    if (payloadSize > m_options.segmentSize_bytes)
+    {
+        m_counters.rejected++;
+        return false;
+    }
+
+    if (m_segmentMemory && m_segmentUsed + payloadSize > m_options.segmentSize_bytes)
+    {
+        closeSegment();
+    }
+
+    if (!m_segmentMemory && !openSegment())
+    {
+        m_counters.rejected++;
+        return false;
+    }
+
+    const auto offset = m_segmentUsed;
+    std::memcpy(m_segmentMemory + offset, payload, payloadSize);
+    m_segmentUsed = alignUp(offset + payloadSize);
+
+    if (m_options.eagerWriteback)
+    {
+        // Asynchronous, only queues the pages for writeback
+        ::sync_file_range(m_segmentFile, static_cast<off_t>(offset), static_cast<off_t>(payloadSize),
+            SYNC_FILE_RANGE_WRITE);
+    }
+
+    // The index entry follows the payload, an entry always refers to a complete copy
+    entry.segment = m_segment;
+    entry.offset = offset;
+    entry.payloadSize = payloadSize;
+    writeAll(m_indexFile, &entry, sizeof(entry), FrameJournalReader::IndexPath(m_options.directory));
+
+    m_counters.frames++;
+    m_counters.bytes += payloadSize;
+    return true;
+}
+
+void FrameJournalWriter::Rotate()
+{
+    closeSegment();
+}
+
+FrameJournalCounters FrameJournalWriter::Counters() const
+{
+    return m_counters;
+}
+
+bool FrameJournalWriter::openSegment()
+{
+    if (m_options.maximumSegments > 0 && m_segment >= m_options.maximumSegments)
+    {
+        return false;
+    }
+
+    const auto segment = m_segment + 1;
+    const auto path = FrameJournalReader::SegmentPath(m_options.directory, segment);
+
+    const int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        throw systemError("Failed to create", path);
+    }
+
+    // Reserve the blocks up front, so the capture never waits for the file system to allocate them and a full disk
+    // shows up here and not as SIGBUS on a store into the mapping
+    const auto size = static_cast<off_t>(m_options.segmentSize_bytes);
+    const auto error = ::posix_fallocate(file, 0, size);
+    if (error != 0)
+    {
+        ::close(file);
+        ::unlink(path.c_str());
+        errno = error;
+        throw systemError("Failed to preallocate", path);
+    }
+
+    void* memory = ::mmap(nullptr, m_options.segmentSize_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (memory == MAP_FAILED)
+    {
+        ::close(file);
+        ::unlink(path.c_str());
+        throw systemError("Failed to map", path);
+    }
+
+    // Written once from front to back
+    ::madvise(memory, m_options.segmentSize_bytes, MADV_SEQUENTIAL);
+
+    m_segmentFile = file;
+    m_segmentMemory = static_cast<uint8_t*>(memory);
+    m_segmentUsed = 0;
+    m_segment = segment;
+    m_counters.segments = segment;
+    return true;
+}
+
+void FrameJournalWriter::closeSegment()
+{
+    if (!m_segmentMemory)
+    {
+        return;
+    }
+
+    ::msync(m_segmentMemory, m_segmentUsed, MS_ASYNC);
+    ::munmap(m_segmentMemory, m_options.segmentSize_bytes);
+    m_segmentMemory = nullptr;
+
+    // Give the unused preallocated space back
+    if (::ftruncate(m_segmentFile, static_cast<off_t>(m_segmentUsed)) != 0)
+    {
+        // The segment stays at its preallocated size, the index still describes it correctly
+    }
+
+    ::close(m_segmentFile);
+    m_segmentFile = -1;
+}
+
+
+FrameJournalReader::FrameJournalReader(const std::string& directory)
+    : m_directory(directory)
+{
+    const auto indexPath = IndexPath(directory);
+    auto* file = std::fopen(indexPath.c_str(), "rb");
+    if (!file)
+    {
+        throw systemError("Failed to open", indexPath);
+    }
+
+    IndexHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1
+        || std::memcmp(header.magic, indexMagic, sizeof(header.magic)) != 0)
+    {
+        std::fclose(file);
+        throw std::runtime_error(indexPath + " is not a frame journal index");
+    }
+
+    if (header.version != FrameJournalVersion || header.entrySize != sizeof(FrameJournalEntry))
+    {
+        std::fclose(file);
+        throw std::runtime_error(indexPath + " has version " + std::to_string(header.version)
+            + ", this tool reads version " + std::to_string(FrameJournalVersion));
+    }
+
+    // A capture that was cut off may leave a partial entry at the end, it is ignored
+    FrameJournalEntry entry;
+    while (std::fread(&entry, sizeof(entry), 1, file) == 1)
+    {
+        m_entries.push_back(entry);
+    }
+
+    std::fclose(file);
+}
+
+FrameJournalReader::~FrameJournalReader()
+{
+    unmapSegment();
+}
+
+const std::vector<FrameJournalEntry>& FrameJournalReader::Entries() const
+{
+    return m_entries;
+}
+
+size_t FrameJournalReader::Find(uint64_t frameId) const
+{
+    const auto found = std::find_if(m_entries.begin(), m_entries.end(),
+        [frameId](const FrameJournalEntry& entry) { return entry.frameId == frameId; });
+    return static_cast<size_t>(found - m_entries.begin());
+}
+
+const uint8_t* FrameJournalReader::Payload(const FrameJournalEntry& entry)
+{
+    mapSegment(entry.segment);
+
+    if (entry.offset + entry.payloadSize > m_mappedSize)
+    {
+        throw std::runtime_error("Frame " + std::to_string(entry.frameId) + " lies beyond the end of "
+            + SegmentPath(m_directory, entry.segment));
+    }
+
+    return m_mappedMemory + entry.offset;
+}
+
+peak::ipl::Image FrameJournalReader::Image(const FrameJournalEntry& entry)
+{
+    const auto* payload = Payload(entry);
+
+    // The IPL does not write to an image it only reads from, the cast is needed for its constructor
+    return peak::ipl::Image(static_cast<peak::ipl::PixelFormatName>(entry.pixelFormat),
+        const_cast<uint8_t*>(payload + entry.imageOffset), entry.imageSize, entry.width, entry.height,
+        entry.deviceTimestamp_ns);
+}
+
+std::string FrameJournalReader::SegmentPath(const std::string& directory, uint32_t segment)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%06u.raw", segment);
+    return directory + "/" + name;
+}
+
+std::string FrameJournalReader::IndexPath(const std::string& directory)
+{
+    return directory + "/index.fjx";
+}
+
+void FrameJournalReader::mapSegment(uint32_t segment)
+{
+    if (m_mappedMemory && m_mappedSegment == segment)
+    {
+        return;
+    }
+
+    unmapSegment();
+
+    const auto path = SegmentPath(m_directory, segment);
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        throw systemError("Failed to open", path);
+    }
+
+    struct stat status;
+    if (::fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(file);
+        throw std::runtime_error(path + " is empty");
+    }
+
+    void* memory = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (memory == MAP_FAILED)
+    {
+        throw systemError("Failed to map", path);
+    }
+
+    m_mappedSegment = segment;
+    m_mappedMemory = static_cast<uint8_t*>(memory);
+    m_mappedSize = static_cast<size_t>(status.st_size);
+}
+
+void FrameJournalReader::unmapSegment()
+{
+    if (m_mappedMemory)
+    {
+        ::munmap(m_mappedMemory, m_mappedSize);
+        m_mappedMemory = nullptr;
+        m_mappedSize = 0;
+    }
+}
@@ -0,0 +1,201 @@
+/*!
+ * \file    framejournal.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameJournalWriter class appends raw, undebayered buffers to
+ *          preallocated, memory-mapped segment files and records every frame
+ *          in an index. The FrameJournalReader class gives offline tools
+ *          random access to the journaled frames, e.g. to convert any of them
+ *          long after the capture.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef FRAMEJOURNAL_H
+#define FRAMEJOURNAL_H
+
+#include <peak/peak.hpp>
+#include <peak_ipl/peak_ipl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+/*!
+ * \brief Position of one chunk of a frame, relative to the start of the frame's payload.
+ */
+struct FrameJournalChunk
+{
+    uint64_t id = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+
+/*!
+ * \brief Index record of one frame. Written to the index file as is, so the layout must not change without a new
+ *        FrameJournalVersion.
+ */
+struct FrameJournalEntry
+{
+    static const size_t MaximumChunks = 8;
+
+    uint64_t frameId = 0;
+    // Timestamp of the camera, Buffer::Timestamp_ns()
+    uint64_t deviceTimestamp_ns = 0;
+    // System clock when the buffer was received, nanoseconds since the Unix epoch
+    uint64_t hostTimestamp_ns = 0;
+    // PFNC value, castable to peak::ipl::PixelFormatName
+    uint64_t pixelFormat = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    // Segment file and byte offset of the payload inside it
+    uint32_t segment = 0;
+    uint32_t flags = 0;
+    uint64_t offset = 0;
+    // The delivered buffer as is: image data and chunk data, if any
+    uint64_t payloadSize = 0;
+    // Image data within the payload
+    uint64_t imageOffset = 0;
+    uint64_t imageSize = 0;
+
+    uint32_t chunkCount = 0;
+    uint32_t reserved = 0;
+    FrameJournalChunk chunks[MaximumChunks];
+};
+
+static_assert(std::is_standard_layout<FrameJournalEntry>::value && sizeof(FrameJournalEntry) == 280,
+    "FrameJournalEntry is written to disk, its layout is part of the file format");
+
+// FrameJournalEntry::flags
+const uint32_t FrameJournalIncomplete = 1u << 0;
+const uint32_t FrameJournalChunksTruncated = 1u << 1;
+
+const uint32_t FrameJournalVersion = 1;
+
+
+struct FrameJournalOptions
+{
+    // Directory of the segment files and the index, created if missing
+    std::string directory;
+    // Size each segment file is preallocated to, a frame never spans two segments
+    uint64_t segmentSize_bytes = 1ull << 30;
+    // Appending fails once this many segments are full, 0 for no limit
+    uint32_t maximumSegments = 0;
+    // Start writeback of every frame right away, so dirty pages never pile up and stall the capture in a burst
+    bool eagerWriteback = true;
+};
+
+
+struct FrameJournalCounters
+{
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint32_t segments = 0;
+    // Frames not journaled because the journal was full or the frame did not fit into a segment
+    uint64_t rejected = 0;
+};
+
+
+/*!
+ * \brief Append-only journal writer. Not thread-safe, owned by the acquisition thread.
+ *
+ * A frame costs one copy of the delivered payload into the page cache and one small write to the index. Nothing is
+ * converted or encoded. Segments are truncated to their used size when they are closed.
+ */
+class FrameJournalWriter
+{
+
+public:
+    explicit FrameJournalWriter(FrameJournalOptions options);
+    ~FrameJournalWriter();
+
+    FrameJournalWriter(const FrameJournalWriter&) = delete;
+    FrameJournalWriter& operator=(const FrameJournalWriter&) = delete;
+
+    /*!
+     * \brief Journals a finished buffer. Returns false if it was rejected, see FrameJournalCounters::rejected. The
+     *        buffer may be requeued as soon as this returns.
+     */
+    bool Append(const std::shared_ptr<peak::core::Buffer>& buffer);
+
+    /*!
+     * \brief Journals \p payloadSize bytes of \p payload with the metadata of \p entry. The segment, offset and
+     *        payloadSize fields of \p entry are filled in.
+     */
+    bool Append(FrameJournalEntry entry, const uint8_t* payload, size_t payloadSize);
+
+    /*!
+     * \brief Metadata of a finished buffer as Append() would journal it. The payloadSize field is the delivered size,
+     *        the segment and offset fields are left empty.
+     */
+    static FrameJournalEntry Describe(const std::shared_ptr<peak::core::Buffer>& buffer);
+
+    // Closes the current segment, the next frame starts a new one
+    void Rotate();
+
+    FrameJournalCounters Counters() const;
+
+private:
+    bool openSegment();
+    void closeSegment();
+
+    FrameJournalOptions m_options;
+    int m_indexFile = -1;
+
+    int m_segmentFile = -1;
+    uint8_t* m_segmentMemory = nullptr;
+    uint64_t m_segmentUsed = 0;
+    uint32_t m_segment = 0;
+
+    FrameJournalCounters m_counters;
+};
+
+
+/*!
+ * \brief Read-only view of a journal, for offline tools. The index is read once on construction.
+ */
+class FrameJournalReader
+{
+
+public:
+    explicit FrameJournalReader(const std::string& directory);
+    ~FrameJournalReader();
+
+    FrameJournalReader(const FrameJournalReader&) = delete;
+    FrameJournalReader& operator=(const FrameJournalReader&) = delete;
+
+    const std::vector<FrameJournalEntry>& Entries() const;
+
+    // Index of the entry with \p frameId, or Entries().size() if there is none
+    size_t Find(uint64_t frameId) const;
+
+    // Payload of \p entry. Valid until the next call or the destruction of the reader.
+    const uint8_t* Payload(const FrameJournalEntry& entry);
+
+    // The image data of \p entry, wrapped without copying. Valid as long as Payload() would be.
+    peak::ipl::Image Image(const FrameJournalEntry& entry);
+
+    static std::string SegmentPath(const std::string& directory, uint32_t segment);
+    static std::string IndexPath(const std::string& directory);
+
+private:
+    void mapSegment(uint32_t segment);
+    void unmapSegment();
+
+    std::string m_directory;
+    std::vector<FrameJournalEntry> m_entries;
+
+    uint32_t m_mappedSegment = 0;
+    uint8_t* m_mappedMemory = nullptr;
+    size_t m_mappedSize = 0;
+};
+
+#endif // FRAMEJOURNAL_H
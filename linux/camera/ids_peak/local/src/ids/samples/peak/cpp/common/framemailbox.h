@@ -0,0 +1,119 @@
+/*!
+ * \file    framemailbox.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameMailbox class holds only the newest frame on its way
+ *          from an acquisition thread to the GUI thread. A frame posted
+ *          before the previous one was taken replaces it and is counted as
+ *          coalesced, so a stalled GUI never queues up more than one frame.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+
+/*!
+ * \brief Counters of a mailbox. All values are totals since construction.
+ */
+struct FrameMailboxCounters
+{
+    uint64_t posted = 0;
+    uint64_t taken = 0;
+    // Frames replaced by a newer one before they were taken, i.e. never displayed
+    uint64_t coalesced = 0;
+};
+
+
+/*!
+ * \brief Latest-frame-wins mailbox. Any thread may Post(), the consumer thread calls Take().
+ *
+ * Post() returns true only for the frame that fills an empty mailbox. The producer notifies the consumer for that
+ * frame alone, e.g. with one queued invocation, and later frames just replace it until the consumer has taken it.
+ * Thus at most one notification and one frame are pending at any time, however long the consumer stalls.
+ */
+template <typename T>
+class FrameMailbox
+{
+
+public:
+    FrameMailbox() = default;
+
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    /*! Stores \p item, replacing a frame not taken yet. Returns true if the consumer has to be notified. */
+    bool Post(T item)
+    {
+        // The replaced frame is released outside the lock, it may be the last reference to a large image
+        T replaced;
+        bool notify = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_posted++;
+
+            if (m_full)
+            {
+                m_coalesced++;
+                replaced = std::move(m_item);
+            }
+            else
+            {
+                notify = true;
+            }
+
+            m_item = std::move(item);
+            m_full = true;
+        }
+
+        return notify;
+    }
+
+    /*! Moves the newest frame into \p item. Returns false if the mailbox is empty. */
+    bool Take(T& item)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_full)
+        {
+            return false;
+        }
+
+        item = std::move(m_item);
+        // Drop the reference held by the mailbox, otherwise the frame would stay referenced until it is replaced
+        m_item = T();
+        m_full = false;
+        m_taken++;
+
+        return true;
+    }
+
+    FrameMailboxCounters Counters() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        FrameMailboxCounters counters;
+        counters.posted = m_posted;
+        counters.taken = m_taken;
+        counters.coalesced = m_coalesced;
+        return counters;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    T m_item{};
+    bool m_full = false;
+
+    uint64_t m_posted = 0;
+    uint64_t m_taken = 0;
+    uint64_t m_coalesced = 0;
+};
+
+#endif // FRAMEMAILBOX_H
@@ -0,0 +1,229 @@
+/*!
+ * \file    framering.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The FrameRing class is a bounded, lock-free single-producer/
+ *          single-consumer ring. It hands finished buffers from the acquisition
+ *          thread to a conversion stage, so that WaitForFinishedBuffer is never
+ *          blocked by image conversion.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <peak/peak.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/*!
+ * \brief A finished buffer together with the metadata the consumer needs without touching the buffer again.
+ */
+struct Frame
+{
+    std::shared_ptr<peak::core::Buffer> buffer;
+    uint64_t frameId = 0;
+    uint64_t timestamp_ns = 0;
+    // Generation of the trigger the frame answers, set by the producer. 0 if it answers none.
+    uint64_t trigger = 0;
+
+    static Frame FromBuffer(const std::shared_ptr<peak::core::Buffer>& buffer)
+    {
+        Frame frame;
+        frame.buffer = buffer;
+        frame.frameId = buffer->FrameID();
+        frame.timestamp_ns = buffer->Timestamp_ns();
+        return frame;
+    }
+};
+
+
+/*!
+ * \brief Back-pressure counters of a ring. All values are totals since construction.
+ */
+struct FrameRingCounters
+{
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t rejected = 0;
+    size_t depth = 0;
+    size_t highWatermark = 0;
+};
+
+
+/*!
+ * \brief Bounded SPSC ring. Exactly one thread may call TryPush() and exactly one thread may call TryPop()/Pop().
+ *
+ * The producer never blocks: when the ring is full TryPush() fails and counts the frame as rejected, so the caller
+ * can requeue the buffer immediately and keep the camera supplied with buffers.
+ */
+template <typename T = Frame>
+class FrameRing
+{
+
+public:
+    explicit FrameRing(size_t capacity)
+        : m_capacity(std::max<size_t>(capacity, 1))
+        , m_slots(m_capacity + 1)
+    {}
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    bool TryPush(T item)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        const auto next = increment(tail);
+
+        if (next == m_head.load(std::memory_order_acquire))
+        {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_slots[tail] = std::move(item);
+        m_tail.store(next, std::memory_order_seq_cst);
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        const auto depth = Size();
+        if (depth > m_highWatermark.load(std::memory_order_relaxed))
+        {
+            m_highWatermark.store(depth, std::memory_order_relaxed);
+        }
+
+        // Only take the mutex if the consumer is actually sleeping
+        if (m_consumerWaiting.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_waitCondition.notify_one();
+        }
+
+        return true;
+    }
+
+    bool TryPop(T& item)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = std::move(m_slots[head]);
+        // Drop the reference held by the slot, otherwise the buffer would stay referenced until it is overwritten
+        m_slots[head] = T();
+        m_head.store(increment(head), std::memory_order_release);
+        m_popped.fetch_add(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /*! Waits up to \p timeout for an item. Returns false on timeout or after WakeConsumer(). */
+    bool Pop(T& item, std::chrono::milliseconds timeout)
+    {
+        if (TryPop(item))
+        {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_consumerWaiting.store(true, std::memory_order_seq_cst);
+
+        // Re-check after announcing the wait, a push in between would otherwise be missed
+        const auto ready = m_waitCondition.wait_for(lock, timeout, [this] {
+            return m_wake || m_head.load(std::memory_order_relaxed) != m_tail.load(std::memory_order_seq_cst);
+        });
+
+        m_consumerWaiting.store(false, std::memory_order_relaxed);
+        m_wake = false;
+        lock.unlock();
+
+        return ready && TryPop(item);
+    }
+
+    /*!
+     * Pops every item left and passes it to \p function, e.g. to requeue the buffers of a stopped stage. Counts as
+     * the consumer, so the consumer thread must have finished.
+     */
+    template <typename Function>
+    void Drain(Function function)
+    {
+        T item;
+        while (TryPop(item))
+        {
+            function(item);
+        }
+    }
+
+    /*! Releases a consumer blocked in Pop(), e.g. when the stage is stopped. */
+    void WakeConsumer()
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_wake = true;
+        m_waitCondition.notify_all();
+    }
+
+    size_t Size() const
+    {
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        return (tail >= head) ? (tail - head) : (tail + m_slots.size() - head);
+    }
+
+    size_t Capacity() const
+    {
+        return m_capacity;
+    }
+
+    FrameRingCounters Counters() const
+    {
+        FrameRingCounters counters;
+        counters.pushed = m_pushed.load(std::memory_order_relaxed);
+        counters.popped = m_popped.load(std::memory_order_relaxed);
+        counters.rejected = m_rejected.load(std::memory_order_relaxed);
+        counters.depth = Size();
+        counters.highWatermark = m_highWatermark.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+private:
+    size_t increment(size_t index) const
+    {
+        return (index + 1 == m_slots.size()) ? 0 : index + 1;
+    }
+
+    // One slot stays empty to tell a full ring from an empty one
+    const size_t m_capacity;
+    std::vector<T> m_slots;
+
+    // Producer and consumer indices are padded onto separate cache lines to avoid false sharing. Padding is used
+    // instead of alignas, because over-aligned heap allocation is not available before C++17.
+    char m_padding0[64];
+    std::atomic<size_t> m_head{ 0 };
+    std::atomic<uint64_t> m_popped{ 0 };
+    char m_padding1[64];
+    std::atomic<size_t> m_tail{ 0 };
+    std::atomic<uint64_t> m_pushed{ 0 };
+    std::atomic<uint64_t> m_rejected{ 0 };
+    std::atomic<size_t> m_highWatermark{ 0 };
+    char m_padding2[64];
+
+    std::atomic<bool> m_consumerWaiting{ false };
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+    bool m_wake = false;
+};
+
+#endif // FRAMERING_H
@@ -0,0 +1,218 @@
+/*!
+ * \file    imagepool.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ImagePool class preallocates a fixed number of equally sized
+ *          images that are handed out as reference counted ImageLease
+ *          objects and return to the pool when the last reference is gone.
+ *          Acquiring, copying and releasing a lease never allocates.
+ *
+ * \version 1.0.0
+ */
+
+#include "imagepool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+
+constexpr size_t imageAlignment = 64;
+
+} // namespace
+
+
+struct ImageLease::Slot
+{
+    ImagePool::State* state = nullptr;
+    uint8_t* data = nullptr;
+    std::atomic<size_t> references{ 0 };
+};
+
+
+struct ImagePool::State
+{
+    size_t imageSize = 0;
+    std::unique_ptr<uint8_t[]> memory;
+    std::unique_ptr<ImageLease::Slot[]> slots;
+    size_t capacity = 0;
+
+    std::mutex mutex;
+    std::condition_variable returned;
+    // Reserved to capacity, pushing never allocates
+    std::vector<ImageLease::Slot*> available;
+    uint64_t acquired = 0;
+    uint64_t exhausted = 0;
+
+    // One for the pool plus one per slot out on lease
+    std::atomic<size_t> references{ 1 };
+
+    void Unreference()
+    {
+        if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    void Return(ImageLease::Slot* slot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            available.push_back(slot);
+        }
+        returned.notify_one();
+
+        // The reference of the slot keeps the state alive until here
+        Unreference();
+    }
+};
+
+
+ImageLease::ImageLease(Slot* slot)
+    : m_slot(slot)
+{}
+
+ImageLease::ImageLease(const ImageLease& other)
+    : m_slot(other.m_slot)
+{
+    if (m_slot)
+    {
+        m_slot->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ImageLease::ImageLease(ImageLease&& other) noexcept
+    : m_slot(other.m_slot)
+{
+    other.m_slot = nullptr;
+}
+
+ImageLease& ImageLease::operator=(ImageLease other) noexcept
+{
+    std::swap(m_slot, other.m_slot);
+    return *this;
+}
+
+ImageLease::~ImageLease()
+{
+    if (m_slot && m_slot->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_slot->state->Return(m_slot);
+    }
+}
+
+ImageLease::operator bool() const
+{
+    return m_slot != nullptr;
+}
+
+uint8_t* ImageLease::Data() const
+{
+    return m_slot ? m_slot->data : nullptr;
+}
+
+size_t ImageLease::Size() const
+{
+    return m_slot ? m_slot->state->imageSize : 0;
+}
+
+void* ImageLease::Detach()
+{
+    auto* token = m_slot;
+    m_slot = nullptr;
+    return token;
+}
+
+void ImageLease::Release(void* token)
+{
+    // Adopts the reference of the token, the destructor drops it
+    ImageLease lease(static_cast<Slot*>(token));
+}
+
+
+ImagePool::ImagePool(size_t count, size_t imageSize)
+    : m_state(new State)
+{
+    const auto stride = (imageSize + imageAlignment - 1) / imageAlignment * imageAlignment;
+
+    m_state->imageSize = imageSize;
+    m_state->capacity = count;
+    // Value initialized, so every page is touched here and not by the first frames
+    m_state->memory.reset(new uint8_t[stride * count + imageAlignment]());
+    m_state->slots.reset(new ImageLease::Slot[count]);
+    m_state->available.reserve(count);
+
+    auto address = reinterpret_cast<uintptr_t>(m_state->memory.get());
+    auto* aligned = m_state->memory.get() + (imageAlignment - address % imageAlignment) % imageAlignment;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& slot = m_state->slots[i];
+        slot.state = m_state;
+        slot.data = aligned + i * stride;
+        m_state->available.push_back(&slot);
+    }
+}
+
+ImagePool::~ImagePool()
+{
+    // Leases still alive keep the memory until they are released
+    m_state->Unreference();
+}
+
+ImageLease ImagePool::TryAcquire()
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return take();
+}
+
+ImageLease ImagePool::Acquire(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->returned.wait_for(lock, timeout, [this] { return !m_state->available.empty(); });
+    return take();
+}
+
+size_t ImagePool::ImageSize() const
+{
+    return m_state->imageSize;
+}
+
+ImagePoolCounters ImagePool::Counters() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+
+    ImagePoolCounters counters;
+    counters.capacity = m_state->capacity;
+    counters.available = m_state->available.size();
+    counters.acquired = m_state->acquired;
+    counters.exhausted = m_state->exhausted;
+    return counters;
+}
+
+ImageLease ImagePool::take()
+{
+    // Called with the mutex held
+    if (m_state->available.empty())
+    {
+        m_state->exhausted++;
+        return ImageLease();
+    }
+
+    auto* slot = m_state->available.back();
+    m_state->available.pop_back();
+    m_state->acquired++;
+
+    slot->references.store(1, std::memory_order_relaxed);
+    m_state->references.fetch_add(1, std::memory_order_relaxed);
+    return ImageLease(slot);
+}
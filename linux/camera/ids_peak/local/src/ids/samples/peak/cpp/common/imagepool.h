@@ -0,0 +1,108 @@
+/*!
+ * \file    imagepool.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The ImagePool class preallocates a fixed number of equally sized
+ *          images that are handed out as reference counted ImageLease
+ *          objects and return to the pool when the last reference is gone.
+ *          Acquiring, copying and releasing a lease never allocates.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef IMAGEPOOL_H
+#define IMAGEPOOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+/*!
+ * \brief Counters of a pool. All values are totals since construction, except available.
+ */
+struct ImagePoolCounters
+{
+    size_t capacity = 0;
+    size_t available = 0;
+    uint64_t acquired = 0;
+    // TryAcquire() or Acquire() calls that found the pool empty
+    uint64_t exhausted = 0;
+};
+
+
+class ImagePool;
+
+
+/*!
+ * \brief Shared reference to one image of an ImagePool, like a shared_ptr without the allocation of a control block.
+ *        Copies refer to the same image. The pool may be destroyed while leases are still alive.
+ */
+class ImageLease
+{
+
+public:
+    ImageLease() = default;
+    ImageLease(const ImageLease& other);
+    ImageLease(ImageLease&& other) noexcept;
+    ImageLease& operator=(ImageLease other) noexcept;
+    ~ImageLease();
+
+    explicit operator bool() const;
+
+    uint8_t* Data() const;
+    size_t Size() const;
+
+    /*!
+     * \brief Hands the reference over to a C style cleanup callback, e.g. the QImageCleanupFunction of a QImage that
+     *        wraps Data(). The lease is empty afterwards, Release(token) drops the reference.
+     */
+    void* Detach();
+    static void Release(void* token);
+
+private:
+    friend class ImagePool;
+
+    struct Slot;
+    explicit ImageLease(Slot* slot);
+
+    Slot* m_slot = nullptr;
+};
+
+
+class ImagePool
+{
+
+public:
+    /*!
+     * \brief Allocates \p count images of \p imageSize bytes, each aligned to 64 bytes.
+     */
+    ImagePool(size_t count, size_t imageSize);
+    ~ImagePool();
+
+    ImagePool(const ImagePool&) = delete;
+    ImagePool& operator=(const ImagePool&) = delete;
+
+    // Returns an empty lease if no image is available
+    ImageLease TryAcquire();
+
+    // Waits up to \p timeout for an image to be returned, returns an empty lease on timeout
+    ImageLease Acquire(std::chrono::milliseconds timeout);
+
+    size_t ImageSize() const;
+    ImagePoolCounters Counters() const;
+
+private:
+    friend class ImageLease;
+
+    struct State;
+
+    ImageLease take();
+
+    // Shared with the leases, freed when the pool and the last lease are gone
+    State* m_state;
+};
+
+#endif // IMAGEPOOL_H
@@ -0,0 +1,270 @@
+/*!
+ * \file    latencyhistogram.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The LatencyRecorder class collects per-stage latencies of the
+ *          acquisition loop in log-linear histograms. Every thread records
+ *          into its own histograms without locks, a reader merges them into
+ *          p50/p99/p999/max per stage.
+ *
+ * \version 1.0.0
+ */
+
+#include "latencyhistogram.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+
+namespace
+{
+
+std::atomic<uint64_t> nextRecorderId{ 1 };
+
+unsigned mostSignificantBit(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+// Duration below which \p fraction of the samples fall, taken as the middle of the bucket and capped by the maximum
+double percentile_us(const std::vector<uint64_t>& counts, uint64_t total, double fraction, uint64_t max_ns)
+{
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5));
+
+    uint64_t seen = 0;
+    for (size_t index = 0; index < counts.size(); ++index)
+    {
+        seen += counts[index];
+        if (seen >= rank)
+        {
+            const auto upper = LatencyHistogram::BucketUpperBound(index);
+            const auto lower = index == 0 ? 0 : LatencyHistogram::BucketUpperBound(index - 1) + 1;
+            const auto middle = lower + (upper - lower) / 2;
+            return static_cast<double>(std::min(middle, max_ns)) / 1000.0;
+        }
+    }
+
+    return static_cast<double>(max_ns) / 1000.0;
+}
+
+} // namespace
+
+
+const char* LatencyStageName(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::Wait:
+        return "wait";
+    case LatencyStage::Convert:
+        return "convert";
+    case LatencyStage::Requeue:
+        return "requeue";
+    case LatencyStage::Encode:
+        return "encode";
+    case LatencyStage::Write:
+        return "write";
+    case LatencyStage::WriteQueue:
+        return "write_queue";
+    case LatencyStage::Trigger:
+        return "trigger";
+    case LatencyStage::Http:
+        return "http";
+    case LatencyStage::Preview:
+        return "preview";
+    case LatencyStage::Barcode:
+        return "barcode";
+    case LatencyStage::Display:
+        return "display";
+    default:
+        return "unknown";
+    }
+}
+
+
+void LatencyHistogram::Record(uint64_t duration_ns)
+{
+    // Single writer: plain load/store instead of read-modify-write keeps the hot path free of locked instructions
+    auto& bucket = m_buckets[BucketIndex(duration_ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_sum_ns.store(m_sum_ns.load(std::memory_order_relaxed) + duration_ns, std::memory_order_relaxed);
+    if (duration_ns > m_max_ns.load(std::memory_order_relaxed))
+    {
+        m_max_ns.store(duration_ns, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::MergeInto(std::vector<uint64_t>& counts, uint64_t& sum_ns, uint64_t& max_ns) const
+{
+    for (size_t index = 0; index < BucketCount; ++index)
+    {
+        counts[index] += m_buckets[index].load(std::memory_order_relaxed);
+    }
+    sum_ns += m_sum_ns.load(std::memory_order_relaxed);
+    max_ns = std::max(max_ns, m_max_ns.load(std::memory_order_relaxed));
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t duration_ns)
+{
+    const uint64_t linearLimit = uint64_t{ 2 } << SubBucketBits;
+    if (duration_ns < linearLimit)
+    {
+        return static_cast<size_t>(duration_ns);
+    }
+
+    const auto msb = std::min(mostSignificantBit(duration_ns), MaxValueBits - 1);
+    const auto shift = msb - SubBucketBits;
+    // The top SubBucketBits + 1 bits, i.e. a value in [2^SubBucketBits, 2^(SubBucketBits + 1))
+    const auto top = std::min<uint64_t>(duration_ns >> shift, linearLimit - 1);
+    const auto subBuckets = size_t{ 1 } << SubBucketBits;
+
+    return static_cast<size_t>(linearLimit) + (msb - SubBucketBits - 1) * subBuckets
+        + static_cast<size_t>(top - subBuckets);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index)
+{
+    const size_t linearLimit = size_t{ 2 } << SubBucketBits;
+    if (index < linearLimit)
+    {
+        return index;
+    }
+
+    const auto subBuckets = size_t{ 1 } << SubBucketBits;
+    const auto group = (index - linearLimit) / subBuckets;
+    const auto sub = (index - linearLimit) % subBuckets;
+    const auto shift = static_cast<unsigned>(group + 1);
+
+    return ((uint64_t{ subBuckets + sub } + 1) << shift) - 1;
+}
+
+
+LatencyRecorder::LatencyRecorder()
+    : m_id(nextRecorderId++)
+{}
+
+LatencyRecorder::~LatencyRecorder() = default;
+
+void LatencyRecorder::Record(LatencyStage stage, std::chrono::steady_clock::duration duration)
+{
+    const auto duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    threadHistograms().stages[static_cast<size_t>(stage)].Record(
+        duration_ns > 0 ? static_cast<uint64_t>(duration_ns) : 0);
+}
+
+void LatencyRecorder::Record(LatencyStage stage, std::chrono::steady_clock::time_point start)
+{
+    Record(stage, std::chrono::steady_clock::now() - start);
+}
+
+LatencySummary LatencyRecorder::Summary(LatencyStage stage) const
+{
+    std::vector<uint64_t> counts(LatencyHistogram::BucketCount, 0);
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& thread : m_threads)
+        {
+            thread->stages[static_cast<size_t>(stage)].MergeInto(counts, sum_ns, max_ns);
+        }
+    }
+
+    LatencySummary summary;
+    for (const auto count : counts)
+    {
+        summary.count += count;
+    }
+    if (summary.count == 0)
+    {
+        return summary;
+    }
+
+    summary.mean_us = static_cast<double>(sum_ns) / static_cast<double>(summary.count) / 1000.0;
+    summary.p50_us = percentile_us(counts, summary.count, 0.5, max_ns);
+    summary.p99_us = percentile_us(counts, summary.count, 0.99, max_ns);
+    summary.p999_us = percentile_us(counts, summary.count, 0.999, max_ns);
+    summary.max_us = static_cast<double>(max_ns) / 1000.0;
+    return summary;
+}
+
+void LatencyRecorder::Dump(std::ostream& stream) const
+{
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+
+    stream << std::fixed << std::setprecision(3);
+    for (size_t index = 0; index < static_cast<size_t>(LatencyStage::Count); ++index)
+    {
+        const auto stage = static_cast<LatencyStage>(index);
+        const auto summary = Summary(stage);
+        if (summary.count == 0)
+        {
+            continue;
+        }
+
+        stream << "latency " << std::left << std::setw(11) << LatencyStageName(stage) << std::right
+               << " n=" << summary.count << " mean=" << summary.mean_us / 1000.0
+               << "ms p50=" << summary.p50_us / 1000.0 << "ms p99=" << summary.p99_us / 1000.0
+               << "ms p999=" << summary.p999_us / 1000.0 << "ms max=" << summary.max_us / 1000.0 << "ms"
+               << std::endl;
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+LatencyRecorder::ThreadHistograms& LatencyRecorder::threadHistograms()
+{
+    // Recorders this thread has written to. The last one is checked first, a thread rarely writes to more than one.
+    thread_local std::vector<std::pair<uint64_t, ThreadHistograms*>> registered;
+
+    if (!registered.empty() && registered.back().first == m_id)
+    {
+        return *registered.back().second;
+    }
+
+    for (auto& entry : registered)
+    {
+        if (entry.first == m_id)
+        {
+            std::swap(entry, registered.back());
+            return *registered.back().second;
+        }
+    }
+
+    // The histograms stay with the recorder, samples of a thread that has exited are still reported
+    auto histograms = std::make_unique<ThreadHistograms>();
+    auto* pointer = histograms.get();
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        m_threads.push_back(std::move(histograms));
+    }
+    registered.emplace_back(m_id, pointer);
+    return *pointer;
+}
+
+
+LatencyRecorder::Scope::Scope(LatencyRecorder* recorder, LatencyStage stage)
+    : m_recorder(recorder)
+    , m_stage(stage)
+    , m_start(recorder ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+{}
+
+LatencyRecorder::Scope::~Scope()
+{
+    if (m_recorder)
+    {
+        m_recorder->Record(m_stage, m_start);
+    }
+}
@@ -0,0 +1,166 @@
+/*!
+ * \file    latencyhistogram.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The LatencyRecorder class collects per-stage latencies of the
+ *          acquisition loop in log-linear histograms. Every thread records
+ *          into its own histograms without locks, a reader merges them into
+ *          p50/p99/p999/max per stage.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+enum class LatencyStage
+{
+    // TriggerSoftware until the buffer is returned by WaitForFinishedBuffer, or the wait itself in free run
+    Wait,
+    // Debayering / pixel format conversion
+    Convert,
+    // QueueBuffer of the consumed buffer
+    Requeue,
+    // JPEG encoding
+    Encode,
+    // Writing the encoded frame to disk
+    Write,
+    // Waiting in a WriteBehindQueue for a writer thread
+    WriteQueue,
+    // TriggerSoftware until the capture result is available
+    Trigger,
+    // A complete HTTP request until its response is sent
+    Http,
+    // Encoding a live preview frame
+    Preview,
+    // Decoding the barcodes of a captured frame
+    Barcode,
+    // Handing a converted frame to the display in the Qt samples
+    Display,
+    Count
+};
+
+const char* LatencyStageName(LatencyStage stage);
+
+
+/*!
+ * \brief Latency distribution of one stage. All durations are in microseconds, percentiles are accurate to ~3%.
+ */
+struct LatencySummary
+{
+    uint64_t count = 0;
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double p999_us = 0.0;
+    double max_us = 0.0;
+};
+
+
+/*!
+ * \brief Log-linear histogram of nanosecond durations with 32 linear sub-buckets per power of two.
+ *
+ * Exactly one thread may call Record(), any thread may read concurrently. Readers see each bucket atomically but
+ * not the histogram as a whole, which is fine for monitoring.
+ */
+class LatencyHistogram
+{
+
+public:
+    void Record(uint64_t duration_ns);
+
+    // Adds the buckets of this histogram to \p counts, which must have BucketCount entries
+    void MergeInto(std::vector<uint64_t>& counts, uint64_t& sum_ns, uint64_t& max_ns) const;
+
+    static size_t BucketIndex(uint64_t duration_ns);
+    // Largest duration that falls into \p index
+    static uint64_t BucketUpperBound(size_t index);
+
+    static const unsigned SubBucketBits = 5;
+    // Durations above 2^40 ns (~18 minutes) are clamped into the last bucket
+    static const unsigned MaxValueBits = 40;
+    // Values below 2^(SubBucketBits + 1) get one bucket each, every higher power of two gets 2^SubBucketBits
+    static const size_t BucketCount =
+        (size_t{ 2 } << SubBucketBits) + (MaxValueBits - SubBucketBits - 1) * (size_t{ 1 } << SubBucketBits);
+
+private:
+    std::array<std::atomic<uint64_t>, BucketCount> m_buckets{};
+    std::atomic<uint64_t> m_sum_ns{ 0 };
+    std::atomic<uint64_t> m_max_ns{ 0 };
+};
+
+
+/*!
+ * \brief Per-thread, per-stage latency histograms.
+ *
+ * Record() is lock-free: the first call of a thread registers a set of histograms for it under a mutex, every later
+ * call only touches that thread's histograms. Summary() and Dump() merge the histograms of all threads. Values are
+ * totals since construction.
+ */
+class LatencyRecorder
+{
+
+public:
+    LatencyRecorder();
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+    void Record(LatencyStage stage, std::chrono::steady_clock::duration duration);
+    void Record(LatencyStage stage, std::chrono::steady_clock::time_point start);
+
+    LatencySummary Summary(LatencyStage stage) const;
+
+    // Writes one line per stage that has samples
+    void Dump(std::ostream& stream) const;
+
+    /*!
+     * \brief Records the time from construction to destruction of the scope.
+     */
+    class Scope
+    {
+
+    public:
+        // A null recorder makes the scope a no-op, so instrumentation can stay in place when it is disabled
+        Scope(LatencyRecorder* recorder, LatencyStage stage);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LatencyRecorder* m_recorder;
+        LatencyStage m_stage;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+private:
+    struct ThreadHistograms
+    {
+        std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::Count)> stages;
+    };
+
+    ThreadHistograms& threadHistograms();
+
+    // Distinguishes recorders in the thread-local lookup, never reused
+    const uint64_t m_id;
+
+    mutable std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadHistograms>> m_threads;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,2555 @@
+/*!
+ * \file    matrixcodedecoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The MatrixCodeDecoder class reads QR Code and Data Matrix
+ *          (ECC 200) symbols from a binarized image. QR Codes are found by
+ *          their three finder patterns, Data Matrix symbols by the solid L
+ *          along two of their sides. Both are sampled module by module and
+ *          repaired by their Reed-Solomon error correction, so a symbol that
+ *          reads at all reads right. BarcodeDecoder binarizes the image with
+ *          its SIMD kernels and runs this decoder on it.
+ *
+ * \version 1.0.0
+ */
+
+#include "matrixcodedecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+
+
+namespace
+{
+
+// Arithmetic in GF(256) built from the primitive polynomial, with x as the generator
+class GaloisField
+{
+
+public:
+    explicit GaloisField(unsigned primitive)
+    {
+        unsigned value = 1;
+        for (int power = 0; power < 255; ++power)
+        {
+            m_exp[power] = static_cast<uint8_t>(value);
+            m_log[value] = power;
+            value <<= 1;
+            if (value & 0x100)
+            {
+                value ^= primitive;
+            }
+        }
+        // Doubled, so a product needs no modulo
+        for (int power = 255; power < 512; ++power)
+        {
+            m_exp[power] = m_exp[power - 255];
+        }
+        m_log[0] = 0;
+    }
+
+    uint8_t Multiply(uint8_t a, uint8_t b) const
+    {
+        return (a && b) ? m_exp[m_log[a] + m_log[b]] : 0;
+    }
+
+    // \p a must not be 0
+    uint8_t Inverse(uint8_t a) const
+    {
+        return m_exp[255 - m_log[a]];
+    }
+
+    uint8_t Exp(int power) const
+    {
+        return m_exp[((power % 255) + 255) % 255];
+    }
+
+    int Log(uint8_t a) const
+    {
+        return m_log[a];
+    }
+
+private:
+    uint8_t m_exp[512];
+    int m_log[256];
+};
+
+// QR Code uses x^8 + x^4 + x^3 + x^2 + 1 and the generator roots a^0, a^1, ...
+const GaloisField& qrField()
+{
+    static const GaloisField field(0x11D);
+    return field;
+}
+
+// Data Matrix uses x^8 + x^5 + x^3 + x^2 + 1 and the generator roots a^1, a^2, ...
+const GaloisField& dataMatrixField()
+{
+    static const GaloisField field(0x12D);
+    return field;
+}
+
+uint8_t evaluate(const GaloisField& field, const std::vector<uint8_t>& codewords, uint8_t x)
+{
+    // The first codeword is the coefficient of the highest power
+    uint8_t result = 0;
+    for (const auto codeword : codewords)
+    {
+        result = field.Multiply(result, x) ^ codeword;
+    }
+    return result;
+}
+
+/*!
+ * Corrects up to \p eccCount / 2 wrong codewords of a Reed-Solomon block in place, data first and the \p eccCount
+ * error correction codewords last. \p firstRoot is the power of the first root of the generator polynomial. Returns
+ * false if the block has more errors than that.
+ */
+bool correctErrors(const GaloisField& field, int firstRoot, size_t eccCount, std::vector<uint8_t>& codewords)
+{
+    std::vector<uint8_t> syndromes(eccCount);
+    bool clean = true;
+    for (size_t i = 0; i < eccCount; ++i)
+    {
+        syndromes[i] = evaluate(field, codewords, field.Exp(firstRoot + static_cast<int>(i)));
+        clean = clean && syndromes[i] == 0;
+    }
+    if (clean)
+    {
+        return true;
+    }
+
+    // Berlekamp-Massey finds the error locator, polynomials lowest power first
+    std::vector<uint8_t> locator{ 1 };
+    std::vector<uint8_t> previous{ 1 };
+    size_t errors = 0;
+    size_t shift = 1;
+    uint8_t previousDiscrepancy = 1;
+    for (size_t step = 0; step < eccCount; ++step)
+    {
+        auto discrepancy = syndromes[step];
+        for (size_t i = 1; i <= errors && i < locator.size(); ++i)
+        {
+            discrepancy ^= field.Multiply(locator[i], syndromes[step - i]);
+        }
+        if (discrepancy == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        const auto scale = field.Multiply(discrepancy, field.Inverse(previousDiscrepancy));
+        auto updated = locator;
+        updated.resize(std::max(locator.size(), previous.size() + shift), 0);
+        for (size_t i = 0; i < previous.size(); ++i)
+        {
+            updated[i + shift] ^= field.Multiply(scale, previous[i]);
+        }
+
+        if (2 * errors <= step)
+        {
+            previous = locator;
+            errors = step + 1 - errors;
+            previousDiscrepancy = discrepancy;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+        locator = std::move(updated);
+    }
+    while (locator.size() > 1 && locator.back() == 0)
+    {
+        locator.pop_back();
+    }
+    if (errors == 0 || errors > eccCount / 2 || locator.size() != errors + 1)
+    {
+        return false;
+    }
+
+    // The error evaluator, syndromes times locator cut at eccCount
+    std::vector<uint8_t> evaluator(eccCount, 0);
+    for (size_t i = 0; i < eccCount; ++i)
+    {
+        for (size_t j = 0; j < locator.size() && j <= i; ++j)
+        {
+            evaluator[i] ^= field.Multiply(syndromes[i - j], locator[j]);
+        }
+    }
+
+    // Chien search over every codeword, Forney for the size of each error
+    const auto count = codewords.size();
+    size_t found = 0;
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto power = static_cast<int>(count - 1 - index);
+        const auto inverse = field.Exp(-power);
+
+        uint8_t value = 0;
+        for (size_t i = locator.size(); i-- > 0;)
+        {
+            value = field.Multiply(value, inverse) ^ locator[i];
+        }
+        if (value != 0)
+        {
+            continue;
+        }
+
+        uint8_t numerator = 0;
+        for (size_t i = evaluator.size(); i-- > 0;)
+        {
+            numerator = field.Multiply(numerator, inverse) ^ evaluator[i];
+        }
+        // The formal derivative keeps the odd powers
+        uint8_t denominator = 0;
+        for (size_t i = locator.size(); i-- > 0;)
+        {
+            if (i % 2 == 1)
+            {
+                denominator ^= field.Multiply(locator[i], field.Exp(-power * static_cast<int>(i - 1)));
+            }
+        }
+        if (denominator == 0)
+        {
+            return false;
+        }
+
+        auto magnitude = field.Multiply(numerator, field.Inverse(denominator));
+        magnitude = field.Multiply(magnitude, field.Exp(power * (1 - firstRoot)));
+        codewords[index] ^= magnitude;
+        found++;
+    }
+    if (found != errors)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < eccCount; ++i)
+    {
+        if (evaluate(field, codewords, field.Exp(firstRoot + static_cast<int>(i))) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Reads the bits of a codeword sequence, most significant first
+class BitReader
+{
+
+public:
+    explicit BitReader(const std::vector<uint8_t>& bytes)
+        : m_bytes(bytes)
+    {}
+
+    size_t Available() const
+    {
+        return 8 * m_bytes.size() - m_position;
+    }
+
+    // Index of the byte the next bit comes from
+    size_t BytePosition() const
+    {
+        return m_position / 8;
+    }
+
+    // \p count of at most 32, the caller checks Available() first
+    uint32_t Read(size_t count)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < count; ++i, ++m_position)
+        {
+            value = (value << 1) | ((m_bytes[m_position / 8] >> (7 - m_position % 8)) & 1u);
+        }
+        return value;
+    }
+
+    // Skips the rest of the current byte
+    void Align()
+    {
+        m_position = (m_position + 7) / 8 * 8;
+    }
+
+private:
+    const std::vector<uint8_t>& m_bytes;
+    size_t m_position = 0;
+};
+
+
+struct Point
+{
+    float x;
+    float y;
+};
+
+Point operator+(Point a, Point b)
+{
+    return { a.x + b.x, a.y + b.y };
+}
+
+Point operator-(Point a, Point b)
+{
+    return { a.x - b.x, a.y - b.y };
+}
+
+Point operator*(float factor, Point a)
+{
+    return { factor * a.x, factor * a.y };
+}
+
+float distance(Point a, Point b)
+{
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+float cross(Point a, Point b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+// Maps points of one plane to another, e.g. module coordinates to pixels
+class PerspectiveTransform
+{
+
+public:
+    // Maps the corners of one quadrilateral to those of the other, in the same order around both
+    static PerspectiveTransform QuadrilateralToQuadrilateral(
+        const std::array<Point, 4>& from, const std::array<Point, 4>& to)
+    {
+        return squareTo(to).times(squareTo(from).inverse());
+    }
+
+    Point Map(Point point) const
+    {
+        const auto w = m[6] * point.x + m[7] * point.y + m[8];
+        return { (m[0] * point.x + m[1] * point.y + m[2]) / w, (m[3] * point.x + m[4] * point.y + m[5]) / w };
+    }
+
+private:
+    // Row major, the last row divides
+    std::array<float, 9> m;
+
+    // Maps (0, 0), (1, 0), (1, 1) and (0, 1) to the corners
+    static PerspectiveTransform squareTo(const std::array<Point, 4>& corners)
+    {
+        const auto& p0 = corners[0];
+        const auto& p1 = corners[1];
+        const auto& p2 = corners[2];
+        const auto& p3 = corners[3];
+        const auto dx3 = p0.x - p1.x + p2.x - p3.x;
+        const auto dy3 = p0.y - p1.y + p2.y - p3.y;
+
+        PerspectiveTransform transform;
+        if (dx3 == 0.0f && dy3 == 0.0f)
+        {
+            transform.m = { p1.x - p0.x, p2.x - p1.x, p0.x, p1.y - p0.y, p2.y - p1.y, p0.y, 0.0f, 0.0f, 1.0f };
+            return transform;
+        }
+
+        const auto dx1 = p1.x - p2.x;
+        const auto dx2 = p3.x - p2.x;
+        const auto dy1 = p1.y - p2.y;
+        const auto dy2 = p3.y - p2.y;
+        const auto denominator = dx1 * dy2 - dx2 * dy1;
+        const auto g = (dx3 * dy2 - dx2 * dy3) / denominator;
+        const auto h = (dx1 * dy3 - dx3 * dy1) / denominator;
+        transform.m = { p1.x - p0.x + g * p1.x, p3.x - p0.x + h * p3.x, p0.x, p1.y - p0.y + g * p1.y,
+            p3.y - p0.y + h * p3.y, p0.y, g, h, 1.0f };
+        return transform;
+    }
+
+    // The adjugate, which inverts up to the scale the division removes anyway
+    PerspectiveTransform inverse() const
+    {
+        PerspectiveTransform result;
+        result.m = { m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+            m[5] * m[6] - m[3] * m[8], m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+            m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3] };
+        return result;
+    }
+
+    // This after \p other
+    PerspectiveTransform times(const PerspectiveTransform& other) const
+    {
+        PerspectiveTransform result;
+        for (size_t row = 0; row < 3; ++row)
+        {
+            for (size_t column = 0; column < 3; ++column)
+            {
+                result.m[3 * row + column] = m[3 * row] * other.m[column] + m[3 * row + 1] * other.m[3 + column]
+                    + m[3 * row + 2] * other.m[6 + column];
+            }
+        }
+        return result;
+    }
+};
+
+// Whether the pixel under a point is dark, false outside the image
+bool darkAt(const BinaryImage& image, Point point)
+{
+    if (!(point.x >= 0.0f && point.y >= 0.0f))
+    {
+        return false;
+    }
+    const auto x = static_cast<size_t>(point.x);
+    const auto y = static_cast<size_t>(point.y);
+    return x < image.width && y < image.height && image.Dark(x, y);
+}
+
+/*!
+ * Samples the centre of every module of a \p columns x \p rows grid, row by row. Module (x, y) covers (x, y) to
+ * (x + 1, y + 1) of the grid plane. Returns false if the grid reaches more than a pixel out of the image, a module
+ * there can't be right.
+ */
+bool sampleGrid(const BinaryImage& image, const PerspectiveTransform& transform, size_t columns, size_t rows,
+    std::vector<uint8_t>& modules)
+{
+    modules.assign(columns * rows, 0);
+    const auto right = static_cast<float>(image.width);
+    const auto bottom = static_cast<float>(image.height);
+    for (size_t y = 0; y < rows; ++y)
+    {
+        for (size_t x = 0; x < columns; ++x)
+        {
+            auto point = transform.Map({ static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f });
+            if (!(point.x >= -1.0f && point.y >= -1.0f && point.x <= right + 1.0f && point.y <= bottom + 1.0f))
+            {
+                return false;
+            }
+            point.x = std::min(std::max(point.x, 0.0f), right - 0.5f);
+            point.y = std::min(std::max(point.y, 0.0f), bottom - 0.5f);
+            modules[y * columns + x] = darkAt(image, point) ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Widths of the light and dark runs of a row, starting with a light one that is empty if the row starts dark, like
+ * the runs of a scan line in BarcodeDecoder.
+ */
+void rowRuns(const BinaryImage& image, size_t y, std::vector<uint32_t>& runs)
+{
+    runs.clear();
+    const auto* row = &image.bits[y * image.stride];
+    bool dark = false;
+    uint32_t length = 0;
+    for (size_t word = 0; word < image.stride; ++word)
+    {
+        const auto bits = row[word];
+        const auto count = std::min<size_t>(64, image.width - 64 * word);
+        // Whole words of one colour are common, they extend the run at once
+        if ((bits == 0 && !dark) || (bits == ~uint64_t{ 0 } && dark && count == 64))
+        {
+            length += static_cast<uint32_t>(count);
+            continue;
+        }
+        for (size_t bit = 0; bit < count; ++bit)
+        {
+            const bool pixel = ((bits >> bit) & 1) != 0;
+            if (pixel != dark)
+            {
+                runs.push_back(length);
+                length = 0;
+                dark = pixel;
+            }
+            length++;
+        }
+    }
+    runs.push_back(length);
+}
+
+
+// ----------------------------------------------------------------------------------------------------------------
+// QR Code
+
+// A finder pattern, the centre of its 7x7 module square
+struct FinderPattern
+{
+    Point center;
+    float module;
+    // Scan rows that found it
+    size_t count;
+};
+
+// Whether dark, light, dark, light, dark widths are in the 1:1:3:1:1 ratio of a finder pattern
+bool finderRatio(const uint32_t counts[5])
+{
+    const auto total = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+    if (total < 7 || std::find(counts, counts + 5, 0u) != counts + 5)
+    {
+        return false;
+    }
+    const auto module = static_cast<float>(total) / 7.0f;
+    const auto allowed = module / 2.0f;
+    return std::abs(module - counts[0]) < allowed && std::abs(module - counts[1]) < allowed
+        && std::abs(3.0f * module - counts[2]) < 3.0f * allowed && std::abs(module - counts[3]) < allowed
+        && std::abs(module - counts[4]) < allowed;
+}
+
+/*!
+ * Walks through a finder pattern from a pixel of its centre along (dx, dy) both ways and returns the offset of its
+ * centre along that line in steps, or NaN if the line does not cross a finder pattern. \p maxCount bounds each run
+ * but the middle, \p total is the width along the scan row, 0 to skip the comparison.
+ */
+float crossCheck(
+    const BinaryImage& image, long x, long y, long dx, long dy, uint32_t maxCount, uint32_t total, uint32_t& width)
+{
+    const auto columns = static_cast<long>(image.width);
+    const auto rows = static_cast<long>(image.height);
+    auto inside = [&](long step) {
+        const auto px = x + step * dx;
+        const auto py = y + step * dy;
+        return px >= 0 && py >= 0 && px < columns && py < rows;
+    };
+    auto dark = [&](long step) {
+        return image.Dark(static_cast<size_t>(x + step * dx), static_cast<size_t>(y + step * dy));
+    };
+
+    uint32_t counts[5] = {};
+    long step = 0;
+    while (inside(step) && dark(step))
+    {
+        counts[2]++;
+        step--;
+    }
+    if (!inside(step))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    while (inside(step) && !dark(step) && counts[1] <= maxCount)
+    {
+        counts[1]++;
+        step--;
+    }
+    if (!inside(step) || counts[1] > maxCount)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    while (inside(step) && dark(step) && counts[0] <= maxCount)
+    {
+        counts[0]++;
+        step--;
+    }
+    if (counts[0] > maxCount)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    step = 1;
+    while (inside(step) && dark(step))
+    {
+        counts[2]++;
+        step++;
+    }
+    if (!inside(step))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    while (inside(step) && !dark(step) && counts[3] < maxCount)
+    {
+        counts[3]++;
+        step++;
+    }
+    if (!inside(step) || counts[3] >= maxCount)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    while (inside(step) && dark(step) && counts[4] < maxCount)
+    {
+        counts[4]++;
+        step++;
+    }
+    if (counts[4] >= maxCount)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    width = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+    // A line through a different pattern, or along an edge, differs in width
+    if (total && 5 * static_cast<uint32_t>(std::abs(static_cast<long>(width) - static_cast<long>(total))) >= 2 * total)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (!finderRatio(counts))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    // From the pixel at step 0 to the middle of the centre run
+    return static_cast<float>(step - static_cast<long>(counts[4]) - static_cast<long>(counts[3]))
+        - static_cast<float>(counts[2]) / 2.0f;
+}
+
+/*!
+ * Confirms a finder pattern found on a scan row by crossing it vertically, horizontally again at the vertical centre
+ * and diagonally, and adds it to \p patterns or to the pattern at the same place.
+ */
+void handleFinder(
+    const BinaryImage& image, float centerX, size_t row, const uint32_t counts[5], std::vector<FinderPattern>& patterns)
+{
+    const auto total = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+    uint32_t verticalWidth = 0;
+    const auto x = static_cast<long>(centerX);
+    const auto dy = crossCheck(image, x, static_cast<long>(row), 0, 1, counts[2], total, verticalWidth);
+    if (std::isnan(dy))
+    {
+        return;
+    }
+    const auto centerY = static_cast<float>(row) + dy;
+
+    uint32_t horizontalWidth = 0;
+    const auto y = static_cast<long>(centerY);
+    const auto dx = crossCheck(image, x, y, 1, 0, counts[2], total, horizontalWidth);
+    if (std::isnan(dx))
+    {
+        return;
+    }
+    centerX = static_cast<float>(x) + dx;
+
+    // Text and stripes pass the straight lines now and then, hardly ever the diagonal as well
+    uint32_t diagonalWidth = 0;
+    if (std::isnan(crossCheck(image, static_cast<long>(centerX), y, 1, 1, counts[2] * 2, 0, diagonalWidth)))
+    {
+        return;
+    }
+
+    const auto module = static_cast<float>(verticalWidth + horizontalWidth) / 14.0f;
+    for (auto& pattern : patterns)
+    {
+        if (std::abs(pattern.center.x - centerX) <= module && std::abs(pattern.center.y - centerY) <= module
+            && std::abs(pattern.module - module) <= std::max(1.0f, pattern.module / 2.0f))
+        {
+            const auto weight = static_cast<float>(pattern.count);
+            pattern.center.x = (pattern.center.x * weight + centerX) / (weight + 1.0f);
+            pattern.center.y = (pattern.center.y * weight + centerY) / (weight + 1.0f);
+            pattern.module = (pattern.module * weight + module) / (weight + 1.0f);
+            pattern.count++;
+            return;
+        }
+    }
+    patterns.push_back({ { centerX, centerY }, module, 1 });
+}
+
+std::vector<FinderPattern> findFinderPatterns(const BinaryImage& image)
+{
+    std::vector<FinderPattern> patterns;
+    std::vector<uint32_t> runs;
+    // Every other row still crosses the 3 module centre of a pattern at 2 pixels per module twice
+    for (size_t y = 0; y < image.height; y += 2)
+    {
+        rowRuns(image, y, runs);
+        uint32_t position = runs[0];
+        // Dark runs are at odd indices
+        for (size_t i = 1; i + 4 < runs.size(); i += 2)
+        {
+            const uint32_t counts[5] = { runs[i], runs[i + 1], runs[i + 2], runs[i + 3], runs[i + 4] };
+            if (finderRatio(counts))
+            {
+                const auto centerX = static_cast<float>(position + counts[0] + counts[1])
+                    + static_cast<float>(counts[2]) / 2.0f;
+                handleFinder(image, centerX, y, counts, patterns);
+            }
+            position += runs[i] + runs[i + 1];
+        }
+    }
+
+    // A pattern crossed by a single row is mostly a coincidence
+    patterns.erase(std::remove_if(patterns.begin(), patterns.end(),
+                       [](const FinderPattern& pattern) { return pattern.count < 2; }),
+        patterns.end());
+    std::stable_sort(patterns.begin(), patterns.end(),
+        [](const FinderPattern& a, const FinderPattern& b) { return a.count > b.count; });
+    return patterns;
+}
+
+// Error correction blocks of a version and level: codewords per block, count of the shorter blocks and their data
+// codewords, count of the longer blocks, which have one data codeword more
+struct QrBlocks
+{
+    uint8_t ecc;
+    uint8_t shortCount;
+    uint8_t shortData;
+    uint8_t longCount;
+};
+
+// By version and level L, M, Q, H, ISO/IEC 18004 table 9
+const QrBlocks qrBlocks[40][4] = {
+    { { 7, 1, 19, 0 }, { 10, 1, 16, 0 }, { 13, 1, 13, 0 }, { 17, 1, 9, 0 } },
+    { { 10, 1, 34, 0 }, { 16, 1, 28, 0 }, { 22, 1, 22, 0 }, { 28, 1, 16, 0 } },
+    { { 15, 1, 55, 0 }, { 26, 1, 44, 0 }, { 18, 2, 17, 0 }, { 22, 2, 13, 0 } },
+    { { 20, 1, 80, 0 }, { 18, 2, 32, 0 }, { 26, 2, 24, 0 }, { 16, 4, 9, 0 } },
+    { { 26, 1, 108, 0 }, { 24, 2, 43, 0 }, { 18, 2, 15, 2 }, { 22, 2, 11, 2 } },
+    { { 18, 2, 68, 0 }, { 16, 4, 27, 0 }, { 24, 4, 19, 0 }, { 28, 4, 15, 0 } },
+    { { 20, 2, 78, 0 }, { 18, 4, 31, 0 }, { 18, 2, 14, 4 }, { 26, 4, 13, 1 } },
+    { { 24, 2, 97, 0 }, { 22, 2, 38, 2 }, { 22, 4, 18, 2 }, { 26, 4, 14, 2 } },
+    { { 30, 2, 116, 0 }, { 22, 3, 36, 2 }, { 20, 4, 16, 4 }, { 24, 4, 12, 4 } },
+    { { 18, 2, 68, 2 }, { 26, 4, 43, 1 }, { 24, 6, 19, 2 }, { 28, 6, 15, 2 } },
+    { { 20, 4, 81, 0 }, { 30, 1, 50, 4 }, { 28, 4, 22, 4 }, { 24, 3, 12, 8 } },
+    { { 24, 2, 92, 2 }, { 22, 6, 36, 2 }, { 26, 4, 20, 6 }, { 28, 7, 14, 4 } },
+    { { 26, 4, 107, 0 }, { 22, 8, 37, 1 }, { 24, 8, 20, 4 }, { 22, 12, 11, 4 } },
+    { { 30, 3, 115, 1 }, { 24, 4, 40, 5 }, { 20, 11, 16, 5 }, { 24, 11, 12, 5 } },
+    { { 22, 5, 87, 1 }, { 24, 5, 41, 5 }, { 30, 5, 24, 7 }, { 24, 11, 12, 7 } },
+    { { 24, 5, 98, 1 }, { 28, 7, 45, 3 }, { 24, 15, 19, 2 }, { 30, 3, 15, 13 } },
+    { { 28, 1, 107, 5 }, { 28, 10, 46, 1 }, { 28, 1, 22, 15 }, { 28, 2, 14, 17 } },
+    { { 30, 5, 120, 1 }, { 26, 9, 43, 4 }, { 28, 17, 22, 1 }, { 28, 2, 14, 19 } },
+    { { 28, 3, 113, 4 }, { 26, 3, 44, 11 }, { 26, 17, 21, 4 }, { 26, 9, 13, 16 } },
+    { { 28, 3, 107, 5 }, { 26, 3, 41, 13 }, { 30, 15, 24, 5 }, { 28, 15, 15, 10 } },
+    { { 28, 4, 116, 4 }, { 26, 17, 42, 0 }, { 28, 17, 22, 6 }, { 30, 19, 16, 6 } },
+    { { 28, 2, 111, 7 }, { 28, 17, 46, 0 }, { 30, 7, 24, 16 }, { 24, 34, 13, 0 } },
+    { { 30, 4, 121, 5 }, { 28, 4, 47, 14 }, { 30, 11, 24, 14 }, { 30, 16, 15, 14 } },
+    { { 30, 6, 117, 4 }, { 28, 6, 45, 14 }, { 30, 11, 24, 16 }, { 30, 30, 16, 2 } },
+    { { 26, 8, 106, 4 }, { 28, 8, 47, 13 }, { 30, 7, 24, 22 }, { 30, 22, 15, 13 } },
+    { { 28, 10, 114, 2 }, { 28, 19, 46, 4 }, { 28, 28, 22, 6 }, { 30, 33, 16, 4 } },
+    { { 30, 8, 122, 4 }, { 28, 22, 45, 3 }, { 30, 8, 23, 26 }, { 30, 12, 15, 28 } },
+    { { 30, 3, 117, 10 }, { 28, 3, 45, 23 }, { 30, 4, 24, 31 }, { 30, 11, 15, 31 } },
+    { { 30, 7, 116, 7 }, { 28, 21, 45, 7 }, { 30, 1, 23, 37 }, { 30, 19, 15, 26 } },
+    { { 30, 5, 115, 10 }, { 28, 19, 47, 10 }, { 30, 15, 24, 25 }, { 30, 23, 15, 25 } },
+    { { 30, 13, 115, 3 }, { 28, 2, 46, 29 }, { 30, 42, 24, 1 }, { 30, 23, 15, 28 } },
+    { { 30, 17, 115, 0 }, { 28, 10, 46, 23 }, { 30, 10, 24, 35 }, { 30, 19, 15, 35 } },
+    { { 30, 17, 115, 1 }, { 28, 14, 46, 21 }, { 30, 29, 24, 19 }, { 30, 11, 15, 46 } },
+    { { 30, 13, 115, 6 }, { 28, 14, 46, 23 }, { 30, 44, 24, 7 }, { 30, 59, 16, 1 } },
+    { { 30, 12, 121, 7 }, { 28, 12, 47, 26 }, { 30, 39, 24, 14 }, { 30, 22, 15, 41 } },
+    { { 30, 6, 121, 14 }, { 28, 6, 47, 34 }, { 30, 46, 24, 10 }, { 30, 2, 15, 64 } },
+    { { 30, 17, 122, 4 }, { 28, 29, 46, 14 }, { 30, 49, 24, 10 }, { 30, 24, 15, 46 } },
+    { { 30, 4, 122, 18 }, { 28, 13, 46, 32 }, { 30, 48, 24, 14 }, { 30, 42, 15, 32 } },
+    { { 30, 20, 117, 4 }, { 28, 40, 47, 7 }, { 30, 43, 24, 22 }, { 30, 10, 15, 67 } },
+    { { 30, 19, 118, 6 }, { 28, 18, 47, 31 }, { 30, 34, 24, 34 }, { 30, 20, 15, 61 } },
+};
+
+// Centres of the alignment patterns on both axes by version, ISO/IEC 18004 annex E, 0 ends the list
+const uint8_t qrAlignment[40][8] = {
+    {},
+    { 6, 18 },
+    { 6, 22 },
+    { 6, 26 },
+    { 6, 30 },
+    { 6, 34 },
+    { 6, 22, 38 },
+    { 6, 24, 42 },
+    { 6, 26, 46 },
+    { 6, 28, 50 },
+    { 6, 30, 54 },
+    { 6, 32, 58 },
+    { 6, 34, 62 },
+    { 6, 26, 46, 66 },
+    { 6, 26, 48, 70 },
+    { 6, 26, 50, 74 },
+    { 6, 30, 54, 78 },
+    { 6, 30, 56, 82 },
+    { 6, 30, 58, 86 },
+    { 6, 34, 62, 90 },
+    { 6, 28, 50, 72, 94 },
+    { 6, 26, 50, 74, 98 },
+    { 6, 30, 54, 78, 102 },
+    { 6, 28, 54, 80, 106 },
+    { 6, 32, 58, 84, 110 },
+    { 6, 30, 58, 86, 114 },
+    { 6, 34, 62, 90, 118 },
+    { 6, 26, 50, 74, 98, 122 },
+    { 6, 30, 54, 78, 102, 126 },
+    { 6, 26, 52, 78, 104, 130 },
+    { 6, 30, 56, 82, 108, 134 },
+    { 6, 34, 60, 86, 112, 138 },
+    { 6, 30, 58, 86, 114, 142 },
+    { 6, 34, 62, 90, 118, 146 },
+    { 6, 30, 54, 78, 102, 126, 150 },
+    { 6, 24, 50, 76, 102, 128, 154 },
+    { 6, 28, 54, 80, 106, 132, 158 },
+    { 6, 32, 58, 84, 110, 136, 162 },
+    { 6, 26, 54, 82, 110, 138, 166 },
+    { 6, 30, 58, 86, 114, 142, 170 },
+};
+
+// BCH code of \p data, \p bits long including the data, with the generator polynomial \p generator
+unsigned bchCode(unsigned data, unsigned dataBits, unsigned bits, unsigned generator)
+{
+    const auto checkBits = bits - dataBits;
+    auto remainder = data << checkBits;
+    for (auto bit = bits; bit-- > checkBits;)
+    {
+        if (remainder & (1u << bit))
+        {
+            remainder ^= generator << (bit - checkBits);
+        }
+    }
+    return (data << checkBits) | remainder;
+}
+
+// The valid code closest to \p read and its data, -1 if more than 3 bits are off
+int closestCode(unsigned read, unsigned first, unsigned last, unsigned dataBits, unsigned bits, unsigned generator,
+    unsigned mask)
+{
+    int best = -1;
+    auto bestDistance = 4;
+    for (auto data = first; data <= last; ++data)
+    {
+        const auto code = bchCode(data, dataBits, bits, generator) ^ mask;
+        const auto distance = __builtin_popcount(code ^ read);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = static_cast<int>(data);
+        }
+    }
+    return best;
+}
+
+// Modules of a version that are no data: finders with their separators and format information, timing, alignment
+// and version information
+std::vector<uint8_t> qrFunctionModules(int version)
+{
+    const auto dimension = static_cast<size_t>(17 + 4 * version);
+    std::vector<uint8_t> function(dimension * dimension, 0);
+    auto set = [&](size_t left, size_t top, size_t width, size_t height) {
+        for (size_t y = top; y < top + height; ++y)
+        {
+            std::fill_n(&function[y * dimension + left], width, 1);
+        }
+    };
+
+    set(0, 0, 9, 9);
+    set(dimension - 8, 0, 8, 9);
+    set(0, dimension - 8, 9, 8);
+
+    const auto* positions = qrAlignment[version - 1];
+    const auto count = static_cast<size_t>(std::find(positions, positions + 8, 0) - positions);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t j = 0; j < count; ++j)
+        {
+            // The corners with a finder pattern have none
+            if ((i == 0 && j == 0) || (i == 0 && j == count - 1) || (i == count - 1 && j == 0))
+            {
+                continue;
+            }
+            set(positions[j] - 2u, positions[i] - 2u, 5, 5);
+        }
+    }
+
+    set(6, 9, 1, dimension - 17);
+    set(9, 6, dimension - 17, 1);
+
+    if (version >= 7)
+    {
+        set(dimension - 11, 0, 3, 6);
+        set(0, dimension - 11, 6, 3);
+    }
+    return function;
+}
+
+bool qrMasked(unsigned mask, size_t row, size_t column)
+{
+    const auto sum = row + column;
+    const auto product = row * column;
+    switch (mask)
+    {
+    case 0:
+        return sum % 2 == 0;
+    case 1:
+        return row % 2 == 0;
+    case 2:
+        return column % 3 == 0;
+    case 3:
+        return sum % 3 == 0;
+    case 4:
+        return (row / 2 + column / 3) % 2 == 0;
+    case 5:
+        return product % 2 + product % 3 == 0;
+    case 6:
+        return (product % 2 + product % 3) % 2 == 0;
+    default:
+        return (sum % 2 + product % 3) % 2 == 0;
+    }
+}
+
+// Characters of the alphanumeric mode by value
+const char qrAlphanumeric[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+/*!
+ * Text of the data codewords of a QR Code. Byte, Kanji and Hanzi segments are passed on as their bytes, ECI
+ * designators and structured append headers are skipped. With FNC1 the % of alphanumeric segments is the GS
+ * separator. Returns false on a segment the data can't hold.
+ */
+bool qrText(const std::vector<uint8_t>& data, int version, std::string& text)
+{
+    BitReader bits(data);
+    const auto group = version <= 9 ? 0 : (version <= 26 ? 1 : 2);
+    bool fnc1 = false;
+    text.clear();
+
+    while (bits.Available() >= 4)
+    {
+        const auto mode = bits.Read(4);
+        switch (mode)
+        {
+        case 0x0:
+            // Terminator
+            return true;
+        case 0x1:
+        {
+            const size_t countBits[3] = { 10, 12, 14 };
+            if (bits.Available() < countBits[group])
+            {
+                return false;
+            }
+            auto count = bits.Read(countBits[group]);
+            while (count >= 3)
+            {
+                if (bits.Available() < 10)
+                {
+                    return false;
+                }
+                const auto value = bits.Read(10);
+                if (value >= 1000)
+                {
+                    return false;
+                }
+                text += static_cast<char>('0' + value / 100);
+                text += static_cast<char>('0' + value / 10 % 10);
+                text += static_cast<char>('0' + value % 10);
+                count -= 3;
+            }
+            if (count == 2)
+            {
+                if (bits.Available() < 7)
+                {
+                    return false;
+                }
+                const auto value = bits.Read(7);
+                if (value >= 100)
+                {
+                    return false;
+                }
+                text += static_cast<char>('0' + value / 10);
+                text += static_cast<char>('0' + value % 10);
+            }
+            else if (count == 1)
+            {
+                if (bits.Available() < 4)
+                {
+                    return false;
+                }
+                const auto value = bits.Read(4);
+                if (value >= 10)
+                {
+                    return false;
+                }
+                text += static_cast<char>('0' + value);
+            }
+            break;
+        }
+        case 0x2:
+        {
+            const size_t countBits[3] = { 9, 11, 13 };
+            if (bits.Available() < countBits[group])
+            {
+                return false;
+            }
+            auto count = bits.Read(countBits[group]);
+            std::string segment;
+            while (count >= 2)
+            {
+                if (bits.Available() < 11)
+                {
+                    return false;
+                }
+                const auto value = bits.Read(11);
+                if (value >= 45 * 45)
+                {
+                    return false;
+                }
+                segment += qrAlphanumeric[value / 45];
+                segment += qrAlphanumeric[value % 45];
+                count -= 2;
+            }
+            if (count == 1)
+            {
+                if (bits.Available() < 6)
+                {
+                    return false;
+                }
+                const auto value = bits.Read(6);
+                if (value >= 45)
+                {
+                    return false;
+                }
+                segment += qrAlphanumeric[value];
+            }
+            if (fnc1)
+            {
+                // %% stands for %, a single % for GS
+                std::string replaced;
+                for (size_t i = 0; i < segment.size(); ++i)
+                {
+                    if (segment[i] == '%' && i + 1 < segment.size() && segment[i + 1] == '%')
+                    {
+                        replaced += '%';
+                        ++i;
+                    }
+                    else
+                    {
+                        replaced += segment[i] == '%' ? '\x1D' : segment[i];
+                    }
+                }
+                segment.swap(replaced);
+            }
+            text += segment;
+            break;
+        }
+        case 0x4:
+        {
+            const size_t countBits = group == 0 ? 8 : 16;
+            if (bits.Available() < countBits)
+            {
+                return false;
+            }
+            const auto count = bits.Read(countBits);
+            if (bits.Available() < 8 * static_cast<size_t>(count))
+            {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                text += static_cast<char>(bits.Read(8));
+            }
+            break;
+        }
+        case 0x8:
+        case 0xD:
+        {
+            // Kanji as Shift JIS, Hanzi as GB 2312, 13 bits per character
+            if (mode == 0xD)
+            {
+                if (bits.Available() < 4)
+                {
+                    return false;
+                }
+                bits.Read(4);
+            }
+            const size_t countBits[3] = { 8, 10, 12 };
+            if (bits.Available() < countBits[group])
+            {
+                return false;
+            }
+            const auto count = bits.Read(countBits[group]);
+            if (bits.Available() < 13 * static_cast<size_t>(count))
+            {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const auto value = bits.Read(13);
+                unsigned assembled = 0;
+                if (mode == 0x8)
+                {
+                    assembled = ((value / 0xC0) << 8) | (value % 0xC0);
+                    assembled += assembled < 0x1F00 ? 0x8140 : 0xC140;
+                }
+                else
+                {
+                    assembled = ((value / 0x60) << 8) | (value % 0x60);
+                    assembled += assembled < 0xA00 ? 0xA1A1 : 0xA6A1;
+                }
+                text += static_cast<char>(assembled >> 8);
+                text += static_cast<char>(assembled & 0xFF);
+            }
+            break;
+        }
+        case 0x7:
+        {
+            // The character set of an ECI is left to the receiver, the bytes pass unchanged
+            if (bits.Available() < 8)
+            {
+                return false;
+            }
+            const auto first = bits.Read(8);
+            const size_t more = (first & 0x80) == 0 ? 0 : ((first & 0xC0) == 0x80 ? 8 : 16);
+            if (bits.Available() < more)
+            {
+                return false;
+            }
+            bits.Read(more);
+            break;
+        }
+        case 0x3:
+            // Structured append: position, total and parity of the symbol in its sequence
+            if (bits.Available() < 16)
+            {
+                return false;
+            }
+            bits.Read(16);
+            break;
+        case 0x5:
+            fnc1 = true;
+            break;
+        case 0x9:
+            // FNC1 in second position names the application with one byte
+            if (bits.Available() < 8)
+            {
+                return false;
+            }
+            bits.Read(8);
+            fnc1 = true;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Text of the sampled modules of a QR Code symbol of \p version. Reads the format information to unmask the data,
+ * collects the codewords, corrects each block and reads the segments. \p readVersion is set to the version of the
+ * version information from version 7 on, which overrides a wrong estimate of the caller.
+ */
+bool decodeQrModules(const std::vector<uint8_t>& modules, int version, int& readVersion, std::string& text)
+{
+    const auto dimension = static_cast<size_t>(17 + 4 * version);
+    auto module = [&](size_t x, size_t y) { return static_cast<unsigned>(modules[y * dimension + x]); };
+
+    readVersion = version;
+    if (version >= 7)
+    {
+        // 6x3 blocks beside the top right and above the bottom left finder pattern, mirrored
+        unsigned upperRight = 0;
+        unsigned lowerLeft = 0;
+        for (size_t across = 6; across-- > 0;)
+        {
+            for (size_t along = 0; along < 3; ++along)
+            {
+                upperRight = (upperRight << 1) | module(dimension - 9 - along, across);
+                lowerLeft = (lowerLeft << 1) | module(across, dimension - 9 - along);
+            }
+        }
+        auto fromUpperRight = closestCode(upperRight, 7, 40, 6, 18, 0x1F25, 0);
+        const auto fromLowerLeft = closestCode(lowerLeft, 7, 40, 6, 18, 0x1F25, 0);
+        if (fromUpperRight < 0)
+        {
+            fromUpperRight = fromLowerLeft;
+        }
+        if (fromUpperRight > 0 && fromUpperRight != version)
+        {
+            readVersion = fromUpperRight;
+            return false;
+        }
+    }
+
+    // Format information, both copies, 15 bits masked with 0x5412
+    unsigned first = 0;
+    for (size_t i = 0; i < 6; ++i)
+    {
+        first = (first << 1) | module(i, 8);
+    }
+    first = (first << 1) | module(7, 8);
+    first = (first << 1) | module(8, 8);
+    first = (first << 1) | module(8, 7);
+    for (size_t j = 6; j-- > 0;)
+    {
+        first = (first << 1) | module(8, j);
+    }
+    unsigned second = 0;
+    for (size_t j = dimension; j-- > dimension - 7;)
+    {
+        second = (second << 1) | module(8, j);
+    }
+    for (size_t i = dimension - 8; i < dimension; ++i)
+    {
+        second = (second << 1) | module(i, 8);
+    }
+    auto format = closestCode(first, 0, 31, 5, 15, 0x537, 0x5412);
+    if (format < 0)
+    {
+        format = closestCode(second, 0, 31, 5, 15, 0x537, 0x5412);
+    }
+    if (format < 0)
+    {
+        return false;
+    }
+    // Levels in the order of qrBlocks: the format encodes L as 1, M as 0, Q as 3 and H as 2
+    const int levels[4] = { 1, 0, 3, 2 };
+    const auto& blocks = qrBlocks[version - 1][levels[format >> 3]];
+    const auto mask = static_cast<unsigned>(format & 7);
+
+    const auto function = qrFunctionModules(version);
+    std::vector<uint8_t> codewords;
+    unsigned current = 0;
+    size_t bitCount = 0;
+    bool upward = true;
+    // Column pairs from the right, up and down in turn, skipping the vertical timing pattern
+    for (auto right = static_cast<long>(dimension) - 1; right > 0; right -= 2)
+    {
+        if (right == 6)
+        {
+            right--;
+        }
+        for (size_t count = 0; count < dimension; ++count)
+        {
+            const auto y = upward ? dimension - 1 - count : count;
+            for (size_t column = 0; column < 2; ++column)
+            {
+                const auto x = static_cast<size_t>(right) - column;
+                if (function[y * dimension + x])
+                {
+                    continue;
+                }
+                current = (current << 1) | (module(x, y) ^ (qrMasked(mask, y, x) ? 1u : 0u));
+                if (++bitCount == 8)
+                {
+                    codewords.push_back(static_cast<uint8_t>(current));
+                    current = 0;
+                    bitCount = 0;
+                }
+            }
+        }
+        upward = !upward;
+    }
+
+    const size_t blockCount = blocks.shortCount + blocks.longCount;
+    const size_t total = blockCount * (blocks.ecc + blocks.shortData) + blocks.longCount;
+    if (codewords.size() < total)
+    {
+        return false;
+    }
+
+    // Data codewords are interleaved over the blocks, then the error correction codewords
+    std::vector<std::vector<uint8_t>> split(blockCount);
+    size_t position = 0;
+    for (size_t i = 0; i <= blocks.shortData; ++i)
+    {
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            if (i < blocks.shortData || block >= blocks.shortCount)
+            {
+                split[block].push_back(codewords[position++]);
+            }
+        }
+    }
+    for (size_t i = 0; i < blocks.ecc; ++i)
+    {
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            split[block].push_back(codewords[position++]);
+        }
+    }
+
+    std::vector<uint8_t> data;
+    for (auto& block : split)
+    {
+        if (!correctErrors(qrField(), 0, blocks.ecc, block))
+        {
+            return false;
+        }
+        data.insert(data.end(), block.begin(), block.end() - blocks.ecc);
+    }
+    return qrText(data, version, text);
+}
+
+/*!
+ * The alignment pattern closest to \p estimate within \p allowance modules of it: a dark module in a light ring in a
+ * dark ring. Returns false if there is none.
+ */
+bool findAlignment(const BinaryImage& image, Point estimate, float module, float allowance, Point& found)
+{
+    const auto reach = allowance * module;
+    const auto left = static_cast<long>(std::max(0.0f, estimate.x - reach));
+    const auto right = static_cast<long>(std::min(static_cast<float>(image.width) - 1.0f, estimate.x + reach));
+    const auto top = static_cast<long>(std::max(0.0f, estimate.y - reach));
+    const auto bottom = static_cast<long>(std::min(static_cast<float>(image.height) - 1.0f, estimate.y + reach));
+    if (right - left < 3 * module || bottom - top < 3 * module)
+    {
+        return false;
+    }
+
+    auto dark = [&](long x, long y) { return image.Dark(static_cast<size_t>(x), static_cast<size_t>(y)); };
+    auto fits = [module](long length) {
+        return static_cast<float>(length) >= module / 2.0f && static_cast<float>(length) <= 1.5f * module;
+    };
+    // Length of the run of one colour from (x, y) along (dx, dy), up to \p limit
+    auto run = [&](long x, long y, long dx, long dy, bool colour, long limit) {
+        long length = 0;
+        while (length <= limit && x >= left && x <= right && y >= top && y <= bottom && dark(x, y) == colour)
+        {
+            x += dx;
+            y += dy;
+            length++;
+        }
+        return length;
+    };
+
+    const auto limit = static_cast<long>(2.0f * module) + 1;
+    auto bestDistance = std::numeric_limits<float>::max();
+    for (long y = top; y <= bottom; ++y)
+    {
+        long x = left;
+        while (x <= right)
+        {
+            if (!dark(x, y))
+            {
+                x++;
+                continue;
+            }
+            const auto length = run(x, y, 1, 0, true, limit);
+            const auto begin = x;
+            x += length;
+            if (!fits(length) || begin == left || x > right)
+            {
+                continue;
+            }
+            const auto before = run(begin - 1, y, -1, 0, false, limit);
+            const auto after = run(x, y, 1, 0, false, limit);
+            if (!fits(before) || !fits(after) || begin - 1 - before < left || x + after > right)
+            {
+                continue;
+            }
+
+            // The same vertically through the middle of the run
+            const auto centerX = (begin + x - 1) / 2;
+            const auto up = run(centerX, y, 0, -1, true, limit);
+            const auto down = run(centerX, y, 0, 1, true, limit);
+            const auto height = up + down - 1;
+            if (!fits(height))
+            {
+                continue;
+            }
+            const auto above = run(centerX, y - up, 0, -1, false, limit);
+            const auto below = run(centerX, y + down, 0, 1, false, limit);
+            if (!fits(above) || !fits(below) || y - up - above < top || y + down + below > bottom)
+            {
+                continue;
+            }
+
+            const Point candidate = { static_cast<float>(begin + x) / 2.0f,
+                static_cast<float>(y - up + 1 + y + down) / 2.0f };
+            const auto away = distance(candidate, estimate);
+            if (away < bestDistance)
+            {
+                bestDistance = away;
+                found = candidate;
+            }
+        }
+    }
+    return bestDistance < std::numeric_limits<float>::max();
+}
+
+/*!
+ * Module size of a finder pattern from its width along rows and columns, which grows by up to the square root of 2
+ * as the symbol turns. \p from and \p to are the centres of two finder patterns along a side of the symbol.
+ */
+float moduleSize(const FinderPattern& pattern, Point from, Point to)
+{
+    const auto length = distance(from, to);
+    if (length <= 0.0f)
+    {
+        return pattern.module;
+    }
+    return pattern.module * std::max(std::abs(to.x - from.x), std::abs(to.y - from.y)) / length;
+}
+
+/*!
+ * Reads the QR Code whose finder patterns are at \p topLeft, \p topRight and \p bottomLeft. Tries the version that
+ * fits their distance best, then its neighbours.
+ */
+bool decodeQr(const BinaryImage& image, const FinderPattern& topLeft, const FinderPattern& topRight,
+    const FinderPattern& bottomLeft, std::string& text)
+{
+    const auto module = (moduleSize(topLeft, topLeft.center, topRight.center)
+                            + moduleSize(topRight, topLeft.center, topRight.center)
+                            + moduleSize(bottomLeft, topLeft.center, topRight.center))
+        / 3.0f;
+    // Along rows and columns, as the alignment pattern is searched like the finder patterns were found
+    const auto rowModule = (topLeft.module + topRight.module + bottomLeft.module) / 3.0f;
+    const auto across = (distance(topLeft.center, topRight.center) + distance(topLeft.center, bottomLeft.center))
+        / 2.0f / module;
+    // The centres are 7 modules less apart than the symbol is wide, which is 17 + 4 * version
+    const auto estimate = static_cast<int>(std::lround((across + 7.0f - 17.0f) / 4.0f));
+
+    std::vector<int> versions;
+    for (const auto offset : { 0, 1, -1 })
+    {
+        if (estimate + offset >= 1 && estimate + offset <= 40)
+        {
+            versions.push_back(estimate + offset);
+        }
+    }
+
+    std::set<int> tried;
+    std::vector<uint8_t> modules;
+    for (size_t attempt = 0; attempt < versions.size(); ++attempt)
+    {
+        const auto version = versions[attempt];
+        if (!tried.insert(version).second)
+        {
+            continue;
+        }
+        const auto dimension = static_cast<float>(17 + 4 * version);
+
+        // The corner opposite the top left one, from the alignment pattern where there is one
+        const auto parallel = topRight.center - topLeft.center + bottomLeft.center;
+        Point bottomRight = parallel;
+        Point bottomRightModule = { dimension - 3.5f, dimension - 3.5f };
+        if (version >= 2)
+        {
+            const auto correction = 1.0f - 3.0f / (dimension - 7.0f);
+            const auto expected = topLeft.center + correction * (parallel - topLeft.center);
+            for (const auto allowance : { 4.0f, 8.0f, 16.0f })
+            {
+                if (findAlignment(image, expected, rowModule, allowance, bottomRight))
+                {
+                    bottomRightModule = { dimension - 6.5f, dimension - 6.5f };
+                    break;
+                }
+            }
+        }
+
+        const auto transform = PerspectiveTransform::QuadrilateralToQuadrilateral(
+            { Point{ 3.5f, 3.5f }, Point{ dimension - 3.5f, 3.5f }, bottomRightModule,
+                Point{ 3.5f, dimension - 3.5f } },
+            { topLeft.center, topRight.center, bottomRight, bottomLeft.center });
+        const auto size = static_cast<size_t>(dimension);
+        if (!sampleGrid(image, transform, size, size, modules))
+        {
+            continue;
+        }
+
+        int readVersion = version;
+        if (decodeQrModules(modules, version, readVersion, text))
+        {
+            return true;
+        }
+        if (readVersion != version && !tried.count(readVersion))
+        {
+            versions.push_back(readVersion);
+        }
+    }
+    return false;
+}
+
+void decodeQrCodes(const BinaryImage& image, std::vector<DecodedBarcode>& barcodes)
+{
+    auto patterns = findFinderPatterns(image);
+    // The most confirmed ones, a frame with more than a few symbols is no label
+    if (patterns.size() > 15)
+    {
+        patterns.resize(15);
+    }
+
+    // Triples whose centres form a right isosceles triangle, the best fitting first
+    struct Triple
+    {
+        float error;
+        size_t topLeft;
+        size_t topRight;
+        size_t bottomLeft;
+    };
+    std::vector<Triple> triples;
+    for (size_t a = 0; a < patterns.size(); ++a)
+    {
+        for (size_t b = a + 1; b < patterns.size(); ++b)
+        {
+            for (size_t c = b + 1; c < patterns.size(); ++c)
+            {
+                const size_t members[3] = { a, b, c };
+                float smallest = std::numeric_limits<float>::max();
+                float largest = 0.0f;
+                for (const auto member : members)
+                {
+                    smallest = std::min(smallest, patterns[member].module);
+                    largest = std::max(largest, patterns[member].module);
+                }
+                if (largest > 1.5f * smallest)
+                {
+                    continue;
+                }
+
+                // The corner opposite the longest side is the top left one
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const auto& p = patterns[members[corner]].center;
+                    const auto& q = patterns[members[(corner + 1) % 3]].center;
+                    const auto& r = patterns[members[(corner + 2) % 3]].center;
+                    const auto pq = distance(p, q);
+                    const auto pr = distance(p, r);
+                    const auto qr = distance(q, r);
+                    if (qr < pq || qr < pr)
+                    {
+                        continue;
+                    }
+
+                    const auto legs = pq * pq + pr * pr;
+                    const auto error = std::abs(pq - pr) / std::max(pq, pr) + std::abs(qr * qr / legs - 1.0f);
+                    // 21 modules wide is the smallest symbol, its finder centres are 14 modules apart
+                    if (error > 0.3f || std::min(pq, pr) < 13.0f * moduleSize(patterns[members[corner]], p, q))
+                    {
+                        break;
+                    }
+                    // Clockwise from the top left corner, the top right one comes before the bottom left one
+                    const bool clockwise = cross(q - p, r - p) > 0.0f;
+                    triples.push_back({ error, members[corner], members[(corner + (clockwise ? 1 : 2)) % 3],
+                        members[(corner + (clockwise ? 2 : 1)) % 3] });
+                    break;
+                }
+            }
+        }
+    }
+    std::stable_sort(
+        triples.begin(), triples.end(), [](const Triple& a, const Triple& b) { return a.error < b.error; });
+
+    std::vector<uint8_t> used(patterns.size(), 0);
+    for (const auto& triple : triples)
+    {
+        if (used[triple.topLeft] || used[triple.topRight] || used[triple.bottomLeft])
+        {
+            continue;
+        }
+        std::string text;
+        if (decodeQr(image, patterns[triple.topLeft], patterns[triple.topRight], patterns[triple.bottomLeft], text))
+        {
+            used[triple.topLeft] = used[triple.topRight] = used[triple.bottomLeft] = 1;
+            DecodedBarcode barcode;
+            barcode.symbology = BarcodeSymbology::QrCode;
+            barcode.text = std::move(text);
+            barcode.votes = 1;
+            barcodes.push_back(std::move(barcode));
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------------------------------------------
+// Data Matrix
+
+// An ECC 200 symbol size with its data regions and error correction, ISO/IEC 16022 table 7
+struct DataMatrixSize
+{
+    uint8_t rows;
+    uint8_t columns;
+    // Modules of one data region, without the finder and clock around it
+    uint8_t regionRows;
+    uint8_t regionColumns;
+    // Error correction codewords per block
+    uint8_t ecc;
+    // Data codewords of all blocks together
+    uint16_t data;
+    uint8_t blocks;
+};
+
+const DataMatrixSize dataMatrixSizes[] = {
+    { 10, 10, 8, 8, 5, 3, 1 },
+    { 12, 12, 10, 10, 7, 5, 1 },
+    { 14, 14, 12, 12, 10, 8, 1 },
+    { 16, 16, 14, 14, 12, 12, 1 },
+    { 18, 18, 16, 16, 14, 18, 1 },
+    { 20, 20, 18, 18, 18, 22, 1 },
+    { 22, 22, 20, 20, 20, 30, 1 },
+    { 24, 24, 22, 22, 24, 36, 1 },
+    { 26, 26, 24, 24, 28, 44, 1 },
+    { 32, 32, 14, 14, 36, 62, 1 },
+    { 36, 36, 16, 16, 42, 86, 1 },
+    { 40, 40, 18, 18, 48, 114, 1 },
+    { 44, 44, 20, 20, 56, 144, 1 },
+    { 48, 48, 22, 22, 68, 174, 1 },
+    { 52, 52, 24, 24, 42, 204, 2 },
+    { 64, 64, 14, 14, 56, 280, 2 },
+    { 72, 72, 16, 16, 36, 368, 4 },
+    { 80, 80, 18, 18, 48, 456, 4 },
+    { 88, 88, 20, 20, 56, 576, 4 },
+    { 96, 96, 22, 22, 68, 696, 4 },
+    { 104, 104, 24, 24, 56, 816, 6 },
+    { 120, 120, 18, 18, 68, 1050, 6 },
+    { 132, 132, 20, 20, 62, 1304, 8 },
+    { 144, 144, 22, 22, 62, 1558, 10 },
+    { 8, 18, 6, 16, 7, 5, 1 },
+    { 8, 32, 6, 14, 11, 10, 1 },
+    { 12, 26, 10, 24, 14, 16, 1 },
+    { 12, 36, 10, 16, 18, 22, 1 },
+    { 16, 36, 14, 16, 24, 32, 1 },
+    { 16, 48, 14, 22, 28, 49, 1 },
+};
+
+/*!
+ * Which codeword and bit every module of the mapping matrix holds, by the placement of ISO/IEC 16022 annex F:
+ * 8 * codeword + bit, bit 0 the most significant, -1 for the fixed corner modules. The matrix is the data regions
+ * put together without their finders and clocks.
+ */
+std::vector<int> dataMatrixPlacement(int rows, int columns)
+{
+    std::vector<int> placement(static_cast<size_t>(rows * columns), -2);
+    auto module = [&](int row, int column, int codeword, int bit) {
+        if (row < 0)
+        {
+            row += rows;
+            column += 4 - ((rows + 4) % 8);
+        }
+        if (column < 0)
+        {
+            column += columns;
+            row += 4 - ((columns + 4) % 8);
+        }
+        placement[static_cast<size_t>(row * columns + column)] = 8 * codeword + bit;
+    };
+    // The usual L shaped codeword of 8 modules with its last bit at (row, column)
+    auto utah = [&](int row, int column, int codeword) {
+        module(row - 2, column - 2, codeword, 0);
+        module(row - 2, column - 1, codeword, 1);
+        module(row - 1, column - 2, codeword, 2);
+        module(row - 1, column - 1, codeword, 3);
+        module(row - 1, column, codeword, 4);
+        module(row, column - 2, codeword, 5);
+        module(row, column - 1, codeword, 6);
+        module(row, column, codeword, 7);
+    };
+    // Codewords wrapped around the corners of the matrix, as (row, column) per bit
+    auto corner = [&](const int (&positions)[8][2], int codeword) {
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            const auto row = positions[bit][0];
+            const auto column = positions[bit][1];
+            module(row < 0 ? rows + row : row, column < 0 ? columns + column : column, codeword, bit);
+        }
+    };
+    const int corner1[8][2] = { { -1, 0 }, { -1, 1 }, { -1, 2 }, { 0, -2 }, { 0, -1 }, { 1, -1 }, { 2, -1 },
+        { 3, -1 } };
+    const int corner2[8][2] = { { -3, 0 }, { -2, 0 }, { -1, 0 }, { 0, -4 }, { 0, -3 }, { 0, -2 }, { 0, -1 },
+        { 1, -1 } };
+    const int corner3[8][2] = { { -3, 0 }, { -2, 0 }, { -1, 0 }, { 0, -2 }, { 0, -1 }, { 1, -1 }, { 2, -1 },
+        { 3, -1 } };
+    const int corner4[8][2] = { { -1, 0 }, { -1, -1 }, { 0, -3 }, { 0, -2 }, { 0, -1 }, { 1, -3 }, { 1, -2 },
+        { 1, -1 } };
+
+    auto unused = [&](int row, int column) { return placement[static_cast<size_t>(row * columns + column)] == -2; };
+    int codeword = 0;
+    int row = 4;
+    int column = 0;
+    do
+    {
+        if (row == rows && column == 0)
+        {
+            corner(corner1, codeword++);
+        }
+        if (row == rows - 2 && column == 0 && columns % 4)
+        {
+            corner(corner2, codeword++);
+        }
+        if (row == rows - 2 && column == 0 && columns % 8 == 4)
+        {
+            corner(corner3, codeword++);
+        }
+        if (row == rows + 4 && column == 2 && !(columns % 8))
+        {
+            corner(corner4, codeword++);
+        }
+        // Diagonally up and right, then down and left
+        do
+        {
+            if (row < rows && column >= 0 && unused(row, column))
+            {
+                utah(row, column, codeword++);
+            }
+            row -= 2;
+            column += 2;
+        } while (row >= 0 && column < columns);
+        row += 1;
+        column += 3;
+        do
+        {
+            if (row >= 0 && column < columns && unused(row, column))
+            {
+                utah(row, column, codeword++);
+            }
+            row += 2;
+            column -= 2;
+        } while (row < rows && column >= 0);
+        row += 3;
+        column += 1;
+    } while (row < rows || column < columns);
+
+    for (auto& value : placement)
+    {
+        if (value == -2)
+        {
+            value = -1;
+        }
+    }
+    return placement;
+}
+
+// Inverts the 255-state randomization of Base 256 codewords, \p position counts the codewords from 1
+uint8_t unrandomize255(uint8_t value, size_t position)
+{
+    const auto pseudo = static_cast<int>((149 * position) % 255 + 1);
+    const auto result = static_cast<int>(value) - pseudo;
+    return static_cast<uint8_t>(result >= 0 ? result : result + 256);
+}
+
+enum class DataMatrixMode
+{
+    Ascii,
+    C40,
+    Text,
+    X12,
+    Edifact,
+    Base256,
+    Done
+};
+
+/*!
+ * C40, Text and X12 pack three values into two codewords. C40 and Text have shift sets for the remaining ASCII
+ * characters and FNC1, \p text picks the lowercase basic set. Returns the mode to go on in.
+ */
+DataMatrixMode dataMatrixTriples(BitReader& bits, DataMatrixMode mode, std::string& result, bool& failed)
+{
+    int shift = 0;
+    bool upper = false;
+    auto emit = [&](int character) {
+        result += static_cast<char>(upper ? character + 128 : character);
+        upper = false;
+    };
+
+    while (bits.Available() >= 16)
+    {
+        const auto first = bits.Read(8);
+        if (first == 254)
+        {
+            // Unlatch to ASCII
+            return DataMatrixMode::Ascii;
+        }
+        const auto packed = (first << 8) + bits.Read(8) - 1;
+        const int values[3] = { static_cast<int>(packed / 1600), static_cast<int>(packed / 40 % 40),
+            static_cast<int>(packed % 40) };
+        for (const auto value : values)
+        {
+            if (mode == DataMatrixMode::X12)
+            {
+                const char x12[] = "\r*> ";
+                if (value < 4)
+                {
+                    emit(x12[value]);
+                }
+                else if (value < 14)
+                {
+                    emit('0' + value - 4);
+                }
+                else
+                {
+                    emit('A' + value - 14);
+                }
+                continue;
+            }
+
+            switch (shift)
+            {
+            case 0:
+                if (value < 3)
+                {
+                    shift = value + 1;
+                }
+                else if (value == 3)
+                {
+                    emit(' ');
+                }
+                else if (value < 14)
+                {
+                    emit('0' + value - 4);
+                }
+                else
+                {
+                    emit((mode == DataMatrixMode::Text ? 'a' : 'A') + value - 14);
+                }
+                continue;
+            case 1:
+                // Shift 1, the control characters
+                emit(value);
+                break;
+            case 2:
+            {
+                const char punctuation[] = "!\"#$%&'()*+,-./:;<=>?@[\\]^_";
+                if (value < 27)
+                {
+                    emit(punctuation[value]);
+                }
+                else if (value == 27)
+                {
+                    result += '\x1D';
+                }
+                else if (value == 30)
+                {
+                    upper = true;
+                }
+                else
+                {
+                    failed = true;
+                    return DataMatrixMode::Done;
+                }
+                break;
+            }
+            default:
+                // Shift 3, the rest of 7 bit ASCII
+                if (mode == DataMatrixMode::C40)
+                {
+                    emit(value + 96);
+                }
+                else if (value == 0)
+                {
+                    emit('`');
+                }
+                else if (value < 27)
+                {
+                    emit('A' + value - 1);
+                }
+                else
+                {
+                    emit(value + 96);
+                }
+                break;
+            }
+            shift = 0;
+        }
+    }
+    // A single codeword left over is ASCII
+    return DataMatrixMode::Ascii;
+}
+
+/*!
+ * Text of the data codewords of a Data Matrix symbol in all its encodation modes. ECI designators and structured
+ * append are skipped, FNC1 past the first position is the GS separator. Returns false on invalid data.
+ */
+bool dataMatrixText(const std::vector<uint8_t>& data, std::string& text)
+{
+    BitReader bits(data);
+    auto mode = DataMatrixMode::Ascii;
+    bool upper = false;
+    std::string trailer;
+    text.clear();
+
+    while (mode != DataMatrixMode::Done && bits.Available() >= 8)
+    {
+        switch (mode)
+        {
+        case DataMatrixMode::Ascii:
+        {
+            const auto first = bits.BytePosition() == 0;
+            const auto codeword = bits.Read(8);
+            if (codeword == 0)
+            {
+                return false;
+            }
+            if (codeword <= 128)
+            {
+                text += static_cast<char>(upper ? codeword - 1 + 128 : codeword - 1);
+                upper = false;
+            }
+            else if (codeword == 129)
+            {
+                // Padding to the end
+                mode = DataMatrixMode::Done;
+            }
+            else if (codeword <= 229)
+            {
+                const auto pair = codeword - 130;
+                text += static_cast<char>('0' + pair / 10);
+                text += static_cast<char>('0' + pair % 10);
+            }
+            else
+            {
+                switch (codeword)
+                {
+                case 230:
+                    mode = DataMatrixMode::C40;
+                    break;
+                case 231:
+                    mode = DataMatrixMode::Base256;
+                    break;
+                case 232:
+                    // FNC1 first marks GS1 data, later it separates its fields
+                    if (!first)
+                    {
+                        text += '\x1D';
+                    }
+                    break;
+                case 233:
+                    // Structured append: sequence and file identification
+                    if (bits.Available() < 24)
+                    {
+                        return false;
+                    }
+                    bits.Read(24);
+                    break;
+                case 234:
+                    // Reader programming, nothing to pass on
+                    break;
+                case 235:
+                    upper = true;
+                    break;
+                case 236:
+                case 237:
+                    text += codeword == 236 ? "[)>\x1E" "05\x1D" : "[)>\x1E" "06\x1D";
+                    trailer = "\x1E\x04";
+                    break;
+                case 238:
+                    mode = DataMatrixMode::X12;
+                    break;
+                case 239:
+                    mode = DataMatrixMode::Text;
+                    break;
+                case 240:
+                    mode = DataMatrixMode::Edifact;
+                    break;
+                case 241:
+                {
+                    // ECI designator of one to three codewords
+                    if (bits.Available() < 8)
+                    {
+                        return false;
+                    }
+                    const auto designator = bits.Read(8);
+                    const size_t more = designator <= 127 ? 0 : (designator <= 191 ? 8 : 16);
+                    if (bits.Available() < more)
+                    {
+                        return false;
+                    }
+                    bits.Read(more);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            break;
+        }
+        case DataMatrixMode::C40:
+        case DataMatrixMode::Text:
+        case DataMatrixMode::X12:
+        {
+            bool failed = false;
+            mode = dataMatrixTriples(bits, mode, text, failed);
+            if (failed)
+            {
+                return false;
+            }
+            break;
+        }
+        case DataMatrixMode::Edifact:
+        {
+            // Four 6 bit values in three codewords, 31 returns to ASCII at the next codeword. Two codewords or less
+            // at the end are ASCII without it.
+            mode = DataMatrixMode::Ascii;
+            bool unlatched = false;
+            while (!unlatched && bits.Available() > 16)
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    const auto value = bits.Read(6);
+                    if (value == 0x1F)
+                    {
+                        bits.Align();
+                        unlatched = true;
+                        break;
+                    }
+                    text += static_cast<char>((value & 0x20) ? value : value | 0x40);
+                }
+            }
+            break;
+        }
+        case DataMatrixMode::Base256:
+        {
+            auto position = bits.BytePosition() + 1;
+            const auto length = unrandomize255(static_cast<uint8_t>(bits.Read(8)), position++);
+            size_t count = length;
+            if (length == 0)
+            {
+                count = bits.Available() / 8;
+            }
+            else if (length >= 250)
+            {
+                if (bits.Available() < 8)
+                {
+                    return false;
+                }
+                count = 250 * (length - 249) + unrandomize255(static_cast<uint8_t>(bits.Read(8)), position++);
+            }
+            if (bits.Available() < 8 * count)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                text += static_cast<char>(unrandomize255(static_cast<uint8_t>(bits.Read(8)), position++));
+            }
+            mode = DataMatrixMode::Ascii;
+            break;
+        }
+        case DataMatrixMode::Done:
+            break;
+        }
+    }
+    text += trailer;
+    return true;
+}
+
+/*!
+ * Text of the sampled modules of a Data Matrix symbol, row by row from the top with the solid L along the left and
+ * the bottom. Returns false if the finders and clocks don't match or the error correction fails.
+ */
+bool decodeDataMatrixModules(const std::vector<uint8_t>& modules, const DataMatrixSize& size, std::string& text)
+{
+    const auto regionHeight = size.regionRows + 2u;
+    const auto regionWidth = size.regionColumns + 2u;
+    const auto verticalRegions = size.rows / regionHeight;
+    const auto horizontalRegions = size.columns / regionWidth;
+
+    // Every data region has its own L and clock, which tell a symbol of this size from one that isn't
+    size_t mismatches = 0;
+    size_t checked = 0;
+    for (size_t y = 0; y < size.rows; ++y)
+    {
+        for (size_t x = 0; x < size.columns; ++x)
+        {
+            const auto row = y % regionHeight;
+            const auto column = x % regionWidth;
+            int expected = -1;
+            if (column == 0 || row == regionHeight - 1)
+            {
+                expected = 1;
+            }
+            else if (row == 0)
+            {
+                expected = column % 2 == 0 ? 1 : 0;
+            }
+            else if (column == regionWidth - 1)
+            {
+                expected = row % 2 == 1 ? 1 : 0;
+            }
+            if (expected >= 0)
+            {
+                checked++;
+                mismatches += modules[y * size.columns + x] != expected ? 1 : 0;
+            }
+        }
+    }
+    if (10 * mismatches > checked)
+    {
+        return false;
+    }
+
+    const auto mappingRows = static_cast<int>(verticalRegions * size.regionRows);
+    const auto mappingColumns = static_cast<int>(horizontalRegions * size.regionColumns);
+    const auto placement = dataMatrixPlacement(mappingRows, mappingColumns);
+    const size_t total = size.data + static_cast<size_t>(size.ecc) * size.blocks;
+    std::vector<uint8_t> codewords(total, 0);
+    for (int row = 0; row < mappingRows; ++row)
+    {
+        for (int column = 0; column < mappingColumns; ++column)
+        {
+            const auto target = placement[static_cast<size_t>(row * mappingColumns + column)];
+            if (target < 0 || static_cast<size_t>(target / 8) >= total)
+            {
+                continue;
+            }
+            // The mapping matrix skips the finder and clock of each region
+            const auto y = static_cast<size_t>(row / size.regionRows * regionHeight + row % size.regionRows + 1);
+            const auto x =
+                static_cast<size_t>(column / size.regionColumns * regionWidth + column % size.regionColumns + 1);
+            if (modules[y * size.columns + x])
+            {
+                codewords[static_cast<size_t>(target / 8)] |= static_cast<uint8_t>(0x80 >> (target % 8));
+            }
+        }
+    }
+
+    // Codeword i belongs to block i % blocks, the data codewords first. The 144x144 symbol starts its error
+    // correction codewords with block 8, as its last two blocks have one data codeword less.
+    const size_t blocks = size.blocks;
+    std::vector<std::vector<uint8_t>> split(blocks);
+    for (size_t i = 0; i < size.data; ++i)
+    {
+        split[i % blocks].push_back(codewords[i]);
+    }
+    for (size_t i = 0; i < static_cast<size_t>(size.ecc) * blocks; ++i)
+    {
+        const auto block = size.rows == 144 ? (i % blocks + 8) % blocks : i % blocks;
+        split[block].push_back(codewords[size.data + i]);
+    }
+    for (auto& block : split)
+    {
+        if (!correctErrors(dataMatrixField(), 1, size.ecc, block))
+        {
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> data(size.data);
+    for (size_t i = 0; i < size.data; ++i)
+    {
+        data[i] = split[i % blocks][i / blocks];
+    }
+    return dataMatrixText(data, text);
+}
+
+// A connected set of dark pixels, as the leftmost and rightmost dark pixel of each of its rows
+struct Blob
+{
+    size_t left;
+    size_t top;
+    size_t right;
+    size_t bottom;
+    size_t pixels;
+    // (y, first x, last x + 1), one entry per run
+    std::vector<std::array<uint32_t, 3>> runs;
+};
+
+/*!
+ * Connected dark areas at least \p minSize pixels wide or high. Runs of dark pixels are joined with the runs of the
+ * row above they touch, including diagonally.
+ */
+std::vector<Blob> blobs(const BinaryImage& image, size_t minSize)
+{
+    struct Run
+    {
+        uint32_t y;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t parent;
+    };
+    std::vector<Run> runs;
+    auto root = [&runs](uint32_t index) {
+        while (runs[index].parent != index)
+        {
+            runs[index].parent = runs[runs[index].parent].parent;
+            index = runs[index].parent;
+        }
+        return index;
+    };
+
+    std::vector<uint32_t> lengths;
+    size_t previousBegin = 0;
+    size_t previousEnd = 0;
+    for (size_t y = 0; y < image.height; ++y)
+    {
+        rowRuns(image, y, lengths);
+        const auto rowBegin = runs.size();
+        uint32_t x = lengths[0];
+        for (size_t i = 1; i < lengths.size(); i += 2)
+        {
+            const auto index = static_cast<uint32_t>(runs.size());
+            runs.push_back({ static_cast<uint32_t>(y), x, x + lengths[i], index });
+            x += lengths[i] + (i + 1 < lengths.size() ? lengths[i + 1] : 0);
+        }
+
+        // Both rows are sorted by x, so one pass finds every touching pair
+        auto above = previousBegin;
+        for (auto current = rowBegin; current < runs.size(); ++current)
+        {
+            while (above < previousEnd && runs[above].end < runs[current].begin)
+            {
+                above++;
+            }
+            for (auto other = above; other < previousEnd && runs[other].begin <= runs[current].end; ++other)
+            {
+                const auto a = root(static_cast<uint32_t>(other));
+                const auto b = root(static_cast<uint32_t>(current));
+                if (a != b)
+                {
+                    runs[std::max(a, b)].parent = std::min(a, b);
+                }
+            }
+        }
+        previousBegin = rowBegin;
+        previousEnd = runs.size();
+    }
+
+    std::vector<Blob> found;
+    std::vector<uint32_t> blobOf(runs.size(), std::numeric_limits<uint32_t>::max());
+    std::vector<Blob> all;
+    for (uint32_t index = 0; index < runs.size(); ++index)
+    {
+        const auto top = root(index);
+        if (blobOf[top] == std::numeric_limits<uint32_t>::max())
+        {
+            blobOf[top] = static_cast<uint32_t>(all.size());
+            all.push_back({ runs[index].begin, runs[index].y, runs[index].end, runs[index].y + 1u, 0, {} });
+        }
+        blobOf[index] = blobOf[top];
+        auto& blob = all[blobOf[index]];
+        blob.left = std::min<size_t>(blob.left, runs[index].begin);
+        blob.right = std::max<size_t>(blob.right, runs[index].end);
+        blob.bottom = std::max<size_t>(blob.bottom, runs[index].y + 1u);
+        blob.pixels += runs[index].end - runs[index].begin;
+    }
+    for (uint32_t index = 0; index < runs.size(); ++index)
+    {
+        auto& blob = all[blobOf[index]];
+        if (blob.right - blob.left >= minSize || blob.bottom - blob.top >= minSize)
+        {
+            blob.runs.push_back({ runs[index].y, runs[index].begin, runs[index].end });
+        }
+    }
+    for (auto& blob : all)
+    {
+        if (!blob.runs.empty())
+        {
+            found.push_back(std::move(blob));
+        }
+    }
+    return found;
+}
+
+// Convex hull of the pixel corners of a blob
+std::vector<Point> hull(const Blob& blob)
+{
+    // The outermost corners of each row are enough
+    std::vector<Point> points;
+    points.reserve(4 * blob.runs.size());
+    for (const auto& run : blob.runs)
+    {
+        const auto y = static_cast<float>(run[0]);
+        for (const auto x : { static_cast<float>(run[1]), static_cast<float>(run[2]) })
+        {
+            points.push_back({ x, y });
+            points.push_back({ x, y + 1.0f });
+        }
+    }
+    std::sort(points.begin(), points.end(),
+        [](const Point& a, const Point& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+    points.erase(std::unique(points.begin(), points.end(),
+                     [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; }),
+        points.end());
+    if (points.size() < 3)
+    {
+        return points;
+    }
+
+    // Andrew's monotone chain
+    std::vector<Point> result(2 * points.size());
+    size_t count = 0;
+    for (const auto& point : points)
+    {
+        while (count >= 2 && cross(result[count - 1] - result[count - 2], point - result[count - 2]) <= 0.0f)
+        {
+            count--;
+        }
+        result[count++] = point;
+    }
+    const auto lower = count + 1;
+    for (size_t i = points.size() - 1; i-- > 0;)
+    {
+        while (count >= lower && cross(result[count - 1] - result[count - 2], points[i] - result[count - 2]) <= 0.0f)
+        {
+            count--;
+        }
+        result[count++] = points[i];
+    }
+    result.resize(count - 1);
+    return result;
+}
+
+/*!
+ * Rectangles around a hull with one side along one of its edges whose area is close to the smallest. A Data Matrix
+ * L fits its symbol exactly, but a triangle like it fits its hypotenuse as well, so all near the minimum are kept.
+ * Each rectangle is given by its four corners in order around it.
+ */
+std::vector<std::array<Point, 4>> enclosingRectangles(const std::vector<Point>& points)
+{
+    struct Candidate
+    {
+        float area;
+        std::array<Point, 4> corners;
+        Point direction;
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const auto edge = points[(i + 1) % points.size()] - points[i];
+        const auto length = std::hypot(edge.x, edge.y);
+        if (length <= 0.0f)
+        {
+            continue;
+        }
+        const Point along = { edge.x / length, edge.y / length };
+        const Point across = { -along.y, along.x };
+        auto minAlong = std::numeric_limits<float>::max();
+        auto maxAlong = -minAlong;
+        auto minAcross = minAlong;
+        auto maxAcross = -minAlong;
+        for (const auto& point : points)
+        {
+            const auto u = point.x * along.x + point.y * along.y;
+            const auto v = point.x * across.x + point.y * across.y;
+            minAlong = std::min(minAlong, u);
+            maxAlong = std::max(maxAlong, u);
+            minAcross = std::min(minAcross, v);
+            maxAcross = std::max(maxAcross, v);
+        }
+        Candidate candidate;
+        candidate.area = (maxAlong - minAlong) * (maxAcross - minAcross);
+        candidate.corners = { minAlong * along + minAcross * across, maxAlong * along + minAcross * across,
+            maxAlong * along + maxAcross * across, minAlong * along + maxAcross * across };
+        candidate.direction = along;
+        candidates.push_back(candidate);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.area < b.area; });
+
+    std::vector<std::array<Point, 4>> rectangles;
+    std::vector<Point> directions;
+    for (const auto& candidate : candidates)
+    {
+        if (candidate.area > 1.15f * candidates.front().area || rectangles.size() == 4)
+        {
+            break;
+        }
+        // The same rectangle comes from each edge along its sides, within a few degrees of a quarter turn
+        const auto same = std::any_of(directions.begin(), directions.end(), [&](const Point& direction) {
+            const auto dot = std::abs(direction.x * candidate.direction.x + direction.y * candidate.direction.y);
+            return std::abs(cross(direction, candidate.direction)) < 0.05f || dot < 0.05f;
+        });
+        if (!same)
+        {
+            directions.push_back(candidate.direction);
+            rectangles.push_back(candidate.corners);
+        }
+    }
+    return rectangles;
+}
+
+/*!
+ * Tries the corner \p corner of a rectangle around a blob as the corner of the solid L of a Data Matrix symbol,
+ * with \p up and \p right the ends of its arms, and reads the symbol. The rectangle must fit the outer edges of the
+ * L, which makes it the outline of the whole symbol.
+ */
+bool decodeDataMatrix(const BinaryImage& image, Point corner, Point up, Point right, std::string& text)
+{
+    const auto height = distance(corner, up);
+    const auto width = distance(corner, right);
+    if (height < 8.0f || width < 8.0f || std::max(height, width) > 6.0f * std::min(height, width))
+    {
+        return false;
+    }
+    const auto upward = (1.0f / height) * (up - corner);
+    const auto rightward = (1.0f / width) * (right - corner);
+
+    // The arms are one module thick where no dark data module lies next to them, so the thinnest place tells the
+    // module size. A small symbol may have dark modules along most of its L, while too thin a module only moves the
+    // probes below closer to the edge. Points a little off the edge of the rectangle may still be outside an arm that
+    // isn't exactly straight.
+    std::vector<float> thickness;
+    auto measure = [&](Point from, Point inward, float reach) {
+        float t = 0.0f;
+        while (t < 1.5f && !darkAt(image, from + t * inward))
+        {
+            t += 0.5f;
+        }
+        while (t < reach && darkAt(image, from + t * inward))
+        {
+            t += 0.5f;
+        }
+        return t;
+    };
+    for (int step = 1; step < 10; ++step)
+    {
+        const auto fraction = static_cast<float>(step) / 10.0f;
+        thickness.push_back(measure(corner + (fraction * height) * upward, rightward, width / 2.0f));
+        thickness.push_back(measure(corner + (fraction * width) * rightward, upward, height / 2.0f));
+    }
+    // Places without an arm, which the solid test rejects anyway, are not taken as thin
+    thickness.erase(std::remove_if(thickness.begin(), thickness.end(), [](float t) { return t < 2.0f; }),
+        thickness.end());
+    if (thickness.size() < 9)
+    {
+        return false;
+    }
+    const auto module = *std::min_element(thickness.begin(), thickness.end());
+
+    // Both arms solid dark along their middle
+    auto solid = [&](Point from, Point along, float length, Point inward) {
+        size_t dark = 0;
+        size_t count = 0;
+        for (float t = module / 2.0f; t < length; t += module / 2.0f, ++count)
+        {
+            dark += darkAt(image, from + t * along + (module / 2.0f) * inward) ? 1 : 0;
+        }
+        return count > 0 && 10 * dark >= 9 * count;
+    };
+    if (!solid(corner, upward, height, rightward) || !solid(corner, rightward, width, upward))
+    {
+        return false;
+    }
+
+    // Modules along the clock tracks opposite the arms, which alternate from module to module
+    auto runs = [&](Point from, Point along, float length, Point inward) {
+        size_t count = 0;
+        bool previous = false;
+        for (float t = module / 4.0f; t < length - module / 4.0f; t += module / 4.0f)
+        {
+            const auto dark = darkAt(image, from + t * along + (module / 2.0f) * inward);
+            if (count == 0 || dark != previous)
+            {
+                count++;
+                previous = dark;
+            }
+        }
+        return static_cast<float>(count);
+    };
+    const auto columnsCounted = runs(up, rightward, width, -1.0f * upward);
+    const auto rowsCounted = runs(right, upward, height, -1.0f * rightward);
+    const auto columnsMeasured = width / module;
+    const auto rowsMeasured = height / module;
+
+    // Sizes that fit either count, the closest to the clocks first
+    std::vector<std::pair<float, const DataMatrixSize*>> sizes;
+    for (const auto& size : dataMatrixSizes)
+    {
+        const auto rows = static_cast<float>(size.rows);
+        const auto columns = static_cast<float>(size.columns);
+        const auto counted = std::abs(rows - rowsCounted) + std::abs(columns - columnsCounted);
+        const auto measured = std::abs(rows - rowsMeasured) / rowsMeasured
+            + std::abs(columns - columnsMeasured) / columnsMeasured;
+        if (counted <= 2.0f || measured <= 0.2f)
+        {
+            sizes.emplace_back(counted, &size);
+        }
+    }
+    std::stable_sort(sizes.begin(), sizes.end(),
+        [](const std::pair<float, const DataMatrixSize*>& a, const std::pair<float, const DataMatrixSize*>& b) {
+            return a.first < b.first;
+        });
+    if (sizes.size() > 4)
+    {
+        sizes.resize(4);
+    }
+
+    std::vector<uint8_t> modules;
+    for (const auto& candidate : sizes)
+    {
+        const auto& size = *candidate.second;
+        const auto rows = static_cast<float>(size.rows);
+        const auto columns = static_cast<float>(size.columns);
+        // Module (0, 0) is the top left one, the rectangle is the outline of the modules
+        const auto transform = PerspectiveTransform::QuadrilateralToQuadrilateral(
+            { Point{ 0.0f, 0.0f }, Point{ columns, 0.0f }, Point{ columns, rows }, Point{ 0.0f, rows } },
+            { up, up + (right - corner), right, corner });
+        if (sampleGrid(image, transform, size.columns, size.rows, modules)
+            && decodeDataMatrixModules(modules, size, text))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void decodeDataMatrices(const BinaryImage& image, std::vector<DecodedBarcode>& barcodes)
+{
+    // The L of the smallest symbol at 2 pixels per module
+    auto found = blobs(image, 16);
+    // The largest first, a symbol's L with the data modules touching it is rarely small
+    std::stable_sort(
+        found.begin(), found.end(), [](const Blob& a, const Blob& b) { return a.pixels > b.pixels; });
+    if (found.size() > 64)
+    {
+        found.resize(64);
+    }
+
+    std::vector<std::array<Point, 4>> decoded;
+    for (const auto& blob : found)
+    {
+        const auto outline = hull(blob);
+        if (outline.size() < 3)
+        {
+            continue;
+        }
+        // A blob inside a symbol read before is part of it
+        const Point middle = { (blob.left + blob.right) / 2.0f, (blob.top + blob.bottom) / 2.0f };
+        const auto inside = std::any_of(decoded.begin(), decoded.end(), [&](const std::array<Point, 4>& corners) {
+            size_t left = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                left += cross(corners[(i + 1) % 4] - corners[i], middle - corners[i]) < 0.0f ? 1 : 0;
+            }
+            // On the same side of all four edges, whichever way round they go
+            return left == 0 || left == 4;
+        });
+        if (inside)
+        {
+            continue;
+        }
+
+        bool read = false;
+        for (const auto& corners : enclosingRectangles(outline))
+        {
+            for (size_t i = 0; i < 4 && !read; ++i)
+            {
+                // On screen the arm going up comes before the arm going right, counter-clockwise
+                const auto& corner = corners[i];
+                const auto& next = corners[(i + 1) % 4];
+                const auto& previous = corners[(i + 3) % 4];
+                const bool nextIsUp = cross(next - corner, previous - corner) > 0.0f;
+                const auto& up = nextIsUp ? next : previous;
+                const auto& right = nextIsUp ? previous : next;
+
+                std::string text;
+                if (decodeDataMatrix(image, corner, up, right, text))
+                {
+                    read = true;
+                    decoded.push_back({ corner, right, right + (up - corner), up });
+                    DecodedBarcode barcode;
+                    barcode.symbology = BarcodeSymbology::DataMatrix;
+                    barcode.text = std::move(text);
+                    barcode.votes = 1;
+                    barcodes.push_back(std::move(barcode));
+                }
+            }
+            if (read)
+            {
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+MatrixCodeDecoder::MatrixCodeDecoder(const BarcodeDecoderOptions& options)
+    : m_qrCode(options.qrCode)
+    , m_dataMatrix(options.dataMatrix)
+{}
+
+std::vector<DecodedBarcode> MatrixCodeDecoder::Decode(const BinaryImage& image) const
+{
+    std::vector<DecodedBarcode> barcodes;
+    if (image.width < 8 || image.height < 8)
+    {
+        return barcodes;
+    }
+    if (m_qrCode)
+    {
+        decodeQrCodes(image, barcodes);
+    }
+    if (m_dataMatrix)
+    {
+        decodeDataMatrices(image, barcodes);
+    }
+
+    // A symbol found twice, e.g. from two rectangles around it, is one
+    std::vector<DecodedBarcode> unique;
+    for (auto& barcode : barcodes)
+    {
+        const auto seen = std::any_of(unique.begin(), unique.end(), [&](const DecodedBarcode& other) {
+            return other.symbology == barcode.symbology && other.text == barcode.text;
+        });
+        if (!seen)
+        {
+            unique.push_back(std::move(barcode));
+        }
+    }
+    return unique;
+}
@@ -0,0 +1,65 @@
+/*!
+ * \file    matrixcodedecoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The MatrixCodeDecoder class reads QR Code and Data Matrix
+ *          (ECC 200) symbols from a binarized image. QR Codes are found by
+ *          their three finder patterns, Data Matrix symbols by the solid L
+ *          along two of their sides. Both are sampled module by module and
+ *          repaired by their Reed-Solomon error correction, so a symbol that
+ *          reads at all reads right. BarcodeDecoder binarizes the image with
+ *          its SIMD kernels and runs this decoder on it.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef MATRIXCODEDECODER_H
+#define MATRIXCODEDECODER_H
+
+#include "barcodedecoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/*!
+ * \brief One bit per pixel, set for dark. Bit x % 64 of word x / 64 of a row, as written by the threshold kernels of
+ *        BarcodeDecoder.
+ */
+struct BinaryImage
+{
+    size_t width = 0;
+    size_t height = 0;
+    // Words per row
+    size_t stride = 0;
+    std::vector<uint64_t> bits;
+
+    bool Dark(size_t x, size_t y) const
+    {
+        return ((bits[y * stride + x / 64] >> (x % 64)) & 1) != 0;
+    }
+};
+
+
+class MatrixCodeDecoder
+{
+
+public:
+    // Reads the symbologies enabled by options.qrCode and options.dataMatrix
+    explicit MatrixCodeDecoder(const BarcodeDecoderOptions& options);
+
+    /*!
+     * \brief Decodes every symbol in the image. Each symbol is reported once with one vote, its error correction
+     *        stands in for the agreement of scan lines a linear barcode needs.
+     */
+    std::vector<DecodedBarcode> Decode(const BinaryImage& image) const;
+
+private:
+    bool m_qrCode;
+    bool m_dataMatrix;
+};
+
+#endif // MATRIXCODEDECODER_H
@@ -0,0 +1,204 @@
+/*!
+ * \file    multisizejpegencoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The MultiSizeJpegEncoder class encodes one Bayer image at full
+ *          size and at several smaller sizes, e.g. a thumbnail and a preview,
+ *          from a single debayer pass. While the full size JPEG is encoded in
+ *          strips, every debayered YCbCr strip is halved into the base of a
+ *          downscale pyramid. Each smaller output is encoded from its pyramid
+ *          level, all of them in parallel.
+ *
+ * \version 1.0.0
+ */
+
+#include "multisizejpegencoder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+
+// Deepest pyramid level, far below any useful output size
+constexpr size_t maximumLevel = 12;
+
+size_t halve(size_t size)
+{
+    return (size + 1) / 2;
+}
+
+// One level of the pyramid, tightly packed
+struct PyramidLevel
+{
+    size_t width = 0;
+    size_t rows = 0;
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> cb;
+    std::vector<uint8_t> cr;
+
+    void Resize(size_t levelWidth, size_t levelRows)
+    {
+        width = levelWidth;
+        rows = levelRows;
+        luma.resize(width * rows);
+        cb.resize(halve(width) * halve(rows));
+        cr.resize(halve(width) * halve(rows));
+    }
+
+    YCbCr420Planes Planes() const
+    {
+        YCbCr420Planes planes;
+        planes.luma = luma.data();
+        planes.lumaStride = width;
+        planes.cb = cb.data();
+        planes.cr = cr.data();
+        planes.chromaStride = halve(width);
+        planes.width = width;
+        planes.rows = rows;
+        return planes;
+    }
+};
+
+// 2x2 box filter. The last column and row are repeated where the source size is odd.
+void downscale(const uint8_t* source, size_t sourceWidth, size_t sourceRows, size_t sourceStride,
+    uint8_t* destination, size_t destinationStride)
+{
+    const auto width = halve(sourceWidth);
+    const auto rows = halve(sourceRows);
+
+    for (size_t y = 0; y < rows; ++y)
+    {
+        const auto* top = source + 2 * y * sourceStride;
+        const auto* bottom = source + std::min(2 * y + 1, sourceRows - 1) * sourceStride;
+        auto* output = destination + y * destinationStride;
+
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto left = 2 * x;
+            const auto right = std::min(left + 1, sourceWidth - 1);
+            output[x] = static_cast<uint8_t>((top[left] + top[right] + bottom[left] + bottom[right] + 2) / 4);
+        }
+    }
+}
+
+void downscale(const YCbCr420Planes& source, PyramidLevel& destination, size_t destinationRow)
+{
+    downscale(source.luma, source.width, source.rows, source.lumaStride,
+        destination.luma.data() + destinationRow * destination.width, destination.width);
+
+    const auto chromaWidth = halve(source.width);
+    const auto chromaRows = halve(source.rows);
+    const auto destinationChromaRow = destinationRow / 2;
+    const auto destinationChromaStride = halve(destination.width);
+    downscale(source.cb, chromaWidth, chromaRows, source.chromaStride,
+        destination.cb.data() + destinationChromaRow * destinationChromaStride, destinationChromaStride);
+    downscale(source.cr, chromaWidth, chromaRows, source.chromaStride,
+        destination.cr.data() + destinationChromaRow * destinationChromaStride, destinationChromaStride);
+}
+
+} // namespace
+
+
+const size_t MultiSizeJpegEncoder::MinimumLongSide;
+
+MultiSizeJpegEncoder::MultiSizeJpegEncoder(std::vector<JpegOutput> outputs, size_t threadCount, int quality)
+    : m_outputs(std::move(outputs))
+    , m_stripEncoder(threadCount, quality)
+{}
+
+const std::vector<JpegOutput>& MultiSizeJpegEncoder::Outputs() const
+{
+    return m_outputs;
+}
+
+size_t MultiSizeJpegEncoder::ThreadCount() const
+{
+    return m_stripEncoder.ThreadCount();
+}
+
+int MultiSizeJpegEncoder::Quality() const
+{
+    return m_stripEncoder.Quality();
+}
+
+std::vector<uint8_t> MultiSizeJpegEncoder::Encode(const peak::ipl::Image& bayerImage, std::vector<ScaledJpeg>& scaled)
+{
+    return Encode(bayerImage.Data(), bayerImage.Width(), bayerImage.Height(),
+        bayerImage.PixelFormat().PixelFormatName(), scaled);
+}
+
+std::vector<uint8_t> MultiSizeJpegEncoder::Encode(const uint8_t* bayer, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, std::vector<ScaledJpeg>& scaled)
+{
+    scaled.clear();
+    if (m_outputs.empty())
+    {
+        return m_stripEncoder.Encode(bayer, width, height, inputPixelFormat);
+    }
+
+    size_t deepest = 1;
+    for (const auto& output : m_outputs)
+    {
+        deepest = std::max(deepest, Level(width, height, output.longSide));
+    }
+
+    // Level 0 is the full size image, which only ever exists strip by strip inside the encoder
+    std::vector<PyramidLevel> pyramid(deepest + 1);
+    pyramid[1].Resize(halve(width), halve(height));
+
+    // Strips start on multiples of 16 rows, so each one maps to whole rows of level 1, chroma included. Strips
+    // encoded concurrently write disjoint rows.
+    auto full = m_stripEncoder.Encode(bayer, width, height, inputPixelFormat,
+        [&pyramid](size_t firstRow, const YCbCr420Planes& strip) { downscale(strip, pyramid[1], firstRow / 2); });
+
+    for (size_t level = 2; level <= deepest; ++level)
+    {
+        const auto& source = pyramid[level - 1];
+        pyramid[level].Resize(halve(source.width), halve(source.rows));
+        downscale(source.Planes(), pyramid[level], 0);
+    }
+
+    std::vector<ScaledJpeg> outputs(m_outputs.size());
+    m_stripEncoder.Parallel(m_outputs.size(), [&](size_t index) {
+        const auto& level = pyramid[Level(width, height, m_outputs[index].longSide)];
+        outputs[index].name = m_outputs[index].name;
+        outputs[index].width = level.width;
+        outputs[index].height = level.rows;
+        outputs[index].jpeg = BayerJpegEncoder::EncodePlanes(level.Planes(), m_outputs[index].quality);
+    });
+
+    scaled = std::move(outputs);
+    return full;
+}
+
+size_t MultiSizeJpegEncoder::Level(size_t width, size_t height, size_t longSide)
+{
+    const auto wanted = std::max(longSide, MinimumLongSide);
+
+    size_t level = 1;
+    auto side = halve(std::max(width, height));
+    while (level < maximumLevel && halve(side) >= wanted)
+    {
+        side = halve(side);
+        ++level;
+    }
+    return level;
+}
+
+std::vector<JpegOutput> MultiSizeJpegEncoder::DefaultOutputs()
+{
+    JpegOutput thumbnail;
+    thumbnail.name = "thumbnail";
+    thumbnail.longSide = 640;
+
+    JpegOutput preview;
+    preview.name = "preview";
+    preview.longSide = 160;
+
+    return { thumbnail, preview };
+}
@@ -0,0 +1,87 @@
+/*!
+ * \file    multisizejpegencoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The MultiSizeJpegEncoder class encodes one Bayer image at full
+ *          size and at several smaller sizes, e.g. a thumbnail and a preview,
+ *          from a single debayer pass. While the full size JPEG is encoded in
+ *          strips, every debayered YCbCr strip is halved into the base of a
+ *          downscale pyramid. Each smaller output is encoded from its pyramid
+ *          level, all of them in parallel.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef MULTISIZEJPEGENCODER_H
+#define MULTISIZEJPEGENCODER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "stripjpegencoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+struct JpegOutput
+{
+    // E.g. "thumbnail", ends up in the file name and the capture result
+    std::string name;
+    // Wanted length of the longer side. Rounded up to the next pyramid level, i.e. the full size halved n times.
+    size_t longSide = 0;
+    int quality = 75;
+};
+
+
+struct ScaledJpeg
+{
+    std::string name;
+    size_t width = 0;
+    size_t height = 0;
+    std::vector<uint8_t> jpeg;
+};
+
+
+class MultiSizeJpegEncoder
+{
+
+public:
+    /*!
+     * \param threadCount Threads sharing the work of one frame as in StripJpegEncoder, 0 for one per core
+     * \param quality Quality of the full size JPEG
+     */
+    MultiSizeJpegEncoder(std::vector<JpegOutput> outputs, size_t threadCount, int quality = 75);
+
+    const std::vector<JpegOutput>& Outputs() const;
+    size_t ThreadCount() const;
+    int Quality() const;
+
+    /*!
+     * \brief Encodes a Bayer image at full size, which is returned, and at the size of every output, which are
+     *        stored in \p scaled in the order of Outputs(). Thread-safe. Throws std::runtime_error if any of them
+     *        fails, \p scaled is left empty then.
+     */
+    std::vector<uint8_t> Encode(const peak::ipl::Image& bayerImage, std::vector<ScaledJpeg>& scaled);
+
+    std::vector<uint8_t> Encode(const uint8_t* bayer, size_t width, size_t height,
+        peak::ipl::PixelFormatName inputPixelFormat, std::vector<ScaledJpeg>& scaled);
+
+    // Pyramid level an output of \p longSide gets for a \p width x \p height image, 1 is half the size
+    static size_t Level(size_t width, size_t height, size_t longSide);
+
+    // A "thumbnail" for the operator UI with a long side of 640 and a "preview" for the LCD and the log of 160
+    static std::vector<JpegOutput> DefaultOutputs();
+
+    // Levels below this long side are not built
+    static const size_t MinimumLongSide = 16;
+
+private:
+    const std::vector<JpegOutput> m_outputs;
+    StripJpegEncoder m_stripEncoder;
+};
+
+#endif // MULTISIZEJPEGENCODER_H
@@ -0,0 +1,101 @@
+/*!
+ * \file    previewjpegencoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The PreviewJpegEncoder class encodes a Bayer image as a small JPEG
+ *          for a live view. The image is demosaiced straight to YCbCr 4:2:0
+ *          planes of the output size with
+ *          Debayer::ConvertScaledToYCbCr420, which have the colours of the
+ *          full size JPEG and go to BayerJpegEncoder::EncodePlanes. The cost
+ *          follows the preview size rather than the sensor size and a frame
+ *          takes a few milliseconds instead of a full debayer and encode.
+ *
+ * \version 1.0.0
+ */
+
+#include "previewjpegencoder.h"
+
+#include "bayerjpegencoder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+PreviewJpegEncoder::PreviewJpegEncoder(size_t longSide, int quality)
+    : m_longSide(std::max<size_t>(longSide, 16))
+    , m_quality(std::min(100, std::max(1, quality)))
+{}
+
+bool PreviewJpegEncoder::IsSupported(peak::ipl::PixelFormatName inputPixelFormat)
+{
+    return Debayer::IsSupported(inputPixelFormat, peak::ipl::PixelFormatName::RGB8);
+}
+
+size_t PreviewJpegEncoder::LongSide() const
+{
+    return m_longSide;
+}
+
+int PreviewJpegEncoder::Quality() const
+{
+    return m_quality;
+}
+
+void PreviewJpegEncoder::OutputSize(size_t width, size_t height, size_t& outputWidth, size_t& outputHeight) const
+{
+    const auto longSide = std::min(m_longSide, std::max(width, height) / 2);
+    if (width >= height)
+    {
+        outputWidth = longSide;
+        outputHeight = (height * longSide + width / 2) / width;
+    }
+    else
+    {
+        outputHeight = longSide;
+        outputWidth = (width * longSide + height / 2) / height;
+    }
+
+    // The scaled conversion wants at least one whole Bayer cell per output pixel
+    outputWidth = std::min(std::max<size_t>(outputWidth, 1), width / 2);
+    outputHeight = std::min(std::max<size_t>(outputHeight, 1), height / 2);
+}
+
+std::vector<uint8_t> PreviewJpegEncoder::Encode(const peak::ipl::Image& bayerImage)
+{
+    return Encode(
+        bayerImage.Data(), bayerImage.Width(), bayerImage.Height(), bayerImage.PixelFormat().PixelFormatName());
+}
+
+std::vector<uint8_t> PreviewJpegEncoder::Encode(
+    const uint8_t* bayer, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat)
+{
+    if (!IsSupported(inputPixelFormat))
+    {
+        throw std::invalid_argument("PreviewJpegEncoder: unsupported input pixel format");
+    }
+
+    size_t outputWidth = 0;
+    size_t outputHeight = 0;
+    OutputSize(width, height, outputWidth, outputHeight);
+
+    const auto chromaWidth = (outputWidth + 1) / 2;
+    const auto chromaRows = (outputHeight + 1) / 2;
+    m_luma.resize(outputWidth * outputHeight);
+    m_cb.resize(chromaWidth * chromaRows);
+    m_cr.resize(chromaWidth * chromaRows);
+
+    m_debayer.ConvertScaledToYCbCr420(bayer, width, height, inputPixelFormat, outputWidth, outputHeight,
+        m_luma.data(), outputWidth, m_cb.data(), m_cr.data(), chromaWidth);
+
+    YCbCr420Planes planes;
+    planes.luma = m_luma.data();
+    planes.lumaStride = outputWidth;
+    planes.cb = m_cb.data();
+    planes.cr = m_cr.data();
+    planes.chromaStride = chromaWidth;
+    planes.width = outputWidth;
+    planes.rows = outputHeight;
+    return BayerJpegEncoder::EncodePlanes(planes, m_quality);
+}
@@ -0,0 +1,71 @@
+/*!
+ * \file    previewjpegencoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The PreviewJpegEncoder class encodes a Bayer image as a small JPEG
+ *          for a live view. The image is demosaiced straight to YCbCr 4:2:0
+ *          planes of the output size with
+ *          Debayer::ConvertScaledToYCbCr420, which have the colours of the
+ *          full size JPEG and go to BayerJpegEncoder::EncodePlanes. The cost
+ *          follows the preview size rather than the sensor size and a frame
+ *          takes a few milliseconds instead of a full debayer and encode.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef PREVIEWJPEGENCODER_H
+#define PREVIEWJPEGENCODER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "debayer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+class PreviewJpegEncoder
+{
+
+public:
+    /*!
+     * \param longSide Length of the longer output side, capped at half the input so every output pixel has a whole
+     *        Bayer cell
+     */
+    explicit PreviewJpegEncoder(size_t longSide = 640, int quality = 70);
+
+    PreviewJpegEncoder(const PreviewJpegEncoder&) = delete;
+    PreviewJpegEncoder& operator=(const PreviewJpegEncoder&) = delete;
+
+    static bool IsSupported(peak::ipl::PixelFormatName inputPixelFormat);
+
+    size_t LongSide() const;
+    int Quality() const;
+
+    // Output size for a \p width x \p height input, keeping the aspect ratio
+    void OutputSize(size_t width, size_t height, size_t& outputWidth, size_t& outputHeight) const;
+
+    /*!
+     * \brief Encodes a Bayer image, e.g. peak::BufferTo<peak::ipl::Image>(buffer), into an in-memory JPEG of
+     *        OutputSize(). Not thread-safe, the scratch planes are reused from frame to frame.
+     */
+    std::vector<uint8_t> Encode(const peak::ipl::Image& bayerImage);
+
+    /*! \brief Encodes a raw, tightly packed Bayer image into an in-memory JPEG of OutputSize(). */
+    std::vector<uint8_t> Encode(
+        const uint8_t* bayer, size_t width, size_t height, peak::ipl::PixelFormatName inputPixelFormat);
+
+private:
+    const size_t m_longSide;
+    const int m_quality;
+    Debayer m_debayer;
+
+    std::vector<uint8_t> m_luma;
+    std::vector<uint8_t> m_cb;
+    std::vector<uint8_t> m_cr;
+};
+
+#endif // PREVIEWJPEGENCODER_H
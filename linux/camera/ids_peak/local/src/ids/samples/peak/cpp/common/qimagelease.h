@@ -0,0 +1,38 @@
+/*!
+ * \file    qimagelease.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Wraps an image of an ImagePool in a QImage without copying it.
+ *          The image returns to the pool when the last QImage sharing it is
+ *          destroyed, wherever that happens.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef QIMAGELEASE_H
+#define QIMAGELEASE_H
+
+#include "imagepool.h"
+
+#include <QImage>
+
+
+/*!
+ * \brief Returns a QImage on the memory of \p lease, or a null QImage if the lease is empty. The QImage takes over the
+ *        reference of the lease, copies of it share the image like any implicitly shared QImage.
+ */
+inline QImage ToQImage(ImageLease lease, int width, int height, int bytesPerLine, QImage::Format format)
+{
+    if (!lease)
+    {
+        return QImage();
+    }
+
+    // Data() must be taken before Detach() empties the lease
+    auto* data = lease.Data();
+    return QImage(data, width, height, bytesPerLine, format, ImageLease::Release, lease.Detach());
+}
+
+#endif // QIMAGELEASE_H
@@ -0,0 +1,326 @@
+/*!
+ * \file    stripjpegencoder.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The StripJpegEncoder class encodes one Bayer image on several
+ *          cores. The image is cut into horizontal strips of whole MCU rows,
+ *          every strip is encoded by BayerJpegEncoder on its own, and the
+ *          entropy coded data of the strips is joined into a single baseline
+ *          JPEG with a restart marker between consecutive strips. The result
+ *          decodes to exactly the same pixels as a single threaded encode.
+ *
+ * \version 1.0.0
+ */
+
+#include "stripjpegencoder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+
+// Height and width of a 4:2:0 MCU in pixels
+constexpr size_t mcuSize = 16;
+
+// JPEG markers, see ITU-T T.81 table B.1
+constexpr uint8_t markerSof0 = 0xC0;
+constexpr uint8_t markerRst0 = 0xD0;
+constexpr uint8_t markerSoi = 0xD8;
+constexpr uint8_t markerEoi = 0xD9;
+constexpr uint8_t markerSos = 0xDA;
+constexpr uint8_t markerDri = 0xDD;
+
+struct StripLayout
+{
+    // Start of the SOF0 and SOS segments, i.e. of their 0xFF byte
+    size_t frameHeader = 0;
+    size_t scanHeader = 0;
+    // Entropy coded data, between the SOS segment and EOI
+    size_t dataBegin = 0;
+    size_t dataEnd = 0;
+};
+
+StripLayout parseStrip(const std::vector<uint8_t>& jpeg)
+{
+    if (jpeg.size() < 4 || jpeg[0] != 0xFF || jpeg[1] != markerSoi || jpeg[jpeg.size() - 2] != 0xFF
+        || jpeg[jpeg.size() - 1] != markerEoi)
+    {
+        throw std::runtime_error("StripJpegEncoder: strip is not a JPEG");
+    }
+
+    StripLayout layout;
+    bool hasFrameHeader = false;
+
+    size_t position = 2;
+    while (position + 4 <= jpeg.size())
+    {
+        if (jpeg[position] != 0xFF)
+        {
+            throw std::runtime_error("StripJpegEncoder: corrupt strip header");
+        }
+
+        const auto marker = jpeg[position + 1];
+        if (marker == 0xFF)
+        {
+            // Fill byte before a marker
+            ++position;
+            continue;
+        }
+
+        const auto length = static_cast<size_t>(jpeg[position + 2]) << 8 | jpeg[position + 3];
+        if (marker == markerSof0)
+        {
+            layout.frameHeader = position;
+            hasFrameHeader = true;
+        }
+        else if (marker >= 0xC1 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        {
+            throw std::runtime_error("StripJpegEncoder: strip is not a baseline JPEG");
+        }
+        else if (marker == markerDri)
+        {
+            throw std::runtime_error("StripJpegEncoder: strip already uses restart markers");
+        }
+        else if (marker == markerSos)
+        {
+            if (!hasFrameHeader || position + 2 + length > jpeg.size() - 2)
+            {
+                break;
+            }
+            layout.scanHeader = position;
+            layout.dataBegin = position + 2 + length;
+            layout.dataEnd = jpeg.size() - 2;
+            return layout;
+        }
+
+        position += 2 + length;
+    }
+
+    throw std::runtime_error("StripJpegEncoder: strip has no scan");
+}
+
+} // namespace
+
+
+struct StripJpegEncoder::Job
+{
+    const std::function<void(size_t index)>* task = nullptr;
+    size_t count = 0;
+
+    // Guarded by StripJpegEncoder::m_mutex
+    size_t next = 0;
+    size_t finished = 0;
+    std::string error;
+    std::condition_variable done;
+};
+
+const size_t StripJpegEncoder::StripsPerThread;
+
+StripJpegEncoder::StripJpegEncoder(size_t threadCount, int quality)
+    : m_threadCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+    , m_encoder(quality)
+{
+    for (size_t i = 1; i < m_threadCount; ++i)
+    {
+        m_threads.emplace_back(&StripJpegEncoder::run, this);
+    }
+}
+
+StripJpegEncoder::~StripJpegEncoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+size_t StripJpegEncoder::ThreadCount() const
+{
+    return m_threadCount;
+}
+
+int StripJpegEncoder::Quality() const
+{
+    return m_encoder.Quality();
+}
+
+std::vector<uint8_t> StripJpegEncoder::Encode(const peak::ipl::Image& bayerImage)
+{
+    return Encode(
+        bayerImage.Data(), bayerImage.Width(), bayerImage.Height(), bayerImage.PixelFormat().PixelFormatName());
+}
+
+std::vector<uint8_t> StripJpegEncoder::Encode(const uint8_t* bayer, size_t width, size_t height,
+    peak::ipl::PixelFormatName inputPixelFormat, const BayerJpegEncoder::StripObserver& observer)
+{
+    const auto stripRows = StripRows(width, height);
+    const auto stripCount = (height + stripRows - 1) / stripRows;
+    if (m_threadCount < 2 || stripCount < 2)
+    {
+        return m_encoder.EncodeRows(bayer, width, height, inputPixelFormat, 0, height, observer);
+    }
+
+    std::vector<std::vector<uint8_t>> strips(stripCount);
+    Parallel(stripCount, [&](size_t index) {
+        const auto firstRow = index * stripRows;
+        const auto rowCount = std::min(stripRows, height - firstRow);
+        strips[index] = m_encoder.EncodeRows(bayer, width, height, inputPixelFormat, firstRow, rowCount, observer);
+    });
+
+    const auto mcusPerRow = (width + mcuSize - 1) / mcuSize;
+    return Join(strips, height, stripRows / mcuSize * mcusPerRow);
+}
+
+void StripJpegEncoder::Parallel(size_t count, const std::function<void(size_t index)>& task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->count = count;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.push_back(job);
+    m_condition.notify_all();
+
+    // The caller runs tasks of its own job until all are claimed, then waits for the ones still running
+    while (runNext(job, lock))
+    {
+    }
+    job->done.wait(lock, [&job] { return job->finished == job->count; });
+    lock.unlock();
+
+    if (!job->error.empty())
+    {
+        throw std::runtime_error("StripJpegEncoder: " + job->error);
+    }
+}
+
+size_t StripJpegEncoder::StripRows(size_t width, size_t height) const
+{
+    const auto mcuRows = std::max<size_t>((height + mcuSize - 1) / mcuSize, 1);
+    const auto mcusPerRow = std::max<size_t>((width + mcuSize - 1) / mcuSize, 1);
+    const auto strips = m_threadCount * StripsPerThread;
+
+    auto stripMcuRows = (mcuRows + strips - 1) / strips;
+    // The restart interval is a 16 bit count of MCUs
+    stripMcuRows = std::min(stripMcuRows, std::max<size_t>(0xFFFF / mcusPerRow, 1));
+
+    return stripMcuRows * mcuSize;
+}
+
+std::vector<uint8_t> StripJpegEncoder::Join(
+    const std::vector<std::vector<uint8_t>>& strips, size_t height, size_t restartInterval)
+{
+    if (strips.empty() || height > 0xFFFF || restartInterval > 0xFFFF)
+    {
+        throw std::invalid_argument("StripJpegEncoder: nothing to join or image too large");
+    }
+
+    std::vector<StripLayout> layouts;
+    layouts.reserve(strips.size());
+    size_t size = 0;
+    for (const auto& strip : strips)
+    {
+        layouts.push_back(parseStrip(strip));
+        size += layouts.back().dataEnd - layouts.back().dataBegin + 2;
+    }
+
+    const auto& first = strips.front();
+    const auto& firstLayout = layouts.front();
+
+    std::vector<uint8_t> jpeg;
+    jpeg.reserve(firstLayout.dataBegin + 6 + size + 2);
+
+    // Headers and tables of the first strip, with the frame height of the full image and a restart interval
+    jpeg.insert(jpeg.end(), first.begin(), first.begin() + firstLayout.scanHeader);
+    jpeg[firstLayout.frameHeader + 5] = static_cast<uint8_t>(height >> 8);
+    jpeg[firstLayout.frameHeader + 6] = static_cast<uint8_t>(height);
+
+    const uint8_t restart[] = { 0xFF, markerDri, 0x00, 0x04, static_cast<uint8_t>(restartInterval >> 8),
+        static_cast<uint8_t>(restartInterval) };
+    jpeg.insert(jpeg.end(), std::begin(restart), std::end(restart));
+    jpeg.insert(jpeg.end(), first.begin() + firstLayout.scanHeader, first.begin() + firstLayout.dataBegin);
+
+    // Each strip ends byte aligned and starts with fresh DC predictions, exactly what a restart marker implies
+    for (size_t i = 0; i < strips.size(); ++i)
+    {
+        if (i > 0)
+        {
+            jpeg.push_back(0xFF);
+            jpeg.push_back(static_cast<uint8_t>(markerRst0 + (i - 1) % 8));
+        }
+        jpeg.insert(jpeg.end(), strips[i].begin() + layouts[i].dataBegin, strips[i].begin() + layouts[i].dataEnd);
+    }
+
+    jpeg.push_back(0xFF);
+    jpeg.push_back(markerEoi);
+    return jpeg;
+}
+
+void StripJpegEncoder::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || !m_jobs.empty(); });
+        if (!m_running)
+        {
+            return;
+        }
+
+        const auto job = m_jobs.front();
+        runNext(job, lock);
+    }
+}
+
+bool StripJpegEncoder::runNext(const std::shared_ptr<Job>& job, std::unique_lock<std::mutex>& lock)
+{
+    if (job->next == job->count)
+    {
+        return false;
+    }
+
+    const auto index = job->next++;
+    if (job->next == job->count)
+    {
+        m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), job));
+    }
+    lock.unlock();
+
+    std::string error;
+    try
+    {
+        (*job->task)(index);
+    }
+    catch (const std::exception& e)
+    {
+        error = e.what();
+    }
+
+    lock.lock();
+    if (!error.empty() && job->error.empty())
+    {
+        job->error = error;
+    }
+    if (++job->finished == job->count)
+    {
+        job->done.notify_all();
+    }
+    return true;
+}
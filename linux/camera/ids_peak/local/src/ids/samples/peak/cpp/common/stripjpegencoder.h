@@ -0,0 +1,103 @@
+/*!
+ * \file    stripjpegencoder.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The StripJpegEncoder class encodes one Bayer image on several
+ *          cores. The image is cut into horizontal strips of whole MCU rows,
+ *          every strip is encoded by BayerJpegEncoder on its own, and the
+ *          entropy coded data of the strips is joined into a single baseline
+ *          JPEG with a restart marker between consecutive strips. The result
+ *          decodes to exactly the same pixels as a single threaded encode.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef STRIPJPEGENCODER_H
+#define STRIPJPEGENCODER_H
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "bayerjpegencoder.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+class StripJpegEncoder
+{
+
+public:
+    /*!
+     * \param threadCount Threads encoding the strips of a frame, 0 for one per core. The caller of Encode() is one
+     *        of them, so threadCount - 1 threads are started.
+     */
+    explicit StripJpegEncoder(size_t threadCount, int quality = 75);
+    ~StripJpegEncoder();
+
+    StripJpegEncoder(const StripJpegEncoder&) = delete;
+    StripJpegEncoder& operator=(const StripJpegEncoder&) = delete;
+
+    size_t ThreadCount() const;
+    int Quality() const;
+
+    /*!
+     * \brief Encodes a Bayer image into an in-memory JPEG. Thread-safe, concurrent calls share the threads.
+     *        Throws std::runtime_error if a strip fails to encode.
+     */
+    std::vector<uint8_t> Encode(const peak::ipl::Image& bayerImage);
+
+    /*!
+     * \brief Encodes a raw, tightly packed Bayer image. \p observer sees every debayered strip, concurrently from
+     *        several threads for different rows.
+     */
+    std::vector<uint8_t> Encode(const uint8_t* bayer, size_t width, size_t height,
+        peak::ipl::PixelFormatName inputPixelFormat,
+        const BayerJpegEncoder::StripObserver& observer = BayerJpegEncoder::StripObserver());
+
+    /*!
+     * \brief Runs task(0) to task(count - 1) on the encoder threads and the caller, and returns once all are done.
+     *        Thread-safe. Throws std::runtime_error with the message of the first task that threw.
+     */
+    void Parallel(size_t count, const std::function<void(size_t index)>& task);
+
+    // Rows per strip for an image of \p width x \p height, a multiple of the 16 row MCU height
+    size_t StripRows(size_t width, size_t height) const;
+
+    /*!
+     * \brief Joins standalone JPEGs of consecutive strips, all encoded with the same settings and all but the last
+     *        one \p restartInterval MCUs large, into one JPEG \p height rows high. Throws std::runtime_error if a
+     *        strip is not a baseline JPEG.
+     */
+    static std::vector<uint8_t> Join(
+        const std::vector<std::vector<uint8_t>>& strips, size_t height, size_t restartInterval);
+
+    // Strips per thread, so that a slow strip, e.g. a detailed part of the scene, does not hold up the others
+    static const size_t StripsPerThread = 2;
+
+private:
+    struct Job;
+
+    void run();
+    bool runNext(const std::shared_ptr<Job>& job, std::unique_lock<std::mutex>& lock);
+
+    const size_t m_threadCount;
+    const BayerJpegEncoder m_encoder;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    // Frames with strips, or other tasks, nobody has claimed yet
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    bool m_running = true;
+};
+
+#endif // STRIPJPEGENCODER_H
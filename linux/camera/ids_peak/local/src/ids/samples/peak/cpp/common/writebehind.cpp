@@ -0,0 +1,737 @@
+/*!
+ * \file    writebehind.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The WriteBehindQueue class moves file writes off the capture and
+ *          GUI threads. Jobs wait in a bounded queue for dedicated writer
+ *          threads, which write each file under a temporary name, optionally
+ *          sync it together with the other files of the batch, and rename it
+ *          into place. Readers never see a partially written file.
+ *
+ * \version 1.0.0
+ */
+
+#include "writebehind.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// io_uring is used through its system calls, so neither liburing nor a particular kernel is needed to build. Kernels
+// without it, or with it disabled by seccomp, fall back to write() and fdatasync() at runtime.
+#if defined(__linux__) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        include <linux/io_uring.h>
+#        include <sys/syscall.h>
+#        if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#            define WRITEBEHIND_IO_URING 1
+#        endif
+#    endif
+#endif
+
+
+const size_t WriteBehindQueue::MaximumBatch;
+
+
+namespace
+{
+
+std::string systemError(const std::string& what, const std::string& path, int error)
+{
+    return what + " " + path + ": " + std::strerror(error);
+}
+
+std::string directoryOf(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    if (slash == std::string::npos)
+    {
+        return ".";
+    }
+
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+// Writes \p size bytes at \p offset, returns 0 or the errno of the failure
+int writeAll(int file, const uint8_t* data, size_t size, uint64_t offset)
+{
+    while (size > 0)
+    {
+        const auto written = ::pwrite(file, data, size, static_cast<off_t>(offset));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno;
+        }
+        data += written;
+        offset += static_cast<uint64_t>(written);
+        size -= static_cast<size_t>(written);
+    }
+
+    return 0;
+}
+
+} // namespace
+
+
+/*!
+ * \brief Minimal io_uring submission and completion ring for writing and syncing whole files. One per writer thread,
+ *        not thread-safe.
+ */
+class WriteBehindQueue::IoRing
+{
+
+public:
+    explicit IoRing(unsigned entries);
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    bool Valid() const;
+
+    /*!
+     * \brief Queues a write of \p data at offset 0 of \p file. With \p sync, an fdatasync is linked to it, which only
+     *        runs if the write completed in full. The completions carry \p userData * 2 for the write and
+     *        \p userData * 2 + 1 for the sync. \p data must stay valid until Complete() returns.
+     */
+    bool QueueWrite(int file, const iovec* data, uint64_t userData, bool sync);
+
+    /*!
+     * \brief Submits everything queued and waits for all of it. \p complete is called with the user data and the
+     *        result of every entry, a negative errno on failure. Entries the kernel never saw complete with
+     *        -ECANCELED, the ring is not used again then.
+     */
+    void Complete(const std::function<void(uint64_t userData, int result)>& complete);
+
+private:
+#ifdef WRITEBEHIND_IO_URING
+    io_uring_sqe* entryAt(unsigned tail);
+    unsigned reap(const std::function<void(uint64_t userData, int result)>& complete);
+
+    int m_ring = -1;
+    bool m_broken = false;
+
+    void* m_sqMemory = MAP_FAILED;
+    size_t m_sqSize = 0;
+    void* m_cqMemory = MAP_FAILED;
+    size_t m_cqSize = 0;
+    io_uring_sqe* m_entries = nullptr;
+    size_t m_entriesSize = 0;
+
+    unsigned* m_sqHead = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+
+    // Entries queued since the last Complete()
+    unsigned m_queued = 0;
+#endif
+};
+
+
+#ifdef WRITEBEHIND_IO_URING
+
+WriteBehindQueue::IoRing::IoRing(unsigned entries)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    m_ring = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (m_ring < 0)
+    {
+        return;
+    }
+
+    m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMapping = false;
+#    ifdef IORING_FEAT_SINGLE_MMAP
+    singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#    endif
+    if (singleMapping)
+    {
+        m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+    }
+
+    m_sqMemory = ::mmap(nullptr, m_sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring,
+        IORING_OFF_SQ_RING);
+    m_cqMemory = singleMapping ? m_sqMemory
+                               : ::mmap(nullptr, m_cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring,
+                                   IORING_OFF_CQ_RING);
+    m_entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* entriesMemory = ::mmap(nullptr, m_entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring,
+        IORING_OFF_SQES);
+
+    if (m_sqMemory == MAP_FAILED || m_cqMemory == MAP_FAILED || entriesMemory == MAP_FAILED)
+    {
+        if (entriesMemory != MAP_FAILED)
+        {
+            ::munmap(entriesMemory, m_entriesSize);
+        }
+        m_broken = true;
+        return;
+    }
+    m_entries = static_cast<io_uring_sqe*>(entriesMemory);
+
+    auto* sq = static_cast<uint8_t*>(m_sqMemory);
+    m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    auto* cq = static_cast<uint8_t*>(m_cqMemory);
+    m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+WriteBehindQueue::IoRing::~IoRing()
+{
+    if (m_entries)
+    {
+        ::munmap(m_entries, m_entriesSize);
+    }
+    if (m_cqMemory != MAP_FAILED && m_cqMemory != m_sqMemory)
+    {
+        ::munmap(m_cqMemory, m_cqSize);
+    }
+    if (m_sqMemory != MAP_FAILED)
+    {
+        ::munmap(m_sqMemory, m_sqSize);
+    }
+    if (m_ring >= 0)
+    {
+        ::close(m_ring);
+    }
+}
+
+bool WriteBehindQueue::IoRing::Valid() const
+{
+    return m_ring >= 0 && !m_broken;
+}
+
+io_uring_sqe* WriteBehindQueue::IoRing::entryAt(unsigned tail)
+{
+    const auto index = tail & m_sqMask;
+    auto* entry = &m_entries[index];
+    std::memset(entry, 0, sizeof(*entry));
+    m_sqArray[index] = index;
+    return entry;
+}
+
+bool WriteBehindQueue::IoRing::QueueWrite(int file, const iovec* data, uint64_t userData, bool sync)
+{
+    if (!Valid())
+    {
+        return false;
+    }
+
+    // Only this thread moves the tail, the kernel moves the head as it consumes entries
+    const auto tail = *m_sqTail;
+    const unsigned count = sync ? 2 : 1;
+    if (m_sqEntries - (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE)) < count)
+    {
+        return false;
+    }
+
+    auto* write = entryAt(tail);
+    write->opcode = IORING_OP_WRITEV;
+    write->fd = file;
+    write->addr = reinterpret_cast<uint64_t>(data);
+    write->len = 1;
+    write->off = 0;
+    write->user_data = userData * 2;
+
+    if (sync)
+    {
+        write->flags |= IOSQE_IO_LINK;
+
+        auto* fsync = entryAt(tail + 1);
+        fsync->opcode = IORING_OP_FSYNC;
+        fsync->fd = file;
+        fsync->fsync_flags = IORING_FSYNC_DATASYNC;
+        fsync->user_data = userData * 2 + 1;
+    }
+
+    // Both entries are published with one tail update, so the kernel never sees a link without its successor
+    __atomic_store_n(m_sqTail, tail + count, __ATOMIC_RELEASE);
+    m_queued += count;
+    return true;
+}
+
+unsigned WriteBehindQueue::IoRing::reap(const std::function<void(uint64_t userData, int result)>& complete)
+{
+    unsigned reaped = 0;
+    auto head = *m_cqHead;
+    const auto tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head, ++reaped)
+    {
+        const auto& completion = m_cqes[head & m_cqMask];
+        complete(completion.user_data, completion.res);
+    }
+
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+void WriteBehindQueue::IoRing::Complete(const std::function<void(uint64_t userData, int result)>& complete)
+{
+    unsigned toSubmit = m_queued;
+    unsigned pending = m_queued;
+    m_queued = 0;
+
+    while (pending > 0)
+    {
+        const auto result = ::syscall(__NR_io_uring_enter, m_ring, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (result >= 0)
+        {
+            toSubmit -= std::min(toSubmit, static_cast<unsigned>(result));
+        }
+        else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            m_broken = true;
+
+            // Entries the kernel has not consumed are taken back and reported as not done
+            auto head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+            const auto tail = *m_sqTail;
+            for (; head != tail; ++head, --pending)
+            {
+                complete(m_entries[m_sqArray[head & m_sqMask]].user_data, -ECANCELED);
+            }
+            __atomic_store_n(m_sqTail, __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            toSubmit = 0;
+
+            // The ones already submitted still complete and reference the caller's memory, so keep reaping them
+            while (pending > 0)
+            {
+                const auto reaped = reap(complete);
+                pending -= std::min(pending, reaped);
+                if (reaped == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            return;
+        }
+
+        pending -= std::min(pending, reap(complete));
+    }
+}
+
+#else
+
+WriteBehindQueue::IoRing::IoRing(unsigned)
+{
+}
+
+WriteBehindQueue::IoRing::~IoRing()
+{
+}
+
+bool WriteBehindQueue::IoRing::Valid() const
+{
+    return false;
+}
+
+bool WriteBehindQueue::IoRing::QueueWrite(int, const iovec*, uint64_t, bool)
+{
+    return false;
+}
+
+void WriteBehindQueue::IoRing::Complete(const std::function<void(uint64_t userData, int result)>&)
+{
+}
+
+#endif
+
+
+WriteBehindQueue::WriteBehindQueue(WriteBehindOptions options)
+    : m_options(std::move(options))
+{
+}
+
+WriteBehindQueue::~WriteBehindQueue()
+{
+    Stop();
+}
+
+void WriteBehindQueue::SetLatencyRecorder(LatencyRecorder* recorder)
+{
+    m_latency = recorder;
+}
+
+void WriteBehindQueue::Start()
+{
+    Stop();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = true;
+    }
+
+    // Set up here rather than by the writers, so Counters() reports the io_uring writers as soon as this returns
+    m_rings.clear();
+    m_ioUringWriters = 0;
+    for (size_t i = 0; i < std::max<size_t>(m_options.threads, 1); ++i)
+    {
+        std::unique_ptr<IoRing> ring;
+        if (m_options.useIoUring)
+        {
+            // A write and its linked sync per job
+            ring = std::make_unique<IoRing>(2 * MaximumBatch);
+            if (ring->Valid())
+            {
+                m_ioUringWriters++;
+            }
+            else
+            {
+                ring.reset();
+            }
+        }
+
+        m_threads.emplace_back(&WriteBehindQueue::run, this, ring.get());
+        m_rings.push_back(std::move(ring));
+    }
+}
+
+void WriteBehindQueue::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+bool WriteBehindQueue::Submit(WriteBehindJob job)
+{
+    std::vector<WriteBehindJob> jobs;
+    jobs.push_back(std::move(job));
+    return SubmitAll(std::move(jobs));
+}
+
+bool WriteBehindQueue::SubmitAll(std::vector<WriteBehindJob> jobs)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running || m_jobs.size() + jobs.size() > m_options.capacity)
+        {
+            m_rejected += jobs.size();
+            return false;
+        }
+
+        const auto submitted = std::chrono::steady_clock::now();
+        for (auto& job : jobs)
+        {
+            Pending pending;
+            pending.job = std::move(job);
+            pending.submitted = submitted;
+            m_jobs.push_back(std::move(pending));
+        }
+        m_highWatermark = std::max(m_highWatermark, m_jobs.size());
+    }
+
+    m_submitted += jobs.size();
+    if (jobs.size() == 1)
+    {
+        m_condition.notify_one();
+    }
+    else
+    {
+        m_condition.notify_all();
+    }
+    return true;
+}
+
+WriteBehindCounters WriteBehindQueue::Counters() const
+{
+    WriteBehindCounters counters;
+    counters.submitted = m_submitted;
+    counters.written = m_written;
+    counters.failed = m_failed;
+    counters.rejected = m_rejected;
+    counters.bytes = m_bytes;
+    counters.syncs = m_syncs;
+    counters.ioUringWriters = m_ioUringWriters;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters.depth = m_jobs.size();
+    counters.highWatermark = m_highWatermark;
+    return counters;
+}
+
+std::string WriteBehindQueue::TemporaryPath(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    const auto directoryLength = (slash == std::string::npos) ? 0 : slash + 1;
+    return path.substr(0, directoryLength) + ".partial." + path.substr(directoryLength);
+}
+
+void WriteBehindQueue::run(IoRing* ring)
+{
+    // Whatever is queued when a writer wakes up forms the batch, so batches only grow while the disk is behind
+    const auto batchLimit = (m_options.syncBatch > 0) ? std::min(m_options.syncBatch, MaximumBatch) : MaximumBatch;
+    std::vector<Pending> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_running || !m_jobs.empty(); });
+
+            // Jobs queued before Stop() are still written
+            if (m_jobs.empty())
+            {
+                break;
+            }
+
+            while (!m_jobs.empty() && batch.size() < batchLimit)
+            {
+                batch.push_back(std::move(m_jobs.front()));
+                m_jobs.pop_front();
+            }
+        }
+
+        if (m_latency)
+        {
+            for (const auto& pending : batch)
+            {
+                m_latency->Record(LatencyStage::WriteQueue, pending.submitted);
+            }
+        }
+
+        writeBatch(batch, (ring && ring->Valid()) ? ring : nullptr);
+        batch.clear();
+    }
+}
+
+void WriteBehindQueue::writeBatch(std::vector<Pending>& batch, IoRing* ring)
+{
+    struct FileWrite
+    {
+        std::string temporaryPath;
+        int file = -1;
+        iovec data{};
+        uint64_t written = 0;
+        bool synced = false;
+        std::string error;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool sync = m_options.syncBatch > 0;
+
+    // Sized once, the iovecs must not move while the ring references them
+    std::vector<FileWrite> writes(batch.size());
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        auto& job = batch[i].job;
+        auto& write = writes[i];
+        write.temporaryPath = TemporaryPath(job.path);
+
+        if (job.writeFile)
+        {
+            try
+            {
+                job.writeFile(write.temporaryPath);
+            }
+            catch (const std::exception& e)
+            {
+                write.error = e.what();
+                continue;
+            }
+
+            struct stat status;
+            if (::stat(write.temporaryPath.c_str(), &status) == 0)
+            {
+                write.written = static_cast<uint64_t>(status.st_size);
+            }
+
+            // Opened again only to sync what the writer function wrote
+            if (sync)
+            {
+                write.file = ::open(write.temporaryPath.c_str(), O_RDONLY | O_CLOEXEC);
+                if (write.file < 0)
+                {
+                    write.error = systemError("Failed to open", write.temporaryPath, errno);
+                }
+            }
+            continue;
+        }
+
+        write.file = ::open(write.temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (write.file < 0)
+        {
+            write.error = systemError("Failed to create", write.temporaryPath, errno);
+            continue;
+        }
+
+        write.data.iov_base = job.data.data();
+        write.data.iov_len = job.data.size();
+        if (ring && !job.data.empty())
+        {
+            ring->QueueWrite(write.file, &write.data, i, sync);
+        }
+    }
+
+    if (ring)
+    {
+        ring->Complete([&](uint64_t userData, int result) {
+            auto& write = writes[userData / 2];
+            if (userData % 2 == 1)
+            {
+                // A failed or cancelled sync is retried below and reports the actual error there
+                write.synced = (result == 0);
+            }
+            else if (result >= 0)
+            {
+                write.written = static_cast<uint64_t>(result);
+            }
+            else if (result != -ECANCELED)
+            {
+                write.error = systemError("Failed to write", write.temporaryPath, -result);
+            }
+        });
+    }
+
+    // Whatever the ring did not finish, short writes included, is completed synchronously
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const auto& job = batch[i].job;
+        auto& write = writes[i];
+        if (!write.error.empty() || write.file < 0)
+        {
+            continue;
+        }
+
+        if (!job.writeFile && write.written < job.data.size())
+        {
+            const auto error =
+                writeAll(write.file, job.data.data() + write.written, job.data.size() - write.written, write.written);
+            if (error != 0)
+            {
+                write.error = systemError("Failed to write", write.temporaryPath, error);
+                continue;
+            }
+            write.written = job.data.size();
+        }
+
+        if (sync && !write.synced && ::fdatasync(write.file) != 0)
+        {
+            write.error = systemError("Failed to sync", write.temporaryPath, errno);
+        }
+    }
+
+    // Renamed only after every file of the batch is complete and synced, so a crash leaves either the whole file or
+    // nothing under the final name
+    std::set<std::string> directories;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const auto& job = batch[i].job;
+        auto& write = writes[i];
+
+        if (write.file >= 0)
+        {
+            ::close(write.file);
+            write.file = -1;
+        }
+
+        if (write.error.empty() && std::rename(write.temporaryPath.c_str(), job.path.c_str()) != 0)
+        {
+            write.error = systemError("Failed to rename", write.temporaryPath, errno);
+        }
+
+        if (!write.error.empty())
+        {
+            ::unlink(write.temporaryPath.c_str());
+        }
+        else if (sync)
+        {
+            directories.insert(directoryOf(job.path));
+        }
+    }
+
+    // One directory sync per batch makes the renames durable
+    for (const auto& directory : directories)
+    {
+        const auto file = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (file < 0 || ::fsync(file) != 0)
+        {
+            std::cout << "Write-behind: " << systemError("Failed to sync", directory, errno) << std::endl;
+        }
+        if (file >= 0)
+        {
+            ::close(file);
+        }
+    }
+    if (!directories.empty())
+    {
+        m_syncs++;
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        auto& pending = batch[i];
+        auto& write = writes[i];
+
+        WriteBehindResult result;
+        result.path = pending.job.path;
+        result.success = write.error.empty();
+        result.error = std::move(write.error);
+        result.latency_ms = std::chrono::duration<double, std::milli>(end - pending.submitted).count();
+
+        if (result.success)
+        {
+            result.bytes = write.written;
+            m_written++;
+            m_bytes += result.bytes;
+        }
+        else
+        {
+            m_failed++;
+        }
+
+        if (m_latency)
+        {
+            m_latency->Record(LatencyStage::Write, end - start);
+        }
+
+        if (pending.job.done)
+        {
+            pending.job.done(result);
+        }
+    }
+}
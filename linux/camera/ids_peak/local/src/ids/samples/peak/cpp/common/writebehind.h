@@ -0,0 +1,168 @@
+/*!
+ * \file    writebehind.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The WriteBehindQueue class moves file writes off the capture and
+ *          GUI threads. Jobs wait in a bounded queue for dedicated writer
+ *          threads, which write each file under a temporary name, optionally
+ *          sync it together with the other files of the batch, and rename it
+ *          into place. Readers never see a partially written file.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef WRITEBEHIND_H
+#define WRITEBEHIND_H
+
+#include "latencyhistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+struct WriteBehindOptions
+{
+    // Writer threads, each with its own io_uring instance
+    size_t threads = 1;
+    // Jobs that may wait for a writer, Submit() rejects jobs beyond this
+    size_t capacity = 16;
+    // 0 renames files without syncing them and leaves durability to the kernel's writeback. N syncs the files of up to
+    // N (at most MaximumBatch) queued jobs together, then renames them and syncs their directory once.
+    size_t syncBatch = 0;
+    // Write and sync byte jobs through io_uring if the kernel allows it, with write() and fdatasync() otherwise
+    bool useIoUring = true;
+};
+
+
+struct WriteBehindResult
+{
+    std::string path;
+    bool success = false;
+    std::string error;
+    uint64_t bytes = 0;
+    // Submit() until the file was renamed to its final path
+    double latency_ms = 0.0;
+};
+
+
+struct WriteBehindJob
+{
+    // Final path. The file is written next to it under TemporaryPath(path) and renamed when complete.
+    std::string path;
+    // Written as is, unless writeFile is set
+    std::vector<uint8_t> data;
+    // Writes the file itself, e.g. with peak::ipl::ImageWriter, to the temporary path it is called with. The temporary
+    // path keeps the extension of path. Exceptions fail the job.
+    std::function<void(const std::string& temporaryPath)> writeFile;
+    // Called on the writer thread when the job is finished or failed
+    std::function<void(const WriteBehindResult& result)> done;
+};
+
+
+/*!
+ * \brief Counters of a queue. All values are totals since construction, except depth.
+ */
+struct WriteBehindCounters
+{
+    uint64_t submitted = 0;
+    uint64_t written = 0;
+    uint64_t failed = 0;
+    // Jobs not accepted because the queue was full or stopped
+    uint64_t rejected = 0;
+    uint64_t bytes = 0;
+    // Batches synced before renaming, see WriteBehindOptions::syncBatch
+    uint64_t syncs = 0;
+    size_t depth = 0;
+    size_t highWatermark = 0;
+    // Writers that use io_uring
+    size_t ioUringWriters = 0;
+};
+
+
+class WriteBehindQueue
+{
+
+public:
+    explicit WriteBehindQueue(WriteBehindOptions options);
+    ~WriteBehindQueue();
+
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+    /*!
+     * \brief Records the time every job waited in the queue (write_queue) and the time to write, sync and rename it
+     *        (write) in \p recorder, which must outlive the queue. Takes effect on the next Start().
+     */
+    void SetLatencyRecorder(LatencyRecorder* recorder);
+
+    void Start();
+
+    // Writes the jobs still queued, then joins the writers
+    void Stop();
+
+    /*!
+     * \brief Queues \p job without waiting. Returns false if the queue is full or not running, \p job is dropped then
+     *        and its done callback is not called.
+     */
+    bool Submit(WriteBehindJob job);
+
+    /*!
+     * \brief Queues all of \p jobs or none of them, e.g. the files of one capture. Returns false if they don't all fit
+     *        or the queue is not running, all of them are dropped then.
+     */
+    bool SubmitAll(std::vector<WriteBehindJob> jobs);
+
+    WriteBehindCounters Counters() const;
+
+    // Hidden file next to \p path with the same extension, so that format detection by extension still works
+    static std::string TemporaryPath(const std::string& path);
+
+    // Largest number of jobs a writer takes at once when syncBatch does not limit it
+    static const size_t MaximumBatch = 16;
+
+private:
+    struct Pending
+    {
+        WriteBehindJob job;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    class IoRing;
+
+    void run(IoRing* ring);
+    void writeBatch(std::vector<Pending>& batch, IoRing* ring);
+
+    const WriteBehindOptions m_options;
+    LatencyRecorder* m_latency = nullptr;
+    std::vector<std::thread> m_threads;
+    // One per writer, null where io_uring is not used
+    std::vector<std::unique_ptr<IoRing>> m_rings;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Pending> m_jobs;
+    bool m_running = false;
+    size_t m_highWatermark = 0;
+
+    std::atomic<uint64_t> m_submitted{ 0 };
+    std::atomic<uint64_t> m_written{ 0 };
+    std::atomic<uint64_t> m_failed{ 0 };
+    std::atomic<uint64_t> m_rejected{ 0 };
+    std::atomic<uint64_t> m_bytes{ 0 };
+    std::atomic<uint64_t> m_syncs{ 0 };
+    std::atomic<size_t> m_ioUringWriters{ 0 };
+};
+
+#endif // WRITEBEHIND_H
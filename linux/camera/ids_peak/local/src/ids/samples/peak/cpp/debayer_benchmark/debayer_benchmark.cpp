@@ -0,0 +1,297 @@
+/*!
+ * \file    debayer_benchmark.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application compares the Debayer kernels with
+ *          peak::ipl::ImageConverter on synthetic Bayer images at the
+ *          resolutions of our cameras. It reports the conversion time of
+ *          every kernel and its PSNR against the IDS peak IPL output.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "debayer.h"
+
+
+struct Resolution
+{
+    size_t width;
+    size_t height;
+};
+
+struct Options
+{
+    size_t iterations = 20;
+    peak::ipl::PixelFormatName inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+};
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line: --iterations <n> and --pattern RG|GR|BG|GB.
+ */
+Options parse_options(int argc, char* argv[]);
+
+/*! \brief Create Bayer Image function
+ *
+ * The function renders a scene with gradients, fine rings and sensor noise
+ * and samples it with the given Bayer pattern.
+ */
+peak::ipl::Image create_bayer_image(peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height);
+
+/*! \brief Measure function
+ *
+ * The function runs the conversion for the given number of iterations and
+ * returns the mean time per frame in milliseconds.
+ */
+template <typename Conversion>
+double measure(size_t iterations, Conversion conversion);
+
+/*! \brief PSNR function
+ *
+ * The function returns the peak signal-to-noise ratio of two 8 bit buffers
+ * of the same size in dB, or infinity if they are identical.
+ */
+double psnr(const uint8_t* a, const uint8_t* b, size_t size);
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"debayer_benchmark\" v" << VERSION << std::endl;
+
+    const auto options = parse_options(argc, argv);
+
+    const std::vector<Resolution> resolutions = { { 4000, 3000 }, { 3264, 2448 } };
+    const std::vector<peak::ipl::PixelFormatName> outputPixelFormats = { peak::ipl::PixelFormatName::BGRa8,
+        peak::ipl::PixelFormatName::RGB8, peak::ipl::PixelFormatName::Mono8 };
+
+    std::cout << "Input: " << peak::ipl::PixelFormat(options.inputPixelFormat).Name() << ", "
+              << options.iterations << " iterations, best kernel: " << Debayer::IsaName(Debayer::BestIsa())
+              << std::endl
+              << std::endl;
+
+    std::cout << std::left << std::setw(11) << "resolution" << std::setw(8) << "output" << std::setw(9)
+              << "kernel" << std::right << std::setw(10) << "ms/frame" << std::setw(10) << "MPix/s"
+              << std::setw(10) << "speedup" << std::setw(12) << "PSNR [dB]" << std::endl;
+
+    try
+    {
+        for (const auto& resolution : resolutions)
+        {
+            const auto input = create_bayer_image(options.inputPixelFormat, resolution.width, resolution.height);
+            const auto megapixels = static_cast<double>(resolution.width * resolution.height) / 1e6;
+            const auto resolutionName = std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+
+            for (const auto outputPixelFormat : outputPixelFormats)
+            {
+                const auto outputName = peak::ipl::PixelFormat(outputPixelFormat).Name();
+
+                auto printRow = [&](const std::string& kernel, double ms, double referenceMs, double quality) {
+                    std::cout << std::left << std::setw(11) << resolutionName << std::setw(8) << outputName
+                              << std::setw(9) << kernel << std::right << std::fixed << std::setprecision(2)
+                              << std::setw(10) << ms << std::setw(10) << std::setprecision(1) << megapixels * 1000.0 / ms
+                              << std::setw(9) << std::setprecision(2) << referenceMs / ms << "x";
+                    if (std::isnan(quality))
+                    {
+                        std::cout << std::setw(12) << "n/a";
+                    }
+                    else if (std::isinf(quality))
+                    {
+                        std::cout << std::setw(12) << "identical";
+                    }
+                    else
+                    {
+                        std::cout << std::setw(12) << std::setprecision(2) << quality;
+                    }
+                    std::cout << std::endl;
+                };
+
+                // Reference: the IDS peak IPL converter, pre-allocated like in the acquisition workers
+                peak::ipl::ImageConverter imageConverter;
+                peak::ipl::Image reference;
+                double referenceMs = 0.0;
+
+                try
+                {
+                    imageConverter.PreAllocateConversion(options.inputPixelFormat, outputPixelFormat,
+                        resolution.width, resolution.height, 2);
+                    reference = imageConverter.Convert(input, outputPixelFormat);
+                    referenceMs = measure(options.iterations,
+                        [&] { reference = imageConverter.Convert(input, outputPixelFormat); });
+                    printRow("ipl", referenceMs, referenceMs, std::numeric_limits<double>::infinity());
+                }
+                catch (const std::exception& e)
+                {
+                    std::cout << resolutionName << " " << outputName << ": IPL conversion not available ("
+                              << e.what() << ")" << std::endl;
+                }
+
+                for (const auto isa : Debayer::AvailableIsas())
+                {
+                    const Debayer debayer(isa);
+                    auto output = debayer.Convert(input, outputPixelFormat);
+                    const auto ms = measure(options.iterations, [&] {
+                        debayer.Convert(input, outputPixelFormat, output.Data(), output.ByteCount());
+                    });
+
+                    const auto quality = reference.Empty()
+                        ? std::numeric_limits<double>::quiet_NaN()
+                        : psnr(reference.Data(), output.Data(), std::min(reference.ByteCount(), output.ByteCount()));
+                    printRow(Debayer::IsaName(isa), ms, (referenceMs > 0.0) ? referenceMs : ms, quality);
+                }
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = (i + 1) < argc;
+
+        if (argument == "--iterations" && hasValue)
+        {
+            options.iterations = std::max<size_t>(std::stoul(argv[++i]), 1);
+        }
+        else if (argument == "--pattern" && hasValue)
+        {
+            const std::string pattern = argv[++i];
+            if (pattern == "RG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+            }
+            else if (pattern == "GR")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGR8;
+            }
+            else if (pattern == "BG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerBG8;
+            }
+            else if (pattern == "GB")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGB8;
+            }
+            else
+            {
+                std::cout << "Ignoring unknown pattern: " << pattern << std::endl;
+            }
+        }
+        else
+        {
+            std::cout << "Ignoring unknown argument: " << argument << std::endl;
+        }
+    }
+
+    return options;
+}
+
+peak::ipl::Image create_bayer_image(peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height)
+{
+    // Colour channel (0 = red, 1 = green, 2 = blue) at the even/odd row and column of the 2x2 cell
+    int cell[2][2] = { { 0, 1 }, { 1, 2 } };
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BayerGR8:
+        cell[0][0] = 1, cell[0][1] = 0, cell[1][0] = 2, cell[1][1] = 1;
+        break;
+    case peak::ipl::PixelFormatName::BayerBG8:
+        cell[0][0] = 2, cell[0][1] = 1, cell[1][0] = 1, cell[1][1] = 0;
+        break;
+    case peak::ipl::PixelFormatName::BayerGB8:
+        cell[0][0] = 1, cell[0][1] = 2, cell[1][0] = 0, cell[1][1] = 1;
+        break;
+    default:
+        break;
+    }
+
+    peak::ipl::Image image(peak::ipl::PixelFormat(pixelFormat), width, height);
+    auto* data = image.Data();
+
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 2.0);
+
+    const auto centerX = static_cast<double>(width) / 2.0;
+    const auto centerY = static_cast<double>(height) / 2.0;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto u = static_cast<double>(x) / static_cast<double>(width);
+            const auto v = static_cast<double>(y) / static_cast<double>(height);
+            const auto radius = std::hypot(static_cast<double>(x) - centerX, static_cast<double>(y) - centerY);
+            const auto rings = 0.5 + 0.5 * std::sin(radius * radius / 4000.0);
+
+            const double scene[3] = { 255.0 * (0.2 + 0.6 * u * rings), 255.0 * (0.3 + 0.5 * rings),
+                255.0 * (0.2 + 0.6 * v * (1.0 - rings)) };
+
+            const auto value = scene[cell[y & 1][x & 1]] + noise(random);
+            data[y * width + x] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::round(value))));
+        }
+    }
+
+    return image;
+}
+
+template <typename Conversion>
+double measure(size_t iterations, Conversion conversion)
+{
+    // One untimed run warms up caches and lazy allocations
+    conversion();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        conversion();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+double psnr(const uint8_t* a, const uint8_t* b, size_t size)
+{
+    double sumOfSquares = 0.0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+        sumOfSquares += difference * difference;
+    }
+
+    if (sumOfSquares == 0.0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const auto meanSquaredError = sumOfSquares / static_cast<double>(size);
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
@@ -0,0 +1,513 @@
+/*!
+ * \file    jpeg_benchmark.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application compares the JPEG encoders of the capture
+ *          pipeline on synthetic Bayer images at the resolutions of our
+ *          cameras: single threaded libjpeg-turbo on debayered RGB8, the
+ *          direct BayerJpegEncoder and the StripJpegEncoder at several
+ *          thread counts, and the MultiSizeJpegEncoder, which adds a
+ *          thumbnail and a preview to the strip encode. It reports the time
+ *          per frame, the file size and whether the full size JPEG decodes to
+ *          the same pixels. Before that it checks that saturated red and
+ *          blue keep their chroma.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csetjmp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "bayerjpegencoder.h"
+#include "debayer.h"
+#include "multisizejpegencoder.h"
+#include "stripjpegencoder.h"
+
+// jpeglib.h needs FILE and size_t declared before it
+#include <jpeglib.h>
+
+
+struct Resolution
+{
+    size_t width;
+    size_t height;
+};
+
+struct Options
+{
+    size_t iterations = 10;
+    peak::ipl::PixelFormatName inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+    // Largest strip thread count, 0 for one per core
+    size_t threads = 0;
+};
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line: --iterations <n>, --pattern RG|GR|BG|GB and --threads <n>.
+ */
+Options parse_options(int argc, char* argv[]);
+
+/*! \brief Create Bayer Image function
+ *
+ * The function renders a scene with gradients, fine rings and sensor noise
+ * and samples it with the given Bayer pattern.
+ */
+peak::ipl::Image create_bayer_image(peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height);
+
+/*! \brief Check Saturated Colours function
+ *
+ * The function encodes a pure red and a pure blue patch with the
+ * BayerJpegEncoder and returns whether the decoded Cr of the red patch and
+ * Cb of the blue patch are near 255 rather than wrapped around to 0.
+ */
+bool check_saturated_colours(peak::ipl::PixelFormatName pixelFormat);
+
+/*! \brief Measure function
+ *
+ * The function runs the encoder for the given number of iterations and
+ * returns the mean time per frame in milliseconds.
+ */
+template <typename Encoding>
+double measure(size_t iterations, Encoding encoding);
+
+/*! \brief Encode RGB function
+ *
+ * The function encodes an RGB8 image with libjpeg(-turbo) on the calling
+ * thread, with the same quality and 4:2:0 subsampling as the Bayer encoders.
+ * Throws std::runtime_error on failure.
+ */
+std::vector<uint8_t> encode_rgb(const uint8_t* rgb, size_t width, size_t height, int quality);
+
+/*! \brief Decode function
+ *
+ * The function decodes a JPEG to RGB8, or to interleaved YCbCr with
+ * \p colorSpace JCS_YCbCr, with libjpeg(-turbo). Throws std::runtime_error on
+ * failure.
+ */
+std::vector<uint8_t> decode(
+    const std::vector<uint8_t>& jpeg, size_t& width, size_t& height, J_COLOR_SPACE colorSpace = JCS_RGB);
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"jpeg_benchmark\" v" << VERSION << std::endl;
+
+    const auto options = parse_options(argc, argv);
+
+    const std::vector<Resolution> resolutions = { { 4000, 3000 }, { 3264, 2448 } };
+    const std::vector<int> qualities = { 50, 75, 90, 95 };
+
+    const auto maximumThreads =
+        (options.threads > 0) ? options.threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 2; threads < maximumThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    if (maximumThreads > 1)
+    {
+        threadCounts.push_back(maximumThreads);
+    }
+
+    std::cout << "Input: " << peak::ipl::PixelFormat(options.inputPixelFormat).Name() << ", "
+              << options.iterations << " iterations, up to " << maximumThreads << " strip thread(s)" << std::endl;
+
+    try
+    {
+        const auto saturated = check_saturated_colours(options.inputPixelFormat);
+        std::cout << "Saturated red and blue: " << (saturated ? "ok" : "chroma wrapped around") << std::endl
+                  << std::endl;
+        if (!saturated)
+        {
+            return EXIT_FAILURE;
+        }
+
+        std::cout << std::left << std::setw(11) << "resolution" << std::setw(9) << "quality" << std::setw(12)
+                  << "encoder" << std::right << std::setw(10) << "ms/frame" << std::setw(10) << "MPix/s"
+                  << std::setw(10) << "speedup" << std::setw(10) << "size [kB]" << std::setw(12) << "decoded"
+                  << std::endl;
+
+        for (const auto& resolution : resolutions)
+        {
+            const auto input = create_bayer_image(options.inputPixelFormat, resolution.width, resolution.height);
+            const auto megapixels = static_cast<double>(resolution.width * resolution.height) / 1e6;
+            const auto resolutionName = std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+
+            const Debayer debayer;
+            auto rgb = debayer.Convert(input, peak::ipl::PixelFormatName::RGB8);
+
+            for (const auto quality : qualities)
+            {
+                auto printRow = [&](const std::string& encoder, double ms, double referenceMs, size_t bytes,
+                                    const std::string& decoded) {
+                    std::cout << std::left << std::setw(11) << resolutionName << std::setw(9) << quality
+                              << std::setw(12) << encoder << std::right << std::fixed << std::setprecision(2)
+                              << std::setw(10) << ms << std::setw(10) << std::setprecision(1) << megapixels * 1000.0 / ms
+                              << std::setw(9) << std::setprecision(2) << referenceMs / ms << "x" << std::setw(10)
+                              << bytes / 1024 << std::setw(12) << decoded << std::endl;
+                };
+
+                // Reference: debayer to RGB8, then single threaded libjpeg-turbo, like the IPL writer path
+                std::vector<uint8_t> jpeg;
+                const auto referenceMs = measure(options.iterations, [&] {
+                    debayer.Convert(input, peak::ipl::PixelFormatName::RGB8, rgb.Data(), rgb.ByteCount());
+                    jpeg = encode_rgb(rgb.Data(), resolution.width, resolution.height, quality);
+                });
+                printRow("rgb+turbo", referenceMs, referenceMs, jpeg.size(), "n/a");
+
+                // The direct encoder on one thread, whose decoded pixels every strip encode must reproduce
+                const BayerJpegEncoder directEncoder(quality);
+                const auto directMs = measure(options.iterations, [&] { jpeg = directEncoder.Encode(input); });
+                printRow("direct", directMs, referenceMs, jpeg.size(), "reference");
+
+                size_t directWidth = 0;
+                size_t directHeight = 0;
+                const auto directPixels = decode(jpeg, directWidth, directHeight);
+
+                for (const auto threads : threadCounts)
+                {
+                    StripJpegEncoder stripEncoder(threads, quality);
+                    const auto ms = measure(options.iterations, [&] { jpeg = stripEncoder.Encode(input); });
+
+                    size_t width = 0;
+                    size_t height = 0;
+                    const auto pixels = decode(jpeg, width, height);
+                    const auto identical = width == directWidth && height == directHeight && pixels == directPixels;
+
+                    printRow("strip " + std::to_string(threads), ms, referenceMs, jpeg.size(),
+                        identical ? "identical" : "differs");
+                }
+
+                // Full size plus the default thumbnail and preview, sized by the full size JPEG alone
+                MultiSizeJpegEncoder multiSizeEncoder(MultiSizeJpegEncoder::DefaultOutputs(), maximumThreads, quality);
+                std::vector<ScaledJpeg> scaled;
+                const auto multiSizeMs =
+                    measure(options.iterations, [&] { jpeg = multiSizeEncoder.Encode(input, scaled); });
+
+                size_t width = 0;
+                size_t height = 0;
+                const auto pixels = decode(jpeg, width, height);
+                const auto identical = width == directWidth && height == directHeight && pixels == directPixels;
+
+                printRow("multi " + std::to_string(maximumThreads), multiSizeMs, referenceMs, jpeg.size(),
+                    identical ? "identical" : "differs");
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = (i + 1) < argc;
+
+        if (argument == "--iterations" && hasValue)
+        {
+            options.iterations = std::max<size_t>(std::stoul(argv[++i]), 1);
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            options.threads = std::stoul(argv[++i]);
+        }
+        else if (argument == "--pattern" && hasValue)
+        {
+            const std::string pattern = argv[++i];
+            if (pattern == "RG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerRG8;
+            }
+            else if (pattern == "GR")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGR8;
+            }
+            else if (pattern == "BG")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerBG8;
+            }
+            else if (pattern == "GB")
+            {
+                options.inputPixelFormat = peak::ipl::PixelFormatName::BayerGB8;
+            }
+            else
+            {
+                std::cout << "Ignoring unknown pattern: " << pattern << std::endl;
+            }
+        }
+        else
+        {
+            std::cout << "Ignoring unknown argument: " << argument << std::endl;
+        }
+    }
+
+    return options;
+}
+
+peak::ipl::Image create_bayer_image(peak::ipl::PixelFormatName pixelFormat, size_t width, size_t height)
+{
+    // Colour channel (0 = red, 1 = green, 2 = blue) at the even/odd row and column of the 2x2 cell
+    int cell[2][2] = { { 0, 1 }, { 1, 2 } };
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BayerGR8:
+        cell[0][0] = 1, cell[0][1] = 0, cell[1][0] = 2, cell[1][1] = 1;
+        break;
+    case peak::ipl::PixelFormatName::BayerBG8:
+        cell[0][0] = 2, cell[0][1] = 1, cell[1][0] = 1, cell[1][1] = 0;
+        break;
+    case peak::ipl::PixelFormatName::BayerGB8:
+        cell[0][0] = 1, cell[0][1] = 2, cell[1][0] = 0, cell[1][1] = 1;
+        break;
+    default:
+        break;
+    }
+
+    peak::ipl::Image image(peak::ipl::PixelFormat(pixelFormat), width, height);
+    auto* data = image.Data();
+
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 2.0);
+
+    const auto centerX = static_cast<double>(width) / 2.0;
+    const auto centerY = static_cast<double>(height) / 2.0;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto u = static_cast<double>(x) / static_cast<double>(width);
+            const auto v = static_cast<double>(y) / static_cast<double>(height);
+            const auto radius = std::hypot(static_cast<double>(x) - centerX, static_cast<double>(y) - centerY);
+            const auto rings = 0.5 + 0.5 * std::sin(radius * radius / 4000.0);
+
+            const double scene[3] = { 255.0 * (0.2 + 0.6 * u * rings), 255.0 * (0.3 + 0.5 * rings),
+                255.0 * (0.2 + 0.6 * v * (1.0 - rings)) };
+
+            const auto value = scene[cell[y & 1][x & 1]] + noise(random);
+            data[y * width + x] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::round(value))));
+        }
+    }
+
+    return image;
+}
+
+bool check_saturated_colours(peak::ipl::PixelFormatName pixelFormat)
+{
+    // Colour channel (0 = red, 2 = blue, otherwise green) at the even/odd row and column of the 2x2 cell
+    int cell[2][2] = { { 0, 1 }, { 1, 2 } };
+    switch (pixelFormat)
+    {
+    case peak::ipl::PixelFormatName::BayerGR8:
+        cell[0][0] = 1, cell[0][1] = 0, cell[1][0] = 2, cell[1][1] = 1;
+        break;
+    case peak::ipl::PixelFormatName::BayerBG8:
+        cell[0][0] = 2, cell[0][1] = 1, cell[1][0] = 1, cell[1][1] = 0;
+        break;
+    case peak::ipl::PixelFormatName::BayerGB8:
+        cell[0][0] = 1, cell[0][1] = 2, cell[1][0] = 0, cell[1][1] = 1;
+        break;
+    default:
+        break;
+    }
+
+    // Left half pure red, right half pure blue, each several MCUs wide
+    const size_t width = 128;
+    const size_t height = 64;
+    peak::ipl::Image image(peak::ipl::PixelFormat(pixelFormat), width, height);
+    auto* data = image.Data();
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto lit = (x < width / 2) ? 0 : 2;
+            data[y * width + x] = (cell[y & 1][x & 1] == lit) ? 255 : 0;
+        }
+    }
+
+    const BayerJpegEncoder encoder(90);
+    size_t decodedWidth = 0;
+    size_t decodedHeight = 0;
+    const auto pixels = decode(encoder.Encode(image), decodedWidth, decodedHeight, JCS_YCbCr);
+    if (decodedWidth != width || decodedHeight != height)
+    {
+        return false;
+    }
+
+    // Centres of the patches, away from the demosaic and JPEG ringing at the border between them
+    const auto* red = pixels.data() + ((height / 2) * width + width / 4) * 3;
+    const auto* blue = pixels.data() + ((height / 2) * width + 3 * width / 4) * 3;
+
+    // Exact JFIF values: red Cb 85 Cr 255, blue Cb 255 Cr 107
+    const int tolerance = 8;
+    auto near = [&](uint8_t value, int expected) { return std::abs(static_cast<int>(value) - expected) <= tolerance; };
+    return near(red[1], 85) && near(red[2], 255) && near(blue[1], 255) && near(blue[2], 107);
+}
+
+template <typename Encoding>
+double measure(size_t iterations, Encoding encoding)
+{
+    // One untimed run warms up caches, lazy allocations and the strip threads
+    encoding();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        encoding();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+namespace
+{
+
+struct ErrorManager
+{
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void errorExit(j_common_ptr info)
+{
+    auto* error = reinterpret_cast<ErrorManager*>(info->err);
+    (*info->err->format_message)(info, error->message);
+    std::longjmp(error->jump, 1);
+}
+
+// Plain C state only between setjmp and the return, so a longjmp does not skip destructors
+bool compress(jpeg_compress_struct& info, ErrorManager& error, const uint8_t* rgb, size_t width, size_t height,
+    int quality, unsigned char** output, unsigned long* outputSize)
+{
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = errorExit;
+
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_compress(&info);
+        return false;
+    }
+
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, output, outputSize);
+
+    info.image_width = static_cast<JDIMENSION>(width);
+    info.image_height = static_cast<JDIMENSION>(height);
+    info.input_components = 3;
+    info.in_color_space = JCS_RGB;
+
+    // The defaults subsample chroma 4:2:0, like the Bayer encoders
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality, TRUE);
+    jpeg_start_compress(&info, TRUE);
+
+    while (info.next_scanline < info.image_height)
+    {
+        auto row = const_cast<JSAMPROW>(rgb + info.next_scanline * width * 3);
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return true;
+}
+
+bool decompress(jpeg_decompress_struct& info, ErrorManager& error, const std::vector<uint8_t>& jpeg,
+    J_COLOR_SPACE colorSpace, std::vector<uint8_t>& pixels, size_t& width, size_t& height)
+{
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = errorExit;
+
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, jpeg.data(), static_cast<unsigned long>(jpeg.size()));
+    jpeg_read_header(&info, TRUE);
+    info.out_color_space = colorSpace;
+    jpeg_start_decompress(&info);
+
+    width = info.output_width;
+    height = info.output_height;
+    pixels.resize(width * height * 3);
+
+    while (info.output_scanline < info.output_height)
+    {
+        JSAMPROW row = pixels.data() + info.output_scanline * width * 3;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    return true;
+}
+
+} // namespace
+
+std::vector<uint8_t> encode_rgb(const uint8_t* rgb, size_t width, size_t height, int quality)
+{
+    jpeg_compress_struct info;
+    ErrorManager error;
+    unsigned char* output = nullptr;
+    unsigned long outputSize = 0;
+
+    const auto success = compress(info, error, rgb, width, height, quality, &output, &outputSize);
+
+    std::vector<uint8_t> jpeg;
+    if (success)
+    {
+        jpeg.assign(output, output + outputSize);
+    }
+    std::free(output);
+
+    if (!success)
+    {
+        throw std::runtime_error(std::string("libjpeg: ") + error.message);
+    }
+    return jpeg;
+}
+
+std::vector<uint8_t> decode(const std::vector<uint8_t>& jpeg, size_t& width, size_t& height, J_COLOR_SPACE colorSpace)
+{
+    jpeg_decompress_struct info;
+    ErrorManager error;
+    std::vector<uint8_t> pixels;
+
+    if (!decompress(info, error, jpeg, colorSpace, pixels, width, height))
+    {
+        throw std::runtime_error(std::string("libjpeg: ") + error.message);
+    }
+    return pixels;
+}
@@ -33,9 +33,15 @@
 
 #include "chronometer.h"
 #include "mainwindow.h"
+#include "qimagelease.h"
 
 #include <QImage>
 
+#include <chrono>
+#include <sstream>
+
+
+const size_t AcquisitionWorker::DisplayImageCount;
 
 AcquisitionWorker::AcquisitionWorker(MainWindow* parent, DisplayWindow* displayWindow,
     std::shared_ptr<peak::core::DataStream> dataStream, peak::ipl::PixelFormatName pixelFormat,
@@ -66,6 +72,20 @@ AcquisitionWorker::AcquisitionWorker(MainWindow* parent, DisplayWindow* displayW
 
     m_customNodesAvailable = isNodeReadable("StreamIncompleteFrameCount")
         && isNodeReadable("StreamDroppedFrameCount") && isNodeReadable("StreamLostFrameCount");
+
+    m_payloadSize = static_cast<size_t>(m_dataStream->ParentDevice()
+                                            ->RemoteDevice()
+                                            ->NodeMaps()
+                                            .at(0)
+                                            ->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")
+                                            ->Value());
+
+    BufferTunerOptions tunerOptions;
+    tunerOptions.minimumBuffers = m_dataStream->NumBuffersAnnouncedMinRequired();
+    // Per camera, so MAX_NUMBER_OF_DEVICES cameras stay within 1.5 GB of buffers
+    tunerOptions.memoryBudget_bytes = size_t{ 512 } << 20;
+    tunerOptions.payloadSize = m_payloadSize;
+    m_bufferTuner = std::make_unique<BufferTuner>(tunerOptions);
 }
 
 void AcquisitionWorker::Start()
@@ -113,6 +133,11 @@ void AcquisitionWorker::Start()
     }
     }
 
+    // Allocate the display images once, the acquisition loop only recycles them. Lines are tightly packed, which is
+    // how the converter writes them.
+    const auto bytesPerLine = m_imageWidth * bytesPerPixel;
+    m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, bytesPerLine * m_imageHeight);
+
     // Pre-allocate images for conversion that can be used simultaneously
     // This is not mandatory but it can increase the speed of image conversions
     size_t imageCount = 1;
@@ -144,6 +169,10 @@ void AcquisitionWorker::Start()
     double frameTime_ms = 0;
     double conversionTime_ms = 0;
 
+    // Interval of the latency dump to the debug output
+    const auto latencyDumpInterval = std::chrono::seconds(10);
+    auto lastLatencyDump = std::chrono::steady_clock::now();
+
     m_running = true;
 
     while (m_running)
@@ -151,11 +180,26 @@ void AcquisitionWorker::Start()
         try
         {
             // Wait 5 seconds for an image from the camera
+            auto waitStart = std::chrono::steady_clock::now();
             auto buffer = m_dataStream->WaitForFinishedBuffer(5000);
+            m_latency.Record(LatencyStage::Wait, waitStart);
+
+            // The input pool depth at this point is what the camera had left while the frame was delivered
+            const auto streamCounters = BufferTuner::ReadSample(m_dataStream);
+            m_bufferTuner->Observe(streamCounters);
 
+            auto conversionStart = std::chrono::steady_clock::now();
             chronometerConversion.Start();
 
-            QImage qImage(static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight), qImageFormat);
+            // Take a display image from the pool. While the display window still holds all of them the frame is not
+            // displayed, the buffer goes straight back to the camera.
+            auto qImage = ToQImage(m_imagePool->TryAcquire(), static_cast<int>(m_imageWidth),
+                static_cast<int>(m_imageHeight), static_cast<int>(bytesPerLine), qImageFormat);
+            if (qImage.isNull())
+            {
+                m_dataStream->QueueBuffer(buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to output pixel format
 
@@ -168,12 +212,27 @@ void AcquisitionWorker::Start()
             //     outputPixelFormat, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
 
             conversionTime_ms = chronometerConversion.GetTimeSinceStart_ms();
+            m_latency.Record(LatencyStage::Convert, conversionStart);
 
             // Requeue buffer
-            m_dataStream->QueueBuffer(buffer);
+            {
+                LatencyRecorder::Scope timing(&m_latency, LatencyStage::Requeue);
+                m_dataStream->QueueBuffer(buffer);
+            }
 
             // Send signal to update the display
-            emit ImageReceived(qImage);
+            {
+                LatencyRecorder::Scope timing(&m_latency, LatencyStage::Display);
+                emit ImageReceived(qImage);
+            }
+
+            if (std::chrono::steady_clock::now() - lastLatencyDump >= latencyDumpInterval)
+            {
+                std::ostringstream dump;
+                m_latency.Dump(dump);
+                qDebug().noquote() << QString::fromStdString(dump.str()).trimmed();
+                lastLatencyDump = std::chrono::steady_clock::now();
+            }
 
             frameTime_ms = chronometerFrameTime.GetTimeSinceStart_ms();
             chronometerFrameTime.Start();
@@ -183,25 +242,15 @@ void AcquisitionWorker::Start()
             if (m_customNodesAvailable)
             {
                 // Missing packets on the interface, event after 1 resend
-                incomplete = static_cast<int>(
-                    m_dataStream->NodeMaps()
-                        .at(0)
-                        ->FindNode<peak::core::nodes::IntegerNode>("StreamIncompleteFrameCount")
-                        ->Value());
+                incomplete = static_cast<int>(streamCounters.incomplete);
 
                 // Camera buffer overrun (sensor data too fast for interface)
-                dropped = static_cast<int>(
-                    m_dataStream->NodeMaps()
-                        .at(0)
-                        ->FindNode<peak::core::nodes::IntegerNode>("StreamDroppedFrameCount")
-                        ->Value());
+                dropped = static_cast<int>(streamCounters.dropped);
 
                 // User buffer overrun (application too slow to process the camera data)
-                lost = static_cast<int>(m_dataStream->NodeMaps()
-                                            .at(0)
-                                            ->FindNode<peak::core::nodes::IntegerNode>("StreamLostFrameCount")
-                                            ->Value());
+                lost = static_cast<int>(streamCounters.lost);
             }
+
         }
         catch (const std::exception&)
         {
@@ -213,6 +262,34 @@ void AcquisitionWorker::Start()
 
         emit UpdateCounters(frameTime_ms, conversionTime_ms, m_frameCounter, m_errorCounter, incomplete, dropped, lost,
             m_customNodesAvailable);
+
+        // Between two frames no buffer is held, so the announced set may be resized
+        if (m_running && m_bufferTuner->WindowElapsed())
+        {
+            tuneBuffers();
+        }
+    }
+}
+
+void AcquisitionWorker::tuneBuffers()
+{
+    try
+    {
+        const auto decision = m_bufferTuner->Decide(m_dataStream->NumBuffersAnnounced());
+        if (decision.action != BufferTunerAction::Keep)
+        {
+            qDebug().noquote() << "Buffer tuning:" << QString::fromStdString(decision.reason);
+
+            BufferTuner::ApplyBufferCount(m_dataStream, decision.to, m_payloadSize);
+            m_bufferTuner->Restart();
+        }
+
+        emit BufferTuning(QString::fromStdString(decision.reason));
+    }
+    catch (const std::exception& e)
+    {
+        qDebug() << "Exception: " << e.what();
+        m_errorCounter++;
     }
 }
 
@@ -220,3 +297,8 @@ void AcquisitionWorker::Stop()
 {
     m_running = false;
 }
+
+const LatencyRecorder& AcquisitionWorker::Latency() const
+{
+    return m_latency;
+}
@@ -28,7 +28,10 @@
 #ifndef ACQUISITIONWORKER_H
 #define ACQUISITIONWORKER_H
 
+#include "buffertuner.h"
 #include "displaywindow.h"
+#include "imagepool.h"
+#include "latencyhistogram.h"
 
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
@@ -55,6 +58,9 @@ public:
 
     void Stop();
 
+    // Per-stage latencies (wait, convert, requeue, display) of all frames since construction
+    const LatencyRecorder& Latency() const;
+
 public slots:
     void Start();
 
@@ -76,10 +82,24 @@ private:
 
     std::unique_ptr<peak::ipl::ImageConverter> m_imageConverter;
 
+    LatencyRecorder m_latency;
+
+    // Number of display images: one being converted, one queued for the display, one shown and one spare
+    static const size_t DisplayImageCount = 4;
+    // Display images, recycled once the display window has released them
+    std::unique_ptr<ImagePool> m_imagePool;
+
+    // Sizes the announced buffer set from the loss counters, applied between two acquisitions
+    std::unique_ptr<BufferTuner> m_bufferTuner;
+    size_t m_payloadSize;
+
+    void tuneBuffers();
+
 signals:
     void ImageReceived(QImage image);
     void UpdateCounters(double frameTime_ms, double conversionTime_ms, unsigned int frameCounter,
         unsigned int errorCounter, int incomplete, int dropped, int lost, bool showCustomNodes);
+    void BufferTuning(QString decision);
 };
 
 #endif // ACQUISITIONWORKER_H
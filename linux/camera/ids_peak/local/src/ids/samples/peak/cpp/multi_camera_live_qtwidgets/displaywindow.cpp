@@ -61,9 +61,13 @@ DisplayWindow::DisplayWindow(QWidget* parent, int posX, int posY, int desiredHei
     // Create a label for the capture infos
     m_labelInfos = new QLabel();
 
-    // Add the graphics display and the label to the corresponding layout of the display window
+    // Create a label for the last decision of the buffer tuner
+    m_labelBuffers = new QLabel();
+
+    // Add the graphics display and the labels to the corresponding layout of the display window
     m_layout->addWidget(m_graphicsView);
     m_layout->addWidget(m_labelInfos);
+    m_layout->addWidget(m_labelBuffers);
 }
 
 
@@ -75,6 +79,12 @@ DisplayWindow::~DisplayWindow()
         m_labelInfos = nullptr;
     }
 
+    if (m_labelBuffers)
+    {
+        delete m_labelBuffers;
+        m_labelBuffers = nullptr;
+    }
+
     if (m_scene)
     {
         delete m_scene;
@@ -134,6 +144,12 @@ void DisplayWindow::UpdateCounters(double frameTime_ms, double conversionTime_ms
 }
 
 
+void DisplayWindow::UpdateBufferTuning(QString decision)
+{
+    m_labelBuffers->setText("Buffers: " + decision);
+}
+
+
 double DisplayWindow::AverageValue(double val1, double val2, double deviation)
 {
     double ret;
@@ -75,6 +75,7 @@ public:
 
 private:
     QLabel* m_labelInfos;
+    QLabel* m_labelBuffers;
     QVBoxLayout* m_layout;
 
     QGraphicsView* m_graphicsView;
@@ -89,6 +90,7 @@ public slots:
     void UpdateDisplay(QImage image);
     void UpdateCounters(double frameTime_ms, double conversionTime_ms, unsigned int frameCounter,
         unsigned int errorCounter, int incomplete, int dropped, int lost, bool showCustomNodes);
+    void UpdateBufferTuning(QString decision);
 };
 
 #endif // DISPLAY_WINDOW_H
@@ -104,6 +104,10 @@ MainWindow::MainWindow(QWidget* parent)
                 connect(deviceElem->acquisitionWorker, &AcquisitionWorker::UpdateCounters, deviceElem->displayWindow,
                     &DisplayWindow::UpdateCounters);
 
+                // Show the decisions of the buffer tuner of this camera
+                connect(deviceElem->acquisitionWorker, &AcquisitionWorker::BufferTuning, deviceElem->displayWindow,
+                    &DisplayWindow::UpdateBufferTuning);
+
                 // Call start function of m_acquisitionWorker when thread starts
                 connect(&deviceElem->acquisitionThread, &QThread::started, deviceElem->acquisitionWorker,
                     &AcquisitionWorker::Start);
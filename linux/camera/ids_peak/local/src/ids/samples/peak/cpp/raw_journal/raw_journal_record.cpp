@@ -0,0 +1,351 @@
+/*!
+ * \file    raw_journal_record.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application captures at the full frame rate of the camera
+ *          into a raw frame journal. Buffers are copied undebayered into
+ *          memory-mapped segment files, nothing is converted or encoded, so
+ *          what to keep and how to encode it can be decided afterwards with
+ *          raw_journal_tool.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <peak/peak.hpp>
+
+#include "bufferpool.h"
+#include "buffertuner.h"
+#include "framejournal.h"
+
+
+struct Options
+{
+    size_t device = 0;
+    std::string path = "journal";
+    uint64_t segmentSize_mb = 1024;
+    // 0 for no limit
+    uint32_t segments = 0;
+    // Stop after this many frames or seconds, 0 for no limit
+    uint64_t frames = 0;
+    uint64_t duration_s = 0;
+    // Longest stall of the disk the buffers have to bridge, sizes the buffer pool
+    double worstCaseStall_ms = 250.0;
+    bool hugePages = false;
+};
+
+namespace
+{
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int)
+{
+    stopRequested = 1;
+}
+
+} // namespace
+
+/*! \brief Parse Options function
+ *
+ * The function parses the command line. Unknown arguments are reported and
+ * the defaults are kept.
+ */
+Options parse_options(int argc, char* argv[]);
+
+/*! \brief Load UserSet Default function
+ *
+ * The function loads the UserSet Default, if the device supports it.
+ */
+void load_userset_default(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice);
+
+/*! \brief Close Device function
+ *
+ * The function stops the acquisition, revokes all buffers and unlocks the
+ * transport layer parameters.
+ */
+void close_device(std::shared_ptr<peak::core::DataStream> dataStream,
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice);
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"raw_journal_record\" v" << VERSION << std::endl;
+
+    const auto options = parse_options(argc, argv);
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // initialize peak library
+    peak::Library::Initialize();
+
+    std::shared_ptr<peak::core::DataStream> dataStream;
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice;
+    int exitCode = EXIT_SUCCESS;
+
+    try
+    {
+        auto& deviceManager = peak::DeviceManager::Instance();
+        deviceManager.Update();
+
+        if (deviceManager.Devices().size() <= options.device)
+        {
+            std::cout << "Device " << options.device << " not found. Exiting program." << std::endl;
+            peak::Library::Close();
+            return EXIT_FAILURE;
+        }
+
+        auto device = deviceManager.Devices().at(options.device)->OpenDevice(peak::core::DeviceAccessType::Control);
+        std::cout << "Opened device: " << device->DisplayName() << std::endl;
+
+        nodeMapRemoteDevice = device->RemoteDevice()->NodeMaps().at(0);
+        dataStream = device->DataStreams().at(0)->OpenDataStream();
+
+        load_userset_default(nodeMapRemoteDevice);
+
+        // Free run at the frame rate of the user set
+        try
+        {
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("TriggerMode")->SetCurrentEntry("Off");
+        }
+        catch (const std::exception&)
+        {
+            // TriggerMode is not available, the camera free runs anyway
+        }
+
+        FrameJournalOptions journalOptions;
+        journalOptions.directory = options.path;
+        journalOptions.segmentSize_bytes = options.segmentSize_mb << 20;
+        journalOptions.maximumSegments = options.segments;
+        FrameJournalWriter journal(journalOptions);
+
+        // Enough buffers to keep the camera supplied while the page cache is flushed to a slow disk
+        const auto payloadSize = static_cast<size_t>(
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")->Value());
+        const auto bufferCountMin = dataStream->NumBuffersAnnouncedMinRequired();
+        auto bufferCount = bufferCountMin + 4;
+        try
+        {
+            const auto frameRate =
+                nodeMapRemoteDevice->FindNode<peak::core::nodes::FloatNode>("AcquisitionFrameRate")->Value();
+            bufferCount = std::max(bufferCount,
+                BufferPool::BufferCount(frameRate, options.worstCaseStall_ms, bufferCountMin));
+            std::cout << "Recording at " << frameRate << " fps" << std::endl;
+        }
+        catch (const std::exception&)
+        {
+            // AcquisitionFrameRate is not available
+        }
+
+        BufferPoolOptions poolOptions;
+        poolOptions.hugePages = options.hugePages;
+        BufferPool bufferPool(dataStream, poolOptions);
+        bufferPool.Announce(bufferCount, payloadSize);
+        bufferPool.QueueAll();
+        std::cout << "Announced " << bufferCount << " buffer(s) of " << payloadSize / 1024 << " kB, journaling to "
+                  << options.path << std::endl;
+
+        // Lock critical features to prevent them from changing during acquisition
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(1);
+
+        dataStream->StartAcquisition();
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->Execute();
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->WaitUntilDone();
+
+        const auto start = std::chrono::steady_clock::now();
+        auto lastReport = start;
+        uint64_t lastFrames = 0;
+        uint64_t lastBytes = 0;
+
+        while (!stopRequested)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (options.duration_s > 0 && now - start >= std::chrono::seconds(options.duration_s))
+            {
+                break;
+            }
+
+            std::shared_ptr<peak::core::Buffer> buffer;
+            try
+            {
+                // The timeout only bounds the reaction time to a stop request
+                buffer = dataStream->WaitForFinishedBuffer(500);
+            }
+            catch (const peak::core::TimeoutException&)
+            {
+                continue;
+            }
+
+            const bool journaled = journal.Append(buffer);
+            dataStream->QueueBuffer(buffer);
+
+            const auto counters = journal.Counters();
+            if (!journaled && options.segments > 0 && counters.segments >= options.segments)
+            {
+                std::cout << "Journal is full" << std::endl;
+                break;
+            }
+
+            if (options.frames > 0 && counters.frames >= options.frames)
+            {
+                break;
+            }
+
+            if (now - lastReport >= std::chrono::seconds(1))
+            {
+                const auto seconds = std::chrono::duration<double>(now - lastReport).count();
+                const auto stream = BufferTuner::ReadSample(dataStream);
+                std::cout << std::fixed << std::setprecision(1) << "frames: " << counters.frames << ", "
+                          << (counters.frames - lastFrames) / seconds << " fps, "
+                          << (counters.bytes - lastBytes) / seconds / (1 << 20) << " MB/s, segments: "
+                          << counters.segments << ", rejected: " << counters.rejected << ", lost: " << stream.lost
+                          << ", dropped: " << stream.dropped << ", incomplete: " << stream.incomplete << std::endl;
+
+                lastReport = now;
+                lastFrames = counters.frames;
+                lastBytes = counters.bytes;
+            }
+        }
+
+        const auto counters = journal.Counters();
+        std::cout << "Journaled " << counters.frames << " frame(s), " << counters.bytes / (1 << 20) << " MB in "
+                  << counters.segments << " segment(s), " << counters.rejected << " rejected" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        exitCode = EXIT_FAILURE;
+    }
+
+    close_device(dataStream, nodeMapRemoteDevice);
+
+    // close peak library
+    peak::Library::Close();
+    return exitCode;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = (i + 1) < argc;
+
+        if (argument == "--device" && hasValue)
+        {
+            options.device = std::stoul(argv[++i]);
+        }
+        else if (argument == "--path" && hasValue)
+        {
+            options.path = argv[++i];
+        }
+        else if (argument == "--segment-mb" && hasValue)
+        {
+            options.segmentSize_mb = std::stoull(argv[++i]);
+        }
+        else if (argument == "--segments" && hasValue)
+        {
+            options.segments = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (argument == "--frames" && hasValue)
+        {
+            options.frames = std::stoull(argv[++i]);
+        }
+        else if (argument == "--duration" && hasValue)
+        {
+            options.duration_s = std::stoull(argv[++i]);
+        }
+        else if (argument == "--worst-case-ms" && hasValue)
+        {
+            options.worstCaseStall_ms = std::stod(argv[++i]);
+        }
+        else if (argument == "--hugepages")
+        {
+            options.hugePages = true;
+        }
+        else
+        {
+            std::cout << "Ignoring unknown argument: " << argument << std::endl;
+        }
+    }
+
+    return options;
+}
+
+void load_userset_default(std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice)
+{
+    try
+    {
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::EnumerationNode>("UserSetSelector")
+            ->SetCurrentEntry("Default");
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("UserSetLoad")->Execute();
+        nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("UserSetLoad")->WaitUntilDone();
+    }
+    catch (const peak::core::NotFoundException&)
+    {
+        // UserSet is not available
+    }
+}
+
+void close_device(std::shared_ptr<peak::core::DataStream> dataStream,
+    std::shared_ptr<peak::core::NodeMap> nodeMapRemoteDevice)
+{
+    if (nodeMapRemoteDevice)
+    {
+        try
+        {
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->Execute();
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    if (dataStream)
+    {
+        try
+        {
+            dataStream->KillWait();
+            dataStream->StopAcquisition(peak::core::AcquisitionStopMode::Default);
+            dataStream->Flush(peak::core::DataStreamFlushMode::DiscardAll);
+
+            for (const auto& buffer : dataStream->AnnouncedBuffers())
+            {
+                dataStream->RevokeBuffer(buffer);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+
+    if (nodeMapRemoteDevice)
+    {
+        try
+        {
+            // Unlock parameters after acquisition stop
+            nodeMapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(0);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "EXCEPTION: " << e.what() << std::endl;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/*!
+ * \file    raw_journal_tool.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   This application inspects a raw frame journal written by
+ *          raw_journal_record and converts selected frames to image files.
+ *
+ *          raw_journal_tool list DIR
+ *          raw_journal_tool stats DIR
+ *          raw_journal_tool export DIR FRAME_ID|all OUTPUT
+ *
+ *          The type of OUTPUT is taken from its extension (.jpg, .png, .bmp
+ *          or .raw for the frame as recorded). With "all", the FrameID is
+ *          appended to the file name of OUTPUT for every frame.
+ *
+ * \version 1.0.0
+ */
+
+#define VERSION "1.0.0"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <peak_ipl/peak_ipl.hpp>
+
+#include "framejournal.h"
+
+
+namespace
+{
+
+void printUsage()
+{
+    std::cout << "Usage: raw_journal_tool list DIR" << std::endl
+              << "       raw_journal_tool stats DIR" << std::endl
+              << "       raw_journal_tool export DIR FRAME_ID|all OUTPUT" << std::endl;
+}
+
+void list(FrameJournalReader& journal)
+{
+    std::cout << "frame_id device_ts_ns host_ts_ns width height pixel_format segment offset bytes flags" << std::endl;
+
+    for (const auto& entry : journal.Entries())
+    {
+        std::cout << entry.frameId << " " << entry.deviceTimestamp_ns << " " << entry.hostTimestamp_ns << " "
+                  << entry.width << " " << entry.height << " 0x" << std::hex << entry.pixelFormat << std::dec << " "
+                  << entry.segment << " " << entry.offset << " " << entry.payloadSize << " " << entry.flags
+                  << std::endl;
+    }
+}
+
+void stats(FrameJournalReader& journal)
+{
+    const auto& entries = journal.Entries();
+    if (entries.empty())
+    {
+        std::cout << "The journal is empty" << std::endl;
+        return;
+    }
+
+    uint64_t bytes = 0;
+    uint64_t incomplete = 0;
+    uint64_t gaps = 0;
+    uint64_t missingFrames = 0;
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        bytes += entries[i].payloadSize;
+        if (entries[i].flags & FrameJournalIncomplete)
+        {
+            ++incomplete;
+        }
+
+        // A FrameID that does not follow its predecessor means the frames in between were not journaled
+        if (i > 0 && entries[i].frameId > entries[i - 1].frameId + 1)
+        {
+            ++gaps;
+            missingFrames += entries[i].frameId - entries[i - 1].frameId - 1;
+        }
+    }
+
+    const auto span_ns = entries.back().deviceTimestamp_ns - entries.front().deviceTimestamp_ns;
+    const auto span_s = span_ns / 1e9;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "frames:         " << entries.size() << std::endl;
+    std::cout << "frame ids:      " << entries.front().frameId << " - " << entries.back().frameId << std::endl;
+    std::cout << "segments:       " << entries.back().segment << std::endl;
+    std::cout << "payload:        " << bytes / (1 << 20) << " MB" << std::endl;
+    std::cout << "span:           " << span_s << " s" << std::endl;
+    if (span_s > 0)
+    {
+        std::cout << "frame rate:     " << (entries.size() - 1) / span_s << " fps" << std::endl;
+    }
+    std::cout << "gaps:           " << gaps << " (" << missingFrames << " frames)" << std::endl;
+    std::cout << "incomplete:     " << incomplete << std::endl;
+}
+
+std::string extensionOf(const std::string& path)
+{
+    const auto dot = path.find_last_of('.');
+    const auto slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return "";
+    }
+
+    return path.substr(dot);
+}
+
+void exportFrame(FrameJournalReader& journal, const FrameJournalEntry& entry, const std::string& output)
+{
+    const auto image = journal.Image(entry);
+
+    if (extensionOf(output) == ".raw")
+    {
+        peak::ipl::ImageWriter::WriteAsRAW(output, image);
+    }
+    else
+    {
+        // Debayer only now, the journal holds the frame as the camera delivered it
+        peak::ipl::ImageConverter converter;
+        peak::ipl::ImageWriter::Write(output, converter.Convert(image, peak::ipl::PixelFormatName::RGB8));
+    }
+
+    std::cout << entry.frameId << " -> " << output << std::endl;
+}
+
+int exportFrames(FrameJournalReader& journal, const std::string& frame, const std::string& output)
+{
+    const auto& entries = journal.Entries();
+
+    if (frame != "all")
+    {
+        const auto index = journal.Find(std::stoull(frame));
+        if (index == entries.size())
+        {
+            std::cout << "FrameID " << frame << " is not in the journal" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        exportFrame(journal, entries[index], output);
+        return EXIT_SUCCESS;
+    }
+
+    // Frames are sorted by segment, so every segment is mapped once
+    const auto extension = extensionOf(output);
+    const auto stem = output.substr(0, output.size() - extension.size());
+    for (const auto& entry : entries)
+    {
+        exportFrame(journal, entry, stem + "_" + std::to_string(entry.frameId) + extension);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "aCCumen Junior \"raw_journal_tool\" v" << VERSION << std::endl;
+
+    if (argc < 3)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string command = argv[1];
+
+    try
+    {
+        FrameJournalReader journal(argv[2]);
+
+        if (command == "list")
+        {
+            list(journal);
+        }
+        else if (command == "stats")
+        {
+            stats(journal);
+        }
+        else if (command == "export" && argc == 5)
+        {
+            return exportFrames(journal, argv[3], argv[4]);
+        }
+        else
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "EXCEPTION: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
  */
 
 #include "acquisitionworker.h"
+#include "qimagelease.h"
 
 #include <peak_ipl/peak_ipl.hpp>
 
@@ -33,17 +34,16 @@
 
 #include <QDebug>
 
+#include <chrono>
 #include <cmath>
 #include <cstring>
 
 
+const size_t AcquisitionWorker::DisplayImageCount;
+
 AcquisitionWorker::AcquisitionWorker(QObject* parent)
     : QObject(parent)
 {
-    m_running = false;
-    m_frameCounter = 0;
-    m_errorCounter = 0;
-
     m_imageConverter = std::make_unique<peak::ipl::ImageConverter>();
 }
 
@@ -58,6 +58,9 @@ void AcquisitionWorker::Start()
         m_imageWidth = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Width")->Value();
         m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
 
+        // Allocate the display images once, the conversion loop only recycles them
+        m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, m_imageWidth * m_imageHeight * 4);
+
         // Pre-allocate images for conversion that can be used simultaneously
         // This is not mandatory but it can increase the speed of image conversions
         size_t imageCount = 1;
@@ -81,6 +84,9 @@ void AcquisitionWorker::Start()
 
     m_running = true;
 
+    // Conversion runs in its own thread, so this loop only waits for buffers and hands them off
+    m_conversionThread = std::thread(&AcquisitionWorker::ConvertFrames, this);
+
     while (m_running)
     {
         try
@@ -88,20 +94,74 @@ void AcquisitionWorker::Start()
             // Get buffer from device's datastream
             const auto buffer = m_dataStream->WaitForFinishedBuffer(5000);
 
-            QImage qImage(m_imageWidth, m_imageHeight, QImage::Format_RGB32);
+            if (!m_frameRing.TryPush(Frame::FromBuffer(buffer)))
+            {
+                // The conversion thread is behind. Requeue the buffer right away instead of starving the camera,
+                // the frame is counted as dropped by the ring.
+                m_dataStream->QueueBuffer(buffer);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            m_errorCounter++;
+
+            qDebug() << "Exception: " << e.what();
+
+            // Send signal with current frame and error counter
+            emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
+        }
+    }
+
+    m_frameRing.WakeConsumer();
+    m_conversionThread.join();
+
+    // Frames the conversion thread did not get to go back to the data stream, so the next Start() has every buffer
+    m_frameRing.Drain([this](Frame& frame) {
+        try
+        {
+            m_dataStream->QueueBuffer(frame.buffer);
+        }
+        catch (const std::exception& e)
+        {
+            qDebug() << "Exception: " << e.what();
+        }
+    });
+}
+
+void AcquisitionWorker::ConvertFrames()
+{
+    while (m_running)
+    {
+        Frame frame;
+        if (!m_frameRing.Pop(frame, std::chrono::milliseconds(100)))
+        {
+            continue;
+        }
+
+        try
+        {
+            // Take a display image from the pool. While the display still holds all of them this thread waits and the
+            // frame ring absorbs, and eventually drops, the frames in the meantime.
+            auto qImage = ToQImage(m_imagePool->Acquire(std::chrono::milliseconds(100)), static_cast<int>(m_imageWidth),
+                static_cast<int>(m_imageHeight), static_cast<int>(m_imageWidth * 4), QImage::Format_RGB32);
+            if (qImage.isNull())
+            {
+                m_dataStream->QueueBuffer(frame.buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to RGBa8 format
 
             // Using the image converter ...
-            m_imageConverter->Convert(peak::BufferTo<peak::ipl::Image>(buffer),
+            m_imageConverter->Convert(peak::BufferTo<peak::ipl::Image>(frame.buffer),
                 peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
 
             // ... or without image converter
-            // peak::BufferTo<peak::ipl::Image>(buffer).ConvertTo(
+            // peak::BufferTo<peak::ipl::Image>(frame.buffer).ConvertTo(
             //     peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
 
             // Queue buffer so that it can be used again
-            m_dataStream->QueueBuffer(buffer);
+            m_dataStream->QueueBuffer(frame.buffer);
 
             // Emit signal that the image is ready to be displayed
             emit imageReceived(qImage);
@@ -115,8 +175,8 @@ void AcquisitionWorker::Start()
             qDebug() << "Exception: " << e.what();
         }
 
-        // Send signal with current frame and error counter
-        emit counterChanged(m_frameCounter, m_errorCounter);
+        // Send signal with current frame, error and dropped counter
+        emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
     }
 }
 
@@ -28,12 +28,18 @@
 #ifndef ACQUISITIONWORKER_H
 #define ACQUISITIONWORKER_H
 
+#include "framering.h"
+#include "imagepool.h"
+
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
 
 #include <QImage>
 #include <QObject>
 
+#include <atomic>
+#include <thread>
+
 
 class AcquisitionWorker : public QObject
 {
@@ -47,23 +53,39 @@ public:
     void Stop();
     void SetDataStream(std::shared_ptr<peak::core::DataStream> dataStream);
 
+    // Number of finished buffers that may wait for conversion. These buffers are announced in addition to
+    // NumBuffersAnnouncedMinRequired(), so the camera is not starved while frames wait in the ring.
+    static const size_t FrameRingCapacity = 4;
+
+    // Number of display images: one being converted, one queued for the display, one shown and one spare
+    static const size_t DisplayImageCount = 4;
+
 private:
+    void ConvertFrames();
+
     std::shared_ptr<peak::core::DataStream> m_dataStream;
     std::shared_ptr<peak::core::NodeMap> m_nodemapRemoteDevice;
 
-    bool m_running = false;
+    std::atomic<bool> m_running{ false };
 
-    unsigned int m_frameCounter = 0;
-    unsigned int m_errorCounter = 0;
+    std::atomic<unsigned int> m_frameCounter{ 0 };
+    std::atomic<unsigned int> m_errorCounter{ 0 };
 
     size_t m_imageWidth = 0;
     size_t m_imageHeight = 0;
 
     std::unique_ptr<peak::ipl::ImageConverter> m_imageConverter;
 
+    // Hands finished buffers from the acquisition loop to the conversion thread
+    FrameRing<> m_frameRing{ FrameRingCapacity };
+    std::thread m_conversionThread;
+
+    // Display images, recycled once the display has released them
+    std::unique_ptr<ImagePool> m_imagePool;
+
 signals:
     void imageReceived(QImage image);
-    void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void counterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
 };
 
 #endif // ACQUISITIONWORKER_H
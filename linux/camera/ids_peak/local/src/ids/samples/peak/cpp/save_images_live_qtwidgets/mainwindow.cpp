@@ -37,8 +37,12 @@
 #include <QThread>
 #include <QWidget>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #define VERSION "1.1.1"
 
@@ -65,6 +69,15 @@ MainWindow::MainWindow(QWidget* parent)
     m_buttonSave = new QPushButton("Press to Save Current Image", this);
     connect(m_buttonSave, SIGNAL(clicked()), this, SLOT(SaveImage()), Qt::UniqueConnection);
 
+    // Images are written by a writer thread. Several files are synced together before they appear under their
+    // final name, the result is reported back to the GUI thread.
+    WriteBehindOptions writeOptions;
+    writeOptions.syncBatch = 4;
+    m_writeQueue = std::make_unique<WriteBehindQueue>(writeOptions);
+    m_writeQueue->SetLatencyRecorder(&m_writeLatency);
+    m_writeQueue->Start();
+    connect(this, &MainWindow::imageSaved, this, &MainWindow::onImageSaved, Qt::QueuedConnection);
+
     // initialize peak library
     peak::Library::Initialize();
 
@@ -119,6 +132,12 @@ MainWindow::~MainWindow()
 
 void MainWindow::DestroyAll()
 {
+    // Finish the images still being saved
+    if (m_writeQueue)
+    {
+        m_writeQueue->Stop();
+    }
+
     if (m_acquisitionWorker)
     {
         m_acquisitionWorker->Stop();
@@ -246,8 +265,8 @@ bool MainWindow::OpenDevice()
             // Get the payload size for correct buffer allocation
             auto payloadSize = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")->Value();
 
-            // Get the minimum number of buffers that must be announced
-            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired();
+            // Get the minimum number of buffers that must be announced, plus the buffers that may wait for conversion
+            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired() + AcquisitionWorker::FrameRingCapacity;
 
             // Allocate and announce image buffers and queue them
             for (size_t bufferCount = 0; bufferCount < bufferCountMax; ++bufferCount)
@@ -385,8 +404,9 @@ void MainWindow::UpdateAllControlPositionsAndSizes()
 
     if (m_labelInfo)
     {
+        // Whatever the controls on the right leave free, the counters include the save queue
         m_labelInfo->move(10, this->height() - 22);
-        m_labelInfo->setFixedSize(200, 24);
+        m_labelInfo->setFixedSize(std::max(200, this->width() - 500), 24);
     }
 
     if (m_labelVersion)
@@ -453,41 +473,66 @@ void MainWindow::SaveImage()
     auto stdfilename = selectSaveFileWithDialog();
     // Check if we did not get an empty filename
 
-    if (!stdfilename.empty())
+    if (stdfilename.empty())
     {
-        /*Write the file to disc. The format is chosen hereby from the filename
-        Alternatively one can use e.g. WriteAsPNG to write it as PNG file but it requires the file ending to be png
-        otherwise it will return an error. Using a specific function like WriteAsPNG one can specify Parameters e.g.
-        compression/quality.
-        */
+        return;
+    }
+
+    /*Write the file to disc. The format is chosen hereby from the filename
+    Alternatively one can use e.g. WriteAsPNG to write it as PNG file but it requires the file ending to be png
+    otherwise it will return an error. Using a specific function like WriteAsPNG one can specify Parameters e.g.
+    compression/quality.
+    The file is written by the writer thread of the write queue, the live view keeps running meanwhile.
+    */
+    WriteBehindJob job;
+    job.path = stdfilename;
+    job.writeFile = [newImage](const std::string& path) {
         try
         {
-            peak::ipl::ImageWriter::Write(stdfilename, newImage);
+            peak::ipl::ImageWriter::Write(path, newImage);
         }
-        // Saving images may emit different exceptions e.g. if the application does not have the permissions to write
-        // into a specific Folder an IO Exception will be thrown
+        // Saving images may emit different exceptions e.g. if the application does not have the permissions to
+        // write into a specific Folder an IO Exception will be thrown
         catch (const peak::ipl::ImageFormatNotSupportedException&)
         {
-            QMessageBox::critical(this, QString("Error"),
-                QString("Image format can not be written to selected File type. Try another. "), QMessageBox::Ok);
+            throw std::runtime_error("Image format can not be written to selected File type. Try another. ");
         }
         catch (const peak::ipl::IOException& e)
         {
-            QMessageBox::critical(
-                this, QString("Error"), QString("File IO Error: \n") + QString(e.what()), QMessageBox::Ok);
+            throw std::runtime_error(std::string("File IO Error: \n") + e.what());
         }
         catch (const peak::ipl::Exception& e)
         {
-            QMessageBox::critical(
-                this, QString("Error"), QString("Internal processing Error: \n") + QString(e.what()), QMessageBox::Ok);
+            throw std::runtime_error(std::string("Internal processing Error: \n") + e.what());
         }
+    };
+    job.done = [this](const WriteBehindResult& result) {
+        emit imageSaved(QString::fromStdString(result.path), QString::fromStdString(result.error));
+    };
+
+    if (!m_writeQueue->Submit(std::move(job)))
+    {
+        QMessageBox::warning(this, QString("Error"),
+            QString("Too many images are still being saved. Try again later."), QMessageBox::Ok);
+    }
+}
+
+void MainWindow::onImageSaved(const QString& path, const QString& error)
+{
+    if (!error.isEmpty())
+    {
+        QMessageBox::critical(
+            this, QString("Error"), QString("Failed to save ") + path + QString(":\n") + error, QMessageBox::Ok);
     }
 }
 
-void MainWindow::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter)
+void MainWindow::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter)
 {
-    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2")
-            .arg(QString::number(frameCounter), QString::number(errorCounter)));
+    const auto saves = m_writeQueue->Counters();
+    const auto writeLatency = m_writeLatency.Summary(LatencyStage::Write);
+    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2, dropped: %3, saving: %4, save p99: %5 ms")
+            .arg(QString::number(frameCounter), QString::number(errorCounter), QString::number(droppedCounter),
+                QString::number(saves.depth), QString::number(writeLatency.p99_us / 1000.0, 'f', 1)));
 }
 
 void MainWindow::on_aboutQt_linkActivated(const QString& link)
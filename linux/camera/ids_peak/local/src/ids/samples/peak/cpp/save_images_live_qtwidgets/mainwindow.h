@@ -26,6 +26,8 @@
 
 #include "acquisitionworker.h"
 #include "display.h"
+#include "latencyhistogram.h"
+#include "writebehind.h"
 
 #include <peak_ipl/peak_ipl.hpp>
 
@@ -41,6 +43,7 @@
 
 
 #include <cstdint>
+#include <memory>
 
 
 class MainWindow : public QMainWindow
@@ -67,6 +70,11 @@ private:
 
     std::mutex m_writeMutex;
 
+    // Saves images on a writer thread, so a slow disk never freezes the live view. Declared after the latency
+    // recorder it records into.
+    LatencyRecorder m_writeLatency;
+    std::unique_ptr<WriteBehindQueue> m_writeQueue;
+
     void DestroyAll();
 
     bool OpenDevice();
@@ -78,9 +86,14 @@ private:
 
     std::string selectSaveFileWithDialog();
 
+signals:
+    // Emitted from the writer thread when a save is finished, \p error is empty on success
+    void imageSaved(const QString& path, const QString& error);
+
 public slots:
     void SaveImage();
-    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void onImageSaved(const QString& path, const QString& error);
+    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void on_aboutQt_linkActivated(const QString& link);
 };
 
@@ -26,6 +26,7 @@
  */
 
 #include "acquisitionworker.h"
+#include "qimagelease.h"
 
 #include <peak_ipl/peak_ipl.hpp>
 #include <peak/converters/peak_buffer_converter_ipl.hpp>
@@ -35,6 +36,8 @@
 #include <cmath>
 #include <cstring>
 
+const size_t AcquisitionWorker::DisplayImageCount;
+
 AcquisitionWorker::AcquisitionWorker(QObject* parent)
     : QObject(parent)
 {
@@ -56,6 +59,9 @@ void AcquisitionWorker::Start()
         m_imageWidth = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Width")->Value();
         m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
 
+        // Allocate the display images once, the acquisition loop only recycles them
+        m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, m_imageWidth * m_imageHeight * 4);
+
         // Start acquisition
         m_dataStream->StartAcquisition();
         m_nodemapRemoteDevice->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->Execute();
@@ -76,7 +82,15 @@ void AcquisitionWorker::Start()
             // Get buffer from device's datastream
             const auto buffer = m_dataStream->WaitForFinishedBuffer(5000);
 
-            QImage qImage(static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight), QImage::Format_RGB32);
+            // Take a display image from the pool. While the display still holds all of them the frame is not displayed,
+            // the buffer goes straight back to the camera.
+            auto qImage = ToQImage(m_imagePool->TryAcquire(), static_cast<int>(m_imageWidth),
+                static_cast<int>(m_imageHeight), static_cast<int>(m_imageWidth * 4), QImage::Format_RGB32);
+            if (qImage.isNull())
+            {
+                m_dataStream->QueueBuffer(buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to RGBa8 format
 
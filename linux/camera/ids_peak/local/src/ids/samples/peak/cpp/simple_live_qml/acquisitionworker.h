@@ -28,6 +28,8 @@
 #ifndef ACQUISITIONWORKER_H
 #define ACQUISITIONWORKER_H
 
+#include "imagepool.h"
+
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
 
@@ -61,6 +63,11 @@ private:
 
     std::unique_ptr<peak::ipl::ImageConverter> m_imageConverter;
 
+    // Number of display images: one being converted, one queued for the display, one shown and one spare
+    static const size_t DisplayImageCount = 4;
+    // Display images, recycled once the display has released them
+    std::unique_ptr<ImagePool> m_imagePool;
+
 signals:
     void imageReceived(QImage image);
     void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
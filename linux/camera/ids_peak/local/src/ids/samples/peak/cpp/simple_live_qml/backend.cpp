@@ -25,6 +25,8 @@
 
 #include "imageitem.h"
 
+#include <utility>
+
 #define VERSION "1.2.0"
 
 
@@ -42,11 +44,13 @@ BackEnd::BackEnd(QObject* parent)
     connect(&m_acquisitionThread, &QThread::started, m_acquisitionWorker, &AcquisitionWorker::Start);
     connect(&m_acquisitionThread, &QThread::finished, m_acquisitionWorker, &QObject::deleteLater);
 
-    // connect the worker new image signal with the corresponding backend signal
-    connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, this, &BackEnd::imageReceived);
+    // connect the worker new image signal with the mailbox of the backend. The image is handed over directly instead of
+    // queueing one event per frame, so a busy GUI thread skips to the newest image.
+    connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, this, &BackEnd::onImageReceived,
+        Qt::DirectConnection);
 
-    // Connect the worker counter updated signal with with the corresponding backend signal
-    connect(m_acquisitionWorker, &AcquisitionWorker::counterChanged, this, &BackEnd::counterChanged);
+    // Connect the worker counter updated signal with with the corresponding backend slot
+    connect(m_acquisitionWorker, &AcquisitionWorker::counterChanged, this, &BackEnd::onCounterChanged);
 
     // Connect the signal from the acquisition worker when an exception was thrown and a message should be printed
     // with the messagebox trigger slot in the BackEnd class
@@ -234,3 +238,26 @@ QString BackEnd::QtVersion() const
 {
     return qVersion();
 }
+
+void BackEnd::onImageReceived(QImage image)
+{
+    // Only the image that fills the empty mailbox queues an event, later ones replace it until it is shown
+    if (m_mailbox.Post(std::move(image)))
+    {
+        QMetaObject::invokeMethod(this, "deliverLatestImage", Qt::QueuedConnection);
+    }
+}
+
+void BackEnd::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter)
+{
+    emit counterChanged(frameCounter, errorCounter, static_cast<unsigned int>(m_mailbox.Counters().coalesced));
+}
+
+void BackEnd::deliverLatestImage()
+{
+    QImage image;
+    if (m_mailbox.Take(image))
+    {
+        emit imageReceived(image);
+    }
+}
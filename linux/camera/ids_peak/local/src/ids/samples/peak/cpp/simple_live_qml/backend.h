@@ -25,6 +25,7 @@
 #define BACKEND_H
 
 #include "acquisitionworker.h"
+#include "framemailbox.h"
 
 #include <peak/peak.hpp>
 
@@ -51,7 +52,8 @@ public:
 signals:
     void acquisitionStarted();
     void imageReceived(QImage image);
-    void counterChanged(const unsigned int frameCounter, const unsigned int errorCounter);
+    void counterChanged(const unsigned int frameCounter, const unsigned int errorCounter,
+        const unsigned int coalescedCounter);
     void messageBoxTrigger(QString messageTitle, QString messageText, bool critical);
 
 private:
@@ -61,6 +63,16 @@ private:
 
     AcquisitionWorker* m_acquisitionWorker;
     QThread m_acquisitionThread;
+
+    // Only the newest image waits for the GUI thread, however long it is busy
+    FrameMailbox<QImage> m_mailbox;
+
+private slots:
+    // Called directly in the acquisition thread
+    void onImageReceived(QImage image);
+    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    // Called in the GUI thread, passes the newest image on to QML
+    void deliverLatestImage();
 };
 
 #endif // BACKEND_H
@@ -45,7 +45,7 @@ Window {
             cameraLiveImage.setImage(image)
         }
         onCounterChanged: {
-            counterText.text = "Acquired: " + frameCounter + ", errors: " + errorCounter
+            counterText.text = "Acquired: " + frameCounter + ", errors: " + errorCounter + ", not displayed: " + coalescedCounter
         }
         onMessageBoxTrigger: {
             if(critical)
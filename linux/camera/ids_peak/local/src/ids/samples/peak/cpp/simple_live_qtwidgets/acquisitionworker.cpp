@@ -26,23 +26,24 @@
  */
 
 #include "acquisitionworker.h"
+#include "qimagelease.h"
 
 #include <peak/converters/peak_buffer_converter_ipl.hpp>
 
 #include <QDebug>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <memory>
 
 
+const size_t AcquisitionWorker::DisplayImageCount;
+
 AcquisitionWorker::AcquisitionWorker(QObject* parent)
     : QObject(parent)
 {
-    m_running = false;
-    m_frameCounter = 0;
-    m_errorCounter = 0;
-
     m_imageConverter = std::make_unique<peak::ipl::ImageConverter>();
 }
 
@@ -57,6 +58,9 @@ void AcquisitionWorker::Start()
         m_imageWidth = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Width")->Value();
         m_imageHeight = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("Height")->Value();
 
+        // Allocate the display images once, the conversion loop only recycles them
+        m_imagePool = std::make_unique<ImagePool>(DisplayImageCount, m_imageWidth * m_imageHeight * 4);
+
         // Pre-allocate images for conversion that can be used simultaneously
         // This is not mandatory but it can increase the speed of image conversions
         size_t imageCount = 1;
@@ -80,6 +84,9 @@ void AcquisitionWorker::Start()
 
     m_running = true;
 
+    // Conversion runs in its own thread, so this loop only waits for buffers and hands them off
+    m_conversionThread = std::thread(&AcquisitionWorker::ConvertFrames, this);
+
     while (m_running)
     {
         try
@@ -87,23 +94,104 @@ void AcquisitionWorker::Start()
             // Get buffer from device's datastream
             const auto buffer = m_dataStream->WaitForFinishedBuffer(5000);
 
-            QImage qImage(static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight), QImage::Format_RGB32);
+            if (!m_frameRing.TryPush(Frame::FromBuffer(buffer)))
+            {
+                // The conversion thread is behind. Requeue the buffer right away instead of starving the camera,
+                // the frame is counted as dropped by the ring.
+                m_dataStream->QueueBuffer(buffer);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            m_errorCounter++;
+
+            qDebug() << "Exception: " << e.what();
+
+            // Send signal with current frame and error counter
+            emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
+        }
+    }
+
+    m_frameRing.WakeConsumer();
+    m_conversionThread.join();
+
+    // Frames the conversion thread did not get to go back to the data stream, so the next Start() has every buffer
+    m_frameRing.Drain([this](Frame& frame) {
+        try
+        {
+            m_dataStream->QueueBuffer(frame.buffer);
+        }
+        catch (const std::exception& e)
+        {
+            qDebug() << "Exception: " << e.what();
+        }
+    });
+}
+
+void AcquisitionWorker::ConvertFrames()
+{
+    while (m_running)
+    {
+        Frame frame;
+        if (!m_frameRing.Pop(frame, std::chrono::milliseconds(100)))
+        {
+            continue;
+        }
+
+        try
+        {
+            // Take a display image from the pool. While the display still holds all of them this thread waits and the
+            // frame ring absorbs, and eventually drops, the frames in the meantime.
+            auto lease = m_imagePool->Acquire(std::chrono::milliseconds(100));
+            if (!lease)
+            {
+                m_dataStream->QueueBuffer(frame.buffer);
+                continue;
+            }
 
             // Create IDS peak IPL image for debayering and convert it to RGBa8 format
+            const auto image = peak::BufferTo<peak::ipl::Image>(frame.buffer);
+            const auto conversion = PlanConversion(image);
+
+            QImage qImage;
+            if (conversion.debayer)
+            {
+                // Debayer only the visible part of the sensor, downscaled in the same pass if the display is smaller.
+                // The pool images have the full size, so any part fits.
+                qImage = ToQImage(std::move(lease), conversion.size.width(), conversion.size.height(),
+                    conversion.size.width() * 4, QImage::Format_RGB32);
 
-            // Using the image converter ...
-            m_imageConverter->Convert(peak::BufferTo<peak::ipl::Image>(buffer),
-                peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
+                Debayer::Region region;
+                region.x = static_cast<size_t>(conversion.region.x());
+                region.y = static_cast<size_t>(conversion.region.y());
+                region.width = static_cast<size_t>(conversion.region.width());
+                region.height = static_cast<size_t>(conversion.region.height());
 
-            // ... or without image converter
-            // peak::BufferTo<peak::ipl::Image>(buffer).ConvertTo(
-            //     peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
+                m_debayer.ConvertRegion(image.Data(), image.Width(), image.Height(),
+                    image.PixelFormat().PixelFormatName(), region, qImage.bits(),
+                    static_cast<size_t>(conversion.size.width()), static_cast<size_t>(conversion.size.height()),
+                    static_cast<size_t>(qImage.bytesPerLine()), peak::ipl::PixelFormatName::BGRa8);
+            }
+            else
+            {
+                qImage = ToQImage(std::move(lease), static_cast<int>(m_imageWidth), static_cast<int>(m_imageHeight),
+                    static_cast<int>(m_imageWidth * 4), QImage::Format_RGB32);
+
+                // Using the image converter ...
+                m_imageConverter->Convert(image, peak::ipl::PixelFormatName::BGRa8, qImage.bits(),
+                    static_cast<size_t>(qImage.byteCount()));
+
+                // ... or without image converter
+                // image.ConvertTo(
+                //     peak::ipl::PixelFormatName::BGRa8, qImage.bits(), static_cast<size_t>(qImage.byteCount()));
+            }
 
             // Queue buffer so that it can be used again
-            m_dataStream->QueueBuffer(buffer);
+            m_dataStream->QueueBuffer(frame.buffer);
 
             // Emit signal that the image is ready to be displayed
-            emit imageReceived(qImage);
+            emit imageReceived(qImage, conversion.region,
+                QSize(static_cast<int>(image.Width()), static_cast<int>(image.Height())));
 
             m_frameCounter++;
         }
@@ -114,11 +202,63 @@ void AcquisitionWorker::Start()
             qDebug() << "Exception: " << e.what();
         }
 
-        // Send signal with current frame and error counter
-        emit counterChanged(m_frameCounter, m_errorCounter);
+        // Send signal with current frame, error and dropped counter
+        emit counterChanged(m_frameCounter, m_errorCounter, static_cast<unsigned int>(m_frameRing.Counters().rejected));
     }
 }
 
+AcquisitionWorker::DisplayConversion AcquisitionWorker::PlanConversion(const peak::ipl::Image& image) const
+{
+    const QRect sensor(0, 0, static_cast<int>(image.Width()), static_cast<int>(image.Height()));
+
+    // By default the whole image at full resolution, the display scales and crops it
+    DisplayConversion conversion;
+    conversion.region = sensor;
+    conversion.size = sensor.size();
+
+    QRect visibleRegion;
+    QSize viewportSize;
+    {
+        std::lock_guard<std::mutex> lock(m_viewMutex);
+        visibleRegion = m_visibleRegion;
+        viewportSize = m_viewportSize;
+    }
+
+    if (viewportSize.isEmpty()
+        || !Debayer::IsSupported(image.PixelFormat().PixelFormatName(), peak::ipl::PixelFormatName::BGRa8))
+    {
+        return conversion;
+    }
+
+    const auto region = visibleRegion.intersected(sensor);
+    if (region.width() >= 2 && region.height() >= 2)
+    {
+        conversion.region = region;
+    }
+
+    // Scale of the region in the display, keeping the aspect ratio like the display does
+    const auto width = static_cast<double>(conversion.region.width());
+    const auto height = static_cast<double>(conversion.region.height());
+    const auto scale = std::min(viewportSize.width() / width, viewportSize.height() / height);
+
+    if (scale <= 0.5)
+    {
+        // Zoomed out, or only slightly in: decimate while demosaicing, only the pixels that end up on screen are read
+        conversion.debayer = true;
+        conversion.size =
+            QSize(std::max(1, static_cast<int>(width * scale)), std::max(1, static_cast<int>(height * scale)));
+    }
+    else if (conversion.region != sensor)
+    {
+        // Zoomed in: the crop at full resolution, the display scales it up
+        conversion.debayer = true;
+    }
+
+    // The whole sensor above half its size in the display is converted by the IPL as before, decimating would save
+    // little and lose detail
+    return conversion;
+}
+
 void AcquisitionWorker::Stop()
 {
     m_running = false;
@@ -129,3 +269,10 @@ void AcquisitionWorker::SetDataStream(std::shared_ptr<peak::core::DataStream> da
     m_dataStream = dataStream;
     m_nodemapRemoteDevice = m_dataStream->ParentDevice()->RemoteDevice()->NodeMaps().at(0);
 }
+
+void AcquisitionWorker::SetView(QRect visibleRegion, QSize viewportSize)
+{
+    std::lock_guard<std::mutex> lock(m_viewMutex);
+    m_visibleRegion = visibleRegion;
+    m_viewportSize = viewportSize;
+}
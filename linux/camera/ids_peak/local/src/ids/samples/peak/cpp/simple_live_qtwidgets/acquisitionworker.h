@@ -28,11 +28,21 @@
 #ifndef ACQUISITIONWORKER_H
 #define ACQUISITIONWORKER_H
 
+#include "debayer.h"
+#include "framering.h"
+#include "imagepool.h"
+
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
 
 #include <QImage>
 #include <QObject>
+#include <QRect>
+#include <QSize>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 
 class AcquisitionWorker : public QObject
@@ -47,23 +57,61 @@ public:
     void Stop();
     void SetDataStream(std::shared_ptr<peak::core::DataStream> dataStream);
 
+    // Visible part of the sensor and size of the display in device pixels. Thread-safe, may be called directly from
+    // the GUI thread.
+    void SetView(QRect visibleRegion, QSize viewportSize);
+
+    // Number of finished buffers that may wait for conversion. These buffers are announced in addition to
+    // NumBuffersAnnouncedMinRequired(), so the camera is not starved while frames wait in the ring.
+    static const size_t FrameRingCapacity = 4;
+
+    // Number of display images: one being converted, one queued for the display, one shown and one spare
+    static const size_t DisplayImageCount = 4;
+
 private:
+    void ConvertFrames();
+
+    // Part of the sensor to convert for the display and the size to convert it to
+    struct DisplayConversion
+    {
+        QRect region;
+        QSize size;
+        // Converted by m_debayer, otherwise the whole image by the IPL image converter
+        bool debayer = false;
+    };
+
+    DisplayConversion PlanConversion(const peak::ipl::Image& image) const;
+
     std::shared_ptr<peak::core::DataStream> m_dataStream;
     std::shared_ptr<peak::core::NodeMap> m_nodemapRemoteDevice;
 
-    bool m_running = false;
+    std::atomic<bool> m_running{ false };
 
-    unsigned int m_frameCounter = 0;
-    unsigned int m_errorCounter = 0;
+    std::atomic<unsigned int> m_frameCounter{ 0 };
+    std::atomic<unsigned int> m_errorCounter{ 0 };
 
     size_t m_imageWidth = 0;
     size_t m_imageHeight = 0;
 
     std::unique_ptr<peak::ipl::ImageConverter> m_imageConverter;
 
+    // Converts only the visible part of Bayer frames, at no more than the display size
+    Debayer m_debayer;
+    mutable std::mutex m_viewMutex;
+    QRect m_visibleRegion;
+    QSize m_viewportSize;
+
+    // Hands finished buffers from the acquisition loop to the conversion thread
+    FrameRing<> m_frameRing{ FrameRingCapacity };
+    std::thread m_conversionThread;
+
+    // Display images, recycled once the display has released them
+    std::unique_ptr<ImagePool> m_imagePool;
+
 signals:
-    void imageReceived(QImage image);
-    void counterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    // \p region is the part of the sensor of \p sensorSize that \p image shows
+    void imageReceived(QImage image, QRect region, QSize sensorSize);
+    void counterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
 };
 
 #endif // ACQUISITIONWORKER_H
@@ -31,7 +31,21 @@
 #include <QImage>
 #include <QWidget>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
+
+
+namespace
+{
+
+// Zooming stops at this many widget pixels per sensor pixel
+constexpr double maximumScale = 8.0;
+
+// Zoom factor of one wheel notch
+constexpr double zoomStep = 1.25;
+
+} // namespace
 
 
 Display::Display(QWidget* parent)
@@ -46,66 +60,226 @@ Display::~Display()
 {}
 
 
-void Display::onImageReceived(QImage image)
+uint64_t Display::CoalescedFrames() const
 {
-    m_scene->setImage(image);
+    return m_mailbox.Counters().coalesced;
 }
 
 
-CustomGraphicsScene::CustomGraphicsScene(Display* parent)
-    : QGraphicsScene(parent),
-    m_parent(parent)
-{}
+QRectF Display::TargetRect(const QRect& region) const
+{
+    // The scene origin is the middle of the display, where m_center is shown
+    const auto s = scale();
+    return QRectF((region.x() - m_center.x()) * s, (region.y() - m_center.y()) * s, region.width() * s,
+        region.height() * s);
+}
 
 
-CustomGraphicsScene::~CustomGraphicsScene()
-{}
+void Display::onImageReceived(QImage image, QRect region, QSize sensorSize)
+{
+    DisplayImage displayImage;
+    displayImage.image = std::move(image);
+    displayImage.region = region;
+    displayImage.sensorSize = sensorSize;
 
+    // Only the image that fills the empty mailbox queues an event, later ones replace it until it is shown
+    if (m_mailbox.Post(std::move(displayImage)))
+    {
+        QMetaObject::invokeMethod(this, "showLatestImage", Qt::QueuedConnection);
+    }
+}
 
-void CustomGraphicsScene::setImage(QImage image)
+
+void Display::showLatestImage()
 {
-    m_image = image;
-    update();
+    DisplayImage displayImage;
+    if (!m_mailbox.Take(displayImage))
+    {
+        return;
+    }
+
+    if (displayImage.sensorSize != m_sensorSize)
+    {
+        // First image, or the sensor size has changed: show the whole sensor
+        m_sensorSize = displayImage.sensorSize;
+        m_zoom = 1.0;
+        m_center = QPointF(m_sensorSize.width() / 2.0, m_sensorSize.height() / 2.0);
+        updateView();
+    }
+
+    m_scene->setImage(displayImage.image, displayImage.region);
 }
 
 
-void CustomGraphicsScene::drawBackground(QPainter* painter, const QRectF&)
+double Display::fitScale() const
 {
-    // Display size
-    double displayWidth = static_cast<double>(m_parent->width());
-    double displayHeight = static_cast<double>(m_parent->height());
+    if (m_sensorSize.isEmpty())
+    {
+        return 1.0;
+    }
+
+    return std::min(static_cast<double>(width()) / m_sensorSize.width(),
+        static_cast<double>(height()) / m_sensorSize.height());
+}
+
+
+double Display::scale() const
+{
+    return fitScale() * m_zoom;
+}
+
+
+void Display::clampZoom()
+{
+    m_zoom = std::max(1.0, std::min(m_zoom, maximumScale / fitScale()));
+}
+
+
+void Display::updateView()
+{
+    if (m_sensorSize.isEmpty())
+    {
+        return;
+    }
 
-    // Image size
-    double imageWidth = static_cast<double>(m_image.width());
-    double imageHeight = static_cast<double>(m_image.height());
+    clampZoom();
 
-    // Calculate aspect ratio of the display
-    double ratio1 = displayWidth / displayHeight;
+    // Half the visible part in sensor pixels. Where it covers the whole sensor, the sensor is centred.
+    const auto s = scale();
+    const auto halfWidth = width() / (2.0 * s);
+    const auto halfHeight = height() / (2.0 * s);
 
-    // Calculate aspect ratio of the image
-    double ratio2 = imageWidth / imageHeight;
+    if (2.0 * halfWidth >= m_sensorSize.width())
+    {
+        m_center.setX(m_sensorSize.width() / 2.0);
+    }
+    else
+    {
+        m_center.setX(std::max(halfWidth, std::min(m_center.x(), m_sensorSize.width() - halfWidth)));
+    }
 
-    if (ratio1 > ratio2)
+    if (2.0 * halfHeight >= m_sensorSize.height())
     {
-        // the height with must fit to the display height. So h remains and w must be scaled down
-        imageWidth = displayHeight * ratio2;
-        imageHeight = displayHeight;
+        m_center.setY(m_sensorSize.height() / 2.0);
     }
     else
     {
-        // the image with must fit to the display width. So w remains and h must be scaled down
-        imageWidth = displayWidth;
-        imageHeight = displayWidth / ratio2;
+        m_center.setY(std::max(halfHeight, std::min(m_center.y(), m_sensorSize.height() - halfHeight)));
     }
 
-    double imagePosX = -1.0 * (imageWidth / 2.0);
-    double imagePosY = -1.0 * (imageHeight / 2.0);
+    const auto visibleRegion =
+        QRectF(m_center.x() - halfWidth, m_center.y() - halfHeight, 2.0 * halfWidth, 2.0 * halfHeight)
+            .toAlignedRect()
+            .intersected(QRect(QPoint(0, 0), m_sensorSize));
+
+    const auto ratio = devicePixelRatioF();
+    const QSize viewportSize(static_cast<int>(std::ceil(width() * ratio)), static_cast<int>(std::ceil(height() * ratio)));
+
+    if (visibleRegion != m_publishedRegion || viewportSize != m_publishedViewport)
+    {
+        m_publishedRegion = visibleRegion;
+        m_publishedViewport = viewportSize;
+        emit viewChanged(visibleRegion, viewportSize);
+    }
+
+    m_scene->update();
+}
 
-    // Remove digits afer point
-    imagePosX = trunc(imagePosX);
-    imagePosY = trunc(imagePosY);
 
-    QRectF rect(imagePosX, imagePosY, imageWidth, imageHeight);
+void Display::resizeEvent(QResizeEvent* event)
+{
+    QGraphicsView::resizeEvent(event);
+    updateView();
+}
+
+
+void Display::wheelEvent(QWheelEvent* event)
+{
+    if (m_sensorSize.isEmpty())
+    {
+        return;
+    }
+
+    // The sensor position under the cursor stays under the cursor
+    const QPointF offset = QPointF(event->pos()) - QPointF(width() / 2.0, height() / 2.0);
+    const auto anchor = m_center + offset / scale();
+
+    m_zoom *= std::pow(zoomStep, event->angleDelta().y() / 120.0);
+    clampZoom();
+    m_center = anchor - offset / scale();
+
+    updateView();
+    event->accept();
+}
+
+
+void Display::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        m_dragging = true;
+        m_dragPosition = event->pos();
+        event->accept();
+    }
+}
+
+
+void Display::mouseMoveEvent(QMouseEvent* event)
+{
+    if (m_dragging)
+    {
+        m_center -= QPointF(event->pos() - m_dragPosition) / scale();
+        m_dragPosition = event->pos();
+        updateView();
+        event->accept();
+    }
+}
+
+
+void Display::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        m_dragging = false;
+        event->accept();
+    }
+}
+
+
+void Display::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    m_zoom = 1.0;
+    updateView();
+    event->accept();
+}
+
+
+CustomGraphicsScene::CustomGraphicsScene(Display* parent)
+    : QGraphicsScene(parent),
+    m_parent(parent)
+{}
+
+
+CustomGraphicsScene::~CustomGraphicsScene()
+{}
+
+
+void CustomGraphicsScene::setImage(QImage image, QRect region)
+{
+    m_image = image;
+    m_region = region;
+    update();
+}
+
+
+void CustomGraphicsScene::drawBackground(QPainter* painter, const QRectF&)
+{
+    if (m_image.isNull())
+    {
+        return;
+    }
 
-    painter->drawImage(rect, m_image);
+    // The image may show only a part of the sensor, at any resolution. It is drawn where that part is in the view,
+    // an image converted before the view changed is placed correctly as well.
+    painter->drawImage(m_parent->TargetRect(m_region), m_image);
 }
@@ -28,10 +28,18 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
+#include "framemailbox.h"
+
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QMouseEvent>
 #include <QPainter>
+#include <QPoint>
+#include <QPointF>
 #include <QRect>
+#include <QResizeEvent>
+#include <QSize>
+#include <QWheelEvent>
 
 #include <cstdint>
 
@@ -47,11 +55,13 @@ public:
     CustomGraphicsScene(Display* pParent);
     ~CustomGraphicsScene();
 
-    void setImage(QImage image);
+    // \p region is the part of the sensor the image shows, in sensor pixels
+    void setImage(QImage image, QRect region);
 
 private:
     Display* m_parent;
     QImage m_image;
+    QRect m_region;
 
     virtual void drawBackground(QPainter* painter, const QRectF& rect);
 };
@@ -65,11 +75,68 @@ public:
     Display(QWidget* parent);
     ~Display();
 
+    // Frames that were replaced by a newer one before the GUI thread got to show them
+    uint64_t CoalescedFrames() const;
+
+    // Where the sensor pixels of \p region appear in the scene at the current zoom and position
+    QRectF TargetRect(const QRect& region) const;
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+    // Wheel zooms around the cursor, dragging moves the view, a double click shows the whole sensor again
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
 private:
+    // An image together with the part of the sensor it shows
+    struct DisplayImage
+    {
+        QImage image;
+        QRect region;
+        QSize sensorSize;
+    };
+
+    // Widget pixels per sensor pixel with the whole sensor in view, and at the current zoom
+    double fitScale() const;
+    double scale() const;
+    // Between the whole sensor and maximumScale widget pixels per sensor pixel
+    void clampZoom();
+    // Keeps the view on the sensor, and publishes it if it changed
+    void updateView();
+
     CustomGraphicsScene* m_scene;
 
+    // Only the newest image waits for the GUI thread, however long it is busy
+    FrameMailbox<DisplayImage> m_mailbox;
+
+    // Known from the first image on
+    QSize m_sensorSize;
+    // 1 shows the whole sensor
+    double m_zoom = 1.0;
+    // Sensor position shown in the middle of the display
+    QPointF m_center;
+
+    QPoint m_dragPosition;
+    bool m_dragging = false;
+
+    QRect m_publishedRegion;
+    QSize m_publishedViewport;
+
 public slots:
-    void onImageReceived(QImage image);
+    // Thread-safe, to be connected with Qt::DirectConnection from the acquisition thread. \p region is the part of
+    // the sensor of \p sensorSize that \p image shows, it may be scaled to any size.
+    void onImageReceived(QImage image, QRect region, QSize sensorSize);
+
+private slots:
+    void showLatestImage();
+
+signals:
+    // The visible part of the sensor in sensor pixels and the size of the display in device pixels. The acquisition
+    // converts no more than this region, at no more than this size.
+    void viewChanged(QRect visibleRegion, QSize viewportSize);
 };
 
 #endif // DISPLAY_H
@@ -77,8 +77,15 @@ MainWindow::MainWindow(QWidget* parent)
             connect(&m_acquisitionThread, &QThread::finished, m_acquisitionWorker, &QObject::deleteLater);
 
             // Connect the signal from the worker thread when a new image was received with the display update slot in
-            // the Display class
-            connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, m_display, &Display::onImageReceived);
+            // the Display class. The image is handed over directly to the mailbox of the display instead of queueing
+            // one event per frame, so a busy GUI thread skips to the newest image.
+            connect(m_acquisitionWorker, &AcquisitionWorker::imageReceived, m_display, &Display::onImageReceived,
+                Qt::DirectConnection);
+
+            // The worker loop has no event loop, the view is handed over directly and read by the conversion thread,
+            // which then converts only the visible part of the sensor at the size of the display
+            connect(m_display, &Display::viewChanged, m_acquisitionWorker, &AcquisitionWorker::SetView,
+                Qt::DirectConnection);
 
             // Connect the signal from the worker thread when the counters have changed with the update slot in the
             // MainWindow class
@@ -210,8 +217,8 @@ bool MainWindow::OpenDevice()
             auto payloadSize = m_nodemapRemoteDevice->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")
                                    ->Value();
 
-            // Get the minimum number of buffers that must be announced
-            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired();
+            // Get the minimum number of buffers that must be announced, plus the buffers that may wait for conversion
+            auto bufferCountMax = m_dataStream->NumBuffersAnnouncedMinRequired() + AcquisitionWorker::FrameRingCapacity;
 
             // Allocate and announce image buffers and queue them
             for (size_t bufferCount = 0; bufferCount < bufferCountMax; ++bufferCount)
@@ -310,10 +317,12 @@ void MainWindow::createStatusBar()
     m_layout->addWidget(statusBar);
 }
 
-void MainWindow::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter)
+void MainWindow::onCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter)
 {
-    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2")
-            .arg(QString::number(frameCounter), QString::number(errorCounter)));
+    const auto coalescedCounter = m_display ? m_display->CoalescedFrames() : 0;
+    m_labelInfo->setText(QString("Frames acquired: %1, errors: %2, dropped: %3, not displayed: %4")
+            .arg(QString::number(frameCounter), QString::number(errorCounter), QString::number(droppedCounter),
+                QString::number(coalescedCounter)));
 }
 
 void MainWindow::on_aboutQt_linkActivated(const QString& link)
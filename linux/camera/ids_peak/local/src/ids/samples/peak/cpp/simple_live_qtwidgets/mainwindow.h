@@ -69,7 +69,7 @@ private:
     void createStatusBar();
 
 public slots:
-    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter);
+    void onCounterChanged(unsigned int frameCounter, unsigned int errorCounter, unsigned int droppedCounter);
     void on_aboutQt_linkActivated(const QString& link);
 };
 
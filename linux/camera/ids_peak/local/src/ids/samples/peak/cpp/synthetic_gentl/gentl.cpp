@@ -0,0 +1,676 @@
+/*!
+ * \file    gentl.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The exported GenTL 1.5 C interface of the synthetic producer.
+ *          Every function resolves its handles, forwards to the modules in
+ *          producer.h and turns exceptions into GC_ERROR codes that
+ *          GCGetLastError can describe.
+ *
+ * \version 1.0.0
+ */
+
+#include "producer.h"
+
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+namespace
+{
+
+using namespace synthetic;
+
+struct LastError
+{
+    GC_ERROR code = GC_ERR_SUCCESS;
+    std::string text;
+};
+
+thread_local LastError lastError;
+
+std::mutex libraryMutex;
+bool initialized = false;
+std::unique_ptr<System> openSystem;
+
+void checkInitialized()
+{
+    std::lock_guard<std::mutex> lock(libraryMutex);
+    if (!initialized)
+    {
+        throw GenTLError(GC_ERR_NOT_INITIALIZED, "GCInitLib has not been called");
+    }
+}
+
+void checkPointer(const void* pointer, const char* name)
+{
+    if (!pointer)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, std::string(name) + " must not be NULL");
+    }
+}
+
+// Runs one API call and turns its exceptions into the GenTL error code
+template <class Function>
+GC_ERROR guarded(Function function, bool requiresInit = true)
+{
+    try
+    {
+        if (requiresInit)
+        {
+            checkInitialized();
+        }
+        function();
+        return GC_ERR_SUCCESS;
+    }
+    catch (const GenTLError& e)
+    {
+        lastError.code = e.Code();
+        lastError.text = e.what();
+    }
+    catch (const std::bad_alloc& e)
+    {
+        lastError.code = GC_ERR_OUT_OF_MEMORY;
+        lastError.text = e.what();
+    }
+    catch (const std::exception& e)
+    {
+        lastError.code = GC_ERR_ERROR;
+        lastError.text = e.what();
+    }
+    catch (...)
+    {
+        lastError.code = GC_ERR_ERROR;
+        lastError.text = "Unknown error";
+    }
+    return lastError.code;
+}
+
+void copyString(const std::string& value, char* buffer, size_t* size)
+{
+    InfoTarget(nullptr, buffer, size).String(value);
+}
+
+System* resolveSystem(void* handle)
+{
+    auto* system = Resolve<System>(handle);
+    std::lock_guard<std::mutex> lock(libraryMutex);
+    if (system != openSystem.get())
+    {
+        throw GenTLError(GC_ERR_INVALID_HANDLE, "Transport layer is not open");
+    }
+    return system;
+}
+
+void getInterfaceInfo(INTERFACE_INFO_CMD command, InfoTarget target)
+{
+    switch (command)
+    {
+    case INTERFACE_INFO_ID:
+        return target.String(System::InterfaceId());
+    case INTERFACE_INFO_DISPLAYNAME:
+        return target.String("Synthetic Interface");
+    case INTERFACE_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "Interface info not available");
+    }
+}
+
+} // namespace
+
+
+namespace GenTL
+{
+
+GC_API GCGetInfo(TL_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] { System::GetInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize)); }, false);
+}
+
+GC_API GCGetLastError(GC_ERROR* piErrorCode, char* sErrText, size_t* piSize)
+{
+    if (!piErrorCode || !piSize)
+    {
+        return GC_ERR_INVALID_PARAMETER;
+    }
+
+    // Not guarded, so reading the error does not overwrite it
+    *piErrorCode = lastError.code;
+    try
+    {
+        copyString(lastError.text, sErrText, piSize);
+    }
+    catch (const GenTLError& e)
+    {
+        return e.Code();
+    }
+    return GC_ERR_SUCCESS;
+}
+
+GC_API GCInitLib(void)
+{
+    return guarded(
+        [] {
+            std::lock_guard<std::mutex> lock(libraryMutex);
+            if (initialized)
+            {
+                throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Library is already initialized");
+            }
+            initialized = true;
+        },
+        false);
+}
+
+GC_API GCCloseLib(void)
+{
+    return guarded([] {
+        std::unique_ptr<System> system;
+        {
+            std::lock_guard<std::mutex> lock(libraryMutex);
+            initialized = false;
+            system = std::move(openSystem);
+        }
+        // Stops the generator threads of streams the consumer left open
+        system.reset();
+    });
+}
+
+GC_API GCReadPort(PORT_HANDLE hPort, uint64_t iAddress, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        checkPointer(piSize, "piSize");
+        Resolve<Port>(hPort)->Read(iAddress, pBuffer, *piSize);
+    });
+}
+
+GC_API GCWritePort(PORT_HANDLE hPort, uint64_t iAddress, const void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        checkPointer(piSize, "piSize");
+        Resolve<Port>(hPort)->Write(iAddress, pBuffer, *piSize);
+    });
+}
+
+GC_API GCGetPortURL(PORT_HANDLE hPort, char* sURL, size_t* piSize)
+{
+    return guarded([&] { copyString(Resolve<Port>(hPort)->Url(), sURL, piSize); });
+}
+
+GC_API GCGetPortInfo(PORT_HANDLE hPort, PORT_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] { Resolve<Port>(hPort)->GetPortInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize)); });
+}
+
+GC_API GCRegisterEvent(EVENTSRC_HANDLE hEventSrc, EVENT_TYPE iEventID, EVENT_HANDLE* phEvent)
+{
+    return guarded([&] {
+        checkPointer(phEvent, "phEvent");
+        auto* source = ResolveHandle(hEventSrc);
+        auto* stream = dynamic_cast<DataStream*>(source);
+        if (!stream)
+        {
+            throw GenTLError(GC_ERR_NOT_IMPLEMENTED, "Only data streams are event sources");
+        }
+        *phEvent = stream->RegisterEvent(iEventID)->AsHandle();
+    });
+}
+
+GC_API GCUnregisterEvent(EVENTSRC_HANDLE hEventSrc, EVENT_TYPE iEventID)
+{
+    return guarded([&] {
+        auto* stream = dynamic_cast<DataStream*>(ResolveHandle(hEventSrc));
+        if (!stream)
+        {
+            throw GenTLError(GC_ERR_NOT_IMPLEMENTED, "Only data streams are event sources");
+        }
+        stream->UnregisterEvent(iEventID);
+    });
+}
+
+GC_API EventGetData(EVENT_HANDLE hEvent, void* pBuffer, size_t* piSize, uint64_t iTimeout)
+{
+    return guarded([&] { Resolve<Event>(hEvent)->GetData(pBuffer, piSize, iTimeout); });
+}
+
+GC_API EventGetDataInfo(EVENT_HANDLE hEvent, const void* pInBuffer, size_t iInSize, EVENT_DATA_INFO_CMD iInfoCmd,
+    INFO_DATATYPE* piType, void* pOutBuffer, size_t* piOutSize)
+{
+    return guarded([&] {
+        auto* event = Resolve<Event>(hEvent);
+        if (event->Type() != EVENT_NEW_BUFFER)
+        {
+            throw GenTLError(GC_ERR_NOT_AVAILABLE, "Event data info not available");
+        }
+        checkPointer(pInBuffer, "pInBuffer");
+        if (iInSize < sizeof(EVENT_NEW_BUFFER_DATA))
+        {
+            throw GenTLError(GC_ERR_INVALID_PARAMETER, "Invalid event data");
+        }
+
+        EVENT_NEW_BUFFER_DATA data;
+        std::memcpy(&data, pInBuffer, sizeof(data));
+        InfoTarget target(piType, pOutBuffer, piOutSize);
+        switch (iInfoCmd)
+        {
+        case EVENT_DATA_ID:
+            return target.Ptr(data.BufferHandle);
+        case EVENT_DATA_VALUE:
+            return target.Ptr(data.pUserPointer);
+        default:
+            throw GenTLError(GC_ERR_NOT_AVAILABLE, "Event data info not available");
+        }
+    });
+}
+
+GC_API EventGetInfo(EVENT_HANDLE hEvent, EVENT_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        auto* event = Resolve<Event>(hEvent);
+        InfoTarget target(piType, pBuffer, piSize);
+        switch (iInfoCmd)
+        {
+        case EVENT_EVENT_TYPE:
+            return target.Int32(event->Type());
+        case EVENT_NUM_IN_QUEUE:
+            return target.SizeT(event->NumInQueue());
+        case EVENT_NUM_FIRED:
+            return target.UInt64(event->NumFired());
+        case EVENT_SIZE_MAX:
+            return target.SizeT(event->DataSizeMax());
+        case EVENT_INFO_DATA_SIZE_MAX:
+            return target.SizeT(sizeof(void*));
+        default:
+            throw GenTLError(GC_ERR_NOT_AVAILABLE, "Event info not available");
+        }
+    });
+}
+
+GC_API EventFlush(EVENT_HANDLE hEvent)
+{
+    return guarded([&] { Resolve<Event>(hEvent)->Flush(); });
+}
+
+GC_API EventKill(EVENT_HANDLE hEvent)
+{
+    return guarded([&] { Resolve<Event>(hEvent)->Kill(); });
+}
+
+GC_API TLOpen(TL_HANDLE* phTL)
+{
+    return guarded([&] {
+        checkPointer(phTL, "phTL");
+        std::lock_guard<std::mutex> lock(libraryMutex);
+        if (openSystem)
+        {
+            throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Transport layer is already open");
+        }
+        openSystem = std::make_unique<System>(Config::FromEnvironment());
+        *phTL = openSystem->AsHandle();
+    });
+}
+
+GC_API TLClose(TL_HANDLE hTL)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        std::unique_ptr<System> system;
+        {
+            std::lock_guard<std::mutex> lock(libraryMutex);
+            system = std::move(openSystem);
+        }
+        system.reset();
+    });
+}
+
+GC_API TLGetInfo(TL_HANDLE hTL, TL_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        System::GetInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API TLGetNumInterfaces(TL_HANDLE hTL, uint32_t* piNumIfaces)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        checkPointer(piNumIfaces, "piNumIfaces");
+        *piNumIfaces = 1;
+    });
+}
+
+GC_API TLGetInterfaceID(TL_HANDLE hTL, uint32_t iIndex, char* sID, size_t* piSize)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        if (iIndex != 0)
+        {
+            throw GenTLError(GC_ERR_INVALID_INDEX, "Invalid interface index");
+        }
+        copyString(System::InterfaceId(), sID, piSize);
+    });
+}
+
+GC_API TLGetInterfaceInfo(TL_HANDLE hTL, const char* sIfaceID, INTERFACE_INFO_CMD iInfoCmd, INFO_DATATYPE* piType,
+    void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        checkPointer(sIfaceID, "sIfaceID");
+        if (std::string(sIfaceID) != System::InterfaceId())
+        {
+            throw GenTLError(GC_ERR_INVALID_ID, "Unknown interface");
+        }
+        getInterfaceInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API TLOpenInterface(TL_HANDLE hTL, const char* sIfaceID, IF_HANDLE* phIface)
+{
+    return guarded([&] {
+        checkPointer(sIfaceID, "sIfaceID");
+        checkPointer(phIface, "phIface");
+        *phIface = resolveSystem(hTL)->OpenInterface(sIfaceID)->AsHandle();
+    });
+}
+
+GC_API TLUpdateInterfaceList(TL_HANDLE hTL, bool8_t* pbChanged, uint64_t)
+{
+    return guarded([&] {
+        resolveSystem(hTL);
+        if (pbChanged)
+        {
+            *pbChanged = false;
+        }
+    });
+}
+
+GC_API IFClose(IF_HANDLE hIface)
+{
+    return guarded([&] { Resolve<Interface>(hIface)->Parent().CloseInterface(); });
+}
+
+GC_API IFGetInfo(IF_HANDLE hIface, INTERFACE_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        Resolve<Interface>(hIface);
+        getInterfaceInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API IFGetNumDevices(IF_HANDLE hIface, uint32_t* piNumDevices)
+{
+    return guarded([&] {
+        checkPointer(piNumDevices, "piNumDevices");
+        *piNumDevices = static_cast<uint32_t>(Resolve<Interface>(hIface)->Parent().DeviceCount());
+    });
+}
+
+GC_API IFGetDeviceID(IF_HANDLE hIface, uint32_t iIndex, char* sIDeviceID, size_t* piSize)
+{
+    return guarded([&] { copyString(Resolve<Interface>(hIface)->Parent().DeviceId(iIndex), sIDeviceID, piSize); });
+}
+
+GC_API IFUpdateDeviceList(IF_HANDLE hIface, bool8_t* pbChanged, uint64_t)
+{
+    return guarded([&] {
+        Resolve<Interface>(hIface);
+        if (pbChanged)
+        {
+            *pbChanged = false;
+        }
+    });
+}
+
+GC_API IFGetDeviceInfo(IF_HANDLE hIface, const char* sDeviceID, DEVICE_INFO_CMD iInfoCmd, INFO_DATATYPE* piType,
+    void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        checkPointer(sDeviceID, "sDeviceID");
+        Resolve<Interface>(hIface)->GetDeviceInfo(sDeviceID, iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API IFOpenDevice(IF_HANDLE hIface, const char* sDeviceID, DEVICE_ACCESS_FLAGS iOpenFlags, DEV_HANDLE* phDevice)
+{
+    return guarded([&] {
+        checkPointer(sDeviceID, "sDeviceID");
+        checkPointer(phDevice, "phDevice");
+        if (iOpenFlags == DEVICE_ACCESS_UNKNOWN || iOpenFlags == DEVICE_ACCESS_NONE)
+        {
+            throw GenTLError(GC_ERR_INVALID_PARAMETER, "Invalid access flags");
+        }
+        *phDevice = Resolve<Interface>(hIface)->OpenDevice(sDeviceID)->AsHandle();
+    });
+}
+
+GC_API DevGetPort(DEV_HANDLE hDevice, PORT_HANDLE* phRemoteDevice)
+{
+    return guarded([&] {
+        checkPointer(phRemoteDevice, "phRemoteDevice");
+        *phRemoteDevice = Resolve<Device>(hDevice)->Remote().AsHandle();
+    });
+}
+
+GC_API DevGetNumDataStreams(DEV_HANDLE hDevice, uint32_t* piNumDataStreams)
+{
+    return guarded([&] {
+        Resolve<Device>(hDevice);
+        checkPointer(piNumDataStreams, "piNumDataStreams");
+        *piNumDataStreams = 1;
+    });
+}
+
+GC_API DevGetDataStreamID(DEV_HANDLE hDevice, uint32_t iIndex, char* sDataStreamID, size_t* piSize)
+{
+    return guarded([&] {
+        Resolve<Device>(hDevice);
+        if (iIndex != 0)
+        {
+            throw GenTLError(GC_ERR_INVALID_INDEX, "Invalid data stream index");
+        }
+        copyString("Stream0", sDataStreamID, piSize);
+    });
+}
+
+GC_API DevOpenDataStream(DEV_HANDLE hDevice, const char* sDataStreamID, DS_HANDLE* phDataStream)
+{
+    return guarded([&] {
+        checkPointer(sDataStreamID, "sDataStreamID");
+        checkPointer(phDataStream, "phDataStream");
+        *phDataStream = Resolve<Device>(hDevice)->OpenDataStream(sDataStreamID)->AsHandle();
+    });
+}
+
+GC_API DevGetInfo(DEV_HANDLE hDevice, DEVICE_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        auto* device = Resolve<Device>(hDevice);
+        auto* parentInterface = Resolve<Interface>(device->ParentInterface());
+        parentInterface->GetDeviceInfo(device->Id(), iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API DevClose(DEV_HANDLE hDevice)
+{
+    return guarded([&] {
+        auto* device = Resolve<Device>(hDevice);
+        Resolve<Interface>(device->ParentInterface())->CloseDevice(device);
+    });
+}
+
+GC_API DSAnnounceBuffer(DS_HANDLE hDataStream, void* pBuffer, size_t iSize, void* pPrivate, BUFFER_HANDLE* phBuffer)
+{
+    return guarded([&] {
+        checkPointer(phBuffer, "phBuffer");
+        *phBuffer = Resolve<DataStream>(hDataStream)->Announce(pBuffer, iSize, pPrivate)->AsHandle();
+    });
+}
+
+GC_API DSAllocAndAnnounceBuffer(DS_HANDLE hDataStream, size_t iSize, void* pPrivate, BUFFER_HANDLE* phBuffer)
+{
+    return guarded([&] {
+        checkPointer(phBuffer, "phBuffer");
+        *phBuffer = Resolve<DataStream>(hDataStream)->AllocAndAnnounce(iSize, pPrivate)->AsHandle();
+    });
+}
+
+GC_API DSFlushQueue(DS_HANDLE hDataStream, ACQ_QUEUE_TYPE iOperation)
+{
+    return guarded([&] { Resolve<DataStream>(hDataStream)->FlushQueue(iOperation); });
+}
+
+GC_API DSStartAcquisition(DS_HANDLE hDataStream, ACQ_START_FLAGS, uint64_t iNumToAcquire)
+{
+    return guarded([&] { Resolve<DataStream>(hDataStream)->StartAcquisition(iNumToAcquire); });
+}
+
+GC_API DSStopAcquisition(DS_HANDLE hDataStream, ACQ_STOP_FLAGS)
+{
+    return guarded([&] { Resolve<DataStream>(hDataStream)->StopAcquisition(); });
+}
+
+GC_API DSGetInfo(DS_HANDLE hDataStream, STREAM_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded(
+        [&] { Resolve<DataStream>(hDataStream)->GetInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize)); });
+}
+
+GC_API DSGetBufferID(DS_HANDLE hDataStream, uint32_t iIndex, BUFFER_HANDLE* phBuffer)
+{
+    return guarded([&] {
+        checkPointer(phBuffer, "phBuffer");
+        *phBuffer = Resolve<DataStream>(hDataStream)->BufferAt(iIndex)->AsHandle();
+    });
+}
+
+GC_API DSClose(DS_HANDLE hDataStream)
+{
+    return guarded([&] {
+        auto* stream = Resolve<DataStream>(hDataStream);
+        Resolve<Device>(stream->ParentDevice())->CloseDataStream();
+    });
+}
+
+GC_API DSRevokeBuffer(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, void** pBuffer, void** pPrivate)
+{
+    return guarded(
+        [&] { Resolve<DataStream>(hDataStream)->Revoke(Resolve<Buffer>(hBuffer), pBuffer, pPrivate); });
+}
+
+GC_API DSQueueBuffer(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer)
+{
+    return guarded([&] { Resolve<DataStream>(hDataStream)->Queue(Resolve<Buffer>(hBuffer)); });
+}
+
+GC_API DSGetBufferInfo(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, BUFFER_INFO_CMD iInfoCmd, INFO_DATATYPE* piType,
+    void* pBuffer, size_t* piSize)
+{
+    return guarded([&] {
+        auto* stream = Resolve<DataStream>(hDataStream);
+        auto* buffer = Resolve<Buffer>(hBuffer);
+        if (&buffer->stream != stream)
+        {
+            throw GenTLError(GC_ERR_INVALID_HANDLE, "Buffer does not belong to this data stream");
+        }
+        buffer->GetInfo(iInfoCmd, InfoTarget(piType, pBuffer, piSize));
+    });
+}
+
+GC_API GCGetNumPortURLs(PORT_HANDLE hPort, uint32_t* piNumURLs)
+{
+    return guarded([&] {
+        checkPointer(piNumURLs, "piNumURLs");
+        *piNumURLs = Resolve<Port>(hPort)->UrlCount();
+    });
+}
+
+GC_API GCGetPortURLInfo(
+    PORT_HANDLE hPort, uint32_t iURLIndex, URL_INFO_CMD iInfoCmd, INFO_DATATYPE* piType, void* pBuffer, size_t* piSize)
+{
+    return guarded(
+        [&] { Resolve<Port>(hPort)->GetUrlInfo(iURLIndex, iInfoCmd, InfoTarget(piType, pBuffer, piSize)); });
+}
+
+GC_API GCReadPortStacked(PORT_HANDLE hPort, PORT_REGISTER_STACK_ENTRY* pEntries, size_t* piNumEntries)
+{
+    return guarded([&] {
+        checkPointer(pEntries, "pEntries");
+        checkPointer(piNumEntries, "piNumEntries");
+        auto* port = Resolve<Port>(hPort);
+        for (size_t i = 0; i < *piNumEntries; ++i)
+        {
+            port->Read(pEntries[i].Address, pEntries[i].pBuffer, pEntries[i].Size);
+        }
+    });
+}
+
+GC_API GCWritePortStacked(PORT_HANDLE hPort, PORT_REGISTER_STACK_ENTRY* pEntries, size_t* piNumEntries)
+{
+    return guarded([&] {
+        checkPointer(pEntries, "pEntries");
+        checkPointer(piNumEntries, "piNumEntries");
+        auto* port = Resolve<Port>(hPort);
+        for (size_t i = 0; i < *piNumEntries; ++i)
+        {
+            port->Write(pEntries[i].Address, pEntries[i].pBuffer, pEntries[i].Size);
+        }
+    });
+}
+
+GC_API DSGetBufferChunkData(
+    DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, SINGLE_CHUNK_DATA* pChunkData, size_t* piNumChunks)
+{
+    return guarded([&] {
+        Resolve<DataStream>(hDataStream);
+        Resolve<Buffer>(hBuffer)->GetChunkData(pChunkData, piNumChunks);
+    });
+}
+
+GC_API IFGetParentTL(IF_HANDLE hIface, TL_HANDLE* phSystem)
+{
+    return guarded([&] {
+        checkPointer(phSystem, "phSystem");
+        *phSystem = Resolve<Interface>(hIface)->Parent().AsHandle();
+    });
+}
+
+GC_API DevGetParentIF(DEV_HANDLE hDevice, IF_HANDLE* phIface)
+{
+    return guarded([&] {
+        checkPointer(phIface, "phIface");
+        *phIface = Resolve<Device>(hDevice)->ParentInterface();
+    });
+}
+
+GC_API DSGetParentDev(DS_HANDLE hDataStream, DEV_HANDLE* phDevice)
+{
+    return guarded([&] {
+        checkPointer(phDevice, "phDevice");
+        *phDevice = Resolve<DataStream>(hDataStream)->ParentDevice();
+    });
+}
+
+GC_API DSGetNumBufferParts(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, uint32_t* piNumParts)
+{
+    return guarded([&] {
+        Resolve<DataStream>(hDataStream);
+        Resolve<Buffer>(hBuffer);
+        checkPointer(piNumParts, "piNumParts");
+        // Single part image buffers only
+        *piNumParts = 0;
+    });
+}
+
+GC_API DSGetBufferPartInfo(DS_HANDLE, BUFFER_HANDLE, uint32_t, BUFFER_PART_INFO_CMD, INFO_DATATYPE*, void*, size_t*)
+{
+    return guarded([] { throw GenTLError(GC_ERR_NOT_AVAILABLE, "Multi part buffers are not supported"); });
+}
+
+} // namespace GenTL
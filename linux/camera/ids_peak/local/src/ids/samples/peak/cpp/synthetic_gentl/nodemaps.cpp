@@ -0,0 +1,445 @@
+/*!
+ * \file    nodemaps.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   GenApi descriptions of the synthetic GenTL producer modules. They
+ *          are served through the "local:" URL of each port.
+ *
+ * \version 1.0.0
+ */
+
+#include "nodemaps.h"
+
+#include "registermap.h"
+
+#include <initializer_list>
+#include <sstream>
+#include <utility>
+
+
+namespace synthetic
+{
+
+namespace
+{
+
+using EnumEntries = std::initializer_list<std::pair<const char*, uint64_t>>;
+using Names = std::initializer_list<const char*>;
+
+// Writes GenApi schema 1.1 nodes. Child elements are emitted in schema order, some GenApi versions insist on it.
+class XmlWriter
+{
+public:
+    XmlWriter(const char* modelName, const char* productGuid, const char* versionGuid, const char* portName)
+        : m_portName(portName)
+    {
+        m_xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+              << "<RegisterDescription ModelName=\"" << modelName << "\" VendorName=\"IoTReady\""
+              << " ToolTip=\"Synthetic GenTL producer\" StandardNameSpace=\"None\""
+              << " SchemaMajorVersion=\"1\" SchemaMinorVersion=\"1\" SchemaSubMinorVersion=\"0\""
+              << " MajorVersion=\"1\" MinorVersion=\"0\" SubMinorVersion=\"0\""
+              << " ProductGuid=\"" << productGuid << "\" VersionGuid=\"" << versionGuid << "\""
+              << " xmlns=\"http://www.genicam.org/GenApi/Version_1_1\""
+              << " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\""
+              << " xsi:schemaLocation=\"http://www.genicam.org/GenApi/Version_1_1"
+              << " http://www.genicam.org/GenApi/GenApiSchema_Version_1_1.xsd\">\n";
+    }
+
+    std::string Finish()
+    {
+        m_xml << "  <Port Name=\"" << m_portName << "\"/>\n";
+        m_xml << "</RegisterDescription>\n";
+        return m_xml.str();
+    }
+
+    void Category(const char* name, Names features)
+    {
+        m_xml << "  <Category Name=\"" << name << "\">\n";
+        for (const auto* feature : features)
+        {
+            m_xml << "    <pFeature>" << feature << "</pFeature>\n";
+        }
+        m_xml << "  </Category>\n";
+    }
+
+    void ChunkPort(const char* name, uint64_t chunkId)
+    {
+        m_xml << "  <Port Name=\"" << name << "\">\n"
+              << "    <ChunkID>" << std::hex << std::uppercase << chunkId << std::dec << "</ChunkID>\n"
+              << "  </Port>\n";
+    }
+
+    // An IntReg can be used as a feature itself, e.g. for read-only counters
+    void IntReg(const char* name, uint64_t address, const char* access, const char* pIndex = nullptr,
+        const char* port = nullptr, const char* visibility = nullptr)
+    {
+        m_xml << "  <IntReg Name=\"" << name << "\">\n";
+        visibilityElement(visibility);
+        address_(address);
+        if (pIndex)
+        {
+            m_xml << "    <pIndex Offset=\"8\">" << pIndex << "</pIndex>\n";
+        }
+        registerTail(8, access, port);
+        m_xml << "    <Sign>Unsigned</Sign>\n"
+              << "    <Endianess>LittleEndian</Endianess>\n"
+              << "  </IntReg>\n";
+    }
+
+    void FloatReg(const char* name, uint64_t address, const char* access, const char* port = nullptr)
+    {
+        m_xml << "  <FloatReg Name=\"" << name << "\">\n";
+        address_(address);
+        registerTail(8, access, port);
+        m_xml << "    <Endianess>LittleEndian</Endianess>\n"
+              << "  </FloatReg>\n";
+    }
+
+    void StringReg(const char* name, uint64_t address, const char* access, const char* visibility = nullptr)
+    {
+        m_xml << "  <StringReg Name=\"" << name << "\">\n";
+        visibilityElement(visibility);
+        address_(address);
+        registerTail(StringLength, access, nullptr);
+        m_xml << "  </StringReg>\n";
+    }
+
+    // \p min, \p max and \p inc are either numbers or the names of nodes holding the limit
+    void Integer(const char* name, const char* pValue, const char* min, const char* max, const char* inc = nullptr,
+        const char* pIsLocked = nullptr, const char* visibility = nullptr)
+    {
+        m_xml << "  <Integer Name=\"" << name << "\">\n";
+        visibilityElement(visibility);
+        if (pIsLocked)
+        {
+            m_xml << "    <pIsLocked>" << pIsLocked << "</pIsLocked>\n";
+        }
+        m_xml << "    <pValue>" << pValue << "</pValue>\n";
+        limit("Min", min);
+        limit("Max", max);
+        limit("Inc", inc);
+        m_xml << "  </Integer>\n";
+    }
+
+    void Float(const char* name, const char* pValue, const char* min, const char* max, const char* unit)
+    {
+        m_xml << "  <Float Name=\"" << name << "\">\n"
+              << "    <pValue>" << pValue << "</pValue>\n";
+        limit("Min", min);
+        limit("Max", max);
+        m_xml << "    <Unit>" << unit << "</Unit>\n"
+              << "  </Float>\n";
+    }
+
+    void IntSwissKnife(const char* name, std::initializer_list<std::pair<const char*, const char*>> variables,
+        const char* formula)
+    {
+        m_xml << "  <IntSwissKnife Name=\"" << name << "\">\n";
+        for (const auto& variable : variables)
+        {
+            m_xml << "    <pVariable Name=\"" << variable.first << "\">" << variable.second << "</pVariable>\n";
+        }
+        m_xml << "    <Formula>" << formula << "</Formula>\n"
+              << "  </IntSwissKnife>\n";
+    }
+
+    void Enumeration(const char* name, const char* pValue, EnumEntries entries, Names selected = {},
+        const char* pIsLocked = nullptr)
+    {
+        m_xml << "  <Enumeration Name=\"" << name << "\">\n";
+        if (pIsLocked)
+        {
+            m_xml << "    <pIsLocked>" << pIsLocked << "</pIsLocked>\n";
+        }
+        for (const auto& entry : entries)
+        {
+            m_xml << "    <EnumEntry Name=\"" << entry.first << "\">\n"
+                  << "      <Value>" << entry.second << "</Value>\n"
+                  << "    </EnumEntry>\n";
+        }
+        m_xml << "    <pValue>" << pValue << "</pValue>\n";
+        for (const auto* feature : selected)
+        {
+            m_xml << "    <pSelected>" << feature << "</pSelected>\n";
+        }
+        m_xml << "  </Enumeration>\n";
+    }
+
+    void Boolean(const char* name, const char* pValue)
+    {
+        m_xml << "  <Boolean Name=\"" << name << "\">\n"
+              << "    <pValue>" << pValue << "</pValue>\n"
+              << "    <OnValue>1</OnValue>\n"
+              << "    <OffValue>0</OffValue>\n"
+              << "  </Boolean>\n";
+    }
+
+    void Command(const char* name, const char* pValue)
+    {
+        m_xml << "  <Command Name=\"" << name << "\">\n"
+              << "    <pValue>" << pValue << "</pValue>\n"
+              << "    <CommandValue>1</CommandValue>\n"
+              << "  </Command>\n";
+    }
+
+private:
+    void visibilityElement(const char* visibility)
+    {
+        if (visibility)
+        {
+            m_xml << "    <Visibility>" << visibility << "</Visibility>\n";
+        }
+    }
+
+    void address_(uint64_t address)
+    {
+        m_xml << "    <Address>0x" << std::hex << std::uppercase << address << std::dec << "</Address>\n";
+    }
+
+    void registerTail(size_t length, const char* access, const char* port)
+    {
+        // Nothing is cached, reads are function calls into this library and the registers change on their own
+        m_xml << "    <Length>" << length << "</Length>\n"
+              << "    <AccessMode>" << access << "</AccessMode>\n"
+              << "    <pPort>" << (port ? port : m_portName) << "</pPort>\n"
+              << "    <Cachable>NoCache</Cachable>\n";
+    }
+
+    void limit(const char* element, const char* value)
+    {
+        if (!value)
+        {
+            return;
+        }
+        const auto numeric = (value[0] >= '0' && value[0] <= '9') || value[0] == '-';
+        if (numeric)
+        {
+            m_xml << "    <" << element << ">" << value << "</" << element << ">\n";
+        }
+        else
+        {
+            m_xml << "    <p" << element << ">" << value << "</p" << element << ">\n";
+        }
+    }
+
+    const char* m_portName;
+    std::ostringstream m_xml;
+};
+
+// The system, interface and local device modules only describe themselves
+std::string moduleXml(const char* modelName, const char* productGuid, const char* versionGuid, const char* portName,
+    const char* prefix)
+{
+    XmlWriter xml(modelName, productGuid, versionGuid, portName);
+
+    const std::string id = std::string(prefix) + "ID";
+    const std::string vendor = std::string(prefix) + "VendorName";
+    const std::string model = std::string(prefix) + "ModelName";
+    const std::string version = std::string(prefix) + "Version";
+    const std::string type = std::string(prefix) + "Type";
+    const std::string serial = std::string(prefix) + "SerialNumber";
+
+    xml.Category("Root", { id.c_str(), vendor.c_str(), model.c_str(), version.c_str(), type.c_str(), serial.c_str() });
+    xml.StringReg(id.c_str(), Module::ID, "RO");
+    xml.StringReg(vendor.c_str(), Module::VendorName, "RO");
+    xml.StringReg(model.c_str(), Module::ModelName, "RO");
+    xml.StringReg(version.c_str(), Module::Version, "RO");
+    xml.StringReg(type.c_str(), Module::Type, "RO");
+    xml.StringReg(serial.c_str(), Module::SerialNumber, "RO");
+
+    return xml.Finish();
+}
+
+std::string dataStreamXml()
+{
+    XmlWriter xml("SyntheticDataStream", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e000004",
+        "5a4e7c01-0d64-4c8e-9a1b-3f2c1e010004", "StreamPort");
+
+    xml.Category("Root",
+        { "StreamID", "StreamBufferHandlingMode", "StreamAnnouncedBufferCount", "StreamAnnounceBufferMinimum",
+            "StreamInputBufferCount", "StreamOutputBufferCount", "StreamStartedFrameCount",
+            "StreamDeliveredFrameCount", "StreamLostFrameCount", "StreamDroppedFrameCount",
+            "StreamIncompleteFrameCount", "StreamIsGrabbing" });
+
+    xml.StringReg("StreamID", Stream::StreamID, "RO");
+    xml.IntReg("StreamBufferHandlingModeReg", Stream::BufferHandlingMode, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("StreamBufferHandlingMode", "StreamBufferHandlingModeReg",
+        { { "OldestFirst", BufferHandling::OldestFirst },
+            { "OldestFirstOverwrite", BufferHandling::OldestFirstOverwrite },
+            { "NewestOnly", BufferHandling::NewestOnly } });
+    xml.IntReg("StreamAnnouncedBufferCount", Stream::AnnouncedBufferCount, "RO");
+    xml.IntReg("StreamAnnounceBufferMinimum", Stream::AnnounceBufferMinimum, "RO");
+    xml.IntReg("StreamInputBufferCount", Stream::InputBufferCount, "RO");
+    xml.IntReg("StreamOutputBufferCount", Stream::OutputBufferCount, "RO");
+    xml.IntReg("StreamStartedFrameCount", Stream::StartedFrameCount, "RO");
+    xml.IntReg("StreamDeliveredFrameCount", Stream::DeliveredFrameCount, "RO");
+    xml.IntReg("StreamLostFrameCount", Stream::LostFrameCount, "RO");
+    xml.IntReg("StreamDroppedFrameCount", Stream::DroppedFrameCount, "RO");
+    xml.IntReg("StreamIncompleteFrameCount", Stream::IncompleteFrameCount, "RO");
+    xml.IntReg("StreamIsGrabbingReg", Stream::IsGrabbing, "RO", nullptr, nullptr, "Invisible");
+    xml.Boolean("StreamIsGrabbing", "StreamIsGrabbingReg");
+
+    return xml.Finish();
+}
+
+std::string remoteDeviceXml()
+{
+    XmlWriter xml("SyntheticCamera", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e000005", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e010005",
+        "Device");
+
+    xml.Category("Root",
+        { "DeviceControl", "ImageFormatControl", "AcquisitionControl", "AnalogControl", "ChunkDataControl",
+            "UserSetControl", "TransportLayerControl" });
+    xml.Category("DeviceControl",
+        { "DeviceVendorName", "DeviceModelName", "DeviceSerialNumber", "DeviceUserID", "SensorName" });
+    xml.Category("ImageFormatControl",
+        { "WidthMax", "HeightMax", "Width", "Height", "OffsetX", "OffsetY", "PixelFormat" });
+    xml.Category("AcquisitionControl",
+        { "AcquisitionMode", "AcquisitionStart", "AcquisitionStop", "AcquisitionFrameRate", "ExposureTime",
+            "ExposureAuto", "TriggerSelector", "TriggerMode", "TriggerSource", "TriggerSoftware" });
+    xml.Category("AnalogControl", { "GainSelector", "Gain", "GainAuto", "BalanceWhiteAuto" });
+    xml.Category("ChunkDataControl",
+        { "ChunkModeActive", "ChunkSelector", "ChunkEnable", "ChunkWidth", "ChunkHeight", "ChunkPixelFormat",
+            "ChunkExposureTime", "ChunkFrameID", "ChunkTimestamp" });
+    xml.Category("UserSetControl", { "UserSetSelector", "UserSetLoad" });
+    xml.Category("TransportLayerControl", { "PayloadSize", "TLParamsLocked" });
+
+    // DeviceControl
+    xml.StringReg("DeviceVendorName", Remote::DeviceVendorName, "RO");
+    xml.StringReg("DeviceModelName", Remote::DeviceModelName, "RO");
+    xml.StringReg("DeviceSerialNumber", Remote::DeviceSerialNumber, "RO");
+    xml.StringReg("DeviceUserID", Remote::DeviceUserID, "RW");
+    xml.StringReg("SensorName", Remote::SensorName, "RO");
+
+    // ImageFormatControl. Width, Height and the offsets move in steps of 2 so the Bayer phase never changes.
+    xml.IntReg("WidthMax", Remote::WidthMax, "RO");
+    xml.IntReg("HeightMax", Remote::HeightMax, "RO");
+    xml.IntReg("WidthReg", Remote::Width, "RW", nullptr, nullptr, "Invisible");
+    xml.IntReg("HeightReg", Remote::Height, "RW", nullptr, nullptr, "Invisible");
+    xml.IntReg("OffsetXReg", Remote::OffsetX, "RW", nullptr, nullptr, "Invisible");
+    xml.IntReg("OffsetYReg", Remote::OffsetY, "RW", nullptr, nullptr, "Invisible");
+    xml.IntSwissKnife("WidthMaxCurrent", { { "MAX", "WidthMax" }, { "OFFSET", "OffsetXReg" } }, "MAX-OFFSET");
+    xml.IntSwissKnife("HeightMaxCurrent", { { "MAX", "HeightMax" }, { "OFFSET", "OffsetYReg" } }, "MAX-OFFSET");
+    xml.IntSwissKnife("OffsetXMax", { { "MAX", "WidthMax" }, { "SIZE", "WidthReg" } }, "MAX-SIZE");
+    xml.IntSwissKnife("OffsetYMax", { { "MAX", "HeightMax" }, { "SIZE", "HeightReg" } }, "MAX-SIZE");
+    xml.Integer("Width", "WidthReg", "16", "WidthMaxCurrent", "2", "TLParamsLocked");
+    xml.Integer("Height", "HeightReg", "16", "HeightMaxCurrent", "2", "TLParamsLocked");
+    xml.Integer("OffsetX", "OffsetXReg", "0", "OffsetXMax", "2", "TLParamsLocked");
+    xml.Integer("OffsetY", "OffsetYReg", "0", "OffsetYMax", "2", "TLParamsLocked");
+    xml.IntReg("PixelFormatReg", Remote::PixelFormat, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("PixelFormat", "PixelFormatReg",
+        { { "Mono8", PixelFormat::Mono8 }, { "BayerGR8", PixelFormat::BayerGR8 },
+            { "BayerRG8", PixelFormat::BayerRG8 }, { "BayerGB8", PixelFormat::BayerGB8 },
+            { "BayerBG8", PixelFormat::BayerBG8 } },
+        {}, "TLParamsLocked");
+
+    // AcquisitionControl
+    xml.IntReg("AcquisitionModeReg", Remote::AcquisitionMode, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("AcquisitionMode", "AcquisitionModeReg", { { "Continuous", 0 } });
+    xml.IntReg("AcquisitionStartReg", Remote::AcquisitionStart, "RW", nullptr, nullptr, "Invisible");
+    xml.Command("AcquisitionStart", "AcquisitionStartReg");
+    xml.IntReg("AcquisitionStopReg", Remote::AcquisitionStop, "RW", nullptr, nullptr, "Invisible");
+    xml.Command("AcquisitionStop", "AcquisitionStopReg");
+    xml.FloatReg("AcquisitionFrameRateReg", Remote::AcquisitionFrameRate, "RW");
+    xml.FloatReg("AcquisitionFrameRateMax", Remote::AcquisitionFrameRateMax, "RO");
+    xml.Float("AcquisitionFrameRate", "AcquisitionFrameRateReg", "0.5", "AcquisitionFrameRateMax", "Hz");
+    xml.FloatReg("ExposureTimeReg", Remote::ExposureTime, "RW");
+    xml.Float("ExposureTime", "ExposureTimeReg", "10", "2000000", "us");
+    xml.IntReg("ExposureAutoReg", Remote::ExposureAuto, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("ExposureAuto", "ExposureAutoReg", { { "Off", 0 }, { "Continuous", 1 } });
+    xml.IntReg("TriggerSelectorReg", Remote::TriggerSelector, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("TriggerSelector", "TriggerSelectorReg",
+        { { "ExposureStart", Trigger::ExposureStart }, { "FrameStart", Trigger::FrameStart } },
+        { "TriggerMode", "TriggerSource", "TriggerSoftware" });
+    xml.IntReg("TriggerModeReg", Remote::TriggerMode, "RW", "TriggerSelectorReg", nullptr, "Invisible");
+    xml.Enumeration("TriggerMode", "TriggerModeReg", { { "Off", 0 }, { "On", 1 } });
+    xml.IntReg("TriggerSourceReg", Remote::TriggerSource, "RW", "TriggerSelectorReg", nullptr, "Invisible");
+    xml.Enumeration("TriggerSource", "TriggerSourceReg",
+        { { "Software", Trigger::SourceSoftware }, { "Line0", Trigger::SourceLine0 } });
+    xml.IntReg("TriggerSoftwareReg", Remote::TriggerSoftware, "RW", "TriggerSelectorReg", nullptr, "Invisible");
+    xml.Command("TriggerSoftware", "TriggerSoftwareReg");
+
+    // AnalogControl. Accepted for compatibility with the samples, the test pattern does not change.
+    xml.IntReg("GainSelectorReg", Remote::GainSelector, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("GainSelector", "GainSelectorReg", { { "AnalogAll", 0 } }, { "Gain" });
+    xml.FloatReg("GainReg", Remote::Gain, "RW");
+    xml.Float("Gain", "GainReg", "1", "16", "");
+    xml.IntReg("GainAutoReg", Remote::GainAuto, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("GainAuto", "GainAutoReg", { { "Off", 0 }, { "Continuous", 1 } });
+    xml.IntReg("BalanceWhiteAutoReg", Remote::BalanceWhiteAuto, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("BalanceWhiteAuto", "BalanceWhiteAutoReg", { { "Off", 0 }, { "Continuous", 1 } });
+
+    // ChunkDataControl. The chunk always carries every value, ChunkEnable is only remembered.
+    xml.IntReg("ChunkModeActiveReg", Remote::ChunkModeActive, "RW", nullptr, nullptr, "Invisible");
+    xml.Boolean("ChunkModeActive", "ChunkModeActiveReg");
+    xml.IntReg("ChunkSelectorReg", Remote::ChunkSelector, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("ChunkSelector", "ChunkSelectorReg",
+        { { "Width", 0 }, { "Height", 1 }, { "PixelFormat", 2 }, { "ExposureTime", 3 }, { "FrameID", 4 },
+            { "Timestamp", 5 } },
+        { "ChunkEnable" });
+    xml.IntReg("ChunkEnableReg", Remote::ChunkEnable, "RW", "ChunkSelectorReg", nullptr, "Invisible");
+    xml.Boolean("ChunkEnable", "ChunkEnableReg");
+    xml.ChunkPort("ChunkPort", Chunk::Id);
+    xml.IntReg("ChunkWidth", Chunk::Width, "RO", nullptr, "ChunkPort");
+    xml.IntReg("ChunkHeight", Chunk::Height, "RO", nullptr, "ChunkPort");
+    xml.IntReg("ChunkPixelFormatReg", Chunk::PixelFormat, "RO", nullptr, "ChunkPort", "Invisible");
+    xml.Enumeration("ChunkPixelFormat", "ChunkPixelFormatReg",
+        { { "Mono8", PixelFormat::Mono8 }, { "BayerGR8", PixelFormat::BayerGR8 },
+            { "BayerRG8", PixelFormat::BayerRG8 }, { "BayerGB8", PixelFormat::BayerGB8 },
+            { "BayerBG8", PixelFormat::BayerBG8 } });
+    xml.FloatReg("ChunkExposureTime", Chunk::ExposureTime, "RO", "ChunkPort");
+    xml.IntReg("ChunkFrameID", Chunk::FrameID, "RO", nullptr, "ChunkPort");
+    xml.IntReg("ChunkTimestamp", Chunk::Timestamp, "RO", nullptr, "ChunkPort");
+
+    // UserSetControl
+    xml.IntReg("UserSetSelectorReg", Remote::UserSetSelector, "RW", nullptr, nullptr, "Invisible");
+    xml.Enumeration("UserSetSelector", "UserSetSelectorReg", { { "Default", 0 } }, { "UserSetLoad" });
+    xml.IntReg("UserSetLoadReg", Remote::UserSetLoad, "RW", nullptr, nullptr, "Invisible");
+    xml.Command("UserSetLoad", "UserSetLoadReg");
+
+    // TransportLayerControl
+    xml.IntReg("PayloadSize", Remote::PayloadSize, "RO");
+    xml.IntReg("TLParamsLockedReg", Remote::TLParamsLocked, "RW", nullptr, nullptr, "Invisible");
+    xml.Integer("TLParamsLocked", "TLParamsLockedReg", "0", "1", nullptr, nullptr, "Invisible");
+
+    return xml.Finish();
+}
+
+} // namespace
+
+const std::string& SystemXml()
+{
+    static const auto xml = moduleXml("SyntheticSystem", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e000001",
+        "5a4e7c01-0d64-4c8e-9a1b-3f2c1e010001", "TLPort", "TL");
+    return xml;
+}
+
+const std::string& InterfaceXml()
+{
+    static const auto xml = moduleXml("SyntheticInterface", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e000002",
+        "5a4e7c01-0d64-4c8e-9a1b-3f2c1e010002", "InterfacePort", "Interface");
+    return xml;
+}
+
+const std::string& LocalDeviceXml()
+{
+    static const auto xml = moduleXml("SyntheticLocalDevice", "5a4e7c01-0d64-4c8e-9a1b-3f2c1e000003",
+        "5a4e7c01-0d64-4c8e-9a1b-3f2c1e010003", "TLDevicePort", "Device");
+    return xml;
+}
+
+const std::string& DataStreamXml()
+{
+    static const auto xml = dataStreamXml();
+    return xml;
+}
+
+const std::string& RemoteDeviceXml()
+{
+    static const auto xml = remoteDeviceXml();
+    return xml;
+}
+
+} // namespace synthetic
@@ -0,0 +1,30 @@
+/*!
+ * \file    nodemaps.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   GenApi descriptions of the synthetic GenTL producer modules. They
+ *          are served through the "local:" URL of each port.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef NODEMAPS_H
+#define NODEMAPS_H
+
+#include <string>
+
+
+namespace synthetic
+{
+
+const std::string& SystemXml();
+const std::string& InterfaceXml();
+const std::string& LocalDeviceXml();
+const std::string& DataStreamXml();
+const std::string& RemoteDeviceXml();
+
+} // namespace synthetic
+
+#endif // NODEMAPS_H
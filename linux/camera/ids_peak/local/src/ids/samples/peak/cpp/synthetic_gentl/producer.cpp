@@ -0,0 +1,1876 @@
+/*!
+ * \file    producer.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Modules of the synthetic GenTL producer: one system with one
+ *          interface and a configurable number of simulated cameras. Each
+ *          camera has a remote nodemap and one data stream that fills the
+ *          announced buffers with a Bayer test pattern, free running at
+ *          AcquisitionFrameRate or on TriggerSoftware.
+ *
+ * \version 1.0.0
+ */
+
+#include "producer.h"
+
+#include "nodemaps.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#    include <malloc.h>
+#else
+#    include <dlfcn.h>
+#endif
+
+
+namespace synthetic
+{
+
+namespace
+{
+
+const char* const vendorName = "IoTReady";
+const char* const version = "1.0.0";
+const char* const streamId = "Stream0";
+
+// Alignment of the buffers allocated by DSAllocAndAnnounceBuffer, a page so they can be locked or mapped cheaply
+constexpr size_t allocationAlignment = 4096;
+// Alignment reported to consumers that allocate their own buffers
+constexpr size_t reportedAlignment = 64;
+
+std::mutex& registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<const Handle*>& registry()
+{
+    static std::unordered_set<const Handle*> handles;
+    return handles;
+}
+
+uint64_t nowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+std::string hex(uint64_t value)
+{
+    std::ostringstream stream;
+    stream << std::hex << std::uppercase << value;
+    return stream.str();
+}
+
+bool inArray(uint64_t address, uint64_t base, size_t count, size_t& index)
+{
+    if (address < base || address >= base + count * 8 || (address - base) % 8 != 0)
+    {
+        return false;
+    }
+    index = static_cast<size_t>((address - base) / 8);
+    return true;
+}
+
+uint64_t parseUnsigned(const char* name, uint64_t fallback)
+{
+    const auto* value = std::getenv(name);
+    if (!value || !*value)
+    {
+        return fallback;
+    }
+    char* end = nullptr;
+    const auto parsed = std::strtoull(value, &end, 0);
+    return (end && *end == '\0' && parsed > 0) ? parsed : fallback;
+}
+
+double parseDouble(const char* name, double fallback)
+{
+    const auto* value = std::getenv(name);
+    if (!value || !*value)
+    {
+        return fallback;
+    }
+    char* end = nullptr;
+    const auto parsed = std::strtod(value, &end);
+    return (end && *end == '\0' && parsed > 0) ? parsed : fallback;
+}
+
+uint64_t parsePixelFormat(const char* name, uint64_t fallback)
+{
+    const auto* value = std::getenv(name);
+    if (!value)
+    {
+        return fallback;
+    }
+    const std::string format(value);
+    if (format == "Mono8")
+    {
+        return PixelFormat::Mono8;
+    }
+    if (format == "BayerGR8")
+    {
+        return PixelFormat::BayerGR8;
+    }
+    if (format == "BayerRG8")
+    {
+        return PixelFormat::BayerRG8;
+    }
+    if (format == "BayerGB8")
+    {
+        return PixelFormat::BayerGB8;
+    }
+    if (format == "BayerBG8")
+    {
+        return PixelFormat::BayerBG8;
+    }
+    return fallback;
+}
+
+void* allocateAligned(size_t size)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(size, allocationAlignment);
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, allocationAlignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+void freeAligned(void* memory)
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+std::string libraryPath()
+{
+#if defined(_WIN32)
+    return "synthetic_gentl.cti";
+#else
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&libraryPath), &info) && info.dli_fname)
+    {
+        return info.dli_fname;
+    }
+    return "synthetic_gentl.cti";
+#endif
+}
+
+} // namespace
+
+
+GenTLError::GenTLError(GC_ERROR code, const std::string& message)
+    : std::runtime_error(message)
+    , m_code(code)
+{}
+
+GC_ERROR GenTLError::Code() const
+{
+    return m_code;
+}
+
+
+Config Config::FromEnvironment()
+{
+    Config config;
+    config.deviceCount = static_cast<size_t>(parseUnsigned("SYNTHETIC_GENTL_DEVICES", config.deviceCount));
+    // Sensor sizes are kept even, so every ROI starts on the same Bayer phase
+    config.sensorWidth =
+        std::max<size_t>(16, static_cast<size_t>(parseUnsigned("SYNTHETIC_GENTL_WIDTH", config.sensorWidth)) & ~1u);
+    config.sensorHeight =
+        std::max<size_t>(16, static_cast<size_t>(parseUnsigned("SYNTHETIC_GENTL_HEIGHT", config.sensorHeight)) & ~1u);
+    config.pixelFormat = parsePixelFormat("SYNTHETIC_GENTL_PIXELFORMAT", config.pixelFormat);
+    config.frameRateMax = parseDouble("SYNTHETIC_GENTL_FRAMERATE_MAX", config.frameRateMax);
+    config.frameRate = std::min(parseDouble("SYNTHETIC_GENTL_FRAMERATE", config.frameRate), config.frameRateMax);
+    return config;
+}
+
+
+InfoTarget::InfoTarget(INFO_DATATYPE* type, void* buffer, size_t* size)
+    : m_type(type)
+    , m_buffer(buffer)
+    , m_size(size)
+{}
+
+void InfoTarget::String(const std::string& value)
+{
+    set(INFO_DATATYPE_STRING, value.c_str(), value.size() + 1);
+}
+
+void InfoTarget::Int32(int32_t value)
+{
+    set(INFO_DATATYPE_INT32, &value, sizeof(value));
+}
+
+void InfoTarget::UInt32(uint32_t value)
+{
+    set(INFO_DATATYPE_UINT32, &value, sizeof(value));
+}
+
+void InfoTarget::UInt64(uint64_t value)
+{
+    set(INFO_DATATYPE_UINT64, &value, sizeof(value));
+}
+
+void InfoTarget::SizeT(size_t value)
+{
+    set(INFO_DATATYPE_SIZET, &value, sizeof(value));
+}
+
+void InfoTarget::Bool(bool value)
+{
+    const bool8_t flag = value;
+    set(INFO_DATATYPE_BOOL8, &flag, sizeof(flag));
+}
+
+void InfoTarget::Float64(double value)
+{
+    set(INFO_DATATYPE_FLOAT64, &value, sizeof(value));
+}
+
+void InfoTarget::Ptr(const void* value)
+{
+    set(INFO_DATATYPE_PTR, &value, sizeof(value));
+}
+
+void InfoTarget::set(INFO_DATATYPE type, const void* value, size_t size)
+{
+    if (m_type)
+    {
+        *m_type = type;
+    }
+    if (!m_size)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "piSize must not be NULL");
+    }
+    if (!m_buffer)
+    {
+        *m_size = size;
+        return;
+    }
+    if (*m_size < size)
+    {
+        *m_size = size;
+        throw GenTLError(GC_ERR_BUFFER_TOO_SMALL, "Buffer too small");
+    }
+
+    std::memcpy(m_buffer, value, size);
+    *m_size = size;
+}
+
+
+Handle::Handle()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().insert(this);
+}
+
+Handle::~Handle()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().erase(this);
+}
+
+void* Handle::AsHandle()
+{
+    return static_cast<Handle*>(this);
+}
+
+Handle* ResolveHandle(void* handle)
+{
+    if (!handle)
+    {
+        throw GenTLError(GC_ERR_INVALID_HANDLE, "Handle is NULL");
+    }
+
+    auto* candidate = static_cast<Handle*>(handle);
+    std::lock_guard<std::mutex> lock(registryMutex());
+    if (registry().find(candidate) == registry().end())
+    {
+        throw GenTLError(GC_ERR_INVALID_HANDLE, "Unknown handle");
+    }
+    return candidate;
+}
+
+
+Port::Port(std::string moduleName, std::string portName, const std::string* xml, size_t registerSize)
+    : m_registers(registerSize)
+    , m_moduleName(std::move(moduleName))
+    , m_portName(std::move(portName))
+    , m_xml(xml)
+{}
+
+void Port::Read(uint64_t address, void* data, size_t size)
+{
+    if (!data)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "pBuffer must not be NULL");
+    }
+
+    if (m_xml && address >= XmlAddress)
+    {
+        const auto offset = address - XmlAddress;
+        if (offset + size > m_xml->size())
+        {
+            throw GenTLError(GC_ERR_INVALID_ADDRESS, "Read beyond the end of the XML");
+        }
+        std::memcpy(data, m_xml->data() + offset, size);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (address + size > m_registers.size())
+    {
+        throw GenTLError(GC_ERR_INVALID_ADDRESS, "Invalid register address 0x" + hex(address));
+    }
+    beforeRead(address, size);
+    std::memcpy(data, m_registers.data() + address, size);
+}
+
+void Port::Write(uint64_t address, const void* data, size_t size)
+{
+    if (!data)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "pBuffer must not be NULL");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (address + size > m_registers.size())
+    {
+        throw GenTLError(GC_ERR_INVALID_ADDRESS, "Invalid register address 0x" + hex(address));
+    }
+    write(address, data, size);
+}
+
+const std::string& Port::ModuleName() const
+{
+    return m_moduleName;
+}
+
+const std::string& Port::PortName() const
+{
+    return m_portName;
+}
+
+uint32_t Port::UrlCount() const
+{
+    return m_xml ? 1 : 0;
+}
+
+std::string Port::Url() const
+{
+    if (!m_xml)
+    {
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "This port has no XML description");
+    }
+    return "local:///" + m_portName + ".xml;" + hex(XmlAddress) + ";" + hex(m_xml->size())
+        + "?SchemaVersion=1.1.0";
+}
+
+void Port::GetUrlInfo(uint32_t index, URL_INFO_CMD command, InfoTarget target) const
+{
+    if (index >= UrlCount())
+    {
+        throw GenTLError(GC_ERR_INVALID_INDEX, "Invalid URL index");
+    }
+
+    switch (command)
+    {
+    case URL_INFO_URL:
+        return target.String(Url());
+    case URL_INFO_SCHEMA_VER_MAJOR:
+        return target.Int32(1);
+    case URL_INFO_SCHEMA_VER_MINOR:
+        return target.Int32(1);
+    case URL_INFO_FILE_VER_MAJOR:
+        return target.Int32(1);
+    case URL_INFO_FILE_VER_MINOR:
+    case URL_INFO_FILE_VER_SUBMINOR:
+        return target.Int32(0);
+    case URL_INFO_FILE_REGISTER_ADDRESS:
+        return target.UInt64(XmlAddress);
+    case URL_INFO_FILE_SIZE:
+        return target.UInt64(m_xml->size());
+    case URL_INFO_SCHEME:
+        return target.Int32(URL_SCHEME_LOCAL);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "URL info not available");
+    }
+}
+
+void Port::GetPortInfo(PORT_INFO_CMD command, InfoTarget target) const
+{
+    switch (command)
+    {
+    case PORT_INFO_ID:
+        return target.String(Id());
+    case PORT_INFO_VENDOR:
+        return target.String(vendorName);
+    case PORT_INFO_MODEL:
+        return target.String("Synthetic Camera");
+    case PORT_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    case PORT_INFO_MODULE:
+        return target.String(m_moduleName);
+    case PORT_INFO_LITTLE_ENDIAN:
+        return target.Bool(true);
+    case PORT_INFO_BIG_ENDIAN:
+        return target.Bool(false);
+    case PORT_INFO_ACCESS_READ:
+    case PORT_INFO_ACCESS_WRITE:
+        return target.Bool(true);
+    case PORT_INFO_ACCESS_NA:
+    case PORT_INFO_ACCESS_NI:
+        return target.Bool(false);
+    case PORT_INFO_VERSION:
+        return target.String(version);
+    case PORT_INFO_PORTNAME:
+        return target.String(m_portName);
+    default:
+        throw GenTLError(GC_ERR_NOT_IMPLEMENTED, "Unknown port info command");
+    }
+}
+
+void Port::beforeRead(uint64_t, size_t)
+{}
+
+void Port::write(uint64_t address, const void*, size_t)
+{
+    throw GenTLError(GC_ERR_ACCESS_DENIED, "Register 0x" + hex(address) + " is read-only");
+}
+
+uint64_t Port::getInt(uint64_t address) const
+{
+    uint64_t value = 0;
+    std::memcpy(&value, m_registers.data() + address, sizeof(value));
+    return value;
+}
+
+void Port::setInt(uint64_t address, uint64_t value)
+{
+    std::memcpy(m_registers.data() + address, &value, sizeof(value));
+}
+
+double Port::getFloat(uint64_t address) const
+{
+    double value = 0;
+    std::memcpy(&value, m_registers.data() + address, sizeof(value));
+    return value;
+}
+
+void Port::setFloat(uint64_t address, double value)
+{
+    std::memcpy(m_registers.data() + address, &value, sizeof(value));
+}
+
+void Port::setString(uint64_t address, const std::string& value)
+{
+    auto* target = m_registers.data() + address;
+    std::memset(target, 0, StringLength);
+    std::memcpy(target, value.data(), std::min(value.size(), StringLength - 1));
+}
+
+
+Event::Event(EVENT_TYPE type)
+    : m_type(type)
+{}
+
+EVENT_TYPE Event::Type() const
+{
+    return m_type;
+}
+
+void Event::GetData(void*, size_t*, uint64_t timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto killed = [this] { return m_pendingKills > 0; };
+    if (timeout == GENTL_INFINITE)
+    {
+        m_condition.wait(lock, killed);
+    }
+    else if (!m_condition.wait_for(lock, std::chrono::milliseconds(timeout), killed))
+    {
+        throw GenTLError(GC_ERR_TIMEOUT, "Timeout");
+    }
+
+    m_pendingKills--;
+    throw GenTLError(GC_ERR_ABORT, "Wait aborted");
+}
+
+void Event::Kill()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingKills++;
+    }
+    m_condition.notify_all();
+}
+
+void Event::Flush()
+{}
+
+size_t Event::NumInQueue() const
+{
+    return 0;
+}
+
+uint64_t Event::NumFired() const
+{
+    return 0;
+}
+
+size_t Event::DataSizeMax() const
+{
+    return 0;
+}
+
+
+Buffer::Buffer(DataStream& stream, void* base, size_t size, void* userPointer, bool ownsMemory)
+    : Port("TLBuffer", "TLBufferPort", nullptr, 0)
+    , stream(stream)
+    , base(static_cast<uint8_t*>(base))
+    , size(size)
+    , userPointer(userPointer)
+    , ownsMemory(ownsMemory)
+{}
+
+Buffer::~Buffer()
+{
+    if (ownsMemory)
+    {
+        freeAligned(base);
+    }
+}
+
+std::string Buffer::Id() const
+{
+    return "Buffer" + hex(reinterpret_cast<uintptr_t>(this));
+}
+
+void Buffer::GetInfo(BUFFER_INFO_CMD command, InfoTarget target)
+{
+    std::lock_guard<std::mutex> lock(stream.Mutex());
+
+    const auto imageSize = geometry.width * geometry.height;
+
+    switch (command)
+    {
+    case BUFFER_INFO_BASE:
+        return target.Ptr(base);
+    case BUFFER_INFO_SIZE:
+        return target.SizeT(size);
+    case BUFFER_INFO_USER_PTR:
+        return target.Ptr(userPointer);
+    case BUFFER_INFO_TIMESTAMP:
+    case BUFFER_INFO_TIMESTAMP_NS:
+        return target.UInt64(timestamp_ns);
+    case BUFFER_INFO_NEW_DATA:
+        return target.Bool(newData);
+    case BUFFER_INFO_IS_QUEUED:
+        return target.Bool(state == State::Input || state == State::Output);
+    case BUFFER_INFO_IS_ACQUIRING:
+        return target.Bool(state == State::Filling);
+    case BUFFER_INFO_IS_INCOMPLETE:
+        return target.Bool(incomplete);
+    case BUFFER_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    case BUFFER_INFO_SIZE_FILLED:
+    case BUFFER_INFO_DATA_SIZE:
+        return target.SizeT(sizeFilled);
+    case BUFFER_INFO_WIDTH:
+        return target.SizeT(geometry.width);
+    case BUFFER_INFO_HEIGHT:
+        return target.SizeT(geometry.height);
+    case BUFFER_INFO_XOFFSET:
+        return target.SizeT(geometry.offsetX);
+    case BUFFER_INFO_YOFFSET:
+        return target.SizeT(geometry.offsetY);
+    case BUFFER_INFO_XPADDING:
+    case BUFFER_INFO_YPADDING:
+        return target.SizeT(0);
+    case BUFFER_INFO_FRAMEID:
+        return target.UInt64(frameId);
+    case BUFFER_INFO_IMAGEPRESENT:
+        return target.Bool(true);
+    case BUFFER_INFO_IMAGEOFFSET:
+        return target.SizeT(0);
+    case BUFFER_INFO_PAYLOADTYPE:
+        return target.SizeT(PAYLOAD_TYPE_IMAGE);
+    case BUFFER_INFO_PIXELFORMAT:
+        return target.UInt64(geometry.pixelFormat);
+    case BUFFER_INFO_PIXELFORMAT_NAMESPACE:
+        return target.UInt64(PIXELFORMAT_NAMESPACE_PFNC_32BIT);
+    case BUFFER_INFO_DELIVERED_IMAGEHEIGHT:
+        return target.SizeT(geometry.width ? std::min(sizeFilled, imageSize) / geometry.width : 0);
+    case BUFFER_INFO_DELIVERED_CHUNKPAYLOADSIZE:
+        return target.SizeT(chunkSize);
+    case BUFFER_INFO_CHUNKLAYOUTID:
+        return target.UInt64(chunkSize ? 1 : 0);
+    case BUFFER_INFO_PIXEL_ENDIANNESS:
+        return target.Int32(PIXELENDIANNESS_LITTLE);
+    case BUFFER_INFO_DATA_LARGER_THAN_BUFFER:
+        return target.Bool(dataLargerThanBuffer);
+    case BUFFER_INFO_CONTAINS_CHUNKDATA:
+        return target.Bool(chunkSize != 0);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "Buffer info not available");
+    }
+}
+
+void Buffer::GetChunkData(SINGLE_CHUNK_DATA* chunkData, size_t* numChunks)
+{
+    if (!numChunks)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "piNumChunks must not be NULL");
+    }
+
+    std::lock_guard<std::mutex> lock(stream.Mutex());
+    if (!chunkSize)
+    {
+        *numChunks = 0;
+        return;
+    }
+    if (!chunkData)
+    {
+        *numChunks = 1;
+        return;
+    }
+    if (*numChunks < 1)
+    {
+        *numChunks = 1;
+        throw GenTLError(GC_ERR_BUFFER_TOO_SMALL, "Buffer too small");
+    }
+
+    chunkData[0].ChunkID = Chunk::Id;
+    chunkData[0].ChunkOffset = static_cast<ptrdiff_t>(geometry.width * geometry.height);
+    chunkData[0].ChunkLength = chunkSize;
+    *numChunks = 1;
+}
+
+
+RemoteDevice::RemoteDevice(const Config& config, std::string serialNumber)
+    : Port(TLRemoteDeviceModuleName, "Device", &RemoteDeviceXml(), Remote::Size)
+    , m_config(config)
+    , m_serialNumber(std::move(serialNumber))
+{
+    loadDefaults();
+}
+
+std::string RemoteDevice::Id() const
+{
+    return m_serialNumber;
+}
+
+std::mutex& RemoteDevice::Mutex()
+{
+    return m_mutex;
+}
+
+std::condition_variable& RemoteDevice::Changed()
+{
+    return m_changed;
+}
+
+RemoteDevice::Settings RemoteDevice::CurrentSettings() const
+{
+    Settings settings;
+    settings.geometry.pixelFormat = getInt(Remote::PixelFormat);
+    settings.geometry.sensorWidth = static_cast<size_t>(getInt(Remote::WidthMax));
+    settings.geometry.sensorHeight = static_cast<size_t>(getInt(Remote::HeightMax));
+    settings.geometry.width = static_cast<size_t>(getInt(Remote::Width));
+    settings.geometry.height = static_cast<size_t>(getInt(Remote::Height));
+    settings.geometry.offsetX = static_cast<size_t>(getInt(Remote::OffsetX));
+    settings.geometry.offsetY = static_cast<size_t>(getInt(Remote::OffsetY));
+    settings.frameRate = getFloat(Remote::AcquisitionFrameRate);
+    settings.exposureTime_us = getFloat(Remote::ExposureTime);
+    settings.triggered = IsTriggered();
+    settings.chunks = getInt(Remote::ChunkModeActive) != 0;
+    return settings;
+}
+
+bool RemoteDevice::IsAcquiring() const
+{
+    return m_acquiring;
+}
+
+bool RemoteDevice::IsTriggered() const
+{
+    for (size_t i = 0; i < Remote::TriggerSelectorCount; ++i)
+    {
+        if (getInt(Remote::TriggerMode + i * 8))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RemoteDevice::TriggerPending() const
+{
+    return m_triggerPending;
+}
+
+bool RemoteDevice::TakeTrigger()
+{
+    const auto pending = m_triggerPending;
+    m_triggerPending = false;
+    return pending;
+}
+
+uint64_t RemoteDevice::AcquisitionGeneration() const
+{
+    return m_acquisitionGeneration;
+}
+
+void RemoteDevice::write(uint64_t address, const void* data, size_t size)
+{
+    if (address >= Remote::DeviceUserID && address + size <= Remote::DeviceUserID + StringLength)
+    {
+        std::memcpy(m_registers.data() + address, data, size);
+        m_registers[Remote::DeviceUserID + StringLength - 1] = 0;
+        return;
+    }
+
+    if (size != 8 || address % 8 != 0)
+    {
+        throw GenTLError(GC_ERR_INVALID_ADDRESS, "Registers are written as a whole");
+    }
+
+    uint64_t value = 0;
+    double floatValue = 0;
+    std::memcpy(&value, data, sizeof(value));
+    std::memcpy(&floatValue, data, sizeof(floatValue));
+
+    const auto invalid = [](const char* feature) {
+        throw GenTLError(GC_ERR_INVALID_VALUE, std::string("Invalid value for ") + feature);
+    };
+
+    size_t index = 0;
+    if (address == Remote::Width || address == Remote::OffsetX)
+    {
+        checkUnlocked();
+        const auto width = address == Remote::Width ? value : getInt(Remote::Width);
+        const auto offsetX = address == Remote::OffsetX ? value : getInt(Remote::OffsetX);
+        if (width < 16 || width % 2 || offsetX % 2 || width + offsetX > getInt(Remote::WidthMax))
+        {
+            invalid(address == Remote::Width ? "Width" : "OffsetX");
+        }
+        setInt(address, value);
+        updatePayloadSize();
+    }
+    else if (address == Remote::Height || address == Remote::OffsetY)
+    {
+        checkUnlocked();
+        const auto height = address == Remote::Height ? value : getInt(Remote::Height);
+        const auto offsetY = address == Remote::OffsetY ? value : getInt(Remote::OffsetY);
+        if (height < 16 || height % 2 || offsetY % 2 || height + offsetY > getInt(Remote::HeightMax))
+        {
+            invalid(address == Remote::Height ? "Height" : "OffsetY");
+        }
+        setInt(address, value);
+        updatePayloadSize();
+    }
+    else if (address == Remote::PixelFormat)
+    {
+        checkUnlocked();
+        if (!TestPattern::IsSupported(value))
+        {
+            invalid("PixelFormat");
+        }
+        setInt(address, value);
+    }
+    else if (address == Remote::AcquisitionMode)
+    {
+        if (value != 0)
+        {
+            invalid("AcquisitionMode");
+        }
+    }
+    else if (address == Remote::AcquisitionStart)
+    {
+        // Commands are self-clearing, the register always reads 0 so IsDone is true right away
+        if (value == 1 && !m_acquiring)
+        {
+            m_acquiring = true;
+            m_triggerPending = false;
+            m_acquisitionGeneration++;
+            m_changed.notify_all();
+        }
+    }
+    else if (address == Remote::AcquisitionStop)
+    {
+        if (value == 1)
+        {
+            m_acquiring = false;
+            m_triggerPending = false;
+            m_changed.notify_all();
+        }
+    }
+    else if (address == Remote::AcquisitionFrameRate)
+    {
+        if (!(floatValue >= 0.5 && floatValue <= getFloat(Remote::AcquisitionFrameRateMax)))
+        {
+            invalid("AcquisitionFrameRate");
+        }
+        setFloat(address, floatValue);
+    }
+    else if (address == Remote::ExposureTime)
+    {
+        if (!(floatValue >= 10.0 && floatValue <= 2000000.0))
+        {
+            invalid("ExposureTime");
+        }
+        setFloat(address, floatValue);
+    }
+    else if (address == Remote::ExposureAuto || address == Remote::GainAuto || address == Remote::BalanceWhiteAuto
+        || address == Remote::TLParamsLocked)
+    {
+        if (value > 1)
+        {
+            invalid("boolean feature");
+        }
+        setInt(address, value);
+    }
+    else if (address == Remote::TriggerSelector)
+    {
+        if (value >= Remote::TriggerSelectorCount)
+        {
+            invalid("TriggerSelector");
+        }
+        setInt(address, value);
+    }
+    else if (inArray(address, Remote::TriggerMode, Remote::TriggerSelectorCount, index)
+        || inArray(address, Remote::TriggerSource, Remote::TriggerSelectorCount, index))
+    {
+        if (value > 1)
+        {
+            invalid("TriggerMode/TriggerSource");
+        }
+        setInt(address, value);
+        m_changed.notify_all();
+    }
+    else if (inArray(address, Remote::TriggerSoftware, Remote::TriggerSelectorCount, index))
+    {
+        // A trigger that arrives while one is still pending is lost, like on a camera that is busy exposing
+        const auto armed = getInt(Remote::TriggerMode + index * 8) == 1
+            && getInt(Remote::TriggerSource + index * 8) == Trigger::SourceSoftware;
+        if (value == 1 && m_acquiring && armed)
+        {
+            m_triggerPending = true;
+            m_changed.notify_all();
+        }
+    }
+    else if (address == Remote::GainSelector || address == Remote::UserSetSelector)
+    {
+        if (value != 0)
+        {
+            invalid("selector");
+        }
+    }
+    else if (address == Remote::Gain)
+    {
+        if (!(floatValue >= 1.0 && floatValue <= 16.0))
+        {
+            invalid("Gain");
+        }
+        setFloat(address, floatValue);
+    }
+    else if (address == Remote::ChunkModeActive)
+    {
+        checkUnlocked();
+        if (value > 1)
+        {
+            invalid("ChunkModeActive");
+        }
+        setInt(address, value);
+        updatePayloadSize();
+    }
+    else if (address == Remote::ChunkSelector)
+    {
+        if (value >= Remote::ChunkSelectorCount)
+        {
+            invalid("ChunkSelector");
+        }
+        setInt(address, value);
+    }
+    else if (inArray(address, Remote::ChunkEnable, Remote::ChunkSelectorCount, index))
+    {
+        if (value > 1)
+        {
+            invalid("ChunkEnable");
+        }
+        setInt(address, value);
+    }
+    else if (address == Remote::UserSetLoad)
+    {
+        if (value == 1)
+        {
+            checkUnlocked();
+            loadDefaults();
+            m_changed.notify_all();
+        }
+    }
+    else
+    {
+        Port::write(address, data, size);
+    }
+}
+
+void RemoteDevice::loadDefaults()
+{
+    // DeviceUserID is not part of a user set
+    const std::string userId(reinterpret_cast<const char*>(m_registers.data() + Remote::DeviceUserID));
+
+    std::fill(m_registers.begin(), m_registers.end(), 0);
+
+    setString(Remote::DeviceVendorName, vendorName);
+    setString(Remote::DeviceModelName, "Synthetic Camera");
+    setString(Remote::DeviceSerialNumber, m_serialNumber);
+    setString(Remote::DeviceUserID, userId);
+    setString(Remote::SensorName, "Synthetic " + std::to_string(m_config.sensorWidth) + "x"
+            + std::to_string(m_config.sensorHeight));
+
+    setInt(Remote::WidthMax, m_config.sensorWidth);
+    setInt(Remote::HeightMax, m_config.sensorHeight);
+    setInt(Remote::Width, m_config.sensorWidth);
+    setInt(Remote::Height, m_config.sensorHeight);
+    setInt(Remote::PixelFormat, m_config.pixelFormat);
+
+    setFloat(Remote::AcquisitionFrameRate, m_config.frameRate);
+    setFloat(Remote::AcquisitionFrameRateMax, m_config.frameRateMax);
+    setFloat(Remote::ExposureTime, 10000.0);
+    setFloat(Remote::Gain, 1.0);
+
+    for (size_t i = 0; i < Remote::TriggerSelectorCount; ++i)
+    {
+        setInt(Remote::TriggerSource + i * 8, Trigger::SourceSoftware);
+    }
+
+    updatePayloadSize();
+}
+
+void RemoteDevice::updatePayloadSize()
+{
+    const auto imageSize = getInt(Remote::Width) * getInt(Remote::Height);
+    setInt(Remote::PayloadSize, imageSize + (getInt(Remote::ChunkModeActive) ? Chunk::Size : 0));
+}
+
+void RemoteDevice::checkUnlocked() const
+{
+    if (getInt(Remote::TLParamsLocked))
+    {
+        throw GenTLError(GC_ERR_ACCESS_DENIED, "TLParamsLocked is set");
+    }
+}
+
+
+class DataStream::NewBufferEvent : public Event
+{
+public:
+    explicit NewBufferEvent(DataStream& stream)
+        : Event(EVENT_NEW_BUFFER)
+        , m_stream(stream)
+    {}
+
+    void GetData(void* buffer, size_t* size, uint64_t timeout) override
+    {
+        if (!buffer || !size)
+        {
+            throw GenTLError(GC_ERR_INVALID_PARAMETER, "pBuffer and piSize must not be NULL");
+        }
+        if (*size < sizeof(EVENT_NEW_BUFFER_DATA))
+        {
+            *size = sizeof(EVENT_NEW_BUFFER_DATA);
+            throw GenTLError(GC_ERR_BUFFER_TOO_SMALL, "Buffer too small");
+        }
+
+        EVENT_NEW_BUFFER_DATA data;
+        m_stream.waitForOutput(*this, timeout, data);
+        std::memcpy(buffer, &data, sizeof(data));
+        *size = sizeof(data);
+    }
+
+    void Kill() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_stream.m_streamMutex);
+            pendingKills++;
+        }
+        m_stream.m_outputCondition.notify_all();
+    }
+
+    void Flush() override
+    {
+        m_stream.FlushQueue(ACQ_QUEUE_OUTPUT_DISCARD);
+    }
+
+    size_t NumInQueue() const override
+    {
+        std::lock_guard<std::mutex> lock(m_stream.m_streamMutex);
+        return m_stream.m_output.size();
+    }
+
+    uint64_t NumFired() const override
+    {
+        std::lock_guard<std::mutex> lock(m_stream.m_streamMutex);
+        return m_stream.m_delivered;
+    }
+
+    size_t DataSizeMax() const override
+    {
+        return sizeof(EVENT_NEW_BUFFER_DATA);
+    }
+
+    // Protected by the stream mutex
+    uint64_t pendingKills = 0;
+
+private:
+    DataStream& m_stream;
+};
+
+
+DataStream::DataStream(RemoteDevice& remoteDevice, void* parentDevice)
+    : Port(TLDataStreamModuleName, "StreamPort", &DataStreamXml(), Stream::Size)
+    , m_remoteDevice(remoteDevice)
+    , m_parentDevice(parentDevice)
+{
+    setString(Stream::StreamID, streamId);
+}
+
+DataStream::~DataStream()
+{
+    StopAcquisition();
+}
+
+std::string DataStream::Id() const
+{
+    return streamId;
+}
+
+void* DataStream::ParentDevice() const
+{
+    return m_parentDevice;
+}
+
+std::mutex& DataStream::Mutex()
+{
+    return m_streamMutex;
+}
+
+Buffer* DataStream::Announce(void* base, size_t size, void* userPointer)
+{
+    if (!base || !size)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "Invalid buffer");
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_buffers.push_back(std::make_unique<Buffer>(*this, base, size, userPointer, false));
+    return m_buffers.back().get();
+}
+
+Buffer* DataStream::AllocAndAnnounce(size_t size, void* userPointer)
+{
+    if (!size)
+    {
+        throw GenTLError(GC_ERR_INVALID_PARAMETER, "Invalid buffer size");
+    }
+
+    auto* memory = allocateAligned(size);
+    if (!memory)
+    {
+        throw GenTLError(GC_ERR_OUT_OF_MEMORY, "Failed to allocate " + std::to_string(size) + " bytes");
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_buffers.push_back(std::make_unique<Buffer>(*this, memory, size, userPointer, true));
+    return m_buffers.back().get();
+}
+
+void DataStream::Revoke(Buffer* buffer, void** base, void** userPointer)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    findBuffer(buffer);
+    if (buffer->state != Buffer::State::Announced)
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Buffer is still queued");
+    }
+
+    if (base)
+    {
+        // Memory allocated by the producer is freed, the consumer gets NULL back
+        *base = buffer->ownsMemory ? nullptr : buffer->base;
+    }
+    if (userPointer)
+    {
+        *userPointer = buffer->userPointer;
+    }
+
+    m_buffers.erase(std::find_if(m_buffers.begin(), m_buffers.end(),
+        [buffer](const std::unique_ptr<Buffer>& announced) { return announced.get() == buffer; }));
+}
+
+void DataStream::Queue(Buffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    findBuffer(buffer);
+    if (buffer->state != Buffer::State::Announced)
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Buffer is already queued");
+    }
+
+    buffer->state = Buffer::State::Input;
+    buffer->newData = false;
+    buffer->sizeFilled = 0;
+    m_input.push_back(buffer);
+}
+
+void DataStream::FlushQueue(ACQ_QUEUE_TYPE operation)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+
+        const auto moveAll = [](std::deque<Buffer*>& from, std::deque<Buffer*>* to, Buffer::State state) {
+            for (auto* buffer : from)
+            {
+                buffer->state = state;
+                if (to)
+                {
+                    to->push_back(buffer);
+                }
+            }
+            from.clear();
+        };
+
+        const auto queueUnqueued = [this] {
+            for (auto& buffer : m_buffers)
+            {
+                if (buffer->state == Buffer::State::Announced)
+                {
+                    buffer->state = Buffer::State::Input;
+                    buffer->newData = false;
+                    buffer->sizeFilled = 0;
+                    m_input.push_back(buffer.get());
+                }
+            }
+        };
+
+        switch (operation)
+        {
+        case ACQ_QUEUE_INPUT_TO_OUTPUT:
+            for (auto* buffer : m_input)
+            {
+                buffer->incomplete = true;
+            }
+            moveAll(m_input, &m_output, Buffer::State::Output);
+            break;
+        case ACQ_QUEUE_OUTPUT_DISCARD:
+            moveAll(m_output, nullptr, Buffer::State::Announced);
+            break;
+        case ACQ_QUEUE_ALL_TO_INPUT:
+            moveAll(m_output, nullptr, Buffer::State::Announced);
+            queueUnqueued();
+            break;
+        case ACQ_QUEUE_UNQUEUED_TO_INPUT:
+            queueUnqueued();
+            break;
+        case ACQ_QUEUE_ALL_DISCARD:
+            moveAll(m_input, nullptr, Buffer::State::Announced);
+            moveAll(m_output, nullptr, Buffer::State::Announced);
+            break;
+        default:
+            throw GenTLError(GC_ERR_INVALID_PARAMETER, "Unknown flush operation");
+        }
+    }
+    m_outputCondition.notify_all();
+}
+
+Buffer* DataStream::BufferAt(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    if (index >= m_buffers.size())
+    {
+        throw GenTLError(GC_ERR_INVALID_INDEX, "Invalid buffer index");
+    }
+    return m_buffers[index].get();
+}
+
+void DataStream::StartAcquisition(uint64_t numToAcquire)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    if (m_grabbing)
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Acquisition is already running");
+    }
+    if (m_buffers.empty())
+    {
+        throw GenTLError(GC_ERR_RESOURCE_EXHAUSTED, "No buffers announced");
+    }
+
+    m_numToAcquire = numToAcquire == GENTL_INFINITE ? 0 : numToAcquire;
+    m_started = 0;
+    m_delivered = 0;
+    m_lost = 0;
+    m_dropped = 0;
+    m_incomplete = 0;
+    m_grabbing = true;
+    m_stopRequested = false;
+    m_generator = std::thread(&DataStream::generate, this);
+}
+
+void DataStream::StopAcquisition()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        if (!m_grabbing)
+        {
+            return;
+        }
+    }
+
+    m_stopRequested = true;
+    {
+        // Taking the mutex orders the flag before the generator's next predicate check
+        std::lock_guard<std::mutex> lock(m_remoteDevice.Mutex());
+    }
+    m_remoteDevice.Changed().notify_all();
+
+    if (m_generator.joinable())
+    {
+        m_generator.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_grabbing = false;
+}
+
+Event* DataStream::RegisterEvent(EVENT_TYPE type)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    if (type == EVENT_NEW_BUFFER)
+    {
+        if (m_newBufferEvent)
+        {
+            throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Event is already registered");
+        }
+        m_newBufferEvent = std::make_unique<NewBufferEvent>(*this);
+        return m_newBufferEvent.get();
+    }
+
+    for (const auto& event : m_otherEvents)
+    {
+        if (event->Type() == type)
+        {
+            throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Event is already registered");
+        }
+    }
+    m_otherEvents.push_back(std::make_unique<Event>(type));
+    return m_otherEvents.back().get();
+}
+
+void DataStream::UnregisterEvent(EVENT_TYPE type)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    if (type == EVENT_NEW_BUFFER)
+    {
+        if (!m_newBufferEvent)
+        {
+            throw GenTLError(GC_ERR_NOT_AVAILABLE, "Event is not registered");
+        }
+        m_newBufferEvent.reset();
+        return;
+    }
+
+    const auto event = std::find_if(m_otherEvents.begin(), m_otherEvents.end(),
+        [type](const std::unique_ptr<Event>& registered) { return registered->Type() == type; });
+    if (event == m_otherEvents.end())
+    {
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "Event is not registered");
+    }
+    m_otherEvents.erase(event);
+}
+
+void DataStream::GetInfo(STREAM_INFO_CMD command, InfoTarget target)
+{
+    if (command == STREAM_INFO_PAYLOAD_SIZE)
+    {
+        uint64_t payloadSize = 0;
+        m_remoteDevice.Read(Remote::PayloadSize, &payloadSize, sizeof(payloadSize));
+        return target.SizeT(static_cast<size_t>(payloadSize));
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    switch (command)
+    {
+    case STREAM_INFO_ID:
+        return target.String(streamId);
+    case STREAM_INFO_NUM_DELIVERED:
+        return target.UInt64(m_delivered);
+    case STREAM_INFO_NUM_UNDERRUN:
+        return target.UInt64(m_lost);
+    case STREAM_INFO_NUM_ANNOUNCED:
+        return target.SizeT(m_buffers.size());
+    case STREAM_INFO_NUM_QUEUED:
+        return target.SizeT(m_input.size());
+    case STREAM_INFO_NUM_AWAIT_DELIVERY:
+        return target.SizeT(m_output.size());
+    case STREAM_INFO_NUM_STARTED:
+        return target.UInt64(m_started);
+    case STREAM_INFO_IS_GRABBING:
+        return target.Bool(m_grabbing);
+    case STREAM_INFO_DEFINES_PAYLOADSIZE:
+        return target.Bool(false);
+    case STREAM_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    case STREAM_INFO_NUM_CHUNKS_MAX:
+        return target.SizeT(1);
+    case STREAM_INFO_BUF_ANNOUNCE_MIN:
+        return target.SizeT(1);
+    case STREAM_INFO_BUF_ALIGNMENT:
+        return target.SizeT(reportedAlignment);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "Stream info not available");
+    }
+}
+
+void DataStream::beforeRead(uint64_t, size_t)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    setInt(Stream::AnnouncedBufferCount, m_buffers.size());
+    setInt(Stream::AnnounceBufferMinimum, 1);
+    setInt(Stream::InputBufferCount, m_input.size());
+    setInt(Stream::OutputBufferCount, m_output.size());
+    setInt(Stream::StartedFrameCount, m_started);
+    setInt(Stream::DeliveredFrameCount, m_delivered);
+    setInt(Stream::LostFrameCount, m_lost);
+    setInt(Stream::DroppedFrameCount, m_dropped);
+    setInt(Stream::IncompleteFrameCount, m_incomplete);
+    setInt(Stream::IsGrabbing, m_grabbing ? 1 : 0);
+    setInt(Stream::BufferHandlingMode, m_bufferHandlingMode);
+}
+
+void DataStream::write(uint64_t address, const void* data, size_t size)
+{
+    if (address != Stream::BufferHandlingMode || size != 8)
+    {
+        return Port::write(address, data, size);
+    }
+
+    uint64_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    if (value > BufferHandling::NewestOnly)
+    {
+        throw GenTLError(GC_ERR_INVALID_VALUE, "Invalid value for StreamBufferHandlingMode");
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_bufferHandlingMode = value;
+    setInt(address, value);
+}
+
+void DataStream::generate()
+{
+    using clock = std::chrono::steady_clock;
+
+    uint64_t generation = 0;
+    bool firstFrame = true;
+    auto next = clock::now();
+
+    while (!m_stopRequested)
+    {
+        RemoteDevice::Settings settings;
+        {
+            std::unique_lock<std::mutex> lock(m_remoteDevice.Mutex());
+            m_remoteDevice.Changed().wait(lock, [this] { return m_stopRequested || m_remoteDevice.IsAcquiring(); });
+            if (m_stopRequested)
+            {
+                break;
+            }
+
+            settings = m_remoteDevice.CurrentSettings();
+            const auto exposure = std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double, std::micro>(settings.exposureTime_us));
+
+            clock::time_point due;
+            if (settings.triggered)
+            {
+                m_remoteDevice.Changed().wait(lock, [this] {
+                    return m_stopRequested || !m_remoteDevice.IsAcquiring() || !m_remoteDevice.IsTriggered()
+                        || m_remoteDevice.TriggerPending();
+                });
+                if (m_stopRequested)
+                {
+                    break;
+                }
+                if (!m_remoteDevice.TakeTrigger())
+                {
+                    continue;
+                }
+
+                // The frame is read out once the exposure has finished
+                due = clock::now() + exposure;
+            }
+            else
+            {
+                // The frame period cannot be shorter than the exposure
+                const auto period = std::max(exposure,
+                    std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double>(1.0 / std::max(settings.frameRate, 0.5))));
+
+                const auto now = clock::now();
+                if (firstFrame || generation != m_remoteDevice.AcquisitionGeneration() || next + period < now)
+                {
+                    // New acquisition or the consumer stalled us: restart the frame clock instead of bursting
+                    firstFrame = false;
+                    generation = m_remoteDevice.AcquisitionGeneration();
+                    next = now;
+                }
+                next += period;
+                due = next;
+            }
+
+            // A frame still being exposed when AcquisitionStop arrives is discarded
+            if (m_remoteDevice.Changed().wait_until(
+                    lock, due, [this] { return m_stopRequested || !m_remoteDevice.IsAcquiring(); }))
+            {
+                continue;
+            }
+        }
+
+        deliver(settings);
+
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        if (m_numToAcquire && m_delivered >= m_numToAcquire)
+        {
+            break;
+        }
+    }
+}
+
+void DataStream::deliver(const RemoteDevice::Settings& settings)
+{
+    const auto imageSize = settings.geometry.width * settings.geometry.height;
+    const auto chunkSize = settings.chunks ? Chunk::Size : 0;
+    const auto payloadSize = imageSize + chunkSize;
+
+    Buffer* buffer = nullptr;
+    uint64_t frameId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        frameId = m_nextFrameId++;
+        m_started++;
+
+        buffer = takeInputBuffer();
+        if (!buffer)
+        {
+            // The frame is gone, like on a camera whose host did not queue buffers in time
+            m_lost++;
+            return;
+        }
+        buffer->state = Buffer::State::Filling;
+    }
+
+    const auto timestamp = nowNs();
+    const auto written = m_pattern.Render(settings.geometry, frameId, buffer->base, buffer->size);
+    const auto complete = buffer->size >= payloadSize;
+
+    if (complete && chunkSize)
+    {
+        auto* chunk = buffer->base + imageSize;
+        const uint64_t pixelFormat = settings.geometry.pixelFormat;
+        const uint64_t width = settings.geometry.width;
+        const uint64_t height = settings.geometry.height;
+        std::memcpy(chunk + Chunk::Width, &width, sizeof(width));
+        std::memcpy(chunk + Chunk::Height, &height, sizeof(height));
+        std::memcpy(chunk + Chunk::PixelFormat, &pixelFormat, sizeof(pixelFormat));
+        std::memcpy(chunk + Chunk::ExposureTime, &settings.exposureTime_us, sizeof(settings.exposureTime_us));
+        std::memcpy(chunk + Chunk::FrameID, &frameId, sizeof(frameId));
+        std::memcpy(chunk + Chunk::Timestamp, &timestamp, sizeof(timestamp));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        buffer->newData = true;
+        buffer->incomplete = !complete;
+        buffer->dataLargerThanBuffer = !complete;
+        buffer->sizeFilled = complete ? payloadSize : written;
+        buffer->chunkSize = complete ? chunkSize : 0;
+        buffer->frameId = frameId;
+        buffer->timestamp_ns = timestamp;
+        buffer->geometry = settings.geometry;
+
+        if (!complete)
+        {
+            m_incomplete++;
+        }
+
+        buffer->state = Buffer::State::Output;
+        m_output.push_back(buffer);
+        m_delivered++;
+
+        if (m_bufferHandlingMode == BufferHandling::NewestOnly)
+        {
+            // Older frames the consumer has not fetched yet go back to the input pool
+            while (m_output.size() > 1)
+            {
+                auto* older = m_output.front();
+                m_output.pop_front();
+                older->state = Buffer::State::Input;
+                older->newData = false;
+                m_input.push_back(older);
+                m_dropped++;
+            }
+        }
+    }
+    m_outputCondition.notify_all();
+}
+
+Buffer* DataStream::takeInputBuffer()
+{
+    if (!m_input.empty())
+    {
+        auto* buffer = m_input.front();
+        m_input.pop_front();
+        return buffer;
+    }
+
+    if (m_bufferHandlingMode == BufferHandling::OldestFirstOverwrite && !m_output.empty())
+    {
+        auto* buffer = m_output.front();
+        m_output.pop_front();
+        m_dropped++;
+        return buffer;
+    }
+
+    return nullptr;
+}
+
+bool DataStream::waitForOutput(NewBufferEvent& event, uint64_t timeout, EVENT_NEW_BUFFER_DATA& data)
+{
+    std::unique_lock<std::mutex> lock(m_streamMutex);
+    const auto ready = [this, &event] { return event.pendingKills > 0 || !m_output.empty(); };
+    if (timeout == GENTL_INFINITE)
+    {
+        m_outputCondition.wait(lock, ready);
+    }
+    else if (!m_outputCondition.wait_for(lock, std::chrono::milliseconds(timeout), ready))
+    {
+        throw GenTLError(GC_ERR_TIMEOUT, "Timeout");
+    }
+
+    if (event.pendingKills > 0)
+    {
+        event.pendingKills--;
+        throw GenTLError(GC_ERR_ABORT, "Wait aborted");
+    }
+
+    auto* buffer = m_output.front();
+    m_output.pop_front();
+    buffer->state = Buffer::State::Announced;
+
+    data.BufferHandle = buffer->AsHandle();
+    data.pUserPointer = buffer->userPointer;
+    return true;
+}
+
+Buffer* DataStream::findBuffer(Buffer* buffer) const
+{
+    for (const auto& announced : m_buffers)
+    {
+        if (announced.get() == buffer)
+        {
+            return buffer;
+        }
+    }
+    throw GenTLError(GC_ERR_INVALID_HANDLE, "Buffer does not belong to this data stream");
+}
+
+
+Device::Device(RemoteDevice& remoteDevice, std::string id, void* parentInterface)
+    : Port(TLDeviceModuleName, "TLDevicePort", &LocalDeviceXml(), Module::Size)
+    , m_remoteDevice(remoteDevice)
+    , m_id(std::move(id))
+    , m_parentInterface(parentInterface)
+{
+    setString(Module::ID, m_id);
+    setString(Module::VendorName, vendorName);
+    setString(Module::ModelName, "Synthetic Camera");
+    setString(Module::Version, version);
+    setString(Module::Type, TLTypeCustomName);
+    setString(Module::SerialNumber, m_id);
+}
+
+Device::~Device()
+{
+    CloseDataStream();
+}
+
+std::string Device::Id() const
+{
+    return m_id;
+}
+
+void* Device::ParentInterface() const
+{
+    return m_parentInterface;
+}
+
+RemoteDevice& Device::Remote()
+{
+    return m_remoteDevice;
+}
+
+DataStream* Device::OpenDataStream(const std::string& id)
+{
+    if (id != streamId)
+    {
+        throw GenTLError(GC_ERR_INVALID_ID, "Unknown data stream " + id);
+    }
+    if (m_dataStream)
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Data stream is already open");
+    }
+
+    m_dataStream = std::make_unique<DataStream>(m_remoteDevice, AsHandle());
+    return m_dataStream.get();
+}
+
+void Device::CloseDataStream()
+{
+    m_dataStream.reset();
+}
+
+DataStream* Device::Stream()
+{
+    return m_dataStream.get();
+}
+
+
+Interface::Interface(System& system)
+    : Port(TLInterfaceModuleName, "InterfacePort", &InterfaceXml(), Module::Size)
+    , m_system(system)
+{
+    setString(Module::ID, System::InterfaceId());
+    setString(Module::VendorName, vendorName);
+    setString(Module::ModelName, "Synthetic Interface");
+    setString(Module::Version, version);
+    setString(Module::Type, TLTypeCustomName);
+}
+
+Interface::~Interface()
+{
+    m_devices.clear();
+}
+
+std::string Interface::Id() const
+{
+    return System::InterfaceId();
+}
+
+System& Interface::Parent()
+{
+    return m_system;
+}
+
+Device* Interface::OpenDevice(const std::string& id)
+{
+    auto* remoteDevice = m_system.FindRemoteDevice(id);
+    if (!remoteDevice)
+    {
+        throw GenTLError(GC_ERR_INVALID_ID, "Unknown device " + id);
+    }
+    if (IsOpen(id))
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Device " + id + " is already open");
+    }
+
+    m_devices.push_back(std::make_unique<Device>(*remoteDevice, id, AsHandle()));
+    return m_devices.back().get();
+}
+
+void Interface::CloseDevice(Device* device)
+{
+    m_devices.erase(std::remove_if(m_devices.begin(), m_devices.end(),
+                        [device](const std::unique_ptr<Device>& open) { return open.get() == device; }),
+        m_devices.end());
+}
+
+bool Interface::IsOpen(const std::string& id) const
+{
+    return std::any_of(m_devices.begin(), m_devices.end(),
+        [&id](const std::unique_ptr<Device>& open) { return open->Id() == id; });
+}
+
+void Interface::GetDeviceInfo(const std::string& id, DEVICE_INFO_CMD command, InfoTarget target) const
+{
+    auto* remoteDevice = m_system.FindRemoteDevice(id);
+    if (!remoteDevice)
+    {
+        throw GenTLError(GC_ERR_INVALID_ID, "Unknown device " + id);
+    }
+
+    switch (command)
+    {
+    case DEVICE_INFO_ID:
+    case DEVICE_INFO_SERIAL_NUMBER:
+        return target.String(id);
+    case DEVICE_INFO_VENDOR:
+        return target.String(vendorName);
+    case DEVICE_INFO_MODEL:
+        return target.String("Synthetic Camera");
+    case DEVICE_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    case DEVICE_INFO_DISPLAYNAME:
+        return target.String(std::string(vendorName) + " Synthetic Camera (" + id + ")");
+    case DEVICE_INFO_ACCESS_STATUS:
+        return target.Int32(IsOpen(id) ? DEVICE_ACCESS_STATUS_OPEN_READWRITE : DEVICE_ACCESS_STATUS_READWRITE);
+    case DEVICE_INFO_USER_DEFINED_NAME: {
+        char userId[StringLength] = {};
+        remoteDevice->Read(Remote::DeviceUserID, userId, sizeof(userId));
+        userId[StringLength - 1] = '\0';
+        return target.String(userId);
+    }
+    case DEVICE_INFO_VERSION:
+        return target.String(version);
+    case DEVICE_INFO_TIMESTAMP_FREQUENCY:
+        return target.UInt64(1000000000ull);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "Device info not available");
+    }
+}
+
+
+System::System(const Config& config)
+    : Port(TLSystemModuleName, "TLPort", &SystemXml(), Module::Size)
+    , m_config(config)
+{
+    setString(Module::ID, Id());
+    setString(Module::VendorName, vendorName);
+    setString(Module::ModelName, "Synthetic GenTL Producer");
+    setString(Module::Version, version);
+    setString(Module::Type, TLTypeCustomName);
+
+    for (size_t i = 0; i < m_config.deviceCount; ++i)
+    {
+        std::ostringstream serial;
+        serial << "SYN" << std::setw(5) << std::setfill('0') << (i + 1);
+        m_remoteDevices.push_back(std::make_unique<RemoteDevice>(m_config, serial.str()));
+    }
+}
+
+System::~System()
+{
+    // Devices reference the remote devices, so the interface goes first
+    m_interface.reset();
+}
+
+std::string System::Id() const
+{
+    return "SyntheticGenTL";
+}
+
+const Config& System::Configuration() const
+{
+    return m_config;
+}
+
+const char* System::InterfaceId()
+{
+    return "SyntheticInterface0";
+}
+
+Interface* System::OpenInterface(const std::string& id)
+{
+    if (id != InterfaceId())
+    {
+        throw GenTLError(GC_ERR_INVALID_ID, "Unknown interface " + id);
+    }
+    if (m_interface)
+    {
+        throw GenTLError(GC_ERR_RESOURCE_IN_USE, "Interface is already open");
+    }
+
+    m_interface = std::make_unique<Interface>(*this);
+    return m_interface.get();
+}
+
+void System::CloseInterface()
+{
+    m_interface.reset();
+}
+
+size_t System::DeviceCount() const
+{
+    return m_remoteDevices.size();
+}
+
+std::string System::DeviceId(size_t index) const
+{
+    if (index >= m_remoteDevices.size())
+    {
+        throw GenTLError(GC_ERR_INVALID_INDEX, "Invalid device index");
+    }
+    return m_remoteDevices[index]->Id();
+}
+
+RemoteDevice* System::FindRemoteDevice(const std::string& id)
+{
+    for (auto& remoteDevice : m_remoteDevices)
+    {
+        if (remoteDevice->Id() == id)
+        {
+            return remoteDevice.get();
+        }
+    }
+    return nullptr;
+}
+
+void System::GetInfo(TL_INFO_CMD command, InfoTarget target)
+{
+    switch (command)
+    {
+    case TL_INFO_ID:
+        return target.String("SyntheticGenTL");
+    case TL_INFO_VENDOR:
+        return target.String(vendorName);
+    case TL_INFO_MODEL:
+        return target.String("Synthetic GenTL Producer");
+    case TL_INFO_VERSION:
+        return target.String(version);
+    case TL_INFO_TLTYPE:
+        return target.String(TLTypeCustomName);
+    case TL_INFO_NAME: {
+        const auto path = libraryPath();
+        return target.String(path.substr(path.find_last_of("/\\") + 1));
+    }
+    case TL_INFO_PATHNAME:
+        return target.String(libraryPath());
+    case TL_INFO_DISPLAYNAME:
+        return target.String(std::string(vendorName) + " Synthetic GenTL Producer");
+    case TL_INFO_CHAR_ENCODING:
+        return target.Int32(TL_CHAR_ENCODING_ASCII);
+    case TL_INFO_GENTL_VER_MAJOR:
+        return target.UInt32(GenTLMajorVersion);
+    case TL_INFO_GENTL_VER_MINOR:
+        return target.UInt32(GenTLMinorVersion);
+    default:
+        throw GenTLError(GC_ERR_NOT_AVAILABLE, "TL info not available");
+    }
+}
+
+} // namespace synthetic
@@ -0,0 +1,450 @@
+/*!
+ * \file    producer.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Modules of the synthetic GenTL producer: one system with one
+ *          interface and a configurable number of simulated cameras. Each
+ *          camera has a remote nodemap and one data stream that fills the
+ *          announced buffers with a Bayer test pattern, free running at
+ *          AcquisitionFrameRate or on TriggerSoftware.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef PRODUCER_H
+#define PRODUCER_H
+
+#include <peak/thirdparty/GenTL.h>
+
+#include "registermap.h"
+#include "testpattern.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace synthetic
+{
+
+using namespace GenTL;
+
+
+/*!
+ * \brief Error reported to the consumer. Every exported function catches it and returns its code.
+ */
+class GenTLError : public std::runtime_error
+{
+public:
+    GenTLError(GC_ERROR code, const std::string& message);
+
+    GC_ERROR Code() const;
+
+private:
+    GC_ERROR m_code;
+};
+
+
+/*!
+ * \brief Producer settings, read from the environment when the transport layer is opened.
+ *
+ * SYNTHETIC_GENTL_DEVICES, SYNTHETIC_GENTL_WIDTH, SYNTHETIC_GENTL_HEIGHT, SYNTHETIC_GENTL_PIXELFORMAT,
+ * SYNTHETIC_GENTL_FRAMERATE and SYNTHETIC_GENTL_FRAMERATE_MAX override the defaults below.
+ */
+struct Config
+{
+    size_t deviceCount = 1;
+    size_t sensorWidth = 4000;
+    size_t sensorHeight = 3000;
+    uint64_t pixelFormat = PixelFormat::BayerRG8;
+    double frameRate = 30.0;
+    double frameRateMax = 200.0;
+
+    static Config FromEnvironment();
+};
+
+
+/*!
+ * \brief Copies an info value to the consumer's buffer, following the size negotiation of the *GetInfo functions.
+ */
+class InfoTarget
+{
+public:
+    InfoTarget(INFO_DATATYPE* type, void* buffer, size_t* size);
+
+    void String(const std::string& value);
+    void Int32(int32_t value);
+    void UInt32(uint32_t value);
+    void UInt64(uint64_t value);
+    void SizeT(size_t value);
+    void Bool(bool value);
+    void Float64(double value);
+    void Ptr(const void* value);
+
+private:
+    void set(INFO_DATATYPE type, const void* value, size_t size);
+
+    INFO_DATATYPE* m_type;
+    void* m_buffer;
+    size_t* m_size;
+};
+
+
+/*!
+ * \brief Base of everything handed out as a GenTL handle. Only registered handles are accepted by Resolve().
+ */
+class Handle
+{
+public:
+    // Handles are valid from construction to destruction
+    Handle();
+    virtual ~Handle();
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    void* AsHandle();
+};
+
+// Looks up a handle of the given type, throws GC_ERR_INVALID_HANDLE if it is unknown or of another type
+Handle* ResolveHandle(void* handle);
+
+template <class T>
+T* Resolve(void* handle)
+{
+    auto* resolved = dynamic_cast<T*>(ResolveHandle(handle));
+    if (!resolved)
+    {
+        throw GenTLError(GC_ERR_INVALID_HANDLE, "Handle has the wrong type");
+    }
+    return resolved;
+}
+
+
+/*!
+ * \brief A module with a register port. The GenApi description of the port is mapped at XmlAddress.
+ */
+class Port : public Handle
+{
+public:
+    Port(std::string moduleName, std::string portName, const std::string* xml, size_t registerSize);
+
+    void Read(uint64_t address, void* data, size_t size);
+    void Write(uint64_t address, const void* data, size_t size);
+
+    virtual std::string Id() const = 0;
+    const std::string& ModuleName() const;
+    const std::string& PortName() const;
+
+    uint32_t UrlCount() const;
+    void GetUrlInfo(uint32_t index, URL_INFO_CMD command, InfoTarget target) const;
+    std::string Url() const;
+    void GetPortInfo(PORT_INFO_CMD command, InfoTarget target) const;
+
+protected:
+    // Called with m_mutex held, before registers in [address, address + size) are copied out
+    virtual void beforeRead(uint64_t address, size_t size);
+    // Called with m_mutex held. The default rejects every write.
+    virtual void write(uint64_t address, const void* data, size_t size);
+
+    uint64_t getInt(uint64_t address) const;
+    void setInt(uint64_t address, uint64_t value);
+    double getFloat(uint64_t address) const;
+    void setFloat(uint64_t address, double value);
+    void setString(uint64_t address, const std::string& value);
+
+    mutable std::mutex m_mutex;
+    std::vector<uint8_t> m_registers;
+
+private:
+    const std::string m_moduleName;
+    const std::string m_portName;
+    const std::string* m_xml;
+};
+
+
+/*!
+ * \brief A GenTL event. New buffer events are served by the data stream, all other event types never fire.
+ */
+class Event : public Handle
+{
+public:
+    explicit Event(EVENT_TYPE type);
+
+    EVENT_TYPE Type() const;
+
+    // iTimeout is in milliseconds, GENTL_INFINITE waits forever
+    virtual void GetData(void* buffer, size_t* size, uint64_t timeout);
+    virtual void Kill();
+    virtual void Flush();
+    virtual size_t NumInQueue() const;
+    virtual uint64_t NumFired() const;
+    virtual size_t DataSizeMax() const;
+
+private:
+    const EVENT_TYPE m_type;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    uint64_t m_pendingKills = 0;
+};
+
+
+class DataStream;
+
+
+/*!
+ * \brief A buffer announced to a data stream. All state except the memory itself is protected by the stream mutex.
+ */
+class Buffer : public Port
+{
+public:
+    Buffer(DataStream& stream, void* base, size_t size, void* userPointer, bool ownsMemory);
+    ~Buffer() override;
+
+    std::string Id() const override;
+
+    void GetInfo(BUFFER_INFO_CMD command, InfoTarget target);
+    void GetChunkData(SINGLE_CHUNK_DATA* chunkData, size_t* numChunks);
+
+    enum class State
+    {
+        Announced,
+        Input,
+        Filling,
+        Output
+    };
+
+    DataStream& stream;
+    uint8_t* const base;
+    const size_t size;
+    void* const userPointer;
+    const bool ownsMemory;
+
+    State state = State::Announced;
+    bool newData = false;
+    bool incomplete = false;
+    bool dataLargerThanBuffer = false;
+    size_t sizeFilled = 0;
+    size_t chunkSize = 0;
+    uint64_t frameId = 0;
+    uint64_t timestamp_ns = 0;
+    PatternGeometry geometry;
+};
+
+
+/*!
+ * \brief Register file and acquisition state of one simulated camera. It outlives the device handles, like the
+ *        settings of a real camera survive closing it.
+ */
+class RemoteDevice : public Port
+{
+public:
+    RemoteDevice(const Config& config, std::string serialNumber);
+
+    std::string Id() const override;
+
+    struct Settings
+    {
+        PatternGeometry geometry;
+        double frameRate = 0;
+        double exposureTime_us = 0;
+        bool triggered = false;
+        bool chunks = false;
+    };
+
+    // The data stream waits on these for AcquisitionStart, AcquisitionStop and TriggerSoftware
+    std::mutex& Mutex();
+    std::condition_variable& Changed();
+
+    // The following require Mutex() to be held
+    Settings CurrentSettings() const;
+    bool IsAcquiring() const;
+    bool IsTriggered() const;
+    bool TriggerPending() const;
+    bool TakeTrigger();
+    uint64_t AcquisitionGeneration() const;
+
+protected:
+    void write(uint64_t address, const void* data, size_t size) override;
+
+private:
+    void loadDefaults();
+    void updatePayloadSize();
+    void checkUnlocked() const;
+
+    const Config m_config;
+    const std::string m_serialNumber;
+    std::condition_variable m_changed;
+    bool m_acquiring = false;
+    bool m_triggerPending = false;
+    uint64_t m_acquisitionGeneration = 0;
+};
+
+
+/*!
+ * \brief The data stream of a device. A generator thread takes buffers from the input pool, renders the test
+ *        pattern into them and moves them to the output queue, honouring StreamBufferHandlingMode.
+ */
+class DataStream : public Port
+{
+public:
+    DataStream(RemoteDevice& remoteDevice, void* parentDevice);
+    ~DataStream() override;
+
+    std::string Id() const override;
+    void* ParentDevice() const;
+
+    Buffer* Announce(void* base, size_t size, void* userPointer);
+    Buffer* AllocAndAnnounce(size_t size, void* userPointer);
+    void Revoke(Buffer* buffer, void** base, void** userPointer);
+    void Queue(Buffer* buffer);
+    void FlushQueue(ACQ_QUEUE_TYPE operation);
+    Buffer* BufferAt(uint32_t index);
+
+    void StartAcquisition(uint64_t numToAcquire);
+    void StopAcquisition();
+
+    Event* RegisterEvent(EVENT_TYPE type);
+    void UnregisterEvent(EVENT_TYPE type);
+
+    void GetInfo(STREAM_INFO_CMD command, InfoTarget target);
+
+    // Used by the buffers, which share the stream mutex
+    std::mutex& Mutex();
+
+protected:
+    void beforeRead(uint64_t address, size_t size) override;
+    void write(uint64_t address, const void* data, size_t size) override;
+
+private:
+    class NewBufferEvent;
+    friend class NewBufferEvent;
+
+    void generate();
+    void deliver(const RemoteDevice::Settings& settings);
+    Buffer* takeInputBuffer();
+    bool waitForOutput(NewBufferEvent& event, uint64_t timeout, EVENT_NEW_BUFFER_DATA& data);
+    Buffer* findBuffer(Buffer* buffer) const;
+
+    RemoteDevice& m_remoteDevice;
+    void* m_parentDevice;
+    TestPattern m_pattern;
+
+    // Protects the buffers, the queues, the counters and the events
+    mutable std::mutex m_streamMutex;
+    std::condition_variable m_outputCondition;
+    std::vector<std::unique_ptr<Buffer>> m_buffers;
+    std::deque<Buffer*> m_input;
+    std::deque<Buffer*> m_output;
+    std::unique_ptr<NewBufferEvent> m_newBufferEvent;
+    std::vector<std::unique_ptr<Event>> m_otherEvents;
+
+    uint64_t m_bufferHandlingMode = BufferHandling::OldestFirst;
+    uint64_t m_nextFrameId = 1;
+    uint64_t m_started = 0;
+    uint64_t m_delivered = 0;
+    uint64_t m_lost = 0;
+    uint64_t m_dropped = 0;
+    uint64_t m_incomplete = 0;
+    uint64_t m_numToAcquire = 0;
+
+    bool m_grabbing = false;
+    std::atomic<bool> m_stopRequested{ false };
+    std::thread m_generator;
+};
+
+
+/*!
+ * \brief The local device module. Owns the data stream while the device is open.
+ */
+class Device : public Port
+{
+public:
+    Device(RemoteDevice& remoteDevice, std::string id, void* parentInterface);
+    ~Device() override;
+
+    std::string Id() const override;
+    void* ParentInterface() const;
+    RemoteDevice& Remote();
+
+    DataStream* OpenDataStream(const std::string& id);
+    void CloseDataStream();
+    DataStream* Stream();
+
+private:
+    RemoteDevice& m_remoteDevice;
+    const std::string m_id;
+    void* m_parentInterface;
+    std::unique_ptr<DataStream> m_dataStream;
+};
+
+
+class System;
+
+
+/*!
+ * \brief The only interface of the system. Owns the open devices.
+ */
+class Interface : public Port
+{
+public:
+    explicit Interface(System& system);
+    ~Interface() override;
+
+    std::string Id() const override;
+    System& Parent();
+
+    Device* OpenDevice(const std::string& id);
+    void CloseDevice(Device* device);
+    bool IsOpen(const std::string& id) const;
+
+    void GetDeviceInfo(const std::string& id, DEVICE_INFO_CMD command, InfoTarget target) const;
+
+private:
+    System& m_system;
+    std::vector<std::unique_ptr<Device>> m_devices;
+};
+
+
+/*!
+ * \brief The transport layer. Owns the simulated cameras for the lifetime of the TLOpen handle.
+ */
+class System : public Port
+{
+public:
+    explicit System(const Config& config);
+    ~System() override;
+
+    std::string Id() const override;
+    const Config& Configuration() const;
+
+    static const char* InterfaceId();
+    Interface* OpenInterface(const std::string& id);
+    void CloseInterface();
+
+    size_t DeviceCount() const;
+    std::string DeviceId(size_t index) const;
+    RemoteDevice* FindRemoteDevice(const std::string& id);
+
+    static void GetInfo(TL_INFO_CMD command, InfoTarget target);
+
+private:
+    const Config m_config;
+    std::vector<std::unique_ptr<RemoteDevice>> m_remoteDevices;
+    std::unique_ptr<Interface> m_interface;
+};
+
+} // namespace synthetic
+
+#endif // PRODUCER_H
@@ -0,0 +1,156 @@
+/*!
+ * \file    registermap.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   Register layout of the synthetic GenTL producer. Every feature of
+ *          the GenApi descriptions in nodemaps.cpp is backed by one of these
+ *          addresses, so the XML files never change with the configuration.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef REGISTERMAP_H
+#define REGISTERMAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace synthetic
+{
+
+// The GenApi description of every port is mapped here, behind the registers
+constexpr uint64_t XmlAddress = 0x100000;
+
+// Length of every string register, including the terminating null
+constexpr size_t StringLength = 32;
+
+// PFNC values of the supported pixel formats
+namespace PixelFormat
+{
+constexpr uint64_t Mono8 = 0x01080001;
+constexpr uint64_t BayerGR8 = 0x01080008;
+constexpr uint64_t BayerRG8 = 0x01080009;
+constexpr uint64_t BayerGB8 = 0x0108000A;
+constexpr uint64_t BayerBG8 = 0x0108000B;
+} // namespace PixelFormat
+
+// Registers of the remote device port
+namespace Remote
+{
+constexpr uint64_t DeviceVendorName = 0x000;
+constexpr uint64_t DeviceModelName = 0x020;
+constexpr uint64_t DeviceSerialNumber = 0x040;
+constexpr uint64_t DeviceUserID = 0x060;
+constexpr uint64_t SensorName = 0x080;
+
+constexpr uint64_t WidthMax = 0x100;
+constexpr uint64_t HeightMax = 0x108;
+constexpr uint64_t Width = 0x110;
+constexpr uint64_t Height = 0x118;
+constexpr uint64_t OffsetX = 0x120;
+constexpr uint64_t OffsetY = 0x128;
+constexpr uint64_t PixelFormat = 0x130;
+constexpr uint64_t PayloadSize = 0x138;
+
+constexpr uint64_t AcquisitionMode = 0x140;
+constexpr uint64_t AcquisitionStart = 0x148;
+constexpr uint64_t AcquisitionStop = 0x150;
+constexpr uint64_t AcquisitionFrameRate = 0x158;
+constexpr uint64_t AcquisitionFrameRateMax = 0x160;
+constexpr uint64_t ExposureTime = 0x168;
+constexpr uint64_t ExposureAuto = 0x170;
+
+// TriggerMode, TriggerSource and TriggerSoftware hold one 8 byte register per TriggerSelector entry
+constexpr uint64_t TriggerSelector = 0x180;
+constexpr uint64_t TriggerMode = 0x188;
+constexpr uint64_t TriggerSource = 0x198;
+constexpr uint64_t TriggerSoftware = 0x1A8;
+constexpr size_t TriggerSelectorCount = 2;
+
+constexpr uint64_t GainSelector = 0x1C0;
+constexpr uint64_t Gain = 0x1C8;
+constexpr uint64_t GainAuto = 0x1D0;
+constexpr uint64_t BalanceWhiteAuto = 0x1D8;
+
+// ChunkEnable holds one 8 byte register per ChunkSelector entry
+constexpr uint64_t ChunkModeActive = 0x200;
+constexpr uint64_t ChunkSelector = 0x208;
+constexpr uint64_t ChunkEnable = 0x210;
+constexpr size_t ChunkSelectorCount = 6;
+
+constexpr uint64_t UserSetSelector = 0x280;
+constexpr uint64_t UserSetLoad = 0x288;
+
+constexpr uint64_t TLParamsLocked = 0x300;
+
+constexpr size_t Size = 0x400;
+} // namespace Remote
+
+// Entries of the TriggerSelector and TriggerSource enumerations
+namespace Trigger
+{
+constexpr uint64_t ExposureStart = 0;
+constexpr uint64_t FrameStart = 1;
+constexpr uint64_t SourceSoftware = 0;
+constexpr uint64_t SourceLine0 = 1;
+} // namespace Trigger
+
+// Layout of the single chunk appended behind the image when ChunkModeActive is set
+namespace Chunk
+{
+constexpr uint64_t Id = 0x5A4E0001;
+constexpr uint64_t Width = 0x00;
+constexpr uint64_t Height = 0x08;
+constexpr uint64_t PixelFormat = 0x10;
+constexpr uint64_t ExposureTime = 0x18;
+constexpr uint64_t FrameID = 0x20;
+constexpr uint64_t Timestamp = 0x28;
+constexpr size_t Size = 0x30;
+} // namespace Chunk
+
+// Registers of the data stream module port
+namespace Stream
+{
+constexpr uint64_t StreamID = 0x000;
+constexpr uint64_t AnnouncedBufferCount = 0x020;
+constexpr uint64_t AnnounceBufferMinimum = 0x028;
+constexpr uint64_t InputBufferCount = 0x030;
+constexpr uint64_t OutputBufferCount = 0x038;
+constexpr uint64_t StartedFrameCount = 0x040;
+constexpr uint64_t DeliveredFrameCount = 0x048;
+constexpr uint64_t LostFrameCount = 0x050;
+constexpr uint64_t DroppedFrameCount = 0x058;
+constexpr uint64_t IncompleteFrameCount = 0x060;
+constexpr uint64_t IsGrabbing = 0x068;
+constexpr uint64_t BufferHandlingMode = 0x070;
+
+constexpr size_t Size = 0x100;
+} // namespace Stream
+
+// Entries of StreamBufferHandlingMode
+namespace BufferHandling
+{
+constexpr uint64_t OldestFirst = 0;
+constexpr uint64_t OldestFirstOverwrite = 1;
+constexpr uint64_t NewestOnly = 2;
+} // namespace BufferHandling
+
+// Registers of the system, interface and local device module ports. Only identification strings live there.
+namespace Module
+{
+constexpr uint64_t ID = 0x000;
+constexpr uint64_t VendorName = 0x020;
+constexpr uint64_t ModelName = 0x040;
+constexpr uint64_t Version = 0x060;
+constexpr uint64_t Type = 0x080;
+constexpr uint64_t SerialNumber = 0x0A0;
+
+constexpr size_t Size = 0x100;
+} // namespace Module
+
+} // namespace synthetic
+
+#endif // REGISTERMAP_H
@@ -0,0 +1,164 @@
+/*!
+ * \file    testpattern.cpp
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The TestPattern class renders the frames of the synthetic camera:
+ *          colour bars over a grey ramp, sampled through the colour filter
+ *          array of the selected Bayer format. The pattern scrolls
+ *          horizontally so consecutive frames differ.
+ *
+ * \version 1.0.0
+ */
+
+#include "testpattern.h"
+
+#include "registermap.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace synthetic
+{
+
+namespace
+{
+
+// Horizontal travel of the pattern in pixels. Even, so the Bayer phase of the scrolled rows stays the same.
+constexpr size_t scrollRange = 64;
+constexpr size_t scrollStep = 2;
+
+struct Rgb
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// 75% colour bars: white, yellow, cyan, green, magenta, red, blue, black
+const Rgb bars[8] = { { 191, 191, 191 }, { 191, 191, 0 }, { 0, 191, 191 }, { 0, 191, 0 }, { 191, 0, 191 },
+    { 191, 0, 0 }, { 0, 0, 191 }, { 0, 0, 0 } };
+
+Rgb sceneColor(size_t sceneX, size_t sceneY, size_t sensorWidth, size_t sensorHeight)
+{
+    // The lower quarter of the sensor is a full range grey ramp, the rest are colour bars
+    if (sceneY >= sensorHeight - sensorHeight / 4)
+    {
+        const auto value = static_cast<uint8_t>(std::min<size_t>(255, sceneX * 255 / std::max<size_t>(sensorWidth - 1, 1)));
+        return { value, value, value };
+    }
+
+    return bars[(sceneX * 8 / sensorWidth) % 8];
+}
+
+// 0 = red, 1 = green, 2 = blue for the pixel at (x, y) of the image
+int bayerChannel(uint64_t pixelFormat, size_t x, size_t y)
+{
+    const auto phase = (y & 1) * 2 + (x & 1);
+    switch (pixelFormat)
+    {
+    case PixelFormat::BayerRG8: {
+        const int channels[4] = { 0, 1, 1, 2 };
+        return channels[phase];
+    }
+    case PixelFormat::BayerGR8: {
+        const int channels[4] = { 1, 0, 2, 1 };
+        return channels[phase];
+    }
+    case PixelFormat::BayerGB8: {
+        const int channels[4] = { 1, 2, 0, 1 };
+        return channels[phase];
+    }
+    default: {
+        const int channels[4] = { 2, 1, 1, 0 };
+        return channels[phase];
+    }
+    }
+}
+
+} // namespace
+
+bool PatternGeometry::operator==(const PatternGeometry& other) const
+{
+    return pixelFormat == other.pixelFormat && sensorWidth == other.sensorWidth
+        && sensorHeight == other.sensorHeight && width == other.width && height == other.height
+        && offsetX == other.offsetX && offsetY == other.offsetY;
+}
+
+bool TestPattern::IsSupported(uint64_t pixelFormat)
+{
+    switch (pixelFormat)
+    {
+    case PixelFormat::Mono8:
+    case PixelFormat::BayerGR8:
+    case PixelFormat::BayerRG8:
+    case PixelFormat::BayerGB8:
+    case PixelFormat::BayerBG8:
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t TestPattern::Render(const PatternGeometry& geometry, uint64_t frameId, uint8_t* output, size_t outputSize)
+{
+    if (!(geometry == m_geometry) || m_pattern.empty())
+    {
+        prepare(geometry);
+    }
+
+    const auto shift = static_cast<size_t>((frameId * scrollStep) % scrollRange);
+    size_t written = 0;
+    for (size_t y = 0; y < geometry.height && written < outputSize; ++y)
+    {
+        const auto count = std::min(geometry.width, outputSize - written);
+        std::memcpy(output + written, m_pattern.data() + y * m_stride + shift, count);
+        written += count;
+    }
+
+    return written;
+}
+
+void TestPattern::prepare(const PatternGeometry& geometry)
+{
+    m_geometry = geometry;
+    m_stride = geometry.width + scrollRange;
+    m_pattern.assign(m_stride * geometry.height, 0);
+
+    const auto sensorWidth = std::max<size_t>(geometry.sensorWidth, 1);
+    const auto sensorHeight = std::max<size_t>(geometry.sensorHeight, 1);
+
+    for (size_t y = 0; y < geometry.height; ++y)
+    {
+        auto* row = m_pattern.data() + y * m_stride;
+        const auto sceneY = geometry.offsetY + y;
+
+        for (size_t x = 0; x < m_stride; ++x)
+        {
+            const auto color = sceneColor(geometry.offsetX + x, sceneY, sensorWidth, sensorHeight);
+
+            if (geometry.pixelFormat == PixelFormat::Mono8)
+            {
+                row[x] = static_cast<uint8_t>((77 * color.r + 150 * color.g + 29 * color.b) >> 8);
+                continue;
+            }
+
+            switch (bayerChannel(geometry.pixelFormat, x, y))
+            {
+            case 0:
+                row[x] = color.r;
+                break;
+            case 1:
+                row[x] = color.g;
+                break;
+            default:
+                row[x] = color.b;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace synthetic
@@ -0,0 +1,64 @@
+/*!
+ * \file    testpattern.h
+ * \author  IoTReady
+ * \date    2026-10-17
+ * \since   1.0.0
+ *
+ * \brief   The TestPattern class renders the frames of the synthetic camera:
+ *          colour bars over a grey ramp, sampled through the colour filter
+ *          array of the selected Bayer format. The pattern scrolls
+ *          horizontally so consecutive frames differ.
+ *
+ * \version 1.0.0
+ */
+
+#ifndef TESTPATTERN_H
+#define TESTPATTERN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace synthetic
+{
+
+struct PatternGeometry
+{
+    uint64_t pixelFormat = 0;
+    size_t sensorWidth = 0;
+    size_t sensorHeight = 0;
+    size_t width = 0;
+    size_t height = 0;
+    size_t offsetX = 0;
+    size_t offsetY = 0;
+
+    bool operator==(const PatternGeometry& other) const;
+};
+
+
+class TestPattern
+{
+
+public:
+    static bool IsSupported(uint64_t pixelFormat);
+
+    /*!
+     * \brief Writes frame \p frameId of the pattern to \p output, a tightly packed 8 bit image of the geometry's
+     *        size. At most \p outputSize bytes are written. Returns the number of bytes written.
+     *
+     * The full pattern is rendered once per geometry, later frames are plain row copies.
+     */
+    size_t Render(const PatternGeometry& geometry, uint64_t frameId, uint8_t* output, size_t outputSize);
+
+private:
+    void prepare(const PatternGeometry& geometry);
+
+    PatternGeometry m_geometry;
+    size_t m_stride = 0;
+    std::vector<uint8_t> m_pattern;
+};
+
+} // namespace synthetic
+
+#endif // TESTPATTERN_H